@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include <inttypes.h>
+#include <algorithm>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <fmt/format.h>
+#include <folly/init/Init.h>
+#include <folly/io/async/EventBaseThread.h>
+#include <folly/portability/GFlags.h>
+#include <thrift/lib/cpp2/async/HeaderClientChannel.h>
+#include "eden/common/utils/benchharness/Bench.h"
+#include "eden/fs/service/gen-cpp2/EdenService.h"
+#include "eden/fs/utils/FileUtils.h"
+#include "eden/fs/utils/PathFuncs.h"
+
+using namespace facebook::eden;
+
+DEFINE_string(repo, "", "Path to the EdenFS checkout to benchmark");
+DEFINE_string(rev1, "", "First revision to alternate between");
+DEFINE_string(rev2, "", "Second revision to alternate between");
+DEFINE_uint64(iterations, 10, "Number of checkouts (alternating revisions)");
+DEFINE_bool(dry_run, false, "Use DRY_RUN checkouts (conflict discovery only)");
+
+DEFINE_string(
+    generate,
+    "",
+    "Instead of benchmarking, populate this directory with a synthetic "
+    "tree; commit the result (twice, with different --seed values) to "
+    "create the revisions to benchmark against");
+DEFINE_uint64(depth, 4, "Directory depth of the generated tree");
+DEFINE_uint64(fanout, 4, "Subdirectories per directory of the generated tree");
+DEFINE_uint64(files_per_dir, 16, "Files per directory of the generated tree");
+DEFINE_double(
+    file_size_log_mean,
+    8.0,
+    "Mean of the log-normal file size distribution, in log(bytes); the "
+    "default centers around a few KB like typical source files");
+DEFINE_double(
+    file_size_log_stddev,
+    1.5,
+    "Standard deviation of the log-normal file size distribution");
+DEFINE_uint64(seed, 0, "Seed for the generated tree's contents");
+
+namespace {
+
+/**
+ * Measures checkOutRevision() by alternating a mount between two existing
+ * revisions over thrift.
+ *
+ * Revisions of a suitable shape can be produced with --generate, which
+ * writes a synthetic tree of configurable depth, fanout, and file-size
+ * distribution into a checkout; running it with two different seeds and
+ * committing each result yields a pair of commits whose diff touches
+ * every file. Commit creation itself goes through the source control
+ * tool, which EdenFS cannot drive over thrift.
+ *
+ * Phase attribution comes from the daemon's own telemetry: the benchmark
+ * snapshots the checkout and object store counters around the run and
+ * reports their deltas (tree fetches and their latency, inode lookups,
+ * and invalidation flush times) next to the end-to-end wall clock
+ * numbers.
+ */
+
+void generateTree(
+    AbsolutePathPiece dir,
+    uint64_t depth,
+    std::mt19937_64& rng) {
+  ensureDirectoryExists(dir);
+
+  std::lognormal_distribution<double> sizeDist{
+      FLAGS_file_size_log_mean, FLAGS_file_size_log_stddev};
+  std::uniform_int_distribution<uint64_t> byteDist{0, 255};
+
+  for (uint64_t i = 0; i < FLAGS_files_per_dir; ++i) {
+    auto size = static_cast<size_t>(sizeDist(rng));
+    std::string contents;
+    contents.reserve(size);
+    for (size_t b = 0; b < size; ++b) {
+      contents.push_back(static_cast<char>(byteDist(rng)));
+    }
+    auto name = PathComponent{fmt::format("file{}.txt", i)};
+    auto result = writeFile(
+        dir + name, folly::ByteRange{folly::StringPiece{contents}});
+    result.throwUnlessValue();
+  }
+
+  if (depth == 0) {
+    return;
+  }
+  for (uint64_t i = 0; i < FLAGS_fanout; ++i) {
+    auto name = PathComponent{fmt::format("dir{}", i)};
+    generateTree(dir + name, depth - 1, rng);
+  }
+}
+
+int generate() {
+  auto dir = canonicalPath(FLAGS_generate);
+  std::mt19937_64 rng{FLAGS_seed};
+  generateTree(dir, FLAGS_depth, rng);
+
+  uint64_t dirCount = 1;
+  uint64_t width = 1;
+  for (uint64_t level = 0; level < FLAGS_depth; ++level) {
+    width *= FLAGS_fanout;
+    dirCount += width;
+  }
+  printf(
+      "wrote %" PRIu64 " directories with %" PRIu64
+      " files each under %s\n"
+      "commit this tree, regenerate with a different --seed, commit again, "
+      "and pass the two commit hashes as --rev1/--rev2\n",
+      dirCount,
+      FLAGS_files_per_dir,
+      dir.c_str());
+  return 0;
+}
+
+std::map<std::string, int64_t> fetchPhaseCounters(
+    EdenServiceAsyncClient& client,
+    folly::EventBase* eventBase) {
+  return client
+      .semifuture_getRegexCounters(
+          "^(checkout\\.|store\\.get_tree|object_store\\.get_tree).*")
+      .via(eventBase)
+      .get();
+}
+
+int benchmark() {
+  if (FLAGS_repo.empty() || FLAGS_rev1.empty() || FLAGS_rev2.empty()) {
+    fprintf(stderr, "--repo, --rev1, and --rev2 are required\n");
+    return 1;
+  }
+  auto path = canonicalPath(FLAGS_repo);
+  auto socketPath = path + ".eden/socket"_relpath;
+
+  auto evbThread = folly::EventBaseThread();
+  auto eventBase = evbThread.getEventBase();
+
+  auto socket = folly::AsyncSocket::newSocket(
+      eventBase, folly::SocketAddress::makeFromPath(socketPath.view()));
+  auto channel =
+      apache::thrift::HeaderClientChannel::newChannel(std::move(socket));
+  auto client = std::make_unique<EdenServiceAsyncClient>(std::move(channel));
+
+  auto mountPoint = std::string{path.view()};
+  auto mode = FLAGS_dry_run ? CheckoutMode::DRY_RUN : CheckoutMode::NORMAL;
+
+  auto before = fetchPhaseCounters(*client, eventBase);
+
+  std::vector<uint64_t> wallTimesNs;
+  wallTimesNs.reserve(FLAGS_iterations);
+  for (uint64_t i = 0; i < FLAGS_iterations; ++i) {
+    const auto& rev = (i % 2 == 0) ? FLAGS_rev2 : FLAGS_rev1;
+
+    uint64_t start = getTime();
+    auto conflicts = client
+                         ->semifuture_checkOutRevision(
+                             mountPoint, rev, mode, CheckOutRevisionParams{})
+                         .via(eventBase)
+                         .get();
+    uint64_t end = getTime();
+    wallTimesNs.push_back(end - start);
+
+    printf(
+        "checkout %" PRIu64 " -> %s: %.1f ms, %zu conflicts\n",
+        i,
+        rev.c_str(),
+        static_cast<double>(end - start) / 1e6,
+        conflicts.size());
+  }
+
+  // Flush thread-local counters so the after-snapshot sees this run.
+  client->semifuture_flushStatsNow().via(eventBase).get();
+  auto after = fetchPhaseCounters(*client, eventBase);
+
+  std::sort(wallTimesNs.begin(), wallTimesNs.end());
+  printf(
+      "\nwall clock: min %.1f ms, median %.1f ms, max %.1f ms\n",
+      static_cast<double>(wallTimesNs.front()) / 1e6,
+      static_cast<double>(wallTimesNs[wallTimesNs.size() / 2]) / 1e6,
+      static_cast<double>(wallTimesNs.back()) / 1e6);
+
+  printf("\nphase counter deltas over the run:\n");
+  for (const auto& [name, value] : after) {
+    auto it = before.find(name);
+    auto delta = value - (it == before.end() ? 0 : it->second);
+    if (delta != 0) {
+      printf("  %s: %+" PRId64 "\n", name.c_str(), delta);
+    }
+  }
+  return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+
+  if (!FLAGS_generate.empty()) {
+    return generate();
+  }
+  return benchmark();
+}
@@ -0,0 +1,283 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+/*
+ * Replays a recorded FsEvent trace against a mount and reports latency
+ * distributions, so changes such as new cache policies can be evaluated
+ * against real recorded traffic rather than synthetic loops.
+ *
+ * The input is a file with one JSON object per line, one per request start
+ * event, as captured from traceFsEvents / the FS ActivityBuffer:
+ *
+ *   {"ts_ns": 123456789, "pid": 4242, "op": "FUSE_GETATTR", "path": "a/b.c"}
+ *
+ * ts_ns is the event's monotonic_time_ns, pid the requesting process, op the
+ * FUSE opcode name, and path the target path relative to the mount root.
+ *
+ * Events from the same pid are replayed in order on a dedicated worker, and
+ * distinct pids run concurrently, so the original per-process ordering and
+ * cross-process concurrency are both preserved. Each event is dispatched at
+ * its recorded offset from the start of the trace (divided by --speed), which
+ * reproduces the original arrival rate rather than issuing requests
+ * back-to-back.
+ */
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/xattr.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <climits>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <folly/FileUtil.h>
+#include <folly/String.h>
+#include <folly/Synchronized.h>
+#include <folly/init/Init.h>
+#include <folly/json.h>
+#include <folly/portability/GFlags.h>
+#include <folly/portability/Unistd.h>
+
+DEFINE_string(
+    trace,
+    "",
+    "File containing the recorded trace, one JSON object per line");
+DEFINE_string(mount, "", "Checkout to replay the trace against");
+DEFINE_double(
+    speed,
+    1.0,
+    "Replay speed multiplier. 1.0 reproduces the recorded timing; larger "
+    "values compress the schedule; 0 replays as fast as possible");
+
+namespace {
+
+using namespace std::chrono;
+
+struct TraceEvent {
+  nanoseconds offset; // Relative to the first event in the trace.
+  pid_t pid;
+  std::string op;
+  std::string path;
+};
+
+struct OpStats {
+  std::vector<microseconds> latencies;
+  uint64_t failures = 0;
+};
+
+enum class ReplayResult { Success, Failure, Unsupported };
+
+/**
+ * Issues the syscall corresponding to a recorded FUSE opcode.
+ *
+ * Mutating opcodes are deliberately not replayed: the tool is meant to run
+ * against a real checkout, and read traffic is what cache policy changes
+ * affect.
+ */
+ReplayResult replayOne(const std::string& op, const std::string& path) {
+  if (op == "FUSE_LOOKUP" || op == "FUSE_GETATTR" || op == "FUSE_STATFS") {
+    struct stat st;
+    return ::lstat(path.c_str(), &st) == 0 ? ReplayResult::Success
+                                           : ReplayResult::Failure;
+  }
+  if (op == "FUSE_OPEN" || op == "FUSE_READ") {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+      return ReplayResult::Failure;
+    }
+    if (op == "FUSE_READ") {
+      char buf[64 * 1024];
+      folly::readNoInt(fd, buf, sizeof(buf));
+    }
+    ::close(fd);
+    return ReplayResult::Success;
+  }
+  if (op == "FUSE_OPENDIR" || op == "FUSE_READDIR" ||
+      op == "FUSE_READDIRPLUS") {
+    DIR* dir = ::opendir(path.c_str());
+    if (!dir) {
+      return ReplayResult::Failure;
+    }
+    while (::readdir(dir)) {
+    }
+    ::closedir(dir);
+    return ReplayResult::Success;
+  }
+  if (op == "FUSE_READLINK") {
+    char buf[PATH_MAX];
+    return ::readlink(path.c_str(), buf, sizeof(buf)) >= 0
+        ? ReplayResult::Success
+        : ReplayResult::Failure;
+  }
+  if (op == "FUSE_GETXATTR" || op == "FUSE_LISTXATTR") {
+    char buf[256];
+#ifdef __APPLE__
+    ::listxattr(path.c_str(), buf, sizeof(buf), 0);
+#else
+    ::listxattr(path.c_str(), buf, sizeof(buf));
+#endif
+    return ReplayResult::Success;
+  }
+  return ReplayResult::Unsupported;
+}
+
+std::vector<TraceEvent> loadTrace(const std::string& traceFile) {
+  std::string contents;
+  if (!folly::readFile(traceFile.c_str(), contents)) {
+    fprintf(stderr, "error: unable to read %s\n", traceFile.c_str());
+    exit(1);
+  }
+
+  std::vector<TraceEvent> events;
+  std::optional<nanoseconds> firstTimestamp;
+  std::vector<folly::StringPiece> lines;
+  folly::split('\n', contents, lines, true);
+  for (auto line : lines) {
+    auto obj = folly::parseJson(line);
+    auto timestamp = nanoseconds{obj["ts_ns"].asInt()};
+    if (!firstTimestamp) {
+      firstTimestamp = timestamp;
+    }
+    events.push_back(TraceEvent{
+        timestamp - *firstTimestamp,
+        static_cast<pid_t>(obj["pid"].asInt()),
+        obj["op"].asString(),
+        obj["path"].asString()});
+  }
+  return events;
+}
+
+void printDistribution(const std::string& op, OpStats& stats) {
+  auto& lat = stats.latencies;
+  std::sort(lat.begin(), lat.end());
+  auto percentile = [&](double p) {
+    return lat[std::min(
+                   lat.size() - 1,
+                   static_cast<size_t>(p * static_cast<double>(lat.size())))]
+        .count();
+  };
+  printf(
+      "%-18s count=%8zu failed=%6" PRIu64
+      " p50=%8ldus p90=%8ldus p99=%8ldus max=%8ldus\n",
+      op.c_str(),
+      lat.size(),
+      stats.failures,
+      static_cast<long>(percentile(0.5)),
+      static_cast<long>(percentile(0.9)),
+      static_cast<long>(percentile(0.99)),
+      static_cast<long>(lat.back().count()));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::Init init{&argc, &argv};
+  if (FLAGS_trace.empty() || FLAGS_mount.empty()) {
+    fprintf(stderr, "usage: %s --trace trace.jsonl --mount path\n", argv[0]);
+    return 1;
+  }
+
+  auto events = loadTrace(FLAGS_trace);
+  if (events.empty()) {
+    fprintf(stderr, "error: trace is empty\n");
+    return 1;
+  }
+  auto traceSpan = std::max_element(
+                       events.begin(),
+                       events.end(),
+                       [](const TraceEvent& a, const TraceEvent& b) {
+                         return a.offset < b.offset;
+                       })
+                       ->offset;
+  printf("Replaying %zu events...\n", events.size());
+
+  // Partition the trace by pid up front so each worker only consults its own
+  // queue during the replay.
+  std::unordered_map<pid_t, std::vector<TraceEvent>> byPid;
+  for (auto& event : events) {
+    byPid[event.pid].push_back(std::move(event));
+  }
+
+  folly::Synchronized<std::unordered_map<std::string, OpStats>> statsByOp;
+  std::atomic<uint64_t> unsupported{0};
+
+  auto replayStart = steady_clock::now();
+  std::vector<std::thread> workers;
+  workers.reserve(byPid.size());
+  for (auto& entry : byPid) {
+    workers.emplace_back([&, pidEvents = &entry.second] {
+      std::unordered_map<std::string, OpStats> localStats;
+      uint64_t localUnsupported = 0;
+      for (const auto& event : *pidEvents) {
+        if (FLAGS_speed > 0) {
+          auto deadline = replayStart +
+              duration_cast<steady_clock::duration>(
+                              event.offset / FLAGS_speed);
+          std::this_thread::sleep_until(deadline);
+        }
+        auto path = FLAGS_mount + "/" + event.path;
+        auto opStart = steady_clock::now();
+        auto result = replayOne(event.op, path);
+        auto elapsed = steady_clock::now() - opStart;
+        switch (result) {
+          case ReplayResult::Success:
+            localStats[event.op].latencies.push_back(
+                duration_cast<microseconds>(elapsed));
+            break;
+          case ReplayResult::Failure:
+            localStats[event.op].failures++;
+            break;
+          case ReplayResult::Unsupported:
+            localUnsupported++;
+            break;
+        }
+      }
+      auto locked = statsByOp.wlock();
+      for (auto& [op, stats] : localStats) {
+        auto& merged = (*locked)[op];
+        merged.latencies.insert(
+            merged.latencies.end(),
+            stats.latencies.begin(),
+            stats.latencies.end());
+        merged.failures += stats.failures;
+      }
+      unsupported.fetch_add(localUnsupported, std::memory_order_relaxed);
+    });
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  auto wallTime = steady_clock::now() - replayStart;
+
+  printf(
+      "Replayed trace spanning %ldms in %ldms with %zu concurrent processes; "
+      "%" PRIu64 " events had unsupported opcodes\n",
+      static_cast<long>(duration_cast<milliseconds>(traceSpan).count()),
+      static_cast<long>(duration_cast<milliseconds>(wallTime).count()),
+      byPid.size(),
+      unsupported.load(std::memory_order_relaxed));
+
+  auto locked = statsByOp.wlock();
+  std::vector<std::string> ops;
+  for (auto& [op, stats] : *locked) {
+    ops.push_back(op);
+  }
+  std::sort(ops.begin(), ops.end());
+  for (auto& op : ops) {
+    auto& stats = (*locked)[op];
+    if (!stats.latencies.empty()) {
+      printDistribution(op, stats);
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include <fmt/format.h>
+#include <folly/io/async/EventBaseThread.h>
+#include <thrift/lib/cpp2/async/HeaderClientChannel.h>
+#include "eden/common/utils/benchharness/Bench.h"
+#include "eden/fs/service/gen-cpp2/EdenService.h"
+#include "eden/fs/utils/PathFuncs.h"
+
+DEFINE_string(repo, "", "Repository to run the queries against");
+DEFINE_string(root, "", "Root of the queries");
+DEFINE_string(
+    literal_file,
+    "README.md",
+    "Repo-relative file used by the literal pattern shape");
+DEFINE_string(
+    extension,
+    "cpp",
+    "File extension used by the suffix, brace, and recursive shapes");
+DEFINE_string(
+    extension2,
+    "h",
+    "Second file extension used by the brace pattern shape");
+
+namespace {
+
+using namespace facebook::eden;
+
+/**
+ * Sweeps globFiles() over a matrix of pattern shapes, wildcard directory
+ * widths, and cold/warm cache states, so glob-engine changes can be
+ * compared across the whole shape space rather than a single query.
+ *
+ * Pass --benchmark_format=json (or --benchmark_out) to get
+ * machine-readable results for trend tracking; each matrix cell is one
+ * benchmark entry named by its shape/width/cold arguments.
+ */
+
+// Values for the "shape" benchmark argument.
+enum Shape : int64_t {
+  kLiteral = 0,
+  kSuffix = 1,
+  kBrace = 2,
+  kRecursive = 3,
+};
+
+AbsolutePath validateArguments() {
+  if (FLAGS_repo.empty()) {
+    throw std::invalid_argument("A repo must be passed in");
+  }
+
+  return canonicalPath(FLAGS_repo);
+}
+
+std::string buildPattern(Shape shape, int64_t width) {
+  // width is the number of single-level wildcard directories prefixed to
+  // the pattern, so higher widths touch wider slices of the tree.
+  std::string prefix;
+  for (int64_t i = 0; i < width; ++i) {
+    prefix += "*/";
+  }
+  switch (shape) {
+    case kLiteral:
+      return FLAGS_literal_file;
+    case kSuffix:
+      return fmt::format("{}*.{}", prefix, FLAGS_extension);
+    case kBrace:
+      return fmt::format(
+          "{}*.{{{},{}}}", prefix, FLAGS_extension, FLAGS_extension2);
+    case kRecursive:
+      return fmt::format("**/*.{}", FLAGS_extension);
+  }
+  throw std::invalid_argument("unknown pattern shape");
+}
+
+void glob_matrix(benchmark::State& state) {
+  auto path = validateArguments();
+  auto shape = static_cast<Shape>(state.range(0));
+  auto width = state.range(1);
+  bool cold = state.range(2) != 0;
+
+  auto socketPath = path + ".eden/socket"_relpath;
+
+  auto evbThread = folly::EventBaseThread();
+  auto eventBase = evbThread.getEventBase();
+
+  auto socket = folly::AsyncSocket::newSocket(
+      eventBase, folly::SocketAddress::makeFromPath(socketPath.view()));
+  auto channel =
+      apache::thrift::HeaderClientChannel::newChannel(std::move(socket));
+  auto client = std::make_unique<EdenServiceAsyncClient>(std::move(channel));
+
+  GlobParams param;
+  param.mountPoint_ref() = path.view();
+  param.globs_ref() = std::vector<std::string>{buildPattern(shape, width)};
+  param.includeDotfiles_ref() = false;
+  param.prefetchFiles_ref() = false;
+  param.suppressFileList_ref() = false;
+  param.wantDtype_ref() = false;
+  param.prefetchMetadata_ref() = false;
+  param.searchRoot_ref() = FLAGS_root;
+
+  for (auto _ : state) {
+    if (cold) {
+      // Re-chill the daemon outside the timed region: drop the local store
+      // caches and unload every inode that the kernel will let go of.
+      // In-memory object caches are not individually flushable over
+      // thrift, so "cold" here means cold inodes and cold on-disk caches.
+      client->semifuture_debugClearLocalStoreCaches().via(eventBase).get();
+      client
+          ->semifuture_unloadInodeForPath(
+              std::string{path.view()}, std::string{}, TimeSpec{})
+          .via(eventBase)
+          .get();
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    auto result = client->semifuture_globFiles(param).via(eventBase).get();
+    auto end = std::chrono::high_resolution_clock::now();
+
+    benchmark::DoNotOptimize(result);
+
+    auto elapsed =
+        std::chrono::duration_cast<std::chrono::duration<double>>(end - start);
+    state.SetIterationTime(elapsed.count());
+  }
+}
+
+void globMatrixArguments(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"shape", "width", "cold"});
+  for (int64_t cold = 0; cold <= 1; ++cold) {
+    b->Args({kLiteral, 0, cold});
+    for (int64_t width : {0, 1, 2, 4}) {
+      b->Args({kSuffix, width, cold});
+      b->Args({kBrace, width, cold});
+    }
+    b->Args({kRecursive, 0, cold});
+  }
+}
+
+BENCHMARK(glob_matrix)
+    ->Apply(globMatrixArguments)
+    ->UseManualTime()
+    ->Unit(benchmark::kMillisecond);
+
+} // namespace
+
+EDEN_BENCHMARK_MAIN();
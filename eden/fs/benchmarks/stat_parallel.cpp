@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include <inttypes.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <folly/Conv.h>
+#include <folly/Exception.h>
+#include <folly/init/Init.h>
+#include <folly/io/async/EventBaseThread.h>
+#include <folly/portability/GFlags.h>
+#include <folly/synchronization/test/Barrier.h>
+#include <thrift/lib/cpp2/async/HeaderClientChannel.h>
+#include "eden/common/utils/benchharness/Bench.h"
+#include "eden/fs/service/gen-cpp2/EdenService.h"
+#include "eden/fs/utils/PathFuncs.h"
+
+using namespace facebook::eden;
+
+DEFINE_uint64(threads, 64, "The number of concurrent stat threads");
+DEFINE_uint64(iterations, 10000, "Number of stat calls per thread");
+DEFINE_bool(
+    cold,
+    false,
+    "Unload EdenFS inodes and invalidate the kernel's caches for the "
+    "checkout before measuring, so the run reproduces a cold-stat storm");
+DEFINE_string(
+    repo,
+    "",
+    "Path to the EdenFS checkout containing the files "
+    "(required with --cold)");
+
+namespace {
+
+/**
+ * Latency samples collected by one thread, in nanoseconds.
+ *
+ * Full samples are retained so percentiles are exact rather than
+ * bucket-estimated; at the default settings this is 80KB per thread.
+ */
+struct LatencySamples {
+  std::vector<uint64_t> samples;
+
+  explicit LatencySamples(size_t expected) {
+    samples.reserve(expected);
+  }
+
+  uint64_t percentile(double pct) {
+    if (samples.empty()) {
+      return 0;
+    }
+    auto index = std::min(
+        samples.size() - 1,
+        static_cast<size_t>(pct * static_cast<double>(samples.size())));
+    std::nth_element(
+        samples.begin(), samples.begin() + index, samples.end());
+    return samples[index];
+  }
+};
+
+void printHistogram(const char* label, LatencySamples& samples) {
+  printf(
+      "%s  p50: %" PRIu64 " ns  p90: %" PRIu64 " ns  p99: %" PRIu64
+      " ns  p99.9: %" PRIu64 " ns  max: %" PRIu64 " ns\n",
+      label,
+      samples.percentile(0.5),
+      samples.percentile(0.9),
+      samples.percentile(0.99),
+      samples.percentile(0.999),
+      *std::max_element(samples.samples.begin(), samples.samples.end()));
+}
+
+/**
+ * Chill the checkout over thrift: unload every inode the kernel will let
+ * go of and then invalidate the kernel's cache for the mount, so the
+ * measured stats miss both the kernel and EdenFS inode caches.
+ */
+void makeCheckoutCold() {
+  if (FLAGS_repo.empty()) {
+    throw std::invalid_argument("--cold requires --repo");
+  }
+  auto path = canonicalPath(FLAGS_repo);
+  auto socketPath = path + ".eden/socket"_relpath;
+
+  auto evbThread = folly::EventBaseThread();
+  auto eventBase = evbThread.getEventBase();
+
+  auto socket = folly::AsyncSocket::newSocket(
+      eventBase, folly::SocketAddress::makeFromPath(socketPath.view()));
+  auto channel =
+      apache::thrift::HeaderClientChannel::newChannel(std::move(socket));
+  auto client = std::make_unique<EdenServiceAsyncClient>(std::move(channel));
+
+  auto mountPoint = std::string{path.view()};
+  auto unloaded = client
+                      ->semifuture_unloadInodeForPath(
+                          mountPoint, std::string{}, TimeSpec{})
+                      .via(eventBase)
+                      .get();
+  client->semifuture_invalidateKernelInodeCache(mountPoint, std::string{})
+      .via(eventBase)
+      .get();
+  printf("unloaded %" PRId64 " inodes\n", unloaded);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+
+  if (argc <= 1) {
+    fprintf(
+        stderr,
+        "Specify a list of filenames on the command line. Each thread stats "
+        "them in sequence, starting at a different offset.\n");
+    return 1;
+  }
+
+  if (FLAGS_cold) {
+    makeCheckoutCold();
+  }
+
+  folly::test::Barrier gate{static_cast<unsigned>(FLAGS_threads)};
+
+  std::mutex result_mutex;
+  LatencySamples combined{FLAGS_threads * FLAGS_iterations};
+  std::vector<LatencySamples> perThread;
+  perThread.reserve(FLAGS_threads);
+
+  auto thread = [&](uint64_t thread_index) {
+    LatencySamples accum{FLAGS_iterations};
+    // Stagger the starting file so that in cold runs the threads collide on
+    // in-flight inode loads, like a real stat storm, instead of marching
+    // through the list in lockstep behind a single loader.
+    int file_index = 1 + static_cast<int>(thread_index % (argc - 1));
+
+    gate.wait();
+
+    for (uint64_t i = 0; i < FLAGS_iterations; ++i) {
+      const char* filename = argv[file_index];
+      struct stat buf;
+
+      uint64_t start_time = getTime();
+      int rc = ::lstat(filename, &buf);
+      uint64_t end_time = getTime();
+      if (rc != 0) {
+        folly::throwSystemError("Failed to stat '", filename, "'");
+      }
+
+      if (++file_index >= argc) {
+        file_index = 1;
+      }
+
+      accum.samples.push_back(end_time - start_time);
+    }
+
+    std::lock_guard guard{result_mutex};
+    combined.samples.insert(
+        combined.samples.end(), accum.samples.begin(), accum.samples.end());
+    perThread.push_back(std::move(accum));
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(FLAGS_threads);
+  for (uint64_t t = 0; t < FLAGS_threads; ++t) {
+    threads.emplace_back(thread, t);
+  }
+
+  for (auto& th : threads) {
+    th.join();
+  }
+
+  for (size_t t = 0; t < perThread.size(); ++t) {
+    auto label = folly::to<std::string>("thread ", t);
+    printHistogram(label.c_str(), perThread[t]);
+  }
+  printHistogram("combined", combined);
+}
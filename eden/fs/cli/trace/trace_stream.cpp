@@ -62,6 +62,8 @@ static const auto kCalendarEmoji =
 
 static const std::unordered_map<HgEventType, const char*> kHgEventTypes = {
     {HgEventType::QUEUE, " "},
+    {HgEventType::DEDUP, " "},
+    {HgEventType::DEQUEUE, " "},
     {HgEventType::START, kRequestStartEmoji},
     {HgEventType::FINISH, kRequestCompleteEmoji},
 };
@@ -188,6 +190,9 @@ void print_hg_event(
     case HgEventType::QUEUE:
       activeRequests[unique].queue = evt;
       break;
+    case HgEventType::DEDUP:
+    case HgEventType::DEQUEUE:
+      break;
     case HgEventType::START: {
       auto& record = activeRequests[unique];
       queueEvent = record.queue;
@@ -209,6 +214,10 @@ void print_hg_event(
     case HgEventType::QUEUE:
       // TODO: Might be interesting to add an option to see queuing events.
       return;
+    case HgEventType::DEDUP:
+    case HgEventType::DEQUEUE:
+      // Queue mechanics; the aggregate view lives in getHgImportDwellTimes.
+      return;
     case HgEventType::START:
       if (queueEvent) {
         auto queueTime = evt.times()->monotonic_time_ns().value() -
@@ -774,13 +783,17 @@ int trace_task(
     "threadId": {},
     "threadName": {},
     "start": {},
-    "duration: {}
+    "duration: {},
+    "onCpuDuration": {},
+    "runqueueWaitDuration": {}
 }})",
           *task.name(),
           *task.threadId(),
           *task.threadName(),
           *task.start(),
-          *task.duration());
+          *task.duration(),
+          *task.onCpuDuration(),
+          *task.runqueueWaitDuration());
     }
 
     auto threadId = static_cast<uint64_t>(*task.threadId());
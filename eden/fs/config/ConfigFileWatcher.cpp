@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/config/ConfigFileWatcher.h"
+
+#include <array>
+
+#include <folly/Exception.h>
+#include <folly/String.h>
+#include <folly/logging/xlog.h>
+#include <folly/system/ThreadName.h>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <boost/filesystem.hpp>
+#endif
+
+namespace facebook::eden {
+
+#ifdef __linux__
+
+namespace {
+/**
+ * Events that may indicate new contents at a watched file's path.  The
+ * common case is IN_MOVED_TO from a rename of a temporary file into place;
+ * in-place writes and deletions are covered as well.
+ */
+constexpr uint32_t kWatchMask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE |
+    IN_DELETE | IN_MOVED_FROM | IN_ATTRIB;
+} // namespace
+
+ConfigFileWatcher::ConfigFileWatcher(
+    std::vector<std::string> paths,
+    ChangeCallback callback)
+    : callback_{std::move(callback)} {
+  int inotifyFd = inotify_init1(IN_CLOEXEC);
+  folly::checkUnixError(inotifyFd, "inotify_init1 failed");
+  inotifyFd_ = folly::File{inotifyFd, /*ownsFd=*/true};
+
+  int stopFd = eventfd(0, EFD_CLOEXEC);
+  folly::checkUnixError(stopFd, "eventfd failed");
+  stopFd_ = folly::File{stopFd, /*ownsFd=*/true};
+
+  for (auto& path : paths) {
+    if (path.empty()) {
+      continue;
+    }
+    boost::filesystem::path filePath{path};
+    auto parent = filePath.parent_path().string();
+    int wd = inotify_add_watch(inotifyFd_.fd(), parent.c_str(), kWatchMask);
+    if (wd == -1) {
+      // A missing config directory is normal (e.g. no user config yet);
+      // changes to it will be picked up on the next daemon restart.
+      XLOG(WARN) << "unable to watch " << parent << " for config changes: "
+                 << folly::errnoStr(errno);
+      continue;
+    }
+    watchedNames_[wd].insert(filePath.filename().string());
+  }
+
+  thread_ = std::thread([this] { watchThread(); });
+}
+
+ConfigFileWatcher::~ConfigFileWatcher() {
+  if (thread_.joinable()) {
+    uint64_t one = 1;
+    folly::checkUnixError(
+        write(stopFd_.fd(), &one, sizeof(one)), "failed to stop watcher");
+    thread_.join();
+  }
+}
+
+bool ConfigFileWatcher::isSupported() {
+  return true;
+}
+
+void ConfigFileWatcher::watchThread() noexcept {
+  folly::setThreadName("ConfigWatcher");
+
+  std::array<pollfd, 2> fds;
+  fds[0] = {inotifyFd_.fd(), POLLIN, 0};
+  fds[1] = {stopFd_.fd(), POLLIN, 0};
+
+  // Large enough for a batch of events with names up to NAME_MAX.
+  alignas(inotify_event) std::array<char, 16 * 1024> buffer;
+
+  while (true) {
+    int ready = poll(fds.data(), fds.size(), -1);
+    if (ready == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      XLOG(ERR) << "config watcher poll failed: " << folly::errnoStr(errno);
+      return;
+    }
+    if (fds[1].revents) {
+      return;
+    }
+    if (!(fds[0].revents & POLLIN)) {
+      continue;
+    }
+
+    auto length = read(inotifyFd_.fd(), buffer.data(), buffer.size());
+    if (length <= 0) {
+      if (length == -1 && errno == EINTR) {
+        continue;
+      }
+      XLOG(ERR) << "config watcher read failed: " << folly::errnoStr(errno);
+      return;
+    }
+
+    bool changed = false;
+    size_t offset = 0;
+    while (offset + sizeof(inotify_event) <= static_cast<size_t>(length)) {
+      auto* event = reinterpret_cast<inotify_event*>(buffer.data() + offset);
+      if (event->len != 0) {
+        auto iter = watchedNames_.find(event->wd);
+        if (iter != watchedNames_.end() &&
+            iter->second.count(event->name) != 0) {
+          changed = true;
+        }
+      }
+      offset += sizeof(inotify_event) + event->len;
+    }
+    if (changed) {
+      callback_();
+    }
+  }
+}
+
+#else // !__linux__
+
+ConfigFileWatcher::ConfigFileWatcher(
+    std::vector<std::string> /*paths*/,
+    ChangeCallback callback)
+    : callback_{std::move(callback)} {}
+
+ConfigFileWatcher::~ConfigFileWatcher() = default;
+
+bool ConfigFileWatcher::isSupported() {
+  return false;
+}
+
+void ConfigFileWatcher::watchThread() noexcept {}
+
+#endif // __linux__
+
+} // namespace facebook::eden
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <folly/File.h>
+
+namespace facebook::eden {
+
+/**
+ * Watches a set of configuration files for changes using inotify, invoking a
+ * callback whenever one of them may have been modified.
+ *
+ * Configuration files are typically replaced by renaming a temporary file
+ * into place, which would silently drop a watch on the file itself, so the
+ * parent directory of each file is watched instead and events are filtered
+ * by file name.
+ *
+ * Only supported on Linux; callers should check isSupported() and fall back
+ * to stat-based polling elsewhere.
+ */
+class ConfigFileWatcher {
+ public:
+  using ChangeCallback = std::function<void()>;
+
+  /**
+   * Start watching.  `paths` holds absolute paths to the files of interest;
+   * entries that are empty or whose parent directory cannot be watched are
+   * skipped with a warning.  The callback is invoked from the watcher thread
+   * and must be cheap and thread-safe.
+   */
+  ConfigFileWatcher(std::vector<std::string> paths, ChangeCallback callback);
+  ~ConfigFileWatcher();
+
+  ConfigFileWatcher(const ConfigFileWatcher&) = delete;
+  ConfigFileWatcher& operator=(const ConfigFileWatcher&) = delete;
+
+  /**
+   * Whether file watching is available on this platform.
+   */
+  static bool isSupported();
+
+ private:
+  void watchThread() noexcept;
+
+  ChangeCallback callback_;
+
+#ifdef __linux__
+  folly::File inotifyFd_;
+
+  /**
+   * eventfd used to wake the watcher thread up for shutdown.
+   */
+  folly::File stopFd_;
+
+  /**
+   * Watch descriptor of each watched parent directory, mapped to the file
+   * names of interest within it.
+   */
+  std::unordered_map<int, std::unordered_set<std::string>> watchedNames_;
+
+  std::thread thread_;
+#endif
+};
+
+} // namespace facebook::eden
@@ -123,6 +123,12 @@ class EdenConfig : private ConfigSettingManager {
     return systemConfigDir_;
   }
 
+  /**
+   * Returns a Thrift-suitable path corresponding to the given source's config
+   * file.  Empty if the source is not file-backed.
+   */
+  std::string toSourcePath(ConfigSourceType cs) const;
+
  private:
   /**
    * Utility method for converting ConfigSourceType to the filename (or cli).
@@ -130,12 +136,6 @@ class EdenConfig : private ConfigSettingManager {
    */
   std::string toString(ConfigSourceType cs) const;
 
-  /**
-   * Returns a Thrift-suitable path corresponding to the given source's config
-   * file.
-   */
-  std::string toSourcePath(ConfigSourceType cs) const;
-
   void parseAndApplyConfigFile(
       int configFd,
       AbsolutePathPiece configPath,
@@ -223,6 +223,19 @@ class EdenConfig : private ConfigSettingManager {
       true,
       this};
 
+  /**
+   * Number of serialized executor lanes each mount's background work is
+   * striped across on the shared CPU pool. This bounds how many pool threads
+   * one mount can occupy at a time, so a storm of work on one mount cannot
+   * crowd every other mount out of the pool, and it keeps a mount's hot
+   * structures on a few cache-warm threads. Set to 0 to disable the
+   * per-mount grouping and submit work directly to the shared pool.
+   */
+  ConfigSetting<uint64_t> mountExecutorLanes{
+      "core:mount-executor-lanes",
+      4,
+      this};
+
   // [config]
 
   /**
@@ -273,6 +286,40 @@ class EdenConfig : private ConfigSettingManager {
       std::chrono::seconds(30),
       this};
 
+  /**
+   * Whether the Thrift server dispatches requests through a separate worker
+   * pool per priority.  Clients declare a QoS class by setting the standard
+   * Thrift call priority header on a request, so interactive CLI calls are
+   * not queued behind bulk daemon traffic.  thrift:num-workers sizes the
+   * NORMAL pool; the other pools use fbthrift's defaults.  The per-priority
+   * queue lengths are exported as thrift.queued_requests.{priority} counters.
+   */
+  ConfigSetting<bool> thriftUsePriorityQueues{
+      "thrift:use-priority-queues",
+      false,
+      this};
+
+  /**
+   * Whether getAttributesFromFiles resolves the requested paths grouped by
+   * parent directory, walking each shared prefix once, rather than walking
+   * every path independently from the root.
+   * TODO: Remove this killswitch after the feature proves to be safe.
+   */
+  ConfigSetting<bool> thriftBatchedAttributeLookups{
+      "thrift:batched-attribute-lookups",
+      true,
+      this};
+
+  /**
+   * Whether identical concurrent status and glob queries are collapsed onto
+   * one in-flight computation instead of each being computed independently.
+   * TODO: Remove this killswitch after the feature proves to be safe.
+   */
+  ConfigSetting<bool> thriftCollapseDuplicateRequests{
+      "thrift:collapse-duplicate-requests",
+      true,
+      this};
+
   // [ssl]
 
   ConfigSetting<AbsolutePath> clientCertificate{
@@ -298,6 +345,16 @@ class EdenConfig : private ConfigSettingManager {
       10,
       this};
 
+  /**
+   * Whether a DRY_RUN checkout computes conflicts with the read-only
+   * parallel diff scanner instead of walking the inode tree through the
+   * checkout machinery.
+   */
+  ConfigSetting<bool> dryRunConflictScan{
+      "mount:dry-run-conflict-scan",
+      true,
+      this};
+
   /**
    * How often will a garbage collection on the working copy will run.
    *
@@ -319,6 +376,40 @@ class EdenConfig : private ConfigSettingManager {
       OneHourMinDuration(std::chrono::hours(24)),
       this};
 
+  /**
+   * How often loaded inodes are swept in the background, unloading clean
+   * inodes with no FS refcount that have not been accessed recently.
+   *
+   * 0 disables the periodic sweep; the legacy --unload_interval_minutes
+   * command line flag is then consulted for backwards compatibility.
+   */
+  ConfigSetting<std::chrono::nanoseconds> periodicInodeUnloadInterval{
+      "mount:periodic-inode-unload-interval",
+      std::chrono::nanoseconds::zero(),
+      this};
+
+  /**
+   * Minimum time since last access before a loaded inode is eligible for the
+   * periodic background sweep.
+   *
+   * 0 falls back to the legacy --unload_age_minutes command line flag.
+   */
+  ConfigSetting<std::chrono::nanoseconds> periodicInodeUnloadAge{
+      "mount:periodic-inode-unload-age",
+      std::chrono::nanoseconds::zero(),
+      this};
+
+  /**
+   * Number of loaded inodes a mount is allowed to retain before the periodic
+   * sweep considers it. Mounts whose loaded inode count is at or below this
+   * target are skipped entirely, so a mount's working set is left untouched
+   * until it actually grows beyond the target. 0 sweeps every mount.
+   */
+  ConfigSetting<uint64_t> inodeWorkingSetTarget{
+      "mount:inode-working-set-target",
+      0,
+      this};
+
   /**
    * Specifies which directory children will be prefetched upon readdir.
    */
@@ -327,6 +418,17 @@ class EdenConfig : private ConfigSettingManager {
       ReaddirPrefetch::None,
       this};
 
+  /**
+   * Whether to remember the result of the last status computation and reuse
+   * it for repeated queries against the same commit while the journal
+   * records no new working copy changes. Tools that poll status in a loop
+   * are answered without re-walking the tree.
+   */
+  ConfigSetting<bool> cacheScmStatus{
+      "mount:cache-scm-status",
+      false,
+      this};
+
   /**
    * The soong build system used in AOSP loves to crawls the entirety of the
    * repository, including the .eden directory. In doing so, it infinitely
@@ -384,6 +486,11 @@ class EdenConfig : private ConfigSettingManager {
       20'000'000,
       this};
 
+  ConfigSetting<uint64_t> localStoreTreeFetchLogSizeLimit{
+      "store:tree-fetch-log-size-limit",
+      20'000'000,
+      this};
+
   /**
    * The minimum duration between logging occurrences of failed HgProxyHash
    * loads.
@@ -411,6 +518,87 @@ class EdenConfig : private ConfigSettingManager {
       5,
       this};
 
+  /**
+   * The number of pending BackingStore imports at which tree prefetching backs
+   * off entirely.  As the pending import count approaches this threshold the
+   * number of tree prefetches allowed in parallel is scaled down from
+   * store:max-tree-prefetches, so that speculative prefetch work yields to
+   * interactive fetches already waiting on the store.  Setting this to 0
+   * disables the backpressure check.
+   */
+  ConfigSetting<uint64_t> treePrefetchBackpressureThreshold{
+      "store:tree-prefetch-backpressure-threshold",
+      0,
+      this};
+
+  /**
+   * The maximum number of (scmTree, wdTree) pairs whose finished diff
+   * results are memoized per mount. Two source control trees are immutable,
+   * so their differences can be replayed on later status calls without
+   * loading either tree; with a stable dirty set only materialized paths
+   * are re-walked. A value of 0 disables the memo.
+   */
+  ConfigSetting<uint32_t> treeDiffMemoCacheEntries{
+      "store:tree-diff-memo-cache-entries",
+      0,
+      this};
+
+  /**
+   * Controls whether fetching a tree from the BackingStore kicks off
+   * low-priority read-ahead of its child trees. Checkout and directory walks
+   * almost always fetch a parent followed by all of its children, so the
+   * read-ahead lets the child round trips overlap with inode
+   * materialization.
+   */
+  ConfigSetting<bool> childTreePrefetch{
+      "store:child-tree-prefetch",
+      false,
+      this};
+
+  /**
+   * Rate limit, in blobs per second, applied to blob prefetches started via
+   * the startPrefetch() Thrift API. Batches wait on a token bucket between
+   * fetches, so a large working-set warm-up trickles in without crowding
+   * out interactive fetches. 0 means unthrottled.
+   */
+  ConfigSetting<uint64_t> prefetchThrottleBlobsPerSecond{
+      "store:prefetch-throttle-blobs-per-second",
+      0,
+      this};
+
+  /**
+   * Controls whether the RocksDB local store is wrapped in an in-memory
+   * write-back tier. Writes to ephemeral key spaces complete in memory and
+   * are flushed to RocksDB in the background; persistent key spaces are
+   * still written through synchronously.
+   */
+  ConfigSetting<bool> useWriteBackLocalStore{
+      "store:use-write-back-cache",
+      false,
+      this};
+
+  /**
+   * When the RocksDB local store wants to garbage collect the caching
+   * column families, defer the collection if the store served at least this
+   * many operations since the previous management run, indicating the host
+   * is busy.  0 disables idle detection and collects immediately.
+   */
+  ConfigSetting<uint64_t> localStoreAutoGCIdleOpsThreshold{
+      "store:auto-gc-idle-operation-threshold",
+      0,
+      this};
+
+  /**
+   * The maximum number of consecutive management runs that may defer
+   * garbage collection waiting for an idle window.  Once reached the
+   * collection runs regardless of load, bounding how far the caches can
+   * grow past their limits.
+   */
+  ConfigSetting<uint64_t> localStoreAutoGCMaxDeferrals{
+      "store:auto-gc-max-deferrals",
+      4,
+      this};
+
   // [fuse]
 
   /**
@@ -425,6 +613,41 @@ class EdenConfig : private ConfigSettingManager {
       1000,
       this};
 
+  /**
+   * The number of pages the kernel may pack into a single FUSE request when
+   * it supports FUSE_MAX_PAGES (Linux 4.20+). Larger requests let the
+   * writeback cache flush dirty pages in bigger batches and reduce the
+   * number of FUSE_WRITE round trips for streaming writes. The kernel
+   * clamps values above 256 pages. 0 (the default) keeps the historical
+   * 32-page (128 KiB with 4 KiB pages) request size.
+   */
+  ConfigSetting<uint32_t> fuseMaximumRequestPages{
+      "fuse:max-request-pages",
+      0,
+      this};
+
+  /**
+   * The number of FUSE dispatcher threads to spawn per mount. Each thread
+   * reads requests from the FUSE device and runs the handler on the reading
+   * thread, so this bounds how many requests are serviced concurrently.
+   * 0 (the default) falls back to the --fuseNumThreads command line flag.
+   */
+  ConfigSetting<uint64_t> fuseNumDispatcherThreads{
+      "fuse:num-dispatcher-threads",
+      0,
+      this};
+
+  /**
+   * Pin each FUSE dispatcher thread to a CPU, spread round-robin across the
+   * online CPUs. Handlers run on the thread that read the request from the
+   * kernel, so pinning keeps the request buffer and the thread's cache state
+   * on one core for stat-heavy workloads. Only effective on Linux.
+   */
+  ConfigSetting<bool> fuseWorkerThreadCpuAffinity{
+      "fuse:worker-thread-cpu-affinity",
+      false,
+      this};
+
   /**
    * The maximum time duration allowed for a fuse request. If a request exceeds
    * this amount of time, an ETIMEDOUT error will be returned to the kernel to
@@ -455,6 +678,51 @@ class EdenConfig : private ConfigSettingManager {
    */
   ConfigSetting<uint32_t> maximumFuseRequests{"fuse:max-requests", 1000, this};
 
+  /**
+   * The maximum number of metadata requests (lookup, getattr, readdir,
+   * xattr and similar) that may be in flight in EdenFS at once. When the
+   * backing store degrades, metadata requests pile up behind slow imports
+   * and the mount appears hung; beyond this bound EdenFS fails additional
+   * metadata requests fast with EAGAIN so that dispatcher capacity remains
+   * available for read and write requests. Requests that move data or
+   * mutate state are never shed. 0 (the default) disables shedding.
+   */
+  ConfigSetting<uint64_t> fuseMaximumInflightLowPriorityRequests{
+      "fuse:max-inflight-low-priority-requests",
+      0,
+      this};
+
+  /**
+   * How long the kernel may cache dentries and inode attributes obtained
+   * from this FUSE mount. EdenFS explicitly invalidates kernel entries when
+   * checkout or a writer changes a path, so the default is effectively
+   * infinite (the largest value the macOS kext handles safely) and lets the
+   * kernel absorb repeated lookups of unchanged paths. Lower this only to
+   * diagnose suspected missed invalidations; sub-infinite values trade
+   * re-lookup traffic for robustness against invalidation bugs.
+   */
+  ConfigSetting<std::chrono::nanoseconds> fuseCacheTTL{
+      "fuse:cache-ttl",
+      std::chrono::seconds(std::numeric_limits<int32_t>::max()),
+      this};
+
+  /**
+   * Whether the first FUSE read of a blob-backed file pushes the entire
+   * blob into the kernel page cache with a FUSE_NOTIFY_STORE message.
+   * Prefetching (for example prefetchFiles) warms the EdenFS BlobCache,
+   * but every file still costs FUSE round trips the first time it is read.
+   * With this enabled, the whole blob is handed to the kernel as soon as
+   * the first read loads it, so the rest of the file is served from kernel
+   * memory with no further FUSE traffic. This trades extra page cache
+   * pressure for fewer round trips, which only pays off for workloads that
+   * go on to read most of every file they touch, such as builds over a
+   * prefetched checkout.
+   */
+  ConfigSetting<bool> fuseNotifyStoreBlobs{
+      "fuse:notify-store-blobs",
+      false,
+      this};
+
   // [nfs]
 
   /**
@@ -505,6 +773,17 @@ class EdenConfig : private ConfigSettingManager {
       1000,
       this};
 
+  /**
+   * Number of threads dedicated to NFS socket I/O.
+   *
+   * When non-zero, each NFS client connection is assigned round-robin to
+   * one of these threads' EventBase, so mounts that open several TCP
+   * connections to EdenFS scale with the connection count instead of
+   * serializing all socket reads and writes on the main EventBase. When
+   * zero, all connections share the main EventBase.
+   */
+  ConfigSetting<uint64_t> numNfsIoThreads{"nfs:num-io-threads", 0, this};
+
   /**
    * Buffer size for read and writes requests. Default to 16 KiB.
    *
@@ -514,6 +793,19 @@ class EdenConfig : private ConfigSettingManager {
    */
   ConfigSetting<uint32_t> nfsIoSize{"nfs:iosize", 16 * 1024, this};
 
+  /**
+   * Whether WRITE requests should honor the stability level requested by the
+   * client.
+   *
+   * When enabled, UNSTABLE writes are only buffered in the overlay's page
+   * cache and the client is told so, letting it gather many small writes
+   * and flush them with a single COMMIT instead of expecting durability
+   * after every 32KB chunk. DATA_SYNC and FILE_SYNC writes are flushed
+   * before replying. When disabled, EdenFS keeps its historical behavior of
+   * claiming FILE_SYNC stability without flushing.
+   */
+  ConfigSetting<bool> nfsUnstableWrites{"nfs:unstable-writes", false, this};
+
   /**
    * Whether EdenFS NFS sockets should bind themself to unix sockets instead of
    * TCP ones.
@@ -548,6 +840,17 @@ class EdenConfig : private ConfigSettingManager {
    */
   ConfigSetting<bool> useReaddirplus{"nfs:use-readdirplus", false, this};
 
+  /**
+   * When set to true, readdirplus resolves the attributes of clean, unloaded
+   * children directly from their source control entry and blob metadata
+   * instead of loading an inode for every entry in the directory. Loaded and
+   * materialized children are still statted through their inode.
+   */
+  ConfigSetting<bool> readdirplusAvoidInodeLoads{
+      "nfs:readdirplus-avoid-inode-loads",
+      false,
+      this};
+
   /**
    * On macOS, ._ (AppleDouble) are sprinkled all over the place. Enabling this
    * allows these file to be created. When disabled, the AppleDouble files
@@ -637,6 +940,32 @@ class EdenConfig : private ConfigSettingManager {
       true,
       this};
 
+  /**
+   * Cache directory enumerations and reuse them across enumeration
+   * sessions as long as the Journal position hasn't moved. Tools like
+   * Explorer restart enumeration sessions on the same unchanged directory
+   * over and over, and each session normally rebuilds the full entry list.
+   * Entries are invalidated whenever the Journal advances, so any write to
+   * the working copy drops the cached listings.
+   * Only applicable on Windows.
+   */
+  ConfigSetting<bool> prjfsUseEnumerationCaching{
+      "prjfs:use-enumeration-caching",
+      false,
+      this};
+
+  /**
+   * When hydrating a file larger than a single chunk, write the chunks to
+   * the ProjectedFS placeholder concurrently instead of one after the
+   * other. This cuts first-open latency for very large files at the cost
+   * of a handful of concurrently allocated write buffers.
+   * Only applicable on Windows.
+   */
+  ConfigSetting<bool> prjfsUseParallelHydration{
+      "prjfs:use-parallel-hydration",
+      false,
+      this};
+
   // [hg]
 
   /**
@@ -703,6 +1032,101 @@ class EdenConfig : private ConfigSettingManager {
       1024,
       this};
 
+  /**
+   * How long a worker will wait for more import requests to arrive when the
+   * dequeued batch is not yet full before dispatching it anyway. Bursty
+   * fetches rarely land in the queue at the exact same time, so without a
+   * window most dispatched batches contain a single request and the batch
+   * sizes above are never reached. A value of 0 dispatches immediately.
+   */
+  ConfigSetting<std::chrono::nanoseconds> importBatchWindow{
+      "hg:import-batch-window",
+      std::chrono::nanoseconds(0),
+      this};
+
+  /**
+   * Maximum number of dequeued-but-unfinished import requests a single mount
+   * may occupy at a time. Several mounts can share one backing store; with a
+   * limit in place, a massive prefetch on one mount leaves workers available
+   * for interactive fetches on the others. A value of 0 means unlimited.
+   * Requests whose mount is unknown are not limited.
+   */
+  ConfigSetting<uint64_t> maxInflightImportRequestsPerMount{
+      "hg:max-inflight-import-requests-per-mount",
+      0,
+      this};
+
+  /**
+   * When true, imports that do not already carry a deadline receive one
+   * derived from the rolling latency baseline of their operation class
+   * (tree, blob, blob metadata), and imports still queued when their
+   * deadline passes fail immediately instead of occupying a queue slot.
+   * During a partial store outage this fails hopeless requests fast and
+   * keeps the import workers available, rather than letting every request
+   * hang for minutes behind a stalled store.
+   */
+  ConfigSetting<bool> adaptiveImportDeadlines{
+      "hg:adaptive-import-deadlines",
+      false,
+      this};
+
+  /**
+   * Lower bound on an adaptively derived import deadline budget, so a
+   * very fast baseline (everything in the hgcache) cannot produce a
+   * deadline that normal queueing delay would trip.
+   */
+  ConfigSetting<std::chrono::nanoseconds> adaptiveImportDeadlineMin{
+      "hg:adaptive-import-deadline-min",
+      std::chrono::seconds(5),
+      this};
+
+  /**
+   * Upper bound on an adaptively derived import deadline budget, so a
+   * slow baseline cannot push the deadline out to the multi-minute hangs
+   * the deadlines exist to prevent.
+   */
+  ConfigSetting<std::chrono::nanoseconds> adaptiveImportDeadlineMax{
+      "hg:adaptive-import-deadline-max",
+      std::chrono::minutes(2),
+      this};
+
+  /**
+   * When a tree is imported, issue one batched LocalStore read for the proxy
+   * hashes of its entries that still use the legacy object ID format. Those
+   * entries are very likely to be fetched next, and a single MultiGet warms
+   * the RocksDB block cache ahead of the per-key lookups they would
+   * otherwise each pay for. Repositories that only contain embedded object
+   * IDs resolve proxy hashes in place and gain nothing from this.
+   */
+  ConfigSetting<bool> hgTreeProxyHashPrefetch{
+      "hg:tree-proxy-hash-prefetch",
+      false,
+      this};
+
+  /**
+   * Record the tree IDs imported from the server in the LocalStore, keyed by
+   * the checkout root they were imported under, and replay that log with
+   * low-priority fetches the next time the same root is mounted or checked
+   * out. After a rebase or a restart most of the same trees are walked
+   * again, so replaying the log overlaps their imports with the start of the
+   * walk instead of serializing them behind it.
+   */
+  ConfigSetting<bool> hgTreeFetchLog{"hg:tree-fetch-log", false, this};
+
+  /**
+   * If a demand tree import has not completed after this delay, issue a
+   * second fetch for the same tree directly against the datapack store and
+   * take whichever response arrives first. This trades a small amount of
+   * duplicated server work for a large cut in tail latency when a single
+   * fetch hits a network hiccup. The delay should be set well above the
+   * typical fetch latency (for example near its p99) so that only outliers
+   * are hedged. Set to 0 (the default) to disable hedging.
+   */
+  ConfigSetting<std::chrono::nanoseconds> hgHedgedTreeImportDelay{
+      "hg:hedged-tree-import-delay",
+      std::chrono::nanoseconds::zero(),
+      this};
+
   /**
    * Whether fetching trees should fall back on an external hg importer process.
    */
@@ -893,6 +1317,32 @@ class EdenConfig : private ConfigSettingManager {
       100,
       this};
 
+  /**
+   * Controls whether the in-process sampling profiler starts at daemon
+   * startup. It can also be toggled at runtime through the
+   * debugSetSamplingProfilerEnabled() thrift call. Only effective on Linux.
+   */
+  ConfigSetting<bool> profilerEnabled{"profiler:enabled", false, this};
+
+  /**
+   * How often the sampling profiler captures a stack from each registered
+   * thread.
+   */
+  ConfigSetting<std::chrono::nanoseconds> profilerSampleInterval{
+      "profiler:sample-interval",
+      std::chrono::milliseconds(100),
+      this};
+
+  /**
+   * Filesystem requests that take at least this long retain a critical-path
+   * trace of their stages, queryable via debugGetSlowRequestTraces. Zero
+   * disables slow-request tracing.
+   */
+  ConfigSetting<std::chrono::nanoseconds> slowRequestTraceThreshold{
+      "telemetry:slow-request-trace-threshold",
+      std::chrono::seconds(1),
+      this};
+
   // [experimental]
 
   /**
@@ -978,6 +1428,98 @@ class EdenConfig : private ConfigSettingManager {
       folly::kIsWindows,
       this};
 
+  /**
+   * The maximum number of checkout actions a directory runs against its
+   * children at once. Sibling subtrees are still checked out in parallel up
+   * to this bound; bounding the fan-out keeps a huge rebase from flooding
+   * the backing store queue and starving the demand fetches interleaved
+   * with it. 0 (the default) keeps the historical behavior of starting
+   * every child action at once.
+   */
+  ConfigSetting<uint64_t> maxConcurrentCheckoutActions{
+      "experimental:max-concurrent-checkout-actions",
+      0,
+      this};
+
+  /**
+   * The maximum number of child subtree walks a directory runs at once when
+   * invalidating non-materialized children (debugInvalidateNonMaterialized
+   * and working copy GC). When set, subtree walks are scheduled on the
+   * server thread pool, so a whole-mount walk runs in parallel across cores
+   * and yields between subtrees instead of crawling the mount inline on the
+   * calling thread. 0 (the default) keeps the historical behavior of
+   * walking every subtree inline.
+   */
+  ConfigSetting<uint64_t> maxConcurrentInvalidationWalks{
+      "experimental:max-concurrent-invalidation-walks",
+      0,
+      this};
+
+  /**
+   * The maximum number of deferred diff entries a directory runs against
+   * its children at once during a diff/status operation. Cheap single-file
+   * comparisons are scheduled ahead of recursive subtree walks regardless
+   * of this setting; bounding the fan-out keeps a status on a wide, heavily
+   * diverged directory from fetching every child subtree at once. 0 (the
+   * default) keeps the historical behavior of starting every deferred
+   * entry at once.
+   */
+  ConfigSetting<uint64_t> maxConcurrentDiffEntries{
+      "experimental:max-concurrent-diff-entries",
+      0,
+      this};
+
+  /**
+   * Glob patterns (gitignore syntax, matched against the file name)
+   * identifying short-lived scratch files created by build tools. When a
+   * matching file is unlinked, EdenFS tries in the background to
+   * dematerialize the containing directory chain again, so that scratch
+   * traffic does not leave the directories permanently materialized in the
+   * overlay. An empty list (the default) disables this.
+   */
+  ConfigSetting<std::vector<std::string>> volatileFilePatterns{
+      "experimental:volatile-file-patterns",
+      {},
+      this};
+
+  /**
+   * During periodic working copy garbage collection, hash materialized
+   * files and fold the ones whose contents still match their source
+   * control blob back to the unmaterialized state. Build tools that
+   * touch-then-restore files otherwise leave thousands of inodes
+   * permanently materialized, paying overlay read costs and inflating
+   * fsck and takeover time.
+   */
+  ConfigSetting<bool> dematerializeUnchangedFiles{
+      "experimental:dematerialize-unchanged-files",
+      false,
+      this};
+
+  /**
+   * When setPathObjectId applies a single tree below the root, check the
+   * tree out directly on the target directory instead of synthesizing a
+   * parent tree around it. The applied subtree root then stays
+   * source-referenced and a clean apply touches no overlay data beyond the
+   * parent chain. Untracked entries already present in the target directory
+   * are kept (regular checkout semantics) rather than replaced wholesale.
+   */
+  ConfigSetting<bool> setPathObjectIdLazyTreeApply{
+      "experimental:set-path-object-id-lazy-tree-apply",
+      false,
+      this};
+
+  /**
+   * After a graceful takeover, hydrate the remembered-inode records from the
+   * previous process into the InodeMap lazily, on first access, instead of
+   * constructing an entry for every record before the mount starts serving.
+   * This keeps post-takeover startup time independent of the number of
+   * remembered inodes.
+   */
+  ConfigSetting<bool> lazyTakeoverInodeHydration{
+      "experimental:lazy-takeover-inode-hydration",
+      false,
+      this};
+
   // [blobcache]
 
   /**
@@ -997,6 +1539,38 @@ class EdenConfig : private ConfigSettingManager {
       16,
       this};
 
+  /**
+   * Number of independent LRU shards the in-memory blob cache is split into.
+   * Each shard has its own lock and an equal slice of the size budget, so
+   * concurrent reads scale with cores instead of serializing on one lock. A
+   * value of 1 keeps the single-lock behavior.
+   */
+  ConfigSetting<size_t> inMemoryBlobCacheShards{"blobcache:shards", 1, this};
+
+  /**
+   * If enabled, blob cache eviction runs on a dedicated background thread.
+   * Inserts that push the cache over its size budget then only enqueue
+   * eviction work instead of evicting inline while the cache lock is held,
+   * keeping read latency flat during insert-heavy workloads at the cost of
+   * transiently exceeding the size budget.
+   */
+  ConfigSetting<bool> inMemoryBlobCacheBackgroundEviction{
+      "blobcache:background-eviction",
+      false,
+      this};
+
+  /**
+   * How many bytes of zstd-compressed blobs to keep in a second-chance tier
+   * behind the in-memory blob cache. Blobs evicted from the main cache to
+   * make room are compressed into this separate budget and decompressed on a
+   * later hit instead of being refetched from the backing store. A value of
+   * 0 disables the tier.
+   */
+  ConfigSetting<size_t> inMemoryBlobCacheCompressedVictimSize{
+      "blobcache:compressed-victim-cache-size",
+      0,
+      this};
+
   // [treecache]
 
   /**
@@ -1024,6 +1598,25 @@ class EdenConfig : private ConfigSettingManager {
       16,
       this};
 
+  /**
+   * Number of independent LRU shards the in-memory tree cache is split into.
+   * See blobcache:shards for the tradeoffs; a value of 1 keeps the
+   * single-lock behavior.
+   */
+  ConfigSetting<size_t> inMemoryTreeCacheShards{"treecache:shards", 1, this};
+
+  /**
+   * Percentage of the tree cache's byte budget reserved for a protected LRU
+   * segment that only admits trees hit more than once. This makes the cache
+   * scan resistant: a one-off recursive walk over the repository churns the
+   * probationary segment without evicting the hot root-adjacent trees. A
+   * value of 0 disables segmentation and keeps the plain LRU behavior.
+   */
+  ConfigSetting<size_t> inMemoryTreeCacheProtectedSegmentPercent{
+      "treecache:protected-segment-percent",
+      0,
+      this};
+
   // [notifications]
 
   /**
@@ -1074,6 +1667,55 @@ class EdenConfig : private ConfigSettingManager {
   ConfigSetting<uint64_t> maxLogFileSize{"log:max-file-size", 50000000, this};
   ConfigSetting<uint64_t> maxRotatedLogFiles{"log:num-rotated-logs", 3, this};
 
+  // [monitor]
+
+  /**
+   * Latency, in microseconds, above which the monitor's performance
+   * watchdog considers a polled percentile counter breached. 0 disables
+   * the watchdog.
+   */
+  ConfigSetting<uint64_t> monitorPerfWatchdogThresholdUs{
+      "monitor:perf-watchdog-threshold-us",
+      0,
+      this};
+
+  /**
+   * Regex selecting the fb303 counters that the performance watchdog
+   * polls. The default matches the one-minute p99 of every filesystem
+   * channel latency histogram.
+   */
+  ConfigSetting<std::string> monitorPerfWatchdogCounterPattern{
+      "monitor:perf-watchdog-counter-pattern",
+      "^(fuse|nfs|prjfs)\\..*_us\\.p99\\.60$",
+      this};
+
+  /**
+   * How often the performance watchdog polls the daemon's counters.
+   */
+  ConfigSetting<std::chrono::nanoseconds> monitorPerfWatchdogInterval{
+      "monitor:perf-watchdog-interval",
+      std::chrono::seconds(30),
+      this};
+
+  /**
+   * Number of consecutive breached polls before the watchdog captures a
+   * diagnostic report. Values above 1 keep one-off latency spikes from
+   * triggering a capture.
+   */
+  ConfigSetting<uint64_t> monitorPerfWatchdogBreachPolls{
+      "monitor:perf-watchdog-breach-polls",
+      3,
+      this};
+
+  /**
+   * Minimum time between two diagnostic captures, so that a long incident
+   * produces one report rather than one per poll.
+   */
+  ConfigSetting<std::chrono::nanoseconds> monitorPerfWatchdogCooldown{
+      "monitor:perf-watchdog-cooldown",
+      std::chrono::minutes(10),
+      this};
+
   // [prefetch-profiles]
 
   /**
@@ -1175,6 +1817,28 @@ class EdenConfig : private ConfigSettingManager {
       std::chrono::minutes(1),
       this};
 
+  /**
+   * Soft limit, in bytes, on the amount of materialized file data stored in
+   * each mount's overlay. Crossing the soft limit only logs a warning so
+   * runaway overlay growth is visible before it fills the disk. 0 disables
+   * the check.
+   */
+  ConfigSetting<uint64_t> overlaySoftSizeLimit{
+      "overlay:size-soft-limit",
+      0,
+      this};
+
+  /**
+   * Hard limit, in bytes, on the amount of materialized file data stored in
+   * each mount's overlay. While over the hard limit, writes that would grow
+   * overlay files fail with ENOSPC; reads and truncation still succeed so
+   * tools can recover by deleting or reverting files. 0 disables the check.
+   */
+  ConfigSetting<uint64_t> overlayHardSizeLimit{
+      "overlay:size-hard-limit",
+      0,
+      this};
+
   /**
    * Determines if EdenFS should enable the option to buffer overlay writes.
    * This only works with SQLite backed overlays.
@@ -1191,6 +1855,60 @@ class EdenConfig : private ConfigSettingManager {
       64 * 1024 * 1024,
       this};
 
+  /**
+   * Maximum number of queued overlay writes the
+   * BufferedSqliteInodeCatalog's worker thread commits in one SQLite
+   * transaction. A burst of writes drained from the buffer together is
+   * committed together instead of one transaction per write, which bounds
+   * how long a commit can defer durability. 0 disables group commit and
+   * every write commits individually.
+   */
+  ConfigSetting<size_t> overlayGroupCommitMaxOperations{
+      "overlay:group-commit-max-operations",
+      256,
+      this};
+
+  /**
+   * Request transparent hugepage backing for the memory-mapped inode
+   * metadata table. Only has an effect on Linux; other platforms ignore it.
+   * The table is always prefaulted at open, so this only changes how the
+   * kernel backs the mapping.
+   */
+  ConfigSetting<bool> overlayInodeMetadataTableHugePages{
+      "overlay:inode-metadata-table-huge-pages",
+      false,
+      this};
+
+  /**
+   * Write new overlay files at their final path instead of writing to a
+   * temporary file and renaming it into place. This halves the directory
+   * metadata operations per materialized file, which is significant for
+   * workloads that create many small files (e.g. untar into the mount). The
+   * tradeoff is that a crash mid-creation can leave a truncated overlay file
+   * behind rather than no file; fsck detects and repairs such files on the
+   * next mount. The root inode always uses the atomic path regardless of
+   * this setting.
+   */
+  ConfigSetting<bool> overlayDirectFileCreation{
+      "overlay:direct-file-creation",
+      false,
+      this};
+
+  /**
+   * Periodically persist an upper bound on the allocated inode numbers to
+   * the overlay. The bound is written before any inode number below it is
+   * handed out, so after a crash the overlay can resume from the checkpoint
+   * instead of running a full fsck scan to recompute the next inode number.
+   * As with fsck:open-dirty, validation of individual overlay entries is
+   * deferred to first access. Only used by the Legacy overlay; do not
+   * disable this setting without a clean shutdown, since a checkpoint from
+   * an earlier run would otherwise go stale.
+   */
+  ConfigSetting<bool> overlayInodeNumberCheckpointing{
+      "overlay:inode-number-checkpointing",
+      false,
+      this};
+
   /**
    * Number of OverlayFile and metadata cached in memory.
    */
@@ -1223,6 +1941,23 @@ class EdenConfig : private ConfigSettingManager {
    */
   ConfigSetting<bool> multiThreadedFsck{"fsck:multi-threaded", true, this};
 
+  /**
+   * Number of threads used to scan overlay shards during unclean-mount fsck.
+   * 0 picks a value based on the number of CPUs. Large overlays recover
+   * faster with more scan threads, at the cost of more IO pressure during
+   * recovery.
+   */
+  ConfigSetting<uint32_t> fsckNumScanThreads{"fsck:num-scan-threads", 0, this};
+
+  /**
+   * Open the overlay immediately after an unclean shutdown instead of running
+   * a full fsck scan first. The next inode number is derived from a cheap
+   * enumeration of the shard directory entry names; no file contents are read
+   * or repaired, so corrupt entries surface as errors on first access and
+   * orphaned files are left in place until the next full fsck.
+   */
+  ConfigSetting<bool> fsckOpenDirty{"fsck:open-dirty", false, this};
+
   // [glob]
 
   /**
@@ -1236,6 +1971,51 @@ class EdenConfig : private ConfigSettingManager {
       true,
       this};
 
+  /**
+   * Whether independent subtree evaluations of a glob run on the server's
+   * thread pool rather than inline on the Thrift thread. Wide recursive
+   * globs over large repositories benefit from the extra parallelism when
+   * trees are already cached.
+   */
+  ConfigSetting<bool> globUseParallelEvaluation{
+      "glob:use-parallel-evaluation",
+      false,
+      this};
+
+  /**
+   * Whether completed recursive suffix queries (globs matching every file
+   * with a given extension) evaluated against explicit revisions are cached
+   * and replayed. Commit trees are immutable, so the same revisions and
+   * patterns always produce the same results.
+   */
+  ConfigSetting<bool> globUseSuffixQueryCache{
+      "glob:use-suffix-query-cache",
+      false,
+      this};
+
+  /**
+   * Whether predictiveGlobFiles results are cached and replayed. Entries are
+   * keyed by the checked-out commit and the prediction profile, and are
+   * revalidated against the journal: any working copy modification since the
+   * result was computed forces a fresh evaluation.
+   */
+  ConfigSetting<bool> globUsePredictiveGlobCache{
+      "glob:use-predictive-glob-cache",
+      false,
+      this};
+
+  /**
+   * Whether globs without explicit revisions are evaluated against raw
+   * Trees from the store when the mount's root is not materialized. A
+   * non-materialized working copy is byte-identical to its checked out
+   * commit, so the results are the same as walking inodes, without
+   * registering an inode for every directory the glob visits.
+   */
+  ConfigSetting<bool> globUseTreeEvaluation{
+      "glob:use-tree-evaluation",
+      true,
+      this};
+
   // [doctor]
 
   /**
@@ -1263,6 +2043,18 @@ class EdenConfig : private ConfigSettingManager {
       std::nullopt,
       this};
 
+  /**
+   * Materialized files at least this large have their SHA-1 and BLAKE3
+   * recomputed on the server thread pool instead of inline on the calling
+   * thread. Hashing reads the whole file, so an inline recomputation of a
+   * multi-GB artifact would pin an FsChannel dispatcher thread for the
+   * entire read.
+   */
+  ConfigSetting<uint64_t> hashOffloadSizeThreshold{
+      "hash:offload-size-threshold",
+      16 * 1024 * 1024,
+      this};
+
   // [facebook]
   // Facebook internal
 
@@ -12,11 +12,12 @@ namespace facebook::eden {
 namespace {
 
 constexpr auto readdirPrefetchStr = [] {
-  std::array<folly::StringPiece, 4> mapping{};
+  std::array<folly::StringPiece, 5> mapping{};
   mapping[folly::to_underlying(ReaddirPrefetch::None)] = "none";
   mapping[folly::to_underlying(ReaddirPrefetch::Files)] = "files";
   mapping[folly::to_underlying(ReaddirPrefetch::Trees)] = "trees";
   mapping[folly::to_underlying(ReaddirPrefetch::Both)] = "both";
+  mapping[folly::to_underlying(ReaddirPrefetch::Adaptive)] = "adaptive";
   return mapping;
 }();
 
@@ -16,6 +16,13 @@ enum class ReaddirPrefetch {
   Files,
   Trees,
   Both,
+  /**
+   * Prefetch both files and trees, but only for directories whose past
+   * readdirs were followed by accesses to their children. Directories
+   * without history fall back to the readdir-then-stat heuristic, and the
+   * observed pattern feeds the history for next time.
+   */
+  Adaptive,
 };
 
 template <>
@@ -7,6 +7,7 @@
 
 #include "eden/fs/config/ReloadableConfig.h"
 
+#include "eden/fs/config/ConfigFileWatcher.h"
 #include "eden/fs/config/EdenConfig.h"
 #include "eden/fs/utils/Bug.h"
 #include "eden/fs/utils/EnumValue.h"
@@ -22,54 +23,103 @@ constexpr std::chrono::seconds kEdenConfigMinimumPollDuration{5};
 namespace facebook::eden {
 
 ReloadableConfig::ReloadableConfig(std::shared_ptr<const EdenConfig> config)
-    : state_{ConfigState{std::move(config)}} {}
+    : config_{std::move(config)} {
+  readMostlyConfig_.store(config_.load(std::memory_order_acquire));
+}
 
 ReloadableConfig::ReloadableConfig(
     std::shared_ptr<const EdenConfig> config,
     ConfigReloadBehavior reloadBehavior)
-    : state_{ConfigState{std::move(config)}}, reloadBehavior_{reloadBehavior} {}
+    : config_{std::move(config)}, reloadBehavior_{reloadBehavior} {
+  readMostlyConfig_.store(config_.load(std::memory_order_acquire));
+}
 
 ReloadableConfig::~ReloadableConfig() = default;
 
-std::shared_ptr<const EdenConfig> ReloadableConfig::getEdenConfig(
-    ConfigReloadBehavior reload) {
-  auto now = std::chrono::steady_clock::now();
+void ReloadableConfig::startFileWatcher() {
+  if (!ConfigFileWatcher::isSupported() || watcher_) {
+    return;
+  }
 
+  std::vector<std::string> paths;
+  auto config = config_.load(std::memory_order_acquire);
+  for (auto sourceType :
+       {ConfigSourceType::SystemConfig, ConfigSourceType::UserConfig}) {
+    auto path = config->toSourcePath(sourceType);
+    if (!path.empty()) {
+      paths.push_back(std::move(path));
+    }
+  }
+
+  watcher_ = std::make_unique<ConfigFileWatcher>(std::move(paths), [this] {
+    changeGeneration_.fetch_add(1, std::memory_order_release);
+  });
+}
+
+bool ReloadableConfig::checkNeedsReload(
+    ConfigReloadBehavior reload,
+    std::chrono::steady_clock::time_point now) {
   if (reloadBehavior_.has_value()) {
     reload = reloadBehavior_.value();
   }
 
-  bool shouldReload;
   switch (reload) {
     case ConfigReloadBehavior::NoReload:
-      shouldReload = false;
-      break;
+      return false;
     case ConfigReloadBehavior::ForceReload:
-      shouldReload = true;
-      break;
+      return true;
     case ConfigReloadBehavior::AutoReload: {
+      if (watcher_) {
+        // The watcher bumps changeGeneration_ whenever a config file may
+        // have changed, so no stat calls or throttling are needed here.
+        return loadedGeneration_.load(std::memory_order_acquire) !=
+            changeGeneration_.load(std::memory_order_acquire);
+      }
       auto lastCheck = lastCheck_.load(std::memory_order_acquire);
-      shouldReload = now - lastCheck >= kEdenConfigMinimumPollDuration;
-      break;
+      return now - lastCheck >= kEdenConfigMinimumPollDuration;
     }
-    default:
-      EDEN_BUG() << "Unexpected reload flag: " << enumValue(reload);
-  }
-
-  if (!shouldReload) {
-    return state_.rlock()->config;
   }
+  EDEN_BUG() << "Unexpected reload flag: " << enumValue(reload);
+}
 
-  auto state = state_.wlock();
+std::shared_ptr<const EdenConfig> ReloadableConfig::performReload(
+    std::chrono::steady_clock::time_point now) {
+  std::lock_guard<std::mutex> guard{reloadMutex_};
 
   // Throttle the updates when using ConfigReloadBehavior::AutoReload
   lastCheck_.store(now, std::memory_order_release);
 
-  auto& config = state->config;
+  // Read the generation before reloading: a change arriving in between keeps
+  // the generations unequal, so the next AutoReload call reloads again.
+  auto generation = changeGeneration_.load(std::memory_order_acquire);
+
+  auto config = config_.load(std::memory_order_acquire);
   if (auto newConfig = config->maybeReload()) {
-    state->config = std::move(newConfig);
+    config = std::move(newConfig);
+    config_.store(config, std::memory_order_release);
+    readMostlyConfig_.store(config);
+  }
+  loadedGeneration_.store(generation, std::memory_order_release);
+  return config;
+}
+
+std::shared_ptr<const EdenConfig> ReloadableConfig::getEdenConfig(
+    ConfigReloadBehavior reload) {
+  auto now = std::chrono::steady_clock::now();
+  if (!checkNeedsReload(reload, now)) {
+    return config_.load(std::memory_order_acquire);
+  }
+  return performReload(now);
+}
+
+folly::ReadMostlySharedPtr<const EdenConfig>
+ReloadableConfig::getEdenConfigReadMostly(ConfigReloadBehavior reload) {
+  auto now = std::chrono::steady_clock::now();
+  if (!checkNeedsReload(reload, now)) {
+    return readMostlyConfig_.load();
   }
-  return state->config;
+  performReload(now);
+  return readMostlyConfig_.load();
 }
 
 } // namespace facebook::eden
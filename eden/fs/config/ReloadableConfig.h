@@ -10,13 +10,16 @@
 #include <atomic>
 #include <chrono>
 #include <memory>
+#include <mutex>
 
-#include <folly/Synchronized.h>
+#include <folly/concurrency/AtomicSharedPtr.h>
+#include <folly/experimental/AtomicReadMostlyMainPtr.h>
 
 #include "eden/fs/config/gen-cpp2/eden_config_types.h"
 
 namespace facebook::eden {
 
+class ConfigFileWatcher;
 class EdenConfig;
 
 // It's unclear to me (chadaustin) whether `atomic<time_point>` is
@@ -62,12 +65,74 @@ class ReloadableConfig {
   std::shared_ptr<const EdenConfig> getEdenConfig(
       ConfigReloadBehavior reload = ConfigReloadBehavior::AutoReload);
 
+  /**
+   * Like getEdenConfig(), but acquires the snapshot through a read-mostly
+   * pointer whose refcount is sharded across cores.  Prefer this on request
+   * hot paths: unlike a shared_ptr copy, it does not bounce a refcount cache
+   * line between cores.  The returned pointer should be short-lived (e.g.
+   * held for the duration of one request).
+   */
+  folly::ReadMostlySharedPtr<const EdenConfig> getEdenConfigReadMostly(
+      ConfigReloadBehavior reload = ConfigReloadBehavior::AutoReload);
+
+  /**
+   * Start watching the files backing this configuration for changes.
+   *
+   * While a watcher is running, AutoReload callers only compare two atomic
+   * generation counters instead of periodically stat()ing the config files,
+   * and reloads happen as soon as a file is replaced rather than on the next
+   * poll interval.  No-op on platforms without inotify support; those keep
+   * the time-throttled stat polling.
+   */
+  void startFileWatcher();
+
  private:
-  struct ConfigState {
-    std::shared_ptr<const EdenConfig> config;
-  };
+  /**
+   * Returns whether the given reload behavior requires checking the config
+   * sources for changes right now.
+   */
+  bool checkNeedsReload(
+      ConfigReloadBehavior reload,
+      std::chrono::steady_clock::time_point now);
+
+  /**
+   * The slow path: reload any changed sources under reloadMutex_ and publish
+   * the result to both config_ and readMostlyConfig_.
+   */
+  std::shared_ptr<const EdenConfig> performReload(
+      std::chrono::steady_clock::time_point now);
+
+  /**
+   * The current config.  Read lock-free on every getEdenConfig() call;
+   * replaced under reloadMutex_ when a source changes.
+   */
+  folly::atomic_shared_ptr<const EdenConfig> config_;
+
+  /**
+   * Mirror of config_ with core-sharded reader refcounts, serving
+   * getEdenConfigReadMostly().
+   */
+  folly::AtomicReadMostlyMainPtr<const EdenConfig> readMostlyConfig_;
+
+  /**
+   * Serializes reload attempts.  Never held on the no-change fast path.
+   */
+  std::mutex reloadMutex_;
+
+  /**
+   * Incremented by the file watcher whenever a config file may have changed.
+   * Starts at 1 so the generation a fresh watcher reports is never equal to
+   * the initial loadedGeneration_ below.
+   */
+  std::atomic<uint64_t> changeGeneration_{1};
+
+  /**
+   * The value of changeGeneration_ that the current config_ reflects.
+   */
+  std::atomic<uint64_t> loadedGeneration_{0};
+
+  std::unique_ptr<ConfigFileWatcher> watcher_;
 
-  folly::Synchronized<ConfigState> state_;
   AtomicTimePoint<std::chrono::steady_clock> lastCheck_{
       std::chrono::steady_clock::time_point{},
   };
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#ifdef __linux__
+
+#include <folly/FileUtil.h>
+#include <folly/experimental/TestUtil.h>
+#include <folly/synchronization/Baton.h>
+#include <gtest/gtest.h>
+
+#include "eden/fs/config/ConfigFileWatcher.h"
+
+using facebook::eden::ConfigFileWatcher;
+
+TEST(ConfigFileWatcherTest, isSupported) {
+  EXPECT_TRUE(ConfigFileWatcher::isSupported());
+}
+
+TEST(ConfigFileWatcherTest, notifiesOnRenameIntoPlace) {
+  folly::test::TemporaryDirectory testDir;
+  auto configPath = (testDir.path() / "edenfs.rc").string();
+  auto tempPath = (testDir.path() / "edenfs.rc.tmp").string();
+  ASSERT_TRUE(folly::writeFile(std::string{"[core]\n"}, configPath.c_str()));
+
+  folly::Baton<> changed;
+  ConfigFileWatcher watcher{{configPath}, [&] { changed.post(); }};
+
+  // Config files are typically updated by renaming a temporary file into
+  // place; this must be observed even though the original inode goes away.
+  ASSERT_TRUE(folly::writeFile(std::string{"[core]\nx = 1\n"}, tempPath.c_str()));
+  ASSERT_EQ(0, rename(tempPath.c_str(), configPath.c_str()));
+
+  EXPECT_TRUE(changed.try_wait_for(std::chrono::seconds(10)));
+}
+
+TEST(ConfigFileWatcherTest, ignoresUnrelatedFiles) {
+  folly::test::TemporaryDirectory testDir;
+  auto configPath = (testDir.path() / "edenfs.rc").string();
+  auto otherPath = (testDir.path() / "unrelated").string();
+  ASSERT_TRUE(folly::writeFile(std::string{"[core]\n"}, configPath.c_str()));
+
+  folly::Baton<> changed;
+  ConfigFileWatcher watcher{{configPath}, [&] { changed.post(); }};
+
+  ASSERT_TRUE(folly::writeFile(std::string{"noise"}, otherPath.c_str()));
+
+  // Modify the watched file afterwards; if the unrelated write had notified,
+  // the baton would already be posted and this wait would return before the
+  // rename below is observed.
+  EXPECT_FALSE(changed.try_wait_for(std::chrono::milliseconds(200)));
+
+  ASSERT_TRUE(
+      folly::writeFile(std::string{"[core]\nx = 1\n"}, configPath.c_str()));
+  EXPECT_TRUE(changed.try_wait_for(std::chrono::seconds(10)));
+}
+
+#endif // __linux__
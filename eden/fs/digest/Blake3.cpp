@@ -7,16 +7,28 @@
 
 #include "eden/fs/digest/Blake3.h"
 
+#include <cstring>
 #include <stdexcept>
 
 #include <blake3.h> // @manual
 
 namespace facebook::eden {
 
+Blake3::Key::Key(folly::ByteRange key) {
+  if (key.size() != BLAKE3_KEY_LEN) {
+    throw std::invalid_argument("Invalid key size, it must be 32 bytes length");
+  }
+  memcpy(bytes_, key.data(), BLAKE3_KEY_LEN);
+}
+
 Blake3::Blake3() {
   blake3_hasher_init(&hasher_);
 }
 
+Blake3::Blake3(const Key& key) {
+  blake3_hasher_init_keyed(&hasher_, key.bytes());
+}
+
 Blake3::Blake3(folly::ByteRange key) {
   if (key.size() != BLAKE3_KEY_LEN) {
     throw std::invalid_argument("Invalid key size, it must be 32 bytes length");
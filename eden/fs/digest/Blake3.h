@@ -16,6 +16,29 @@
 namespace facebook::eden {
 
 struct Blake3 final {
+  /**
+   * A parsed and length-validated 32-byte key.
+   *
+   * BLAKE3's keyed mode uses the key words directly as the initial chaining
+   * value, so there is no expensive derivation worth caching; what parsing
+   * the key once saves is re-validating and re-plumbing the configured key
+   * string on every hasher construction in per-blob paths.
+   */
+  class Key {
+   public:
+    /**
+     * Throws std::invalid_argument unless the key is exactly 32 bytes.
+     */
+    explicit Key(folly::ByteRange key);
+
+    const uint8_t (&bytes() const)[BLAKE3_KEY_LEN] {
+      return bytes_;
+    }
+
+   private:
+    uint8_t bytes_[BLAKE3_KEY_LEN];
+  };
+
   Blake3();
 
   /*
@@ -26,6 +49,12 @@ struct Blake3 final {
    */
   explicit Blake3(folly::ByteRange key);
 
+  /**
+   * Initialize a blake3_hasher in the keyed hashing mode from an already
+   * validated key, skipping the per-use size check.
+   */
+  explicit Blake3(const Key& key);
+
   static Blake3 create(std::optional<folly::ByteRange> key);
   static Blake3 create(const std::optional<std::string>& key);
   static Blake3 create(std::optional<folly::StringPiece> key);
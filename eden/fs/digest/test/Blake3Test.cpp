@@ -46,6 +46,25 @@ TEST(Blake3, keyedBlake3Test) {
       "762a2729ed3c2c1b5ec9523761e43bf215589dc8f1844a11a6a987f19cfab0e0");
 }
 
+TEST(Blake3, parsedKeyBlake3Test) {
+  const Blake3::Key key{folly::ByteRange(kKey)};
+  Blake3 blake3(key);
+  blake3.update(kData);
+  std::array<uint8_t, 32> out;
+  blake3.finalize(folly::MutableByteRange(out.data(), out.size()));
+
+  // Hashing with a pre-parsed key matches hashing with the raw key bytes.
+  EXPECT_EQ(
+      folly::hexlify(folly::ByteRange(out.data(), out.size())),
+      "762a2729ed3c2c1b5ec9523761e43bf215589dc8f1844a11a6a987f19cfab0e0");
+}
+
+TEST(Blake3, invalidKeySizeTest) {
+  EXPECT_THROW(
+      Blake3::Key{folly::ByteRange(folly::StringPiece{"too short"})},
+      std::invalid_argument);
+}
+
 TEST(Blake3, blake3EmptyTest) {
   Blake3 blake3;
   std::array<uint8_t, 32> out;
@@ -10,11 +10,18 @@
 #include "eden/fs/fuse/FuseChannel.h"
 #include <boost/cast.hpp>
 #include <fmt/core.h>
+#include <folly/container/F14Map.h>
+#include <folly/container/F14Set.h>
 #include <folly/executors/QueuedImmediateExecutor.h>
 #include <folly/futures/Future.h>
+#include <folly/Utility.h>
 #include <folly/logging/xlog.h>
 #include <folly/system/ThreadName.h>
 #include <chrono>
+#include <thread>
+#ifdef __linux__
+#include <sched.h>
+#endif
 #include <csignal>
 #include <type_traits>
 #include "eden/common/utils/Synchronized.h"
@@ -25,9 +32,11 @@
 #include "eden/fs/telemetry/FsEventLogger.h"
 #include "eden/fs/utils/Bug.h"
 #include "eden/fs/utils/IDGen.h"
+#include "eden/fs/utils/RefPtr.h"
 #include "eden/fs/utils/StaticAssert.h"
 #include "eden/fs/utils/SystemError.h"
 #include "eden/fs/utils/Thread.h"
+#include "eden/fs/utils/ThreadSampler.h"
 
 using namespace folly;
 using std::string;
@@ -607,6 +616,32 @@ SamplingGroup fuseOpcodeSamplingGroup(uint32_t opcode) {
   return entry ? entry->samplingGroup : SamplingGroup::DropAll;
 }
 
+/**
+ * Returns true for opcodes that may be failed fast with EAGAIN when the
+ * dispatcher is saturated, typically because the backing store is degraded
+ * and imports are slow.
+ *
+ * Only read-only metadata queries are eligible: applications can retry them
+ * and no state is lost if they fail. Opcodes that move file data (READ,
+ * WRITE) or mutate state (create, unlink, rename, setattr, RELEASE, FORGET,
+ * FLUSH, fsync) are never shed; erroring those would corrupt application
+ * behavior rather than just slow it down.
+ */
+bool isLowPriorityOpcode(uint32_t opcode) {
+  switch (opcode) {
+    case FUSE_LOOKUP:
+    case FUSE_GETATTR:
+    case FUSE_READLINK:
+    case FUSE_READDIR:
+    case FUSE_GETXATTR:
+    case FUSE_LISTXATTR:
+    case FUSE_ACCESS:
+      return true;
+    default:
+      return false;
+  }
+}
+
 } // namespace
 
 StringPiece fuseOpcodeName(uint32_t opcode) {
@@ -623,6 +658,9 @@ ProcessAccessLog::AccessType fuseOpcodeAccessType(uint32_t opcode) {
 FuseChannel::DataRange::DataRange(int64_t off, int64_t len)
     : offset(off), length(len) {}
 
+FuseChannel::StoreData::StoreData(uint64_t off, std::unique_ptr<folly::IOBuf> d)
+    : offset(off), data(std::move(d)) {}
+
 FuseChannel::InvalidationEntry::InvalidationEntry(
     InodeNumber num,
     PathComponentPiece n)
@@ -639,6 +677,14 @@ FuseChannel::InvalidationEntry::InvalidationEntry(Promise<Unit> p)
       inode(kRootNodeId),
       promise(std::move(p)) {}
 
+FuseChannel::InvalidationEntry::InvalidationEntry(
+    InodeNumber num,
+    uint64_t offset,
+    std::unique_ptr<folly::IOBuf> data)
+    : type(InvalidationType::STORE),
+      inode(num),
+      store(offset, std::move(data)) {}
+
 FuseChannel::InvalidationEntry::~InvalidationEntry() {
   switch (type) {
     case InvalidationType::INODE:
@@ -650,6 +696,9 @@ FuseChannel::InvalidationEntry::~InvalidationEntry() {
     case InvalidationType::FLUSH:
       promise.~Promise();
       return;
+    case InvalidationType::STORE:
+      store.~StoreData();
+      return;
   }
   XLOG(FATAL) << "unknown InvalidationEntry type: "
               << static_cast<uint64_t>(type);
@@ -659,7 +708,8 @@ FuseChannel::InvalidationEntry::
     InvalidationEntry(InvalidationEntry&& other) noexcept(
         std::is_nothrow_move_constructible_v<PathComponent>&&
             std::is_nothrow_move_constructible_v<folly::Promise<folly::Unit>>&&
-                std::is_nothrow_move_constructible_v<DataRange>)
+                std::is_nothrow_move_constructible_v<DataRange>&&
+                    std::is_nothrow_move_constructible_v<StoreData>)
     : type(other.type), inode(other.inode) {
   switch (type) {
     case InvalidationType::INODE:
@@ -671,6 +721,9 @@ FuseChannel::InvalidationEntry::
     case InvalidationType::FLUSH:
       new (&promise) Promise<Unit>(std::move(other.promise));
       return;
+    case InvalidationType::STORE:
+      new (&store) StoreData(std::move(other.store));
+      return;
   }
 }
 
@@ -686,6 +739,12 @@ std::ostream& operator<<(
                 << "\")";
     case FuseChannel::InvalidationType::FLUSH:
       return os << "(invalidation flush)";
+    case FuseChannel::InvalidationType::STORE:
+      return os << "(inode " << entry.inode << ", store offset "
+                << entry.store.offset << ", length "
+                << (entry.store.data ? entry.store.data->computeChainDataLength()
+                                     : 0)
+                << ")";
   }
   return os << "(unknown invalidation type "
             << static_cast<uint64_t>(entry.type) << " inode " << entry.inode
@@ -794,7 +853,10 @@ FuseChannel::FuseChannel(
     bool requireUtf8Path,
     int32_t maximumBackgroundRequests,
     bool useWriteBackCache,
-    size_t fuseTraceBusCapacity)
+    size_t fuseTraceBusCapacity,
+    bool workerThreadCpuAffinity,
+    size_t maximumRequestPages,
+    size_t maximumInflightLowPriorityRequests)
     : privHelper_{privHelper},
       bufferSize_(std::max(size_t(getpagesize()) + 0x1000, MIN_BUFSIZE)),
       numThreads_(numThreads),
@@ -807,6 +869,9 @@ FuseChannel::FuseChannel(
       requireUtf8Path_{requireUtf8Path},
       maximumBackgroundRequests_{maximumBackgroundRequests},
       useWriteBackCache_{useWriteBackCache},
+      workerThreadCpuAffinity_{workerThreadCpuAffinity},
+      maximumRequestPages_{maximumRequestPages},
+      maximumInflightLowPriorityRequests_{maximumInflightLowPriorityRequests},
       fuseDevice_(std::move(fuseDevice)),
       processAccessLog_(std::move(processInfoCache)),
       traceDetailedArguments_(std::make_shared<std::atomic<size_t>>(0)),
@@ -878,6 +943,11 @@ Future<FuseChannel::StopFuture> FuseChannel::initialize() {
 FuseChannel::StopFuture FuseChannel::initializeFromTakeover(
     fuse_init_out connInfo) {
   connInfo_ = connInfo;
+  // The previous edenfs may have negotiated a larger max_write than our
+  // default read buffer holds; grow the buffer so we can receive those
+  // writes. The worker threads have not started yet.
+  bufferSize_ =
+      std::max(bufferSize_, size_t{connInfo.max_write} + size_t{0x1000});
   dispatcher_->initConnection(connInfo);
   XLOG(DBG1) << "Takeover using max_write=" << connInfo_->max_write
              << ", max_readahead=" << connInfo_->max_readahead
@@ -969,6 +1039,16 @@ void FuseChannel::invalidateEntry(InodeNumber parent, PathComponentPiece name) {
   invalidationCV_.notify_one();
 }
 
+void FuseChannel::storeData(
+    InodeNumber ino,
+    uint64_t offset,
+    std::unique_ptr<folly::IOBuf> data) {
+  // Add the entry to invalidationQueue_ and wake up the invalidation thread to
+  // send it.
+  invalidationQueue_.lock()->queue.emplace_back(ino, offset, std::move(data));
+  invalidationCV_.notify_one();
+}
+
 void FuseChannel::invalidateInodes(folly::Range<InodeNumber*> range) {
   {
     auto queue = invalidationQueue_.lock();
@@ -1003,6 +1083,62 @@ ImmediateFuture<folly::Unit> FuseChannel::completeInvalidations() {
   return result;
 }
 
+size_t FuseChannel::dedupInvalidations(std::vector<InvalidationEntry>& entries) {
+  if (entries.size() < 2) {
+    return 0;
+  }
+
+  size_t removed = 0;
+  std::vector<bool> drop(entries.size(), false);
+  folly::F14FastSet<InodeNumber> seenInodes;
+  folly::F14FastMap<InodeNumber, folly::F14FastSet<PathComponentPiece>>
+      seenEntries;
+  for (size_t i = 0; i < entries.size(); ++i) {
+    auto& entry = entries[i];
+    switch (entry.type) {
+      case InvalidationType::INODE:
+        // Only full invalidations are deduplicated. Ranged invalidations are
+        // rare and cheap enough to just send.
+        if (entry.range.offset == 0 && entry.range.length == 0 &&
+            !seenInodes.insert(entry.inode).second) {
+          drop[i] = true;
+          ++removed;
+        }
+        break;
+      case InvalidationType::DIR_ENTRY:
+        if (!seenEntries[entry.inode].insert(entry.name.piece()).second) {
+          drop[i] = true;
+          ++removed;
+        }
+        break;
+      case InvalidationType::STORE:
+        // Storing data repopulates the inode's cache, so a later
+        // invalidation of this inode must be sent even if an earlier one
+        // already was.
+        seenInodes.erase(entry.inode);
+        break;
+      case InvalidationType::FLUSH:
+        // Flush promises only observe ordering and we only ever keep the
+        // first occurrence of a duplicate, so it is safe to deduplicate
+        // across them.
+        break;
+    }
+  }
+
+  if (removed == 0) {
+    return 0;
+  }
+  std::vector<InvalidationEntry> kept;
+  kept.reserve(entries.size() - removed);
+  for (size_t i = 0; i < entries.size(); ++i) {
+    if (!drop[i]) {
+      kept.push_back(std::move(entries[i]));
+    }
+  }
+  entries.swap(kept);
+  return removed;
+}
+
 /**
  * Send an element from the invalidation queue.
  *
@@ -1026,6 +1162,9 @@ void FuseChannel::sendInvalidation(InvalidationEntry& entry) {
         // invalidation queue have been completed.
         entry.promise.setValue();
         return;
+      case InvalidationType::STORE:
+        sendStoreData(entry.inode, entry.store);
+        return;
     }
     EDEN_BUG() << "unknown invalidation entry type "
                << static_cast<uint64_t>(entry.type);
@@ -1152,6 +1291,40 @@ void FuseChannel::sendInvalidateEntry(
   }
 }
 
+/**
+ * Send a FUSE_NOTIFY_STORE message to the kernel.
+ *
+ * This method always runs in the invalidation thread.
+ */
+void FuseChannel::sendStoreData(InodeNumber ino, const StoreData& store) {
+  const auto size = store.data->computeChainDataLength();
+  XLOG(DBG3) << "sendStoreData(ino=" << ino << ", offset=" << store.offset
+             << ", size=" << size << ")";
+
+  fuse_notify_store_out notify = {};
+  notify.nodeid = ino.get();
+  notify.offset = store.offset;
+  notify.size = folly::to_narrow(size);
+
+  fuse_out_header out;
+  out.unique = 0;
+  out.error = FUSE_NOTIFY_STORE;
+
+  // The data is handed to the kernel directly out of the IOBuf chain with
+  // writev, without flattening it first. The kernel copies it into the page
+  // cache; it will not extend the file past its current size, so stores
+  // beyond EOF are quietly truncated.
+  folly::fbvector<iovec> iov;
+  iov.reserve(2 + store.data->countChainElements());
+  iov.push_back(make_iovec(out));
+  iov.push_back(make_iovec(notify));
+  store.data->appendToIov(&iov);
+
+  // The caller (sendInvalidation) logs and ignores errors, including the
+  // ENOENT that results when the kernel no longer knows about this inode.
+  sendRawReply(iov.data(), iov.size());
+}
+
 std::vector<FuseChannel::OutstandingRequest>
 FuseChannel::getOutstandingRequests() {
   std::vector<FuseChannel::OutstandingRequest> outstandingCalls;
@@ -1226,6 +1399,30 @@ void FuseChannel::setThreadSigmask() {
   folly::checkPosixError(pthread_sigmask(SIG_UNBLOCK, &sigset, &oldset));
 }
 
+void FuseChannel::pinWorkerThread() {
+#ifdef __linux__
+  // Spread the worker threads round-robin across the online CPUs.  Request
+  // handlers run on the thread that read the request from the kernel, so
+  // pinning keeps the request buffer and the handler's cache state on one
+  // core rather than letting the scheduler migrate the thread mid-request.
+  const auto numCpus = std::thread::hardware_concurrency();
+  if (numCpus == 0) {
+    return;
+  }
+  const auto cpu =
+      nextWorkerCpu_.fetch_add(1, std::memory_order_relaxed) % numCpus;
+  cpu_set_t cpuSet;
+  CPU_ZERO(&cpuSet);
+  CPU_SET(cpu, &cpuSet);
+  if (auto rc =
+          pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet)) {
+    // Affinity is a performance hint; keep running unpinned on failure.
+    XLOG(WARN) << "unable to pin FUSE worker thread to CPU " << cpu << ": "
+               << folly::errnoStr(rc);
+  }
+#endif
+}
+
 void FuseChannel::initWorkerThread() noexcept {
   try {
     setThreadSigmask();
@@ -1255,9 +1452,17 @@ void FuseChannel::fuseWorkerThread() noexcept {
   disablePthreadCancellation();
   setThreadName(fmt::format("fuse{}", mountPath_.basename()));
   setThreadSigmask();
+  if (workerThreadCpuAffinity_) {
+    pinWorkerThread();
+  }
   *(liveRequestWatches_.get()) =
       std::make_shared<RequestMetricsScope::LockedRequestWatchList>();
 
+  // Make this dispatcher thread visible to the sampling profiler while it
+  // is processing the session.
+  ThreadSampler::Registration samplerRegistration{
+      fmt::format("fuse{}", mountPath_.basename())};
+
   try {
     processSession();
   } catch (const std::exception& ex) {
@@ -1320,6 +1525,15 @@ void FuseChannel::invalidationThread() noexcept {
       lockedQueue->queue.swap(entries);
     }
 
+    // A checkout can enqueue the same invalidation many times; drop
+    // duplicates before paying one syscall apiece for them.
+    if (auto deduped = dedupInvalidations(entries)) {
+      XLOG(DBG4) << "deduplicated " << deduped << " of "
+                 << (entries.size() + deduped) << " invalidations";
+      dispatcher_->getStats()->increment(
+          &FuseStats::invalidationsDeduplicated, deduped);
+    }
+
     // Process all of the entries we found
     for (auto& entry : entries) {
       sendInvalidation(entry);
@@ -1441,8 +1655,15 @@ void FuseChannel::readInitPacket() {
   auto& want = connInfo.flags;
 
   // TODO: follow up and look at the new flags; particularly
-  // FUSE_DO_READDIRPLUS, FUSE_READDIRPLUS_AUTO. FUSE_SPLICE_XXX are interesting
-  // too, but may not directly benefit eden today.
+  // FUSE_DO_READDIRPLUS, FUSE_READDIRPLUS_AUTO.
+  //
+  // FUSE_SPLICE_READ/WRITE/MOVE deliberately remain unused. splice(2) only
+  // eliminates a copy when the reply data originates from a file
+  // descriptor (file -> pipe -> fuse device). EdenFS read replies come
+  // from memory-resident blobs, and sendRawReply() already gathers the
+  // header and the IOBuf chain into a single writev() to the device, so a
+  // vmsplice-based path would add pipe management and page-pinning
+  // hazards without removing any copy.
   //
   // FUSE_ATOMIC_O_TRUNC is a nice optimization when the kernel supports it
   // and the FUSE daemon requires handling open/release for stateful file
@@ -1477,6 +1698,28 @@ void FuseChannel::readInitPacket() {
   (void)useWriteBackCache_;
 #endif
 
+#ifdef FUSE_MAX_PAGES
+  if (maximumRequestPages_ != 0 && (capable & FUSE_MAX_PAGES)) {
+    // Kernels with FUSE_MAX_PAGES accept more than the historical 32 pages
+    // per request. A larger max_write lets the writeback cache flush dirty
+    // pages in bigger batches and reduces the number of FUSE_WRITE round
+    // trips for streaming writes. The kernel caps max_pages at 256; clamp
+    // here too so the buffer we allocate matches what we advertise.
+    constexpr size_t kMaxMaxPages = 256;
+    const size_t pageSize = getpagesize();
+    const auto maxPages = std::min(maximumRequestPages_, kMaxMaxPages);
+    want |= FUSE_MAX_PAGES;
+    connInfo.max_pages = static_cast<uint16_t>(maxPages);
+    connInfo.max_write = maxPages * pageSize;
+    // Grow the request read buffer so worker threads can receive a full
+    // max_write-sized write plus headers. Worker threads have not started
+    // yet, so this is safe to update without synchronization.
+    bufferSize_ = std::max(bufferSize_, connInfo.max_write + size_t{0x1000});
+  }
+#else
+  (void)maximumRequestPages_;
+#endif
+
 #ifdef FUSE_NO_OPEN_SUPPORT
   // File handles are stateless so the kernel does not need to send open() and
   // release().
@@ -1554,6 +1797,13 @@ void FuseChannel::readInitPacket() {
   dispatcher_->initConnection(connInfo);
 }
 
+// Each worker thread runs this loop: one blocking read(2) per request and
+// one writev(2) per reply. An io_uring based transport (fuse-over-io_uring,
+// FUSE_URING in Linux 6.14+) could batch submissions and completions, but
+// the FUSE protocol header vendored in third-party/fuse_kernel_linux.h
+// predates that protocol and getdeps does not provide liburing, so the
+// per-syscall loop remains the transport for now. If the header and
+// dependency are ever updated, this loop is the seam to swap out.
 void FuseChannel::processSession() {
   std::vector<char> buf(bufferSize_);
   // Save this for the sanity check later in the loop to avoid
@@ -1747,6 +1997,28 @@ void FuseChannel::processSession() {
 
       default: {
         if (handlerEntry && handlerEntry->handler) {
+          // When the backing store is slow, metadata requests accumulate
+          // behind imports faster than they complete and every new request
+          // just deepens the queue. Beyond the configured bound, fail
+          // retryable metadata queries fast so that READ and WRITE (which
+          // are never shed) stay responsive. Note that the kernel absorbs
+          // most repeated lookups and getattrs of unchanged inodes itself:
+          // we hand it effectively infinite entry/attribute TTLs and
+          // invalidate explicitly, so the requests that reach us here are
+          // largely cold ones that would otherwise block on the store.
+          const bool lowPriority = isLowPriorityOpcode(header->opcode);
+          if (lowPriority && maximumInflightLowPriorityRequests_ != 0 &&
+              inflightLowPriorityRequests_.load(std::memory_order_relaxed) >=
+                  maximumInflightLowPriorityRequests_) {
+            XLOG_EVERY_MS(WARN, 60000)
+                << "shedding " << fuseOpcodeName(header->opcode)
+                << " request: " << maximumInflightLowPriorityRequests_
+                << " low-priority requests already in flight on "
+                << mountPath_;
+            replyError(*header, EAGAIN);
+            break;
+          }
+
           auto requestId = generateUniqueID();
           if (handlerEntry->argRenderer &&
               traceDetailedArguments_->load(std::memory_order_acquire)) {
@@ -1756,12 +2028,18 @@ void FuseChannel::processSession() {
             traceBus_->publish(FuseTraceEvent::start(requestId, *header));
           }
 
-          // This is a shared_ptr because, due to timeouts, the internal request
-          // lifetime may not match the FUSE request lifetime, so we capture it
-          // in both. I'm sure this could be improved with some cleverness.
-          auto request = std::make_shared<FuseRequestContext>(this, *header);
+          // Due to timeouts, the internal request lifetime may not match the
+          // FUSE request lifetime, so the reply path and the timeout path
+          // each hold a reference. FuseRequestContext is intrusively
+          // refcounted and pool-allocated, so at steady state this recycles
+          // the allocation of a request that recently finished.
+          auto request = makeRefPtr<FuseRequestContext>(this, *header);
 
           ++state_.wlock()->pendingRequests;
+          if (lowPriority) {
+            inflightLowPriorityRequests_.fetch_add(
+                1, std::memory_order_relaxed);
+          }
 
           auto headerCopy = *header;
 
@@ -1784,18 +2062,30 @@ void FuseChannel::processSession() {
                     request->startRequest(
                         dispatcher_->getStats().copy(),
                         handlerEntry->stat,
-                        *(liveRequestWatches_.get()));
+                        *(liveRequestWatches_.get()),
+                        &latencyHistograms_.forAccessType(
+                            handlerEntry->accessType),
+                        handlerEntry->name);
                     return (this->*handlerEntry->handler)(
                                *request, request->getReq(), arg)
                         .semi()
                         .via(&folly::QueuedImmediateExecutor::instance());
-                  }).ensure([request] {
+                  }).ensure([request = request.copy()] {
                     }).within(requestTimeout_),
                   notifier_.get())
-              .ensure([this, request, requestId, headerCopy] {
+              .ensure([this,
+                       request = request.copy(),
+                       requestId,
+                       headerCopy,
+                       lowPriority] {
                 traceBus_->publish(FuseTraceEvent::finish(
                     requestId, headerCopy, request->getResult()));
 
+                if (lowPriority) {
+                  inflightLowPriorityRequests_.fetch_sub(
+                      1, std::memory_order_relaxed);
+                }
+
                 // We may be complete; check to see if all requests are
                 // done and whether there are any threads remaining.
                 auto state = state_.wlock();
@@ -2427,12 +2717,19 @@ ImmediateFuture<folly::Unit> FuseChannel::fuseBatchForget(
       reinterpret_cast<const fuse_batch_forget_in*>(arg.data());
   auto item = reinterpret_cast<const fuse_forget_one*>(forgets + 1);
   const auto end = item + forgets->count;
-  XLOG(DBG7) << "FUSE_BATCH_FORGET";
+  XLOG(DBG7) << "FUSE_BATCH_FORGET count=" << forgets->count;
 
+  // Hand the whole batch to the dispatcher at once so the refcount
+  // decrements can be applied in a single pass over the inode table rather
+  // than taking its lock once per entry.
+  std::vector<std::pair<InodeNumber, uint32_t>> entries;
+  entries.reserve(forgets->count);
   while (item != end) {
-    dispatcher_->forget(InodeNumber{item->nodeid}, item->nlookup);
+    entries.emplace_back(
+        InodeNumber{item->nodeid}, static_cast<uint32_t>(item->nlookup));
     ++item;
   }
+  dispatcher_->forgetMulti(entries);
   request.replyNone();
   return folly::unit;
 }
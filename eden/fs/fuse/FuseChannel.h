@@ -27,6 +27,7 @@
 #include "eden/fs/fuse/FuseDispatcher.h"
 #include "eden/fs/inodes/FsChannel.h"
 #include "eden/fs/inodes/InodeNumber.h"
+#include "eden/fs/telemetry/DurationHistogram.h"
 #include "eden/fs/telemetry/RequestMetricsScope.h"
 #include "eden/fs/telemetry/TraceBus.h"
 #include "eden/fs/utils/CaseSensitivity.h"
@@ -250,7 +251,10 @@ class FuseChannel final : public FsChannel {
       bool requireUtf8Path,
       int32_t maximumBackgroundRequests,
       bool useWriteBackCache,
-      size_t fuseTraceBusCapacity);
+      size_t fuseTraceBusCapacity,
+      bool workerThreadCpuAffinity = false,
+      size_t maximumRequestPages = 0,
+      size_t maximumInflightLowPriorityRequests = 0);
 
   FuseChannel(const FuseChannel&) = delete;
   FuseChannel(FuseChannel&&) = delete;
@@ -376,6 +380,25 @@ class FuseChannel final : public FsChannel {
    */
   void invalidateInodes(folly::Range<InodeNumber*> range);
 
+  /**
+   * Push file data into the kernel's page cache for the specified inode,
+   * using a FUSE_NOTIFY_STORE message.
+   *
+   * This is the inverse of invalidateInode(): rather than dropping cached
+   * pages it populates them, so subsequent reads of the stored range are
+   * served by the kernel without a FUSE round trip.
+   *
+   * The store is best effort and performed asynchronously on the
+   * invalidation thread: writes to the FUSE device must not block request
+   * handlers, and the kernel holds page locks while a read of the same
+   * inode is in progress. Stores for inodes the kernel does not currently
+   * know about fail with ENOENT and are silently dropped.
+   */
+  void storeData(
+      InodeNumber ino,
+      uint64_t offset,
+      std::unique_ptr<folly::IOBuf> data);
+
   /**
    * Wait for all currently scheduled invalidateInode() and invalidateEntry()
    * operations to complete.
@@ -487,6 +510,14 @@ class FuseChannel final : public FsChannel {
     return processAccessLog_;
   }
 
+  const FsLatencyHistograms* getLatencyHistograms() const override {
+    return &latencyHistograms_;
+  }
+
+  AbsolutePathPiece getMountPath() const {
+    return mountPath_;
+  }
+
   ImmediateFuture<folly::Unit> waitForPendingWrites() override {
     return folly::unit;
   }
@@ -551,19 +582,31 @@ class FuseChannel final : public FsChannel {
     int64_t offset;
     int64_t length;
   };
+  struct StoreData {
+    StoreData(uint64_t offset, std::unique_ptr<folly::IOBuf> data);
+
+    uint64_t offset;
+    std::unique_ptr<folly::IOBuf> data;
+  };
   enum class InvalidationType : uint32_t {
     INODE,
     DIR_ENTRY,
     FLUSH,
+    STORE,
   };
   struct InvalidationEntry {
     InvalidationEntry(InodeNumber inode, int64_t offset, int64_t length);
     InvalidationEntry(InodeNumber inode, PathComponentPiece name);
     explicit InvalidationEntry(folly::Promise<folly::Unit> promise);
+    InvalidationEntry(
+        InodeNumber inode,
+        uint64_t offset,
+        std::unique_ptr<folly::IOBuf> data);
     InvalidationEntry(InvalidationEntry&& other) noexcept(
         std::is_nothrow_move_constructible_v<PathComponent>&&
             std::is_nothrow_move_constructible_v<folly::Promise<folly::Unit>>&&
-                std::is_nothrow_move_constructible_v<DataRange>);
+                std::is_nothrow_move_constructible_v<DataRange>&&
+                    std::is_nothrow_move_constructible_v<StoreData>);
     ~InvalidationEntry();
 
     InvalidationType type;
@@ -572,6 +615,7 @@ class FuseChannel final : public FsChannel {
       PathComponent name;
       DataRange range;
       folly::Promise<folly::Unit> promise;
+      StoreData store;
     };
   };
   struct InvalidationQueue {
@@ -726,13 +770,28 @@ class FuseChannel final : public FsChannel {
 
  private:
   void setThreadSigmask();
+  void pinWorkerThread();
   void initWorkerThread() noexcept;
   void fuseWorkerThread() noexcept;
   void invalidationThread() noexcept;
   void stopInvalidationThread();
+
+  /**
+   * Drop invalidation entries that are exact duplicates of an earlier entry
+   * in the same drained batch. Returns the number of entries removed.
+   *
+   * Each queue entry costs one write to /dev/fuse, so a checkout that
+   * touches many files is worth deduplicating before issuing syscalls.
+   * Deduplicating within one batch is safe: every modification whose
+   * invalidation is in the batch happened before the batch was drained, so
+   * one eviction per dentry or inode suffices for all of them.
+   */
+  static size_t dedupInvalidations(std::vector<InvalidationEntry>& entries);
+
   void sendInvalidation(InvalidationEntry& entry);
   void sendInvalidateInode(InodeNumber ino, int64_t off, int64_t len);
   void sendInvalidateEntry(InodeNumber parent, PathComponentPiece name);
+  void sendStoreData(InodeNumber ino, const StoreData& store);
   void readInitPacket();
   void startWorkerThreads();
 
@@ -778,7 +837,13 @@ class FuseChannel final : public FsChannel {
   /*
    * Constant state that does not change for the lifetime of the FuseChannel
    */
-  const size_t bufferSize_{0};
+  /*
+   * The size of the buffer worker threads use to read requests from the
+   * FUSE device. Set in the constructor, and possibly grown once during
+   * initialization (or takeover) if a larger max_write is negotiated.
+   * Constant while the worker threads are running.
+   */
+  size_t bufferSize_{0};
   const size_t numThreads_;
   std::unique_ptr<FuseDispatcher> dispatcher_;
   const folly::Logger* const straceLogger_;
@@ -789,6 +854,22 @@ class FuseChannel final : public FsChannel {
   bool requireUtf8Path_;
   int32_t maximumBackgroundRequests_;
   bool useWriteBackCache_;
+  const bool workerThreadCpuAffinity_;
+  const size_t maximumRequestPages_;
+  const size_t maximumInflightLowPriorityRequests_;
+
+  /**
+   * The number of currently dispatched requests whose opcodes are eligible
+   * for load shedding. See isLowPriorityOpcode() for the opcode set. Only
+   * consulted when maximumInflightLowPriorityRequests_ is non-zero.
+   */
+  std::atomic<size_t> inflightLowPriorityRequests_{0};
+
+  /**
+   * The next CPU to pin a worker thread to when workerThreadCpuAffinity_ is
+   * enabled. Worker threads are spread round-robin across the online CPUs.
+   */
+  std::atomic<uint32_t> nextWorkerCpu_{0};
 
   /*
    * connInfo_ is modified during the initialization process,
@@ -836,6 +917,7 @@ class FuseChannel final : public FsChannel {
   std::thread invalidationThread_;
 
   ProcessAccessLog processAccessLog_;
+  FsLatencyHistograms latencyHistograms_;
 
   // this tracks metrics for live FUSE requests, this is a thread local
   // to avoid contention between the FuseWorkerThreads as they kick off
@@ -74,6 +74,13 @@ ImmediateFuture<fuse_entry_out> FuseDispatcher::lookup(
 
 void FuseDispatcher::forget(InodeNumber /*ino*/, unsigned long /*nlookup*/) {}
 
+void FuseDispatcher::forgetMulti(
+    const std::vector<std::pair<InodeNumber, uint32_t>>& entries) {
+  for (const auto& [ino, nlookup] : entries) {
+    forget(ino, nlookup);
+  }
+}
+
 ImmediateFuture<FuseDispatcher::Attr> FuseDispatcher::getattr(
     InodeNumber /*ino*/,
     const ObjectFetchContextPtr& /*context*/) {
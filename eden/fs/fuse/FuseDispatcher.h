@@ -93,6 +93,18 @@ class FuseDispatcher {
    */
   virtual void forget(InodeNumber ino, unsigned long nlookup);
 
+  /**
+   * Batched version of forget(), called for FUSE_BATCH_FORGET.
+   *
+   * The kernel sends forget floods after memory pressure; applying the
+   * decrements one call at a time takes the inode table lock once per
+   * entry. The default implementation does exactly that, but
+   * implementations that can apply the whole batch under a single lock
+   * acquisition should override this.
+   */
+  virtual void forgetMulti(
+      const std::vector<std::pair<InodeNumber, uint32_t>>& entries);
+
   /**
    * The stat information and the cache TTL for the kernel
    *
@@ -26,7 +26,8 @@ FuseRequestContext::FuseRequestContext(
           channel->getProcessAccessLog(),
           makeRefPtr<FuseObjectFetchContext>(
               ProcessId{fuseHeader.pid},
-              fuseHeader.opcode)),
+              fuseHeader.opcode,
+              channel->getMountPath().view())),
       channel_(channel),
       fuseHeader_(fuseHeader) {}
 
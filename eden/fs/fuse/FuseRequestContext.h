@@ -19,13 +19,17 @@
 #include "eden/fs/telemetry/EdenStats.h"
 #include "eden/fs/telemetry/RequestMetricsScope.h"
 #include "eden/fs/utils/FsChannelTypes.h"
+#include "eden/fs/utils/PoolAlloc.h"
 
 namespace facebook::eden {
 
 class FuseObjectFetchContext : public FsObjectFetchContext {
  public:
-  FuseObjectFetchContext(ProcessId pid, uint32_t opcode)
-      : pid_{pid}, opcode_{opcode} {}
+  FuseObjectFetchContext(
+      ProcessId pid,
+      uint32_t opcode,
+      std::string_view mountPath)
+      : pid_{pid}, opcode_{opcode}, mountPath_{mountPath} {}
 
   OptionalProcessId getClientPid() const override {
     return pid_;
@@ -35,19 +39,30 @@ class FuseObjectFetchContext : public FsObjectFetchContext {
     return fuseOpcodeName(opcode_);
   }
 
+  std::optional<std::string_view> getMountId() const override {
+    return mountPath_;
+  }
+
  private:
   ProcessId pid_;
   uint32_t opcode_;
+  // Owned by the FuseChannel, which outlives every request on it.
+  std::string_view mountPath_;
 };
 
 /**
  * Each FUSE request has a corresponding FuseRequestContext object that is
- * allocated at request start and deallocated when it finishes.
+ * allocated at request start and deallocated when it finishes. At steady
+ * state the allocation is recycled from a recently-finished request via
+ * PoolAlloc rather than hitting the allocator; the channel owns requests
+ * through RefPtr, so finishing a request returns its memory to the pool
+ * as soon as the last reference drops.
  *
  * Unless a member function indicates otherwise, FuseRequestContext may be used
  * from multiple threads, but only by one thread at a time.
  */
-class FuseRequestContext : public RequestContext {
+class FuseRequestContext : public RequestContext,
+                           public PoolAlloc<FuseRequestContext> {
  public:
   explicit FuseRequestContext(
       FuseChannel* channel,
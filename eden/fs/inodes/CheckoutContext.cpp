@@ -15,6 +15,7 @@
 #include "eden/fs/inodes/EdenMount.h"
 #include "eden/fs/inodes/InodePtr.h"
 #include "eden/fs/inodes/TreeInode.h"
+#include "eden/fs/telemetry/EdenStats.h"
 
 using folly::Future;
 using std::vector;
@@ -102,8 +103,16 @@ Future<vector<CheckoutConflict>> CheckoutContext::flush() {
     // We do this after releasing the rename lock since some of the invalidation
     // operations may be blocked waiting on FUSE unlink() and rename()
     // operations complete.
+    folly::stop_watch<> invalidationWatch;
     return mount_->flushInvalidations()
-        .thenValue([this](auto&&) { return std::move(*conflicts_.wlock()); })
+        .thenValue([this, invalidationWatch](auto&&) {
+          // Large checkouts can spend seconds waiting for the kernel to
+          // process invalidations; track that separately from the rest of
+          // the checkout.
+          mount_->getStats()->addDuration(
+              &CheckoutStats::invalidationFlush, invalidationWatch.elapsed());
+          return std::move(*conflicts_.wlock());
+        })
         .semi()
         .via(&folly::QueuedImmediateExecutor::instance());
   }
@@ -7,6 +7,9 @@
 
 #include "eden/fs/inodes/DeferredDiffEntry.h"
 
+#include <algorithm>
+#include <atomic>
+
 #include <folly/Unit.h>
 #include <folly/futures/Future.h>
 #include <folly/logging/xlog.h>
@@ -20,6 +23,7 @@
 #include "eden/fs/store/DiffContext.h"
 #include "eden/fs/store/ObjectStore.h"
 #include "eden/fs/utils/Bug.h"
+#include "eden/fs/utils/ImmediateFuture.h"
 
 using folly::Future;
 using folly::makeFuture;
@@ -99,6 +103,13 @@ class ModifiedDiffEntry : public DeferredDiffEntry {
     });
   }
 
+  bool isSubtreeWalk() const override {
+    // This is only a scheduling hint: a blob entry can still turn into a
+    // walk when the path is now a directory, but that case is rare enough
+    // not to matter here.
+    return scmEntries_[0].isTree();
+  }
+
  private:
   ImmediateFuture<folly::Unit> runForScmTree(const InodePtr& inode) {
     XCHECK_GT(scmEntries_.size(), 0ull) << "scmEntries must have values";
@@ -236,6 +247,10 @@ class ModifiedBlobDiffEntry : public DeferredDiffEntry {
         });
   }
 
+  bool isSubtreeWalk() const override {
+    return false;
+  }
+
  private:
   TreeEntry scmEntry_;
   ObjectId currentBlobHash_;
@@ -275,6 +290,43 @@ class AddedScmDiffEntry : public DeferredDiffEntry {
   ObjectId wdHash_;
 };
 
+/**
+ * An explicit work queue over a batch of deferred diff entries.
+ *
+ * A fixed number of workers each claim the next unstarted entry, run it,
+ * record its result, and move on to the next one. Indices are claimed with
+ * an atomic counter, so every entry runs exactly once and every result slot
+ * is written exactly once even when entries complete on different threads.
+ */
+class DeferredEntryQueue
+    : public std::enable_shared_from_this<DeferredEntryQueue> {
+ public:
+  explicit DeferredEntryQueue(
+      const std::vector<unique_ptr<DeferredDiffEntry>>& entries)
+      : entries_{entries}, results_{entries.size()} {}
+
+  ImmediateFuture<folly::Unit> runWorker() {
+    auto index = next_.fetch_add(1, std::memory_order_relaxed);
+    if (index >= entries_.size()) {
+      return folly::unit;
+    }
+    return entries_[index]->run().thenTry(
+        [self = shared_from_this(), index](folly::Try<Unit> result) {
+          self->results_[index] = std::move(result);
+          return self->runWorker();
+        });
+  }
+
+  std::vector<folly::Try<Unit>> takeResults() {
+    return std::move(results_);
+  }
+
+ private:
+  const std::vector<unique_ptr<DeferredDiffEntry>>& entries_;
+  std::atomic<size_t> next_{0};
+  std::vector<folly::Try<Unit>> results_;
+};
+
 class RemovedScmDiffEntry : public DeferredDiffEntry {
  public:
   RemovedScmDiffEntry(DiffContext* context, RelativePath path, ObjectId scmHash)
@@ -354,4 +406,39 @@ unique_ptr<DeferredDiffEntry> DeferredDiffEntry::createRemovedScmEntry(
   return make_unique<RemovedScmDiffEntry>(context, std::move(path), scmHash);
 }
 
+ImmediateFuture<std::vector<folly::Try<Unit>>> runDeferredDiffEntries(
+    std::vector<unique_ptr<DeferredDiffEntry>>& entries,
+    uint64_t limit) {
+  // Start the cheap single-object comparisons ahead of the recursive
+  // subtree walks so their results reach the callback early. The true size
+  // of a subtree is unknown until its trees have been fetched, so this
+  // coarse split is the best scheduling signal available up front.
+  std::stable_partition(
+      entries.begin(),
+      entries.end(),
+      [](const unique_ptr<DeferredDiffEntry>& entry) {
+        return !entry->isSubtreeWalk();
+      });
+
+  if (limit == 0 || entries.size() <= limit) {
+    std::vector<ImmediateFuture<Unit>> futures;
+    futures.reserve(entries.size());
+    for (auto& entry : entries) {
+      futures.push_back(entry->run());
+    }
+    return collectAll(std::move(futures));
+  }
+
+  auto queue = std::make_shared<DeferredEntryQueue>(entries);
+  std::vector<ImmediateFuture<Unit>> workers;
+  workers.reserve(limit);
+  for (uint64_t n = 0; n < limit; ++n) {
+    workers.push_back(queue->runWorker());
+  }
+  return collectAll(std::move(workers))
+      .thenValue([queue](std::vector<folly::Try<Unit>>&&) {
+        return queue->takeResults();
+      });
+}
+
 } // namespace facebook::eden
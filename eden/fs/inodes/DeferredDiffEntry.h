@@ -8,12 +8,15 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 #include "eden/fs/inodes/InodePtrFwd.h"
 #include "eden/fs/utils/DirType.h"
 #include "eden/fs/utils/PathFuncs.h"
 
 namespace folly {
 struct Unit;
+template <typename T>
+class Try;
 } // namespace folly
 
 namespace facebook::eden {
@@ -51,6 +54,16 @@ class DeferredDiffEntry {
 
   FOLLY_NODISCARD virtual ImmediateFuture<folly::Unit> run() = 0;
 
+  /**
+   * Whether running this entry may recursively walk a subtree (fetching
+   * trees and diffing directories), as opposed to comparing a single
+   * object. runDeferredDiffEntries uses this to schedule cheap comparisons
+   * ahead of subtree walks.
+   */
+  virtual bool isSubtreeWalk() const {
+    return true;
+  }
+
   static std::unique_ptr<DeferredDiffEntry> createUntrackedEntry(
       DiffContext* context,
       RelativePath path,
@@ -96,4 +109,22 @@ class DeferredDiffEntry {
   DiffContext* const context_;
   RelativePath const path_;
 };
+
+/**
+ * Run a batch of deferred diff entries, producing one result per entry.
+ *
+ * The entries are reordered in place so that cheap single-object
+ * comparisons start before recursive subtree walks, letting file-level
+ * results reach the diff callback while the walks are still in flight; the
+ * returned results line up with the reordered vector. When limit is
+ * non-zero, at most that many entries run concurrently and the rest are
+ * queued behind them, bounding the fetch fan-out on wide, heavily diverged
+ * directories. The caller must keep the entries alive until the returned
+ * future completes.
+ */
+FOLLY_NODISCARD ImmediateFuture<std::vector<folly::Try<folly::Unit>>>
+runDeferredDiffEntries(
+    std::vector<std::unique_ptr<DeferredDiffEntry>>& entries,
+    uint64_t limit);
+
 } // namespace facebook::eden
@@ -53,6 +53,7 @@
 #include "eden/fs/store/ObjectStore.h"
 #include "eden/fs/store/ScmStatusDiffCallback.h"
 #include "eden/fs/store/StatsFetchContext.h"
+#include "eden/fs/store/TreeDiffMemoCache.h"
 #include "eden/fs/store/TreeLookupProcessor.h"
 #include "eden/fs/telemetry/StructuredLogger.h"
 #include "eden/fs/utils/Bug.h"
@@ -66,8 +67,11 @@
 #include "eden/fs/utils/NotImplemented.h"
 #include "eden/fs/utils/PathFuncs.h"
 #include "eden/fs/utils/SpawnedProcess.h"
+#include "eden/fs/utils/StripedSerialExecutor.h"
+#include "eden/fs/utils/SystemError.h"
 #include "eden/fs/utils/UnboundedQueueExecutor.h"
 
+#include <algorithm>
 #include <chrono>
 
 using folly::Future;
@@ -128,6 +132,17 @@ constexpr PathComponentPiece kDotEdenSymlinkName{"this-dir"_pc};
 
 namespace {
 constexpr PathComponentPiece kNfsdSocketName{"nfsd.socket"_pc};
+
+std::shared_ptr<StripedSerialExecutor> makeMountThreadPool(
+    ServerState& serverState) {
+  auto lanes =
+      serverState.getEdenConfig()->mountExecutorLanes.getValue();
+  if (lanes == 0) {
+    return nullptr;
+  }
+  return std::make_shared<StripedSerialExecutor>(
+      folly::getKeepAliveToken(serverState.getThreadPool().get()), lanes);
+}
 }
 
 /**
@@ -208,10 +223,11 @@ class EdenMount::JournalDiffCallback : public DiffCallback {
 static constexpr folly::StringPiece kEdenStracePrefix = "eden.strace.";
 
 // We compute this when the process is initialized, but stash a copy
-// in each EdenMount.  We may in the future manage to propagate enough
-// state across upgrades or restarts that we can preserve this, but
-// as implemented today, a process restart will invalidate any cached
-// mountGeneration that a client may be holding on to.
+// in each EdenMount.  A graceful takeover transfers the old process's
+// generation for each mount (see SerializedMountInfo::mountGeneration),
+// so cached mountGenerations held by clients survive daemon upgrades.
+// A hard restart still invalidates any cached mountGeneration that a
+// client may be holding on to.
 // We take the bottom 16-bits of the pid and 32-bits of the current
 // time and shift them up, leaving 16 bits for a mount point generation
 // number.
@@ -261,6 +277,7 @@ EdenMount::EdenMount(
           serverState_->getEdenConfig()->prjfsNumInvalidationThreads.getValue(),
           "prjfs-dir-inval")},
 #endif
+      mountThreadPool_{makeMountThreadPool(*serverState_)},
       inodeMap_{new InodeMap(
           this,
           serverState_->getReloadableConfig(),
@@ -293,6 +310,11 @@ EdenMount::EdenMount(
           "inode",
           serverState_->getEdenConfig()->InodeTraceBusCapacity.getValue())},
       clock_{serverState_->getClock()} {
+  auto memoEntries = serverState_->getEdenConfig()
+                         ->treeDiffMemoCacheEntries.getValue();
+  if (memoEntries > 0) {
+    treeDiffMemoCache_ = std::make_shared<TreeDiffMemoCache>(memoEntries);
+  }
   subscribeInodeActivityBuffer();
 }
 
@@ -349,11 +371,20 @@ InodeCatalogOptions EdenMount::getInodeCatalogOptions(
 FOLLY_NODISCARD folly::Future<folly::Unit> EdenMount::initialize(
     OverlayChecker::ProgressCallback&& progressCallback,
     const std::optional<SerializedInodeMap>& takeover,
-    const std::optional<MountProtocol>& takeoverMountProtocol) {
+    const std::optional<MountProtocol>& takeoverMountProtocol,
+    const std::optional<uint64_t>& takeoverMountGeneration) {
   // it is an invariant that shouldUseNfs_ is set before we transition to
   // INITIALIZING
   calculateIsNfsMount(takeoverMountProtocol);
 
+  // Adopt the old process's mount generation when one was handed over.
+  // This keeps journal positions held by clients valid across a graceful
+  // restart, so subscribers revalidate incrementally instead of treating
+  // the mount as brand new and re-crawling it.
+  if (takeoverMountGeneration.has_value()) {
+    mountGeneration_ = *takeoverMountGeneration;
+  }
+
   transitionState(State::UNINITIALIZED, State::INITIALIZING);
 
   auto parentCommit = checkoutConfig_->getParentCommit();
@@ -810,11 +841,26 @@ ImmediateFuture<SetPathObjectIdResultAndTimes> EdenMount::setPathsToObjectIds(
         objects.at(0).path.empty() &&
         facebook::eden::ObjectType::TREE == objects.at(0).type;
 
+    // When a single tree is applied somewhere below the root, we can check it
+    // out directly on the target directory rather than synthesizing a parent
+    // tree around it. The synthesized tree has no real ObjectId, so the
+    // target's parent could never dematerialize after the apply; checking out
+    // the real tree lets saveOverlayPostCheckout record the applied subtree
+    // root as a plain source-referenced entry, making a clean apply
+    // metadata-only. Note that untracked entries already present in the
+    // target directory are left in place by checkout rather than replaced
+    // wholesale, which is why this is gated on a config.
+    bool setSingleTree = !setOnRoot &&
+        getEdenConfig()->setPathObjectIdLazyTreeApply.getValue() &&
+        objects.size() == 1 &&
+        facebook::eden::ObjectType::TREE == objects.at(0).type;
+
+    const auto& targetPath = setSingleTree ? objects.at(0).path : path;
     auto getTargetTreeInodeFuture =
-        ensureDirectoryExists(path, ctx->getFetchContext());
+        ensureDirectoryExists(targetPath, ctx->getFetchContext());
 
     std::vector<ImmediateFuture<shared_ptr<TreeEntry>>> getTreeEntryFutures;
-    if (!setOnRoot) {
+    if (!setOnRoot && !setSingleTree) {
       for (auto& object : objects) {
         ImmediateFuture<shared_ptr<TreeEntry>> getTreeEntryFuture =
             objectStore_->getTreeEntryForObjectId(
@@ -825,7 +871,7 @@ ImmediateFuture<SetPathObjectIdResultAndTimes> EdenMount::setPathsToObjectIds(
       }
     }
 
-    auto getRootTreeFuture = setOnRoot
+    auto getRootTreeFuture = (setOnRoot || setSingleTree)
         ? objectStore_->getTree(objects.at(0).id, ctx->getFetchContext())
         : collectAllSafe(std::move(getTreeEntryFutures))
               .thenValue(
@@ -1051,6 +1097,13 @@ folly::SemiFuture<folly::Unit> EdenMount::unmount() {
       });
 }
 
+folly::Executor* EdenMount::getMountThreadPool() const {
+  if (mountThreadPool_) {
+    return mountThreadPool_.get();
+  }
+  return serverState_->getThreadPool().get();
+}
+
 const shared_ptr<UnboundedQueueExecutor>& EdenMount::getServerThreadPool()
     const {
   return serverState_->getThreadPool();
@@ -1067,6 +1120,11 @@ std::shared_ptr<const EdenConfig> EdenMount::getEdenConfig() const {
   return serverState_->getReloadableConfig()->getEdenConfig();
 }
 
+folly::ReadMostlySharedPtr<const EdenConfig> EdenMount::getEdenConfigReadMostly()
+    const {
+  return serverState_->getReloadableConfig()->getEdenConfigReadMostly();
+}
+
 #ifndef _WIN32
 InodeMetadataTable* EdenMount::getInodeMetadataTable() const {
   return overlay_->getInodeMetadataTable();
@@ -1342,6 +1400,177 @@ ImmediateFuture<folly::Unit> EdenMount::waitForPendingWrites() const {
   }
 }
 
+namespace {
+
+/**
+ * Join a working copy status (against the old parent) with the tree-level
+ * changes between the old and new parents into the conflict list a checkout
+ * would report. A path only conflicts when both sides touch it.
+ */
+std::vector<CheckoutConflict> computeDryRunConflicts(
+    const ScmStatus& workingCopy,
+    const ScmStatus& treeChanges) {
+  std::vector<CheckoutConflict> conflicts;
+
+  auto addConflict = [&](const std::string& path, ConflictType type) {
+    CheckoutConflict conflict;
+    conflict.path_ref() = path;
+    conflict.type_ref() = type;
+    conflicts.push_back(std::move(conflict));
+  };
+
+  const auto& local = *workingCopy.entries_ref();
+  for (const auto& [path, treeChange] : *treeChanges.entries_ref()) {
+    auto it = local.find(path);
+    if (it == local.end()) {
+      continue;
+    }
+    switch (treeChange) {
+      case ScmFileStatus::MODIFIED:
+        if (it->second == ScmFileStatus::MODIFIED) {
+          addConflict(path, ConflictType::MODIFIED_MODIFIED);
+        } else if (it->second == ScmFileStatus::REMOVED) {
+          addConflict(path, ConflictType::REMOVED_MODIFIED);
+        }
+        break;
+      case ScmFileStatus::REMOVED:
+        if (it->second == ScmFileStatus::MODIFIED) {
+          addConflict(path, ConflictType::MODIFIED_REMOVED);
+        } else if (it->second == ScmFileStatus::REMOVED) {
+          addConflict(path, ConflictType::MISSING_REMOVED);
+        }
+        break;
+      case ScmFileStatus::ADDED:
+        if (it->second == ScmFileStatus::ADDED) {
+          addConflict(path, ConflictType::UNTRACKED_ADDED);
+        }
+        break;
+      case ScmFileStatus::IGNORED:
+        break;
+    }
+  }
+
+  for (const auto* status : {&workingCopy, &treeChanges}) {
+    for (const auto& [path, message] : *status->errors_ref()) {
+      CheckoutConflict conflict;
+      conflict.path_ref() = path;
+      conflict.type_ref() = ConflictType::ERROR;
+      conflict.message_ref() = message;
+      conflicts.push_back(std::move(conflict));
+    }
+  }
+
+  return conflicts;
+}
+
+/**
+ * Resolve the Tree at the given prefix under rootTree, or nullptr when the
+ * prefix does not exist in that tree. Fails with ENOTDIR when the prefix
+ * refers to a file.
+ */
+ImmediateFuture<std::shared_ptr<const Tree>> lookupTreeUnderPrefix(
+    std::shared_ptr<const Tree> rootTree,
+    RelativePathPiece prefix,
+    std::shared_ptr<ObjectStore> objectStore,
+    const ObjectFetchContextPtr& context) {
+  if (prefix.empty()) {
+    return rootTree;
+  }
+  return getTreeOrTreeEntry(
+             std::move(rootTree),
+             prefix,
+             std::move(objectStore),
+             context.copy())
+      .thenTry(
+          [](Try<std::variant<std::shared_ptr<const Tree>, TreeEntry>>&&
+                 result) -> std::shared_ptr<const Tree> {
+            if (auto* err = result.tryGetExceptionObject<std::system_error>();
+                err && isEnoent(*err)) {
+              return nullptr;
+            }
+            auto value = std::move(result).value();
+            if (auto* tree =
+                    std::get_if<std::shared_ptr<const Tree>>(&value)) {
+              return std::move(*tree);
+            }
+            throw std::system_error(ENOTDIR, std::generic_category());
+          });
+}
+
+} // namespace
+
+folly::Future<CheckoutResult> EdenMount::dryRunCheckout(
+    TreeInodePtr rootInode,
+    const RootId& fromRootId,
+    const RootId& toRootId,
+    std::shared_ptr<CheckoutContext> ctx) {
+  const folly::stop_watch<> stopWatch;
+  auto checkoutTimes = std::make_shared<CheckoutTimes>();
+
+  auto statusCallback = std::make_unique<ScmStatusDiffCallback>();
+  auto statusFuture = diff(
+      std::move(rootInode),
+      statusCallback.get(),
+      fromRootId,
+      /*listIgnored=*/false,
+      /*enforceCurrentParent=*/false,
+      folly::CancellationToken{},
+      ctx->getFetchContext());
+
+  auto treeCallback = std::make_unique<ScmStatusDiffCallback>();
+  auto treeContext = createDiffContext(
+      treeCallback.get(),
+      folly::CancellationToken{},
+      ctx->getFetchContext(),
+      /*listIgnored=*/false);
+  auto treeFuture = diffRoots(treeContext.get(), fromRootId, toRootId);
+
+  return collectAllSafe(std::move(statusFuture), std::move(treeFuture))
+      .thenValue([statusCallback = std::move(statusCallback),
+                  treeCallback = std::move(treeCallback),
+                  treeContext = std::move(treeContext),
+                  checkoutTimes,
+                  stopWatch](auto&&) {
+        checkoutTimes->didDiff = stopWatch.elapsed();
+
+        CheckoutResult result;
+        result.conflicts = computeDryRunConflicts(
+            statusCallback->extractStatus(), treeCallback->extractStatus());
+        checkoutTimes->didFinish = stopWatch.elapsed();
+        result.times = *checkoutTimes;
+        return result;
+      })
+      .thenTry([this, ctx, stopWatch, fromRootId, toRootId](
+                   Try<CheckoutResult>&& result) {
+        auto fetchStats = ctx->getStatsContext().computeStatistics();
+
+        XLOG(DBG1) << (result.hasValue() ? "" : "failed ")
+                   << "dry-run conflict scan for " << this->getPath()
+                   << " from " << fromRootId << " to " << toRootId
+                   << " accessed " << fetchStats.tree.accessCount << " trees ("
+                   << fetchStats.tree.cacheHitRate << "% chr)";
+
+        auto event = FinishedCheckout{};
+        event.mode = getCheckoutModeString(CheckoutMode::DRY_RUN);
+        event.duration =
+            std::chrono::duration<double>{stopWatch.elapsed()}.count();
+        event.success = result.hasValue();
+        event.fetchedTrees = fetchStats.tree.fetchCount;
+        event.fetchedBlobs = fetchStats.blob.fetchCount;
+        event.fetchedBlobsMetadata = fetchStats.blobMetadata.fetchCount;
+        event.accessedTrees = fetchStats.tree.accessCount;
+        event.accessedBlobs = fetchStats.blob.accessCount;
+        event.accessedBlobsMetadata = fetchStats.blobMetadata.accessCount;
+        if (result.hasValue()) {
+          event.numConflicts = result.value().conflicts.size();
+        }
+        this->serverState_->getStructuredLogger()->logEvent(event);
+        return std::move(result);
+      })
+      .semi()
+      .via(getServerThreadPool().get());
+}
+
 folly::Future<CheckoutResult> EdenMount::checkout(
     TreeInodePtr rootInode,
     const RootId& snapshotHash,
@@ -1351,6 +1580,12 @@ folly::Future<CheckoutResult> EdenMount::checkout(
   const folly::stop_watch<> stopWatch;
   auto checkoutTimes = std::make_shared<CheckoutTimes>();
 
+  // DRY_RUN only reads, so when the conflict scanner is enabled it does not
+  // mark a checkout as in progress: concurrent status and checkout
+  // operations proceed as usual.
+  const bool useDryRunScan = checkoutMode == CheckoutMode::DRY_RUN &&
+      getEdenConfig()->dryRunConflictScan.getValue();
+
   ParentCommitState::CheckoutState oldState =
       ParentCommitState::NoOngoingCheckout{};
   RootId oldParent;
@@ -1387,7 +1622,9 @@ folly::Future<CheckoutResult> EdenMount::checkout(
     // achieving the same would be to hold the lock during the checkout
     // operation, but this might lead to deadlocks on Windows due to callbacks
     // needing to access the parent commit to service callbacks.
-    parentLock->checkoutState = ParentCommitState::CheckoutInProgress{};
+    if (!useDryRunScan) {
+      parentLock->checkoutState = ParentCommitState::CheckoutInProgress{};
+    }
   }
 
   auto ctx = std::make_shared<CheckoutContext>(
@@ -1399,6 +1636,11 @@ folly::Future<CheckoutResult> EdenMount::checkout(
   XLOG(DBG1) << "starting checkout for " << this->getPath() << ": " << oldParent
              << " to " << snapshotHash;
 
+  if (useDryRunScan) {
+    return dryRunCheckout(
+        std::move(rootInode), oldParent, snapshotHash, std::move(ctx));
+  }
+
   // Update lastCheckoutTime_ before starting the checkout operation.
   // This ensures that any inode objects created once the checkout starts will
   // get the current checkout time, rather than the time from the previous
@@ -1634,6 +1876,103 @@ folly::Future<CheckoutResult> EdenMount::checkout(
       });
 }
 
+folly::Future<CheckoutResult> EdenMount::checkoutPath(
+    RelativePathPiece path,
+    const RootId& toRootId,
+    const ObjectFetchContextPtr& fetchContext,
+    folly::StringPiece thriftMethodCaller,
+    CheckoutMode checkoutMode) {
+  const folly::stop_watch<> stopWatch;
+  auto checkoutTimes = std::make_shared<CheckoutTimes>();
+
+  {
+    // A full checkout swaps the parent commit out from under us, and an
+    // interrupted one leaves the working copy in a mixed state, so a scoped
+    // update cannot know which tree the subtree is based on. Unlike a full
+    // checkout, we do not mark a checkout as in progress: the subtree is
+    // protected by the per-inode checkout machinery, and concurrent scoped
+    // updates of disjoint directories are explicitly allowed.
+    auto parentLock = parentState_.rlock();
+    if (parentLock->isCheckoutInProgressOrInterrupted()) {
+      return makeFuture<CheckoutResult>(newEdenError(
+          EdenErrorType::CHECKOUT_IN_PROGRESS,
+          "cannot update a directory while a checkout operation is in progress"));
+    }
+  }
+
+  auto ctx = std::make_shared<CheckoutContext>(
+      this,
+      checkoutMode,
+      fetchContext->getClientPid(),
+      thriftMethodCaller,
+      fetchContext->getRequestInfo());
+  XLOG(DBG1) << "starting scoped checkout of " << path << " for "
+             << this->getPath() << " to " << toRootId;
+
+  // As with setPathsToObjectIds, inodes created by this operation should get
+  // the time of this operation rather than that of the last full checkout.
+  setLastCheckoutTime(EdenTimestamp{clock_->getRealtime()});
+
+  auto fromTreeFuture = lookupTreeUnderPrefix(
+      getCheckedOutRootTree(), path, objectStore_, ctx->getFetchContext());
+  auto toTreeFuture =
+      objectStore_->getRootTree(toRootId, ctx->getFetchContext())
+          .thenValue([this, path = RelativePath{path}, ctx](
+                         ObjectStore::GetRootTreeResult toRoot) {
+            return lookupTreeUnderPrefix(
+                std::move(toRoot.tree),
+                path,
+                objectStore_,
+                ctx->getFetchContext());
+          });
+  auto targetInodeFuture = ensureDirectoryExists(path, ctx->getFetchContext());
+
+  return collectAllSafe(
+             std::move(fromTreeFuture),
+             std::move(toTreeFuture),
+             std::move(targetInodeFuture))
+      .thenValue([ctx, checkoutTimes, stopWatch](
+                     std::tuple<
+                         shared_ptr<const Tree>,
+                         shared_ptr<const Tree>,
+                         TreeInodePtr> results) {
+        checkoutTimes->didLookupTrees = stopWatch.elapsed();
+        auto [fromTree, toTree, targetInode] = std::move(results);
+        // As in a full checkout, unload unreferenced children first so that
+        // unmodified subtrees can take the cheap wholesale-update path.
+        targetInode->unloadChildrenUnreferencedByFs();
+        return targetInode
+            ->checkout(ctx.get(), std::move(fromTree), std::move(toTree))
+            .semi();
+      })
+      .thenValue([ctx, checkoutTimes, stopWatch](auto&&) {
+        checkoutTimes->didCheckout = stopWatch.elapsed();
+        return ctx->flush().semi();
+      })
+      .thenValue([checkoutTimes,
+                  stopWatch](std::vector<CheckoutConflict>&& conflicts) {
+        checkoutTimes->didFinish = stopWatch.elapsed();
+        CheckoutResult result;
+        result.times = *checkoutTimes;
+        result.conflicts = std::move(conflicts);
+        return result;
+      })
+      .thenTry([this, ctx, path = RelativePath{path}, toRootId](
+                   Try<CheckoutResult>&& result) {
+        auto fetchStats = ctx->getStatsContext().computeStatistics();
+        XLOG(DBG1) << (result.hasValue() ? "" : "failed ")
+                   << "scoped checkout of " << path << " for "
+                   << this->getPath() << " to " << toRootId << " accessed "
+                   << fetchStats.tree.accessCount << " trees ("
+                   << fetchStats.tree.cacheHitRate << "% chr) and "
+                   << fetchStats.blob.accessCount << " blobs ("
+                   << fetchStats.blob.cacheHitRate << "% chr).";
+        return std::move(result);
+      })
+      .semi()
+      .via(getServerThreadPool().get());
+}
+
 void EdenMount::forgetStaleInodes() {
   inodeMap_->forgetStaleInodes();
 }
@@ -1741,7 +2080,8 @@ std::unique_ptr<DiffContext> EdenMount::createDiffContext(
       getCheckoutConfig()->getCaseSensitive(),
       getCheckoutConfig()->getEnableWindowsSymlinks(),
       getObjectStore(),
-      serverState_->getTopLevelIgnores());
+      serverState_->getTopLevelIgnores(),
+      treeDiffMemoCache_);
 }
 
 ImmediateFuture<Unit> EdenMount::diff(
@@ -1827,6 +2167,24 @@ ImmediateFuture<std::unique_ptr<ScmStatus>> EdenMount::diff(
     const ObjectFetchContextPtr& fetchContext,
     bool listIgnored,
     bool enforceCurrentParent) {
+  // Results only stay valid as long as nothing is written to the working
+  // copy, so there is no point caching a status too large to copy cheaply.
+  constexpr size_t kMaxCachedStatusEntries = 10'000;
+
+  bool useCache =
+      serverState_->getEdenConfig()->cacheScmStatus.getValue() && !listIgnored;
+  uint64_t journalSequence = 0;
+  if (useCache) {
+    if (auto latest = journal_->getLatest()) {
+      journalSequence = latest->sequenceID;
+    }
+    auto cache = cachedScmStatus_.rlock();
+    if (cache->has_value() && (*cache)->commit == commitHash &&
+        (*cache)->journalSequence == journalSequence) {
+      return std::make_unique<ScmStatus>((*cache)->status);
+    }
+  }
+
   auto callback = std::make_unique<ScmStatusDiffCallback>();
   auto callbackPtr = callback.get();
   return this
@@ -1838,8 +2196,21 @@ ImmediateFuture<std::unique_ptr<ScmStatus>> EdenMount::diff(
           enforceCurrentParent,
           std::move(cancellation),
           fetchContext)
-      .thenValue([callback = std::move(callback)](auto&&) {
-        return std::make_unique<ScmStatus>(callback->extractStatus());
+      .thenValue([this,
+                  callback = std::move(callback),
+                  commitHash,
+                  useCache,
+                  journalSequence](auto&&) {
+        auto status = std::make_unique<ScmStatus>(callback->extractStatus());
+        if (useCache &&
+            status->entries_ref()->size() <= kMaxCachedStatusEntries) {
+          // journalSequence was read before the walk started, so any write
+          // landing during the walk bumps the journal past it and the
+          // next query recomputes rather than seeing a stale result.
+          *cachedScmStatus_.wlock() = CachedScmStatus{
+              commitHash, journalSequence, /*listIgnored=*/false, *status};
+        }
+        return status;
       });
 }
 
@@ -1896,6 +2267,8 @@ std::string EdenMount::getCounterName(CounterName name) {
       return folly::to<std::string>("inodemap.", base, ".loaded");
     case CounterName::INODEMAP_UNLOADED:
       return folly::to<std::string>("inodemap.", base, ".unloaded");
+    case CounterName::INODEMAP_MEMORY:
+      return folly::to<std::string>("inodemap.", base, ".memory");
     case CounterName::JOURNAL_MEMORY:
       return folly::to<std::string>("journal.", base, ".memory");
     case CounterName::JOURNAL_ENTRIES:
@@ -1910,6 +2283,8 @@ std::string EdenMount::getCounterName(CounterName name) {
     case CounterName::PERIODIC_UNLINKED_INODE_UNLOAD:
       return folly::to<std::string>(
           "inodemap.", base, ".unloaded_unlinked_inodes");
+    case CounterName::OVERLAY_DATA_SIZE:
+      return folly::to<std::string>("overlay.", base, ".data_size");
   }
   EDEN_BUG() << "unknown counter name "
              << static_cast<std::underlying_type_t<CounterName>>(name);
@@ -1926,11 +2301,15 @@ std::unique_ptr<FuseChannel, FsChannelDeleter> makeFuseChannel(
     EdenMount* mount,
     folly::File fuseFd) {
   auto edenConfig = mount->getEdenConfig();
+  size_t numFuseThreads = edenConfig->fuseNumDispatcherThreads.getValue();
+  if (numFuseThreads == 0) {
+    numFuseThreads = FLAGS_fuseNumThreads;
+  }
   return makeFuseChannel(
       mount->getServerState()->getPrivHelper(),
       std::move(fuseFd),
       mount->getPath(),
-      FLAGS_fuseNumThreads,
+      numFuseThreads,
       EdenDispatcherFactory::makeFuseDispatcher(mount),
       &mount->getStraceLogger(),
       mount->getServerState()->getProcessInfoCache(),
@@ -1944,7 +2323,10 @@ std::unique_ptr<FuseChannel, FsChannelDeleter> makeFuseChannel(
       mount->getCheckoutConfig()->getUseWriteBackCache(),
       mount->getServerState()
           ->getEdenConfig()
-          ->FuseTraceBusCapacity.getValue());
+          ->FuseTraceBusCapacity.getValue(),
+      edenConfig->fuseWorkerThreadCpuAffinity.getValue(),
+      edenConfig->fuseMaximumRequestPages.getValue(),
+      edenConfig->fuseMaximumInflightLowPriorityRequests.getValue());
 }
 } // namespace
 #endif
@@ -1974,6 +2356,7 @@ folly::Future<NfsServer::NfsMountInfo> makeNfsChannel(
                    mount->getServerState()->getNotifier(),
                    mount->getCheckoutConfig()->getCaseSensitive(),
                    iosize,
+                   edenConfig->nfsUnstableWrites.getValue(),
                    edenConfig->nfsTraceBusCapacity.getValue());
              })
       .thenValue([mount,
@@ -2211,12 +2594,16 @@ void EdenMount::preparePostFsChannelCompletion(
             }
 
             fsChannelCompletionPromise_.setWith([&] {
-              return TakeoverData::MountInfo{
+              auto mountInfo = TakeoverData::MountInfo{
                   getPath(),
                   checkoutConfig_->getClientDirectory(),
                   stopData->extractTakeoverInfo(),
                   SerializedInodeMap{} // placeholder
               };
+              // Hand our generation to the new process so that journal
+              // positions held by clients stay valid across the takeover.
+              mountInfo.mountGeneration = getMountGeneration();
+              return mountInfo;
             });
           })
           .deferError([this](folly::exception_wrapper&& ew) {
@@ -2429,6 +2816,23 @@ std::optional<TreePrefetchLease> EdenMount::tryStartTreePrefetch(
     const ObjectFetchContext& context) {
   auto config = serverState_->getEdenConfig(ConfigReloadBehavior::NoReload);
   auto maxTreePrefetches = config->maxTreePrefetches.getValue();
+  auto backpressureThreshold =
+      config->treePrefetchBackpressureThreshold.getValue();
+  if (backpressureThreshold != 0) {
+    // Scale the prefetch concurrency limit down as the backing store's pending
+    // import queue fills up, so prefetching saturates an idle store but yields
+    // to interactive fetches when the store is already backed up.
+    auto pendingImports =
+        objectStore_->getBackingStore()->getPendingImportCount();
+    if (pendingImports >= backpressureThreshold) {
+      maxTreePrefetches = 0;
+    } else {
+      maxTreePrefetches = std::max(
+          uint64_t{1},
+          maxTreePrefetches * (backpressureThreshold - pendingImports) /
+              backpressureThreshold);
+    }
+  }
   auto numInProgress =
       numPrefetchesInProgress_.fetch_add(1, std::memory_order_acq_rel);
   if (numInProgress < maxTreePrefetches) {
@@ -2451,6 +2855,17 @@ std::optional<EdenMount::WorkingCopyGCLease> EdenMount::tryStartWorkingCopyGC(
       &workingCopyGCInProgress_, std::move(inode)};
 }
 
+void EdenMount::recordReaddirFollowedByChildAccess(InodeNumber dir) {
+  readdirPrefetchHistory_.wlock()->set(dir, true);
+}
+
+bool EdenMount::wasReaddirFollowedByChildAccess(InodeNumber dir) {
+  auto history = readdirPrefetchHistory_.wlock();
+  // find() rather than exists() so the hit refreshes the entry's LRU
+  // position.
+  return history->find(dir) != history->end();
+}
+
 void EdenMount::treePrefetchFinished() noexcept {
   auto oldValue =
       numPrefetchesInProgress_.fetch_sub(1, std::memory_order_acq_rel);
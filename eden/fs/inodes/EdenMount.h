@@ -12,6 +12,8 @@
 #include <folly/SharedMutex.h>
 #include <folly/Synchronized.h>
 #include <folly/ThreadLocal.h>
+#include <folly/container/EvictingCacheMap.h>
+#include <folly/experimental/ReadMostlySharedPtr.h>
 #include <folly/futures/Future.h>
 #include <folly/futures/Promise.h>
 #include <folly/futures/SharedPromise.h>
@@ -51,6 +53,7 @@ DECLARE_string(edenfsctlPath);
 
 namespace folly {
 class EventBase;
+class Executor;
 class File;
 
 template <typename T>
@@ -63,6 +66,7 @@ class BindMount;
 class BlobCache;
 class CheckoutConfig;
 class CheckoutConflict;
+class CheckoutContext;
 class Clock;
 class DiffContext;
 class EdenConfig;
@@ -78,10 +82,12 @@ class Journal;
 class MountPoint;
 class Nfsd3;
 class ObjectStore;
+class TreeDiffMemoCache;
 class Overlay;
 class OverlayFileAccess;
 class PrjfsChannel;
 class ServerState;
+class StripedSerialExecutor;
 class Tree;
 class TreePrefetchLease;
 class UnboundedQueueExecutor;
@@ -168,6 +174,11 @@ enum class CounterName {
    * Represents count of unloaded inodes in the current mount.
    */
   INODEMAP_UNLOADED,
+  /**
+   * Represents the estimated memory retained by the InodeMap and the loaded
+   * inodes it tracks.
+   */
+  INODEMAP_MEMORY,
   /**
    * Represents the amount of memory used by deltas in the change log
    */
@@ -197,7 +208,13 @@ enum class CounterName {
    * unlinked inode unloading. This is used on NFS mounts to clean up old
    * inodes.
    */
-  PERIODIC_UNLINKED_INODE_UNLOAD
+  PERIODIC_UNLINKED_INODE_UNLOAD,
+
+  /**
+   * Represents the on-disk size of this mount's overlay, in bytes, as of the
+   * most recent periodic size check. Reports 0 until the first check runs.
+   */
+  OVERLAY_DATA_SIZE
 
 };
 
@@ -350,11 +367,14 @@ class EdenMount : public std::enable_shared_from_this<EdenMount> {
    * Asynchronous EdenMount initialization - post instantiation.
    *
    * If takeover data is specified, it is used to initialize the inode map.
+   * If the old process handed over its mount generation, this mount adopts
+   * it so journal positions held by clients stay valid across the restart.
    */
   FOLLY_NODISCARD folly::Future<folly::Unit> initialize(
       OverlayChecker::ProgressCallback&& progressCallback = [](auto) {},
       const std::optional<SerializedInodeMap>& takeover = std::nullopt,
-      const std::optional<MountProtocol>& takeoverMountProtocol = std::nullopt);
+      const std::optional<MountProtocol>& takeoverMountProtocol = std::nullopt,
+      const std::optional<uint64_t>& takeoverMountGeneration = std::nullopt);
 
   /**
    * Destroy the EdenMount.
@@ -615,6 +635,13 @@ class EdenMount : public std::enable_shared_from_this<EdenMount> {
 
   std::shared_ptr<const EdenConfig> getEdenConfig() const;
 
+  /**
+   * Like getEdenConfig(), but avoids bouncing a shared refcount cache line
+   * between cores.  Prefer this for short-lived snapshots on request hot
+   * paths; see ReloadableConfig::getEdenConfigReadMostly().
+   */
+  folly::ReadMostlySharedPtr<const EdenConfig> getEdenConfigReadMostly() const;
+
   const CheckoutConfig* getCheckoutConfig() const {
     return checkoutConfig_.get();
   }
@@ -624,6 +651,16 @@ class EdenMount : public std::enable_shared_from_this<EdenMount> {
    */
   const std::shared_ptr<UnboundedQueueExecutor>& getServerThreadPool() const;
 
+  /**
+   * Returns the executor that this mount's background work should run on.
+   *
+   * When core:mount-executor-lanes is non-zero this is a group of serialized
+   * lanes striped over the server's thread pool, bounding how many pool
+   * threads this mount can occupy at once; otherwise it is the shared server
+   * thread pool itself.
+   */
+  folly::Executor* getMountThreadPool() const;
+
 #ifdef _WIN32
   /**
    * Returns the thread pool where directory invalidation need to be performed.
@@ -764,6 +801,47 @@ class EdenMount : public std::enable_shared_from_this<EdenMount> {
       folly::StringPiece thriftMethodCaller,
       CheckoutMode checkoutMode = CheckoutMode::NORMAL);
 
+  /**
+   * Compute the conflicts a checkout to toRootId would hit, without going
+   * through the checkout machinery.
+   *
+   * This is the DRY_RUN fast path: it runs two parallel diffs - the working
+   * copy against fromRootId and fromRootId against toRootId - using the
+   * batched diff engine, and joins the results into the conflict list a real
+   * checkout would report. Since it only reads, it does not mark a checkout
+   * as in progress and never takes per-inode checkout locks.
+   */
+  folly::Future<CheckoutResult> dryRunCheckout(
+      TreeInodePtr rootInode,
+      const RootId& fromRootId,
+      const RootId& toRootId,
+      std::shared_ptr<CheckoutContext> ctx);
+
+  /**
+   * Check out only the subtree under the given path to its state in the
+   * specified commit.
+   *
+   * This applies the tree differences between the currently checked out
+   * commit and toRootId below `path`, using the same per-entry checkout
+   * machinery - and thus the same conflict semantics - as a full checkout,
+   * but with a cost proportional to the subtree rather than the whole
+   * repository. The mount's parent commit is left unchanged, so the working
+   * copy becomes a mix of the parent commit and the updated directory; as
+   * with setPathsToObjectIds, it is up to the caller's source control
+   * tooling to account for that. A path missing from either commit is
+   * treated as an empty directory on that side.
+   *
+   * Fails with CHECKOUT_IN_PROGRESS when a full checkout is running or was
+   * interrupted, and with ENOTDIR when the path refers to a file in either
+   * commit.
+   */
+  folly::Future<CheckoutResult> checkoutPath(
+      RelativePathPiece path,
+      const RootId& toRootId,
+      const ObjectFetchContextPtr& fetchContext,
+      folly::StringPiece thriftMethodCaller,
+      CheckoutMode checkoutMode = CheckoutMode::NORMAL);
+
   /**
    * Chown the repository to the given uid and gid
    */
@@ -810,6 +888,22 @@ class EdenMount : public std::enable_shared_from_this<EdenMount> {
       DiffContext* ctxPtr,
       const RootId& commitHash) const;
 
+  /**
+   * This accepts a callback which will be invoked as differences are found.
+   * Note that the callback methods may be invoked simultaneously from multiple
+   * different threads, and the callback is responsible for performing
+   * synchronization (if it is needed). It will be packaged into a DiffContext
+   * and passed through the TreeInode diff() codepath
+   */
+  FOLLY_NODISCARD ImmediateFuture<folly::Unit> diff(
+      TreeInodePtr rootInode,
+      DiffCallback* callback,
+      const RootId& commitHash,
+      bool listIgnored,
+      bool enforceCurrentParent,
+      folly::CancellationToken cancellation,
+      const ObjectFetchContextPtr& fetchContext) const;
+
   /**
    * Reset the state to point to the specified parent commit, without
    * modifying the working directory contents at all.
@@ -1021,6 +1115,22 @@ class EdenMount : public std::enable_shared_from_this<EdenMount> {
       TreeInodePtr treeInode,
       const ObjectFetchContext& context);
 
+  /**
+   * Record that a readdir of the given directory was followed by stat or
+   * open calls on its children, so future readdirs of the same directory
+   * can start prefetching immediately instead of waiting to re-observe the
+   * pattern. Used by the "adaptive" readdir prefetch policy; see
+   * TreeInode::considerReaddirPrefetch.
+   */
+  void recordReaddirFollowedByChildAccess(InodeNumber dir);
+
+  /**
+   * Whether a past readdir of the given directory was followed by accesses
+   * to its children. The history is in-memory and bounded, so a false
+   * return may just mean the entry aged out.
+   */
+  bool wasReaddirFollowedByChildAccess(InodeNumber dir);
+
   /**
    * Lease to be held for the duration of a background GC.
    *
@@ -1199,22 +1309,6 @@ class EdenMount : public std::enable_shared_from_this<EdenMount> {
       const ObjectFetchContextPtr& fetchContext,
       bool listIgnored = false) const;
 
-  /**
-   * This accepts a callback which will be invoked as differences are found.
-   * Note that the callback methods may be invoked simultaneously from multiple
-   * different threads, and the callback is responsible for performing
-   * synchronization (if it is needed). It will be packaged into a DiffContext
-   * and passed through the TreeInode diff() codepath
-   */
-  FOLLY_NODISCARD ImmediateFuture<folly::Unit> diff(
-      TreeInodePtr rootInode,
-      DiffCallback* callback,
-      const RootId& commitHash,
-      bool listIgnored,
-      bool enforceCurrentParent,
-      folly::CancellationToken cancellation,
-      const ObjectFetchContextPtr& fetchContext) const;
-
   /**
    * Signal to unmount() that fsChannelMount() or takeoverFuse() has started.
    *
@@ -1287,6 +1381,13 @@ class EdenMount : public std::enable_shared_from_this<EdenMount> {
   std::shared_ptr<UnboundedQueueExecutor> invalidationExecutor_;
 #endif
 
+  /**
+   * Serialized executor lanes over the server thread pool for this mount's
+   * background work, or nullptr when core:mount-executor-lanes is 0. See
+   * getMountThreadPool().
+   */
+  std::shared_ptr<StripedSerialExecutor> mountThreadPool_;
+
   /**
    * Should the created mount use NFS (only currently supported on Linux and
    * Windows). We calculate this when the mount is created based on the
@@ -1299,6 +1400,13 @@ class EdenMount : public std::enable_shared_from_this<EdenMount> {
   std::shared_ptr<ObjectStore> objectStore_;
   std::shared_ptr<BlobCache> blobCache_;
   BlobAccess blobAccess_;
+
+  /**
+   * Memo of finished tree-pair diff results shared by every diff operation
+   * on this mount, so repeated status calls re-walk only materialized paths.
+   * Null when store:tree-diff-memo-cache-entries is 0.
+   */
+  std::shared_ptr<TreeDiffMemoCache> treeDiffMemoCache_;
   std::shared_ptr<Overlay> overlay_;
 
 #ifndef _WIN32
@@ -1327,11 +1435,34 @@ class EdenMount : public std::enable_shared_from_this<EdenMount> {
   std::unique_ptr<Journal> journal_;
   folly::Synchronized<std::unique_ptr<IActivityRecorder>> activityRecorder_;
 
+  /**
+   * The result of the most recent successful status computation, keyed by
+   * the commit it was computed against and the journal sequence number
+   * observed before the walk began. As long as the journal records no
+   * further working copy change, a repeated status query for the same
+   * commit is answered from this cache without re-walking the tree; any
+   * mismatch falls back to the full diff. Only populated when
+   * mount:cache-scm-status is enabled.
+   */
+  struct CachedScmStatus {
+    RootId commit;
+    // JournalDelta::SequenceNumber; spelled out to avoid pulling the
+    // journal headers into this file for one alias.
+    uint64_t journalSequence{0};
+    bool listIgnored{false};
+    ScmStatus status;
+  };
+  folly::Synchronized<std::optional<CachedScmStatus>> cachedScmStatus_;
+
   /**
    * A number to uniquely identify this particular incarnation of this mount.
    * We use bits from the process id and the time at which we were mounted.
+   *
+   * Not const only because initialize() overwrites it with the old
+   * process's generation during a graceful takeover, before the mount is
+   * visible to any client. It must not change after initialization.
    */
-  const uint64_t mountGeneration_;
+  uint64_t mountGeneration_;
 
   /**
    * The path to the unix socket that can be used to address us via thrift
@@ -1415,6 +1546,20 @@ class EdenMount : public std::enable_shared_from_this<EdenMount> {
    */
   std::atomic<uint64_t> numPrefetchesInProgress_{0};
 
+  /**
+   * How many directories the adaptive readdir prefetch policy remembers.
+   */
+  static constexpr size_t kReaddirPrefetchHistorySize = 4096;
+
+  /**
+   * Directories whose readdir was followed by child accesses, consulted by
+   * the adaptive readdir prefetch policy. Survives inode unloads (the
+   * per-inode prefetch state does not) but is not persisted across
+   * restarts.
+   */
+  folly::Synchronized<folly::EvictingCacheMap<InodeNumber, bool>>
+      readdirPrefetchHistory_{folly::in_place, kReaddirPrefetchHistorySize};
+
   /**
    * Whether a periodic working copy GC is ongoing for this mount.
    */
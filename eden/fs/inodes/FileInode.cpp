@@ -10,11 +10,13 @@
 #include <fmt/format.h>
 #include <optional>
 
+#include <folly/futures/Future.h>
 #include <folly/io/Cursor.h>
 #include <folly/io/IOBuf.h>
 #include <folly/io/async/EventBase.h>
 #include <folly/logging/xlog.h>
 
+#include "eden/fs/fuse/FuseChannel.h"
 #include "eden/fs/inodes/EdenMount.h"
 #include "eden/fs/inodes/InodeError.h"
 #include "eden/fs/inodes/InodeTable.h"
@@ -94,6 +96,14 @@ class FileInode::LockedState {
    */
   void setMaterialized();
 
+  /**
+   * Move the file back into the BLOB_NOT_LOADING state, recording the
+   * source control object it is now known to be identical to.
+   *
+   * May only be called in the MATERIALIZED_IN_OVERLAY state.
+   */
+  void setDematerialized(const ObjectId& hash, uint64_t size);
+
   /**
    * If this inode still has access to a cached blob, return it.
    *
@@ -169,6 +179,17 @@ void FileInode::LockedState::setMaterialized() {
 #endif
 }
 
+void FileInode::LockedState::setDematerialized(
+    const ObjectId& hash,
+    uint64_t size) {
+  XCHECK_EQ(ptr_->tag, State::MATERIALIZED_IN_OVERLAY);
+  ptr_->materializedState.~MaterializedState();
+  new (&ptr_->nonMaterializedState)
+      FileInodeState::NonMaterializedState{hash};
+  ptr_->nonMaterializedState.size = size;
+  ptr_->tag = State::BLOB_NOT_LOADING;
+}
+
 /*********************************************************************
  * Implementations of FileInode private template methods
  * These definitions need to appear before any functions that use them.
@@ -761,6 +782,82 @@ ImmediateFuture<bool> FileInode::isSameAs(
 }
 
 #ifndef _WIN32
+ImmediateFuture<folly::Unit> FileInode::dematerializeIfUnchanged(
+    ObjectId scmHash,
+    TreeEntryType scmType,
+    const ObjectFetchContextPtr& fetchContext) {
+  {
+    auto state = state_.rlock();
+    if (!state->isMaterialized()) {
+      return folly::unit;
+    }
+    if (scmType != treeEntryTypeFromMode(getMetadataLocked(*state).mode)) {
+      return folly::unit;
+    }
+  }
+
+  // Fetch the blob's metadata before taking any locks; the comparison is
+  // re-validated under the state lock in dematerializeIfContentsMatch().
+  return getObjectStore()
+      .getBlobMetadata(scmHash, fetchContext)
+      .thenTry([self = inodePtrFromThis(), scmHash, scmType](
+                   folly::Try<BlobMetadata> metadata) {
+        if (metadata.hasException()) {
+          XLOG(DBG4) << "not dematerializing " << self->getLogPath() << ": "
+                     << metadata.exception();
+          return folly::unit;
+        }
+        self->dematerializeIfContentsMatch(scmHash, scmType, metadata.value());
+        return folly::unit;
+      });
+}
+
+void FileInode::dematerializeIfContentsMatch(
+    const ObjectId& scmHash,
+    TreeEntryType scmType,
+    const BlobMetadata& scmMetadata) {
+  // The rename lock is required by TreeInode::childDematerialized() and
+  // pins our location for the duration.
+  auto renameLock = getMount()->acquireRenameLock();
+  auto loc = getLocationInfo(renameLock);
+  if (!loc.parent || loc.unlinked) {
+    return;
+  }
+
+  {
+    auto state = LockedState{this};
+    if (!state->isMaterialized()) {
+      return;
+    }
+    if (scmType != treeEntryTypeFromMode(getMetadataLocked(*state).mode)) {
+      return;
+    }
+    // Writes modify the overlay file while holding the state lock, so
+    // comparing sizes and hashes here cannot race with a concurrent
+    // modification.  The size check makes the common "file did change"
+    // case cheap; hashing only happens when the sizes agree and no SHA-1
+    // is cached.
+    if (state->materializedState.getSize(*this) != scmMetadata.size ||
+        state->materializedState.getSha1(*this) != scmMetadata.sha1) {
+      return;
+    }
+
+    state.setDematerialized(scmHash, scmMetadata.size);
+  }
+
+  XLOG(DBG4) << "dematerialized " << getLogPath() << ": contents match blob "
+             << scmHash;
+
+  loc.parent->childDematerialized(renameLock, loc.name, scmHash);
+
+  // Now that the parent records a source control hash for this entry again,
+  // our overlay data can be removed.  The ordering matters: the parent is
+  // updated first so our overlay data is never missing while the parent
+  // still claims we are materialized.
+  getMount()->getOverlayFileAccess()->forget(getNodeId());
+  getMount()->getOverlay()->removeOverlayFile(getNodeId());
+}
+
 mode_t FileInode::getMode() const {
   return getMetadata().mode;
 }
@@ -858,6 +955,30 @@ ImmediateFuture<Hash20> FileInode::getSha1(
       return getObjectStore().getBlobSha1(
           state->nonMaterializedState.hash, fetchContext);
     case State::MATERIALIZED_IN_OVERLAY:
+      // Hashing reads the entire file, so recomputing the SHA-1 of a large
+      // materialized file inline would pin the calling (dispatcher) thread
+      // for the whole read. Offload those to the server thread pool.
+      if (!state->materializedState.hasCachedSha1() &&
+          state->materializedState.getSize(*this) >=
+              getMount()
+                  ->getEdenConfigReadMostly()
+                  ->hashOffloadSizeThreshold.getValue()) {
+        state.unlock();
+        return ImmediateFuture<Hash20>{folly::via(
+            getMount()->getServerThreadPool().get(),
+            [self = inodePtrFromThis(), fetchContext = fetchContext.copy()]()
+                -> folly::SemiFuture<Hash20> {
+              {
+                auto state = LockedState{self};
+                if (state->tag == State::MATERIALIZED_IN_OVERLAY) {
+                  return state->materializedState.getSha1(*self);
+                }
+              }
+              // The file was dematerialized while the hash was queued;
+              // restart on the blob path.
+              return self->getSha1(fetchContext).semi();
+            })};
+      }
       return makeImmediateFutureWith(
           [&] { return state->materializedState.getSha1(*this); });
   }
@@ -877,15 +998,61 @@ ImmediateFuture<Hash32> FileInode::getBlake3(
       return getObjectStore().getBlobBlake3(
           state->nonMaterializedState.hash, fetchContext);
     case State::MATERIALIZED_IN_OVERLAY:
+      // As with getSha1, don't hash large materialized files inline on the
+      // calling thread. The BLAKE3 cache lives in OverlayFileAccess so a
+      // cached hash isn't visible here; a large file with a cached hash just
+      // pays one hop to the server thread pool.
+      if (state->materializedState.getSize(*this) >=
+          getMount()
+              ->getEdenConfigReadMostly()
+              ->hashOffloadSizeThreshold.getValue()) {
+        state.unlock();
+        return ImmediateFuture<Hash32>{folly::via(
+            getMount()->getServerThreadPool().get(),
+            [self = inodePtrFromThis(),
+             fetchContext = fetchContext.copy(),
+             blake3Key = getMount()
+                             ->getEdenConfigReadMostly()
+                             ->blake3Key.getValue()]()
+                -> folly::SemiFuture<Hash32> {
+              {
+                auto state = LockedState{self};
+                if (state->tag == State::MATERIALIZED_IN_OVERLAY) {
+                  return state->materializedState.getBlake3(*self, blake3Key);
+                }
+              }
+              // The file was dematerialized while the hash was queued;
+              // restart on the blob path.
+              return self->getBlake3(fetchContext).semi();
+            })};
+      }
       return makeImmediateFutureWith([&] {
         return state->materializedState.getBlake3(
-            *this, getMount()->getEdenConfig()->blake3Key.getValue());
+            *this, getMount()->getEdenConfigReadMostly()->blake3Key.getValue());
       });
   }
 
   XLOG(FATAL) << "FileInode in illegal state: " << state->tag;
 }
 
+ImmediateFuture<uint64_t> FileInode::getSize(
+    const ObjectFetchContextPtr& fetchContext) {
+  auto state = LockedState{this};
+
+  logAccess(*fetchContext);
+  switch (state->tag) {
+    case State::BLOB_NOT_LOADING:
+    case State::BLOB_LOADING:
+      return getObjectStore().getBlobSize(
+          state->nonMaterializedState.hash, fetchContext);
+    case State::MATERIALIZED_IN_OVERLAY:
+      return makeImmediateFutureWith(
+          [&] { return state->materializedState.getSize(*this); });
+  }
+
+  XLOG(FATAL) << "FileInode in illegal state: " << state->tag;
+}
+
 ImmediateFuture<BlobMetadata> FileInode::getBlobMetadata(
     const ObjectFetchContextPtr& fetchContext,
     bool blake3Required) {
@@ -899,11 +1066,53 @@ ImmediateFuture<BlobMetadata> FileInode::getBlobMetadata(
       return getObjectStore().getBlobMetadata(
           state->nonMaterializedState.hash, fetchContext, blake3Required);
     case State::MATERIALIZED_IN_OVERLAY:
+      // Computing metadata reads the file twice (SHA-1 and BLAKE3), so
+      // offload large files to the server thread pool rather than hashing
+      // inline on the calling thread.
+      if (state->materializedState.getSize(*this) >=
+          getMount()
+              ->getEdenConfigReadMostly()
+              ->hashOffloadSizeThreshold.getValue()) {
+        state.unlock();
+        return ImmediateFuture<BlobMetadata>{folly::via(
+            getMount()->getServerThreadPool().get(),
+            [self = inodePtrFromThis(),
+             fetchContext = fetchContext.copy(),
+             blake3Required,
+             blake3Key = getMount()
+                             ->getEdenConfigReadMostly()
+                             ->blake3Key.getValue()]()
+                -> folly::SemiFuture<BlobMetadata> {
+              {
+                auto state = LockedState{self};
+                if (state->tag == State::MATERIALIZED_IN_OVERLAY) {
+                  std::optional<Hash32> blake3;
+                  if (blake3Required) {
+                    blake3 =
+                        state->materializedState.getBlake3(*self, blake3Key);
+                  }
+                  return BlobMetadata{
+                      state->materializedState.getSha1(*self),
+                      std::move(blake3),
+                      state->materializedState.getSize(*self)};
+                }
+              }
+              // The file was dematerialized while the hash was queued;
+              // restart on the blob path.
+              return self->getBlobMetadata(fetchContext, blake3Required)
+                  .semi();
+            })};
+      }
       return makeImmediateFutureWith([&] {
+        std::optional<Hash32> blake3;
+        if (blake3Required) {
+          blake3 = state->materializedState.getBlake3(
+              *this,
+              getMount()->getEdenConfigReadMostly()->blake3Key.getValue());
+        }
         return BlobMetadata{
             state->materializedState.getSha1(*this),
-            state->materializedState.getBlake3(
-                *this, getMount()->getEdenConfig()->blake3Key.getValue()),
+            std::move(blake3),
             state->materializedState.getSize(*this)};
       });
   }
@@ -986,6 +1195,7 @@ ImmediateFuture<folly::Unit> FileInode::fallocate(
       LockedState{this},
       nullptr,
       [offset, length, self = inodePtrFromThis()](LockedState&& state) {
+        state->materializedState.invalidate();
         self->getOverlayFileAccess(state)->fallocate(*self, offset, length);
         return folly::unit;
       },
@@ -1094,8 +1304,30 @@ ImmediateFuture<std::tuple<BufVec, bool>> FileInode::read(
           state->readByteRanges.clear();
         }
 
-        auto buf = blob->getContents();
-        folly::io::Cursor cursor(&buf);
+        // When enabled, hand the rest of the blob to the kernel page cache
+        // as soon as the first read loads it, so subsequent reads of this
+        // file are served from kernel memory without further FUSE round
+        // trips. The store happens asynchronously on the invalidation
+        // thread; the kernel holds page locks for this read until our reply
+        // is sent.
+        if (off == 0 && blob->getSize() > size) {
+          if (auto* fuseChannel = self->getMount()->getFuseChannel()) {
+            if (self->getMount()
+                    ->getEdenConfigReadMostly()
+                    ->fuseNotifyStoreBlobs.getValue()) {
+              fuseChannel->storeData(
+                  self->getNodeId(), 0, blob->getContents().clone());
+            }
+          }
+        }
+
+        // Read directly out of the blob's IOBuf chain. Cloning the requested
+        // slice shares the blob's underlying buffers rather than copying
+        // them, and FuseChannel writes the chain to /dev/fuse with writev,
+        // so the blob bytes are handed to the kernel without a memcpy. The
+        // cloned slice keeps the buffers alive even if the blob is evicted
+        // from the BlobCache before the reply is sent.
+        folly::io::Cursor cursor(&blob->getContents());
 
         if (!cursor.canAdvance(off)) {
           // Seek beyond EOF.  Return an empty result.
@@ -1367,7 +1599,7 @@ void FileInode::materializeNow(
 void FileInode::materializeAndTruncate(LockedState& state) {
   XCHECK_NE(state->tag, State::MATERIALIZED_IN_OVERLAY);
   getOverlayFileAccess(state)->createEmptyFile(
-      getNodeId(), getMount()->getEdenConfig()->blake3Key.getValue());
+      getNodeId(), getMount()->getEdenConfigReadMostly()->blake3Key.getValue());
   state.setMaterialized();
 }
 
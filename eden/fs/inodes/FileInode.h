@@ -121,6 +121,14 @@ struct FileInodeState {
      */
     uint64_t getSize(FileInode& inode);
 
+    /**
+     * Whether a sha1 is cached, i.e. whether getSha1 will return without
+     * reading and hashing the file contents.
+     */
+    bool hasCachedSha1() const {
+      return sha1_.has_value();
+    }
+
     /**
      * Reset the cached sha1 and size.
      *
@@ -232,6 +240,15 @@ class FileInode final : public InodeBaseMetadata<FileInodeState> {
       const ObjectFetchContextPtr& fetchContext,
       bool blake3Required = false);
 
+  /**
+   * Return the size of this file's contents.
+   *
+   * Unlike getBlobMetadata(), this never fetches blob contents or computes
+   * hashes: materialized files answer from the overlay file and
+   * non-materialized files from the object store's size lookup.
+   */
+  ImmediateFuture<uint64_t> getSize(const ObjectFetchContextPtr& fetchContext);
+
   /**
    * Check to see if the file has the same contents as the specified blob
    * and the same tree entry type.
@@ -254,6 +271,25 @@ class FileInode final : public InodeBaseMetadata<FileInodeState> {
       TreeEntryType entryType,
       const ObjectFetchContextPtr& fetchContext);
 
+#ifndef _WIN32
+  /**
+   * If this file is materialized but its contents are identical to the given
+   * source control blob, flip it back to the unmaterialized state and remove
+   * its overlay data.
+   *
+   * This reverses materialization for files that a build touched and then
+   * restored: the parent directory records the source control hash again, so
+   * the file stops paying overlay read costs and no longer counts against
+   * fsck and takeover time.  Does nothing if the file has been unlinked,
+   * has a different type or contents than the blob, or is modified
+   * concurrently with the comparison.
+   */
+  ImmediateFuture<folly::Unit> dematerializeIfUnchanged(
+      ObjectId scmHash,
+      TreeEntryType scmType,
+      const ObjectFetchContextPtr& fetchContext);
+#endif // !_WIN32
+
   /**
    * Get the file mode_t value.
    */
@@ -506,6 +542,18 @@ class FileInode final : public InodeBaseMetadata<FileInodeState> {
       const ObjectFetchContextPtr& fetchContext);
 
 #ifndef _WIN32
+  /**
+   * Helper function for dematerializeIfUnchanged().
+   *
+   * Re-validates the comparison against the blob's metadata under the
+   * rename and state locks, and performs the actual state flip and overlay
+   * cleanup when the contents match.
+   */
+  void dematerializeIfContentsMatch(
+      const ObjectId& scmHash,
+      TreeEntryType scmType,
+      const BlobMetadata& scmMetadata);
+
   /**
    * Returns the OverlayFileAccess used to mediate access to an overlay file.
    *
@@ -13,6 +13,7 @@
 namespace facebook::eden {
 
 class ProcessAccessLog;
+struct FsLatencyHistograms;
 
 class FsStopData {
  public:
@@ -90,6 +91,14 @@ class FsChannel {
    */
   virtual ProcessAccessLog& getProcessAccessLog() = 0;
 
+  /**
+   * Returns this channel's per-mount latency histograms, or nullptr for
+   * channel types that do not maintain them.
+   */
+  virtual const FsLatencyHistograms* getLatencyHistograms() const {
+    return nullptr;
+  }
+
   /**
    * Some user-space filesystem implementations (notably Projected FS, but also
    * FUSE in writeback-cache mode) receive write notifications asynchronously.
@@ -9,6 +9,7 @@
 
 #include "eden/fs/inodes/FuseDispatcherImpl.h"
 #include <folly/logging/xlog.h>
+#include "eden/fs/config/EdenConfig.h"
 #include "eden/fs/fuse/FuseDirList.h"
 #include "eden/fs/inodes/EdenMount.h"
 #include "eden/fs/inodes/FileInode.h"
@@ -29,7 +30,16 @@ namespace facebook::eden {
 
 namespace {
 
-/** Compute a fuse_entry_out */
+/**
+ * Compute a fuse_entry_out.
+ *
+ * The entry and attribute TTLs handed to the kernel are effectively
+ * infinite by default: correctness is maintained by explicit invalidation
+ * instead. Checkout and write paths call FuseChannel::invalidateEntry /
+ * invalidateInode for every path they change, so the kernel can keep
+ * absorbing repeated lookups of unchanged paths indefinitely. The TTL is
+ * only configurable (fuse:cache-ttl) as a diagnostic escape hatch.
+ */
 fuse_entry_out computeEntryParam(const FuseDispatcher::Attr& attr) {
   XDCHECK(attr.st.st_ino) << "We should never return a 0 inode to FUSE";
   fuse_entry_out entry = {};
@@ -57,7 +67,11 @@ FuseDispatcher::Attr attrForInodeWithCorruptOverlay(InodeNumber ino) noexcept {
 FuseDispatcherImpl::FuseDispatcherImpl(EdenMount* mount)
     : FuseDispatcher(mount->getStats().copy()),
       mount_(mount),
-      inodeMap_(mount_->getInodeMap()) {}
+      inodeMap_(mount_->getInodeMap()),
+      cacheTimeoutSeconds_(static_cast<uint64_t>(
+          std::chrono::duration_cast<std::chrono::seconds>(
+              mount->getEdenConfig()->fuseCacheTTL.getValue())
+              .count())) {}
 
 ImmediateFuture<FuseDispatcher::Attr> FuseDispatcherImpl::getattr(
     InodeNumber ino,
@@ -66,8 +80,9 @@ ImmediateFuture<FuseDispatcher::Attr> FuseDispatcherImpl::getattr(
       .thenValue([context = context.copy()](const InodePtr& inode) {
         return inode->stat(context);
       })
-      .thenValue(
-          [](const struct stat& st) { return FuseDispatcher::Attr{st}; });
+      .thenValue([ttl = cacheTimeoutSeconds_](const struct stat& st) {
+        return FuseDispatcher::Attr{st, ttl};
+      });
 }
 
 ImmediateFuture<uint64_t> FuseDispatcherImpl::opendir(
@@ -101,13 +116,14 @@ ImmediateFuture<fuse_entry_out> FuseDispatcherImpl::lookup(
                   context = context.copy()](const TreeInodePtr& tree) {
         return tree->getOrLoadChild(name, context);
       })
-      .thenValue([context = context.copy()](const InodePtr& inode) {
+      .thenValue([context = context.copy(),
+                  ttl = cacheTimeoutSeconds_](const InodePtr& inode) {
         return makeImmediateFutureWith([&]() { return inode->stat(context); })
-            .thenTry([inode](folly::Try<struct stat> maybeStat) {
+            .thenTry([inode, ttl](folly::Try<struct stat> maybeStat) {
               if (maybeStat.hasValue()) {
                 inode->incFsRefcount();
                 return computeEntryParam(
-                    FuseDispatcher::Attr{maybeStat.value()});
+                    FuseDispatcher::Attr{maybeStat.value(), ttl});
               } else {
                 // The most common case for stat() failing is if this file is
                 // materialized but the data for it in the overlay is missing
@@ -200,8 +216,8 @@ ImmediateFuture<FuseDispatcher::Attr> FuseDispatcherImpl::setattr(
 
         return inode->setattr(desired, context);
       })
-      .thenValue([](struct stat&& stat) {
-        return FuseDispatcher::Attr{std::move(stat)};
+      .thenValue([ttl = cacheTimeoutSeconds_](struct stat&& stat) {
+        return FuseDispatcher::Attr{std::move(stat), ttl};
       });
 }
 
@@ -209,6 +225,11 @@ void FuseDispatcherImpl::forget(InodeNumber ino, unsigned long nlookup) {
   inodeMap_->decFsRefcount(ino, nlookup);
 }
 
+void FuseDispatcherImpl::forgetMulti(
+    const std::vector<std::pair<InodeNumber, uint32_t>>& entries) {
+  inodeMap_->decFsRefcounts(entries);
+}
+
 ImmediateFuture<uint64_t> FuseDispatcherImpl::open(
     InodeNumber /*ino*/,
     int /*flags*/) {
@@ -233,13 +254,15 @@ ImmediateFuture<fuse_entry_out> FuseDispatcherImpl::create(
   // (and thus can be zero)
   mode = S_IFREG | (07777 & mode);
   return inodeMap_->lookupTreeInode(parent).thenValue(
-      [mode, childName = PathComponent{name}, context = context.copy()](
-          const TreeInodePtr& inode) {
+      [mode,
+       childName = PathComponent{name},
+       context = context.copy(),
+       ttl = cacheTimeoutSeconds_](const TreeInodePtr& inode) {
         auto child = inode->mknod(childName, mode, 0, InvalidationRequired::No);
         return child->stat(context).thenValue(
-            [child](struct stat st) -> fuse_entry_out {
+            [child, ttl](struct stat st) -> fuse_entry_out {
               child->incFsRefcount();
-              return computeEntryParam(FuseDispatcher::Attr{st});
+              return computeEntryParam(FuseDispatcher::Attr{st, ttl});
             });
       });
 }
@@ -342,14 +365,17 @@ ImmediateFuture<fuse_entry_out> FuseDispatcherImpl::mknod(
     dev_t rdev,
     const ObjectFetchContextPtr& context) {
   return inodeMap_->lookupTreeInode(parent).thenValue(
-      [childName = PathComponent{name}, mode, rdev, context = context.copy()](
-          const TreeInodePtr& inode) {
+      [childName = PathComponent{name},
+       mode,
+       rdev,
+       context = context.copy(),
+       ttl = cacheTimeoutSeconds_](const TreeInodePtr& inode) {
         auto child =
             inode->mknod(childName, mode, rdev, InvalidationRequired::No);
         return child->stat(context).thenValue(
-            [child](struct stat st) -> fuse_entry_out {
+            [child, ttl](struct stat st) -> fuse_entry_out {
               child->incFsRefcount();
-              return computeEntryParam(FuseDispatcher::Attr{st});
+              return computeEntryParam(FuseDispatcher::Attr{st, ttl});
             });
       });
 }
@@ -360,12 +386,14 @@ ImmediateFuture<fuse_entry_out> FuseDispatcherImpl::mkdir(
     mode_t mode,
     const ObjectFetchContextPtr& context) {
   return inodeMap_->lookupTreeInode(parent).thenValue(
-      [childName = PathComponent{name}, mode, context = context.copy()](
-          const TreeInodePtr& inode) {
+      [childName = PathComponent{name},
+       mode,
+       context = context.copy(),
+       ttl = cacheTimeoutSeconds_](const TreeInodePtr& inode) {
         auto child = inode->mkdir(childName, mode, InvalidationRequired::No);
-        return child->stat(context).thenValue([child](struct stat st) {
+        return child->stat(context).thenValue([child, ttl](struct stat st) {
           child->incFsRefcount();
-          return computeEntryParam(FuseDispatcher::Attr{st});
+          return computeEntryParam(FuseDispatcher::Attr{st, ttl});
         });
       });
 }
@@ -402,13 +430,14 @@ ImmediateFuture<fuse_entry_out> FuseDispatcherImpl::symlink(
   return inodeMap_->lookupTreeInode(parent).thenValue(
       [linkContents = link.str(),
        childName = PathComponent{name},
-       context = context.copy()](const TreeInodePtr& inode) {
+       context = context.copy(),
+       ttl = cacheTimeoutSeconds_](const TreeInodePtr& inode) {
         auto symlinkInode =
             inode->symlink(childName, linkContents, InvalidationRequired::No);
         symlinkInode->incFsRefcount();
         return symlinkInode->stat(context).thenValue(
-            [symlinkInode](struct stat st) {
-              return computeEntryParam(FuseDispatcher::Attr{st});
+            [symlinkInode, ttl](struct stat st) {
+              return computeEntryParam(FuseDispatcher::Attr{st, ttl});
             });
       });
 }
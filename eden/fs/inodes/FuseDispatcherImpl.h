@@ -42,6 +42,8 @@ class FuseDispatcherImpl : public FuseDispatcher {
       const ObjectFetchContextPtr& context) override;
 
   void forget(InodeNumber ino, unsigned long nlookup) override;
+  void forgetMulti(const std::vector<std::pair<InodeNumber, uint32_t>>& entries)
+      override;
   ImmediateFuture<uint64_t> open(InodeNumber ino, int flags) override;
   ImmediateFuture<std::string> readlink(
       InodeNumber ino,
@@ -134,6 +136,10 @@ class FuseDispatcherImpl : public FuseDispatcher {
   // every FUSE request, and having it locally avoids having to dereference
   // mount_ first.
   InodeMap* const inodeMap_;
+
+  // How long the kernel may cache the dentries and attributes we return, in
+  // seconds. Captured from fuse:cache-ttl when the mount starts.
+  const uint64_t cacheTimeoutSeconds_;
 };
 
 } // namespace facebook::eden
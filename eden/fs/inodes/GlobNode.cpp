@@ -95,7 +95,8 @@ ImmediateFuture<folly::Unit> GlobNode::evaluate(
     TreeInodePtr root,
     PrefetchList* fileBlobsToPrefetch,
     ResultList& globResult,
-    const RootId& originRootId) const {
+    const RootId& originRootId,
+    folly::Executor* executor) const {
   return evaluateImpl<TreeInodePtrRoot, TreeInodePtr>(
              store.get(),
              context,
@@ -103,7 +104,8 @@ ImmediateFuture<folly::Unit> GlobNode::evaluate(
              TreeInodePtrRoot(std::move(root)),
              fileBlobsToPrefetch,
              globResult,
-             originRootId)
+             originRootId,
+             executor)
       // Make sure the store stays alive for the duration of globbing.
       .ensure([store] {});
 }
@@ -42,6 +42,9 @@ class GlobNode : public GlobNodeImpl {
    *
    * When fileBlobsToPrefetch is non-null, the Hash of the globbed files will
    * be appended to it.
+   *
+   * When executor is non-null, independent subtree evaluations are run on
+   * it rather than inline on the calling thread.
    */
   ImmediateFuture<folly::Unit> evaluate(
       std::shared_ptr<ObjectStore> store,
@@ -50,7 +53,8 @@ class GlobNode : public GlobNodeImpl {
       TreeInodePtr root,
       PrefetchList* fileBlobsToPrefetch,
       ResultList& globResult,
-      const RootId& originRootId) const;
+      const RootId& originRootId,
+      folly::Executor* executor = nullptr) const;
 };
 
 } // namespace facebook::eden
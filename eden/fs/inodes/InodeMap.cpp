@@ -13,6 +13,7 @@
 #include <folly/Likely.h>
 #include <folly/chrono/Conv.h>
 #include <folly/logging/xlog.h>
+#include <folly/memory/Malloc.h>
 
 #include "eden/fs/config/EdenConfig.h"
 #include "eden/fs/config/ReloadableConfig.h"
@@ -34,6 +35,16 @@ using std::optional;
 
 namespace facebook::eden {
 
+namespace {
+std::optional<ObjectIdInterner::Handle> internHash(
+    const std::optional<ObjectId>& hash) {
+  if (!hash) {
+    return std::nullopt;
+  }
+  return ObjectIdInterner::getInstance().intern(*hash);
+}
+} // namespace
+
 InodeMap::UnloadedInode::UnloadedInode(
     InodeNumber parentNum,
     PathComponentPiece entryName,
@@ -51,7 +62,7 @@ InodeMap::UnloadedInode::UnloadedInode(
       name(entryName),
       isUnlinked{isUnlinked},
       mode{mode},
-      hash{std::move(hash)},
+      hash{internHash(hash)},
       numFsReferences{fsRefcount} {
   if (folly::kIsWindows) {
     XDCHECK_LE(numFsReferences, 1u);
@@ -72,7 +83,7 @@ InodeMap::UnloadedInode::UnloadedInode(
       // this specific mode bit pattern in eden so we can
       // force the value down here.
       mode{S_IFDIR | 0755},
-      hash{std::move(hash)},
+      hash{internHash(hash)},
       numFsReferences{fsRefcount} {
   if (folly::kIsWindows) {
     XDCHECK_LE(numFsReferences, 1u);
@@ -89,7 +100,7 @@ InodeMap::UnloadedInode::UnloadedInode(
       name{entryName},
       isUnlinked{isUnlinked},
       mode{inode->getMode()},
-      hash{inode->getObjectId()},
+      hash{internHash(inode->getObjectId())},
       numFsReferences{fsRefcount} {
   if (folly::kIsWindows) {
     XDCHECK_LE(numFsReferences, 1u);
@@ -100,6 +111,13 @@ InodeType InodeMap::UnloadedInode::getInodeType() const {
   return S_ISDIR(mode) ? InodeType::TREE : InodeType::FILE;
 }
 
+std::optional<ObjectId> InodeMap::UnloadedInode::getHash() const {
+  if (!hash) {
+    return std::nullopt;
+  }
+  return ObjectIdInterner::getInstance().lookup(*hash);
+}
+
 InodeMap::InodeMap(
     EdenMount* mount,
     std::shared_ptr<ReloadableConfig> config,
@@ -174,9 +192,13 @@ void InodeMap::initializeUnloadedInode(
 void InodeMap::initializeFromTakeover(
     TreeInodePtr root,
     const SerializedInodeMap& takeover) {
+  const bool lazyHydration =
+      config_->getEdenConfig()->lazyTakeoverInodeHydration.getValue();
+
   auto data = data_.wlock();
   initializeRoot(data, std::move(root));
 
+  data->pendingTakeoverInodes_.reserve(takeover.unloadedInodes_ref()->size());
   for (const auto& entry : *takeover.unloadedInodes_ref()) {
     if (*entry.numFsReferences_ref() < 0) {
       auto message = folly::to<std::string>(
@@ -187,32 +209,76 @@ void InodeMap::initializeFromTakeover(
       throw std::runtime_error(message);
     }
 
-    std::optional<ObjectId> hash;
-    if (entry.hash_ref().has_value()) {
-      const std::string& value = entry.hash_ref().value();
-      if (value.empty()) {
-        // LEGACY: Old versions of EdenFS sent the empty string to mean
-        // materialized. When a BackingStore wants to support the empty ObjectId
-        // as a valid identifier, remove this code path.
-        hash = std::nullopt;
-      } else {
-        hash = ObjectId{value};
-      }
+    auto number = InodeNumber::fromThrift(*entry.inodeNumber_ref());
+    auto result = data->pendingTakeoverInodes_.emplace(number, entry);
+    if (!result.second) {
+      auto message = fmt::format(
+          "takeover data contains duplicate inode number {}", number);
+      XLOG(ERR) << message;
+      throw std::runtime_error(message);
     }
-    initializeUnloadedInode(
-        data,
-        InodeNumber::fromThrift(*entry.parentInode_ref()),
-        InodeNumber::fromThrift(*entry.inodeNumber_ref()),
-        PathComponentPiece{*entry.name_ref()},
-        *entry.isUnlinked_ref(),
-        *entry.mode_ref(),
-        std::move(hash),
-        folly::to<uint32_t>(*entry.numFsReferences_ref()));
+  }
+
+  if (!lazyHydration) {
+    // Construct the UnloadedInode entries up front. When
+    // experimental:lazy-takeover-inode-hydration is enabled this work is
+    // instead performed the first time each inode is accessed, so serving can
+    // start without walking the entire remembered-inode set.
+    hydrateAllTakeoverInodes(data);
   }
 
   XLOG(DBG2) << "InodeMap initialized mount " << mount_->getPath()
              << " from takeover, " << data->unloadedInodes_.size()
-             << " inodes registered";
+             << " inodes registered, " << data->pendingTakeoverInodes_.size()
+             << " takeover records pending hydration";
+}
+
+std::unordered_map<InodeNumber, InodeMap::UnloadedInode>::iterator
+InodeMap::hydrateTakeoverInode(
+    const folly::Synchronized<Members>::LockedPtr& data,
+    InodeNumber number) {
+  auto pendingIter = data->pendingTakeoverInodes_.find(number);
+  if (pendingIter == data->pendingTakeoverInodes_.end()) {
+    return data->unloadedInodes_.end();
+  }
+  const auto& entry = pendingIter->second;
+
+  std::optional<ObjectId> hash;
+  if (entry.hash_ref().has_value()) {
+    const std::string& value = entry.hash_ref().value();
+    if (value.empty()) {
+      // LEGACY: Old versions of EdenFS sent the empty string to mean
+      // materialized. When a BackingStore wants to support the empty ObjectId
+      // as a valid identifier, remove this code path.
+      hash = std::nullopt;
+    } else {
+      hash = ObjectId{value};
+    }
+  }
+  initializeUnloadedInode(
+      data,
+      InodeNumber::fromThrift(*entry.parentInode_ref()),
+      number,
+      PathComponentPiece{*entry.name_ref()},
+      *entry.isUnlinked_ref(),
+      *entry.mode_ref(),
+      std::move(hash),
+      folly::to<uint32_t>(*entry.numFsReferences_ref()));
+  data->pendingTakeoverInodes_.erase(pendingIter);
+  XLOG(DBG7) << "hydrated takeover record for inode " << number;
+  return data->unloadedInodes_.find(number);
+}
+
+void InodeMap::hydrateAllTakeoverInodes(
+    const folly::Synchronized<Members>::LockedPtr& data) {
+  if (data->pendingTakeoverInodes_.empty()) {
+    return;
+  }
+  XLOG(DBG4) << "hydrating " << data->pendingTakeoverInodes_.size()
+             << " remaining takeover inode records";
+  while (!data->pendingTakeoverInodes_.empty()) {
+    hydrateTakeoverInode(data, data->pendingTakeoverInodes_.begin()->first);
+  }
 }
 
 void InodeMap::initializeFromOverlay(TreeInodePtr root, Overlay& overlay) {
@@ -265,13 +331,50 @@ void InodeMap::initializeFromOverlay(TreeInodePtr root, Overlay& overlay) {
 }
 
 ImmediateFuture<InodePtr> InodeMap::lookupInode(InodeNumber number) {
-  // Lock the data.
+  // The overwhelmingly common case is looking up an inode that is already
+  // loaded. Serve it under the shared lock so concurrent lookups do not
+  // serialize on each other: holding the lock in any mode is enough to keep
+  // the inode from being unloaded, and acquiring an InodePtr is an atomic
+  // refcount bump.
+  {
+    auto data = data_.rlock();
+    auto loadedIter = data->loadedInodes_.find(number);
+    if (loadedIter != data->loadedInodes_.end()) {
+      auto inode = loadedIter->second.getPtr();
+      stats_->increment(
+          inode->isDir() ? &InodeMapStats::lookupTreeInodeHit
+                         : &InodeMapStats::lookupBlobInodeHit);
+      return inode;
+    }
+
+    // If another thread has already started loading this inode, we only
+    // need to attach a promise to its wait list.  Do that under the shared
+    // lock plus the inode's waiter stripe so that a herd of threads hitting
+    // one cold inode does not serialize on the exclusive lock below.  The
+    // entry cannot be erased while we hold the shared lock, and load
+    // completion takes the exclusive lock, so it cannot miss a promise
+    // attached here.
+    auto unloadedIter = data->unloadedInodes_.find(number);
+    if (unloadedIter != data->unloadedInodes_.end()) {
+      auto& unloadedData = unloadedIter->second;
+      std::lock_guard<std::mutex> guard{getLoadWaiterLock(number)};
+      if (!unloadedData.promises.empty()) {
+        unloadedData.promises.emplace_back();
+        return unloadedData.promises.back().getSemiFuture();
+      }
+      // Nobody is loading this inode yet; fall through and race for the
+      // exclusive lock to become the first loader.
+    }
+  }
+
+  // Lock the data exclusively.
   // We hold it while doing most of our work below, but explicitly unlock it
   // before triggering inode loading or before fulfilling any Promises.
   auto data = data_.wlock();
   std::vector<InodeTraceEvent> startLoadEvents;
 
-  // Check to see if this Inode is already loaded
+  // Check again under the exclusive lock: the inode may have finished
+  // loading between the two acquisitions.
   auto loadedIter = data->loadedInodes_.find(number);
   if (loadedIter != data->loadedInodes_.end()) {
     auto inode = loadedIter->second.getPtr();
@@ -283,6 +386,9 @@ ImmediateFuture<InodePtr> InodeMap::lookupInode(InodeNumber number) {
 
   // Look up the data in the unloadedInodes_ map.
   auto unloadedIter = data->unloadedInodes_.find(number);
+  if (unloadedIter == data->unloadedInodes_.end()) {
+    unloadedIter = hydrateTakeoverInode(data, number);
+  }
   if (UNLIKELY(unloadedIter == data->unloadedInodes_.end())) {
     if (mount_->throwEstaleIfInodeIsMissing()) {
       XLOG(DBG3) << "NFS inode " << number << " stale";
@@ -341,7 +447,7 @@ ImmediateFuture<InodePtr> InodeMap::lookupInode(InodeNumber number) {
       InodePtr firstLoadedParent = loadedIter->second.getPtr();
       PathComponent requiredChildName = unloadedData->name;
       bool isUnlinked = unloadedData->isUnlinked;
-      std::optional<ObjectId> optionalHash = unloadedData->hash;
+      std::optional<ObjectId> optionalHash = unloadedData->getHash();
       auto mode = unloadedData->mode;
       // Unlock data and publish load events before starting the child lookup
       data.unlock();
@@ -361,6 +467,11 @@ ImmediateFuture<InodePtr> InodeMap::lookupInode(InodeNumber number) {
 
     // Look up the parent in unloadedInodes_
     unloadedIter = data->unloadedInodes_.find(unloadedData->parent);
+    if (unloadedIter == data->unloadedInodes_.end()) {
+      // References into unloadedInodes_ remain valid across this insertion;
+      // only iterators may be invalidated by a rehash.
+      unloadedIter = hydrateTakeoverInode(data, unloadedData->parent);
+    }
     if (UNLIKELY(unloadedIter == data->unloadedInodes_.end())) {
       // This shouldn't happen.  We must know about the parent inode number if
       // we knew about the child.
@@ -394,7 +505,7 @@ ImmediateFuture<InodePtr> InodeMap::lookupInode(InodeNumber number) {
         unloadedData->name,
         unloadedData->isUnlinked,
         childInodeNumber,
-        unloadedData->hash,
+        unloadedData->getHash(),
         unloadedData->mode);
 
     if (alreadyLoading) {
@@ -647,9 +758,30 @@ std::optional<RelativePath> InodeMap::getPathForInodeHelper(
                    << "appears to contain non-unlinked child " << inodeNumber;
       }
       return *dir + unloadedIt->second.name;
-    } else {
-      throwSystemErrorExplicit(EINVAL, "unknown inode number ", inodeNumber);
     }
+
+    // We only hold the lock in shared mode here, so we cannot hydrate a
+    // pending takeover record. Answer directly from the serialized data.
+    auto pendingIt = data->pendingTakeoverInodes_.find(inodeNumber);
+    if (pendingIt != data->pendingTakeoverInodes_.cend()) {
+      const auto& entry = pendingIt->second;
+      if (*entry.isUnlinked_ref()) {
+        return std::nullopt;
+      }
+      auto parent = InodeNumber::fromThrift(*entry.parentInode_ref());
+      PathComponentPiece name{*entry.name_ref()};
+      if (parent == kRootNodeId) {
+        return RelativePath(name);
+      }
+      auto dir = getPathForInodeHelper(parent, data);
+      if (!dir) {
+        EDEN_BUG() << "unlinked parent inode " << parent
+                   << "appears to contain non-unlinked child " << inodeNumber;
+      }
+      return *dir + name;
+    }
+
+    throwSystemErrorExplicit(EINVAL, "unknown inode number ", inodeNumber);
   }
 }
 void InodeMap::decFsRefcount(InodeNumber number, uint32_t count) {
@@ -665,6 +797,24 @@ void InodeMap::decFsRefcount(InodeNumber number, uint32_t count) {
   }
 }
 
+void InodeMap::decFsRefcounts(
+    const std::vector<std::pair<InodeNumber, uint32_t>>& entries) {
+  std::vector<InodePtr> inodePtrs;
+  {
+    auto data = data_.wlock();
+    for (const auto& [number, count] : entries) {
+      if (auto inodePtr = decFsRefcountHelper(data, number, count)) {
+        inodePtrs.push_back(std::move(inodePtr));
+      }
+    }
+  }
+  // As in decFsRefcount(), release the lock before decrementing the loaded
+  // inodes' FS reference counts and dropping our pointer references.
+  for (auto& inodePtr : inodePtrs) {
+    inodePtr->decFsRefcount();
+  }
+}
+
 InodePtr InodeMap::decFsRefcountHelper(
     folly::Synchronized<Members>::LockedPtr& data,
     InodeNumber number,
@@ -688,6 +838,10 @@ InodePtr InodeMap::decFsRefcountHelper(
 
   // If it wasn't loaded, it should be in the unloaded map
   auto unloadedIter = data->unloadedInodes_.find(number);
+  if (unloadedIter == data->unloadedInodes_.end()) {
+    // The FS may forget an inode we have only seen as a takeover record.
+    unloadedIter = hydrateTakeoverInode(data, number);
+  }
   if (UNLIKELY(unloadedIter == data->unloadedInodes_.end())) {
     EDEN_BUG() << "InodeMap::decFsRefcount() called on unknown inode number "
                << number;
@@ -744,6 +898,10 @@ void InodeMap::forgetStaleInodes() {
   {
     auto data = data_.wlock();
 
+    // Unlinked inodes may still be sitting in un-hydrated takeover records;
+    // hydrate everything so the scan below sees them.
+    hydrateAllTakeoverInodes(data);
+
     for (auto& inode : data->unloadedInodes_) {
       XLOG(DBG9) << "Considering forgetting unloaded inode " << inode.first;
       if (inode.second.isUnlinked) {
@@ -921,7 +1079,17 @@ Future<SerializedInodeMap> InodeMap::shutdown(
     }
 
     SerializedInodeMap result;
-    result.unloadedInodes_ref()->reserve(data->unloadedInodes_.size());
+    result.unloadedInodes_ref()->reserve(
+        data->unloadedInodes_.size() + data->pendingTakeoverInodes_.size());
+
+    // Takeover records that were never accessed since the last takeover can
+    // be forwarded to the new process as-is, without ever hydrating them.
+    for (auto& [inodeNumber, entry] : data->pendingTakeoverInodes_) {
+      XLOG(DBG5) << "  forwarding un-hydrated takeover record " << inodeNumber;
+      result.unloadedInodes_ref()->emplace_back(std::move(entry));
+    }
+    data->pendingTakeoverInodes_.clear();
+
     for (const auto& [inodeNumber, entry] : data->unloadedInodes_) {
       SerializedInodeMapEntry serializedEntry;
 
@@ -933,8 +1101,8 @@ Future<SerializedInodeMap> InodeMap::shutdown(
       serializedEntry.name() = entry.name.asString();
       serializedEntry.isUnlinked_ref() = entry.isUnlinked;
       serializedEntry.numFsReferences_ref() = entry.numFsReferences;
-      if (entry.hash.has_value()) {
-        serializedEntry.hash_ref() = entry.hash.value().asString();
+      if (auto hash = entry.getHash()) {
+        serializedEntry.hash_ref() = hash->asString();
       }
       // If entry.hash is empty, the inode is materialized.
       serializedEntry.mode_ref() = entry.mode;
@@ -970,13 +1138,16 @@ void InodeMap::shutdownComplete(
 }
 
 bool InodeMap::isInodeRemembered(InodeNumber ino) const {
-  return data_.rlock()->unloadedInodes_.count(ino) > 0;
+  auto members = data_.rlock();
+  return members->unloadedInodes_.count(ino) > 0 ||
+      members->pendingTakeoverInodes_.count(ino) > 0;
 }
 
 bool InodeMap::isInodeLoadedOrRemembered(InodeNumber ino) const {
   auto members = data_.rlock();
   return members->unloadedInodes_.count(ino) > 0 ||
-      members->loadedInodes_.count(ino) > 0;
+      members->loadedInodes_.count(ino) > 0 ||
+      members->pendingTakeoverInodes_.count(ino) > 0;
 }
 
 void InodeMap::onInodeUnreferenced(
@@ -1161,7 +1332,8 @@ optional<InodeMap::UnloadedInode> InodeMap::updateOverlayForUnload(
     for (const auto& pair : treeContents.entries) {
       const auto& childName = pair.first;
       const auto& entry = pair.second;
-      if (data->unloadedInodes_.count(entry.getInodeNumber())) {
+      if (data->unloadedInodes_.count(entry.getInodeNumber()) ||
+          data->pendingTakeoverInodes_.count(entry.getInodeNumber())) {
         XLOG(DBG5) << "remembering inode " << asTree->getNodeId() << " ("
                    << asTree->getLogPath() << ") because its child "
                    << childName << " was remembered";
@@ -1198,6 +1370,11 @@ bool InodeMap::startLoadingChildIfNotLoading(
     auto data = data_.wlock();
     UnloadedInode* unloadedData{nullptr};
     auto iter = data->unloadedInodes_.find(childInode);
+    if (iter == data->unloadedInodes_.end()) {
+      // Prefer hydrating a takeover record over creating a default entry so
+      // the attributes from the previous process are not lost.
+      iter = hydrateTakeoverInode(data, childInode);
+    }
     if (iter == data->unloadedInodes_.end()) {
       InodeNumber parentNumber = parent->getNodeId();
       // T127459236: not all attributes of the UnloadedInode are set here. For
@@ -1250,7 +1427,8 @@ InodeMap::InodeCounts InodeMap::getInodeCounts() const {
       data->numTreeInodes_ + data->numFileInodes_, data->loadedInodes_.size());
   counts.treeCount = data->numTreeInodes_;
   counts.fileCount = data->numFileInodes_;
-  counts.unloadedInodeCount = data->unloadedInodes_.size();
+  counts.unloadedInodeCount =
+      data->unloadedInodes_.size() + data->pendingTakeoverInodes_.size();
   counts.periodicUnlinkedUnloadInodeCount =
       numPeriodicallyUnloadedUnlinkedInodes_.load(std::memory_order_relaxed);
   counts.periodicLinkedUnloadInodeCount =
@@ -1258,6 +1436,42 @@ InodeMap::InodeCounts InodeMap::getInodeCounts() const {
   return counts;
 }
 
+size_t InodeMap::estimateMemoryUsage() const {
+  auto data = data_.rlock();
+  size_t usage = 0;
+
+  /* NOTE: The following code assumes an unordered_map is separated into an
+   * array of buckets, each one being a chain of nodes containing a next
+   * pointer, a key-value pair, and a stored hash
+   */
+  usage +=
+      folly::goodMallocSize(sizeof(void*) * data->loadedInodes_.bucket_count());
+  usage += folly::goodMallocSize(
+               sizeof(void*) + sizeof(size_t) +
+               sizeof(std::pair<const InodeNumber, LoadedInode>)) *
+      data->loadedInodes_.size();
+  usage += folly::goodMallocSize(
+      sizeof(void*) * data->unloadedInodes_.bucket_count());
+  usage += folly::goodMallocSize(
+               sizeof(void*) + sizeof(size_t) +
+               sizeof(std::pair<const InodeNumber, UnloadedInode>)) *
+      data->unloadedInodes_.size();
+
+  // The loaded Inode objects themselves. This does not include memory each
+  // inode owns indirectly, such as a materialized TreeInode's entry map.
+  usage += folly::goodMallocSize(sizeof(TreeInode)) * data->numTreeInodes_;
+  usage += folly::goodMallocSize(sizeof(FileInode)) * data->numFileInodes_;
+
+  // Heap-allocated names of unloaded inodes. Hashes are interned handles;
+  // each distinct hash's bytes live once in the process-wide interner
+  // rather than in every entry.
+  for (const auto& [number, unloaded] : data->unloadedInodes_) {
+    usage += estimateIndirectMemoryUsage(unloaded.name);
+  }
+
+  return usage;
+}
+
 std::vector<InodeNumber> InodeMap::getReferencedInodes() const {
   std::vector<InodeNumber> inodes;
   {
@@ -1274,6 +1488,12 @@ std::vector<InodeNumber> InodeMap::getReferencedInodes() const {
         inodes.push_back(ino);
       }
     }
+
+    for (const auto& [ino, entry] : data->pendingTakeoverInodes_) {
+      if (*entry.numFsReferences_ref() > 0) {
+        inodes.push_back(ino);
+      }
+    }
   }
 
   return inodes;
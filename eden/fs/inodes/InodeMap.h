@@ -9,8 +9,10 @@
 
 #include <folly/Synchronized.h>
 #include <folly/futures/Future.h>
+#include <array>
 #include <list>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <unordered_map>
 
@@ -19,6 +21,7 @@
 #include "eden/fs/inodes/InodePtr.h"
 #include "eden/fs/inodes/Overlay.h"
 #include "eden/fs/model/ObjectId.h"
+#include "eden/fs/model/ObjectIdInterner.h"
 #include "eden/fs/takeover/gen-cpp2/takeover_types.h"
 #include "eden/fs/utils/ImmediateFuture.h"
 #include "eden/fs/utils/PathFuncs.h"
@@ -244,6 +247,18 @@ class InodeMap {
    */
   void decFsRefcount(InodeNumber number, uint32_t count = 1);
 
+  /**
+   * Decrement the FS refcounts of multiple inode numbers in one pass.
+   *
+   * This behaves like calling decFsRefcount() for each entry, but applies
+   * all of the decrements under a single acquisition of the data lock.
+   * FUSE_BATCH_FORGET storms after kernel memory pressure can carry
+   * thousands of entries; taking the lock once per batch keeps them from
+   * stalling concurrent lookups.
+   */
+  void decFsRefcounts(
+      const std::vector<std::pair<InodeNumber, uint32_t>>& entries);
+
   /**
    * See EdenMount::forgetStaleInodes
    */
@@ -411,6 +426,18 @@ class InodeMap {
    */
   InodeCounts getInodeCounts() const;
 
+  /**
+   * Estimate the memory retained by this InodeMap and the loaded Inode
+   * objects it tracks.
+   *
+   * This is a lower bound: it accounts for the map storage, the Inode
+   * objects themselves, and the names of unloaded inodes, but not for
+   * memory owned indirectly by individual inodes, such as a materialized
+   * TreeInode's entry map. Unloaded inode hashes are interned handles
+   * whose bytes live in the process-wide ObjectIdInterner.
+   */
+  size_t estimateMemoryUsage() const;
+
   void recordPeriodicInodeUnload(size_t numInodesToUnload);
   /*
    * Return all referenced inodes (loaded and unloaded inodes whose
@@ -480,13 +507,21 @@ class InodeMap {
     InodeType getInodeType() const;
 
     /**
-     * If the entry is not materialized, this contains the hash
-     * identifying the source control Tree (if this is a directory) or Blob
-     * (if this is a file) that contains the entry contents.
+     * If the entry is not materialized, this contains the interned handle
+     * of the hash identifying the source control Tree (if this is a
+     * directory) or Blob (if this is a file) that contains the entry
+     * contents. Storing the 8-byte handle instead of the ObjectId keeps a
+     * large population of unloaded inodes (e.g. right after takeover) from
+     * duplicating hash bytes; use getHash() to resolve it.
      *
      * If the entry is materialized, this field is not set.
      */
-    std::optional<ObjectId> const hash;
+    std::optional<ObjectIdInterner::Handle> const hash;
+
+    /**
+     * Resolves hash back to the ObjectId this entry was created with.
+     */
+    std::optional<ObjectId> getHash() const;
 
     /**
      * A list of promises waiting on this inode to be loaded.
@@ -494,11 +529,18 @@ class InodeMap {
      * If this list is non-empty then the inode is currently in the process of
      * being loaded.
      *
+     * This list may be accessed while holding the data_ lock exclusively, or
+     * while holding the data_ lock shared plus this inode's stripe of
+     * loadWaiterLocks_.  The latter lets a herd of threads waiting on one
+     * in-progress load attach their promises without serializing on the
+     * exclusive lock.  It is mutable because the shared-lock path only has
+     * const access to the map entry.
+     *
      * (We could use folly::SharedPromise here instead, but it has extra
      * overhead that we don't really need.  It performs its own locking, but we
-     * are already protected by the data_ lock.)
+     * are already protected by the locks above.)
      */
-    PromiseVector promises;
+    mutable PromiseVector promises;
 
     /**
      * Contains the timestamp for when an unloaded inode started loading. If the
@@ -566,6 +608,20 @@ class InodeMap {
      */
     std::unordered_map<InodeNumber, UnloadedInode> unloadedInodes_;
 
+    /**
+     * Takeover inode records that have not yet been hydrated into
+     * unloadedInodes_.
+     *
+     * When experimental:lazy-takeover-inode-hydration is enabled,
+     * initializeFromTakeover() parks the serialized records here instead of
+     * eagerly constructing an UnloadedInode for every remembered inode, and
+     * each record is hydrated the first time the inode is accessed. Records
+     * that are never touched are forwarded as-is on the next takeover. This
+     * map is always empty when the option is off.
+     */
+    std::unordered_map<InodeNumber, SerializedInodeMapEntry>
+        pendingTakeoverInodes_;
+
     /**
      * Indicates if the FS mount point has been unmounted.
      *
@@ -712,6 +768,27 @@ class InodeMap {
       InodeNumber ino,
       Args&&... args);
 
+  /**
+   * Hydrate the pending takeover record for the given inode into
+   * unloadedInodes_, if one exists, and return an iterator to the resulting
+   * entry. Returns unloadedInodes_.end() if the inode has no pending record.
+   *
+   * Must be called with the data_ lock held exclusively.
+   */
+  std::unordered_map<InodeNumber, UnloadedInode>::iterator
+  hydrateTakeoverInode(
+      const folly::Synchronized<Members>::LockedPtr& data,
+      InodeNumber number);
+
+  /**
+   * Hydrate every remaining takeover record. Used by operations that need to
+   * see the complete set of unloaded inodes.
+   *
+   * Must be called with the data_ lock held exclusively.
+   */
+  void hydrateAllTakeoverInodes(
+      const folly::Synchronized<Members>::LockedPtr& data);
+
   /**
    * For unloaded inodes, this decrements the inode fs refcount.
    * For loaded inodes this returns the inode to decrement the FS refcount on
@@ -753,6 +830,24 @@ class InodeMap {
    */
   folly::Synchronized<Members> data_;
 
+  /**
+   * Striped locks protecting UnloadedInode::promises for shared-lock
+   * waiter attachment, selected by inode number.
+   *
+   * When a lookup finds an in-progress load it only needs to append one
+   * promise to that inode's wait list.  Doing so under the shared data_
+   * lock plus the inode's stripe keeps a herd of waiters on a cold inode
+   * from serializing on the exclusive lock.  Exclusive holders of data_
+   * may touch any wait list without the stripe: the shared-lock path
+   * cannot run concurrently with them.
+   */
+  static constexpr size_t kLoadWaiterStripes = 64;
+  mutable std::array<std::mutex, kLoadWaiterStripes> loadWaiterLocks_;
+
+  std::mutex& getLoadWaiterLock(InodeNumber number) const {
+    return loadWaiterLocks_[number.get() % kLoadWaiterStripes];
+  }
+
   /**
    * The number of inodes that we have unloaded with our periodic
    * unlinked inode unloading. Periodic unlinked inode unloading is run after
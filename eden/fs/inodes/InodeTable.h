@@ -10,6 +10,8 @@
 #include "Overlay.h"
 #ifndef _WIN32
 
+#include <folly/hash/SpookyHashV2.h>
+#include <cstddef>
 #include <optional>
 #include "eden/fs/inodes/InodeMetadata.h"
 #include "eden/fs/inodes/InodeNumber.h"
@@ -21,29 +23,92 @@
 namespace facebook::eden {
 
 namespace detail {
+
+/**
+ * The original InodeTableEntry layout, which carried no checksum.
+ * Retained so tables written by older versions of EdenFS are migrated in
+ * place the first time they are opened.
+ */
 template <typename Record>
-struct InodeTableEntry {
+struct LegacyInodeTableEntry {
   enum { VERSION = Record::VERSION };
 
-  explicit InodeTableEntry() = delete;
-  InodeTableEntry(InodeNumber ino, const Record& rec)
+  explicit LegacyInodeTableEntry() = delete;
+  LegacyInodeTableEntry(InodeNumber ino, const Record& rec)
       : inode{ino}, record{rec} {}
 
   /// Conversion from old versions.
-  template <typename OldRecord>
-  explicit InodeTableEntry(const InodeTableEntry<OldRecord>& old)
-      : inode{old.inode}, record{old.record} {}
+  template <typename OldEntry>
+  explicit LegacyInodeTableEntry(const OldEntry& old)
+      : inode{old.inode}, record{Record{old.record}} {}
+
+  InodeNumber inode;
+  Record record;
+};
+
+template <typename Record>
+struct InodeTableEntry {
+  /**
+   * Changes to the entry wrapper itself are versioned in the bits above
+   * the Record's own version number, so that the wrapper can evolve
+   * without renaming every Record type. Record versions must stay below
+   * kEntryFormatBase.
+   */
+  enum { kEntryFormatBase = 0x10000 };
+  enum { VERSION = kEntryFormatBase + Record::VERSION };
+
+  explicit InodeTableEntry() = delete;
+  InodeTableEntry(InodeNumber ino, const Record& rec)
+      : inode{ino}, record{rec} {
+    checksum = computeChecksum();
+  }
+
+  /// Conversion from old record versions and from the checksum-less
+  /// entry layout.
+  template <typename OldEntry>
+  explicit InodeTableEntry(const OldEntry& old)
+      : inode{old.inode}, record{Record{old.record}} {
+    checksum = computeChecksum();
+  }
+
+  /**
+   * Hash of the entry's stored bytes, excluding the checksum field
+   * itself.
+   *
+   * The hash covers the object representation in place, padding
+   * included. That is safe because the checksum is always recomputed
+   * after a record is written into its slot, and whole entries only move
+   * via trivial copies that preserve the full representation.
+   */
+  uint64_t computeChecksum() const {
+    return folly::hash::SpookyHashV2::Hash64(
+        this, offsetof(InodeTableEntry, checksum), kChecksumSeed);
+  }
+
+  void updateChecksum() {
+    checksum = computeChecksum();
+  }
+
+  bool hasValidChecksum() const {
+    return checksum == computeChecksum();
+  }
 
   // WARNING: this data structure is serialized directly to disk via
-  // MappedDiskVector. Do not change the order, set, or types of fields. We
-  // could, if we want to change Entry itself, coopt high bits of VERSION and
-  // modify MappedDiskVector to allow direct upgrades rather than linear
-  // upgrades.
+  // MappedDiskVector. Do not change the order, set, or types of fields.
+  // To change the entry layout, bump kEntryFormatBase and keep the old
+  // layout around for migration, as with LegacyInodeTableEntry.
   InodeNumber inode;
-  // TODO: should we maintain a 64-bit SpookyHashV2 checksum to ignore
-  // corrupted entries?
   Record record;
+  /**
+   * Checksum over the inode number and record, updated on every write.
+   * A mismatch on load means a crash tore the entry mid-write, so the
+   * entry must not be trusted.
+   */
+  uint64_t checksum;
+
+  static constexpr uint64_t kChecksumSeed = 0xb7e151628aed2a6b;
 };
+
 } // namespace detail
 
 /**
@@ -92,14 +157,23 @@ class InodeTable {
 
   /**
    * Create or open an InodeTable at the specified path.
+   *
+   * The table is always prefaulted (MAP_POPULATE) since every record is
+   * traversed immediately after opening.  useHugePages additionally requests
+   * transparent hugepage backing for the mapping on Linux, which reduces TLB
+   * pressure on mounts with large metadata tables.
    */
   template <typename... OldRecords>
   static std::unique_ptr<InodeTable> open(
       folly::StringPiece path,
-      EdenStatsPtr stats) {
+      EdenStatsPtr stats,
+      bool useHugePages = false) {
     return std::unique_ptr<InodeTable>{new InodeTable{
         MappedDiskVector<Entry>::template open<
-            detail::InodeTableEntry<OldRecords>...>(path, true),
+            detail::LegacyInodeTableEntry<Record>,
+            detail::InodeTableEntry<OldRecords>...,
+            detail::LegacyInodeTableEntry<OldRecords>...>(
+            path, true, useHugePages),
         std::move(stats)}};
   }
 
@@ -191,9 +265,10 @@ class InodeTable {
     }
     auto index = iter->second;
     XCHECK_LT(index, state->storage.size());
-    fn(state->storage[index].record);
-    // TODO: maybe trigger a background msync
-    return state->storage[index].record;
+    auto& entry = state->storage[index];
+    fn(entry.record);
+    entry.updateChecksum();
+    return entry.record;
   }
 
   // TODO: replace with freeInodes - it's much more efficient to free a bunch
@@ -239,11 +314,21 @@ class InodeTable {
     for (auto& entry : state->indices) {
       const auto& inode = entry.first;
       auto index = entry.second;
-      auto& record = state->storage[index].record;
-      fn(inode, record);
+      fn(inode, state->storage[index].record);
+      state->storage[index].updateChecksum();
     }
   }
 
+  /**
+   * Schedules asynchronous writeback of the table's dirty pages.  Dirty
+   * records are otherwise flushed at the kernel's discretion, which can leave
+   * a large burst of metadata updates unwritten for a long time; calling this
+   * periodically from maintenance bounds that window without blocking.
+   */
+  void sync() {
+    state_.rlock()->storage.sync();
+  }
+
  private:
   explicit InodeTable(MappedDiskVector<Entry>&& storage, EdenStatsPtr stats)
       : state_{folly::in_place, std::move(storage)}, stats_{std::move(stats)} {}
@@ -280,7 +365,7 @@ class InodeTable {
       auto iter = state->indices.find(ino);
       if (LIKELY(iter != state->indices.end())) {
         auto index = iter->second;
-        return modify(state->storage[index].record);
+        return modifyAndUpdateChecksum<T>(state->storage[index], modify);
       }
     }
 
@@ -293,7 +378,7 @@ class InodeTable {
     auto iter = state->indices.find(ino);
     if (UNLIKELY(iter != state->indices.end())) {
       auto index = iter->second;
-      return modify(state->storage[index].record);
+      return modifyAndUpdateChecksum<T>(state->storage[index], modify);
     }
 
     size_t index = state->storage.size();
@@ -302,6 +387,23 @@ class InodeTable {
     return result(state->storage[index].record);
   }
 
+  /**
+   * Runs a modification callback against an entry's record and refreshes
+   * the entry's checksum afterwards, so readers after a crash never see a
+   * record without a matching checksum for longer than the write itself.
+   */
+  template <typename T, typename ModifyFn>
+  static T modifyAndUpdateChecksum(Entry& entry, ModifyFn&& modify) {
+    if constexpr (std::is_void_v<T>) {
+      modify(entry.record);
+      entry.updateChecksum();
+    } else {
+      T result = modify(entry.record);
+      entry.updateChecksum();
+      return result;
+    }
+  }
+
   struct State {
     State(MappedDiskVector<Entry>&& mdv) : storage{std::move(mdv)} {
       for (size_t i = 0; i < storage.size(); ++i) {
@@ -311,6 +413,15 @@ class InodeTable {
           // zeroes. Don't pretend this entry is valid.
           continue;
         }
+        if (!entry.hasValidChecksum()) {
+          // Some of the entry's bytes made it to disk but not all of
+          // them - a crash can tear an entry across page boundaries.
+          // Drop it rather than trust stale or mixed metadata.
+          XLOG_FIRST_N(WARNING, 100)
+              << "Discarding torn record for inode " << entry.inode
+              << ": checksum mismatch";
+          continue;
+        }
         auto ret = indices.insert({entry.inode, i});
         if (!ret.second) {
           XLOG_FIRST_N(WARNING, 100)
@@ -344,6 +455,10 @@ static_assert(
     CheckSize<InodeMetadata, 40>(),
     "Don't change InodeMetadata without implementing a migration path");
 
+static_assert(
+    CheckSize<detail::InodeTableEntry<InodeMetadata>, 56>(),
+    "Don't change InodeTableEntry without implementing a migration path");
+
 using InodeMetadataTable = InodeTable<InodeMetadata>;
 
 } // namespace facebook::eden
@@ -13,7 +13,9 @@
 #include "eden/fs/inodes/InodeBase.h"
 #include "eden/fs/inodes/InodeMap.h"
 #include "eden/fs/inodes/TreeInode.h"
+#include "eden/fs/inodes/VirtualInode.h"
 #include "eden/fs/nfs/NfsUtils.h"
+#include "eden/fs/store/ObjectStore.h"
 #include "eden/fs/telemetry/EdenStats.h"
 #include "eden/fs/utils/NotImplemented.h"
 #include "eden/fs/utils/String.h"
@@ -45,6 +47,14 @@ NfsDispatcherImpl::NfsDispatcherImpl(EdenMount* mount)
 ImmediateFuture<struct stat> NfsDispatcherImpl::getattr(
     InodeNumber ino,
     const ObjectFetchContextPtr& context) {
+  // GETATTR dominates NFS traffic and almost always asks about an inode that
+  // is already loaded with its metadata in memory. Consulting the loaded
+  // inode table synchronously answers those requests entirely on the RPC
+  // handler thread, without allocating a continuation or copying the fetch
+  // context for the general loading path below.
+  if (auto inode = inodeMap_->lookupLoadedInode(ino)) {
+    return statHelper(inode, context);
+  }
   return inodeMap_->lookupInode(ino).thenValue(
       [context = context.copy()](const InodePtr& inode) {
         return statHelper(inode, context);
@@ -146,6 +156,28 @@ ImmediateFuture<NfsDispatcher::WriteRes> NfsDispatcherImpl::write(
       });
 }
 
+ImmediateFuture<NfsDispatcher::CommitRes> NfsDispatcherImpl::commit(
+    InodeNumber ino,
+    bool datasync,
+    const ObjectFetchContextPtr& context) {
+  return inodeMap_->lookupFileInode(ino).thenValue(
+      [datasync, context = context.copy()](const FileInodePtr& inode) {
+        // TODO(xavierd): Modify fsync to obtain pre and post stat of the
+        // file.
+#ifndef _WIN32
+        inode->fsync(datasync);
+#else
+        // FileInode::fsync does not exist on Windows, where EdenFS serves
+        // no NFS mounts anyway; skip the flush and just return the
+        // post-operation stat.
+        (void)datasync;
+#endif
+        return inode->stat(context).thenValue([](const struct stat& stat) {
+          return CommitRes{std::nullopt, stat};
+        });
+      });
+}
+
 ImmediateFuture<NfsDispatcher::CreateRes> NfsDispatcherImpl::create(
     InodeNumber dir,
     PathComponent name,
@@ -333,39 +365,137 @@ ImmediateFuture<NfsDispatcher::ReaddirRes> NfsDispatcherImpl::readdirplus(
     uint32_t count,
     const ObjectFetchContextPtr& context) {
 #ifndef _WIN32
+  bool avoidInodeLoads =
+      mount_->getEdenConfig()->readdirplusAvoidInodeLoads.getValue();
   return inodeMap_->lookupTreeInode(dir).thenValue(
-      [context = context.copy(), offset, count, this](
+      [context = context.copy(), offset, count, avoidInodeLoads, this](
           const TreeInodePtr& inode) {
         auto [dirList, isEof] = inode->nfsReaddir(
             NfsDirList{count, nfsv3Procs::readdirplus}, offset, context);
-        auto& dirListRef = dirList.getListRef();
-        std::vector<ImmediateFuture<folly::Unit>> futuresVec{};
-        for (auto& entry : dirListRef) {
-          if (entry.name == "." || entry.name == "..") {
-            futuresVec.push_back(
-                this->getattr(InodeNumber{entry.fileid}, context)
-                    .thenTry([&entry](folly::Try<struct stat> st) {
-                      entry.name_attributes = statToPostOpAttr(st);
-                      return folly::unit;
-                    }));
-          } else {
-            futuresVec.push_back(
-                inode->getOrLoadChild(PathComponent{entry.name}, context)
-                    .thenValue(
-                        [entry, context = context.copy()](InodePtr&& inodep) {
-                          return statHelper(inodep, context);
-                        })
-                    .thenTry([&entry](folly::Try<struct stat> st) {
-                      entry.name_attributes = statToPostOpAttr(st);
-                      return folly::unit;
-                    }));
+
+        // When nfs:readdirplus-avoid-inode-loads is set, resolve all of the
+        // directory's children in one pass without loading inodes: clean
+        // unloaded children are statted from their source control entry and
+        // blob metadata instead of instantiating an inode apiece. Loaded and
+        // materialized children still go through their inode.
+        //
+        // The whole page is resolved with one tree read (getChildren) and
+        // one batched metadata fetch for every blob-backed child, so the
+        // per-entry stats below are served from memory rather than each
+        // paying its own backing store round trip.
+        ImmediateFuture<PathMap<VirtualInode>> childrenFuture{
+            PathMap<VirtualInode>{
+                mount_->getCheckoutConfig()->getCaseSensitive()}};
+        if (avoidInodeLoads) {
+          std::vector<PathComponent> names;
+          std::vector<ImmediateFuture<VirtualInode>> childFutures;
+          for (auto& child :
+               inode->getChildren(context, /*loadInodes=*/false)) {
+            names.push_back(std::move(child.first));
+            childFutures.push_back(std::move(child.second));
           }
+          childrenFuture =
+              collectAllSafe(std::move(childFutures))
+                  .thenValue([this,
+                              context = context.copy(),
+                              names = std::move(names)](
+                                 std::vector<VirtualInode>&& resolved) mutable {
+                    auto blobIds = std::make_shared<std::vector<ObjectId>>();
+                    for (const auto& child : resolved) {
+                      if (!child.isDirectory()) {
+                        if (auto id = child.getObjectId()) {
+                          blobIds->push_back(std::move(id).value());
+                        }
+                      }
+                    }
+
+                    PathMap<VirtualInode> children{
+                        mount_->getCheckoutConfig()->getCaseSensitive()};
+                    for (size_t i = 0; i < names.size(); i++) {
+                      children.emplace(
+                          std::move(names[i]), std::move(resolved[i]));
+                    }
+
+                    return mount_->getObjectStore()
+                        ->getBlobMetadatas(
+                            ObjectIdRange{blobIds->data(), blobIds->size()},
+                            context)
+                        .thenTry([blobIds, children = std::move(children)](
+                                     auto&&) mutable {
+                          // Warming the metadata cache is best effort; any
+                          // error will be reported by the per-entry stat
+                          // below.
+                          return std::move(children);
+                        });
+                  });
         }
-        auto res = collectAllSafe(std::move(futuresVec));
-        return std::move(res).thenValue(
-            [dirList = std::move(dirList),
-             isEof = isEof](std::vector<folly::Unit>&&) mutable {
-              return ReaddirRes{std::move(dirList), isEof};
+
+        return std::move(childrenFuture)
+            .thenValue([this,
+                        context = context.copy(),
+                        inode,
+                        dirList = std::move(dirList),
+                        isEof = isEof](PathMap<VirtualInode>&& children) mutable {
+              auto& dirListRef = dirList.getListRef();
+              std::vector<ImmediateFuture<folly::Unit>> futuresVec{};
+              for (auto& entry : dirListRef) {
+                if (entry.name == "." || entry.name == "..") {
+                  futuresVec.push_back(
+                      this->getattr(InodeNumber{entry.fileid}, context)
+                          .thenTry([&entry](folly::Try<struct stat> st) {
+                            entry.name_attributes = statToPostOpAttr(st);
+                            return folly::unit;
+                          }));
+                  continue;
+                }
+
+                auto childIter = children.find(PathComponentPiece{entry.name});
+                if (childIter != children.end()) {
+                  futuresVec.push_back(
+                      childIter->second
+                          .stat(
+                              mount_->getLastCheckoutTime().toTimespec(),
+                              mount_->getObjectStore(),
+                              context)
+                          .thenTry([this, &entry](folly::Try<struct stat> st) {
+                            if (st.hasValue() && st->st_ino == 0) {
+                              // The attributes came from the source control
+                              // entry rather than an inode; fill in the
+                              // identity fields an inode stat would have
+                              // provided.
+                              auto defaults = mount_->initStatData();
+                              st->st_ino = entry.fileid;
+                              st->st_uid = defaults.st_uid;
+                              st->st_gid = defaults.st_gid;
+                              st->st_blksize = defaults.st_blksize;
+                              st->st_nlink = S_ISDIR(st->st_mode) ? 2 : 1;
+                              st->st_blocks = (st->st_size + 511) / 512;
+                            }
+                            entry.name_attributes = statToPostOpAttr(st);
+                            return folly::unit;
+                          }));
+                } else {
+                  // Either inode loads were not avoided, or the directory
+                  // changed between the readdir snapshot and the children
+                  // lookup; fall back to loading the child.
+                  futuresVec.push_back(
+                      inode->getOrLoadChild(PathComponent{entry.name}, context)
+                          .thenValue([entry, context = context.copy()](
+                                         InodePtr&& inodep) {
+                            return statHelper(inodep, context);
+                          })
+                          .thenTry([&entry](folly::Try<struct stat> st) {
+                            entry.name_attributes = statToPostOpAttr(st);
+                            return folly::unit;
+                          }));
+                }
+              }
+              auto res = collectAllSafe(std::move(futuresVec));
+              return std::move(res).thenValue(
+                  [dirList = std::move(dirList),
+                   isEof = isEof](std::vector<folly::Unit>&&) mutable {
+                    return ReaddirRes{std::move(dirList), isEof};
+                  });
             });
       });
 #else
@@ -51,6 +51,11 @@ class NfsDispatcherImpl : public NfsDispatcher {
       FileOffset offset,
       const ObjectFetchContextPtr& context) override;
 
+  ImmediateFuture<NfsDispatcher::CommitRes> commit(
+      InodeNumber ino,
+      bool datasync,
+      const ObjectFetchContextPtr& context) override;
+
   ImmediateFuture<NfsDispatcher::CreateRes> create(
       InodeNumber ino,
       PathComponent name,
@@ -13,6 +13,7 @@
 #include <folly/Exception.h>
 #include <folly/File.h>
 #include <folly/FileUtil.h>
+#include <folly/Likely.h>
 #include <folly/Range.h>
 #include <folly/io/Cursor.h>
 #include <folly/io/IOBuf.h>
@@ -40,6 +41,14 @@ namespace {
 constexpr uint64_t ioCountMask = 0x7FFFFFFFFFFFFFFFull;
 constexpr uint64_t ioClosedMask = 1ull << 63;
 
+/**
+ * How far ahead of the current allocation the inode number checkpoint is
+ * persisted.  A larger window means fewer checkpoint writes but a bigger gap
+ * in the inode number space after a crash; the space is 64 bits wide, so the
+ * gap is harmless.
+ */
+constexpr uint64_t kInodeNumberCheckpointInterval = 1'000'000;
+
 std::unique_ptr<InodeCatalog> makeInodeCatalog(
     AbsolutePathPiece localDir,
     InodeCatalogType inodeCatalogType,
@@ -105,12 +114,15 @@ std::unique_ptr<InodeCatalog> makeInodeCatalog(
 }
 
 std::unique_ptr<FileContentStore> makeFileContentStore(
-    AbsolutePathPiece localDir) {
+    AbsolutePathPiece localDir,
+    const EdenConfig& config) {
 #ifdef _WIN32
   (void)localDir;
+  (void)config;
   return nullptr;
 #else
-  return std::make_unique<FsFileContentStore>(localDir);
+  return std::make_unique<FsFileContentStore>(
+      localDir, config.overlayDirectFileCreation.getValue());
 #endif
 }
 } // namespace
@@ -168,7 +180,7 @@ Overlay::Overlay(
     EdenStatsPtr stats,
     bool windowsSymlinksEnabled,
     const EdenConfig& config)
-    : fileContentStore_{makeFileContentStore(localDir)},
+    : fileContentStore_{makeFileContentStore(localDir, config)},
       inodeCatalog_{makeInodeCatalog(
           localDir,
           inodeCatalogType,
@@ -300,38 +312,72 @@ void Overlay::initOverlay(
     // data in some of the on-disk state.
     //
     // Use OverlayChecker to scan the overlay for any issues, and also compute
-    // correct next inode number as it does so.
-    XLOG(WARN) << "Overlay " << localDir_
-               << " was not shut down cleanly.  Performing fsck scan.";
-
-    // TODO(zeyi): `OverlayCheck` should be associated with the specific
-    // Overlay implementation.
-    //
-    // Note: lookupCallback is a reference but is stored on OverlayChecker.
-    // Therefore OverlayChecker must not exist longer than this initOverlay
-    // call.
-    OverlayChecker checker(
-        inodeCatalog_.get(),
-        static_cast<FsFileContentStore*>(fileContentStore_.get()),
-        std::nullopt,
-        lookupCallback);
-    folly::stop_watch<> fsckRuntime;
-    checker.scanForErrors(progressCallback);
-    auto result = checker.repairErrors();
-    auto fsckRuntimeInSeconds =
-        std::chrono::duration<double>{fsckRuntime.elapsed()}.count();
-    if (result) {
-      // If totalErrors - fixedErrors is nonzero, then we failed to
-      // fix all of the problems.
-      auto success = !(result->totalErrors - result->fixedErrors);
-      structuredLogger_->logEvent(
-          Fsck{fsckRuntimeInSeconds, success, true /*attempted_repair*/});
-    } else {
-      structuredLogger_->logEvent(Fsck{
-          fsckRuntimeInSeconds, true /*success*/, false /*attempted_repair*/});
+    // the correct next inode number as it does so.  With an inode number
+    // checkpoint or fsck:open-dirty, skip the scan and just compute the next
+    // inode number.
+    if (config->overlayInodeNumberCheckpointing.getValue() &&
+        inodeCatalogType_ == InodeCatalogType::Legacy) {
+      optNextInodeNumber =
+          static_cast<FsFileContentStore*>(fileContentStore_.get())
+              ->tryLoadInodeNumberCheckpoint();
     }
+    if (optNextInodeNumber.has_value()) {
+      // The checkpoint is persisted before any inode number below its value
+      // is handed out, so it remains a trustworthy upper bound after a
+      // crash.  Validation of individual entries is deferred to first
+      // access, as with fsck:open-dirty.
+      XLOG(WARN) << "Overlay " << localDir_
+                 << " was not shut down cleanly.  Resuming from the inode "
+                    "number checkpoint without a full fsck scan.";
+    } else if (config->fsckOpenDirty.getValue()) {
+      // Open immediately and defer validation to first access.  The next
+      // inode number only requires the shard entry names, which is far
+      // cheaper than the full content scan below.
+      XLOG(WARN) << "Overlay " << localDir_
+                 << " was not shut down cleanly.  fsck:open-dirty is set, so "
+                    "the full consistency scan is being skipped.";
+      folly::stop_watch<> scanRuntime;
+      optNextInodeNumber =
+          static_cast<FsFileContentStore*>(fileContentStore_.get())
+              ->scanForNextInodeNumber();
+      auto scanRuntimeInSeconds =
+          std::chrono::duration<double>{scanRuntime.elapsed()}.count();
+      structuredLogger_->logEvent(Fsck{
+          scanRuntimeInSeconds, true /*success*/, false /*attempted_repair*/});
+    } else {
+      XLOG(WARN) << "Overlay " << localDir_
+                 << " was not shut down cleanly.  Performing fsck scan.";
+
+      // TODO(zeyi): `OverlayCheck` should be associated with the specific
+      // Overlay implementation.
+      //
+      // Note: lookupCallback is a reference but is stored on OverlayChecker.
+      // Therefore OverlayChecker must not exist longer than this initOverlay
+      // call.
+      OverlayChecker checker(
+          inodeCatalog_.get(),
+          static_cast<FsFileContentStore*>(fileContentStore_.get()),
+          std::nullopt,
+          lookupCallback,
+          config->fsckNumScanThreads.getValue());
+      folly::stop_watch<> fsckRuntime;
+      checker.scanForErrors(progressCallback);
+      auto result = checker.repairErrors(progressCallback);
+      auto fsckRuntimeInSeconds =
+          std::chrono::duration<double>{fsckRuntime.elapsed()}.count();
+      if (result) {
+        // If totalErrors - fixedErrors is nonzero, then we failed to
+        // fix all of the problems.
+        auto success = !(result->totalErrors - result->fixedErrors);
+        structuredLogger_->logEvent(
+            Fsck{fsckRuntimeInSeconds, success, true /*attempted_repair*/});
+      } else {
+        structuredLogger_->logEvent(Fsck{
+            fsckRuntimeInSeconds, true /*success*/, false /*attempted_repair*/});
+      }
 
-    optNextInodeNumber = checker.getNextInodeNumber();
+      optNextInodeNumber = checker.getNextInodeNumber();
+    }
 #else
     // SqliteInodeCatalog will always return the value of next Inode number, if
     // we end up here - it's a bug.
@@ -341,6 +387,15 @@ void Overlay::initOverlay(
     hadCleanStartup_ = true;
   }
 
+#ifndef _WIN32
+  // Read these before config is potentially moved below.
+  const bool metadataTableHugePages =
+      config->overlayInodeMetadataTableHugePages.getValue();
+  inodeNumberCheckpointingEnabled_ =
+      config->overlayInodeNumberCheckpointing.getValue() &&
+      inodeCatalogType_ == InodeCatalogType::Legacy;
+#endif
+
   // On Windows, we need to scan the state of the repository every time at
   // start up to find any potential changes happened when EdenFS is not
   // running.
@@ -365,11 +420,16 @@ void Overlay::initOverlay(
   inodeMetadataTable_ = InodeMetadataTable::open(
       (localDir_ + PathComponentPiece{FsFileContentStore::kMetadataFile})
           .c_str(),
-      stats_.copy());
+      stats_.copy(),
+      metadataTableHugePages);
 #endif // !_WIN32
 }
 
 InodeNumber Overlay::allocateInodeNumber() {
+  return allocateInodeNumberRange(1);
+}
+
+InodeNumber Overlay::allocateInodeNumberRange(uint64_t count) {
   // InodeNumber should generally be 64-bits wide, in which case it isn't even
   // worth bothering to handle the case where nextInodeNumber_ wraps.  We don't
   // need to bother checking for conflicts with existing inode numbers since
@@ -380,12 +440,35 @@ InodeNumber Overlay::allocateInodeNumber() {
       "expected nextInodeNumber_ and InodeNumber to have the same size");
   static_assert(
       sizeof(InodeNumber) >= 8, "expected InodeNumber to be at least 64 bits");
+  XDCHECK_NE(0u, count);
 
   // This could be a relaxed atomic operation.  It doesn't matter on x86 but
   // might on ARM.
-  auto previous = nextInodeNumber_++;
-  XDCHECK_NE(0u, previous) << "allocateInodeNumber called before initialize";
-  return InodeNumber{previous};
+  auto first = nextInodeNumber_.fetch_add(count);
+  XDCHECK_NE(0u, first) << "allocateInodeNumber called before initialize";
+  auto last = first + count - 1;
+  if (UNLIKELY(
+          inodeNumberCheckpointingEnabled_ &&
+          last >= inodeNumberCheckpoint_.load(std::memory_order_acquire))) {
+    extendInodeNumberCheckpoint(last);
+  }
+  return InodeNumber{first};
+}
+
+void Overlay::extendInodeNumberCheckpoint(FOLLY_MAYBE_UNUSED uint64_t allocated) {
+#ifndef _WIN32
+  std::lock_guard<std::mutex> guard{inodeNumberCheckpointMutex_};
+  if (allocated < inodeNumberCheckpoint_.load(std::memory_order_relaxed)) {
+    // Another thread already extended the checkpoint past this allocation.
+    return;
+  }
+  auto newBound = allocated + kInodeNumberCheckpointInterval;
+  static_cast<FsFileContentStore*>(fileContentStore_.get())
+      ->saveInodeNumberCheckpoint(InodeNumber{newBound});
+  // Publish only after the new bound is durable; allocations at or above the
+  // old bound wait on the mutex until then.
+  inodeNumberCheckpoint_.store(newBound, std::memory_order_release);
+#endif
 }
 
 DirContents Overlay::loadOverlayDir(InodeNumber inodeNumber) {
@@ -402,6 +485,27 @@ DirContents Overlay::loadOverlayDir(InodeNumber inodeNumber) {
 
   bool shouldRewriteOverlay = false;
 
+  // Legacy overlay directories can contain entries that were never assigned
+  // an inode number. Count them up front so the whole directory's worth can
+  // be allocated with a single atomic operation below.
+  uint64_t unnumberedEntries = 0;
+  for (auto& iter : *dir.entries_ref()) {
+    if (filterAppleDouble_ && string_view{iter.first}.starts_with("._")) {
+      continue;
+    }
+    if (!*iter.second.inodeNumber_ref()) {
+      ++unnumberedEntries;
+    }
+  }
+  InodeNumber nextAllocated;
+  if (unnumberedEntries != 0) {
+    nextAllocated = allocateInodeNumberRange(unnumberedEntries);
+  }
+
+  // Reserve the exact entry count up front; like the DirContents built from
+  // source control trees, this map stays resident while the inode is loaded,
+  // so we don't want to hold on to incremental growth slack.
+  result.reserve(dir.entries_ref()->size());
   for (auto& iter : *dir.entries_ref()) {
     const auto& name = iter.first;
     const auto& value = iter.second;
@@ -418,7 +522,8 @@ DirContents Overlay::loadOverlayDir(InodeNumber inodeNumber) {
     if (*value.inodeNumber_ref()) {
       ino = InodeNumber::fromThrift(*value.inodeNumber_ref());
     } else {
-      ino = allocateInodeNumber();
+      ino = nextAllocated;
+      nextAllocated = InodeNumber{nextAllocated.get() + 1};
       shouldRewriteOverlay = true;
     }
 
@@ -691,6 +796,19 @@ void Overlay::handleGCRequest(GCRequest& request) {
   if (std::holds_alternative<GCRequest::MaintenanceRequest>(
           request.requestType)) {
     inodeCatalog_->maintenance();
+#ifndef _WIN32
+    // Kick off asynchronous writeback of dirty inode metadata pages so a
+    // burst of metadata updates doesn't sit unwritten until shutdown.
+    if (inodeMetadataTable_) {
+      inodeMetadataTable_->sync();
+    }
+#endif
+    return;
+  }
+
+  if (auto* sizeCheck =
+          std::get_if<GCRequest::SizeCheckRequest>(&request.requestType)) {
+    handleSizeCheckRequest(*sizeCheck);
     return;
   }
 
@@ -703,12 +821,15 @@ void Overlay::handleGCRequest(GCRequest& request) {
   // Should only include inode numbers for trees.
   std::queue<InodeNumber> queue;
 
+  DurationScope statScope{stats_, &OverlayStats::gcTreeCollection};
+
   // TODO: For better throughput on large tree collections, it might make
   // sense to split this into two threads: one for traversing the tree and
   // another that makes the actual unlink calls.
   auto safeRemoveOverlayFile = [&](InodeNumber inodeNumber) {
     try {
       removeOverlayFile(inodeNumber);
+      stats_->increment(&OverlayStats::gcInodesReclaimed);
     } catch (const std::exception& e) {
       XLOG(ERR) << "Failed to remove overlay data for file inode "
                 << inodeNumber << ": " << e.what();
@@ -752,6 +873,7 @@ void Overlay::handleGCRequest(GCRequest& request) {
         continue;
       } else {
         dir = std::move(*dirData);
+        stats_->increment(&OverlayStats::gcInodesReclaimed);
       }
     } catch (const std::exception& e) {
       XLOG(ERR) << "While collecting, failed to load tree data for inode "
@@ -811,7 +933,78 @@ void Overlay::renameChild(
   }
 }
 
+void Overlay::handleSizeCheckRequest(
+    const GCRequest::SizeCheckRequest& request) {
+  // Walk the overlay directory and sum the sizes of its regular files.  This
+  // covers both materialized file contents and the inode catalog's own
+  // storage.  Enumeration errors are tolerated: files are created and
+  // removed concurrently with this walk, so the result is inherently an
+  // approximation.
+  uint64_t totalSize = 0;
+  boost::system::error_code error;
+  auto iterator = boost::filesystem::recursive_directory_iterator(
+      boost::filesystem::path{localDir_.value().c_str()}, error);
+  if (error.value() != 0) {
+    XLOG(WARN) << "error walking overlay " << localDir_
+               << " for size check: " << error.message();
+    return;
+  }
+  auto endIterator = boost::filesystem::recursive_directory_iterator();
+  while (iterator != endIterator) {
+    const auto& dirEntry = *iterator;
+    auto status = dirEntry.symlink_status(error);
+    if (error.value() == 0 &&
+        status.type() == boost::filesystem::regular_file) {
+      auto size = boost::filesystem::file_size(dirEntry.path(), error);
+      if (error.value() == 0) {
+        totalSize += size;
+      }
+    }
+    iterator.increment(error);
+    if (error.value() != 0) {
+      XLOG(WARN) << "error walking overlay " << localDir_
+                 << " for size check: " << error.message();
+      break;
+    }
+  }
+
+  dataSize_.store(totalSize, std::memory_order_relaxed);
+
+  if (request.softLimit != 0) {
+    bool overSoft = totalSize > request.softLimit;
+    if (overSoft && !overSoftSizeLimit_) {
+      XLOG(WARN) << "overlay " << localDir_ << " has grown to " << totalSize
+                 << " bytes, over the soft size limit of " << request.softLimit;
+    } else if (!overSoft && overSoftSizeLimit_) {
+      XLOG(INFO) << "overlay " << localDir_ << " shrank to " << totalSize
+                 << " bytes, back under the soft size limit of "
+                 << request.softLimit;
+    }
+    overSoftSizeLimit_ = overSoft;
+  } else {
+    overSoftSizeLimit_ = false;
+  }
+
+  bool overHard = request.hardLimit != 0 && totalSize > request.hardLimit;
+  if (overHard && !overHardSizeLimit_.load(std::memory_order_relaxed)) {
+    XLOG(ERR) << "overlay " << localDir_ << " has grown to " << totalSize
+              << " bytes, over the hard size limit of " << request.hardLimit
+              << "; failing writes that grow overlay files until it shrinks";
+  } else if (!overHard && overHardSizeLimit_.load(std::memory_order_relaxed)) {
+    XLOG(INFO) << "overlay " << localDir_ << " shrank to " << totalSize
+               << " bytes, back under the hard size limit of "
+               << request.hardLimit << "; allowing writes again";
+  }
+  overHardSizeLimit_.store(overHard, std::memory_order_relaxed);
+}
+
 void Overlay::maintenance() {
   gcQueue_.lock()->queue.emplace_back(Overlay::GCRequest::MaintenanceRequest{});
 }
+
+void Overlay::checkOverlaySize(uint64_t softLimit, uint64_t hardLimit) {
+  gcQueue_.lock()->queue.emplace_back(
+      Overlay::GCRequest::SizeCheckRequest{softLimit, hardLimit});
+  gcCondVar_.notify_one();
+}
 } // namespace facebook::eden
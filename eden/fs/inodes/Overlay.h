@@ -14,6 +14,7 @@
 #include <array>
 #include <atomic>
 #include <condition_variable>
+#include <mutex>
 #include <optional>
 #include <thread>
 #include "eden/fs/config/InodeCatalogOptions.h"
@@ -169,11 +170,20 @@ class Overlay : public std::enable_shared_from_this<Overlay> {
    *   TreeInode::create() or TreeInode::mkdir().  In this case
    *   inodeCreated() should be called immediately afterwards to register the
    *   new child Inode object.
-   *
-   * TODO: It would be easy to extend this function to allocate a range of
-   * inode values in one atomic operation.
    */
   InodeNumber allocateInodeNumber();
+
+  /**
+   * Allocate `count` consecutive inode numbers with a single atomic
+   * operation, returning the first. Callers populating a whole directory's
+   * entries (the first-time load of a source control tree) use this to pay
+   * the allocation and checkpoint-tracking overhead once per directory
+   * rather than once per entry.
+   *
+   * The same rules as allocateInodeNumber() apply to every number in the
+   * returned range. count must be nonzero.
+   */
+  InodeNumber allocateInodeNumberRange(uint64_t count);
 #ifndef _WIN32
 
   /**
@@ -280,6 +290,34 @@ class Overlay : public std::enable_shared_from_this<Overlay> {
    */
   void maintenance();
 
+  /**
+   * Asynchronously re-measure the amount of data stored in the overlay
+   * directory and compare it against the given limits.  The measurement runs
+   * on the background GC thread; crossing the soft limit logs a warning and
+   * crossing the hard limit makes isOverHardSizeLimit() return true until a
+   * later measurement falls back under the limit.  A limit of 0 disables the
+   * corresponding check.  This method is called periodically by an EdenServer
+   * task.
+   */
+  void checkOverlaySize(uint64_t softLimit, uint64_t hardLimit);
+
+  /**
+   * Returns the on-disk size of the overlay, in bytes, as of the most recent
+   * checkOverlaySize() measurement.  Returns 0 if no measurement has run yet.
+   */
+  uint64_t getDataSize() const {
+    return dataSize_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * Whether the most recent checkOverlaySize() measurement found the overlay
+   * over its hard size limit.  Write paths that grow overlay files consult
+   * this and fail with ENOSPC while it is set.
+   */
+  bool isOverHardSizeLimit() const {
+    return overHardSizeLimit_.load(std::memory_order_relaxed);
+  }
+
   /*
    * Returns a raw pointer to the inode catalog. This method should only be
    * used for testing.
@@ -327,7 +365,17 @@ class Overlay : public std::enable_shared_from_this<Overlay> {
     struct MaintenanceRequest {};
     explicit GCRequest(MaintenanceRequest req) : requestType{std::move(req)} {}
 
-    std::variant<MaintenanceRequest, overlay::OverlayDir, FlushRequest>
+    struct SizeCheckRequest {
+      uint64_t softLimit;
+      uint64_t hardLimit;
+    };
+    explicit GCRequest(SizeCheckRequest req) : requestType{req} {}
+
+    std::variant<
+        MaintenanceRequest,
+        SizeCheckRequest,
+        overlay::OverlayDir,
+        FlushRequest>
         requestType;
   };
 
@@ -343,6 +391,14 @@ class Overlay : public std::enable_shared_from_this<Overlay> {
       InodeCatalog::LookupCallback& lookupCallback);
   void gcThread() noexcept;
   void handleGCRequest(GCRequest& request);
+  void handleSizeCheckRequest(const GCRequest::SizeCheckRequest& request);
+
+  /**
+   * Persist a new inode number checkpoint covering `allocated` plus a window
+   * of future allocations.  Called from allocateInodeNumber() when an
+   * allocation reaches the previously persisted bound.
+   */
+  void extendInodeNumberCheckpoint(uint64_t allocated);
 
   // Serialize EdenFS overlay data structure into Thrift data structure
   overlay::OverlayEntry serializeOverlayEntry(const DirEntry& entry);
@@ -361,6 +417,26 @@ class Overlay : public std::enable_shared_from_this<Overlay> {
    */
   std::atomic<uint64_t> nextInodeNumber_{0};
 
+  /**
+   * When overlay:inode-number-checkpointing is enabled, an upper bound on
+   * the allocated inode numbers that has been persisted to the overlay.
+   * The bound is extended (and made durable) before any inode number at or
+   * above it is returned from allocateInodeNumber().
+   */
+  std::atomic<uint64_t> inodeNumberCheckpoint_{0};
+
+  /**
+   * Serializes extensions of the persisted inode number checkpoint.
+   */
+  std::mutex inodeNumberCheckpointMutex_;
+
+  /**
+   * Whether allocateInodeNumber() maintains the persisted inode number
+   * checkpoint.  Set during initOverlay(); only supported by the Legacy
+   * inode catalog.
+   */
+  bool inodeNumberCheckpointingEnabled_{false};
+
   std::unique_ptr<FileContentStore> fileContentStore_;
   std::unique_ptr<InodeCatalog> inodeCatalog_;
   InodeCatalogType inodeCatalogType_;
@@ -400,6 +476,20 @@ class Overlay : public std::enable_shared_from_this<Overlay> {
   folly::Synchronized<GCQueue, std::mutex> gcQueue_;
   std::condition_variable gcCondVar_;
 
+  /**
+   * On-disk size of the overlay directory as of the most recent size check,
+   * and whether that check found the overlay over its hard limit.  Both are
+   * written only by the GC thread.
+   */
+  std::atomic<uint64_t> dataSize_{0};
+  std::atomic<bool> overHardSizeLimit_{false};
+
+  /**
+   * Whether the previous size check was over the soft limit.  Only accessed
+   * from the GC thread; used to log on transitions rather than every check.
+   */
+  bool overSoftSizeLimit_{false};
+
   /**
    * This uint64_t holds two values, a single bit on the MSB that
    * acts a boolean closed: True if the the Overlay has been closed with
@@ -10,6 +10,7 @@
 #include "eden/fs/inodes/OverlayFile.h"
 
 #include <folly/FileUtil.h>
+#include <sys/mman.h>
 
 #include "eden/fs/inodes/Overlay.h"
 #include "eden/fs/utils/NotImplemented.h"
@@ -175,6 +176,84 @@ folly::Expected<int, int> OverlayFile::fallocate(
 #endif
 }
 
+folly::Expected<int, int> OverlayFile::fadviseSequential() const {
+#ifdef __linux__
+  std::shared_ptr<Overlay> overlay = overlay_.lock();
+  if (!overlay) {
+    return folly::makeUnexpected(EIO);
+  }
+  if (std::holds_alternative<folly::File>(data_)) {
+    auto& file = std::get<folly::File>(data_);
+    IORequest req{overlay.get()};
+
+    // posix_fadvise returns the error number directly instead of setting
+    // errno.
+    auto ret = ::posix_fadvise(file.fd(), 0, 0, POSIX_FADV_SEQUENTIAL);
+    if (ret != 0) {
+      return folly::makeUnexpected(ret);
+    }
+    return folly::makeExpected<int>(ret);
+  } else {
+    NOT_IMPLEMENTED();
+  }
+#else
+  return folly::makeUnexpected(ENOSYS);
+#endif
+}
+
+folly::Expected<FileOffset, int> OverlayFile::copyRangeFrom(
+    const OverlayFile& source,
+    FileOffset offset,
+    FileOffset length) const {
+#ifdef __linux__
+  std::shared_ptr<Overlay> overlay = overlay_.lock();
+  if (!overlay) {
+    return folly::makeUnexpected(EIO);
+  }
+  if (!std::holds_alternative<folly::File>(data_) ||
+      !std::holds_alternative<folly::File>(source.data_)) {
+    // Unlike the single-file operations above, callers of copyRangeFrom
+    // are expected to fall back to an ordinary write, so report ENOTSUP
+    // rather than aborting.
+    return folly::makeUnexpected(ENOTSUP);
+  }
+  auto& file = std::get<folly::File>(data_);
+  auto& sourceFile = std::get<folly::File>(source.data_);
+  IORequest req{overlay.get()};
+
+  FileOffset copied = 0;
+  while (copied < length) {
+    off_t inOffset = offset + copied;
+    off_t outOffset = offset + copied;
+    auto ret = ::copy_file_range(
+        sourceFile.fd(),
+        &inOffset,
+        file.fd(),
+        &outOffset,
+        length - copied,
+        0);
+    if (ret == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return folly::makeUnexpected(errno);
+    }
+    if (ret == 0) {
+      // Unexpected EOF on the source; let the caller notice the short
+      // copy and fall back.
+      break;
+    }
+    copied += ret;
+  }
+  return copied;
+#else
+  (void)source;
+  (void)offset;
+  (void)length;
+  return folly::makeUnexpected(ENOSYS);
+#endif
+}
+
 folly::Expected<int, int> OverlayFile::fdatasync() const {
 #ifndef __APPLE__
   std::shared_ptr<Overlay> overlay = overlay_.lock();
@@ -198,6 +277,25 @@ folly::Expected<int, int> OverlayFile::fdatasync() const {
 #endif
 }
 
+folly::Expected<void*, int> OverlayFile::mmapReadOnly(size_t length) const {
+  std::shared_ptr<Overlay> overlay = overlay_.lock();
+  if (!overlay) {
+    return folly::makeUnexpected(EIO);
+  }
+  if (!std::holds_alternative<folly::File>(data_)) {
+    // Callers fall back to pread, so report ENOTSUP rather than aborting.
+    return folly::makeUnexpected(ENOTSUP);
+  }
+  auto& file = std::get<folly::File>(data_);
+  IORequest req{overlay.get()};
+
+  void* data = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, file.fd(), 0);
+  if (data == MAP_FAILED) {
+    return folly::makeUnexpected(errno);
+  }
+  return data;
+}
+
 folly::Expected<std::string, int> OverlayFile::readFile() const {
   std::shared_ptr<Overlay> overlay = overlay_.lock();
   if (!overlay) {
@@ -52,8 +52,33 @@ class OverlayFile {
   folly::Expected<int, int> fsync() const;
   folly::Expected<int, int> fallocate(FileOffset offset, FileOffset length)
       const;
+  /**
+   * Advise the kernel that the rest of this file will likely be read
+   * sequentially, so it can widen its readahead window. Purely a hint;
+   * returns ENOSYS on platforms without posix_fadvise.
+   */
+  folly::Expected<int, int> fadviseSequential() const;
+  /**
+   * Copy length bytes at the given offset from source into this file at
+   * the same offset, without moving the data through user space. On
+   * filesystems with reflink support the payload's extents are shared
+   * rather than duplicated. Returns the number of bytes copied, ENOTSUP
+   * when either file is not backed by a file descriptor, and ENOSYS on
+   * platforms without copy_file_range.
+   */
+  folly::Expected<FileOffset, int> copyRangeFrom(
+      const OverlayFile& source,
+      FileOffset offset,
+      FileOffset length) const;
   folly::Expected<int, int> fdatasync() const;
   folly::Expected<std::string, int> readFile() const;
+  /**
+   * Map the first length bytes of the file read-only and shared. The
+   * caller owns the mapping and must munmap it. Returns ENOTSUP when the
+   * file is not backed by a file descriptor, and ENOSYS on platforms
+   * without mmap; callers are expected to fall back to pread.
+   */
+  folly::Expected<void*, int> mmapReadOnly(size_t length) const;
 
  private:
   OverlayFile(const OverlayFile&) = delete;
@@ -9,10 +9,14 @@
 
 #include "eden/fs/inodes/OverlayFileAccess.h"
 
+#include <folly/Exception.h>
 #include <folly/Expected.h>
 #include <folly/Range.h>
 #include <folly/logging/xlog.h>
 #include <folly/portability/OpenSSL.h>
+#include <sys/mman.h>
+
+#include <shared_mutex>
 
 #include "eden/fs/digest/Blake3.h"
 #include "eden/fs/inodes/FileInode.h"
@@ -29,6 +33,20 @@ namespace facebook::eden {
 
 constexpr size_t kHashingBufSize = 8192;
 
+/**
+ * How many recently materialized files are remembered as potential clone
+ * sources. Each slot can pin an open overlay file handle, so keep this
+ * modest relative to the entry cache.
+ */
+constexpr size_t kRecentMaterializationIndexSize = 64;
+
+/**
+ * How many evicted entries' sizes and content hashes are remembered. Each
+ * slot is ~64 bytes, so the bound is a few hundred KB; unlike the entry
+ * cache these slots do not pin open file handles.
+ */
+constexpr size_t kEvictedMetadataCacheSize = 4096;
+
 template <typename Hasher>
 int hash(Hasher&& hasher, const OverlayFile& file) {
   FileOffset off = FsFileContentStore::kHeaderLength;
@@ -62,16 +80,53 @@ void OverlayFileAccess::Entry::Info::invalidateMetadata() {
   size = std::nullopt;
   sha1 = std::nullopt;
   blake3 = std::nullopt;
+  appendSha1State = std::nullopt;
+  appendHashLength = 0;
 }
 
-OverlayFileAccess::State::State(size_t cacheSize) : entries{cacheSize} {
+OverlayFileAccess::Entry::Mapping::~Mapping() {
+  ::munmap(data, length);
+}
+
+void OverlayFileAccess::dropMapping(Entry& entry) {
+  // The wlock ensures no reader is copying out of the mapping while it is
+  // unmapped or while a following truncate shrinks the file.
+  entry.mapping.wlock()->reset();
+  entry.mappingAttempted.store(false, std::memory_order_relaxed);
+}
+
+OverlayFileAccess::State::State(size_t cacheSize)
+    : entries{cacheSize},
+      recentMaterializations{kRecentMaterializationIndexSize} {
   if (cacheSize == 0) {
     throw std::range_error{"overlayFileCacheSize must be at least 1"};
   }
 }
 
 OverlayFileAccess::OverlayFileAccess(Overlay* overlay, size_t cacheSize)
-    : overlay_{overlay}, state_{folly::in_place, cacheSize} {}
+    : overlay_{overlay},
+      evictedMetadata_{folly::in_place, kEvictedMetadataCacheSize},
+      state_{folly::in_place, cacheSize} {
+  // Poison evicted entries. Once an entry is evicted, the inode's file may
+  // be reopened and written through a fresh entry, so an in-flight clone
+  // using the old entry must be able to detect that its version check no
+  // longer covers the file.
+  //
+  // Before poisoning, save any known size and content hashes so that
+  // reopening the inode does not rehash unmodified contents from scratch.
+  // The size is required because it is what verifies the saved hashes on
+  // reopen.
+  state_.wlock()->entries.setPruneHook(
+      [this](InodeNumber ino, EntryPtr&& entry) {
+        auto info = entry->info.wlock();
+        if (info->size.has_value() &&
+            (info->sha1.has_value() || info->blake3.has_value())) {
+          evictedMetadata_.wlock()->set(
+              ino, SavedMetadata{*info->size, info->sha1, info->blake3});
+        }
+        info->invalidateMetadata();
+      });
+}
 
 OverlayFileAccess::~OverlayFileAccess() = default;
 
@@ -79,6 +134,7 @@ void OverlayFileAccess::createEmptyFile(
     InodeNumber ino,
     const std::optional<std::string>& maybeBlake3Key) {
   auto file = overlay_->createOverlayFile(ino, folly::ByteRange{});
+  evictedMetadata_.wlock()->erase(ino);
   auto state = state_.wlock();
   XCHECK(!state->entries.exists(ino))
       << "Cannot create overlay file " << ino << " when it's already open!";
@@ -88,10 +144,18 @@ void OverlayFileAccess::createEmptyFile(
   Hash32 emptyBlake3;
   blake3.finalize(emptyBlake3.mutableBytes());
 
-  state->entries.set(
-      ino,
-      std::make_shared<Entry>(
-          std::move(file), size_t{0}, kEmptySha1, std::move(emptyBlake3)));
+  auto entry = std::make_shared<Entry>(
+      std::move(file), size_t{0}, kEmptySha1, std::move(emptyBlake3));
+  {
+    // A new empty file is typically populated by sequential writes; seed a
+    // streaming hash state so those writes are hashed as they land.
+    SHA_CTX ctx;
+    SHA1_Init(&ctx);
+    auto info = entry->info.wlock();
+    info->appendSha1State = ctx;
+    info->appendHashLength = 0;
+  }
+  state->entries.set(ino, std::move(entry));
 }
 
 void OverlayFileAccess::createFile(
@@ -99,13 +163,81 @@ void OverlayFileAccess::createFile(
     const Blob& blob,
     const std::optional<Hash20>& sha1,
     const std::optional<Hash32>& blake3) {
-  auto file = overlay_->createOverlayFile(ino, blob.getContents());
+  auto file = tryCreateCloned(ino, blob, sha1);
+  if (!file.has_value()) {
+    file = overlay_->createOverlayFile(ino, blob.getContents());
+  }
+  evictedMetadata_.wlock()->erase(ino);
   auto state = state_.wlock();
   XCHECK(!state->entries.exists(ino))
       << "Cannot create overlay file " << ino << " when it's already open!";
-  state->entries.set(
-      ino,
-      std::make_shared<Entry>(std::move(file), blob.getSize(), sha1, blake3));
+  auto entry =
+      std::make_shared<Entry>(std::move(*file), blob.getSize(), sha1, blake3);
+  state->entries.set(ino, entry);
+  if (sha1.has_value() && blob.getSize() != 0) {
+    state->recentMaterializations.set(
+        *sha1, RecentMaterialization{entry, entry->info.rlock()->version});
+  }
+}
+
+std::optional<OverlayFile> OverlayFileAccess::tryCreateCloned(
+    InodeNumber ino,
+    const Blob& blob,
+    const std::optional<Hash20>& sha1) {
+  if (!sha1.has_value() || blob.getSize() == 0) {
+    return std::nullopt;
+  }
+
+  EntryPtr source;
+  uint64_t sourceVersion;
+  {
+    auto state = state_.wlock();
+    auto iter = state->recentMaterializations.find(*sha1);
+    if (iter == state->recentMaterializations.end()) {
+      return std::nullopt;
+    }
+    source = iter->second.entry;
+    sourceVersion = iter->second.version;
+  }
+
+  // Block writes to the source while its payload is copied, and verify
+  // nothing modified it since it was indexed.
+  std::unique_lock cloneLock{source->cloneLock};
+  if (source->info.rlock()->version != sourceVersion) {
+    return std::nullopt;
+  }
+
+  auto file = overlay_->createOverlayFile(ino, folly::ByteRange{});
+  const auto length = static_cast<FileOffset>(blob.getSize());
+  auto copied = file.copyRangeFrom(
+      source->file, FsFileContentStore::kHeaderLength, length);
+
+  bool cloned = copied.hasValue() && copied.value() == length;
+  if (cloned) {
+    // Eviction of the source entry bumps its version, and any write that
+    // could have raced with the copy through a freshly opened entry is
+    // preceded by such an eviction, so a stable version here means the
+    // copied bytes match the blob.
+    cloned = source->info.rlock()->version == sourceVersion;
+  }
+  if (!cloned) {
+    // The kernel-side copy is unavailable (non-Linux, LMDB-backed
+    // overlay) or raced with a modification of the source. Overwrite with
+    // the blob contents we already have in memory.
+    auto iov = blob.getContents().getIov();
+    auto written = file.pwritev(
+        iov.data(),
+        static_cast<int>(iov.size()),
+        FsFileContentStore::kHeaderLength);
+    if (written.hasError()) {
+      folly::throwSystemErrorExplicit(
+          written.error(), "failed to write overlay file contents");
+    }
+    if (written.value() != static_cast<ssize_t>(blob.getSize())) {
+      folly::throwSystemErrorExplicit(EIO, "short write of overlay file");
+    }
+  }
+  return file;
 }
 
 FileOffset OverlayFileAccess::getFileSize(FileInode& inode) {
@@ -160,10 +292,20 @@ Hash20 OverlayFileAccess::getSha1(FileInode& inode) {
   auto entry = getEntryForInode(inode.getNodeId());
   uint64_t version;
   {
-    auto info = entry->info.rlock();
+    auto info = entry->info.wlock();
     if (info->sha1.has_value()) {
       return *info->sha1;
     }
+    if (info->appendSha1State.has_value()) {
+      // The streaming state covers the whole file; finalize a copy of it
+      // instead of rereading the contents, keeping the state itself usable
+      // for further appends.
+      SHA_CTX ctx = *info->appendSha1State;
+      Hash20 sha1;
+      SHA1_Final(sha1.mutableBytes().begin(), &ctx);
+      info->sha1 = sha1;
+      return sha1;
+    }
     version = info->version;
   }
 
@@ -172,8 +314,12 @@ Hash20 OverlayFileAccess::getSha1(FileInode& inode) {
 
   SHA_CTX ctx;
   SHA1_Init(&ctx);
+  uint64_t hashedBytes = 0;
   if (auto r = hash(
-          [&ctx](const auto* buf, auto len) { SHA1_Update(&ctx, buf, len); },
+          [&](const auto* buf, auto len) {
+            SHA1_Update(&ctx, buf, len);
+            hashedBytes += len;
+          },
           entry->file);
       r != 0) {
     throw InodeError(
@@ -182,12 +328,17 @@ Hash20 OverlayFileAccess::getSha1(FileInode& inode) {
 
   static_assert(Hash20::RAW_SIZE == SHA_DIGEST_LENGTH);
   Hash20 sha1;
-  SHA1_Final(sha1.mutableBytes().begin(), &ctx);
+  auto finalCtx = ctx;
+  SHA1_Final(sha1.mutableBytes().begin(), &finalCtx);
 
-  // Update the cache if the version still matches.
+  // Update the cache if the version still matches.  The pre-finalization
+  // streaming state is saved too, so a later append extends it rather than
+  // forcing another full reread.
   auto info = entry->info.wlock();
   if (version == info->version) {
     info->sha1 = sha1;
+    info->appendSha1State = ctx;
+    info->appendHashLength = hashedBytes;
   }
   return sha1;
 }
@@ -261,6 +412,46 @@ std::string OverlayFileAccess::readAllContents(FileInode& inode) {
 BufVec OverlayFileAccess::read(FileInode& inode, size_t size, FileOffset off) {
   auto entry = getEntryForInode(inode.getNodeId());
 
+  {
+    // When a read mapping is established, copy straight out of the page
+    // cache instead of paying a pread syscall per request. The rlock is
+    // held across the copy: a concurrent truncate drops the mapping under
+    // the wlock before shrinking the file, so the pages we touch cannot
+    // fault. The mapping's length is the file size (modifications drop
+    // it), so EOF handling against it is exact.
+    auto mapping = entry->mapping.rlock();
+    if (*mapping) {
+      const auto contentOff =
+          static_cast<size_t>(off) + FsFileContentStore::kHeaderLength;
+      const auto length = (*mapping)->length;
+      auto buf = folly::IOBuf::createCombined(size);
+      if (contentOff < length) {
+        auto avail = std::min(size, length - contentOff);
+        memcpy(
+            buf->writableBuffer(),
+            static_cast<const char*>((*mapping)->data) + contentOff,
+            avail);
+        buf->append(avail);
+        entry->nextSequentialOffset.store(
+            off + avail, std::memory_order_relaxed);
+      }
+      return BufVec{std::move(buf)};
+    }
+  }
+
+  // Blob-backed files are loaded into memory whole, so per-request reads
+  // only reach the backing filesystem here, for materialized files. When
+  // two reads in a row are contiguous, advise the kernel once that the rest
+  // of the file will likely be read sequentially so its readahead window
+  // can open up ahead of the next request.
+  if (off != 0 &&
+      off == entry->nextSequentialOffset.load(std::memory_order_relaxed) &&
+      !entry->sequentialAdviseIssued.exchange(
+          true, std::memory_order_relaxed)) {
+    // This is purely a hint; ignore failures.
+    (void)entry->file.fadviseSequential();
+  }
+
   auto buf = folly::IOBuf::createCombined(size);
   auto res = entry->file.preadNoInt(
       buf->writableBuffer(), size, off + FsFileContentStore::kHeaderLength);
@@ -272,6 +463,33 @@ BufVec OverlayFileAccess::read(FileInode& inode, size_t size, FileOffset off) {
         "pread failed during overlay file read");
   }
 
+  entry->nextSequentialOffset.store(
+      off + res.value(), std::memory_order_relaxed);
+
+  // Try once per modification epoch to establish a read mapping for large
+  // files, so the reads that follow this one skip the syscall above.
+  if (!entry->mappingAttempted.exchange(true, std::memory_order_relaxed)) {
+    const auto versionBefore = entry->info.rlock()->version;
+    auto st = entry->file.fstat();
+    if (st.hasValue() &&
+        static_cast<uint64_t>(st.value().st_size) >=
+            FsFileContentStore::kHeaderLength + kMapThresholdBytes) {
+      const auto mapLength = static_cast<size_t>(st.value().st_size);
+      auto mapped = entry->file.mmapReadOnly(mapLength);
+      if (mapped.hasValue()) {
+        auto mapping = entry->mapping.wlock();
+        if (!*mapping && entry->info.rlock()->version == versionBefore) {
+          *mapping =
+              std::make_unique<Entry::Mapping>(mapped.value(), mapLength);
+        } else {
+          // The file was modified between the fstat and here, so the
+          // mapped length may be stale; the next read retries.
+          ::munmap(mapped.value(), mapLength);
+        }
+      }
+    }
+  }
+
   buf->append(res.value());
   return BufVec{std::move(buf)};
 }
@@ -281,8 +499,17 @@ size_t OverlayFileAccess::write(
     const struct iovec* iov,
     size_t iovcnt,
     FileOffset off) {
+  if (overlay_->isOverHardSizeLimit()) {
+    throw InodeError(
+        ENOSPC,
+        inode.inodePtrFromThis(),
+        "overlay is over its hard size limit");
+  }
   auto entry = getEntryForInode(inode.getNodeId());
 
+  // Hold the clone lock shared so a concurrent materialization cloning
+  // this file's payload cannot observe a half-applied write.
+  std::shared_lock cloneLock{entry->cloneLock};
   auto xfer =
       entry->file.pwritev(iov, iovcnt, off + FsFileContentStore::kHeaderLength);
   if (xfer.hasError()) {
@@ -291,14 +518,45 @@ size_t OverlayFileAccess::write(
         inode.inodePtrFromThis(),
         "pwritev failed during file write");
   }
-  auto info = entry->info.wlock();
-  info->invalidateMetadata();
+  {
+    auto info = entry->info.wlock();
+    if (info->appendSha1State.has_value() && off >= 0 &&
+        static_cast<uint64_t>(off) == info->appendHashLength) {
+      // Pure append: extend the streaming hash state with the bytes
+      // actually written instead of discarding everything we know about
+      // the contents. A racing append sees a moved appendHashLength below
+      // and falls into the invalidation path, so the state never covers
+      // torn contents.
+      size_t remaining = xfer.value();
+      for (size_t i = 0; i < iovcnt && remaining != 0; ++i) {
+        auto len = std::min(iov[i].iov_len, remaining);
+        SHA1_Update(&info->appendSha1State.value(), iov[i].iov_base, len);
+        remaining -= len;
+      }
+      info->appendHashLength += xfer.value();
+      ++info->version;
+      info->sha1 = std::nullopt;
+      info->blake3 = std::nullopt;
+      info->size = info->appendHashLength;
+    } else {
+      info->invalidateMetadata();
+    }
+  }
+  // The write may have grown the file past a read mapping's length; drop
+  // it (after the version bump above, see dropMapping) so reads go back
+  // to pread until a new mapping is established.
+  dropMapping(*entry);
 
   return xfer.value();
 }
 
 void OverlayFileAccess::truncate(FileInode& inode, FileOffset size) {
   auto entry = getEntryForInode(inode.getNodeId());
+  std::shared_lock cloneLock{entry->cloneLock};
+  // Unmap before shrinking the file: touching mapped pages past the new
+  // EOF would fault, and dropMapping's wlock waits out any reader still
+  // copying from the mapping.
+  dropMapping(*entry);
   auto result = entry->file.ftruncate(size + FsFileContentStore::kHeaderLength);
   if (result.hasError()) {
     throw InodeError(
@@ -307,8 +565,23 @@ void OverlayFileAccess::truncate(FileInode& inode, FileOffset size) {
         "unable to ftruncate overlay file");
   }
 
-  auto info = entry->info.wlock();
-  info->invalidateMetadata();
+  {
+    auto info = entry->info.wlock();
+    info->invalidateMetadata();
+    if (size == 0) {
+      // The truncate-then-rewrite flow is a sequence of appends from byte
+      // zero; seed a fresh streaming hash state so the rewrite is hashed
+      // as it is written.
+      SHA_CTX ctx;
+      SHA1_Init(&ctx);
+      info->appendSha1State = ctx;
+      info->appendHashLength = 0;
+      info->size = size_t{0};
+    }
+  }
+  // Drop again after the version bump, in case a racing read installed a
+  // mapping sized before the truncation.
+  dropMapping(*entry);
 }
 
 void OverlayFileAccess::fsync(FileInode& inode, bool datasync) {
@@ -329,7 +602,16 @@ void OverlayFileAccess::fallocate(
     FileInode& inode,
     uint64_t offset,
     uint64_t length) {
+  if (overlay_->isOverHardSizeLimit()) {
+    throw InodeError(
+        ENOSPC,
+        inode.inodePtrFromThis(),
+        "overlay is over its hard size limit");
+  }
   auto entry = getEntryForInode(inode.getNodeId());
+  // fallocate can extend the file with zeroes, so it also counts as a
+  // modification for clone purposes.
+  std::shared_lock cloneLock{entry->cloneLock};
   auto result =
       entry->file.fallocate(offset, length + FsFileContentStore::kHeaderLength);
   if (result.hasError()) {
@@ -338,6 +620,25 @@ void OverlayFileAccess::fallocate(
         inode.inodePtrFromThis(),
         "unable to fallocate overlay file");
   }
+
+  // fallocate can extend the file with zeroes past the previously known
+  // size, so all cached content metadata is stale now.
+  entry->info.wlock()->invalidateMetadata();
+  dropMapping(*entry);
+}
+
+void OverlayFileAccess::forget(InodeNumber ino) {
+  {
+    auto state = state_.wlock();
+    auto iter = state->entries.find(ino);
+    if (iter != state->entries.end()) {
+      // Bump the version so an in-flight clone using this entry as its
+      // source notices that its version check no longer covers the file.
+      iter->second->info.wlock()->invalidateMetadata();
+      state->entries.erase(ino);
+    }
+  }
+  evictedMetadata_.wlock()->erase(ino);
 }
 
 OverlayFileAccess::EntryPtr OverlayFileAccess::getEntryForInode(
@@ -351,11 +652,36 @@ OverlayFileAccess::EntryPtr OverlayFileAccess::getEntryForInode(
   }
 
   // No entry found. Open one while the lock is not held.
-  // TODO: A possible future optimization here is, if a SHA-1 is known when
-  // the blob is evicted, write it into an xattr when the blob is closed. When
-  // reopened, if the xattr exists, read it back out (and clear).
-  auto entry = std::make_shared<Entry>(
-      overlay_->openFileNoVerify(ino), std::nullopt, std::nullopt);
+  std::optional<SavedMetadata> saved;
+  {
+    auto evicted = evictedMetadata_.wlock();
+    auto iter = evicted->find(ino);
+    if (iter != evicted->end()) {
+      saved = iter->second;
+      evicted->erase(iter->first);
+    }
+  }
+
+  auto file = overlay_->openFileNoVerify(ino);
+
+  // If a previous entry for this inode saved its content hashes when it was
+  // evicted, verify the file is still the size it was then and seed the new
+  // entry with them, skipping a full rehash. A single fstat is the price of
+  // the check.
+  if (saved.has_value()) {
+    auto st = file.fstat();
+    if (st.hasError() ||
+        st.value().st_size !=
+            static_cast<FileOffset>(saved->size) +
+                static_cast<FileOffset>(FsFileContentStore::kHeaderLength)) {
+      saved = std::nullopt;
+    }
+  }
+
+  auto entry = saved.has_value()
+      ? std::make_shared<Entry>(
+            std::move(file), saved->size, saved->sha1, saved->blake3)
+      : std::make_shared<Entry>(std::move(file), std::nullopt, std::nullopt);
 
   {
     auto state = state_.wlock();
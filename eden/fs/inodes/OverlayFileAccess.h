@@ -8,8 +8,11 @@
 #pragma once
 
 #include <folly/File.h>
+#include <folly/SharedMutex.h>
 #include <folly/Synchronized.h>
 #include <folly/container/EvictingCacheMap.h>
+#include <folly/portability/OpenSSL.h>
+#include <atomic>
 #include <memory>
 #include "eden/fs/inodes/InodeNumber.h"
 #include "eden/fs/inodes/InodePtr.h"
@@ -48,6 +51,11 @@ class OverlayFileAccess {
    * Creates a new file in the overlay populated with the contents of the given
    * blob. If a sha1 is given, it is cached in memory.
    *
+   * When another file with the same content hash was recently materialized
+   * and has not been modified since, the payload is copied kernel-side from
+   * that file instead of being written again, which shares extents on
+   * filesystems with reflink support.
+   *
    * The caller must verify the overlay file does not already exist. Calls to
    * any other OverlayFileAccess functions for this inode must occur after
    * createEmptyFile returns.
@@ -117,6 +125,15 @@ class OverlayFileAccess {
    */
   void fallocate(FileInode& inode, uint64_t offset, uint64_t size);
 
+  /**
+   * Drop any cached file handle and saved metadata for the given inode.
+   *
+   * This must be called when an inode is dematerialized, before its overlay
+   * file is removed: the inode may later be materialized again, and
+   * createEmptyFile/createFile require that no entry exist for it.
+   */
+  void forget(InodeNumber ino);
+
  private:
   /*
    * OverlayFileAccess can be accessed concurrently. There are two types of data
@@ -158,18 +175,123 @@ class OverlayFileAccess {
       std::optional<Hash20> sha1;
       std::optional<Hash32> blake3;
       uint64_t version{0};
+
+      /**
+       * Streaming SHA-1 state covering the entire file contents, maintained
+       * incrementally across sequential appends.  While present,
+       * appendHashLength bytes have been consumed and, by construction,
+       * equal the file size.  A write that is not a pure append (or a
+       * truncation to a nonzero size) discards the state; getSha1() then
+       * finalizes a copy of it instead of rereading the whole file.
+       *
+       * This bounds hash recomputation for workloads that build large files
+       * by appending (database fixtures, checkpoints): without it, every
+       * write invalidates the SHA-1 cache and the next status query rereads
+       * and rehashes the entire file.
+       */
+      std::optional<SHA_CTX> appendSha1State;
+      uint64_t appendHashLength{0};
     };
 
     const OverlayFile file;
     folly::Synchronized<Info> info;
+
+    /**
+     * Sequential read detection for kernel readahead hinting: the offset
+     * just past the most recent read, and whether we have already advised
+     * the kernel. Plain relaxed atomics; the detection is a heuristic, so a
+     * racy update only costs a missed or spurious hint.
+     */
+    std::atomic<FileOffset> nextSequentialOffset{0};
+    std::atomic<bool> sequentialAdviseIssued{false};
+
+    /**
+     * Held shared around modifications to the file and exclusively while
+     * another inode's materialization clones this file's payload, so a
+     * clone never observes a half-applied write. Writers only serialize
+     * against clones, not against each other.
+     */
+    folly::SharedMutex cloneLock;
+
+    /**
+     * A read-only shared mapping of the whole overlay file (header
+     * included), established lazily for large materialized files so
+     * repeated reads are served from the page cache through the mapping
+     * instead of paying a pread syscall each. Only valid while no
+     * modification has happened since it was created: every modifying
+     * operation drops the mapping (under the wlock, so no reader can be
+     * copying out of it when the file is subsequently shrunk and the
+     * pages could fault) and the next read may re-establish it.
+     *
+     * While the mapping exists the file cannot grow, since all writes go
+     * through write() and drop it first, so its length is the file size
+     * and EOF handling against it is exact.
+     */
+    struct Mapping {
+      Mapping(void* d, size_t l) : data{d}, length{l} {}
+      ~Mapping();
+      Mapping(const Mapping&) = delete;
+      Mapping& operator=(const Mapping&) = delete;
+
+      void* const data;
+      const size_t length;
+    };
+    folly::Synchronized<std::unique_ptr<Mapping>> mapping;
+
+    /**
+     * Whether a read has already tried to map this file since the last
+     * modification, bounding the fstat+mmap attempt to one per
+     * modification epoch. Reset together with the mapping.
+     */
+    std::atomic<bool> mappingAttempted{false};
   };
 
   using EntryPtr = std::shared_ptr<Entry>;
 
+  /**
+   * A recently materialized file that can serve as the clone source for
+   * other inodes materializing a blob with the same content hash. The
+   * version captures Entry::Info::version at materialization time; if it
+   * has moved since, the file's contents no longer necessarily match.
+   */
+  struct RecentMaterialization {
+    EntryPtr entry;
+    uint64_t version;
+  };
+
+  /**
+   * Content metadata preserved when an entry is evicted from the open-file
+   * cache, so reopening the same inode does not force a full re-read and
+   * rehash just because the file handle was closed in between. Builds that
+   * query the SHA-1 of the same locally-built artifacts hundreds of times
+   * between modifications would otherwise pay the rehash on every cache
+   * miss.
+   *
+   * While EdenFS is running, overlay file contents only change through
+   * OverlayFileAccess, and every modification reopens an entry first, so
+   * metadata saved at eviction time stays valid until the next entry for
+   * that inode is created. As a cross-check against anything else touching
+   * the overlay, the saved size is verified against the file on reopen and
+   * the metadata is discarded on mismatch.
+   */
+  struct SavedMetadata {
+    size_t size;
+    std::optional<Hash20> sha1;
+    std::optional<Hash32> blake3;
+  };
+
   struct State {
     explicit State(size_t cacheSize);
 
     folly::EvictingCacheMap<InodeNumber, EntryPtr> entries;
+
+    /**
+     * Index from content SHA-1 to a recently materialized overlay file,
+     * used to deduplicate materialization IO for workloads that produce
+     * many identical files (codegen, copied build outputs).
+     */
+    folly::EvictingCacheMap<Hash20, RecentMaterialization>
+        recentMaterializations;
   };
 
   using LockedStatePtr = folly::Synchronized<State>::LockedPtr;
@@ -180,7 +302,45 @@ class OverlayFileAccess {
    */
   EntryPtr getEntryForInode(InodeNumber);
 
+  /**
+   * If a recently materialized file with the same SHA-1 is known and
+   * still unmodified, creates the overlay file for ino by cloning that
+   * file's payload kernel-side. Returns std::nullopt when no usable clone
+   * source exists; falls back to writing the blob contents itself if the
+   * copy fails partway.
+   */
+  std::optional<OverlayFile> tryCreateCloned(
+      InodeNumber ino,
+      const Blob& blob,
+      const std::optional<Hash20>& sha1);
+
+  /**
+   * Smallest file content size for which read() will establish a read
+   * mapping. Small files do not read often enough for the mapping to
+   * amortize its mmap/munmap cost over the saved preads.
+   */
+  static constexpr size_t kMapThresholdBytes = 1024 * 1024;
+
+  /**
+   * Drops the entry's read mapping and re-arms the mapping attempt.
+   * Modifying operations must call this after bumping the entry's info
+   * version: a read racing to establish a mapping checks the version
+   * under the mapping lock before installing it, so bump-then-drop
+   * guarantees a mapping with a stale length never survives.
+   */
+  static void dropMapping(Entry& entry);
+
   Overlay* overlay_ = nullptr;
+
+  /**
+   * Metadata of recently evicted entries, keyed by inode number. Kept
+   * outside State so the entry cache's prune hook can record into it while
+   * the state lock is held. Declared before state_ so it outlives the
+   * entry cache during destruction.
+   */
+  folly::Synchronized<folly::EvictingCacheMap<InodeNumber, SavedMetadata>>
+      evictedMetadata_;
+
   folly::Synchronized<State> state_;
 };
 
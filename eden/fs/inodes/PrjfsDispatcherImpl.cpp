@@ -20,6 +20,7 @@
 #include "eden/fs/inodes/FileInode.h"
 #include "eden/fs/inodes/ServerState.h"
 #include "eden/fs/inodes/TreeInode.h"
+#include "eden/fs/journal/Journal.h"
 #include "eden/fs/store/ObjectFetchContext.h"
 #include "eden/fs/store/ObjectStore.h"
 #include "eden/fs/telemetry/EdenStats.h"
@@ -77,7 +78,27 @@ EdenTimestamp PrjfsDispatcherImpl::getLastCheckoutTime() const {
 ImmediateFuture<std::vector<PrjfsDirEntry>> PrjfsDispatcherImpl::opendir(
     RelativePath path,
     const ObjectFetchContextPtr& context) {
-  return mount_->getServerState()
+  std::optional<uint64_t> journalSequence;
+  if (mount_->getEdenConfig()->prjfsUseEnumerationCaching.getValue()) {
+    journalSequence = getJournalSequence();
+    auto cache = enumerationCache_.wlock();
+    auto it = cache->find(path);
+    if (it != cache->end() &&
+        it->second.journalSequence == *journalSequence) {
+      // The listing was built when the Journal was already at its current
+      // position, thus nothing changed in the working copy since then:
+      // serve it from cache. Tools like Explorer will re-enumerate the
+      // same unchanged directory over and over.
+      return std::vector<PrjfsDirEntry>{it->second.entries};
+    }
+  }
+  // Take a copy before the chain below moves path, so the result can be
+  // inserted in the cache once built.
+  auto cachePath = journalSequence.has_value()
+      ? std::optional<RelativePath>{path}
+      : std::nullopt;
+
+  auto fut = mount_->getServerState()
       ->getFaultInjector()
       .checkAsync("PrjfsDispatcherImpl::opendir", path.view())
       .thenValue([this, path = std::move(path), context = context.copy()](
@@ -185,6 +206,29 @@ ImmediateFuture<std::vector<PrjfsDirEntry>> PrjfsDispatcherImpl::opendir(
               return dirEntries;
             });
       });
+
+  if (!journalSequence.has_value()) {
+    return fut;
+  }
+  return std::move(fut).thenValue(
+      [this,
+       path = std::move(cachePath).value(),
+       journalSequence = *journalSequence](
+          std::vector<PrjfsDirEntry> entries) {
+        // Only cache the listing if the Journal didn't move while it was
+        // being built, otherwise a concurrent write may not be reflected
+        // in it.
+        if (getJournalSequence() == journalSequence) {
+          enumerationCache_.wlock()->set(
+              path, CachedEnumeration{journalSequence, entries});
+        }
+        return entries;
+      });
+}
+
+uint64_t PrjfsDispatcherImpl::getJournalSequence() {
+  auto latest = mount_->getJournal().getLatest();
+  return latest.has_value() ? latest->sequenceID : 0;
 }
 
 ImmediateFuture<bool> PrjfsDispatcherImpl::isFinalSymlinkPathDirectory(
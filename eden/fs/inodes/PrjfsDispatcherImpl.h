@@ -7,6 +7,8 @@
 
 #pragma once
 
+#include <folly/container/EvictingCacheMap.h>
+
 #include "eden/fs/inodes/EdenMount.h"
 #include "eden/fs/prjfs/PrjfsDispatcher.h"
 #include "eden/fs/service/gen-cpp2/eden_types.h"
@@ -98,10 +100,35 @@ class PrjfsDispatcherImpl : public PrjfsDispatcher {
       const int remainingRecursionDepth = kMaxSymlinkChainDepth);
 
  private:
+  /**
+   * Return the Journal position, or 0 when the Journal is empty.
+   */
+  uint64_t getJournalSequence();
+
+  /**
+   * A directory listing built by opendir, along with the Journal position
+   * at the time it was built.
+   */
+  struct CachedEnumeration {
+    uint64_t journalSequence;
+    std::vector<PrjfsDirEntry> entries;
+  };
+
+  static constexpr size_t kEnumerationCacheSize = 1024;
+
   // The EdenMount associated with this dispatcher.
   EdenMount* const mount_;
   folly::Synchronized<std::unordered_set<RelativePath>> symlinkCheck_;
 
+  /**
+   * Cache of directory listings, keyed by directory path. A cached listing
+   * is only valid while the Journal is still at the position recorded when
+   * it was built: any write to the working copy invalidates it. See
+   * prjfs:use-enumeration-caching.
+   */
+  folly::Synchronized<folly::EvictingCacheMap<RelativePath, CachedEnumeration>>
+      enumerationCache_{std::in_place, kEnumerationCacheSize};
+
   const std::string dotEdenConfig_;
 
   bool symlinksEnabled_;
@@ -26,6 +26,22 @@ RequestContext::~RequestContext() noexcept {
       latencyStat_(*stats_).addDuration(diff);
     }
 
+    if (latencyHistogram_) {
+      latencyHistogram_->record(duration_cast<microseconds>(diff));
+    }
+
+    if (spanRecorder_) {
+      auto& buffer = SlowRequestTraceBuffer::get();
+      if (diff_ns >= buffer.threshold() && buffer.isEnabled()) {
+        spanRecorder_->addStage("reply");
+        buffer.add(SlowRequestTraceBuffer::Trace{
+            std::chrono::system_clock::now(),
+            std::move(opName_),
+            diff_ns,
+            spanRecorder_->extractStages()});
+      }
+    }
+
     if (requestWatchList_) {
       { auto temp = std::move(requestMetricsScope_); }
       requestWatchList_.reset();
@@ -62,11 +78,20 @@ void RequestContext::startRequest(
     EdenStatsPtr stats,
     DurationFn stat,
     std::shared_ptr<RequestMetricsScope::LockedRequestWatchList>
-        requestWatches) {
+        requestWatches,
+    DurationHistogram* latencyHistogram,
+    std::string_view opName) {
   startTime_ = steady_clock::now();
   XDCHECK(!latencyStat_);
   stats_ = std::move(stats);
   latencyStat_ = std::move(stat);
+  latencyHistogram_ = latencyHistogram;
+  if (SlowRequestTraceBuffer::get().isEnabled()) {
+    spanRecorder_ = std::make_shared<RequestSpanRecorder>();
+    spanRecorder_->addStage("dispatch");
+    opName_ = std::string{opName};
+    fsObjectFetchContext_->setSpanRecorder(spanRecorder_);
+  }
   requestWatchList_ = requestWatches;
   if (requestWatchList_) {
     requestMetricsScope_ = RequestMetricsScope(requestWatchList_.get());
@@ -13,9 +13,12 @@
 
 #include "eden/fs/store/ImportPriority.h"
 #include "eden/fs/store/ObjectFetchContext.h"
+#include "eden/fs/telemetry/DurationHistogram.h"
 #include "eden/fs/telemetry/EdenStats.h"
 #include "eden/fs/telemetry/RequestMetricsScope.h"
+#include "eden/fs/telemetry/RequestSpanRecorder.h"
 #include "eden/fs/utils/ProcessAccessLog.h"
+#include "eden/fs/utils/RefPtr.h"
 
 namespace facebook::eden {
 
@@ -46,6 +49,21 @@ class FsObjectFetchContext : public ObjectFetchContext {
   void didFetch(ObjectType /*type*/, const ObjectId& /*hash*/, Origin origin)
       override {
     edenTopStats_.setFetchOrigin(origin);
+    if (spanRecorder_) {
+      switch (origin) {
+        case Origin::FromMemoryCache:
+          spanRecorder_->addStage("fetch_memory_cache");
+          break;
+        case Origin::FromDiskCache:
+          spanRecorder_->addStage("fetch_disk_cache");
+          break;
+        case Origin::FromNetworkFetch:
+          spanRecorder_->addStage("fetch_network");
+          break;
+        default:
+          break;
+      }
+    }
   }
 
   Cause getCause() const override {
@@ -61,6 +79,14 @@ class FsObjectFetchContext : public ObjectFetchContext {
     return nullptr;
   }
 
+  RequestSpanRecorder* getSpanRecorder() const override {
+    return spanRecorder_.get();
+  }
+
+  void setSpanRecorder(std::shared_ptr<RequestSpanRecorder> recorder) {
+    spanRecorder_ = std::move(recorder);
+  }
+
   void deprioritize(uint64_t delta) override {
     ImportPriority prev = priority_.load(std::memory_order_acquire);
     priority_.compare_exchange_strong(
@@ -74,6 +100,9 @@ class FsObjectFetchContext : public ObjectFetchContext {
  private:
   EdenTopStats edenTopStats_;
 
+  /** Shared with the owning RequestContext; see RequestContext::spanRecorder_. */
+  std::shared_ptr<RequestSpanRecorder> spanRecorder_;
+
   /**
    * Normally, one requestData is created for only one fetch request,
    * so priority will only be accessed by one thread, but that is
@@ -86,7 +115,17 @@ class FsObjectFetchContext : public ObjectFetchContext {
 
 using FsObjectFetchContextPtr = RefPtr<FsObjectFetchContext>;
 
-class RequestContext {
+/**
+ * Tracks the lifetime of a single filesystem request: stats, latency
+ * accounting, and the fetch context handed to the object store.
+ *
+ * RequestContext is intrusively reference counted so channels can share
+ * ownership between the reply path and a timeout path via RefPtr without a
+ * separate control-block allocation. Channels that own their requests
+ * exclusively may use unique_ptr instead; the reference count is then
+ * simply unused.
+ */
+class RequestContext : public RefCounted {
  public:
   explicit RequestContext(
       ProcessAccessLog& pal,
@@ -104,13 +143,17 @@ class RequestContext {
       EdenStatsPtr stats,
       StatsGroupBase::Duration T::*stat,
       std::shared_ptr<RequestMetricsScope::LockedRequestWatchList>
-          requestWatches) {
+          requestWatches,
+      DurationHistogram* latencyHistogram = nullptr,
+      std::string_view opName = {}) {
     return startRequest(
         std::move(stats),
         [stat](EdenStats& stats) -> StatsGroupBase::Duration& {
           return stats.getStatsForCurrentThread<T>().*stat;
         },
-        std::move(requestWatches));
+        std::move(requestWatches),
+        latencyHistogram,
+        opName);
   }
 
   const ObjectFetchContextPtr& getObjectFetchContext() const {
@@ -135,7 +178,9 @@ class RequestContext {
       EdenStatsPtr stats,
       DurationFn stat,
       std::shared_ptr<RequestMetricsScope::LockedRequestWatchList>
-          requestWatches);
+          requestWatches,
+      DurationHistogram* latencyHistogram,
+      std::string_view opName);
 
   void finishRequest() noexcept;
 
@@ -144,6 +189,15 @@ class RequestContext {
   EdenStatsPtr stats_;
   DurationFn latencyStat_;
 
+  // If set, points at the owning channel's per-mount histogram for this
+  // request's access family. The channel outlives its requests.
+  DurationHistogram* latencyHistogram_ = nullptr;
+
+  // Only allocated when slow-request tracing is enabled. Shared with the
+  // fetch context so stages can be recorded deep in the object store.
+  std::shared_ptr<RequestSpanRecorder> spanRecorder_;
+  std::string opName_;
+
   RequestMetricsScope requestMetricsScope_;
   std::shared_ptr<RequestMetricsScope::LockedRequestWatchList>
       requestWatchList_;
@@ -69,6 +69,7 @@ ServerState::ServerState(
                     mainEventBase,
                     initialConfig.numNfsThreads.getValue(),
                     initialConfig.maxNfsInflightRequests.getValue(),
+                    initialConfig.numNfsIoThreads.getValue(),
                     initialConfig.runInternalRpcbind.getValue(),
                     structuredLogger_)
               : nullptr},
@@ -47,12 +47,15 @@
 #include "eden/fs/store/DiffCallback.h"
 #include "eden/fs/store/DiffContext.h"
 #include "eden/fs/store/ObjectStore.h"
+#include "eden/fs/store/PathLoader.h"
+#include "eden/fs/telemetry/EdenStats.h"
 #include "eden/fs/telemetry/LogEvent.h"
 #include "eden/fs/telemetry/Tracing.h"
 #include "eden/fs/utils/Bug.h"
 #include "eden/fs/utils/CaseSensitivity.h"
 #include "eden/fs/utils/Clock.h"
 #include "eden/fs/utils/FaultInjector.h"
+#include "eden/fs/utils/GlobMatcher.h"
 #include "eden/fs/utils/ImmediateFuture.h"
 #include "eden/fs/utils/NotImplemented.h"
 #include "eden/fs/utils/PathFuncs.h"
@@ -186,6 +189,27 @@ TreeInode::TreeInode(
     std::optional<ObjectId> treeHash)
     : Base(mount), contents_(folly::in_place, std::move(dir), treeHash) {}
 
+/**
+ * A snapshot of the entries a readdir stream has not yet emitted, sorted
+ * by inode number. See readdirImpl for how it is resumed and invalidated.
+ */
+struct TreeInode::ReaddirCursor {
+  struct Entry {
+    PathComponent name;
+    dtype_t dtype;
+    InodeNumber inodeNumber;
+  };
+
+  /** The offset the next readdir call must pass to resume this stream. */
+  off_t nextOffset{2};
+
+  /** Entries not yet emitted, sorted by inode number. */
+  std::vector<Entry> entries;
+
+  /** Index into `entries` of the next entry to emit. */
+  size_t index{0};
+};
+
 TreeInode::~TreeInode() = default;
 
 ImmediateFuture<struct stat> TreeInode::stat(
@@ -236,6 +260,14 @@ std::optional<ImmediateFuture<VirtualInode>> TreeInode::rlockGetOrFindChild(
   // Check if the child is already loaded and return it if so
   auto iter = contents.entries.find(name);
   if (iter == contents.entries.end()) {
+    // DirContents is a complete in-memory index of this directory, so this
+    // single lookup is all it takes to conclude ENOENT; no Tree or
+    // ObjectStore access happens on a miss. Repeated probes for the same
+    // missing name (config discovery, Python import paths) are additionally
+    // absorbed by the kernel: FuseDispatcherImpl::lookup translates ENOENT
+    // into a negative dentry that the kernel caches until we invalidate the
+    // name. The counter below exists to keep the miss rate observable.
+    getMount()->getStats()->increment(&TreeInodeStats::lookupChildNotFound);
     XLOG(DBG7) << "attempted to load non-existent entry \"" << name << "\" in "
                << getLogPath();
     return std::make_optional(
@@ -345,6 +377,7 @@ ImmediateFuture<VirtualInode> TreeInode::getOrFindChild(
     const ObjectFetchContextPtr& context,
     bool loadInodes) {
   TraceBlock block("getOrFindChild");
+  getMount()->getStats()->increment(&TreeInodeStats::lookupChild);
 
 #ifndef _WIN32
   if (name == kDotEdenName && getNodeId() != kRootNodeId) {
@@ -977,6 +1010,76 @@ void TreeInode::childMaterialized(
   }
 }
 
+void TreeInode::childrenMaterialized(
+    const RenameLock& renameLock,
+    const std::vector<PathComponentPiece>& childNames) {
+  if (childNames.empty()) {
+    return;
+  }
+  auto startTime = std::chrono::system_clock::now();
+  bool wasAlreadyMaterialized;
+  {
+    auto contents = contents_.wlock();
+    wasAlreadyMaterialized = contents->isMaterialized();
+    if (!wasAlreadyMaterialized) {
+      getMount()->publishInodeTraceEvent(InodeTraceEvent(
+          startTime,
+          getNodeId(),
+          InodeType::TREE,
+          InodeEventType::MATERIALIZE,
+          InodeEventProgress::START,
+          getLocationInfo(renameLock).name));
+    }
+
+    // Mark every child materialized before deciding whether we need to
+    // rewrite our overlay data, so a batch of already-materialized children
+    // costs no overlay write at all.
+    bool anyChildChanged = false;
+    for (auto childName : childNames) {
+      auto iter = contents->entries.find(childName);
+      if (iter == contents->entries.end()) {
+        // This should never happen.
+        // We should only get called with legitimate children names.
+        EDEN_BUG() << "error attempting to materialize " << childName << " in "
+                   << getLogPath() << ": entry not present";
+      }
+
+      auto& childEntry = iter->second;
+      if (!childEntry.isMaterialized()) {
+        childEntry.setMaterialized();
+        anyChildChanged = true;
+      }
+    }
+
+    if (wasAlreadyMaterialized && !anyChildChanged) {
+      // Nothing to do
+      return;
+    }
+
+    contents->setMaterialized();
+    saveOverlayDir(contents->entries);
+  }
+
+  // Materialize parent and publish materialization event only if newly
+  // materialized
+  if (!wasAlreadyMaterialized) {
+    // If we have a parent directory, ask our parent to materialize itself
+    // and mark us materialized when it does so.
+    auto location = getLocationInfo(renameLock);
+    if (location.parent && !location.unlinked) {
+      location.parent->childMaterialized(renameLock, location.name);
+    }
+
+    getMount()->publishInodeTraceEvent(InodeTraceEvent(
+        startTime,
+        getNodeId(),
+        InodeType::TREE,
+        InodeEventType::MATERIALIZE,
+        InodeEventProgress::END,
+        location.name));
+  }
+}
+
 void TreeInode::childDematerialized(
     const RenameLock& renameLock,
     PathComponentPiece childName,
@@ -1049,6 +1152,227 @@ void TreeInode::childDematerialized(
   }
 }
 
+ImmediateFuture<folly::Unit> TreeInode::dematerializeIfUnmodified(
+    ObjectFetchContextPtr context) {
+  {
+    // Cheap check, without the rename lock, whether dematerialization is
+    // even possible. Any materialized entry means we have local changes.
+    auto contents = contents_.rlock();
+    if (!contents->isMaterialized()) {
+      return folly::unit;
+    }
+    for (const auto& entry : contents->entries) {
+      if (entry.second.isMaterialized()) {
+        return folly::unit;
+      }
+    }
+  }
+
+  auto myPath = getPath();
+  if (!myPath.has_value()) {
+    // We have already been unlinked.
+    return folly::unit;
+  }
+
+  return resolveTree(
+             getObjectStore(),
+             context,
+             getMount()->getCheckedOutRootTree(),
+             myPath.value())
+      .thenTry([self = inodePtrFromThis(), context = context.copy()](
+                   folly::Try<std::shared_ptr<const Tree>> result) mutable
+               -> ImmediateFuture<folly::Unit> {
+        if (result.hasException()) {
+          // The directory does not exist in the checked out commit, so it
+          // has to stay materialized.
+          return folly::unit;
+        }
+        auto parent = self->dematerializeIfIdentical(*result.value());
+        if (!parent) {
+          return folly::unit;
+        }
+        // Our parent now records us with a source control hash again, but
+        // had to materialize itself to do so. It may itself be identical
+        // to source control now; repeat the attempt up the chain.
+        return parent->dematerializeIfUnmodified(std::move(context));
+      });
+}
+
+TreeInodePtr TreeInode::dematerializeIfIdentical(const Tree& tree) {
+  // A Tree hash that cannot be reconstituted from the backing store must
+  // never be recorded; see the equivalent check in
+  // saveOverlayPostCheckout().
+  if (tree.getHash().size() == 0) {
+    return nullptr;
+  }
+
+  auto renameLock = getMount()->acquireRenameLock();
+  {
+    auto contents = contents_.wlock();
+    if (!contents->isMaterialized()) {
+      return nullptr;
+    }
+    if (tree.size() != contents->entries.size()) {
+      return nullptr;
+    }
+
+    // Our contents PathMap sorts paths in the same order as the Tree's
+    // entry list, so the two can be compared with one parallel walk.
+    auto inodeIter = contents->entries.begin();
+    auto scmIter = tree.begin();
+    for (; scmIter != tree.end(); ++inodeIter, ++scmIter) {
+      if (inodeIter->second.isMaterialized()) {
+        return nullptr;
+      }
+      if (inodeIter->first != scmIter->first) {
+        return nullptr;
+      }
+      switch (getObjectStore().compareObjectsById(
+          inodeIter->second.getHash(), scmIter->second.getHash())) {
+        case ObjectComparison::Unknown:
+        case ObjectComparison::Different:
+          return nullptr;
+        case ObjectComparison::Identical:
+          break;
+      }
+    }
+
+    // We are identical to the source control Tree; record its hash. The
+    // overlay data is kept (as after checkout) so that our entries retain
+    // their inode numbers.
+    contents->treeHash = tree.getHash();
+    saveOverlayDir(contents->entries);
+  }
+
+  auto loc = getLocationInfo(renameLock);
+  if (loc.parent && !loc.unlinked) {
+    loc.parent->childDematerialized(renameLock, loc.name, tree.getHash());
+    return loc.parent;
+  }
+  return nullptr;
+}
+
+#ifndef _WIN32
+ImmediateFuture<folly::Unit> TreeInode::dematerializeUnchangedFiles(
+    ObjectFetchContextPtr context) {
+  {
+    // Only materialized directories can contain materialized entries, so a
+    // non-materialized directory has nothing to fold.
+    auto contents = contents_.rlock();
+    if (!contents->isMaterialized()) {
+      return folly::unit;
+    }
+  }
+
+  auto myPath = getPath();
+  if (!myPath.has_value()) {
+    // We have already been unlinked.
+    return folly::unit;
+  }
+
+  return resolveTree(
+             getObjectStore(),
+             context,
+             getMount()->getCheckedOutRootTree(),
+             myPath.value())
+      .thenTry([self = inodePtrFromThis(), context = context.copy()](
+                   folly::Try<std::shared_ptr<const Tree>> result) mutable
+               -> ImmediateFuture<folly::Unit> {
+        if (result.hasException()) {
+          // The directory does not exist in the checked out commit; none of
+          // its entries can be folded back to source control objects.
+          return folly::unit;
+        }
+        auto tree = std::move(result).value();
+
+        // Gather candidates under the contents lock, but start the actual
+        // work only after releasing it: dematerialization acquires the
+        // rename lock, which must never be taken while holding a contents
+        // lock.
+        std::vector<TreeInodePtr> loadedDirs;
+        std::vector<std::pair<FileInodePtr, TreeEntry>> loadedFiles;
+        std::vector<PathComponent> dirsToLoad;
+        std::vector<std::pair<PathComponent, TreeEntry>> filesToLoad;
+        {
+          auto contents = self->contents_.rlock();
+          for (const auto& [name, entry] : contents->entries) {
+            if (entry.isDirectory()) {
+              // Materialization propagates upwards, so a non-materialized
+              // child directory cannot contain materialized descendants.
+              if (!entry.isMaterialized()) {
+                continue;
+              }
+              if (auto child = entry.asTreePtrOrNull()) {
+                loadedDirs.emplace_back(std::move(child));
+              } else {
+                dirsToLoad.emplace_back(name);
+              }
+              continue;
+            }
+
+            if (!entry.isMaterialized()) {
+              continue;
+            }
+            auto scmIter = tree->find(name);
+            if (scmIter == tree->cend() || scmIter->second.isTree()) {
+              continue;
+            }
+            if (auto child = entry.asFilePtrOrNull()) {
+              loadedFiles.emplace_back(std::move(child), scmIter->second);
+            } else {
+              filesToLoad.emplace_back(name, scmIter->second);
+            }
+          }
+        }
+
+        std::vector<ImmediateFuture<folly::Unit>> futures;
+        futures.reserve(
+            loadedDirs.size() + loadedFiles.size() + dirsToLoad.size() +
+            filesToLoad.size());
+        for (const auto& child : loadedDirs) {
+          futures.push_back(child->dematerializeUnchangedFiles(context.copy()));
+        }
+        for (const auto& fileEntry : loadedFiles) {
+          futures.push_back(fileEntry.first->dematerializeIfUnchanged(
+              fileEntry.second.getHash(), fileEntry.second.getType(), context));
+        }
+        for (const auto& name : dirsToLoad) {
+          futures.push_back(
+              self->getOrLoadChildTree(name, context)
+                  .thenValue([context = context.copy()](TreeInodePtr child) {
+                    return child->dematerializeUnchangedFiles(
+                        std::move(context));
+                  }));
+        }
+        for (const auto& fileToLoad : filesToLoad) {
+          futures.push_back(
+              self->getOrLoadChild(fileToLoad.first, context)
+                  .thenValue([context = context.copy(),
+                              scmEntry = fileToLoad.second](
+                                 InodePtr child) mutable
+                             -> ImmediateFuture<folly::Unit> {
+                    auto file = child.asFilePtrOrNull();
+                    if (!file) {
+                      return folly::unit;
+                    }
+                    return file->dematerializeIfUnchanged(
+                        scmEntry.getHash(),
+                        scmEntry.getType(),
+                        context);
+                  }));
+        }
+
+        return collectAll(std::move(futures))
+            .thenValue([self, context = context.copy()](
+                           std::vector<folly::Try<folly::Unit>>&&) mutable {
+              // With unchanged files folded back, this directory itself may
+              // now be identical to its source control Tree.
+              return self->dematerializeIfUnmodified(std::move(context));
+            });
+      });
+}
+#endif // !_WIN32
+
 Overlay* TreeInode::getOverlay() const {
   return getMount()->getOverlay();
 }
@@ -1089,20 +1413,28 @@ DirContents TreeInode::buildDirFromTree(
     bool windowsSymlinksEnabled) {
   XCHECK(tree);
 
-  // A future optimization is for this code to allocate all of the inode numbers
-  // at once and then dole them out, one per entry. It would reduce the number
-  // of atomic operations from N to 1, though if the atomic is issued with the
-  // other work this loop is doing it may not matter much.
-
   DirContents dir(caseSensitive);
-  // TODO: O(N^2)
+  // Reserve the exact entry count up front: these DirContents stay resident
+  // for as long as the TreeInode is loaded, so growth slack from incremental
+  // reallocation would be held for the lifetime of the inode.
+  dir.reserve(tree->size());
+  // Allocate every entry's inode number with one atomic operation and dole
+  // them out, rather than bumping the shared counter (and its checkpoint
+  // tracking) once per entry.
+  auto nextInode = tree->size() == 0
+      ? InodeNumber{}
+      : overlay->allocateInodeNumberRange(tree->size());
+  // Tree entries are sorted, so each emplaceSorted is an append on
+  // case-sensitive mounts. Case-insensitive ordering can differ, in which
+  // case it degrades to a regular emplace for the affected entries.
   for (const auto& treeEntry : *tree) {
-    dir.emplace(
+    dir.emplaceSorted(
         treeEntry.first,
         modeFromTreeEntryType(filteredEntryType(
             treeEntry.second.getType(), windowsSymlinksEnabled)),
-        overlay->allocateInodeNumber(),
+        nextInode,
         treeEntry.second.getHash());
+    nextInode = InodeNumber{nextInode.get() + 1};
   }
   return dir;
 }
@@ -1428,7 +1760,8 @@ ImmediateFuture<folly::Unit> TreeInode::rmdir(
 void TreeInode::removeAllChildrenRecursively(
     InvalidationRequired invalidate,
     const ObjectFetchContextPtr& context,
-    const RenameLock& renameLock) {
+    const RenameLock& renameLock,
+    std::vector<FileChangeJournalDelta>& removedPaths) {
   // TODO: Unconditional materialization is slightly conservative. If the
   // BackingStore Tree is empty, then this function can return without
   // materializing.
@@ -1452,11 +1785,14 @@ void TreeInode::removeAllChildrenRecursively(
 
   // Step 2, Clear contents in the child folders
   for (auto& treeNode : loadedTreeNodes) {
-    treeNode->removeAllChildrenRecursively(invalidate, context, renameLock);
+    treeNode->removeAllChildrenRecursively(
+        invalidate, context, renameLock, removedPaths);
   }
 
   loadedTreeNodes.clear();
 
+  auto myPath = getPath();
+
   // Step 3, Now all child nodes are removable, unless one of the directories
   // had a new entry added while the contents lock was not held.
   auto contents = contents_.wlock();
@@ -1491,6 +1827,10 @@ void TreeInode::removeAllChildrenRecursively(
       auto inode = it->second.getInode();
       inode->markUnlinked(this, it->first, renameLock);
     }
+    if (myPath.has_value()) {
+      removedPaths.emplace_back(
+          myPath.value() + it->first, FileChangeJournalDelta::REMOVED);
+    }
     // Erase from contents must happen right after markUnlink
     it = contents->entries.erase(it);
 
@@ -1564,8 +1904,16 @@ ImmediateFuture<folly::Unit> TreeInode::removeRecursivelyNoFlushInvalidation(
   } else {
     {
       auto renameLock = inodePtrFromThis()->getMount()->acquireRenameLock();
+      // Journal the whole recursive removal as a single batch: one journal
+      // lock acquisition and one subscriber notification instead of one per
+      // removed file. Record whatever accumulated even if the removal stops
+      // partway through, since those entries are already gone.
+      std::vector<FileChangeJournalDelta> removedPaths;
+      SCOPE_EXIT {
+        getMount()->getJournal().recordBatch(std::move(removedPaths));
+      };
       child.asTreePtr()->removeAllChildrenRecursively(
-          invalidate, context, renameLock);
+          invalidate, context, renameLock, removedPaths);
     }
     return inodePtrFromThis()->removeImpl<TreeInodePtr>(
         PathComponent{name}, std::move(child), invalidate, 1, context);
@@ -1587,6 +1935,27 @@ ImmediateFuture<folly::Unit> TreeInode::removeRecursively(
           });
 }
 
+namespace {
+
+/**
+ * Check whether a file name matches one of the configured
+ * experimental:volatile-file-patterns globs. The compiled patterns come
+ * from GlobMatcher's process-wide cache, so this is cheap enough for the
+ * unlink path; with the default empty pattern list it is a single vector
+ * size check.
+ */
+bool isVolatileFileName(const EdenConfig& config, PathComponentPiece name) {
+  for (const auto& pattern : config.volatileFilePatterns.getValue()) {
+    auto matcher = GlobMatcher::createCached(pattern, GlobOptions::DEFAULT);
+    if (matcher.hasValue() && matcher->match(name.view())) {
+      return true;
+    }
+  }
+  return false;
+}
+
+} // namespace
+
 template <typename InodePtrType>
 ImmediateFuture<folly::Unit> TreeInode::removeImpl(
     PathComponent name,
@@ -1637,6 +2006,21 @@ ImmediateFuture<folly::Unit> TreeInode::removeImpl(
     // Record the change in the journal.
     getMount()->getJournal().recordRemoved(targetName);
 
+    // If the removed file was a build tool's scratch file, this directory
+    // may now match source control again; try to dematerialize it in the
+    // background so scratch traffic does not leave it permanently
+    // materialized.
+    if constexpr (std::is_same_v<InodePtrType, FileInodePtr>) {
+      if (isVolatileFileName(*getMount()->getEdenConfig(), name)) {
+        folly::via(
+            getMount()->getServerThreadPool().get(),
+            [self = inodePtrFromThis(), context = context.copy()]() mutable {
+              return self->dematerializeIfUnmodified(std::move(context))
+                  .semi();
+            });
+      }
+    }
+
     return folly::unit;
   }
 
@@ -2276,8 +2660,10 @@ bool TreeInode::readdirImpl(
    *
    * Today, Eden does not support hard links. Therefore, in the short term, we
    * can store inode numbers in off_t and treat them as an index into an
-   * inode-sorted list of entries. This has quadratic time complexity without an
-   * additional index but is correct.
+   * inode-sorted list of entries. A naive implementation of that is
+   * quadratic across a full listing, so each stream's remaining entries are
+   * cached on the inode and continuations resume from the cache in O(1);
+   * only a cache miss pays for rescanning the directory.
    *
    * In the long term, especially when Eden's tree directory structure is stored
    * in SQLite or something similar, we should maintain a seekdir/readdir cookie
@@ -2327,34 +2713,93 @@ bool TreeInode::readdirImpl(
     }
   }
 
-  auto dir = contents_.rlock();
-  auto& entries = dir->entries;
+  // The offset of every real entry is its inode number plus 2, so once "."
+  // and ".." have been emitted the stream is logically at offset 2.
+  off = std::max<off_t>(off, 2);
 
-  // Compute an index into the PathMap by InodeNumber, only including the
-  // entries that are greater than the given offset.
-  std::vector<std::pair<InodeNumber, size_t>> indices;
-  indices.reserve(entries.size());
-  size_t index = 0;
-  for (auto& entry : entries) {
-    auto inodeNumber = entry.second.getInodeNumber();
-    if (static_cast<off_t>(inodeNumber.get() + 2) > off) {
-      indices.emplace_back(entry.second.getInodeNumber(), index);
+  // Fast path: resume the cursor cached by a previous call if this one
+  // continues the same stream. A fresh listing (off == 2) always rebuilds
+  // so it reflects the directory's current contents. The callbacks only
+  // serialize into the response buffer, so holding the cursor lock across
+  // them is fine; contents_ is never held here.
+  {
+    auto cursor = readdirCursor_.lock();
+    if (*cursor && off > 2 && (*cursor)->nextOffset == off) {
+      auto& state = **cursor;
+      auto startIndex = state.index;
+      while (state.index < state.entries.size()) {
+        auto& entry = state.entries[state.index];
+        if (!add(
+                entry.name.view(),
+                DirEntry{dtype_to_mode(entry.dtype), entry.inodeNumber},
+                entry.inodeNumber.get() + 2)) {
+          return false;
+        }
+        state.nextOffset = static_cast<off_t>(entry.inodeNumber.get() + 2);
+        ++state.index;
+      }
+      if (state.index == startIndex) {
+        // This was the end-of-stream probe of a fully drained stream;
+        // release the cursor. Keeping it until now lets the probe itself
+        // answer from the cache instead of rescanning the directory.
+        cursor->reset();
+      }
+      return true;
     }
-    ++index;
   }
-  std::make_heap(indices.begin(), indices.end(), std::greater<>{});
 
-  // The provided FuseDirList has limited space. Add entries until no more fit.
-  while (!indices.empty()) {
-    std::pop_heap(indices.begin(), indices.end(), std::greater<>{});
-    auto& [name, entry] = entries.begin()[indices.back().second];
-    indices.pop_back();
+  // Copy the entries past the given offset out of contents_, then sort and
+  // emit them only after the lock is released: the callback serializes into
+  // the response buffer, and holding contents_ across that would hold off a
+  // waiting writer (and, with writer priority, any new reader) for the
+  // duration of the response. Emitting from a snapshot preserves the POSIX
+  // semantics described above: every entry left unmodified for the whole
+  // stream is returned exactly once, and entries added or removed in the
+  // middle of the stream may or may not appear.
+  auto snapshot = std::make_unique<ReaddirCursor>();
+  {
+    auto dir = contents_.rlock();
+    auto& entries = dir->entries;
+    snapshot->entries.reserve(entries.size());
+    for (auto& [name, entry] : entries) {
+      auto inodeNumber = entry.getInodeNumber();
+      if (static_cast<off_t>(inodeNumber.get() + 2) > off) {
+        snapshot->entries.push_back(
+            ReaddirCursor::Entry{name, entry.getDtype(), inodeNumber});
+      }
+    }
+  }
+  std::sort(
+      snapshot->entries.begin(),
+      snapshot->entries.end(),
+      [](const ReaddirCursor::Entry& lhs, const ReaddirCursor::Entry& rhs) {
+        return lhs.inodeNumber < rhs.inodeNumber;
+      });
 
-    if (!add(name.view(), entry, entry.getInodeNumber().get() + 2)) {
+  // The provided FuseDirList has limited space. Add entries until no more
+  // fit. The callbacks only look at the inode number and dtype, so a
+  // DirEntry reconstructed from the copied data is equivalent to the
+  // original.
+  while (snapshot->index < snapshot->entries.size()) {
+    auto& entry = snapshot->entries[snapshot->index];
+    if (!add(
+            entry.name.view(),
+            DirEntry{dtype_to_mode(entry.dtype), entry.inodeNumber},
+            entry.inodeNumber.get() + 2)) {
+      // Stash the remaining entries, keyed by the last emitted offset, so
+      // the next continuation resumes in O(1). This may replace the cursor
+      // of a concurrent stream over the same directory; that stream then
+      // rebuilds its snapshot, which is no worse than not caching at all.
+      *readdirCursor_.lock() = std::move(snapshot);
       return false;
     }
+    snapshot->nextOffset = static_cast<off_t>(entry.inodeNumber.get() + 2);
+    ++snapshot->index;
   }
 
+  // The stream is complete. Drop any cursor left behind by an abandoned
+  // stream so it does not pin a large snapshot.
+  readdirCursor_.lock()->reset();
   return true;
 }
 
@@ -2380,7 +2825,6 @@ std::tuple<NfsDirList, bool> TreeInode::nfsReaddir(
     NfsDirList&& list,
     off_t off,
     const ObjectFetchContextPtr& context) {
-  updateAtime();
   bool isEof = readdirImpl(
       off,
       context,
@@ -2992,17 +3436,21 @@ ImmediateFuture<Unit> TreeInode::computeDiff(
     load.finish();
   }
 
-  // Now process all of the deferred work.
-  std::vector<ImmediateFuture<Unit>> deferredFutures;
-  for (auto& entry : deferredEntries) {
-    deferredFutures.push_back(entry->run());
-  }
+  // Now process all of the deferred work. Cheap single-object comparisons
+  // run ahead of recursive subtree walks, and if a concurrency bound is
+  // configured, at most that many of this directory's deferred entries are
+  // in flight at once. The results line up with deferredEntries (which may
+  // have been reordered), so errors below can be attributed to the right
+  // entry.
+  auto deferredFuture = runDeferredDiffEntries(
+      deferredEntries,
+      getMount()->getEdenConfig()->maxConcurrentDiffEntries.getValue());
 
   // Wait on all of the deferred entries to complete.
-  // Note that we explicitly move-capture the deferredFutures vector into this
+  // Note that we explicitly move-capture the deferredEntries vector into this
   // callback, to ensure that the DeferredDiffEntry objects do not get
   // destroyed before they complete.
-  return collectAll(std::move(deferredFutures))
+  return std::move(deferredFuture)
       .thenValue([self = std::move(self),
                   currentPath = RelativePath{std::move(currentPath)},
                   context,
@@ -3061,17 +3509,42 @@ Future<Unit> TreeInode::checkout(
     load.finish();
   }
 
-  // Now start all of the checkout actions
-  vector<Future<InvalidationRequired>> actionFutures;
-  for (const auto& action : actions) {
-    actionFutures.emplace_back(action->run(ctx, &getObjectStore()));
-  }
+  // Now start the checkout actions. All children run in parallel; if a
+  // concurrency bound is configured, at most that many actions of this
+  // directory are in flight at once and the rest start as earlier ones
+  // finish. The result order always matches `actions` so errors below can be
+  // attributed to the right entry.
+  auto maxConcurrentActions =
+      getMount()->getEdenConfig()->maxConcurrentCheckoutActions.getValue();
+  folly::SemiFuture<vector<folly::Try<facebook::eden::InvalidationRequired>>>
+      collectFuture = [&] {
+        if (maxConcurrentActions == 0 ||
+            actions.size() <= maxConcurrentActions) {
+          vector<Future<InvalidationRequired>> actionFutures;
+          actionFutures.reserve(actions.size());
+          for (const auto& action : actions) {
+            actionFutures.emplace_back(action->run(ctx, &getObjectStore()));
+          }
+          return folly::collectAll(actionFutures);
+        }
+
+        std::vector<CheckoutAction*> pendingActions;
+        pendingActions.reserve(actions.size());
+        for (const auto& action : actions) {
+          pendingActions.push_back(action.get());
+        }
+        auto* store = &getObjectStore();
+        return folly::collectAll(folly::window(
+            std::move(pendingActions),
+            [ctx, store](CheckoutAction* action) {
+              return action->run(ctx, store);
+            },
+            maxConcurrentActions));
+      }();
 
   ImmediateFuture<Unit> faultFuture =
       getMount()->getServerState()->getFaultInjector().checkAsync(
           "TreeInode::checkout", getLogPath(), ctx->isDryRun());
-  folly::SemiFuture<vector<folly::Try<facebook::eden::InvalidationRequired>>>
-      collectFuture = folly::collectAll(actionFutures);
 
   // Wait for all of the actions, and record any errors.
   return std::move(faultFuture)
@@ -4267,16 +4740,49 @@ ImmediateFuture<uint64_t> TreeInode::invalidateChildrenNotMaterialized(
   }
 
   return getLoadedOrRememberedTreeChildren(this, getInodeMap(), context)
-      .thenValue([context = context.copy(),
-                  cutoff](std::vector<TreeInodePtr> treeChildren) {
-        std::vector<ImmediateFuture<uint64_t>> futures;
+      .thenValue([self = inodePtrFromThis(), context = context.copy(), cutoff](
+                     std::vector<TreeInodePtr> treeChildren)
+                     -> ImmediateFuture<std::vector<uint64_t>> {
+        auto maxConcurrentWalks =
+            self->getMount()
+                ->getEdenConfig()
+                ->maxConcurrentInvalidationWalks.getValue();
+        if (maxConcurrentWalks == 0 ||
+            treeChildren.size() <= maxConcurrentWalks) {
+          std::vector<ImmediateFuture<uint64_t>> futures;
+
+          for (auto& tree : treeChildren) {
+            futures.push_back(
+                tree->invalidateChildrenNotMaterialized(cutoff, context));
+          }
 
-        for (auto& tree : treeChildren) {
-          futures.push_back(
-              tree->invalidateChildrenNotMaterialized(cutoff, context));
+          return collectAllSafe(std::move(futures));
         }
 
-        return collectAllSafe(std::move(futures));
+        // With a concurrency bound configured, child subtree walks are
+        // scheduled on the server thread pool at most maxConcurrentWalks at
+        // a time. Large walks then run in parallel across cores, and the
+        // executor hop between subtrees keeps a whole-mount invalidation
+        // from monopolizing the calling thread.
+        auto* threadPool =
+            self->getMount()->getServerState()->getThreadPool().get();
+        return folly::collectAll(folly::window(
+                   folly::getKeepAliveToken(threadPool),
+                   std::move(treeChildren),
+                   [cutoff, context = context.copy()](TreeInodePtr tree) {
+                     return tree
+                         ->invalidateChildrenNotMaterialized(cutoff, context)
+                         .semi();
+                   },
+                   maxConcurrentWalks))
+            .deferValue([](std::vector<folly::Try<uint64_t>> tries) {
+              std::vector<uint64_t> counts;
+              counts.reserve(tries.size());
+              for (auto& t : tries) {
+                counts.push_back(std::move(t).value());
+              }
+              return counts;
+            });
       })
       .thenValue([self = inodePtrFromThis(),
                   cutoff](const std::vector<uint64_t>& invalidatedCounts) {
@@ -4543,11 +5049,18 @@ void TreeInode::childWasStat(bool isFile, const ObjectFetchContext& context) {
       std::memory_order_acq_rel,
       std::memory_order_acquire));
 
+  // We just observed a readdir followed by a child stat. Under the adaptive
+  // policy, remember it so future readdirs of this directory can prefetch
+  // immediately; see considerReaddirPrefetch().
+  auto config = getMount()->getServerState()->getEdenConfig();
+  if (config->readdirPrefetch.getValue() == ReaddirPrefetch::Adaptive) {
+    getMount()->recordReaddirFollowedByChildAccess(getNodeId());
+  }
+
   doPrefetch(prefetchSet, context);
 }
 
-void TreeInode::considerReaddirPrefetch(
-    const ObjectFetchContextPtr& /*context*/) {
+void TreeInode::considerReaddirPrefetch(const ObjectFetchContextPtr& context) {
   auto currentState = prefetchState_.load(std::memory_order_relaxed);
   switch (currentState) {
     case NeverEnumerated:
@@ -4562,6 +5075,23 @@ void TreeInode::considerReaddirPrefetch(
       return;
   }
 
+  // Under the adaptive policy, a directory whose past readdirs were
+  // followed by child accesses starts prefetching at readdir time instead
+  // of waiting for childWasStat() to re-observe the pattern, saving the
+  // latency of the first child's cold stat.
+  auto config = getMount()->getServerState()->getEdenConfig();
+  if (config->readdirPrefetch.getValue() == ReaddirPrefetch::Adaptive &&
+      getMount()->wasReaddirFollowedByChildAccess(getNodeId())) {
+    if (prefetchState_.compare_exchange_strong(
+            currentState,
+            PrefetchedAll,
+            std::memory_order_acq_rel,
+            std::memory_order_acquire)) {
+      doPrefetch(PrefetchFiles | PrefetchTrees, *context);
+    }
+    return;
+  }
+
   if (!prefetchState_.compare_exchange_strong(
           currentState,
           Enumerated,
@@ -4592,6 +5122,11 @@ void TreeInode::doPrefetch(
       break;
     case ReaddirPrefetch::Both:
       break;
+    case ReaddirPrefetch::Adaptive:
+      // Gating happened at trigger time: prefetch-at-readdir required
+      // history, and the childWasStat() fallback both seeds the history and
+      // prefetches like Both would.
+      break;
   }
   if (!prefetchSet) {
     XLOG(DBG4) << "skipping prefetch for " << getLogPath()
@@ -26,6 +26,7 @@ class DiffContext;
 class FuseDirList;
 class NfsDirList;
 class EdenMount;
+class FileChangeJournalDelta;
 class GitIgnoreStack;
 class DiffCallback;
 class InodeMap;
@@ -267,11 +268,16 @@ class TreeInode final : public InodeBaseMetadata<DirContents> {
    * Attempts to remove and unlink children of this inode. Under concurrent
    * modification, it is not guaranteed that TreeInode is empty after this
    * function returns.
+   *
+   * Removed paths are appended to removedPaths rather than journaled here,
+   * so the caller can record the whole recursive removal as one batch
+   * instead of taking the journal lock per file.
    */
   void removeAllChildrenRecursively(
       InvalidationRequired invalidate,
       const ObjectFetchContextPtr& context,
-      const RenameLock& renameLock);
+      const RenameLock& renameLock,
+      std::vector<FileChangeJournalDelta>& removedPaths);
 
   /**
    * For unloaded nodes, the removal should be simpler: remove the node
@@ -376,6 +382,24 @@ class TreeInode final : public InodeBaseMetadata<DirContents> {
       const RenameLock& renameLock,
       PathComponentPiece childName);
 
+  /**
+   * Update this directory when several child entries are materialized at
+   * once.
+   *
+   * This behaves like calling childMaterialized() once per name in
+   * childNames, but writes this directory's overlay data once and walks the
+   * parent chain at most once, rather than per child. Bulk writers that
+   * materialize many entries under one directory should prefer this to avoid
+   * rewriting the directory's overlay data for every child.
+   *
+   * The same preconditions as childMaterialized() apply to every name in
+   * childNames: each child must have written out its own overlay data before
+   * this method is called, and no child locks may be held.
+   */
+  void childrenMaterialized(
+      const RenameLock& renameLock,
+      const std::vector<PathComponentPiece>& childNames);
+
   /**
    * Update this directory when a child entry is dematerialized.
    *
@@ -395,6 +419,40 @@ class TreeInode final : public InodeBaseMetadata<DirContents> {
       PathComponentPiece childName,
       ObjectId childScmHash);
 
+  /**
+   * Try to dematerialize this directory outside of a checkout operation.
+   *
+   * If every entry is identical to the source control Tree at this
+   * directory's path, records the Tree's hash and tells the parent to
+   * dematerialize this entry, then repeats the attempt on the parent.
+   * Does nothing if the directory has any local changes, materialized
+   * children, or no corresponding Tree in the checked out commit.
+   *
+   * This is invoked in the background after unlinking files that match
+   * the experimental:volatile-file-patterns config setting, so scratch
+   * files created and deleted by build tools do not leave their parent
+   * directories permanently materialized.
+   */
+  ImmediateFuture<folly::Unit> dematerializeIfUnmodified(
+      ObjectFetchContextPtr context);
+
+#ifndef _WIN32
+  /**
+   * Recursively fold materialized files whose contents still match their
+   * source control blob back to the unmaterialized state, then try to
+   * dematerialize this directory itself.
+   *
+   * Build tools commonly touch files and later restore their original
+   * contents; without this, those inodes stay materialized forever.  This
+   * walk hashes candidate files (via FileInode::dematerializeIfUnchanged)
+   * and is therefore IO-heavy: it is only run from the periodic working
+   * copy garbage collection task, gated on the
+   * experimental:dematerialize-unchanged-files config setting.
+   */
+  ImmediateFuture<folly::Unit> dematerializeUnchangedFiles(
+      ObjectFetchContextPtr context);
+#endif // !_WIN32
+
   /**
    * Internal API only for use by InodeMap.
    *
@@ -806,6 +864,17 @@ class TreeInode final : public InodeBaseMetadata<DirContents> {
 
   void saveOverlayPostCheckout(CheckoutContext* ctx, const Tree* tree);
 
+  /**
+   * Synchronous half of dematerializeIfUnmodified(): compare this
+   * directory's entries to the given source control Tree and, if every
+   * entry is identical, record the Tree's hash and dematerialize this
+   * entry in the parent directory.
+   *
+   * Returns the parent TreeInode if this directory was dematerialized (so
+   * the caller can repeat the attempt up the chain), or null otherwise.
+   */
+  TreeInodePtr dematerializeIfIdentical(const Tree& tree);
+
   /**
    * Send a request to the kernel to invalidate its directory cache for this
    * inode.  This is required when the child entry list has changed.
@@ -902,6 +971,19 @@ class TreeInode final : public InodeBaseMetadata<DirContents> {
 
   folly::Synchronized<TreeInodeState> contents_;
 
+  struct ReaddirCursor;
+
+  /**
+   * Continuation state for an in-progress readdir stream, letting the next
+   * readdir call resume iteration in O(1) instead of rescanning the
+   * directory. Readdir offsets are inode numbers, so a missed cursor only
+   * costs rebuilding the snapshot; correctness never depends on this
+   * cache. At most one stream's remaining entries are held; concurrent
+   * listings of the same directory fall back to the rebuild path.
+   */
+  folly::Synchronized<std::unique_ptr<ReaddirCursor>, std::mutex>
+      readdirCursor_;
+
   /**
    * Valid state transitions:
    *   NeverEnumerated -> Enumerated
@@ -215,6 +215,23 @@ ImmediateFuture<BlobMetadata> VirtualInode::getBlobMetadata(
       });
 }
 
+ImmediateFuture<uint64_t> VirtualInode::getSize(
+    RelativePathPiece path,
+    const std::shared_ptr<ObjectStore>& objectStore,
+    const ObjectFetchContextPtr& fetchContext) const {
+  return match(
+      variant_,
+      [&](const InodePtr& inode) {
+        return inode.asFilePtr()->getSize(fetchContext);
+      },
+      [&](const TreePtr&) {
+        return makeImmediateFuture<uint64_t>(PathError(EISDIR, path));
+      },
+      [&](auto& entry) {
+        return objectStore->getBlobSize(entry.getObjectId(), fetchContext);
+      });
+}
+
 EntryAttributes VirtualInode::getEntryAttributesForNonFile(
     EntryAttributeFlags requestedAttributes,
     RelativePathPiece path,
@@ -300,17 +317,21 @@ ImmediateFuture<EntryAttributes> VirtualInode::getEntryAttributes(
         getTreeEntryType(path, fetchContext, windowsSymlinksEnabled);
   }
   auto blobMetadataFuture = ImmediateFuture<BlobMetadata>{
-      PathError{EINVAL, path, "neither sha1 nor size requested"}};
-  // sha1, blake3 and size come together so, there isn't much point of splitting
-  // them up
+      PathError{EINVAL, path, "neither sha1 nor blake3 requested"}};
+  auto sizeFuture =
+      ImmediateFuture<uint64_t>{PathError{EINVAL, path, "size not requested"}};
+  // sha1, blake3 and size are stored together, so when a hash is wanted the
+  // size comes along for free.  When only the size is wanted, resolve it on
+  // its own so the request never fetches blob contents or computes hashes.
   if (requestedAttributes.containsAnyOf(
-          ENTRY_ATTRIBUTE_SIZE | ENTRY_ATTRIBUTE_SHA1 |
-          ENTRY_ATTRIBUTE_BLAKE3)) {
+          ENTRY_ATTRIBUTE_SHA1 | ENTRY_ATTRIBUTE_BLAKE3)) {
     blobMetadataFuture = getBlobMetadata(
         path,
         objectStore,
         fetchContext,
         requestedAttributes.contains(ENTRY_ATTRIBUTE_BLAKE3));
+  } else if (requestedAttributes.contains(ENTRY_ATTRIBUTE_SIZE)) {
+    sizeFuture = getSize(path, objectStore, fetchContext);
   }
 
   std::optional<ObjectId> objectId;
@@ -318,14 +339,18 @@ ImmediateFuture<EntryAttributes> VirtualInode::getEntryAttributes(
     objectId = getObjectId();
   }
 
-  return collectAll(std::move(entryTypeFuture), std::move(blobMetadataFuture))
+  return collectAll(
+             std::move(entryTypeFuture),
+             std::move(blobMetadataFuture),
+             std::move(sizeFuture))
       .thenValue(
           [requestedAttributes, entryObjectId = std::move(objectId)](
               std::tuple<
                   folly::Try<std::optional<TreeEntryType>>,
-                  folly::Try<BlobMetadata>> rawAttributeData) mutable
+                  folly::Try<BlobMetadata>,
+                  folly::Try<uint64_t>> rawAttributeData) mutable
           -> EntryAttributes {
-            auto& [entryType, blobMetadata] = rawAttributeData;
+            auto& [entryType, blobMetadata, sizeOnly] = rawAttributeData;
 
             std::optional<folly::Try<Hash20>> sha1;
             if (requestedAttributes.contains(ENTRY_ATTRIBUTE_SHA1)) {
@@ -339,13 +364,6 @@ ImmediateFuture<EntryAttributes> VirtualInode::getEntryAttributes(
               if (blobMetadata.hasException()) {
                 blake3 = folly::Try<Hash32>(blobMetadata.exception());
               } else {
-                if (blobMetadata.value().blake3) {
-                  blake3 =
-                      folly::Try<Hash32>(blobMetadata.value().blake3.value());
-                } else {
-                  blake3 =
-                      folly::Try<Hash32>(blobMetadata.value().blake3.value());
-                }
                 blake3 = blobMetadata.value().blake3
                     ? folly::Try<Hash32>(blobMetadata.value().blake3.value())
                     : folly::Try<Hash32>(
@@ -356,9 +374,14 @@ ImmediateFuture<EntryAttributes> VirtualInode::getEntryAttributes(
 
             std::optional<folly::Try<uint64_t>> size;
             if (requestedAttributes.contains(ENTRY_ATTRIBUTE_SIZE)) {
-              size = blobMetadata.hasException()
-                  ? folly::Try<uint64_t>(blobMetadata.exception())
-                  : folly::Try<uint64_t>(blobMetadata.value().size);
+              if (requestedAttributes.containsAnyOf(
+                      ENTRY_ATTRIBUTE_SHA1 | ENTRY_ATTRIBUTE_BLAKE3)) {
+                size = blobMetadata.hasException()
+                    ? folly::Try<uint64_t>(blobMetadata.exception())
+                    : folly::Try<uint64_t>(blobMetadata.value().size);
+              } else {
+                size = std::move(sizeOnly);
+              }
             }
 
             std::optional<folly::Try<std::optional<TreeEntryType>>> type;
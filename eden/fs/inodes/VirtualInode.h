@@ -188,6 +188,15 @@ class VirtualInode {
       const ObjectFetchContextPtr& fetchContext,
       bool blake3Required = false) const;
 
+  /**
+   * Helper function for getEntryAttributes: resolve only the file size,
+   * without fetching blob contents or computing hashes.
+   */
+  ImmediateFuture<uint64_t> getSize(
+      RelativePathPiece path,
+      const std::shared_ptr<ObjectStore>& objectStore,
+      const ObjectFetchContextPtr& fetchContext) const;
+
   EntryAttributes getEntryAttributesForNonFile(
       EntryAttributeFlags requestedAttributes,
       RelativePathPiece path,
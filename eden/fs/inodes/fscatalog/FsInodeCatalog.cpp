@@ -13,6 +13,7 @@
 #include <algorithm>
 #include <chrono>
 
+#include <folly/Conv.h>
 #include <folly/Exception.h>
 #include <folly/File.h>
 #include <folly/FileUtil.h>
@@ -48,6 +49,7 @@ using std::string;
  */
 constexpr StringPiece kInfoFile{"info"};
 constexpr const char* kNextInodeNumberFile{"next-inode-number"};
+constexpr const char* kInodeNumberCheckpointFile{"inode-number-checkpoint"};
 
 /**
  * 4-byte magic identifier to put at the start of the info file.
@@ -168,6 +170,9 @@ void FsFileContentStore::close() {
 void FsInodeCatalog::close(std::optional<InodeNumber> inodeNumber) {
   if (inodeNumber) {
     core_->saveNextInodeNumber(inodeNumber.value());
+    // The next-inode-number file supersedes any checkpoint written while
+    // running; remove it so a stale bound cannot be trusted by a future run.
+    core_->removeInodeNumberCheckpoint();
   }
   core_->close();
 }
@@ -218,6 +223,42 @@ std::optional<InodeNumber> FsFileContentStore::tryLoadNextInodeNumber() {
   return InodeNumber{nextInodeNumber};
 }
 
+InodeNumber FsFileContentStore::scanForNextInodeNumber() {
+  uint64_t maxInode = kRootNodeId.get();
+
+  std::array<char, kShardDirPathLength + 1> subdirPath;
+  subdirPath[kShardDirPathLength] = '\0';
+  MutableStringPiece subdirStringPiece{subdirPath.data(), kShardDirPathLength};
+  for (ShardID shardID = 0; shardID < kNumShards; ++shardID) {
+    formatSubdirShardPath(shardID, subdirStringPiece);
+    auto path = localDir_ + PathComponentPiece{StringPiece{subdirPath.data()}};
+
+    boost::system::error_code error;
+    auto iterator = boost::filesystem::directory_iterator(
+        boost::filesystem::path{path.value().c_str()}, error);
+    if (error.value() != 0) {
+      folly::throwSystemErrorExplicit(
+          error.value(), "error enumerating overlay shard ", path.view());
+    }
+    auto endIterator = boost::filesystem::directory_iterator();
+    while (iterator != endIterator) {
+      // Entries with non-numeric names are left alone here; a full
+      // OverlayChecker scan is responsible for reporting them.
+      auto entryInodeNumber =
+          folly::tryTo<uint64_t>(iterator->path().filename().string());
+      if (entryInodeNumber.hasValue() && *entryInodeNumber > maxInode) {
+        maxInode = *entryInodeNumber;
+      }
+      iterator.increment(error);
+      if (error.value() != 0) {
+        folly::throwSystemErrorExplicit(
+            error.value(), "error enumerating overlay shard ", path.view());
+      }
+    }
+  }
+  return InodeNumber{maxInode + 1};
+}
+
 void FsFileContentStore::saveNextInodeNumber(InodeNumber nextInodeNumber) {
   auto nextInodeNumberPath =
       localDir_ + PathComponentPiece{kNextInodeNumberFile};
@@ -231,6 +272,51 @@ void FsFileContentStore::saveNextInodeNumber(InodeNumber nextInodeNumber) {
       .value();
 }
 
+void FsFileContentStore::saveInodeNumberCheckpoint(InodeNumber bound) {
+  auto checkpointPath =
+      localDir_ + PathComponentPiece{kInodeNumberCheckpointFile};
+
+  auto boundVal = bound.get();
+  writeFileAtomic(
+      checkpointPath,
+      ByteRange(
+          reinterpret_cast<const uint8_t*>(&boundVal),
+          reinterpret_cast<const uint8_t*>(&boundVal + 1)))
+      .value();
+}
+
+std::optional<InodeNumber> FsFileContentStore::tryLoadInodeNumberCheckpoint() {
+  int fd =
+      openat(dirFile_.fd(), kInodeNumberCheckpointFile, O_RDONLY | O_CLOEXEC);
+  if (fd == -1) {
+    if (errno == ENOENT) {
+      return std::nullopt;
+    }
+    folly::throwSystemError("Failed to open ", kInodeNumberCheckpointFile);
+  }
+  folly::File checkpointFile{fd, /* ownsFd */ true};
+
+  uint64_t bound;
+  auto readResult = folly::readFull(fd, &bound, sizeof(bound));
+  if (readResult < 0) {
+    folly::throwSystemError(
+        "Failed to read ", kInodeNumberCheckpointFile, " from overlay");
+  }
+  if (readResult != sizeof(bound) || bound <= kRootNodeId.get()) {
+    XLOG(WARN) << "Ignoring invalid inode number checkpoint in " << localDir_;
+    return std::nullopt;
+  }
+  return InodeNumber{bound};
+}
+
+void FsFileContentStore::removeInodeNumberCheckpoint() {
+  if (unlinkat(dirFile_.fd(), kInodeNumberCheckpointFile, 0) &&
+      errno != ENOENT) {
+    folly::throwSystemError(
+        "Failed to unlink ", kInodeNumberCheckpointFile, " in overlay");
+  }
+}
+
 void FsFileContentStore::readExistingOverlay(int infoFD) {
   // Read the info file header
   std::array<uint8_t, kInfoHeaderSize> infoHeader;
@@ -499,6 +585,45 @@ folly::File FsFileContentStore::createOverlayFileImpl(
   // provide minimal benefits for our use case.
   auto path = getFilePath(inodeNumber);
 
+  // When direct file creation is enabled, skip the temporary file and rename
+  // below and write straight to the final path.  This halves the directory
+  // metadata operations per created file, at the cost of possibly leaving a
+  // truncated overlay file behind if we crash mid-write; validateHeader()
+  // rejects such files and fsck repairs them.  The root inode is always
+  // written atomically (and fdatasync'd below) since a corrupt root prevents
+  // the checkout from mounting at all.
+  if (directFileCreation_ && inodeNumber != kRootNodeId) {
+    auto fd = openat(
+        dirFile_.fd(),
+        path.c_str(),
+        O_CREAT | O_RDWR | O_CLOEXEC | O_NOFOLLOW | O_TRUNC,
+        0600);
+    folly::checkUnixError(
+        fd,
+        "failed to create overlay file for inode ",
+        inodeNumber,
+        " in ",
+        localDir_.view());
+    folly::File file{fd, /* ownsFd */ true};
+    bool success = false;
+    SCOPE_EXIT {
+      if (!success) {
+        unlinkat(dirFile_.fd(), path.c_str(), 0);
+      }
+    };
+
+    auto sizeWritten = folly::writevFull(fd, iov, iovCount);
+    folly::checkUnixError(
+        sizeWritten,
+        "error writing to overlay file for inode ",
+        inodeNumber,
+        " in ",
+        localDir_.view());
+    success = true;
+
+    return file;
+  }
+
   auto tmpPath = getFileTmpPath(inodeNumber);
 
   auto tmpFD = openat(
@@ -38,8 +38,15 @@ class InodePath;
  */
 class FsFileContentStore : public FileContentStore {
  public:
-  explicit FsFileContentStore(AbsolutePathPiece localDir)
-      : localDir_{localDir} {}
+  /**
+   * directFileCreation skips the temporary-file-plus-rename dance when
+   * creating overlay files for non-root inodes; see
+   * EdenConfig::overlayDirectFileCreation.
+   */
+  explicit FsFileContentStore(
+      AbsolutePathPiece localDir,
+      bool directFileCreation = false)
+      : localDir_{localDir}, directFileCreation_{directFileCreation} {}
 
   /**
    * Initialize the FileContentStore, acquire the "info" file lock and load the
@@ -159,6 +166,40 @@ class FsFileContentStore : public FileContentStore {
 
   std::optional<fsck::InodeInfo> loadInodeInfo(InodeNumber number);
 
+  /**
+   * Compute the next inode number by enumerating the shard subdirectories and
+   * taking the maximum of the entry names, without reading any file contents.
+   *
+   * This is much cheaper than a full OverlayChecker scan and is used by the
+   * fsck:open-dirty fast path after an unclean shutdown, where validation of
+   * the overlay contents is deferred to first access.
+   */
+  InodeNumber scanForNextInodeNumber();
+
+  /**
+   * Persist an upper bound on the inode numbers allocated so far.
+   *
+   * Unlike the next-inode-number file, the checkpoint does not indicate a
+   * clean shutdown: it is written before any inode number below its value is
+   * handed out, so it remains a trustworthy bound even after a crash.  See
+   * EdenConfig::overlayInodeNumberCheckpointing.
+   */
+  void saveInodeNumberCheckpoint(InodeNumber bound);
+
+  /**
+   * Load the inode number checkpoint, if one was written by the previous
+   * user of this overlay.  Returns std::nullopt if no valid checkpoint
+   * exists.
+   */
+  std::optional<InodeNumber> tryLoadInodeNumberCheckpoint();
+
+  /**
+   * Remove the inode number checkpoint.  Called on clean shutdown, where the
+   * next-inode-number file supersedes it.  Removing a checkpoint that does
+   * not exist is not an error.
+   */
+  void removeInodeNumberCheckpoint();
+
   static constexpr folly::StringPiece kMetadataFile{"metadata.table"};
 
   /**
@@ -231,6 +272,12 @@ class FsFileContentStore : public FileContentStore {
   /** Path to ".eden/CLIENT/local" */
   const AbsolutePath localDir_;
 
+  /**
+   * Whether to create non-root overlay files directly at their final path
+   * rather than atomically via a temporary file and rename.
+   */
+  const bool directFileCreation_;
+
   /**
    * An open file descriptor to the overlay info file.
    *
@@ -5,6 +5,7 @@
  * GNU General Public License version 2.
  */
 
+#include <algorithm>
 #include <memory>
 
 #include <folly/Conv.h>
@@ -406,6 +407,40 @@ TEST_P(FsckTest, testNoErrors) {
           .toString());
 }
 
+TEST_P(FsckTest, testScanProgressReporting) {
+  auto testOverlay = make_shared<TestOverlay>(overlayType());
+  auto root = testOverlay->init();
+  SimpleOverlayLayout layout(root);
+  testOverlay->closeCleanly();
+
+  testOverlay->recreateSqliteInodeCatalog();
+  FsFileContentStore& fcs = testOverlay->fcs();
+  InodeCatalog* catalog = testOverlay->inodeCatalog();
+  std::optional<InodeNumber> nextInode;
+  if (overlayType() == InodeCatalogType::Legacy) {
+    nextInode = catalog->initOverlay(/*createIfNonExisting=*/false);
+  } else {
+    nextInode = catalog->initOverlay(/*createIfNonExisting=*/true);
+    fcs.initialize(/*createIfNonExisting=*/false);
+  }
+  InodeCatalog::LookupCallback lookup = [](auto&&, auto&&) {
+    return makeImmediateFuture<InodeCatalog::LookupCallbackValue>(
+        std::runtime_error("no lookup callback"));
+  };
+  OverlayChecker checker(catalog, &fcs, nextInode, lookup);
+
+  std::vector<uint16_t> progress;
+  checker.scanForErrors(
+      [&progress](uint16_t percent) { progress.push_back(percent); });
+
+  // The scan must report monotone progress starting at 0 and ending at the
+  // point where repairErrors() would take over.
+  ASSERT_FALSE(progress.empty());
+  EXPECT_EQ(0, progress.front());
+  EXPECT_EQ(95, progress.back());
+  EXPECT_TRUE(std::is_sorted(progress.begin(), progress.end()));
+}
+
 TEST_P(FsckTest, testMissingNextInodeNumber) {
   // This test is not applicable for Sqlite and InMemory backed overlays since
   // they implicitly track the next inode number
@@ -13,6 +13,7 @@
 #include <fcntl.h>
 #include <folly/portability/Unistd.h>
 #include <ctime>
+#include <thread>
 
 #include <folly/Conv.h>
 #include <folly/ExceptionWrapper.h>
@@ -48,17 +49,25 @@ struct OverlayChecker::Impl {
   FsFileContentStore* const fcs;
   std::optional<InodeNumber> loadedNextInodeNumber;
   InodeCatalog::LookupCallback& lookupCallback;
+  const uint32_t numScanThreads;
   std::unordered_map<InodeNumber, InodeInfo> inodes;
 
   Impl(
       InodeCatalog* inodeCatalog,
       FsFileContentStore* fcs,
       std::optional<InodeNumber> nextInodeNumber,
-      InodeCatalog::LookupCallback& lookupCallback)
+      InodeCatalog::LookupCallback& lookupCallback,
+      uint32_t numScanThreads)
       : inodeCatalog{inodeCatalog},
         fcs{fcs},
         loadedNextInodeNumber{nextInodeNumber},
-        lookupCallback{lookupCallback} {}
+        lookupCallback{lookupCallback},
+        // hardware_concurrency() may return 0 if it cannot determine the
+        // CPU count, so keep the old fixed thread count as a floor.
+        numScanThreads{
+            numScanThreads != 0
+                ? numScanThreads
+                : std::max(4u, std::thread::hardware_concurrency())} {}
 };
 
 class OverlayChecker::RepairState {
@@ -747,12 +756,14 @@ OverlayChecker::OverlayChecker(
     InodeCatalog* inodeCatalog,
     FsFileContentStore* fcs,
     optional<InodeNumber> nextInodeNumber,
-    InodeCatalog::LookupCallback& lookupCallback)
+    InodeCatalog::LookupCallback& lookupCallback,
+    uint32_t numScanThreads)
     : impl_{std::make_unique<Impl>(
           inodeCatalog,
           fcs,
           nextInodeNumber,
-          lookupCallback)} {}
+          lookupCallback,
+          numScanThreads)} {}
 
 OverlayChecker::~OverlayChecker() = default;
 
@@ -762,9 +773,18 @@ void OverlayChecker::scanForErrors(const ProgressCallback& progressCallback) {
     callback(0);
   }
   readInodes(progressCallback);
+  if (auto callback = progressCallback) {
+    callback(85);
+  }
   linkInodeChildren();
+  if (auto callback = progressCallback) {
+    callback(90);
+  }
   scanForParentErrors();
   checkNextInodeNumber();
+  if (auto callback = progressCallback) {
+    callback(95);
+  }
 
   if (errors_.empty()) {
     XLOG(INFO) << "fsck:" << impl_->fcs->getLocalDir()
@@ -776,7 +796,8 @@ void OverlayChecker::scanForErrors(const ProgressCallback& progressCallback) {
   }
 }
 
-optional<OverlayChecker::RepairResult> OverlayChecker::repairErrors() {
+optional<OverlayChecker::RepairResult> OverlayChecker::repairErrors(
+    const ProgressCallback& progressCallback) {
   if (errors_.empty()) {
     return std::nullopt;
   }
@@ -795,6 +816,11 @@ optional<OverlayChecker::RepairResult> OverlayChecker::repairErrors() {
   size_t errnum = 0;
   for (const auto& error : errors_) {
     ++errnum;
+    // The repair pass continues from where the scan's progress left off.
+    if (auto callback = progressCallback) {
+      callback(
+          static_cast<uint16_t>(95 + (5 * (errnum - 1)) / errors_.size()));
+    }
     auto description = error->getMessage(this);
     if (errnum < maxPrintedErrors) {
       XLOG(ERR) << "fsck:" << impl_->fcs->getLocalDir()
@@ -966,8 +992,8 @@ std::unique_ptr<OverlayChecker::Error> make_error(Args&&... args) {
 void OverlayChecker::readInodes(const ProgressCallback& progressCallback) {
   using namespace folly::gen;
 
-  auto threads = 4;
-  uint32_t progress10pct = 0;
+  auto threads = impl_->numScanThreads;
+  uint32_t progressPct = 0;
 
   folly::Synchronized<std::vector<std::unique_ptr<Error>>> errors;
 
@@ -1042,20 +1068,26 @@ void OverlayChecker::readInodes(const ProgressCallback& progressCallback) {
           },
           threads) |
       move |
-      map([this, progressCallback, &progress10pct](
+      map([this, progressCallback, &progressPct](
               std::optional<InodeInfo> inodeInfoOpt) -> bool {
         if (inodeInfoOpt.has_value()) {
           auto inodeInfo = inodeInfoOpt.value();
           ShardID shardID = static_cast<ShardID>(inodeInfo.number.get() & 0xff);
-          uint32_t progress = (10 * shardID) / FsFileContentStore::kNumShards;
-          if (progress > progress10pct) {
-            XLOG(INFO) << "fsck:" << impl_->fcs->getLocalDir() << ": scan "
-                       << progress << "0% complete: " << impl_->inodes.size()
-                       << " inodes scanned";
+          // The inode scan covers the 0-85 range of the overall progress;
+          // the later link/check/repair phases cover the rest.
+          uint32_t progress = (85 * shardID) / FsFileContentStore::kNumShards;
+          if (progress > progressPct) {
+            // Stream every percent to the callback, but only log every
+            // tenth to keep the log volume as before.
+            if (progress / 10 > progressPct / 10) {
+              XLOG(INFO) << "fsck:" << impl_->fcs->getLocalDir() << ": scan "
+                         << progress << "% complete: " << impl_->inodes.size()
+                         << " inodes scanned";
+            }
             if (auto callback = progressCallback) {
-              callback(progress);
+              callback(static_cast<uint16_t>(progress));
             }
-            progress10pct = progress;
+            progressPct = progress;
           }
 
           updateMaxInodeNumber(inodeInfo.number);
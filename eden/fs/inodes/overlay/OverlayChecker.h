@@ -52,6 +52,13 @@ class OverlayChecker {
     uint32_t fixedErrors{0};
   };
 
+  /**
+   * Invoked periodically with an approximate completion percentage (0-100)
+   * as the check progresses, so callers can stream progress to the user
+   * (e.g. via the StartupStatusChannel) instead of leaving the mount
+   * silently unavailable.  The inode scan covers 0-85, linking children
+   * and checking parents cover 85-95, and the repair pass covers 95-100.
+   */
   using ProgressCallback = std::function<void(uint16_t)>;
 
   /**
@@ -61,12 +68,17 @@ class OverlayChecker {
    * FsFileContentStore for the duration of the check operation.  The caller is
    * responsible for ensuring that the InodeCatalog and FsFileContentStore
    * objects exist for at least as long as the OverlayChecker object.
+   *
+   * numScanThreads controls how many threads scanForErrors() uses to
+   * enumerate and load overlay shards; 0 picks a value based on the number
+   * of CPUs.
    */
   OverlayChecker(
       InodeCatalog* inodeCatalog,
       FsFileContentStore* fcs,
       std::optional<InodeNumber> nextInodeNumber,
-      InodeCatalog::LookupCallback& lookupCallback);
+      InodeCatalog::LookupCallback& lookupCallback,
+      uint32_t numScanThreads = 0);
 
   ~OverlayChecker();
 
@@ -80,8 +92,13 @@ class OverlayChecker {
    *
    * Returns std::nullopt if repairErrors() is called when there are no errors
    * to repair, otherwise returns a RepairResult.
+   *
+   * Repairs can dominate the fsck runtime when there are many errors (e.g.
+   * archiving orphaned subtrees), so progress continues to be reported here,
+   * picking up where scanForErrors() left off.
    */
-  std::optional<RepairResult> repairErrors();
+  std::optional<RepairResult> repairErrors(
+      const ProgressCallback& progressCallback = [](auto) {});
 
   /**
    * Log the errors that were found by scanForErrors(), without fixing them.
@@ -27,7 +27,8 @@ BufferedSqliteInodeCatalog::BufferedSqliteInodeCatalog(
     const EdenConfig& config,
     SqliteTreeStore::SynchronousMode mode)
     : SqliteInodeCatalog(path, std::move(logger), mode),
-      bufferSize_{config.overlayBufferSize.getValue()} {
+      bufferSize_{config.overlayBufferSize.getValue()},
+      groupCommitLimit_{config.overlayGroupCommitMaxOperations.getValue()} {
   workerThread_ = std::thread{[this] {
     folly::setThreadName("OverlayBuffer");
     processOnWorkerThread();
@@ -38,7 +39,8 @@ BufferedSqliteInodeCatalog::BufferedSqliteInodeCatalog(
     std::unique_ptr<SqliteDatabase> store,
     const EdenConfig& config)
     : SqliteInodeCatalog(std::move(store)),
-      bufferSize_{config.overlayBufferSize.getValue()} {
+      bufferSize_{config.overlayBufferSize.getValue()},
+      groupCommitLimit_{config.overlayGroupCommitMaxOperations.getValue()} {
   workerThread_ = std::thread{[this] {
     folly::setThreadName("OverlayBuffer");
     processOnWorkerThread();
@@ -119,12 +121,51 @@ void BufferedSqliteInodeCatalog::processOnWorkerThread() {
       // processed
     }
 
-    for (auto& event : work) {
-      // event will return true if it was a stopping event, in which case the
-      // thread should exit
-      if (event->operation()) {
-        return;
+    // Coalesce the drained writes into group commits: a burst that queued
+    // up together is committed together in one SQLite transaction rather
+    // than one transaction per write. The group size is naturally sized by
+    // the burst (everything drained at once), capped by groupCommitLimit_
+    // to bound how much work a single commit can defer.
+    size_t groupSize = 0;
+    bool groupOpen = false;
+
+    auto commitGroup = [&] {
+      if (groupOpen) {
+        commitGroupCommit();
+        groupOpen = false;
+        groupSize = 0;
       }
+    };
+
+    try {
+      for (auto& event : work) {
+        // Control events (flush, pause, shutdown) are enqueued with a zero
+        // size estimate and must observe every earlier write as committed,
+        // so close any open group first.
+        bool isControlEvent = event->estimateIndirectMemoryUsage == 0;
+        if (isControlEvent) {
+          commitGroup();
+        } else if (!groupOpen && groupCommitLimit_ != 0) {
+          beginGroupCommit();
+          groupOpen = true;
+        }
+
+        // event will return true if it was a stopping event, in which case
+        // the thread should exit
+        if (event->operation()) {
+          return;
+        }
+
+        if (groupOpen && ++groupSize >= groupCommitLimit_) {
+          commitGroup();
+        }
+      }
+      commitGroup();
+    } catch (...) {
+      if (groupOpen) {
+        rollbackGroupCommit();
+      }
+      throw;
     }
   }
 }
@@ -124,6 +124,9 @@ class BufferedSqliteInodeCatalog : public SqliteInodeCatalog {
 
   // Maximum size of the buffer in bytes
   const size_t bufferSize_;
+  // Maximum number of queued writes committed in one SQLite transaction; 0
+  // disables group commit
+  const size_t groupCommitLimit_;
   std::thread workerThread_;
   folly::Synchronized<State, std::mutex> state_;
   // Encodes the condition !state_.work.empty()
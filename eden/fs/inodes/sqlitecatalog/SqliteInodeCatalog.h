@@ -111,6 +111,23 @@ class SqliteInodeCatalog : public InodeCatalog {
 
   std::optional<fsck::InodeInfo> loadInodeInfo(InodeNumber number) override;
 
+ protected:
+  /**
+   * Group-commit brackets for BufferedSqliteInodeCatalog's worker thread;
+   * see SqliteTreeStore::beginGroupCommit().
+   */
+  void beginGroupCommit() {
+    store_.beginGroupCommit();
+  }
+
+  void commitGroupCommit() {
+    store_.commitGroupCommit();
+  }
+
+  void rollbackGroupCommit() {
+    store_.rollbackGroupCommit();
+  }
+
  private:
   SqliteTreeStore store_;
 
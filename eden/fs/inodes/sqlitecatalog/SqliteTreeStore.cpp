@@ -215,6 +215,14 @@ SqliteTreeStore::SqliteTreeStore(
   // https://www.sqlite.org/pragma.html#pragma_locking_mode
   SqliteStatement(dbLock, "PRAGMA locking_mode=EXCLUSIVE").step();
 
+  // Track free pages so maintenance() can return them to the filesystem with
+  // incremental_vacuum, rather than the database file only ever growing.
+  // This pragma only takes effect for newly created databases; existing
+  // databases keep their current auto_vacuum mode (changing it would require
+  // a full VACUUM).
+  // https://www.sqlite.org/pragma.html#pragma_auto_vacuum
+  SqliteStatement(dbLock, "PRAGMA auto_vacuum=INCREMENTAL").step();
+
   if (synchronous_mode == SqliteTreeStore::SynchronousMode::Off) {
     XLOG(INFO)
         << "Synchronous mode is off. Data loss may happen when system crashes.";
@@ -409,23 +417,44 @@ std::vector<InodeNumber> SqliteTreeStore::getAllParentInodeNumbers() {
   return numbers;
 }
 
+namespace {
+/**
+ * Decode the rows of a selectTree query into an OverlayDir.
+ *
+ * The entry table is clustered on (parent, name) and selectTree returns
+ * rows in name order, so every entry can be appended at the end of the
+ * map with a hint instead of paying a lookup per row.  The hash column is
+ * only copied into the thrift struct when it is non-empty: an unset hash
+ * already means "materialized" (see overlay.thrift), so materialized
+ * entries skip a string allocation per row.
+ */
+void readTreeRows(SqliteStatement& query, overlay::OverlayDir& dir) {
+  auto& entries = *dir.entries_ref();
+  while (query.step()) {
+    auto name = query.columnBlob(0);
+    overlay::OverlayEntry entry;
+    entry.mode_ref() =
+        dtype_to_mode(static_cast<dtype_t>(query.columnUint64(1)));
+    entry.inodeNumber_ref() = query.columnUint64(2);
+    auto hash = query.columnBlob(3);
+    if (!hash.empty()) {
+      entry.hash_ref() = hash.toString();
+    }
+    entries.emplace_hint(entries.end(), name.toString(), std::move(entry));
+  }
+}
+} // namespace
+
 overlay::OverlayDir SqliteTreeStore::loadTree(InodeNumber inode) {
   overlay::OverlayDir dir;
 
-  db_->transaction([&](auto& txn) {
-    auto query = cache_->selectTree.get(txn);
-    query->bind(1, inode.get());
-
-    while (query->step()) {
-      auto name = query->columnBlob(0);
-      overlay::OverlayEntry entry;
-      entry.mode_ref() =
-          dtype_to_mode(static_cast<dtype_t>(query->columnUint64(1)));
-      entry.inodeNumber_ref() = query->columnUint64(2);
-      entry.hash_ref() = query->columnBlob(3).toString();
-      dir.entries_ref()->emplace(std::make_pair(name, entry));
-    }
-  });
+  // A single SELECT does not need an explicit transaction; skipping the
+  // BEGIN/COMMIT statement pair matters when wide trees are loaded one
+  // directory at a time.
+  auto db = db_->lock();
+  auto query = cache_->selectTree.get(db);
+  query->bind(1, inode.get());
+  readTreeRows(*query, dir);
 
   return dir;
 }
@@ -437,16 +466,7 @@ overlay::OverlayDir SqliteTreeStore::loadAndRemoveTree(InodeNumber inode) {
     // SQLite does not support select-and-delete in one query.
     auto query = cache_->selectTree.get(txn);
     query->bind(1, inode.get());
-
-    while (query->step()) {
-      auto name = query->columnBlob(0);
-      overlay::OverlayEntry entry;
-      entry.mode_ref() =
-          dtype_to_mode(static_cast<dtype_t>(query->columnUint64(1)));
-      entry.inodeNumber_ref() = query->columnUint64(2);
-      entry.hash_ref() = query->columnBlob(3).toString();
-      dir.entries_ref()->emplace(std::make_pair(name, entry));
-    }
+    readTreeRows(*query, dir);
 
     auto deleteInode = cache_->deleteTree.get(txn);
     deleteInode->reset();
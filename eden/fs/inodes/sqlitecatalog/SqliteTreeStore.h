@@ -146,11 +146,38 @@ class SqliteTreeStore {
 
   void maintenance() {
     db_->checkpoint();
+    // Return a bounded number of free pages to the filesystem each cycle so
+    // deleted overlay trees are reclaimed over time without a long stall.
+    db_->incrementalVacuum(kMaintenanceVacuumPages);
+  }
+
+  /**
+   * Bracket a group of tree store writes in a single SQLite transaction;
+   * the writes become durable together at commitGroupCommit().  Used by
+   * BufferedSqliteInodeCatalog to coalesce bursts of queued writes.
+   */
+  void beginGroupCommit() {
+    db_->beginTransaction();
+  }
+
+  void commitGroupCommit() {
+    db_->commitTransaction();
+  }
+
+  void rollbackGroupCommit() {
+    db_->rollbackTransaction();
   }
 
  private:
   FRIEND_TEST(SqliteTreeStoreTest, testRecoverInodeEntryNumber);
 
+  /**
+   * Maximum number of free pages incremental_vacuum reclaims per maintenance
+   * cycle. At the default 4KiB page size this bounds each cycle's repacking
+   * work to roughly 4MiB of file shrinkage.
+   */
+  static constexpr uint64_t kMaintenanceVacuumPages = 1024;
+
   struct StatementCache;
 
   /**
@@ -217,6 +217,52 @@ TEST(
   EXPECT_EQ(ino, overlay->getMaxInodeNumber());
 }
 
+TEST(PlainSqliteInodeCatalogTest, group_commit_round_trips_bursts_buffered) {
+  auto config = EdenConfig::createTestEdenConfig();
+  // A small group commit limit forces a burst of writes to span several
+  // grouped transactions.
+  config->overlayGroupCommitMaxOperations.setValue(
+      2, ConfigSourceType::Default, true);
+  folly::test::TemporaryDirectory testDir;
+  auto overlay = Overlay::create(
+      canonicalPath(testDir.path().string()),
+      kPathMapDefaultCaseSensitive,
+      InodeCatalogType::Sqlite,
+      INODE_CATALOG_BUFFERED,
+      std::make_shared<NullStructuredLogger>(),
+      makeRefPtr<EdenStats>(),
+      true,
+      *config);
+  overlay->initialize(EdenConfig::createTestEdenConfig()).get();
+
+  std::vector<InodeNumber> inodes;
+  for (int i = 0; i < 20; i++) {
+    auto ino = overlay->allocateInodeNumber();
+    auto child = overlay->allocateInodeNumber();
+    DirContents dir(kPathMapDefaultCaseSensitive);
+    dir.emplace("child"_pc, S_IFDIR | 0755, child);
+    overlay->saveOverlayDir(ino, dir);
+    inodes.push_back(ino);
+  }
+  overlay->close();
+
+  // Reopen the overlay and verify every write in the burst was committed.
+  overlay = Overlay::create(
+      canonicalPath(testDir.path().string()),
+      kPathMapDefaultCaseSensitive,
+      InodeCatalogType::Sqlite,
+      INODE_CATALOG_BUFFERED,
+      std::make_shared<NullStructuredLogger>(),
+      makeRefPtr<EdenStats>(),
+      true,
+      *config);
+  overlay->initialize(EdenConfig::createTestEdenConfig()).get();
+  for (auto ino : inodes) {
+    auto result = overlay->loadOverlayDir(ino);
+    EXPECT_EQ(1, result.size());
+  }
+}
+
 class RawSqliteInodeCatalogTest
     : public ::testing::TestWithParam<InodeCatalogOptions> {
  public:
@@ -96,6 +96,23 @@ TEST_F(SqliteTreeStoreTest, testSaveLoadTree) {
   expect_entries(*dir.entries_ref(), *restored.entries_ref());
 }
 
+TEST_F(SqliteTreeStoreTest, testLoadTreeLeavesMaterializedHashUnset) {
+  auto inode = store_->nextInodeNumber();
+  overlay::OverlayDir dir;
+  dir.entries_ref()->emplace(std::make_pair("materialized", makeEntry()));
+  dir.entries_ref()->emplace(std::make_pair(
+      "tracked",
+      makeEntry(Hash20{"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa"})));
+  store_->saveTree(inode, overlay::OverlayDir{dir});
+
+  // Materialized entries come back with the hash unset rather than as an
+  // empty string; both spellings mean "materialized" per overlay.thrift.
+  auto loaded = store_->loadTree(inode);
+  EXPECT_FALSE(
+      loaded.entries_ref()->at("materialized").hash_ref().has_value());
+  EXPECT_TRUE(loaded.entries_ref()->at("tracked").hash_ref().has_value());
+}
+
 TEST_F(SqliteTreeStoreTest, testRecoverInodeEntryNumber) {
   overlay::OverlayDir dir;
   dir.entries_ref()->emplace(std::make_pair("hello", makeEntry()));
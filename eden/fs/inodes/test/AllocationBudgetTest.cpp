@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#ifndef _WIN32
+
+#include <fmt/format.h>
+#include <folly/logging/xlog.h>
+#include <folly/portability/GTest.h>
+
+#include "eden/fs/fuse/FuseDirList.h"
+#include "eden/fs/inodes/EdenMount.h"
+#include "eden/fs/inodes/FileInode.h"
+#include "eden/fs/inodes/TreeInode.h"
+#include "eden/fs/model/git/TopLevelIgnores.h"
+#include "eden/fs/store/DiffContext.h"
+#include "eden/fs/store/ObjectFetchContext.h"
+#include "eden/fs/store/ScmStatusDiffCallback.h"
+#include "eden/fs/testharness/AllocationCounter.h"
+#include "eden/fs/testharness/FakeTreeBuilder.h"
+#include "eden/fs/testharness/TestMount.h"
+#include "eden/fs/utils/CaseSensitivity.h"
+
+using namespace facebook::eden;
+using namespace std::chrono_literals;
+
+namespace {
+
+// Allocation budgets for warm canonical operations. These are deliberately
+// loose fences: they exist to catch an order-of-magnitude regression in a
+// hot path, not to pin exact counts, which vary across toolchain and
+// library versions. When lowering latency in one of these paths, measure
+// the new count from the test log and tighten the budget to keep the fence
+// meaningful.
+constexpr size_t kLookupBudget = 1000;
+constexpr size_t kReadBudget = 2000;
+constexpr size_t kReaddirBudget = 10000;
+constexpr size_t kStatusBudget = 50000;
+
+/**
+ * Run the operation once to warm caches and load inodes, then measure the
+ * allocations of a second run. The operation must complete on the calling
+ * thread; anything asynchronous has to be drained via the TestMount's
+ * server executor inside the callback.
+ */
+template <typename Operation>
+size_t measureWarmAllocations(Operation&& operation) {
+  operation();
+  AllocationCounterScope scope;
+  operation();
+  return scope.count();
+}
+
+} // namespace
+
+TEST(AllocationBudget, counterObservesAllocations) {
+  AllocationCounterScope scope;
+  auto data = std::make_unique<char[]>(64);
+  EXPECT_NE(data.get(), nullptr);
+  EXPECT_GE(scope.count(), 1ul);
+}
+
+TEST(AllocationBudget, warmLookupStaysWithinBudget) {
+  FakeTreeBuilder builder;
+  builder.setFile("dir/a.txt", "file contents\n");
+  TestMount mount{builder};
+  auto root = mount.getEdenMount()->getRootInode();
+
+  auto allocations = measureWarmAllocations([&] {
+    auto future =
+        root->getOrLoadChild("dir"_pc, ObjectFetchContext::getNullContext())
+            .semi()
+            .via(mount.getServerExecutor().get());
+    mount.drainServerExecutor();
+    std::move(future).get(0ms);
+  });
+
+  XLOGF(INFO, "warm lookup allocations: {}", allocations);
+  EXPECT_LE(allocations, kLookupBudget);
+}
+
+TEST(AllocationBudget, warmReadStaysWithinBudget) {
+  FakeTreeBuilder builder;
+  builder.setFile("dir/a.txt", "file contents\n");
+  TestMount mount{builder};
+  auto inode = mount.getFileInode("dir/a.txt");
+
+  auto allocations = measureWarmAllocations([&] {
+    auto future = inode->read(4096, 0, ObjectFetchContext::getNullContext())
+                      .semi()
+                      .via(mount.getServerExecutor().get());
+    mount.drainServerExecutor();
+    std::move(future).get(0ms);
+  });
+
+  XLOGF(INFO, "warm read allocations: {}", allocations);
+  EXPECT_LE(allocations, kReadBudget);
+}
+
+TEST(AllocationBudget, warmReaddirStaysWithinBudget) {
+  FakeTreeBuilder builder;
+  for (int i = 0; i < 32; ++i) {
+    builder.setFile(fmt::format("dir/file{:02}", i), "");
+  }
+  TestMount mount{builder};
+  auto dir = mount.getTreeInode("dir");
+
+  auto allocations = measureWarmAllocations([&] {
+    auto result = dir->fuseReaddir(
+                          FuseDirList{1 << 20},
+                          0,
+                          ObjectFetchContext::getNullContext())
+                      .extract();
+    EXPECT_EQ(34, result.size());
+  });
+
+  XLOGF(INFO, "warm readdir allocations: {}", allocations);
+  EXPECT_LE(allocations, kReaddirBudget);
+}
+
+TEST(AllocationBudget, statusOfOneModifiedFileStaysWithinBudget) {
+  FakeTreeBuilder builder;
+  builder.setFile("dir/a.txt", "file contents\n");
+  builder.setFile("dir/b.txt", "more contents\n");
+  TestMount mount{builder};
+  mount.overwriteFile("dir/a.txt", "modified contents\n");
+
+  auto allocations = measureWarmAllocations([&] {
+    ScmStatusDiffCallback callback;
+    DiffContext diffContext{
+        &callback,
+        folly::CancellationToken{},
+        ObjectFetchContext::getNullContext(),
+        /*listIgnored=*/false,
+        kPathMapDefaultCaseSensitive,
+        true,
+        mount.getEdenMount()->getObjectStore(),
+        std::make_unique<TopLevelIgnores>("", "")};
+    auto commitHash = mount.getEdenMount()->getCheckedOutRootId();
+    auto future = mount.getEdenMount()
+                      ->diff(mount.getRootInode(), &diffContext, commitHash)
+                      .semi()
+                      .via(mount.getServerExecutor().get());
+    mount.drainServerExecutor();
+    std::move(future).get(0ms);
+    auto status = callback.extractStatus();
+    EXPECT_EQ(1, status.entries_ref()->size());
+  });
+
+  XLOGF(INFO, "warm status allocations: {}", allocations);
+  EXPECT_LE(allocations, kStatusBudget);
+}
+
+#endif
@@ -1727,6 +1727,84 @@ TEST(Checkout, conflict_when_directory_containing_modified_file_is_removed) {
   }
 }
 
+TEST(Checkout, dryRunConflictScan) {
+  auto builder1 = FakeTreeBuilder{};
+  builder1.setFile("src/main.c", "int main() {}\n");
+  builder1.setFile("src/old.c", "old\n");
+  TestMount testMount{RootId{"1"}, builder1};
+
+  auto builder2 = builder1.clone();
+  builder2.setFile("src/new.c", "new\n");
+  builder2.removeFile("src/old.c");
+  builder2.finalize(testMount.getBackingStore(), true);
+  auto commit2 = testMount.getBackingStore()->putCommit("2", builder2);
+  commit2->setReady();
+
+  // An untracked file at a path the new commit adds, and a local removal of
+  // a file the new commit also removes.
+  testMount.addFile("src/new.c", "different contents\n");
+  testMount.deleteFile("src/old.c");
+
+  auto executor = testMount.getServerExecutor().get();
+  auto checkoutResult = testMount.getEdenMount()
+                            ->checkout(
+                                testMount.getRootInode(),
+                                RootId{"2"},
+                                ObjectFetchContext::getNullContext(),
+                                __func__,
+                                CheckoutMode::DRY_RUN)
+                            .waitVia(executor);
+  ASSERT_TRUE(checkoutResult.isReady());
+  auto result = std::move(checkoutResult).get();
+  ASSERT_EQ(2, result.conflicts.size());
+
+  EXPECT_EQ("src/new.c", *result.conflicts[0].path_ref());
+  EXPECT_EQ(ConflictType::UNTRACKED_ADDED, *result.conflicts[0].type_ref());
+  EXPECT_EQ("src/old.c", *result.conflicts[1].path_ref());
+  EXPECT_EQ(ConflictType::MISSING_REMOVED, *result.conflicts[1].type_ref());
+
+  // A dry run must not move the parent commit.
+  EXPECT_EQ(RootId{"1"}, testMount.getEdenMount()->getWorkingCopyParent());
+}
+
+TEST(Checkout, checkoutPathScopedUpdate) {
+  auto builder1 = FakeTreeBuilder{};
+  builder1.setFile("proj/a.c", "a v1\n");
+  builder1.setFile("proj/sub/b.c", "b v1\n");
+  builder1.setFile("other/x.c", "x v1\n");
+  TestMount testMount{RootId{"1"}, builder1};
+
+  auto builder2 = builder1.clone();
+  builder2.replaceFile("proj/a.c", "a v2\n");
+  builder2.setFile("proj/c.c", "c v2\n");
+  builder2.removeFile("proj/sub/b.c");
+  builder2.replaceFile("other/x.c", "x v2\n");
+  builder2.finalize(testMount.getBackingStore(), true);
+  auto commit2 = testMount.getBackingStore()->putCommit("2", builder2);
+  commit2->setReady();
+
+  auto executor = testMount.getServerExecutor().get();
+  auto checkoutResult = testMount.getEdenMount()
+                            ->checkoutPath(
+                                "proj"_relpath,
+                                RootId{"2"},
+                                ObjectFetchContext::getNullContext(),
+                                __func__)
+                            .waitVia(executor);
+  ASSERT_TRUE(checkoutResult.isReady());
+  auto result = std::move(checkoutResult).get();
+  EXPECT_EQ(0, result.conflicts.size());
+
+  // The requested directory moved to commit 2...
+  EXPECT_FILE_INODE(testMount.getFileInode("proj/a.c"), "a v2\n", 0644);
+  EXPECT_FILE_INODE(testMount.getFileInode("proj/c.c"), "c v2\n", 0644);
+  EXPECT_THROW_ERRNO(testMount.getFileInode("proj/sub/b.c"_relpath), ENOENT);
+
+  // ... while everything outside of it, and the parent commit, stayed put.
+  EXPECT_FILE_INODE(testMount.getFileInode("other/x.c"), "x v1\n", 0644);
+  EXPECT_EQ(RootId{"1"}, testMount.getEdenMount()->getWorkingCopyParent());
+}
+
 TEST(Checkout, checkoutFailsOnInProgressCheckout) {
   auto builder1 = FakeTreeBuilder();
   builder1.setFile("src/main.c", "// Some code.\n");
@@ -144,4 +144,67 @@ TEST(Dematerialize, test_dematerialization_migrates_to_the_new_ID_scheme) {
   EXPECT_TRUE(inode->isUnlinked());
 }
 
+TEST(Dematerialize, volatile_file_unlink_dematerializes_parent_chain) {
+  FakeTreeBuilder builder;
+  builder.setFile("proj/src/main.c", "int main() {}\n");
+  TestMount mount{builder};
+  mount.updateEdenConfig(
+      {{"experimental:volatile-file-patterns", "[\"*.tmp\"]"}});
+
+  // Creating a scratch file materializes the whole parent chain.
+  mount.addFile("proj/src/build.tmp", "scratch");
+  EXPECT_TRUE(
+      mount.getTreeInode("proj/src")->getContents().rlock()->isMaterialized());
+  EXPECT_TRUE(
+      mount.getTreeInode("proj")->getContents().rlock()->isMaterialized());
+
+  // Deleting it schedules a background dematerialization of the chain.
+  mount.deleteFile("proj/src/build.tmp");
+  mount.drainServerExecutor();
+
+  EXPECT_FALSE(
+      mount.getTreeInode("proj/src")->getContents().rlock()->isMaterialized());
+  EXPECT_FALSE(
+      mount.getTreeInode("proj")->getContents().rlock()->isMaterialized());
+  EXPECT_FALSE(mount.getRootInode()->getContents().rlock()->isMaterialized());
+}
+
+TEST(Dematerialize, volatile_file_unlink_keeps_modified_directories) {
+  FakeTreeBuilder builder;
+  builder.setFile("proj/src/main.c", "int main() {}\n");
+  TestMount mount{builder};
+  mount.updateEdenConfig(
+      {{"experimental:volatile-file-patterns", "[\"*.tmp\"]"}});
+
+  // The directory has a real local modification alongside the scratch file.
+  mount.overwriteFile("proj/src/main.c", "int main() { return 1; }\n");
+  mount.addFile("proj/src/build.tmp", "scratch");
+
+  mount.deleteFile("proj/src/build.tmp");
+  mount.drainServerExecutor();
+
+  // The modification keeps the chain materialized.
+  EXPECT_TRUE(
+      mount.getTreeInode("proj/src")->getContents().rlock()->isMaterialized());
+  EXPECT_TRUE(
+      mount.getTreeInode("proj")->getContents().rlock()->isMaterialized());
+}
+
+TEST(Dematerialize, non_matching_unlink_does_not_dematerialize) {
+  FakeTreeBuilder builder;
+  builder.setFile("proj/src/main.c", "int main() {}\n");
+  TestMount mount{builder};
+  mount.updateEdenConfig(
+      {{"experimental:volatile-file-patterns", "[\"*.tmp\"]"}});
+
+  // A file that does not match the configured patterns gets the historical
+  // behavior: deletion leaves the directory materialized.
+  mount.addFile("proj/src/scratch.log", "scratch");
+  mount.deleteFile("proj/src/scratch.log");
+  mount.drainServerExecutor();
+
+  EXPECT_TRUE(
+      mount.getTreeInode("proj/src")->getContents().rlock()->isMaterialized());
+}
+
 } // namespace
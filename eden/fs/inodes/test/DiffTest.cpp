@@ -320,6 +320,33 @@ TEST(DiffTest, fileCasingChange) {
 // Test file adds/removes/modifications with various orderings of names between
 // the TreeInode entries and Tree entries.  This exercises the code that walks
 // through the two entry lists comparing entry names.
+TEST(DiffTest, boundedDeferredEntries) {
+  DiffTest test;
+  auto& mount = test.getMount();
+  // Bound the per-directory deferred entry fan-out so that the wide set of
+  // modifications below goes through the work queue rather than the
+  // start-everything-at-once path.
+  mount.updateEdenConfig({{"experimental:max-concurrent-diff-entries", "2"}});
+
+  mount.overwriteFile("src/1.txt", "modified\n");
+  mount.overwriteFile("src/a/b/3.txt", "modified\n");
+  mount.addFile("src/new.txt", "extra stuff");
+  mount.mkdir("src/newdir");
+  mount.mkdir("src/newdir/sub");
+  mount.addFile("src/newdir/sub/file.txt", "extra stuff");
+  mount.deleteFile("doc/readme.txt");
+
+  auto result = test.diff();
+  EXPECT_THAT(
+      *result.entries_ref(),
+      UnorderedElementsAre(
+          std::make_pair("src/1.txt", ScmFileStatus::MODIFIED),
+          std::make_pair("src/a/b/3.txt", ScmFileStatus::MODIFIED),
+          std::make_pair("src/new.txt", ScmFileStatus::ADDED),
+          std::make_pair("src/newdir/sub/file.txt", ScmFileStatus::ADDED),
+          std::make_pair("doc/readme.txt", ScmFileStatus::REMOVED)));
+}
+
 TEST(DiffTest, pathOrdering) {
   DiffTest test({
       {"one/bbb.txt", "test\n"},
@@ -415,6 +415,134 @@ TEST_F(FileInodeTest, truncatingMaterializesParent) {
   EXPECT_EQ(true, isInodeMaterialized(parent));
 }
 
+TEST_F(FileInodeTest, sha1TracksSequentialAppends) {
+  mount_.addFile("dir/log.txt", "");
+  auto inode = mount_.getFileInode("dir/log.txt");
+  auto sha1Of = [&](folly::StringPiece contents) {
+    return Hash20::sha1(folly::ByteRange{contents});
+  };
+
+  // Build the file with sequential appends; the hash must cover all of it.
+  inode->write("first chunk ", 0, ObjectFetchContext::getNullContext()).get();
+  inode->write("second chunk", 12, ObjectFetchContext::getNullContext()).get();
+  EXPECT_EQ(
+      sha1Of("first chunk second chunk"),
+      inode->getSha1(ObjectFetchContext::getNullContext()).get());
+
+  // An overwrite in the middle discards the streaming state.
+  inode->write("FIRST", 0, ObjectFetchContext::getNullContext()).get();
+  EXPECT_EQ(
+      sha1Of("FIRST chunk second chunk"),
+      inode->getSha1(ObjectFetchContext::getNullContext()).get());
+
+  // Appending again after a full rehash extends the recomputed state.
+  inode->write("!", 24, ObjectFetchContext::getNullContext()).get();
+  EXPECT_EQ(
+      sha1Of("FIRST chunk second chunk!"),
+      inode->getSha1(ObjectFetchContext::getNullContext()).get());
+}
+
+TEST_F(FileInodeTest, largeMaterializedFileReadsStayCoherent) {
+  mount_.addFile("dir/big.bin", "");
+  auto inode = mount_.getFileInode("dir/big.bin");
+
+  // Materialize a file large enough for the overlay read path to establish
+  // its read mapping.
+  std::string contents(1024 * 1024 + 4096, 'x');
+  contents.front() = 'A';
+  contents.back() = 'Z';
+  inode->write(contents, 0, ObjectFetchContext::getNullContext()).get();
+
+  auto readAll = [&]() {
+    auto readRes =
+        inode
+            ->read(
+                contents.size() + 1024, 0, ObjectFetchContext::getNullContext())
+            .get();
+    return std::get<0>(readRes)->moveToFbString().toStdString();
+  };
+
+  // The first read goes through pread and arms the mapping; the second is
+  // served from it. Both must see identical contents.
+  EXPECT_EQ(contents, readAll());
+  EXPECT_EQ(contents, readAll());
+
+  // A write drops the mapping, so subsequent reads observe the change.
+  inode->write("MODIFIED", 100, ObjectFetchContext::getNullContext()).get();
+  contents.replace(100, 8, "MODIFIED");
+  EXPECT_EQ(contents, readAll());
+  EXPECT_EQ(contents, readAll());
+
+  // Truncation shrinks the file; reads must see the new EOF, not stale
+  // mapped pages.
+  DesiredMetadata desired;
+  desired.size = 4096;
+  (void)inode->setattr(desired, ObjectFetchContext::getNullContext()).get();
+  contents.resize(4096);
+  EXPECT_EQ(contents, readAll());
+  EXPECT_EQ(contents, readAll());
+}
+
+TEST_F(FileInodeTest, dematerializeUnchangedFiles) {
+  auto inode = mount_.getFileInode("dir/sub/b.txt");
+  auto parent = mount_.getTreeInode("dir/sub");
+
+  // Materialize the file without changing its contents, as a build tool
+  // that touches and then restores a file would.
+  inode->write("This is b.txt.\n", 0, ObjectFetchContext::getNullContext())
+      .get();
+  EXPECT_FALSE(inode->getObjectId().has_value());
+  EXPECT_TRUE(isInodeMaterialized(parent));
+
+  mount_.getTreeInode(RelativePathPiece{})
+      ->dematerializeUnchangedFiles(ObjectFetchContext::getNullContext().copy())
+      .get();
+
+  // The file and its parent directory chain fold back to source control.
+  EXPECT_TRUE(inode->getObjectId().has_value());
+  EXPECT_FALSE(isInodeMaterialized(parent));
+  EXPECT_FILE_INODE(inode, "This is b.txt.\n", 0644);
+}
+
+TEST_F(FileInodeTest, dematerializeLeavesChangedFilesAlone) {
+  auto inode = mount_.getFileInode("dir/sub/b.txt");
+
+  inode->write("modified contents\n", 0, ObjectFetchContext::getNullContext())
+      .get();
+
+  mount_.getTreeInode(RelativePathPiece{})
+      ->dematerializeUnchangedFiles(ObjectFetchContext::getNullContext().copy())
+      .get();
+
+  // The contents differ from the source control blob, so the file must
+  // stay materialized.
+  EXPECT_FALSE(inode->getObjectId().has_value());
+  EXPECT_FILE_INODE(inode, "modified contents\n", 0644);
+}
+
+TEST_F(FileInodeTest, materializingIdenticalBlobsKeepsFilesIndependent) {
+  TestMount mount;
+  FakeTreeBuilder builder;
+  builder.setFiles(
+      {{"gen/one.h", "// generated\n"}, {"gen/two.h", "// generated\n"}});
+  mount.initialize(builder);
+
+  auto one = mount.getFileInode("gen/one.h");
+  auto two = mount.getFileInode("gen/two.h");
+
+  // Materialize both files without changing their contents. The second
+  // materialization may share its overlay payload with the first.
+  one->write("// generated\n", 0, ObjectFetchContext::getNullContext()).get();
+  two->write("// generated\n", 0, ObjectFetchContext::getNullContext()).get();
+  EXPECT_FILE_INODE(one, "// generated\n", 0644);
+  EXPECT_FILE_INODE(two, "// generated\n", 0644);
+
+  // Writing to one copy must never leak into the other.
+  one->write("// EDITED!!!\n", 0, ObjectFetchContext::getNullContext()).get();
+  EXPECT_FILE_INODE(one, "// EDITED!!!\n", 0644);
+  EXPECT_FILE_INODE(two, "// generated\n", 0644);
+}
+
 TEST_F(FileInodeTest, addNewMaterializationsToInodeTraceBus) {
   auto& trace_bus = mount_.getEdenMount()->getInodeTraceBus();
 
@@ -10,6 +10,7 @@
 
 #include <utility>
 
+#include <folly/CancellationToken.h>
 #include <folly/Conv.h>
 #include <folly/Exception.h>
 #include <folly/Range.h>
@@ -375,6 +376,48 @@ TEST(GlobNodeTest, matchingDirectoryDoesNotLoadTree) {
   }
 }
 
+TEST(GlobNodeTest, evaluateOnExecutor) {
+  auto mount = TestMount{};
+  auto builder = FakeTreeBuilder{};
+  builder.setFiles(
+      {{"dir/a.txt", "a"}, {"dir/sub/b.txt", "b"}, {"other/c.txt", "c"}});
+  mount.initialize(builder, /*startReady=*/true);
+
+  GlobNode globRoot(
+      /*includeDotfiles=*/false, mount.getConfig()->getCaseSensitive());
+  globRoot.parse("**/*.txt");
+
+  auto rootInode = mount.getTreeInode(RelativePathPiece());
+  auto globResults =
+      std::make_shared<folly::Synchronized<std::vector<GlobResult>>>();
+  auto future = globRoot
+                    .evaluate(
+                        mount.getEdenMount()->getObjectStore(),
+                        ObjectFetchContext::getNullContext(),
+                        RelativePathPiece(),
+                        rootInode,
+                        /*fileBlobsToPrefetch=*/nullptr,
+                        *globResults,
+                        kZeroRootId,
+                        mount.getServerExecutor().get())
+                    .semi()
+                    .via(mount.getServerExecutor().get());
+  mount.drainServerExecutor();
+  std::move(future).get(kSmallTimeout);
+
+  // Parallel subtree evaluation does not guarantee an append order, so sort
+  // before comparing. ThriftGlobImpl sorts and deduplicates the same way.
+  auto matches = std::move(*globResults->wlock());
+  std::sort(matches.begin(), matches.end());
+
+  std::vector<GlobResult> expect{
+      GlobResult("dir/a.txt"_relpath, dtype_t::Regular, kZeroRootId),
+      GlobResult("dir/sub/b.txt"_relpath, dtype_t::Regular, kZeroRootId),
+      GlobResult("other/c.txt"_relpath, dtype_t::Regular, kZeroRootId),
+  };
+  EXPECT_EQ(expect, matches);
+}
+
 TEST(GlobNodeTest, treeLoadError) {
   auto mount = TestMount{};
   auto builder = FakeTreeBuilder{};
@@ -478,3 +521,60 @@ TEST(GlobNodeTest, testCaseInsensitive) {
   };
   EXPECT_EQ(expect, matches);
 }
+
+namespace {
+/**
+ * A fetch context carrying a cancellation token, standing in for a Thrift
+ * request whose client may disconnect mid-glob.
+ */
+class CancellableFetchContext : public ObjectFetchContext {
+ public:
+  explicit CancellableFetchContext(folly::CancellationToken token)
+      : token_{std::move(token)} {}
+
+  Cause getCause() const override {
+    return Cause::Unknown;
+  }
+
+  const std::unordered_map<std::string, std::string>* getRequestInfo()
+      const override {
+    return nullptr;
+  }
+
+  folly::CancellationToken getCancellationToken() const override {
+    return token_;
+  }
+
+ private:
+  folly::CancellationToken token_;
+};
+} // namespace
+
+TEST(GlobNodeTest, cancelledContextStopsEvaluation) {
+  auto mount = TestMount{};
+  auto builder = FakeTreeBuilder{};
+  builder.setFiles({{"dir/a.txt", "a"}});
+  mount.initialize(builder, /*startReady=*/true);
+
+  GlobNode globRoot(
+      /*includeDotfiles=*/false, mount.getConfig()->getCaseSensitive());
+  globRoot.parse("**/*.txt");
+
+  folly::CancellationSource cancellation;
+  cancellation.requestCancellation();
+  auto context = makeRefPtr<CancellableFetchContext>(cancellation.getToken());
+
+  auto globResults = folly::Synchronized<std::vector<GlobResult>>{};
+  auto fut = globRoot.evaluate(
+      mount.getEdenMount()->getObjectStore(),
+      context.as<ObjectFetchContext>(),
+      RelativePathPiece(),
+      mount.getTreeInode(RelativePathPiece()),
+      /*fileBlobsToPrefetch=*/nullptr,
+      globResults,
+      kZeroRootId);
+
+  // The walk is abandoned before expanding anything.
+  EXPECT_THROW(std::move(fut).get(), folly::OperationCancelled);
+  EXPECT_TRUE(globResults.rlock()->empty());
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/common/utils/benchharness/Bench.h"
+
+#include <fmt/core.h>
+
+#include "eden/fs/inodes/EdenMount.h"
+#include "eden/fs/inodes/InodeMap.h"
+#include "eden/fs/testharness/FakeTreeBuilder.h"
+#include "eden/fs/testharness/TestMount.h"
+
+namespace {
+
+using namespace facebook::eden;
+
+constexpr size_t kFileCount = 256;
+
+/**
+ * Builds a mount with kFileCount files, loads them all, and records their
+ * inode numbers so the benchmarks below can exercise the loaded-inode fast
+ * path of InodeMap::lookupInode().
+ */
+struct LoadedMount {
+  LoadedMount() {
+    FakeTreeBuilder builder;
+    for (size_t i = 0; i < kFileCount; ++i) {
+      builder.setFile(fmt::format("dir/file{:03}.txt", i), "contents\n");
+    }
+    mount = std::make_unique<TestMount>(builder);
+    inodeNumbers.reserve(kFileCount);
+    for (size_t i = 0; i < kFileCount; ++i) {
+      inodeNumbers.push_back(
+          mount->getFileInode(fmt::format("dir/file{:03}.txt", i))
+              ->getNodeId());
+    }
+  }
+
+  std::unique_ptr<TestMount> mount;
+  std::vector<InodeNumber> inodeNumbers;
+};
+
+void InodeMap_lookup_loaded_inode(benchmark::State& state) {
+  LoadedMount loaded;
+  auto* inodeMap = loaded.mount->getEdenMount()->getInodeMap();
+  uint64_t processed = 0;
+  for (auto _ : state) {
+    auto inode =
+        inodeMap->lookupInode(loaded.inodeNumbers[processed % kFileCount])
+            .get();
+    benchmark::DoNotOptimize(inode);
+    processed++;
+  }
+  state.SetItemsProcessed(processed);
+}
+BENCHMARK(InodeMap_lookup_loaded_inode);
+
+void InodeMap_lookup_same_inode(benchmark::State& state) {
+  LoadedMount loaded;
+  auto* inodeMap = loaded.mount->getEdenMount()->getInodeMap();
+  auto number = loaded.inodeNumbers.front();
+  uint64_t processed = 0;
+  for (auto _ : state) {
+    auto inode = inodeMap->lookupInode(number).get();
+    benchmark::DoNotOptimize(inode);
+    processed++;
+  }
+  state.SetItemsProcessed(processed);
+}
+BENCHMARK(InodeMap_lookup_same_inode);
+
+} // namespace
+
+EDEN_BENCHMARK_MAIN();
@@ -144,6 +144,62 @@ TEST(InodeMap, asyncLookup) {
   EXPECT_EQ(srcTree.get(), srcTree2.get());
 }
 
+TEST(InodeMap, concurrentLookupsShareOneLoad) {
+  auto builder = FakeTreeBuilder();
+  builder.setFile("a/b/file.txt", "this is a test file");
+  TestMount testMount{builder, false};
+  const auto& edenMount = testMount.getEdenMount();
+  auto* inodeMap = edenMount->getInodeMap();
+
+  // Load "a" and "a/b" by path to find their inode numbers, then unload
+  // them again so they can be looked up by number.
+  auto root = edenMount->getRootInode();
+  auto aFuture =
+      edenMount->getInodeSlow("a"_relpath, ObjectFetchContext::getNullContext())
+          .semi()
+          .via(testMount.getServerExecutor().get());
+  auto bFuture =
+      edenMount
+          ->getInodeSlow("a/b"_relpath, ObjectFetchContext::getNullContext())
+          .semi()
+          .via(testMount.getServerExecutor().get());
+  builder.setReady("a");
+  builder.setReady("a/b");
+  testMount.drainServerExecutor();
+  InodeNumber bn;
+  {
+    auto a = std::move(aFuture).get(0ms).asTreePtr();
+    a->incFsRefcount();
+    {
+      auto b = std::move(bFuture).get(0ms);
+      bn = b->getNodeId();
+      b->incFsRefcount();
+    }
+    a->unloadChildrenNow(); // Unloads b
+  }
+  root->unloadChildrenNow(); // Unloads a
+
+  // Issue several lookups before letting the load make progress. The first
+  // one starts the load; the others only attach to its wait list.
+  auto future1 = inodeMap->lookupTreeInode(bn).semi().via(
+      testMount.getServerExecutor().get());
+  auto future2 = inodeMap->lookupTreeInode(bn).semi().via(
+      testMount.getServerExecutor().get());
+  auto future3 = inodeMap->lookupTreeInode(bn).semi().via(
+      testMount.getServerExecutor().get());
+  EXPECT_FALSE(future1.isReady());
+  EXPECT_FALSE(future2.isReady());
+  EXPECT_FALSE(future3.isReady());
+
+  testMount.drainServerExecutor();
+  auto b1 = std::move(future1).get(0ms);
+  auto b2 = std::move(future2).get(0ms);
+  auto b3 = std::move(future3).get(0ms);
+  EXPECT_EQ(bn, b1->getNodeId());
+  EXPECT_EQ(b1.get(), b2.get());
+  EXPECT_EQ(b1.get(), b3.get());
+}
+
 TEST(InodeMap, asyncError) {
   auto builder = FakeTreeBuilder();
   builder.setFile("README", "docs go here\n");
@@ -558,6 +614,47 @@ TEST(InodeMap, unloadedFileMetadataIsForgotten) {
   EXPECT_FALSE(mount.hasMetadata(file1ino));
   EXPECT_FALSE(mount.hasMetadata(file2ino));
 }
+
+TEST(InodeMap, batchedForgetReleasesReferences) {
+  FakeTreeBuilder builder;
+  builder.setFile("dir1/file.txt", "contents");
+  builder.setFile("dir2/file.txt", "contents");
+  TestMount mount{builder};
+  auto edenMount = mount.getEdenMount();
+
+  auto dir1 = mount.getTreeInode("dir1"_relpath);
+  auto dir2 = mount.getTreeInode("dir2"_relpath);
+
+  auto file1 = mount.getFileInode("dir1/file.txt"_relpath);
+  auto file1ino = file1->getNodeId();
+  auto file2 = mount.getFileInode("dir2/file.txt"_relpath);
+  auto file2ino = file2->getNodeId();
+
+  file1->incFsRefcount();
+  file2->incFsRefcount();
+  file1.reset();
+  file2.reset();
+
+  dir1->unlink(
+          PathComponentPiece{"file.txt"},
+          InvalidationRequired::No,
+          ObjectFetchContext::getNullContext())
+      .get(0ms);
+  dir2->unlink(
+          PathComponentPiece{"file.txt"},
+          InvalidationRequired::No,
+          ObjectFetchContext::getNullContext())
+      .get(0ms);
+
+  EXPECT_TRUE(mount.hasMetadata(file1ino));
+  EXPECT_TRUE(mount.hasMetadata(file2ino));
+
+  // A single batched decrement behaves like one decFsRefcount call per
+  // entry.
+  edenMount->getInodeMap()->decFsRefcounts({{file1ino, 1}, {file2ino, 1}});
+  EXPECT_FALSE(mount.hasMetadata(file1ino));
+  EXPECT_FALSE(mount.hasMetadata(file2ino));
+}
 #endif
 
 struct InodePersistenceTreeTest : ::testing::Test {
@@ -593,6 +690,10 @@ struct InodePersistenceTakeoverTest : InodePersistenceTreeTest {
     tree.reset();
     file1.reset();
     file2.reset();
+    if (lazyHydration_) {
+      testMount.updateEdenConfig(
+          {{"experimental:lazy-takeover-inode-hydration", "true"}});
+    }
 #ifdef _WIN32
     // Windows doesn't support graceful restart yet. Here these tests help
     // test the consistency of the overlay. On Windows we are using Sqlite
@@ -611,6 +712,18 @@ struct InodePersistenceTakeoverTest : InodePersistenceTreeTest {
   InodeNumber oldTreeId;
   InodeNumber oldFile1Id;
   InodeNumber oldFile2Id;
+
+  /**
+   * When true, the remounted InodeMap hydrates takeover records on first
+   * access instead of all up front.
+   */
+  bool lazyHydration_ = false;
+};
+
+struct InodePersistenceLazyTakeoverTest : InodePersistenceTakeoverTest {
+  InodePersistenceLazyTakeoverTest() {
+    lazyHydration_ = true;
+  }
 };
 
 TEST_F(
@@ -685,6 +798,30 @@ TEST_F(
   EXPECT_EQ(oldFile1Id, file1->getNodeId());
   EXPECT_EQ(oldFile2Id, file2->getNodeId());
 }
+
+TEST_F(
+    InodePersistenceLazyTakeoverTest,
+    hydratesTakeoverRecordsOnFirstAccess) {
+  auto* inodeMap = edenMount->getInodeMap();
+
+  // The takeover records must be visible before they are hydrated.
+  EXPECT_TRUE(inodeMap->isInodeRemembered(oldTreeId));
+  EXPECT_TRUE(inodeMap->isInodeRemembered(oldFile1Id));
+  EXPECT_TRUE(inodeMap->isInodeRemembered(oldFile2Id));
+  EXPECT_EQ(3, inodeMap->getInodeCounts().unloadedInodeCount);
+
+  // Looking up by inode number hydrates records on demand, including the
+  // walk from a file record up to its unhydrated parent.
+  auto file1Fut = inodeMap->lookupInode(oldFile1Id).semi().via(
+      testMount.getServerExecutor().get());
+  testMount.drainServerExecutor();
+  EXPECT_EQ("dir/file1.txt", std::move(file1Fut).get(0ms)->getLogPath());
+
+  // Untouched records keep working through the name lookup path too.
+  auto file2 = testMount.getInode("dir/file2.txt"_relpath);
+  EXPECT_EQ(oldFile2Id, file2->getNodeId());
+  EXPECT_EQ(1, file2->debugGetFsRefcount());
+}
 #endif
 
 /**
@@ -233,6 +233,40 @@ TEST_F(OverlayTest, roundTripThroughSaveAndLoad) {
   EXPECT_TRUE(two.isMaterialized());
 }
 
+TEST_F(OverlayTest, sizeCheckTracksDataSizeAndHardLimit) {
+  // Materialize a file so the overlay contains some data.
+  mount_.overwriteFile("dir/a.txt", "contents changed\n");
+  auto overlay = mount_.getEdenMount()->getOverlay();
+
+  // A tiny hard limit should trip after measurement.
+  overlay->checkOverlaySize(0, 1);
+  overlay->flushPendingAsync().get();
+  EXPECT_GT(overlay->getDataSize(), 0);
+  EXPECT_TRUE(overlay->isOverHardSizeLimit());
+
+  // A generous hard limit clears the flag again.
+  overlay->checkOverlaySize(0, 1ull << 40);
+  overlay->flushPendingAsync().get();
+  EXPECT_FALSE(overlay->isOverHardSizeLimit());
+
+  // A limit of 0 disables the check entirely.
+  overlay->checkOverlaySize(0, 0);
+  overlay->flushPendingAsync().get();
+  EXPECT_FALSE(overlay->isOverHardSizeLimit());
+}
+
+TEST_F(OverlayTest, allocateInodeNumberRange) {
+  auto overlay = mount_.getEdenMount()->getOverlay();
+
+  auto before = overlay->allocateInodeNumber();
+  auto first = overlay->allocateInodeNumberRange(1000);
+  auto after = overlay->allocateInodeNumber();
+
+  // The range is contiguous and does not overlap neighboring allocations.
+  EXPECT_EQ(before.get() + 1, first.get());
+  EXPECT_EQ(first.get() + 1000, after.get());
+}
+
 TEST_F(OverlayTest, getFilePath) {
   InodePath path;
 
@@ -293,6 +327,49 @@ TEST(PlainOverlayTest, reopened_overlay_is_clean) {
   EXPECT_TRUE(overlay->hadCleanStartup());
 }
 
+TEST(PlainOverlayTest, direct_file_creation_round_trips) {
+  folly::test::TemporaryDirectory testDir;
+  auto localDir = canonicalPath(testDir.path().string());
+  auto config = EdenConfig::createTestEdenConfig();
+  config->overlayDirectFileCreation.setValue(
+      true, ConfigSourceType::Default, true);
+
+  InodeNumber ino;
+  {
+    auto overlay = Overlay::create(
+        localDir,
+        kPathMapDefaultCaseSensitive,
+        kInodeCatalogType,
+        kInodeCatalogOptions,
+        std::make_shared<NullStructuredLogger>(),
+        makeRefPtr<EdenStats>(),
+        true,
+        *config);
+    overlay->initialize(config).get();
+    ino = overlay->allocateInodeNumber();
+    overlay->createOverlayFile(ino, folly::ByteRange{"contents"_sp});
+    overlay->close();
+  }
+
+  // The file must read back identically to one created via the atomic path.
+  auto overlay = Overlay::create(
+      localDir,
+      kPathMapDefaultCaseSensitive,
+      kInodeCatalogType,
+      kInodeCatalogOptions,
+      std::make_shared<NullStructuredLogger>(),
+      makeRefPtr<EdenStats>(),
+      true,
+      *EdenConfig::createTestEdenConfig());
+  overlay->initialize(EdenConfig::createTestEdenConfig()).get();
+  auto file = overlay->openFile(ino, FsFileContentStore::kHeaderIdentifierFile);
+  EXPECT_TRUE(
+      file.lseek(FsFileContentStore::kHeaderLength, SEEK_SET).hasValue());
+  auto result = file.readFile();
+  EXPECT_FALSE(result.hasError());
+  EXPECT_EQ("contents", result.value());
+}
+
 TEST(PlainOverlayTest, unclean_overlay_is_dirty) {
   folly::test::TemporaryDirectory testDir;
   auto localDir = canonicalPath(testDir.path().string());
@@ -327,6 +404,102 @@ TEST(PlainOverlayTest, unclean_overlay_is_dirty) {
   EXPECT_FALSE(overlay->hadCleanStartup());
 }
 
+TEST(PlainOverlayTest, open_dirty_skips_scan_but_preserves_inode_numbers) {
+  folly::test::TemporaryDirectory testDir;
+  auto localDir = canonicalPath(testDir.path().string());
+
+  InodeNumber ino;
+  {
+    auto overlay = Overlay::create(
+        localDir,
+        kPathMapDefaultCaseSensitive,
+        kInodeCatalogType,
+        kInodeCatalogOptions,
+        std::make_shared<NullStructuredLogger>(),
+        makeRefPtr<EdenStats>(),
+        true,
+        *EdenConfig::createTestEdenConfig());
+    overlay->initialize(EdenConfig::createTestEdenConfig()).get();
+    ino = overlay->allocateInodeNumber();
+    overlay->createOverlayFile(ino, folly::ByteRange{"contents"_sp});
+    overlay->close();
+  }
+
+  if (unlink((localDir + "next-inode-number"_pc).c_str())) {
+    folly::throwSystemError("removing saved inode number");
+  }
+
+  auto config = EdenConfig::createTestEdenConfig();
+  config->fsckOpenDirty.setValue(true, ConfigSourceType::Default, true);
+  auto overlay = Overlay::create(
+      localDir,
+      kPathMapDefaultCaseSensitive,
+      kInodeCatalogType,
+      kInodeCatalogOptions,
+      std::make_shared<NullStructuredLogger>(),
+      makeRefPtr<EdenStats>(),
+      true,
+      *config);
+  overlay->initialize(config).get();
+  EXPECT_FALSE(overlay->hadCleanStartup());
+  // The name-only shard scan must still account for existing entries so that
+  // new inode numbers do not collide with them.
+  EXPECT_GT(overlay->allocateInodeNumber(), ino);
+}
+
+TEST(PlainOverlayTest, inode_number_checkpoint_avoids_fsck_scan) {
+  folly::test::TemporaryDirectory testDir;
+  auto localDir = canonicalPath(testDir.path().string());
+  auto checkpointPath = localDir + "inode-number-checkpoint"_pc;
+
+  auto config = EdenConfig::createTestEdenConfig();
+  config->overlayInodeNumberCheckpointing.setValue(
+      true, ConfigSourceType::Default, true);
+
+  InodeNumber ino;
+  std::string checkpointContents;
+  {
+    auto overlay = Overlay::create(
+        localDir,
+        kPathMapDefaultCaseSensitive,
+        kInodeCatalogType,
+        kInodeCatalogOptions,
+        std::make_shared<NullStructuredLogger>(),
+        makeRefPtr<EdenStats>(),
+        true,
+        *config);
+    overlay->initialize(config).get();
+    ino = overlay->allocateInodeNumber();
+    overlay->createOverlayFile(ino, folly::ByteRange{"contents"_sp});
+
+    // The first allocation persisted a checkpoint ahead of the numbers
+    // handed out so far.  Save its contents: a clean close removes it, so we
+    // restore it below to simulate a crash.
+    ASSERT_TRUE(folly::readFile(checkpointPath.c_str(), checkpointContents));
+    overlay->close();
+  }
+
+  if (unlink((localDir + "next-inode-number"_pc).c_str())) {
+    folly::throwSystemError("removing saved inode number");
+  }
+  ASSERT_TRUE(folly::writeFile(checkpointContents, checkpointPath.c_str()));
+
+  auto overlay = Overlay::create(
+      localDir,
+      kPathMapDefaultCaseSensitive,
+      kInodeCatalogType,
+      kInodeCatalogOptions,
+      std::make_shared<NullStructuredLogger>(),
+      makeRefPtr<EdenStats>(),
+      true,
+      *config);
+  overlay->initialize(config).get();
+  EXPECT_FALSE(overlay->hadCleanStartup());
+  // The checkpoint is an upper bound on everything allocated before the
+  // crash, so new numbers must not collide with existing entries.
+  EXPECT_GT(overlay->allocateInodeNumber(), ino);
+}
+
 enum class OverlayRestartMode {
   CLEAN,
   UNCLEAN,
@@ -7,6 +7,7 @@
 
 #include "eden/fs/inodes/TreeInode.h"
 
+#include <fmt/format.h>
 #include <folly/Exception.h>
 #include <folly/Random.h>
 #include <folly/executors/ManualExecutor.h>
@@ -107,6 +108,38 @@ TEST(TreeInode, findEntryDifferencesWithOneAddition) {
   EXPECT_EQ((std::vector<std::string>{"+ three"}), *differences);
 }
 
+TEST(TreeInode, childrenMaterializedMarksChildrenAndParents) {
+  FakeTreeBuilder builder;
+  builder.setFiles({{"dir/a.txt", "a"}, {"dir/b.txt", "b"}, {"dir/c.txt", "c"}});
+  TestMount mount{builder};
+
+  auto dir = mount.getTreeInode("dir");
+  EXPECT_TRUE(dir->getObjectId().has_value());
+
+  {
+    auto renameLock = mount.getEdenMount()->acquireRenameLock();
+    dir->childrenMaterialized(renameLock, {"a.txt"_pc, "b.txt"_pc});
+  }
+
+  // The directory and its parent are materialized now, along with exactly the
+  // children that were in the batch.
+  EXPECT_EQ(std::nullopt, dir->getObjectId());
+  EXPECT_EQ(std::nullopt, mount.getRootInode()->getObjectId());
+  {
+    auto contents = dir->getContents().rlock();
+    EXPECT_TRUE(contents->entries.find("a.txt"_pc)->second.isMaterialized());
+    EXPECT_TRUE(contents->entries.find("b.txt"_pc)->second.isMaterialized());
+    EXPECT_FALSE(contents->entries.find("c.txt"_pc)->second.isMaterialized());
+  }
+
+  // A batch of already-materialized children is a no-op.
+  {
+    auto renameLock = mount.getEdenMount()->acquireRenameLock();
+    dir->childrenMaterialized(renameLock, {"a.txt"_pc, "b.txt"_pc});
+  }
+  EXPECT_EQ(std::nullopt, dir->getObjectId());
+}
+
 #ifndef _WIN32
 TEST(TreeInode, fuseReaddirReturnsSelfAndParentBeforeEntries) {
   // libfuse's documentation says returning . and .. is optional, but the FUSE
@@ -200,6 +233,67 @@ TEST(TreeInode, fuseReaddirRespectsOffset) {
   EXPECT_EQ(0, resultE.size());
 }
 
+TEST(TreeInode, fuseReaddirLargeDirectory) {
+  // Large directories must be listed completely, with strictly increasing
+  // offsets.
+  FakeTreeBuilder builder;
+  for (int i = 0; i < 300; ++i) {
+    builder.setFile(fmt::format("file{:03}", i), "");
+  }
+  TestMount mount{builder};
+
+  auto root = mount.getEdenMount()->getRootInode();
+  auto result =
+      root->fuseReaddir(
+              FuseDirList{1 << 20}, 0, ObjectFetchContext::getNullContext())
+          .extract();
+
+  // ".", "..", the 300 files, and ".eden".
+  ASSERT_EQ(303, result.size());
+  EXPECT_EQ(".", result[0].name);
+  EXPECT_EQ("..", result[1].name);
+  for (size_t i = 3; i < result.size(); ++i) {
+    EXPECT_LT(result[i - 1].offset, result[i].offset);
+  }
+}
+
+TEST(TreeInode, fuseReaddirPagedListingReturnsEveryEntryOnce) {
+  // Page through a directory with a small buffer, as the FUSE kernel module
+  // does. Continuations after the first call resume from the cached readdir
+  // cursor, and the whole listing must still contain every entry exactly
+  // once.
+  FakeTreeBuilder builder;
+  for (int i = 0; i < 100; ++i) {
+    builder.setFile(fmt::format("file{:03}", i), "");
+  }
+  TestMount mount{builder};
+
+  auto root = mount.getEdenMount()->getRootInode();
+
+  std::unordered_map<std::string, unsigned> seen;
+  FileOffset lastOffset = 0;
+  for (;;) {
+    auto result = root->fuseReaddir(
+                          FuseDirList{500},
+                          lastOffset,
+                          ObjectFetchContext::getNullContext())
+                      .extract();
+    if (result.empty()) {
+      break;
+    }
+    lastOffset = result.back().offset;
+    for (auto& entry : result) {
+      ++seen[entry.name];
+    }
+  }
+
+  // ".", "..", the 100 files, and ".eden".
+  EXPECT_EQ(103, seen.size());
+  for (auto& [name, count] : seen) {
+    EXPECT_EQ(1, count) << name << " was returned " << count << " times";
+  }
+}
+
 TEST(TreeInode, fuseReaddirIgnoresWildOffsets) {
   TestMount mount{FakeTreeBuilder{}};
 
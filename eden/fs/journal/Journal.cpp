@@ -7,6 +7,7 @@
 
 #include "eden/fs/journal/Journal.h"
 #include <folly/logging/xlog.h>
+#include <limits>
 #include "eden/fs/journal/JournalDelta.h"
 
 namespace facebook::eden {
@@ -34,20 +35,36 @@ JournalDeltaPtr Journal::DeltaState::frontPtr() noexcept {
 void Journal::DeltaState::popFront() {
   bool isFileChangeEmpty = fileChangeDeltas.empty();
   bool isHashUpdateEmpty = hashUpdateDeltas.empty();
+  bool popFileChange;
   if (!isFileChangeEmpty && !isHashUpdateEmpty) {
-    if (fileChangeDeltas.front().sequenceID <
-        hashUpdateDeltas.front().sequenceID) {
-      fileChangeDeltas.pop_front();
-    } else {
-      hashUpdateDeltas.pop_front();
-    }
+    popFileChange = fileChangeDeltas.front().sequenceID <
+        hashUpdateDeltas.front().sequenceID;
   } else if (!isFileChangeEmpty) {
-    fileChangeDeltas.pop_front();
+    popFileChange = true;
   } else if (!isHashUpdateEmpty) {
+    popFileChange = false;
+  } else {
+    return;
+  }
+  if (popFileChange) {
+    if (recycledDeltas.size() < kMaxRecycledDeltas) {
+      recycledDeltas.push_back(std::move(fileChangeDeltas.front()));
+    }
+    fileChangeDeltas.pop_front();
+  } else {
     hashUpdateDeltas.pop_front();
   }
 }
 
+FileChangeJournalDelta Journal::DeltaState::takeRecycledDelta() {
+  if (recycledDeltas.empty()) {
+    return FileChangeJournalDelta{};
+  }
+  auto delta = std::move(recycledDeltas.back());
+  recycledDeltas.pop_back();
+  return delta;
+}
+
 JournalDeltaPtr Journal::DeltaState::backPtr() noexcept {
   bool isFileChangeEmpty = fileChangeDeltas.empty();
   bool isHashUpdateEmpty = hashUpdateDeltas.empty();
@@ -99,32 +116,68 @@ void Journal::DeltaState::appendDelta(RootUpdateJournalDelta&& delta) {
 Journal::Journal(EdenStatsPtr edenStats) : edenStats_{std::move(edenStats)} {
   // Add 0 so that this counter shows up in ODS
   edenStats_->increment(&JournalStats::truncatedReads, 0);
+  notifierThread_ = std::thread([this] { notifierThread(); });
+}
+
+Journal::~Journal() {
+  XCHECK_NE(std::this_thread::get_id(), notifierThread_.get_id());
+  notifierState_.lock()->stop = true;
+  notifierCondVar_.notify_all();
+  if (notifierThread_.joinable()) {
+    notifierThread_.join();
+  }
+}
+
+Journal::Journal(EdenStatsPtr edenStats, AbsolutePathPiece overflowDir)
+    : Journal{std::move(edenStats)} {
+  try {
+    overflow_ = std::make_unique<JournalOverflow>(overflowDir);
+  } catch (const std::exception& ex) {
+    // The journal is fully functional without the overflow tier; queries
+    // past the memory limit just see truncated results as they used to.
+    XLOG(WARNING) << "journal overflow tier at " << overflowDir
+                  << " disabled: " << ex.what();
+  }
 }
 
 void Journal::recordCreated(RelativePathPiece fileName) {
-  addDelta(FileChangeJournalDelta(fileName, FileChangeJournalDelta::CREATED));
+  recordFileChange(fileName, FileChangeJournalDelta::CREATED);
 }
 
 void Journal::recordRemoved(RelativePathPiece fileName) {
-  addDelta(FileChangeJournalDelta(fileName, FileChangeJournalDelta::REMOVED));
+  recordFileChange(fileName, FileChangeJournalDelta::REMOVED);
 }
 
 void Journal::recordChanged(RelativePathPiece fileName) {
-  addDelta(FileChangeJournalDelta(fileName, FileChangeJournalDelta::CHANGED));
+  recordFileChange(fileName, FileChangeJournalDelta::CHANGED);
 }
 
 void Journal::recordRenamed(
     RelativePathPiece oldName,
     RelativePathPiece newName) {
-  addDelta(FileChangeJournalDelta(
-      oldName, newName, FileChangeJournalDelta::RENAMED));
+  recordFileChange(oldName, newName, FileChangeJournalDelta::RENAMED);
 }
 
 void Journal::recordReplaced(
     RelativePathPiece oldName,
     RelativePathPiece newName) {
-  addDelta(FileChangeJournalDelta(
-      oldName, newName, FileChangeJournalDelta::REPLACED));
+  recordFileChange(oldName, newName, FileChangeJournalDelta::REPLACED);
+}
+
+void Journal::recordBatch(std::vector<FileChangeJournalDelta>&& changes) {
+  if (changes.empty()) {
+    return;
+  }
+  bool shouldNotify = false;
+  {
+    auto deltaState = deltaState_.lock();
+    for (auto& change : changes) {
+      shouldNotify |= addDeltaBeforeNotifying(std::move(change), *deltaState);
+    }
+  }
+  if (shouldNotify) {
+    notifySubscribers();
+  }
 }
 
 void Journal::recordHashUpdate(RootId toHash) {
@@ -153,16 +206,102 @@ void Journal::recordUncleanPaths(
   addDelta(std::move(delta), std::move(toHash));
 }
 
+namespace {
+
+/**
+ * Folds one evicted delta into the segment being spilled. Eviction walks
+ * the journal oldest to newest, so for a path seen twice the oldest
+ * existedBefore and the newest existedAfter win, and snapshotTransitions
+ * is built oldest first and reversed before spilling.
+ */
+void foldIntoSegment(
+    JournalOverflow::Segment& segment,
+    const FileChangeJournalDelta& delta) {
+  ++segment.filesAccumulated;
+  for (const auto& [name, info] : delta.getChangedFilesInOverlay()) {
+    auto* existing = folly::get_ptr(segment.changedFilesInOverlay, name);
+    if (existing) {
+      existing->existedAfter = info.existedAfter;
+    } else {
+      segment.changedFilesInOverlay.emplace(name, info);
+    }
+  }
+}
+
+void foldIntoSegment(
+    JournalOverflow::Segment& segment,
+    const RootUpdateJournalDelta& delta) {
+  segment.snapshotTransitions.push_back(delta.fromHash);
+  segment.uncleanPaths.insert(
+      delta.uncleanPaths.begin(), delta.uncleanPaths.end());
+}
+
+} // namespace
+
 void Journal::truncateIfNecessary(DeltaState& deltaState) {
+  if (estimateMemoryUsage(deltaState) <= deltaState.memoryLimit) {
+    return;
+  }
+
+  // With an overflow tier, evict down past the limit so each spill covers
+  // a run of deltas; evicting exactly to the limit would produce one tiny
+  // segment file per subsequently added delta.
+  const size_t target = overflow_
+      ? deltaState.memoryLimit - deltaState.memoryLimit / 10
+      : deltaState.memoryLimit;
+
+  std::optional<JournalOverflow::Segment> spilled;
   while (JournalDeltaPtr front = deltaState.frontPtr()) {
-    if (estimateMemoryUsage(deltaState) <= deltaState.memoryLimit) {
+    if (estimateMemoryUsage(deltaState) <= target) {
       break;
     }
+    if (overflow_) {
+      if (!spilled) {
+        spilled.emplace();
+        spilled->fromSequence = front->sequenceID;
+        spilled->fromTime = front->time;
+      }
+      spilled->toSequence = front->sequenceID;
+      spilled->toTime = front->time;
+      if (deltaState.isFileChangeInFront()) {
+        foldIntoSegment(*spilled, deltaState.fileChangeDeltas.front());
+      } else {
+        foldIntoSegment(*spilled, deltaState.hashUpdateDeltas.front());
+      }
+    }
     deltaState.stats->entryCount--;
 
     deltaState.deltaMemoryUsage -= front.estimateMemoryUsage();
     deltaState.popFront();
   }
+  if (spilled) {
+    std::reverse(
+        spilled->snapshotTransitions.begin(),
+        spilled->snapshotTransitions.end());
+    overflow_->spill(*spilled);
+  }
+  dropTruncatedCheckpoints(deltaState);
+}
+
+void Journal::dropTruncatedCheckpoints(DeltaState& deltaState) {
+  if (deltaState.checkpoints.empty()) {
+    return;
+  }
+  if (deltaState.empty()) {
+    deltaState.checkpoints.clear();
+    deltaState.checkpointMemoryUsage = 0;
+    return;
+  }
+  const auto frontSequenceID = deltaState.getFrontSequenceID();
+  for (auto it = deltaState.checkpoints.begin();
+       it != deltaState.checkpoints.end();) {
+    if (it->first + kCheckpointBlockSize - 1 < frontSequenceID) {
+      deltaState.checkpointMemoryUsage -= it->second.estimateMemoryUsage();
+      it = deltaState.checkpoints.erase(it);
+    } else {
+      ++it;
+    }
+  }
 }
 
 bool Journal::compact(FileChangeJournalDelta& delta, DeltaState& deltaState) {
@@ -221,17 +360,109 @@ bool Journal::addDeltaBeforeNotifying(T&& delta, DeltaState& deltaState) {
   return shouldNotify;
 }
 
-void Journal::notifySubscribers() const {
-  auto subscribers = subscriberState_.rlock()->subscribers;
-  for (auto& sub : subscribers) {
-    sub.second();
+void Journal::notifySubscribers() {
+  ++notifierState_.lock()->publishedGeneration;
+  notifierCondVar_.notify_all();
+}
+
+void Journal::notifierThread() noexcept {
+  uint64_t lastDelivered = 0;
+  for (;;) {
+    uint64_t generation;
+    {
+      auto lock = notifierState_.lock();
+      while (!lock->stop && lock->publishedGeneration == lastDelivered) {
+        notifierCondVar_.wait(lock.as_lock());
+      }
+      if (lock->stop) {
+        return;
+      }
+      generation = lock->publishedGeneration;
+    }
+
+    // Generations published while the previous delivery was running are
+    // folded into this one; subscribers coalesce notifications anyway, so
+    // they only need to learn that something changed since they last
+    // looked.
+    const uint64_t coalesced = generation - lastDelivered - 1;
+
+    // Snapshot the callbacks so they run without the subscriber lock held;
+    // a callback may cancel its own subscription.
+    std::vector<std::pair<SubscriberId, SubscriberCallback>> callbacks;
+    {
+      auto subscriberState = subscriberState_.rlock();
+      callbacks.reserve(subscriberState->subscribers.size());
+      for (const auto& sub : subscriberState->subscribers) {
+        callbacks.emplace_back(sub.first, sub.second.callback);
+      }
+    }
+
+    std::vector<SubscriberId> slowSubscribers;
+    for (auto& callback : callbacks) {
+      const auto start = std::chrono::steady_clock::now();
+      try {
+        callback.second();
+      } catch (const std::exception& ex) {
+        XLOG(ERR) << "journal subscriber " << callback.first
+                  << " threw: " << ex.what();
+      }
+      const auto elapsed = std::chrono::steady_clock::now() - start;
+      if (elapsed >= kSlowSubscriberThreshold) {
+        XLOG(WARN) << "journal subscriber " << callback.first << " took "
+                   << std::chrono::duration_cast<std::chrono::milliseconds>(
+                          elapsed)
+                          .count()
+                   << "ms to handle a change notification";
+        slowSubscribers.push_back(callback.first);
+      }
+    }
+
+    if (!callbacks.empty()) {
+      auto subscriberState = subscriberState_.wlock();
+      for (const auto& callback : callbacks) {
+        auto iter = subscriberState->subscribers.find(callback.first);
+        if (iter != subscriberState->subscribers.end()) {
+          ++iter->second.notificationsDelivered;
+          iter->second.notificationsCoalesced += coalesced;
+        }
+      }
+      for (auto id : slowSubscribers) {
+        auto iter = subscriberState->subscribers.find(id);
+        if (iter != subscriberState->subscribers.end()) {
+          ++iter->second.slowDeliveries;
+        }
+      }
+    }
+    edenStats_->increment(
+        &JournalStats::subscriberNotificationsDelivered, callbacks.size());
+    if (!slowSubscribers.empty()) {
+      edenStats_->increment(
+          &JournalStats::slowSubscriberDeliveries, slowSubscribers.size());
+    }
+
+    {
+      notifierState_.lock()->deliveredGeneration = generation;
+    }
+    notifierCondVar_.notify_all();
+    lastDelivered = generation;
+  }
+}
+
+void Journal::waitForPendingNotifications() {
+  auto lock = notifierState_.lock();
+  const auto target = lock->publishedGeneration;
+  while (!lock->stop && lock->deliveredGeneration < target) {
+    notifierCondVar_.wait(lock.as_lock());
   }
 }
 
-void Journal::addDelta(FileChangeJournalDelta&& delta) {
+template <typename... Args>
+void Journal::recordFileChange(Args&&... args) {
   bool shouldNotify;
   {
     auto deltaState = deltaState_.lock();
+    auto delta = deltaState->takeRecycledDelta();
+    delta.reset(std::forward<Args>(args)...);
     shouldNotify = addDeltaBeforeNotifying(std::move(delta), *deltaState);
   }
   if (shouldNotify) {
@@ -281,7 +512,7 @@ std::optional<JournalDeltaInfo> Journal::getLatest() {
 uint64_t Journal::registerSubscriber(SubscriberCallback&& callback) {
   auto subscriberState = subscriberState_.wlock();
   auto id = subscriberState->nextSubscriberId++;
-  subscriberState->subscribers[id] = std::move(callback);
+  subscriberState->subscribers[id].callback = std::move(callback);
   return id;
 }
 
@@ -292,7 +523,7 @@ void Journal::cancelSubscriber(uint64_t id) {
     return;
   }
   // Extend the lifetime of the value we're removing
-  auto callback = std::move(it->second);
+  auto callback = std::move(it->second.callback);
   subscriberState->subscribers.erase(it);
   // release the lock before we trigger the destructor
   subscriberState.unlock();
@@ -303,7 +534,7 @@ void Journal::cancelAllSubscribers() {
   // Take care: some subscribers will attempt to call cancelSubscriber()
   // as part of their tear down, so we need to make sure that we aren't
   // holding the lock when we trigger that.
-  std::unordered_map<SubscriberId, SubscriberCallback> subscribers;
+  std::unordered_map<SubscriberId, Subscriber> subscribers;
   subscriberState_.wlock()->subscribers.swap(subscribers);
   subscribers.clear();
 }
@@ -314,6 +545,20 @@ bool Journal::isSubscriberValid(uint64_t id) const {
   return subscribers.find(id) != subscribers.end();
 }
 
+std::vector<JournalSubscriberStats> Journal::getSubscriberStats() const {
+  auto subscriberState = subscriberState_.rlock();
+  std::vector<JournalSubscriberStats> stats;
+  stats.reserve(subscriberState->subscribers.size());
+  for (const auto& sub : subscriberState->subscribers) {
+    stats.push_back(JournalSubscriberStats{
+        sub.first,
+        sub.second.notificationsDelivered,
+        sub.second.notificationsCoalesced,
+        sub.second.slowDeliveries});
+  }
+  return stats;
+}
+
 std::optional<InternalJournalStats> Journal::getStats() {
   return deltaState_.lock()->stats;
 }
@@ -368,6 +613,37 @@ size_t Journal::estimateMemoryUsage(const DeltaState& deltaState) const {
   return memoryUsage;
 }
 
+size_t Journal::JournalCheckpoint::estimateMemoryUsage() const {
+  size_t mem = folly::goodMallocSize(sizeof(JournalCheckpoint));
+
+  /* NOTE: The following code assumes an unordered_map and unordered_set are
+   * separated into an array of buckets, each one being a chain of nodes
+   * containing a next pointer, a key-value pair, and a stored hash
+   */
+  size_t map_elem_size = folly::goodMallocSize(
+      sizeof(void*) + sizeof(decltype(changedFilesInOverlay)::value_type) +
+      sizeof(size_t));
+  mem += map_elem_size * changedFilesInOverlay.size();
+  mem += folly::goodMallocSize(
+      sizeof(void*) * changedFilesInOverlay.bucket_count());
+  for (const auto& entry : changedFilesInOverlay) {
+    mem += facebook::eden::estimateIndirectMemoryUsage(entry.first);
+  }
+
+  size_t set_elem_size = folly::goodMallocSize(
+      sizeof(void*) + sizeof(decltype(uncleanPaths)::value_type) +
+      sizeof(size_t));
+  mem += set_elem_size * uncleanPaths.size();
+  mem += folly::goodMallocSize(sizeof(void*) * uncleanPaths.bucket_count());
+  for (const auto& path : uncleanPaths) {
+    mem += facebook::eden::estimateIndirectMemoryUsage(path);
+  }
+
+  mem += folly::goodMallocSize(snapshotTransitions.capacity() * sizeof(RootId));
+
+  return mem;
+}
+
 void Journal::flush() {
   bool shouldNotify;
   {
@@ -376,6 +652,12 @@ void Journal::flush() {
     auto lastHash = deltaState->currentHash;
     deltaState->fileChangeDeltas.clear();
     deltaState->hashUpdateDeltas.clear();
+    deltaState->checkpoints.clear();
+    deltaState->checkpointMemoryUsage = 0;
+    if (overflow_) {
+      // flush() deliberately truncates all history.
+      overflow_->clear();
+    }
     deltaState->stats = std::nullopt;
     auto delta = RootUpdateJournalDelta();
     /* Tracking the hash correctly when the journal is flushed is important
@@ -394,28 +676,284 @@ void Journal::flush() {
 }
 
 std::unique_ptr<JournalDeltaRange> Journal::accumulateRange(
-    SequenceNumber from) {
+    SequenceNumber from,
+    const FileChangeFilter& filter) {
   XDCHECK(from > 0);
   std::unique_ptr<JournalDeltaRange> result = nullptr;
 
   size_t filesAccumulated = 0;
   auto deltaState = deltaState_.lock();
-  // If this is going to be truncated, handle it before iterating.
+
+  // When the range reaches past the in-memory deltas, decide up front
+  // whether the overflow tier can complete it; if it cannot, answer with
+  // a truncated result without accumulating anything, as before.
+  bool consultOverflow = false;
   if (!deltaState->empty() && deltaState->getFrontSequenceID() > from) {
-    result = std::make_unique<JournalDeltaRange>();
-    result->isTruncated = true;
+    consultOverflow = overflow_ &&
+        overflow_->getOldestSequence().value_or(
+            std::numeric_limits<SequenceNumber>::max()) <= from;
+    if (!consultOverflow) {
+      result = std::make_unique<JournalDeltaRange>();
+      result->isTruncated = true;
+      deltaState->lastModificationHasBeenObserved = true;
+      if (edenStats_) {
+        edenStats_->increment(&JournalStats::truncatedReads);
+      }
+      return result;
+    }
+  }
+
+  if (!deltaState->empty()) {
+    // The overflow tier holds everything older than the in-memory front.
+    const auto effectiveFrom =
+        std::max(from, deltaState->getFrontSequenceID());
+    auto fileChangeDeltaCallback =
+        [&](const FileChangeJournalDelta& current) -> void {
+      ++filesAccumulated;
+      if (!result) {
+        result = std::make_unique<JournalDeltaRange>();
+        result->toSequence = current.sequenceID;
+        result->toTime = current.time;
+        result->snapshotTransitions.push_back(deltaState->currentHash);
+      }
+      // Capture the lower bound.
+      result->fromSequence = current.sequenceID;
+      result->fromTime = current.time;
+
+      for (auto& entry : current.getChangedFilesInOverlay()) {
+        auto& name = entry.first;
+        auto& currentInfo = entry.second;
+        if (filter && !filter(name)) {
+          continue;
+        }
+        auto* resultInfo =
+            folly::get_ptr(result->changedFilesInOverlay, name);
+        if (!resultInfo) {
+          result->changedFilesInOverlay.emplace(name, currentInfo);
+        } else {
+          if (resultInfo->existedBefore != currentInfo.existedAfter) {
+            auto event1 = eventCharacterizationFor(currentInfo);
+            auto event2 = eventCharacterizationFor(*resultInfo);
+            XLOG(ERR) << "Journal for " << name << " holds invalid "
+                      << event1 << ", " << event2 << " sequence";
+          }
+
+          resultInfo->existedBefore = currentInfo.existedBefore;
+        }
+      }
+    };
+    auto hashUpdateDeltaCallback =
+        [&](const RootUpdateJournalDelta& current) -> void {
+      if (!result) {
+        result = std::make_unique<JournalDeltaRange>();
+        result->toSequence = current.sequenceID;
+        result->toTime = current.time;
+        result->snapshotTransitions.push_back(deltaState->currentHash);
+      }
+      // Capture the lower bound.
+      result->fromSequence = current.sequenceID;
+      result->fromTime = current.time;
+      result->snapshotTransitions.push_back(current.fromHash);
+
+      // Merge the unclean status list
+      if (filter) {
+        for (const auto& path : current.uncleanPaths) {
+          if (filter(path)) {
+            result->uncleanPaths.insert(path);
+          }
+        }
+      } else {
+        result->uncleanPaths.insert(
+            current.uncleanPaths.begin(), current.uncleanPaths.end());
+      }
+    };
+
+    // Deltas in the block still being appended to can still change (the
+    // newest delta may be compacted), so they are merged directly.
+    const auto tip = deltaState->nextSequence - 1;
+    auto blockStart = checkpointBlockStart(tip);
+    forEachDelta(
+        *deltaState,
+        std::max(effectiveFrom, blockStart),
+        tip,
+        std::nullopt,
+        fileChangeDeltaCallback,
+        hashUpdateDeltaCallback);
+
+    // Older blocks are immutable, so they are consumed through checkpoint
+    // summaries that are built and cached the first time they are
+    // accumulated. The oldest block is walked directly when 'from' starts
+    // partway into it.
+    while (blockStart > effectiveFrom) {
+      const auto blockEnd = blockStart - 1;
+      blockStart -= kCheckpointBlockSize;
+      if (blockStart >= effectiveFrom && !filter) {
+        mergeSummary(
+            getOrBuildCheckpoint(*deltaState, blockStart),
+            *result,
+            filesAccumulated,
+            filter);
+      } else {
+        // Filtered accumulations walk the deltas directly: checkpoints are
+        // unfiltered summaries, and caching one per subscriber filter would
+        // defeat the purpose of the cache.
+        forEachDelta(
+            *deltaState,
+            std::max(effectiveFrom, blockStart),
+            blockEnd,
+            std::nullopt,
+            fileChangeDeltaCallback,
+            hashUpdateDeltaCallback);
+      }
+    }
+
+    // Everything older than the in-memory front comes from spilled
+    // overflow segments, newest first. The filter is applied while
+    // merging, since segments are unfiltered summaries.
+    if (consultOverflow) {
+      bool allLoaded = overflow_->forEachSegment(
+          from, [&](JournalOverflow::Segment&& segment) {
+            if (!result) {
+              result = std::make_unique<JournalDeltaRange>();
+              result->toSequence = segment.toSequence;
+              result->toTime = segment.toTime;
+              result->snapshotTransitions.push_back(deltaState->currentHash);
+            }
+            mergeSummary(segment, *result, filesAccumulated, filter);
+          });
+      if (!allLoaded) {
+        if (!result) {
+          result = std::make_unique<JournalDeltaRange>();
+        }
+        result->isTruncated = true;
+      }
+    }
+  }
+
+  if (result) {
+    if (edenStats_) {
+      if (result->isTruncated) {
+        edenStats_->increment(&JournalStats::truncatedReads);
+      }
+      edenStats_->increment(&JournalStats::filesAccumulated, filesAccumulated);
+    }
+    if (deltaState->stats) {
+      deltaState->stats->maxFilesAccumulated =
+          std::max(deltaState->stats->maxFilesAccumulated, filesAccumulated);
+    }
+
+    std::reverse(
+        result->snapshotTransitions.begin(), result->snapshotTransitions.end());
+  }
+
+  deltaState->lastModificationHasBeenObserved = true;
+  return result;
+}
+
+std::unique_ptr<JournalDeltaRange> Journal::accumulatePage(
+    SequenceNumber from,
+    size_t maxDeltas) {
+  XDCHECK(from > 0);
+  XDCHECK(maxDeltas > 0);
+  std::unique_ptr<JournalDeltaRange> result = nullptr;
+
+  size_t filesAccumulated = 0;
+  auto deltaState = deltaState_.lock();
+
+  if (deltaState->empty()) {
+    deltaState->lastModificationHasBeenObserved = true;
+    return result;
+  }
+
+  const auto front = deltaState->getFrontSequenceID();
+  const auto tip = deltaState->nextSequence - 1;
+  if (from > tip) {
+    deltaState->lastModificationHasBeenObserved = true;
+    return result;
+  }
+
+  if (from < front) {
+    // The page starts below the in-memory deltas. If the overflow tier
+    // cannot complete it, answer with a truncated result, exactly like
+    // accumulateRange(). Otherwise the whole spilled portion forms one
+    // page; see the comment on accumulatePage() in the header.
+    if (!overflow_ ||
+        overflow_->getOldestSequence().value_or(
+            std::numeric_limits<SequenceNumber>::max()) > from) {
+      result = std::make_unique<JournalDeltaRange>();
+      result->isTruncated = true;
+      deltaState->lastModificationHasBeenObserved = true;
+      if (edenStats_) {
+        edenStats_->increment(&JournalStats::truncatedReads);
+      }
+      return result;
+    }
+
+    // The snapshot hash as of the newest spilled delta is the hash the
+    // oldest in-memory root update started from, or the current hash if
+    // every in-memory delta is a plain file change.
+    const RootId boundaryHash = deltaState->hashUpdateDeltas.empty()
+        ? deltaState->currentHash
+        : deltaState->hashUpdateDeltas.front().fromHash;
+
+    bool allLoaded = overflow_->forEachSegment(
+        from, [&](JournalOverflow::Segment&& segment) {
+          if (!result) {
+            result = std::make_unique<JournalDeltaRange>();
+            result->toSequence = segment.toSequence;
+            result->toTime = segment.toTime;
+            result->snapshotTransitions.push_back(boundaryHash);
+          }
+          mergeSummary(segment, *result, filesAccumulated, {});
+        });
+    if (!allLoaded) {
+      if (!result) {
+        result = std::make_unique<JournalDeltaRange>();
+      }
+      result->isTruncated = true;
+    }
+    if (result) {
+      // The next page resumes at the in-memory front even if the newest
+      // spilled segment stopped short of it.
+      result->toSequence = front - 1;
+      result->hasMoreDeltas = true;
+    }
   } else {
+    SequenceNumber pageEnd = tip;
+    if (maxDeltas < tip - from + 1) {
+      pageEnd = from + maxDeltas - 1;
+    }
+
+    // The snapshot hash as of pageEnd is the hash the oldest root update
+    // above the window started from, or the current hash when no root
+    // update happened after the window.
+    RootId windowHash = deltaState->currentHash;
+    if (pageEnd < tip) {
+      auto sequenceAfter = [](JournalDelta::SequenceNumber seq,
+                              const JournalDelta& delta) {
+        return seq < delta.sequenceID;
+      };
+      auto it = std::upper_bound(
+          deltaState->hashUpdateDeltas.begin(),
+          deltaState->hashUpdateDeltas.end(),
+          pageEnd,
+          sequenceAfter);
+      if (it != deltaState->hashUpdateDeltas.end()) {
+        windowHash = it->fromHash;
+      }
+    }
+
     forEachDelta(
         *deltaState,
         from,
+        pageEnd,
         std::nullopt,
         [&](const FileChangeJournalDelta& current) -> void {
           ++filesAccumulated;
           if (!result) {
             result = std::make_unique<JournalDeltaRange>();
-            result->toSequence = current.sequenceID;
             result->toTime = current.time;
-            result->snapshotTransitions.push_back(deltaState->currentHash);
+            result->snapshotTransitions.push_back(windowHash);
           }
           // Capture the lower bound.
           result->fromSequence = current.sequenceID;
@@ -443,19 +981,32 @@ std::unique_ptr<JournalDeltaRange> Journal::accumulateRange(
         [&](const RootUpdateJournalDelta& current) -> void {
           if (!result) {
             result = std::make_unique<JournalDeltaRange>();
-            result->toSequence = current.sequenceID;
             result->toTime = current.time;
-            result->snapshotTransitions.push_back(deltaState->currentHash);
+            result->snapshotTransitions.push_back(windowHash);
           }
           // Capture the lower bound.
           result->fromSequence = current.sequenceID;
           result->fromTime = current.time;
           result->snapshotTransitions.push_back(current.fromHash);
 
-          // Merge the unclean status list
           result->uncleanPaths.insert(
               current.uncleanPaths.begin(), current.uncleanPaths.end());
         });
+
+    if (!result) {
+      // Every entry once in this window was compacted into a newer
+      // sequence number. Return an empty page so the caller still
+      // advances its bookmark past the window.
+      result = std::make_unique<JournalDeltaRange>();
+      result->fromSequence = from;
+      result->snapshotTransitions.push_back(windowHash);
+    }
+    // Compaction can fold entries into newer sequence numbers, so the
+    // bookmark is the window bound itself rather than the newest delta
+    // observed: the next page must resume past everything this window
+    // covered.
+    result->toSequence = pageEnd;
+    result->hasMoreDeltas = pageEnd < tip;
   }
 
   if (result) {
@@ -478,6 +1029,122 @@ std::unique_ptr<JournalDeltaRange> Journal::accumulateRange(
   return result;
 }
 
+const Journal::JournalCheckpoint& Journal::getOrBuildCheckpoint(
+    DeltaState& deltaState,
+    SequenceNumber blockStart) {
+  auto it = deltaState.checkpoints.find(blockStart);
+  if (it != deltaState.checkpoints.end()) {
+    return it->second;
+  }
+
+  JournalCheckpoint checkpoint;
+  forEachDelta(
+      deltaState,
+      blockStart,
+      blockStart + kCheckpointBlockSize - 1,
+      std::nullopt,
+      [&](const FileChangeJournalDelta& current) -> void {
+        ++checkpoint.filesAccumulated;
+        if (checkpoint.toSequence == 0) {
+          checkpoint.toSequence = current.sequenceID;
+          checkpoint.toTime = current.time;
+        }
+        checkpoint.fromSequence = current.sequenceID;
+        checkpoint.fromTime = current.time;
+
+        for (auto& entry : current.getChangedFilesInOverlay()) {
+          auto& name = entry.first;
+          auto& currentInfo = entry.second;
+          auto* info = folly::get_ptr(checkpoint.changedFilesInOverlay, name);
+          if (!info) {
+            checkpoint.changedFilesInOverlay.emplace(name, currentInfo);
+          } else {
+            info->existedBefore = currentInfo.existedBefore;
+          }
+        }
+      },
+      [&](const RootUpdateJournalDelta& current) -> void {
+        if (checkpoint.toSequence == 0) {
+          checkpoint.toSequence = current.sequenceID;
+          checkpoint.toTime = current.time;
+        }
+        checkpoint.fromSequence = current.sequenceID;
+        checkpoint.fromTime = current.time;
+        checkpoint.snapshotTransitions.push_back(current.fromHash);
+        checkpoint.uncleanPaths.insert(
+            current.uncleanPaths.begin(), current.uncleanPaths.end());
+      });
+
+  // Bound the checkpoint cache separately from the deltas themselves so
+  // that it cannot push deltas out of the journal. Evict the oldest
+  // checkpoints first since queries tend to start near the tip.
+  const size_t checkpointSize = checkpoint.estimateMemoryUsage();
+  const size_t checkpointMemoryLimit = deltaState.memoryLimit / 4;
+  while (!deltaState.checkpoints.empty() &&
+         deltaState.checkpointMemoryUsage + checkpointSize >
+             checkpointMemoryLimit) {
+    auto oldest = std::min_element(
+        deltaState.checkpoints.begin(),
+        deltaState.checkpoints.end(),
+        [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+    deltaState.checkpointMemoryUsage -= oldest->second.estimateMemoryUsage();
+    deltaState.checkpoints.erase(oldest);
+  }
+  deltaState.checkpointMemoryUsage += checkpointSize;
+  return deltaState.checkpoints.emplace(blockStart, std::move(checkpoint))
+      .first->second;
+}
+
+template <typename Summary>
+void Journal::mergeSummary(
+    const Summary& summary,
+    JournalDeltaRange& result,
+    size_t& filesAccumulated,
+    const FileChangeFilter& filter) {
+  if (summary.toSequence == 0) {
+    // The block contained no deltas.
+    return;
+  }
+  filesAccumulated += summary.filesAccumulated;
+  result.fromSequence = summary.fromSequence;
+  result.fromTime = summary.fromTime;
+
+  for (const auto& entry : summary.changedFilesInOverlay) {
+    auto& name = entry.first;
+    auto& currentInfo = entry.second;
+    if (filter && !filter(name)) {
+      continue;
+    }
+    auto* resultInfo = folly::get_ptr(result.changedFilesInOverlay, name);
+    if (!resultInfo) {
+      result.changedFilesInOverlay.emplace(name, currentInfo);
+    } else {
+      if (resultInfo->existedBefore != currentInfo.existedAfter) {
+        auto event1 = eventCharacterizationFor(currentInfo);
+        auto event2 = eventCharacterizationFor(*resultInfo);
+        XLOG(ERR) << "Journal for " << name << " holds invalid " << event1
+                  << ", " << event2 << " sequence";
+      }
+      resultInfo->existedBefore = currentInfo.existedBefore;
+    }
+  }
+
+  result.snapshotTransitions.insert(
+      result.snapshotTransitions.end(),
+      summary.snapshotTransitions.begin(),
+      summary.snapshotTransitions.end());
+  if (filter) {
+    for (const auto& path : summary.uncleanPaths) {
+      if (filter(path)) {
+        result.uncleanPaths.insert(path);
+      }
+    }
+  } else {
+    result.uncleanPaths.insert(
+        summary.uncleanPaths.begin(), summary.uncleanPaths.end());
+  }
+}
+
 std::vector<DebugJournalDelta> Journal::getDebugRawJournalInfo(
     SequenceNumber from,
     std::optional<size_t> limit,
@@ -489,6 +1156,7 @@ std::vector<DebugJournalDelta> Journal::getDebugRawJournalInfo(
   forEachDelta(
       *deltaState,
       from,
+      deltaState->nextSequence,
       limit,
       [&](const FileChangeJournalDelta& current) -> void {
         DebugJournalDelta delta;
@@ -549,12 +1217,28 @@ template <class FileChangeFunc, class HashUpdateFunc>
 void Journal::forEachDelta(
     const DeltaState& deltaState,
     JournalDelta::SequenceNumber from,
+    JournalDelta::SequenceNumber to,
     std::optional<size_t> lengthLimit,
     FileChangeFunc&& fileChangeDeltaCallback,
     HashUpdateFunc&& hashUpdateDeltaCallback) const {
   size_t iters = 0;
-  auto fileChangeIt = deltaState.fileChangeDeltas.rbegin();
-  auto hashUpdateIt = deltaState.hashUpdateDeltas.rbegin();
+  // The deques are sorted by sequence ID, so the newest delta with a
+  // sequence ID <= 'to' can be located with a binary search rather than by
+  // skipping over every newer delta.
+  auto sequenceAfter = [](JournalDelta::SequenceNumber seq,
+                          const JournalDelta& delta) {
+    return seq < delta.sequenceID;
+  };
+  auto fileChangeIt = std::make_reverse_iterator(std::upper_bound(
+      deltaState.fileChangeDeltas.begin(),
+      deltaState.fileChangeDeltas.end(),
+      to,
+      sequenceAfter));
+  auto hashUpdateIt = std::make_reverse_iterator(std::upper_bound(
+      deltaState.hashUpdateDeltas.begin(),
+      deltaState.hashUpdateDeltas.end(),
+      to,
+      sequenceAfter));
   auto fileChangeRend = deltaState.fileChangeDeltas.rend();
   auto hashUpdateRend = deltaState.hashUpdateDeltas.rend();
   while (fileChangeIt != fileChangeRend || hashUpdateIt != hashUpdateRend) {
@@ -10,11 +10,17 @@
 #include <folly/Function.h>
 #include <folly/Synchronized.h>
 #include <algorithm>
+#include <chrono>
+#include <condition_variable>
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <optional>
+#include <thread>
 #include <unordered_map>
+#include <vector>
 #include "eden/fs/journal/JournalDelta.h"
+#include "eden/fs/journal/JournalOverflow.h"
 #include "eden/fs/model/RootId.h"
 #include "eden/fs/service/gen-cpp2/streamingeden_types.h"
 #include "eden/fs/telemetry/EdenStats.h"
@@ -41,6 +47,18 @@ struct JournalDeltaInfo {
   std::chrono::steady_clock::time_point time;
 };
 
+/** Delivery statistics for one journal subscriber. */
+struct JournalSubscriberStats {
+  uint64_t subscriberId = 0;
+  /// Number of times the subscriber's callback has been invoked.
+  uint64_t notificationsDelivered = 0;
+  /// Journal changes that were folded into a later delivery because the
+  /// notifier thread was still draining earlier ones.
+  uint64_t notificationsCoalesced = 0;
+  /// Deliveries whose callback ran longer than the slow threshold.
+  uint64_t slowDeliveries = 0;
+};
+
 /** The Journal exists to answer questions about how files are changing
  * over time.
  *
@@ -54,8 +72,10 @@ struct JournalDeltaInfo {
  * revisions (the prior and new revision hash) from which we can derive
  * the larger list of files.
  *
- * The Journal class is thread-safe.  Subscribers are called on the thread
- * that called addDelta.
+ * The Journal class is thread-safe.  Subscribers are called on a dedicated
+ * notifier thread owned by the Journal; recording a change only publishes a
+ * generation number and wakes that thread, so a slow subscriber never
+ * throttles filesystem mutation.
  */
 class Journal {
  public:
@@ -65,6 +85,19 @@ class Journal {
 
   explicit Journal(EdenStatsPtr edenStats);
 
+  /**
+   * Creates a Journal with an on-disk overflow tier rooted at overflowDir
+   * (typically inside the mount's state directory). Deltas evicted by the
+   * memory limit are summarized and spilled there instead of being
+   * dropped, so accumulateRange() degrades to slightly slower queries
+   * rather than truncated results when the memory cap is hit. If the
+   * directory cannot be set up the overflow tier is disabled and the
+   * journal behaves as if it were constructed without one.
+   */
+  Journal(EdenStatsPtr edenStats, AbsolutePathPiece overflowDir);
+
+  ~Journal();
+
   Journal(const Journal&) = delete;
   Journal& operator=(const Journal&) = delete;
 
@@ -85,6 +118,15 @@ class Journal {
    */
   void recordReplaced(RelativePathPiece oldName, RelativePathPiece newName);
 
+  /**
+   * Records a group of file changes while taking the journal lock once and
+   * notifying subscribers at most once, instead of per change. Intended for
+   * bulk operations such as recursive removals that would otherwise acquire
+   * the lock for every file they touch. The deltas are assigned sequence
+   * numbers in the order they appear in the vector.
+   */
+  void recordBatch(std::vector<FileChangeJournalDelta>&& changes);
+
   /**
    * Creates a journal delta that updates the root to this new hash
    */
@@ -112,32 +154,75 @@ class Journal {
    */
   std::optional<JournalDeltaInfo> getLatest();
 
+  /**
+   * A predicate over paths used to restrict an accumulation to the paths a
+   * subscriber cares about. The filter is invoked for each changed and
+   * unclean path while the journal lock is held, so it must be cheap and
+   * must not call back into the Journal.
+   */
+  using FileChangeFilter = std::function<bool(RelativePathPiece)>;
+
   /**
    * Returns an accumulation of all deltas with sequence number >= limitSequence
    * merged. If limitSequence is further back than the Journal remembers,
-   * isTruncated will be set on the JournalDeltaSum.
+   * isTruncated will be set on the JournalDeltaSum. With an overflow tier,
+   * ranges reaching past the in-memory deltas are completed from spilled
+   * segments, and isTruncated is only set once the range reaches past the
+   * overflow tier as well.
    *
    * The default limit value indicates that all deltas should be summed.
    *
    * If the limitSequence means that no deltas will match, returns nullptr.
+   *
+   * Completed blocks of kCheckpointBlockSize deltas are summarized into
+   * cached checkpoints the first time they are accumulated, so repeated
+   * queries over a long history cost proportionally to the number of
+   * distinct changed files rather than the number of deltas.
+   *
+   * When a filter is provided, only paths it accepts are merged into the
+   * result. The sequence bounds still cover the full range so the caller's
+   * next query can resume from toSequence. Filtered accumulations bypass
+   * the checkpoint cache, since checkpoints are unfiltered summaries.
    */
   std::unique_ptr<JournalDeltaRange> accumulateRange(
-      SequenceNumber limitSequence = 1);
+      SequenceNumber limitSequence = 1,
+      const FileChangeFilter& filter = {});
+
+  /**
+   * Accumulates a bounded page of deltas starting at limitSequence, so a
+   * caller resuming from an old position can walk a long history in
+   * pieces instead of receiving it as one giant merged range. At most
+   * maxDeltas in-memory journal entries are folded into the page. The
+   * returned toSequence is the bookmark for the next page: query again
+   * from toSequence + 1 while hasMoreDeltas is set on the result.
+   *
+   * A page that starts below the in-memory deltas covers the entire
+   * overflow tier up to the in-memory front regardless of maxDeltas;
+   * spilled segments are pre-merged summaries, so such a page stays far
+   * smaller than the raw history it replaces, and splitting it further
+   * would not reduce the dominant cost of loading the segments.
+   *
+   * isTruncated is set under the same conditions as in accumulateRange().
+   * Returns nullptr if no deltas at or past limitSequence exist.
+   */
+  std::unique_ptr<JournalDeltaRange> accumulatePage(
+      SequenceNumber limitSequence,
+      size_t maxDeltas);
 
   // Subscription functionality:
 
   /**
    * Registers a callback to be invoked when the journal has changed.
    *
-   * The subscriber is called while the subscriber lock is held, so it
-   * is recommended the subscriber callback do the minimal amount of work needed
-   * to schedule the real work to happen in some other context, because journal
-   * updates are likely to happen in awkward contexts or in the middle of some
-   * batch of mutations where it is not appropriate to do any heavy lifting.
+   * The subscriber is called on the Journal's notifier thread, not the
+   * thread that recorded the change, so a slow callback delays other
+   * subscribers but never the writer. Callbacks should still only schedule
+   * the real work to happen in some other context.
    *
    * To minimize notification traffic, the Journal may coalesce redundant
    * modifications between subscriber notifications and calls to getLatest or
-   * accumulateRange.
+   * accumulateRange, and changes recorded while the notifier thread is busy
+   * are folded into a single later delivery.
    *
    * The return value of registerSubscriber is an identifier than can be passed
    * to cancelSubscriber to later remove the registration.
@@ -148,6 +233,18 @@ class Journal {
   void cancelAllSubscribers();
   bool isSubscriberValid(SubscriberId id) const;
 
+  /**
+   * Blocks until the notifier thread has delivered every journal change
+   * published before this call. Primarily for tests and orderly shutdown;
+   * must not be called from a subscriber callback.
+   */
+  void waitForPendingNotifications();
+
+  /**
+   * Returns delivery statistics for the currently registered subscribers.
+   */
+  std::vector<JournalSubscriberStats> getSubscriberStats() const;
+
   // Statistics and debugging:
 
   /**
@@ -183,11 +280,52 @@ class Journal {
    * The delta will have a new sequence number and timestamp
    * applied.
    */
-  void addDelta(FileChangeJournalDelta&& delta);
   void addDelta(RootUpdateJournalDelta&& delta, RootId newRootId);
 
   static constexpr size_t kDefaultJournalMemoryLimit = 1000000000;
 
+  /**
+   * Maximum number of truncated file-change deltas kept for reuse. Paths
+   * are short, so even a full pool costs a few kilobytes.
+   */
+  static constexpr size_t kMaxRecycledDeltas = 64;
+
+  /**
+   * Number of sequence numbers covered by each checkpoint. Sequence numbers
+   * are partitioned into fixed blocks of this size; once the newest delta's
+   * sequence number is past a block, the deltas in that block can no longer
+   * change and the block is eligible for summarization.
+   */
+  static constexpr JournalDelta::SequenceNumber kCheckpointBlockSize = 4096;
+
+  /**
+   * A pre-merged summary of all deltas within one checkpoint block. Merging
+   * a checkpoint into an accumulation costs proportionally to the number of
+   * distinct files changed in the block rather than the number of deltas,
+   * which keeps accumulateRange() cheap for subscribers that repeatedly
+   * re-scan long histories.
+   */
+  struct JournalCheckpoint {
+    /**
+     * Sequence bounds of the deltas present in the block. A toSequence of 0
+     * means the block contained no deltas (sequence numbers can be skipped,
+     * for example by flush()).
+     */
+    JournalDelta::SequenceNumber fromSequence = 0;
+    JournalDelta::SequenceNumber toSequence = 0;
+    std::chrono::steady_clock::time_point fromTime;
+    std::chrono::steady_clock::time_point toTime;
+    /// Number of file change deltas folded into this checkpoint.
+    size_t filesAccumulated = 0;
+    std::unordered_map<RelativePath, PathChangeInfo> changedFilesInOverlay;
+    /// The fromHash of each hash update in the block, newest first.
+    std::vector<RootId> snapshotTransitions;
+    std::unordered_set<RelativePath> uncleanPaths;
+
+    /** Get memory used (in bytes) by this checkpoint */
+    size_t estimateMemoryUsage() const;
+  };
+
   struct DeltaState {
     /**
      * The sequence number that we'll use for the next entry that we link into
@@ -206,11 +344,36 @@ class Journal {
     size_t memoryLimit = kDefaultJournalMemoryLimit;
     size_t deltaMemoryUsage = 0;
 
+    /**
+     * Lazily built checkpoint summaries, keyed by the first sequence number
+     * of their block. Entries are dropped when truncation discards their
+     * block and when the journal is flushed. The cache is bounded to a
+     * fraction of the journal's memory limit so that it cannot push deltas
+     * out of the journal itself.
+     */
+    std::unordered_map<JournalDelta::SequenceNumber, JournalCheckpoint>
+        checkpoints;
+    size_t checkpointMemoryUsage = 0;
+
     // Set to false when a delta is added.
     // Set to true when getLatest() or accumulateRange() are called.
     // If true before calling addDelta, subscribers are notified.
     bool lastModificationHasBeenObserved = true;
 
+    /**
+     * File-change deltas discarded by truncation, kept so their path
+     * storage can be reused by later recorded changes instead of being
+     * reallocated. Bounded by kMaxRecycledDeltas; a busy journal truncates
+     * and records at a similar rate, so a small pool absorbs most churn.
+     */
+    std::vector<FileChangeJournalDelta> recycledDeltas;
+
+    /**
+     * Returns a delta from the recycle pool, or a default-constructed one
+     * if the pool is empty. The caller must reset() it before use.
+     */
+    FileChangeJournalDelta takeRecycledDelta();
+
     JournalDeltaPtr frontPtr() noexcept;
     void popFront();
     JournalDeltaPtr backPtr() noexcept;
@@ -238,6 +401,11 @@ class Journal {
   /**
    * Removes the oldest deltas until the memory usage of the journal is below
    * the journal's memory limit.
+   *
+   * With an overflow tier, the evicted deltas are summarized into a
+   * segment and spilled to disk rather than forgotten, and eviction
+   * overshoots the limit slightly so each spill covers a run of deltas
+   * instead of producing one segment per evicted delta.
    */
   void truncateIfNecessary(DeltaState& deltaState);
 
@@ -248,9 +416,62 @@ class Journal {
   bool compact(FileChangeJournalDelta& delta, DeltaState& deltaState);
   bool compact(RootUpdateJournalDelta& delta, DeltaState& deltaState);
 
+  /**
+   * Returns the first sequence number of the checkpoint block containing
+   * seq.
+   */
+  static constexpr JournalDelta::SequenceNumber checkpointBlockStart(
+      JournalDelta::SequenceNumber seq) {
+    return ((seq - 1) / kCheckpointBlockSize) * kCheckpointBlockSize + 1;
+  }
+
+  /**
+   * Returns the checkpoint summarizing the block starting at blockStart,
+   * building and caching it from the raw deltas if it has not been built
+   * yet. The block must be complete: the newest delta's sequence number must
+   * be past the block, and the block must not have been truncated.
+   */
+  const JournalCheckpoint& getOrBuildCheckpoint(
+      DeltaState& deltaState,
+      JournalDelta::SequenceNumber blockStart);
+
+  /**
+   * Merges a pre-built summary (a JournalCheckpoint or a
+   * JournalOverflow::Segment; the two are field-compatible) into an
+   * accumulation, exactly as if the deltas it summarizes had been visited
+   * newest to oldest. A non-empty filter restricts the merged paths, since
+   * summaries themselves are always unfiltered.
+   */
+  template <typename Summary>
+  static void mergeSummary(
+      const Summary& summary,
+      JournalDeltaRange& result,
+      size_t& filesAccumulated,
+      const FileChangeFilter& filter);
+
+  /**
+   * Drops cached checkpoints whose blocks are no longer covered by the
+   * journal's deltas.
+   */
+  static void dropTruncatedCheckpoints(DeltaState& deltaState);
+
+  /**
+   * Delivery latency above which a subscriber is counted and logged as
+   * slow. Subscriber callbacks are expected to do no more than schedule
+   * work elsewhere, so anything near this threshold is misbehaving.
+   */
+  static constexpr std::chrono::milliseconds kSlowSubscriberThreshold{50};
+
+  struct Subscriber {
+    SubscriberCallback callback;
+    uint64_t notificationsDelivered{0};
+    uint64_t notificationsCoalesced{0};
+    uint64_t slowDeliveries{0};
+  };
+
   struct SubscriberState {
     SubscriberId nextSubscriberId{1};
-    std::unordered_map<SubscriberId, SubscriberCallback> subscribers;
+    std::unordered_map<SubscriberId, Subscriber> subscribers;
   };
 
   /**
@@ -265,28 +486,69 @@ class Journal {
   [[nodiscard]] bool addDeltaBeforeNotifying(T&& delta, DeltaState& deltaState);
 
   /**
-   * Notify subscribers that a change has happened. Must not be called while
-   * Journal locks are held.
+   * Common implementation of the record*() functions for file changes.
+   * Builds the delta inside the journal lock from a recycled delta when one
+   * is available, so recording a change usually reuses path storage freed
+   * by truncation rather than allocating anew.
    */
-  void notifySubscribers() const;
+  template <typename... Args>
+  void recordFileChange(Args&&... args);
+
+  /**
+   * Publish a change to the notifier thread, which invokes the subscriber
+   * callbacks. The writer-side cost is bumping the published generation
+   * under a short mutex and waking the thread.
+   */
+  void notifySubscribers();
+
+  /**
+   * Body of the notifier thread: waits for published generations and
+   * delivers each to every subscriber, folding generations that arrived
+   * while a delivery was in flight into the next one.
+   */
+  void notifierThread() noexcept;
 
   size_t estimateMemoryUsage(const DeltaState& deltaState) const;
 
   /**
-   * Runs from the latest delta to the delta with sequence ID (if 'lengthLimit'
-   * is not nullopt then checks at most 'lengthLimit' entries) and runs
-   * deltaActor on each entry encountered.
+   * Runs from the delta with sequence ID 'to' (or the latest delta, if
+   * 'to' is larger) down to the delta with sequence ID 'from' (if
+   * 'lengthLimit' is not nullopt then checks at most 'lengthLimit' entries)
+   * and runs deltaActor on each entry encountered.
    * */
   template <class FileChangeFunc, class HashUpdateFunc>
   void forEachDelta(
       const DeltaState& deltaState,
       JournalDelta::SequenceNumber from,
+      JournalDelta::SequenceNumber to,
       std::optional<size_t> lengthLimit,
       FileChangeFunc&& fileChangeDeltaCallback,
       HashUpdateFunc&& hashUpdateDeltaCallback) const;
 
   folly::Synchronized<SubscriberState> subscriberState_;
 
+  /**
+   * State shared with the notifier thread. Writers bump
+   * publishedGeneration; the thread records the generation it has finished
+   * delivering so waitForPendingNotifications() can block until every
+   * publish issued before the call has been handed to the subscribers.
+   */
+  struct NotifierState {
+    bool stop{false};
+    uint64_t publishedGeneration{0};
+    uint64_t deliveredGeneration{0};
+  };
+  folly::Synchronized<NotifierState, std::mutex> notifierState_;
+  std::condition_variable notifierCondVar_;
+  std::thread notifierThread_;
+
+  /**
+   * On-disk overflow tier for deltas evicted by the memory limit, or null
+   * if the journal was constructed without one. Only accessed while the
+   * deltaState_ lock is held.
+   */
+  std::unique_ptr<JournalOverflow> overflow_;
+
   EdenStatsPtr edenStats_;
 };
 } // namespace facebook::eden
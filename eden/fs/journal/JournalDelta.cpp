@@ -54,6 +54,57 @@ FileChangeJournalDelta::FileChangeJournalDelta(
       isPath1Valid{true},
       isPath2Valid{true} {}
 
+void FileChangeJournalDelta::reset(
+    RelativePathPiece fileName,
+    FileChangeJournalDelta::Created) {
+  path1.assign(fileName);
+  info1 = PathChangeInfo{false, true};
+  isPath1Valid = true;
+  isPath2Valid = false;
+}
+
+void FileChangeJournalDelta::reset(
+    RelativePathPiece fileName,
+    FileChangeJournalDelta::Removed) {
+  path1.assign(fileName);
+  info1 = PathChangeInfo{true, false};
+  isPath1Valid = true;
+  isPath2Valid = false;
+}
+
+void FileChangeJournalDelta::reset(
+    RelativePathPiece fileName,
+    FileChangeJournalDelta::Changed) {
+  path1.assign(fileName);
+  info1 = PathChangeInfo{true, true};
+  isPath1Valid = true;
+  isPath2Valid = false;
+}
+
+void FileChangeJournalDelta::reset(
+    RelativePathPiece oldName,
+    RelativePathPiece newName,
+    FileChangeJournalDelta::Renamed) {
+  path1.assign(oldName);
+  path2.assign(newName);
+  info1 = PathChangeInfo{true, false};
+  info2 = PathChangeInfo{false, true};
+  isPath1Valid = true;
+  isPath2Valid = true;
+}
+
+void FileChangeJournalDelta::reset(
+    RelativePathPiece oldName,
+    RelativePathPiece newName,
+    FileChangeJournalDelta::Replaced) {
+  path1.assign(oldName);
+  path2.assign(newName);
+  info1 = PathChangeInfo{true, false};
+  info2 = PathChangeInfo{true, true};
+  isPath1Valid = true;
+  isPath2Valid = true;
+}
+
 size_t FileChangeJournalDelta::estimateMemoryUsage() const {
   size_t mem = sizeof(FileChangeJournalDelta);
 
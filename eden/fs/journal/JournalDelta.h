@@ -95,6 +95,18 @@ class FileChangeJournalDelta : public JournalDelta {
       RelativePathPiece newName,
       Replaced);
 
+  /**
+   * Overwrite this delta in place with a new change, reusing any path
+   * storage it has already allocated. These mirror the constructors above
+   * and let the Journal recycle truncated deltas instead of allocating
+   * fresh path strings for every recorded change.
+   */
+  void reset(RelativePathPiece fileName, Created);
+  void reset(RelativePathPiece fileName, Removed);
+  void reset(RelativePathPiece fileName, Changed);
+  void reset(RelativePathPiece oldName, RelativePathPiece newName, Renamed);
+  void reset(RelativePathPiece oldName, RelativePathPiece newName, Replaced);
+
   /** Which of these paths actually contain information */
   RelativePath path1;
   RelativePath path2;
@@ -204,6 +216,14 @@ struct JournalDeltaRange {
   std::unordered_set<RelativePath> uncleanPaths;
 
   bool isTruncated = false;
+
+  /**
+   * True when a bounded accumulation (Journal::accumulatePage) stopped
+   * before the newest delta in the journal, so more history remains past
+   * toSequence. Always false for unbounded accumulations.
+   */
+  bool hasMoreDeltas = false;
+
   JournalDeltaRange() {
     // 1 and 2 entries are the most common by far.
     snapshotTransitions.reserve(2);
@@ -0,0 +1,213 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/journal/JournalOverflow.h"
+
+#include <fmt/format.h>
+#include <folly/io/Cursor.h>
+#include <folly/io/IOBuf.h>
+#include <folly/io/IOBufQueue.h>
+#include <folly/logging/xlog.h>
+
+#include "eden/fs/utils/FileUtils.h"
+
+namespace facebook::eden {
+
+namespace {
+
+constexpr uint32_t kSegmentMagic = 0x4a4f5646; // "JOVF"
+constexpr uint32_t kSegmentVersion = 1;
+
+void appendString(folly::io::QueueAppender& appender, folly::StringPiece str) {
+  appender.write<uint32_t>(str.size());
+  appender.push(folly::ByteRange{str});
+}
+
+std::string serializeSegment(const JournalOverflow::Segment& segment) {
+  folly::IOBufQueue queue;
+  folly::io::QueueAppender appender{&queue, 4096};
+
+  appender.write<uint32_t>(kSegmentMagic);
+  appender.write<uint32_t>(kSegmentVersion);
+  appender.write<uint64_t>(segment.fromSequence);
+  appender.write<uint64_t>(segment.toSequence);
+  appender.write<int64_t>(segment.fromTime.time_since_epoch().count());
+  appender.write<int64_t>(segment.toTime.time_since_epoch().count());
+  appender.write<uint64_t>(segment.filesAccumulated);
+
+  appender.write<uint64_t>(segment.changedFilesInOverlay.size());
+  for (const auto& [path, info] : segment.changedFilesInOverlay) {
+    appendString(appender, path.stringPiece());
+    appender.write<uint8_t>(info.existedBefore);
+    appender.write<uint8_t>(info.existedAfter);
+  }
+
+  appender.write<uint64_t>(segment.snapshotTransitions.size());
+  for (const auto& rootId : segment.snapshotTransitions) {
+    appendString(appender, rootId.value());
+  }
+
+  appender.write<uint64_t>(segment.uncleanPaths.size());
+  for (const auto& path : segment.uncleanPaths) {
+    appendString(appender, path.stringPiece());
+  }
+
+  auto buf = queue.move();
+  return buf->moveToFbString().toStdString();
+}
+
+std::string readString(folly::io::Cursor& cursor) {
+  auto length = cursor.read<uint32_t>();
+  return cursor.readFixedString(length);
+}
+
+std::optional<JournalOverflow::Segment> deserializeSegment(
+    folly::StringPiece data) {
+  auto buf = folly::IOBuf::wrapBufferAsValue(folly::ByteRange{data});
+  folly::io::Cursor cursor{&buf};
+  try {
+    if (cursor.read<uint32_t>() != kSegmentMagic ||
+        cursor.read<uint32_t>() != kSegmentVersion) {
+      return std::nullopt;
+    }
+
+    JournalOverflow::Segment segment;
+    segment.fromSequence = cursor.read<uint64_t>();
+    segment.toSequence = cursor.read<uint64_t>();
+    segment.fromTime = std::chrono::steady_clock::time_point{
+        std::chrono::steady_clock::duration{cursor.read<int64_t>()}};
+    segment.toTime = std::chrono::steady_clock::time_point{
+        std::chrono::steady_clock::duration{cursor.read<int64_t>()}};
+    segment.filesAccumulated = cursor.read<uint64_t>();
+
+    auto changedFileCount = cursor.read<uint64_t>();
+    for (uint64_t i = 0; i < changedFileCount; ++i) {
+      RelativePath path{readString(cursor)};
+      PathChangeInfo info;
+      info.existedBefore = cursor.read<uint8_t>() != 0;
+      info.existedAfter = cursor.read<uint8_t>() != 0;
+      segment.changedFilesInOverlay.emplace(std::move(path), info);
+    }
+
+    auto transitionCount = cursor.read<uint64_t>();
+    for (uint64_t i = 0; i < transitionCount; ++i) {
+      segment.snapshotTransitions.emplace_back(readString(cursor));
+    }
+
+    auto uncleanPathCount = cursor.read<uint64_t>();
+    for (uint64_t i = 0; i < uncleanPathCount; ++i) {
+      segment.uncleanPaths.insert(RelativePath{readString(cursor)});
+    }
+
+    return segment;
+  } catch (const std::exception&) {
+    return std::nullopt;
+  }
+}
+
+} // namespace
+
+JournalOverflow::JournalOverflow(AbsolutePathPiece dir, size_t maxBytes)
+    : dir_{dir.copy()}, maxBytes_{maxBytes} {
+  ensureDirectoryExists(dir_);
+
+  // Sequence numbers restart with each process, so segments left behind by
+  // a previous run can never match a query.
+  auto entries = getAllDirectoryEntryNames(dir_);
+  if (entries.hasValue()) {
+    for (const auto& name : entries.value()) {
+      removeFileWithAbsolutePath(dir_ + name);
+    }
+  }
+}
+
+AbsolutePath JournalOverflow::segmentPath(SequenceNumber fromSequence) const {
+  return dir_ + PathComponent{fmt::format("{:020}", fromSequence)};
+}
+
+void JournalOverflow::spill(const Segment& segment) {
+  XDCHECK_NE(0ul, segment.fromSequence);
+  XDCHECK_LE(segment.fromSequence, segment.toSequence);
+  XDCHECK(
+      segments_.empty() || segments_.back().toSequence < segment.fromSequence);
+
+  auto data = serializeSegment(segment);
+  auto path = segmentPath(segment.fromSequence);
+  auto result = writeFile(path, folly::ByteRange{folly::StringPiece{data}});
+  if (result.hasException()) {
+    XLOG(WARNING) << "failed to spill journal overflow segment to " << path
+                  << ": " << result.exception().what();
+    // The tier's coverage must stay contiguous. If older segments survived
+    // this failure, a later query reaching below the hole would merge them
+    // and return a non-truncated result that silently omits every change in
+    // this run. Drop them so getOldestSequence() reflects the gap and such
+    // queries report a truncation, as they would without the tier.
+    clear();
+    return;
+  }
+
+  segments_.push_back(
+      SegmentInfo{segment.fromSequence, segment.toSequence, data.size()});
+  totalBytes_ += data.size();
+  evictToFit();
+}
+
+void JournalOverflow::evictToFit() {
+  // Always retain the newest segment, even if it alone exceeds the budget;
+  // evicting it would make the spill that just happened pointless.
+  while (segments_.size() > 1 && totalBytes_ > maxBytes_) {
+    const auto& oldest = segments_.front();
+    removeFileWithAbsolutePath(segmentPath(oldest.fromSequence));
+    totalBytes_ -= oldest.fileSize;
+    segments_.erase(segments_.begin());
+  }
+}
+
+bool JournalOverflow::forEachSegment(
+    SequenceNumber limitSequence,
+    folly::FunctionRef<void(Segment&&)> fn) const {
+  bool allLoaded = true;
+  for (auto it = segments_.rbegin(); it != segments_.rend(); ++it) {
+    if (it->toSequence < limitSequence) {
+      break;
+    }
+    auto path = segmentPath(it->fromSequence);
+    auto data = readFile(path);
+    if (data.hasException()) {
+      XLOG(WARNING) << "failed to read journal overflow segment " << path
+                    << ": " << data.exception().what();
+      allLoaded = false;
+      continue;
+    }
+    auto segment = deserializeSegment(data.value());
+    if (!segment) {
+      XLOG(WARNING) << "discarding corrupt journal overflow segment " << path;
+      allLoaded = false;
+      continue;
+    }
+    fn(std::move(*segment));
+  }
+  return allLoaded;
+}
+
+std::optional<JournalOverflow::SequenceNumber>
+JournalOverflow::getOldestSequence() const {
+  if (segments_.empty()) {
+    return std::nullopt;
+  }
+  return segments_.front().fromSequence;
+}
+
+void JournalOverflow::clear() {
+  for (const auto& segment : segments_) {
+    removeFileWithAbsolutePath(segmentPath(segment.fromSequence));
+  }
+  segments_.clear();
+  totalBytes_ = 0;
+}
+
+} // namespace facebook::eden
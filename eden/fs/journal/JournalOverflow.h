@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <folly/Function.h>
+
+#include "eden/fs/journal/JournalDelta.h"
+#include "eden/fs/model/RootId.h"
+#include "eden/fs/utils/PathFuncs.h"
+
+namespace facebook::eden {
+
+/**
+ * An on-disk overflow tier for the Journal.
+ *
+ * When the journal's memory limit forces deltas out of memory, dropping
+ * them outright forces subscribers that ask about older sequence numbers
+ * into a truncated (full recrawl) response - a catastrophic cost on big
+ * mounts. Instead, the Journal summarizes each run of deltas it evicts
+ * into a Segment and spills it here; accumulateRange() reads the spilled
+ * segments back when a query reaches past the in-memory deltas, so
+ * hitting the memory cap degrades to slightly slower range queries
+ * instead of recrawl storms.
+ *
+ * Segments are stored as one file per spill in a directory in the mount's
+ * state directory, named by the segment's first sequence number so the
+ * directory listing is also the sequence order. Total disk usage is
+ * bounded: once it exceeds the limit the oldest segments are deleted,
+ * ring style, and queries reaching below the oldest retained segment are
+ * truncated as before.
+ *
+ * Journal sequence numbers restart at 1 in each process, so segments from
+ * a previous run are meaningless; the constructor clears any out of the
+ * directory. This also means the steady_clock timestamps inside a segment
+ * are always from the current process.
+ *
+ * This class is not thread-safe. The Journal guards it with its delta
+ * lock.
+ */
+class JournalOverflow {
+ public:
+  using SequenceNumber = JournalDelta::SequenceNumber;
+
+  /**
+   * A pre-merged summary of one run of evicted deltas, exactly as if they
+   * had been accumulated newest to oldest.
+   */
+  struct Segment {
+    SequenceNumber fromSequence = 0;
+    SequenceNumber toSequence = 0;
+    std::chrono::steady_clock::time_point fromTime;
+    std::chrono::steady_clock::time_point toTime;
+    /// Number of file change deltas folded into this segment.
+    size_t filesAccumulated = 0;
+    std::unordered_map<RelativePath, PathChangeInfo> changedFilesInOverlay;
+    /// The fromHash of each hash update in the run, newest first.
+    std::vector<RootId> snapshotTransitions;
+    std::unordered_set<RelativePath> uncleanPaths;
+  };
+
+  /**
+   * Creates the directory if necessary and removes segments left behind
+   * by a previous process. Throws if the directory cannot be created.
+   */
+  explicit JournalOverflow(
+      AbsolutePathPiece dir,
+      size_t maxBytes = kDefaultMaxBytes);
+
+  /**
+   * Serializes the segment to disk and deletes the oldest segments if the
+   * tier is over its disk budget. If the write fails, all older segments
+   * are dropped as well: coverage must stay contiguous, or queries
+   * reaching below the failed run would merge around the hole and silently
+   * miss its changes. A failed spill therefore degrades to the truncated
+   * response the caller would have produced without the tier.
+   */
+  void spill(const Segment& segment);
+
+  /**
+   * Visits every segment whose range ends at or after limitSequence,
+   * newest first - the same order accumulateRange() visits deltas.
+   * Returns false if any segment in the range failed to load (it is
+   * skipped after logging), so the caller can report the resulting gap as
+   * a truncation.
+   */
+  bool forEachSegment(
+      SequenceNumber limitSequence,
+      folly::FunctionRef<void(Segment&&)> fn) const;
+
+  /**
+   * The first sequence number still covered by the tier, or nullopt if no
+   * segments are retained.
+   */
+  std::optional<SequenceNumber> getOldestSequence() const;
+
+  /**
+   * Deletes all segments. Called when the journal is flushed, which
+   * deliberately truncates all history.
+   */
+  void clear();
+
+ private:
+  static constexpr size_t kDefaultMaxBytes = 100 * 1024 * 1024;
+
+  struct SegmentInfo {
+    SequenceNumber fromSequence;
+    SequenceNumber toSequence;
+    size_t fileSize;
+  };
+
+  AbsolutePath segmentPath(SequenceNumber fromSequence) const;
+  void evictToFit();
+
+  const AbsolutePath dir_;
+  const size_t maxBytes_;
+  /// Retained segments, oldest first.
+  std::vector<SegmentInfo> segments_;
+  size_t totalBytes_ = 0;
+};
+
+} // namespace facebook::eden
@@ -7,6 +7,8 @@
 
 #include "eden/fs/journal/Journal.h"
 
+#include <fmt/format.h>
+#include <folly/experimental/TestUtil.h>
 #include <folly/portability/GMock.h>
 #include <folly/portability/GTest.h>
 
@@ -166,6 +168,47 @@ void checkHashMatches(
 
 } // namespace
 
+TEST_F(JournalTest, record_batch_assigns_sequences_and_notifies_once) {
+  unsigned int notifications = 0;
+  journal.registerSubscriber([&]() { ++notifications; });
+
+  // Observe the journal so the next modification triggers a notification.
+  EXPECT_FALSE(journal.getLatest());
+
+  std::vector<FileChangeJournalDelta> changes;
+  changes.emplace_back("dir/a.txt"_relpath, FileChangeJournalDelta::REMOVED);
+  changes.emplace_back("dir/b.txt"_relpath, FileChangeJournalDelta::REMOVED);
+  changes.emplace_back("dir/c.txt"_relpath, FileChangeJournalDelta::CREATED);
+  journal.recordBatch(std::move(changes));
+
+  journal.waitForPendingNotifications();
+  EXPECT_EQ(1, notifications);
+
+  auto latest = journal.getLatest();
+  ASSERT_TRUE(latest);
+  EXPECT_EQ(3, latest->sequenceID);
+
+  auto summed = journal.accumulateRange();
+  ASSERT_NE(nullptr, summed);
+  EXPECT_EQ(1, summed->fromSequence);
+  EXPECT_EQ(3, summed->toSequence);
+  EXPECT_EQ(3, summed->changedFilesInOverlay.size());
+  EXPECT_FALSE(
+      summed->changedFilesInOverlay[RelativePath{"dir/a.txt"}].existedAfter);
+  EXPECT_FALSE(
+      summed->changedFilesInOverlay[RelativePath{"dir/b.txt"}].existedAfter);
+  EXPECT_TRUE(
+      summed->changedFilesInOverlay[RelativePath{"dir/c.txt"}].existedAfter);
+
+  // An empty batch records nothing and does not notify.
+  journal.recordBatch({});
+  latest = journal.getLatest();
+  ASSERT_TRUE(latest);
+  EXPECT_EQ(3, latest->sequenceID);
+  journal.waitForPendingNotifications();
+  EXPECT_EQ(1, notifications);
+}
+
 TEST_F(JournalTest, accumulate_range_with_hash_updates) {
   RootId hash0;
   RootId hash1{"1111111111111111111111111111111111111111"};
@@ -201,6 +244,205 @@ TEST_F(JournalTest, accumulate_range_with_hash_updates) {
   checkHashMatches({hash1}, journal);
 }
 
+TEST_F(JournalTest, accumulate_range_with_checkpointed_blocks) {
+  // Write enough entries that accumulation crosses several checkpoint
+  // blocks, then check that the merged result matches a linear walk.
+  constexpr uint64_t kEntries = 10000;
+  for (uint64_t i = 1; i <= kEntries; i++) {
+    journal.recordCreated(RelativePath{"foo/" + std::to_string(i)});
+  }
+
+  // The first accumulation builds checkpoint summaries for the completed
+  // blocks; the second is served mostly from them.
+  for (int pass = 0; pass < 2; pass++) {
+    auto summed = journal.accumulateRange();
+    ASSERT_NE(nullptr, summed);
+    EXPECT_FALSE(summed->isTruncated);
+    EXPECT_EQ(1, summed->fromSequence);
+    EXPECT_EQ(kEntries, summed->toSequence);
+    EXPECT_EQ(kEntries, summed->changedFilesInOverlay.size());
+  }
+
+  // Ranges that start partway into a checkpointed block are still exact.
+  auto summed = journal.accumulateRange(kEntries / 2 + 1);
+  ASSERT_NE(nullptr, summed);
+  EXPECT_EQ(kEntries / 2 + 1, summed->fromSequence);
+  EXPECT_EQ(kEntries, summed->toSequence);
+  EXPECT_EQ(kEntries / 2, summed->changedFilesInOverlay.size());
+}
+
+TEST_F(JournalTest, checkpoints_merge_file_states_and_hash_updates) {
+  RootId hash0;
+  RootId hash1{"1111111111111111111111111111111111111111"};
+  // Spread a remove/create pair and a hash update far enough apart that
+  // they land in different checkpoint blocks.
+  journal.recordRemoved("test.txt"_relpath);
+  journal.recordHashUpdate(hash1);
+  for (uint64_t i = 0; i < 5000; i++) {
+    journal.recordCreated(RelativePath{"foo/" + std::to_string(i)});
+  }
+  journal.recordCreated("test.txt"_relpath);
+
+  // Accumulate twice so that the second query is served from the
+  // checkpoints built by the first.
+  journal.accumulateRange();
+  auto summed = journal.accumulateRange();
+  ASSERT_NE(nullptr, summed);
+  ASSERT_EQ(1, summed->changedFilesInOverlay.count(RelativePath{"test.txt"}));
+  EXPECT_TRUE(
+      summed->changedFilesInOverlay[RelativePath{"test.txt"}].existedBefore);
+  EXPECT_TRUE(
+      summed->changedFilesInOverlay[RelativePath{"test.txt"}].existedAfter);
+  ASSERT_EQ(2, summed->snapshotTransitions.size());
+  EXPECT_EQ(hash0, summed->snapshotTransitions[0]);
+  EXPECT_EQ(hash1, summed->snapshotTransitions[1]);
+}
+
+TEST_F(JournalTest, accumulate_range_with_filter) {
+  RootId hash1{"1111111111111111111111111111111111111111"};
+  journal.recordCreated("foo/one.txt"_relpath);
+  journal.recordCreated("bar/two.txt"_relpath);
+  journal.recordChanged("foo/one.txt"_relpath);
+
+  auto uncleanPaths = std::unordered_set<RelativePath>();
+  uncleanPaths.insert(RelativePath("foo/unclean.txt"));
+  uncleanPaths.insert(RelativePath("bar/unclean.txt"));
+  journal.recordUncleanPaths(RootId{}, hash1, std::move(uncleanPaths));
+
+  auto fooFilter = [](RelativePathPiece path) {
+    return path.view().find("foo/") == 0;
+  };
+
+  // Only paths accepted by the filter are merged into the result, but the
+  // sequence bounds still cover the full range.
+  auto summed = journal.accumulateRange(1, fooFilter);
+  ASSERT_NE(nullptr, summed);
+  EXPECT_EQ(1, summed->fromSequence);
+  EXPECT_EQ(4, summed->toSequence);
+  EXPECT_EQ(1, summed->changedFilesInOverlay.size());
+  EXPECT_EQ(
+      1, summed->changedFilesInOverlay.count(RelativePath{"foo/one.txt"}));
+  EXPECT_EQ(1, summed->uncleanPaths.size());
+  EXPECT_EQ(1, summed->uncleanPaths.count(RelativePath{"foo/unclean.txt"}));
+
+  // Hash updates are still reported even when the filter matches nothing.
+  summed = journal.accumulateRange(
+      1, [](RelativePathPiece) { return false; });
+  ASSERT_NE(nullptr, summed);
+  EXPECT_EQ(0, summed->changedFilesInOverlay.size());
+  EXPECT_EQ(0, summed->uncleanPaths.size());
+  ASSERT_EQ(2, summed->snapshotTransitions.size());
+  EXPECT_EQ(hash1, summed->snapshotTransitions.back());
+}
+
+TEST_F(JournalTest, filtered_accumulation_bypasses_checkpoints) {
+  // Write enough entries to span several checkpoint blocks and build the
+  // checkpoints with an unfiltered accumulation.
+  constexpr uint64_t kEntries = 10000;
+  for (uint64_t i = 1; i <= kEntries; i++) {
+    journal.recordCreated(RelativePath{"foo/" + std::to_string(i)});
+  }
+  journal.accumulateRange();
+
+  // A filtered accumulation over the same range walks the deltas directly
+  // and must still be exact.
+  auto summed = journal.accumulateRange(1, [](RelativePathPiece path) {
+    return path.view().back() == '0';
+  });
+  ASSERT_NE(nullptr, summed);
+  EXPECT_EQ(1, summed->fromSequence);
+  EXPECT_EQ(kEntries, summed->toSequence);
+  EXPECT_EQ(kEntries / 10, summed->changedFilesInOverlay.size());
+}
+
+TEST_F(JournalTest, accumulate_page_bounded_windows) {
+  // Empty journals have no pages either.
+  EXPECT_EQ(nullptr, journal.accumulatePage(1, 4));
+
+  for (uint64_t i = 1; i <= 10; i++) {
+    journal.recordCreated(RelativePath{"file" + std::to_string(i) + ".txt"});
+  }
+
+  // Walk the history in pages of four, resuming from toSequence + 1 each
+  // time, the way a paging client does.
+  auto page = journal.accumulatePage(1, 4);
+  ASSERT_NE(nullptr, page);
+  EXPECT_FALSE(page->isTruncated);
+  EXPECT_EQ(1, page->fromSequence);
+  EXPECT_EQ(4, page->toSequence);
+  EXPECT_TRUE(page->hasMoreDeltas);
+  EXPECT_EQ(4, page->changedFilesInOverlay.size());
+
+  page = journal.accumulatePage(5, 4);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(5, page->fromSequence);
+  EXPECT_EQ(8, page->toSequence);
+  EXPECT_TRUE(page->hasMoreDeltas);
+  EXPECT_EQ(4, page->changedFilesInOverlay.size());
+
+  // The last page is short and reports that the history is exhausted.
+  page = journal.accumulatePage(9, 4);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(9, page->fromSequence);
+  EXPECT_EQ(10, page->toSequence);
+  EXPECT_FALSE(page->hasMoreDeltas);
+  EXPECT_EQ(2, page->changedFilesInOverlay.size());
+
+  EXPECT_EQ(nullptr, journal.accumulatePage(11, 4));
+}
+
+TEST_F(JournalTest, accumulate_page_reports_hash_at_window_end) {
+  RootId hash1{"1111111111111111111111111111111111111111"};
+  RootId hash2{"2222222222222222222222222222222222222222"};
+
+  journal.recordChanged("a.txt"_relpath); // sequence 1
+  journal.recordHashUpdate(RootId{}, hash1); // sequence 2
+  journal.recordChanged("b.txt"_relpath); // sequence 3
+  journal.recordHashUpdate(hash1, hash2); // sequence 4
+  journal.recordChanged("c.txt"_relpath); // sequence 5
+
+  // A page ending before a hash update must report the hash as of its
+  // window end, not the journal's current hash, or the client would
+  // attribute the later checkout to the wrong range.
+  auto page = journal.accumulatePage(1, 1);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(std::vector<RootId>{RootId{}}, page->snapshotTransitions);
+
+  page = journal.accumulatePage(1, 3);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(
+      (std::vector<RootId>{RootId{}, hash1}), page->snapshotTransitions);
+
+  // The final page sees the transition to the current hash.
+  page = journal.accumulatePage(4, 2);
+  ASSERT_NE(nullptr, page);
+  EXPECT_FALSE(page->hasMoreDeltas);
+  EXPECT_EQ(
+      (std::vector<RootId>{hash1, hash2}), page->snapshotTransitions);
+}
+
+TEST_F(JournalTest, accumulate_page_empty_window_still_advances) {
+  journal.recordCreated("file1.txt"_relpath); // sequence 1
+  journal.recordChanged("file1.txt"_relpath); // sequence 2
+  // Compacted into sequence 3, leaving sequence 2 vacant.
+  journal.recordChanged("file1.txt"_relpath);
+
+  // A window that only covers compacted-away sequence numbers returns an
+  // empty page rather than nullptr, so the caller's bookmark still moves
+  // forward to the deltas past the window.
+  auto page = journal.accumulatePage(2, 1);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(2, page->toSequence);
+  EXPECT_TRUE(page->hasMoreDeltas);
+  EXPECT_EQ(0, page->changedFilesInOverlay.size());
+
+  page = journal.accumulatePage(3, 1);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(3, page->toSequence);
+  EXPECT_FALSE(page->hasMoreDeltas);
+  EXPECT_EQ(1, page->changedFilesInOverlay.size());
+}
+
 TEST_F(JournalTest, debugRawJournalInfoRemoveCreateUpdate) {
   // Remove test.txt
   journal.recordRemoved("test.txt"_relpath);
@@ -473,6 +715,21 @@ TEST_F(JournalTest, limit_of_zero_truncates_after_one_entry) {
   EXPECT_FALSE(summed);
 }
 
+TEST_F(JournalTest, recycled_deltas_do_not_leak_previous_paths) {
+  // A limit of 0 truncates the previous entry on every record, so each new
+  // delta here is built from a recycled one. A recycled two-path rename
+  // reused for a single-path create must not resurface its old paths.
+  journal.setMemoryLimit(0);
+  journal.recordRenamed("old1.txt"_relpath, "new1.txt"_relpath);
+  journal.recordRenamed("old2.txt"_relpath, "new2.txt"_relpath);
+  journal.recordCreated("file1.txt"_relpath);
+  auto summed = journal.accumulateRange(3);
+  ASSERT_TRUE(summed);
+  EXPECT_EQ(1, summed->changedFilesInOverlay.size());
+  EXPECT_EQ(1, summed->changedFilesInOverlay.count(RelativePath{"file1.txt"}));
+  EXPECT_TRUE(summed->changedFilesInOverlay[RelativePath{"file1.txt"}].isNew());
+}
+
 TEST_F(JournalTest, truncation_nonzero) {
   // Set the journal to a size such that it can store a few entries
   journal.setMemoryLimit(1500);
@@ -603,12 +860,19 @@ TEST_F(JournalTest, subscribers_are_notified_of_changes) {
 
   EXPECT_EQ(0u, calls);
   journal.recordChanged("foo"_relpath);
+  journal.waitForPendingNotifications();
   EXPECT_EQ(1u, calls);
   EXPECT_EQ(1u, journal.getLatest()->sequenceID);
 
   journal.recordChanged("foo"_relpath);
+  journal.waitForPendingNotifications();
   EXPECT_EQ(2u, calls);
   EXPECT_EQ(2u, journal.getLatest()->sequenceID);
+
+  auto stats = journal.getSubscriberStats();
+  ASSERT_EQ(1u, stats.size());
+  EXPECT_EQ(2u, stats[0].notificationsDelivered);
+  EXPECT_EQ(0u, stats[0].slowDeliveries);
 }
 
 TEST_F(
@@ -620,11 +884,14 @@ TEST_F(
 
   EXPECT_EQ(0u, calls);
   journal.recordChanged("foo"_relpath);
+  journal.waitForPendingNotifications();
   EXPECT_EQ(1u, calls);
   journal.recordChanged("foo"_relpath);
+  journal.waitForPendingNotifications();
   EXPECT_EQ(1u, calls);
   EXPECT_EQ(2u, journal.getLatest()->sequenceID);
   journal.recordChanged("foo"_relpath);
+  journal.waitForPendingNotifications();
   EXPECT_EQ(2u, calls);
   EXPECT_EQ(3u, journal.getLatest()->sequenceID);
 }
@@ -643,17 +910,184 @@ TEST_F(JournalTest, all_subscribers_are_notified_after_any_observation) {
   journal.recordChanged("foo"_relpath);
   journal.recordChanged("foo"_relpath);
 
+  journal.waitForPendingNotifications();
   EXPECT_EQ(1u, calls1);
   EXPECT_EQ(1u, calls2);
 
   EXPECT_EQ(2u, journal.getLatest()->sequenceID);
   journal.recordChanged("foo"_relpath);
 
+  journal.waitForPendingNotifications();
   EXPECT_EQ(2u, calls1);
   EXPECT_EQ(2u, calls2);
 
   journal.recordChanged("foo"_relpath);
 
+  journal.waitForPendingNotifications();
   EXPECT_EQ(2u, calls1);
   EXPECT_EQ(2u, calls2);
 }
+
+namespace {
+
+struct JournalOverflowTest : ::testing::Test {
+  Journal makeJournalWithOverflow() {
+    return Journal{
+        edenStats.copy(), canonicalPath(overflowDir.path().string())};
+  }
+
+  EdenStatsPtr edenStats{makeRefPtr<EdenStats>()};
+  folly::test::TemporaryDirectory overflowDir{"eden_journal_overflow_"};
+};
+
+} // namespace
+
+TEST_F(JournalOverflowTest, memory_limit_spills_instead_of_truncating) {
+  auto journal = makeJournalWithOverflow();
+  journal.setMemoryLimit(1500);
+
+  constexpr uint64_t kFileCount = 200;
+  for (uint64_t i = 0; i < kFileCount; ++i) {
+    journal.recordCreated(RelativePath{fmt::format("file{}.txt", i)});
+  }
+  // The memory limit must have evicted most of the deltas.
+  ASSERT_LT(journal.getStats()->entryCount, kFileCount);
+
+  auto summed = journal.accumulateRange(1);
+  ASSERT_TRUE(summed);
+  EXPECT_FALSE(summed->isTruncated);
+  EXPECT_EQ(1, summed->fromSequence);
+  EXPECT_EQ(kFileCount, summed->toSequence);
+  EXPECT_EQ(kFileCount, summed->changedFilesInOverlay.size());
+
+  // Ranges starting past the spilled deltas never touch the overflow tier.
+  summed = journal.accumulateRange(kFileCount);
+  ASSERT_TRUE(summed);
+  EXPECT_FALSE(summed->isTruncated);
+  EXPECT_EQ(1, summed->changedFilesInOverlay.size());
+}
+
+TEST_F(JournalOverflowTest, spilled_hash_updates_are_preserved) {
+  auto journal = makeJournalWithOverflow();
+  journal.setMemoryLimit(0);
+
+  journal.recordUncleanPaths(
+      RootId{"1"}, RootId{"2"}, {RelativePath{"unclean.txt"}});
+  journal.recordCreated("file1.txt"_relpath);
+  journal.recordCreated("file2.txt"_relpath);
+
+  auto summed = journal.accumulateRange(1);
+  ASSERT_TRUE(summed);
+  EXPECT_FALSE(summed->isTruncated);
+  std::vector<RootId> expectedTransitions{RootId{"1"}, RootId{"2"}};
+  EXPECT_EQ(expectedTransitions, summed->snapshotTransitions);
+  EXPECT_EQ(1, summed->uncleanPaths.count(RelativePath{"unclean.txt"}));
+  EXPECT_EQ(2, summed->changedFilesInOverlay.size());
+}
+
+TEST_F(JournalOverflowTest, accumulating_spilled_range_honors_filter) {
+  auto journal = makeJournalWithOverflow();
+  journal.setMemoryLimit(0);
+
+  journal.recordCreated("foo/one.txt"_relpath);
+  journal.recordCreated("bar/two.txt"_relpath);
+  journal.recordCreated("foo/three.txt"_relpath);
+
+  auto summed = journal.accumulateRange(1, [](RelativePathPiece path) {
+    return path.view().find("foo/") == 0;
+  });
+  ASSERT_TRUE(summed);
+  EXPECT_FALSE(summed->isTruncated);
+  EXPECT_EQ(1, summed->fromSequence);
+  EXPECT_EQ(3, summed->toSequence);
+  EXPECT_EQ(2, summed->changedFilesInOverlay.size());
+  EXPECT_EQ(0, summed->changedFilesInOverlay.count("bar/two.txt"_relpath));
+}
+
+TEST_F(JournalOverflowTest, accumulate_page_covers_spilled_history) {
+  auto journal = makeJournalWithOverflow();
+  journal.setMemoryLimit(1500);
+
+  constexpr uint64_t kFileCount = 200;
+  for (uint64_t i = 0; i < kFileCount; ++i) {
+    journal.recordCreated(RelativePath{fmt::format("file{}.txt", i)});
+  }
+  const auto inMemory = journal.getStats()->entryCount;
+  ASSERT_LT(inMemory, kFileCount);
+  const auto front = kFileCount - inMemory + 1;
+
+  // The first page is the whole spilled portion, pre-merged; the bookmark
+  // lands just below the in-memory front.
+  auto page = journal.accumulatePage(1, 10);
+  ASSERT_TRUE(page);
+  EXPECT_FALSE(page->isTruncated);
+  EXPECT_EQ(1, page->fromSequence);
+  EXPECT_EQ(front - 1, page->toSequence);
+  EXPECT_TRUE(page->hasMoreDeltas);
+  EXPECT_EQ(front - 1, page->changedFilesInOverlay.size());
+
+  // Later pages walk the in-memory deltas in bounded windows; together
+  // the pages cover every file exactly once.
+  auto covered = page->changedFilesInOverlay.size();
+  auto next = page->toSequence + 1;
+  while (page->hasMoreDeltas) {
+    page = journal.accumulatePage(next, 10);
+    ASSERT_TRUE(page);
+    EXPECT_FALSE(page->isTruncated);
+    EXPECT_LE(page->changedFilesInOverlay.size(), 10u);
+    covered += page->changedFilesInOverlay.size();
+    next = page->toSequence + 1;
+  }
+  EXPECT_EQ(kFileCount, page->toSequence);
+  EXPECT_EQ(kFileCount, covered);
+}
+
+TEST_F(JournalOverflowTest, accumulate_page_truncates_below_overflow) {
+  auto journal = makeJournalWithOverflow();
+  journal.recordCreated("file1.txt"_relpath);
+  journal.flush(); // Deliberately truncates all history.
+  journal.recordCreated("file2.txt"_relpath);
+
+  auto page = journal.accumulatePage(1, 10);
+  ASSERT_TRUE(page);
+  EXPECT_TRUE(page->isTruncated);
+}
+
+TEST_F(JournalOverflowTest, failed_spill_truncates_older_history) {
+  auto journal = makeJournalWithOverflow();
+  journal.setMemoryLimit(0);
+
+  journal.recordCreated("file1.txt"_relpath);
+  journal.recordCreated("file2.txt"_relpath);
+  auto summed = journal.accumulateRange(1);
+  ASSERT_TRUE(summed);
+  EXPECT_FALSE(summed->isTruncated);
+
+  // Destroy the overflow directory so the next spill fails to write its
+  // segment file.
+  removeRecursively(canonicalPath(overflowDir.path().string()));
+  journal.recordCreated("file3.txt"_relpath);
+
+  // The surviving segments must not be merged around the hole left by the
+  // failed spill; a query reaching below it reports a truncation instead
+  // of silently omitting the lost changes.
+  summed = journal.accumulateRange(1);
+  ASSERT_TRUE(summed);
+  EXPECT_TRUE(summed->isTruncated);
+}
+
+TEST_F(JournalOverflowTest, flush_clears_the_overflow_tier) {
+  auto journal = makeJournalWithOverflow();
+  journal.setMemoryLimit(0);
+
+  journal.recordCreated("file1.txt"_relpath);
+  journal.recordCreated("file2.txt"_relpath);
+  auto summed = journal.accumulateRange(1);
+  ASSERT_TRUE(summed);
+  EXPECT_FALSE(summed->isTruncated);
+
+  journal.flush();
+  summed = journal.accumulateRange(1);
+  ASSERT_TRUE(summed);
+  EXPECT_TRUE(summed->isTruncated);
+}
@@ -14,6 +14,8 @@
 #include <array>
 #include <iosfwd>
 
+#include "eden/fs/utils/Memory.h"
+
 namespace folly {
 class IOBuf;
 }
@@ -80,6 +82,15 @@ class ObjectId {
     return bytes_.size();
   }
 
+  /**
+   * Returns an estimate of the heap memory used by this ObjectId. IDs short
+   * enough for fbstring's inline storage (such as plain 20-byte hashes) cost
+   * nothing; longer IDs, like hg proxy hashes, report their allocation.
+   */
+  size_t estimateIndirectMemoryUsage() const {
+    return facebook::eden::estimateIndirectMemoryUsage(bytes_);
+  }
+
   /** @return [lowercase] hex representation of this ObjectId. */
   std::string toLogString() const {
     return asHexString();
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/model/ObjectIdInterner.h"
+
+#include <folly/MapUtil.h>
+#include <folly/logging/xlog.h>
+
+namespace facebook::eden {
+
+ObjectIdInterner::~ObjectIdInterner() {
+  for (auto& chunk : chunks_) {
+    delete chunk.load(std::memory_order_acquire);
+  }
+}
+
+ObjectIdInterner& ObjectIdInterner::getInstance() {
+  // Never deleted so handles stay resolvable during shutdown.
+  static auto* instance = new ObjectIdInterner;
+  return *instance;
+}
+
+ObjectIdInterner::Handle ObjectIdInterner::intern(const ObjectId& id) {
+  {
+    auto index = index_.rlock();
+    if (auto* handle = folly::get_ptr(*index, id)) {
+      return *handle;
+    }
+  }
+
+  auto index = index_.wlock();
+  // Another thread may have interned this ID while the lock was dropped.
+  if (auto* handle = folly::get_ptr(*index, id)) {
+    return *handle;
+  }
+
+  auto handle = nextHandle_.load(std::memory_order_relaxed);
+  auto chunkIndex = handle >> kChunkShift;
+  XCHECK_LT(chunkIndex, kMaxChunks)
+      << "ObjectIdInterner is full; this process has interned an implausible "
+      << "number of distinct ObjectIds";
+
+  auto* chunk = chunks_[chunkIndex].load(std::memory_order_acquire);
+  if (!chunk) {
+    chunk = new Chunk;
+    // Publish the chunk before the handle so lock-free readers that see the
+    // handle also see the chunk.
+    chunks_[chunkIndex].store(chunk, std::memory_order_release);
+  }
+  (*chunk)[handle & (kChunkSize - 1)] = id;
+  index->emplace(id, handle);
+  // The release store orders the entry write above before the point where
+  // lookup() will accept this handle.
+  nextHandle_.store(handle + 1, std::memory_order_release);
+  return handle;
+}
+
+const ObjectId& ObjectIdInterner::lookup(Handle handle) const {
+  XCHECK_LT(handle, nextHandle_.load(std::memory_order_acquire))
+      << "lookup of a handle that was never interned";
+  auto* chunk = chunks_[handle >> kChunkShift].load(std::memory_order_acquire);
+  return (*chunk)[handle & (kChunkSize - 1)];
+}
+
+} // namespace facebook::eden
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#pragma once
+
+#include <folly/Synchronized.h>
+#include <folly/container/F14Map.h>
+#include <array>
+#include <atomic>
+#include <memory>
+
+#include "eden/fs/model/ObjectId.h"
+
+namespace facebook::eden {
+
+/**
+ * A process-wide, append-only table that maps ObjectIds to stable 8-byte
+ * handles.
+ *
+ * ObjectIds are variable-length byte strings; long IDs (such as hg proxy
+ * hashes) heap-allocate and are copied into every structure keyed by them.
+ * Interning stores each distinct ObjectId once and hands out a dense
+ * uint64_t handle, so handle-keyed structures probe and compare integers
+ * instead of hashing and comparing byte strings.
+ *
+ * Handles are never invalidated or reused: the table only grows, and
+ * lookup() is lock-free so resolving a handle back to its ObjectId is cheap
+ * on hot paths. intern() takes the table lock only when it sees a new ID.
+ */
+class ObjectIdInterner {
+ public:
+  using Handle = uint64_t;
+
+  ObjectIdInterner() = default;
+  ObjectIdInterner(const ObjectIdInterner&) = delete;
+  ObjectIdInterner& operator=(const ObjectIdInterner&) = delete;
+  ~ObjectIdInterner();
+
+  /**
+   * Returns the shared process-wide interner.
+   */
+  static ObjectIdInterner& getInstance();
+
+  /**
+   * Returns the handle for the given ObjectId, assigning a new one if this
+   * ID has not been seen before. Interning the same ID always returns the
+   * same handle.
+   */
+  Handle intern(const ObjectId& id);
+
+  /**
+   * Resolves a handle previously returned by intern() back to its ObjectId.
+   * Lock-free. The returned reference is valid for the lifetime of the
+   * interner since entries are never removed.
+   */
+  const ObjectId& lookup(Handle handle) const;
+
+  /**
+   * Number of distinct ObjectIds interned so far.
+   */
+  size_t size() const {
+    return nextHandle_.load(std::memory_order_acquire);
+  }
+
+ private:
+  /**
+   * Interned IDs live in fixed-size chunks so existing entries never move
+   * when the table grows, which is what makes lock-free lookup() safe.
+   */
+  static constexpr size_t kChunkShift = 12;
+  static constexpr size_t kChunkSize = size_t{1} << kChunkShift;
+  static constexpr size_t kMaxChunks = size_t{1} << 14;
+  using Chunk = std::array<ObjectId, kChunkSize>;
+
+  /** Maps interned IDs to their handles. Only consulted by intern(). */
+  folly::Synchronized<folly::F14FastMap<ObjectId, Handle>> index_;
+
+  /**
+   * Chunk pointers are published with release stores after the chunk's new
+   * entry is written, so lookup() can read them with acquire loads without
+   * holding the index_ lock.
+   */
+  std::array<std::atomic<Chunk*>, kMaxChunks> chunks_{};
+
+  /** Next handle to assign; also the number of valid entries. */
+  std::atomic<Handle> nextHandle_{0};
+};
+
+} // namespace facebook::eden
@@ -7,6 +7,7 @@
 
 #include "eden/fs/model/Tree.h"
 #include <folly/io/IOBuf.h>
+#include <folly/lang/Bits.h>
 
 namespace facebook::eden {
 
@@ -21,8 +22,13 @@ size_t Tree::getSizeBytes() const {
   size_t indirect_size =
       folly::goodMallocSize(sizeof(TreeEntry) * entries_.capacity());
 
+  // The entries themselves are stored contiguously in the PathMap's vector;
+  // the only per-entry heap allocations are long entry names and long
+  // ObjectIds (such as hg proxy hashes), both accounted for here so the
+  // TreeCache's byte budget reflects actual memory usage.
   for (auto& entry : entries_) {
     indirect_size += estimateIndirectMemoryUsage(entry.first.value());
+    indirect_size += entry.second.getIndirectSizeBytes();
   }
   return internal_size + indirect_size;
 }
@@ -46,6 +52,198 @@ IOBuf Tree::serialize() const {
   return buf;
 }
 
+folly::IOBuf Tree::serializeV2() const {
+  XCHECK_LE(entries_.size(), std::numeric_limits<uint32_t>::max());
+  uint32_t numberOfEntries = static_cast<uint32_t>(entries_.size());
+
+  size_t recordsSize = 0;
+  for (auto& entry : entries_) {
+    recordsSize += entry.second.serializedSize(entry.first);
+  }
+  size_t serialized_size = sizeof(uint32_t) + sizeof(uint32_t) +
+      sizeof(uint32_t) * numberOfEntries + recordsSize;
+
+  IOBuf buf(IOBuf::CREATE, serialized_size);
+  Appender appender(&buf, 0);
+
+  appender.write<uint32_t>(V2_VERSION);
+  appender.write<uint32_t>(numberOfEntries);
+
+  // Fixed-stride offset table, in sorted entry order. Offsets are relative
+  // to the first entry record, which starts right after the table.
+  uint32_t offset = 0;
+  for (auto& entry : entries_) {
+    appender.write<uint32_t>(offset);
+    offset += static_cast<uint32_t>(entry.second.serializedSize(entry.first));
+  }
+  for (auto& entry : entries_) {
+    entry.second.serialize(entry.first, appender);
+  }
+  return buf;
+}
+
+folly::IOBuf Tree::serializeV3() const {
+  XCHECK_LE(entries_.size(), std::numeric_limits<uint32_t>::max());
+  uint32_t numberOfEntries = static_cast<uint32_t>(entries_.size());
+
+  size_t bitmapWords = (size_t{numberOfEntries} + 63) / 64;
+  size_t recordsSize = 0;
+  for (auto& entry : entries_) {
+    recordsSize += entry.second.serializedSize(entry.first);
+  }
+  size_t serialized_size = sizeof(uint32_t) + sizeof(uint32_t) +
+      sizeof(uint64_t) * bitmapWords + sizeof(uint32_t) * numberOfEntries +
+      recordsSize;
+
+  IOBuf buf(IOBuf::CREATE, serialized_size);
+  Appender appender(&buf, 0);
+
+  appender.write<uint32_t>(V3_VERSION);
+  appender.write<uint32_t>(numberOfEntries);
+
+  // Dirent-type bitmap, one bit per entry in sorted order, set for trees.
+  uint64_t word = 0;
+  size_t bit = 0;
+  for (auto& entry : entries_) {
+    if (entry.second.isTree()) {
+      word |= uint64_t{1} << bit;
+    }
+    if (++bit == 64) {
+      appender.write<uint64_t>(word);
+      word = 0;
+      bit = 0;
+    }
+  }
+  if (bit != 0) {
+    appender.write<uint64_t>(word);
+  }
+
+  // Fixed-stride offset table and entry records, exactly as in V2.
+  uint32_t offset = 0;
+  for (auto& entry : entries_) {
+    appender.write<uint32_t>(offset);
+    offset += static_cast<uint32_t>(entry.second.serializedSize(entry.first));
+  }
+  for (auto& entry : entries_) {
+    entry.second.serialize(entry.first, appender);
+  }
+  return buf;
+}
+
+namespace {
+
+/** Size in bytes of a V3 dirent-type bitmap covering num_entries entries. */
+size_t bitmapByteSize(uint32_t num_entries) {
+  return ((size_t{num_entries} + 63) / 64) * sizeof(uint64_t);
+}
+
+/**
+ * Read the name of the serialized entry record at the beginning of the given
+ * buffer without deserializing the rest of the record. Returns std::nullopt
+ * if the record is truncated.
+ */
+std::optional<StringPiece> peekEntryName(StringPiece record) {
+  // Records start with a type byte, the hash size and bytes, then the name
+  // size and bytes. See TreeEntry::serialize.
+  if (record.size() < sizeof(uint8_t) + sizeof(uint16_t)) {
+    return std::nullopt;
+  }
+  record.advance(sizeof(uint8_t));
+  uint16_t hash_size;
+  memcpy(&hash_size, record.data(), sizeof(uint16_t));
+  record.advance(sizeof(uint16_t));
+  if (record.size() < hash_size + sizeof(uint16_t)) {
+    return std::nullopt;
+  }
+  record.advance(hash_size);
+  uint16_t name_size;
+  memcpy(&name_size, record.data(), sizeof(uint16_t));
+  record.advance(sizeof(uint16_t));
+  if (record.size() < name_size) {
+    return std::nullopt;
+  }
+  return StringPiece{record, 0, name_size};
+}
+} // namespace
+
+std::optional<TreeEntry> Tree::findEntry(
+    folly::StringPiece data,
+    PathComponentPiece name,
+    CaseSensitivity caseSensitive) {
+  if (data.size() < 2 * sizeof(uint32_t)) {
+    return std::nullopt;
+  }
+  uint32_t version;
+  memcpy(&version, data.data(), sizeof(uint32_t));
+  data.advance(sizeof(uint32_t));
+  if (version != V2_VERSION && version != V3_VERSION) {
+    return std::nullopt;
+  }
+  uint32_t num_entries;
+  memcpy(&num_entries, data.data(), sizeof(uint32_t));
+  data.advance(sizeof(uint32_t));
+
+  if (version == V3_VERSION) {
+    size_t bitmapSize = bitmapByteSize(num_entries);
+    if (data.size() < bitmapSize) {
+      XLOG(ERR) << "Corrupted V3 tree data, truncated type bitmap";
+      return std::nullopt;
+    }
+    data.advance(bitmapSize);
+  }
+
+  size_t tableSize = sizeof(uint32_t) * size_t{num_entries};
+  if (data.size() < tableSize) {
+    XLOG(ERR) << "Corrupted V2 tree data, truncated offset table";
+    return std::nullopt;
+  }
+  const char* offsetTable = data.data();
+  auto records = data.subpiece(tableSize);
+
+  auto recordAt = [&](size_t index) -> std::optional<StringPiece> {
+    uint32_t recordOffset;
+    memcpy(
+        &recordOffset,
+        offsetTable + index * sizeof(uint32_t),
+        sizeof(uint32_t));
+    if (recordOffset > records.size()) {
+      XLOG(ERR) << "Corrupted V2 tree data, record offset out of bounds";
+      return std::nullopt;
+    }
+    return records.subpiece(recordOffset);
+  };
+
+  // The offset table is in sorted entry order, so the serialized records can
+  // be binary-searched in place.
+  size_t low = 0;
+  size_t high = num_entries;
+  while (low < high) {
+    size_t mid = low + (high - low) / 2;
+    auto record = recordAt(mid);
+    if (!record) {
+      return std::nullopt;
+    }
+    auto entryName = peekEntryName(*record);
+    if (!entryName) {
+      XLOG(ERR) << "Corrupted V2 tree data, truncated entry record";
+      return std::nullopt;
+    }
+    PathComponentPiece midName{*entryName};
+    if (isPathPieceLess(midName, name, caseSensitive)) {
+      low = mid + 1;
+    } else if (isPathPieceLess(name, midName, caseSensitive)) {
+      high = mid;
+    } else {
+      auto entry = TreeEntry::deserialize(*record);
+      if (!entry) {
+        return std::nullopt;
+      }
+      return std::move(entry->second);
+    }
+  }
+  return std::nullopt;
+}
+
 TreePtr Tree::tryDeserialize(ObjectId hash, folly::StringPiece data) {
   if (data.size() < sizeof(uint32_t)) {
     XLOG(ERR) << "Can not read tree version, bytes remaining " << data.size();
@@ -54,7 +252,8 @@ TreePtr Tree::tryDeserialize(ObjectId hash, folly::StringPiece data) {
   uint32_t version;
   memcpy(&version, data.data(), sizeof(uint32_t));
   data.advance(sizeof(uint32_t));
-  if (version != V1_VERSION) {
+  if (version != V1_VERSION && version != V2_VERSION &&
+      version != V3_VERSION) {
     return nullptr;
   }
 
@@ -66,6 +265,28 @@ TreePtr Tree::tryDeserialize(ObjectId hash, folly::StringPiece data) {
   memcpy(&num_entries, data.data(), sizeof(uint32_t));
   data.advance(sizeof(uint32_t));
 
+  if (version == V3_VERSION) {
+    // The bitmap only accelerates type queries on the serialized bytes; the
+    // entries carry their own types, so skip over it.
+    size_t bitmapSize = bitmapByteSize(num_entries);
+    if (data.size() < bitmapSize) {
+      XLOG(ERR) << "Corrupted V3 tree data, truncated type bitmap";
+      return nullptr;
+    }
+    data.advance(bitmapSize);
+  }
+
+  if (version == V2_VERSION || version == V3_VERSION) {
+    // The offset table only accelerates in-place lookups; the records that
+    // follow it match the V1 format, so skip over it.
+    size_t tableSize = sizeof(uint32_t) * size_t{num_entries};
+    if (data.size() < tableSize) {
+      XLOG(ERR) << "Corrupted V2 tree data, truncated offset table";
+      return nullptr;
+    }
+    data.advance(tableSize);
+  }
+
   Tree::container entries{kPathMapDefaultCaseSensitive};
   entries.reserve(num_entries);
   for (size_t i = 0; i < num_entries; i++) {
@@ -73,7 +294,9 @@ TreePtr Tree::tryDeserialize(ObjectId hash, folly::StringPiece data) {
     if (!entry) {
       return nullptr;
     }
-    entries.emplace(entry->first, std::move(entry->second));
+    // Move the name into the map to avoid a second allocation for names too
+    // long for the small-string optimization.
+    entries.emplace(std::move(entry->first), std::move(entry->second));
   }
 
   if (!data.empty()) {
@@ -85,4 +308,47 @@ TreePtr Tree::tryDeserialize(ObjectId hash, folly::StringPiece data) {
       std::move(entries), std::move(hash));
 }
 
+bool Tree::EntryTypeBitmap::isTree(uint32_t index) const {
+  XDCHECK_LT(index, entryCount_);
+  uint64_t word;
+  memcpy(
+      &word,
+      words_.data() + (index / 64) * sizeof(uint64_t),
+      sizeof(uint64_t));
+  return (word >> (index % 64)) & 1;
+}
+
+uint32_t Tree::EntryTypeBitmap::treeCount() const {
+  uint32_t count = 0;
+  for (size_t i = 0; i < words_.size(); i += sizeof(uint64_t)) {
+    uint64_t word;
+    memcpy(&word, words_.data() + i, sizeof(uint64_t));
+    count += static_cast<uint32_t>(folly::popcount(word));
+  }
+  return count;
+}
+
+std::optional<Tree::EntryTypeBitmap> Tree::peekEntryTypes(
+    folly::StringPiece data) {
+  if (data.size() < 2 * sizeof(uint32_t)) {
+    return std::nullopt;
+  }
+  uint32_t version;
+  memcpy(&version, data.data(), sizeof(uint32_t));
+  data.advance(sizeof(uint32_t));
+  if (version != V3_VERSION) {
+    return std::nullopt;
+  }
+  uint32_t num_entries;
+  memcpy(&num_entries, data.data(), sizeof(uint32_t));
+  data.advance(sizeof(uint32_t));
+
+  size_t bitmapSize = bitmapByteSize(num_entries);
+  if (data.size() < bitmapSize) {
+    XLOG(ERR) << "Corrupted V3 tree data, truncated type bitmap";
+    return std::nullopt;
+  }
+  return EntryTypeBitmap{num_entries, StringPiece{data, 0, bitmapSize}};
+}
+
 } // namespace facebook::eden
@@ -90,14 +90,85 @@ class Tree {
    */
   folly::IOBuf serialize() const;
 
+  /**
+   * Serialize tree using the V2 format.
+   *
+   * V2 prepends a fixed-stride offset table (one uint32_t per entry, in
+   * sorted order) to the entry records, so a single entry can be located by
+   * binary-searching the serialized bytes in place without materializing the
+   * full entry vector. See findEntry().
+   */
+  folly::IOBuf serializeV2() const;
+
+  /**
+   * Serialize tree using the V3 format.
+   *
+   * V3 extends V2 with a packed dirent-type bitmap between the entry count
+   * and the offset table, with one bit per entry in sorted order that is
+   * set when that entry is a tree. The bitmap and entry count are readable
+   * without decoding any entry record (see peekEntryTypes()), so questions
+   * like "does this directory have subtrees at all" cost O(words) on the
+   * serialized bytes.
+   */
+  folly::IOBuf serializeV3() const;
+
+  /**
+   * Look up a single entry by name directly in a serialized V2 or V3 tree.
+   *
+   * Returns std::nullopt when the buffer is not in V2/V3 format or when the
+   * name is not present. This only deserializes the O(log n) records visited
+   * by the binary search, which avoids the multi-millisecond stall of
+   * materializing very large trees when only one child is needed.
+   */
+  static std::optional<TreeEntry> findEntry(
+      folly::StringPiece data,
+      PathComponentPiece name,
+      CaseSensitivity caseSensitive = kPathMapDefaultCaseSensitive);
+
+  /**
+   * A view of the entry count and dirent-type bitmap at the head of a
+   * serialized V3 tree. The view borrows the serialized bytes; it must not
+   * outlive them.
+   */
+  class EntryTypeBitmap {
+   public:
+    EntryTypeBitmap(uint32_t entryCount, folly::StringPiece words)
+        : entryCount_{entryCount}, words_{words} {}
+
+    uint32_t entryCount() const {
+      return entryCount_;
+    }
+
+    /** Whether the index-th entry, in sorted order, is a tree. */
+    bool isTree(uint32_t index) const;
+
+    /** Number of tree entries, counted with popcount over the bitmap. */
+    uint32_t treeCount() const;
+
+   private:
+    uint32_t entryCount_;
+    folly::StringPiece words_;
+  };
+
+  /**
+   * Read the entry count and dirent-type bitmap of a serialized V3 tree
+   * without decoding any entry record.
+   *
+   * Returns std::nullopt when the buffer is not in V3 format. Lets
+   * subtree-descent decisions (diff and glob only need "which entries are
+   * trees") be answered from the serialized bytes alone.
+   */
+  static std::optional<EntryTypeBitmap> peekEntryTypes(
+      folly::StringPiece data);
+
   /**
    * Deserialize tree if possible.
    * Returns nullptr if serialization format is not supported.
    *
    * First byte is used to identify serialization format.
    * Git tree starts with 'tree', so we can use any bytes other then 't' as a
-   * version identifier. Currently only V1_VERSION is supported, along with
-   * git tree format.
+   * version identifier. V1 through V3 are supported, along with git tree
+   * format.
    */
   static TreePtr tryDeserialize(ObjectId hash, folly::StringPiece data);
 
@@ -108,6 +179,8 @@ class Tree {
   container entries_;
 
   static constexpr uint32_t V1_VERSION = 1u;
+  static constexpr uint32_t V2_VERSION = 2u;
+  static constexpr uint32_t V3_VERSION = 3u;
 };
 
 } // namespace facebook::eden
@@ -147,6 +147,15 @@ class TreeEntry {
     return contentBlake3_;
   }
 
+  /**
+   * An estimate of the heap memory used by this entry beyond sizeof(*this).
+   * The only indirect storage is the ObjectId's bytes; the optional hashes
+   * and size are stored inline.
+   */
+  size_t getIndirectSizeBytes() const {
+    return hash_.estimateIndirectMemoryUsage();
+  }
+
   /**
    * Computes exact serialized size of this entry.
    */
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include <folly/portability/GTest.h>
+#include <thread>
+#include <vector>
+
+#include "eden/fs/model/ObjectIdInterner.h"
+
+namespace facebook::eden {
+
+TEST(ObjectIdInterner, internIsStable) {
+  ObjectIdInterner interner;
+
+  auto id1 = ObjectId::fromHex("0123456789012345678901234567890123456789");
+  auto id2 = ObjectId::fromHex("9876543210987654321098765432109876543210");
+
+  auto handle1 = interner.intern(id1);
+  auto handle2 = interner.intern(id2);
+  EXPECT_NE(handle1, handle2);
+  EXPECT_EQ(2, interner.size());
+
+  // Re-interning returns the same handle without growing the table.
+  EXPECT_EQ(handle1, interner.intern(id1));
+  EXPECT_EQ(handle2, interner.intern(id2));
+  EXPECT_EQ(2, interner.size());
+
+  EXPECT_EQ(id1, interner.lookup(handle1));
+  EXPECT_EQ(id2, interner.lookup(handle2));
+}
+
+TEST(ObjectIdInterner, internLongIds) {
+  ObjectIdInterner interner;
+
+  // IDs longer than fbstring's inline storage, like hg proxy hashes.
+  auto id = ObjectId{folly::ByteRange{folly::StringPiece{
+      "proxy-hash:some/long/repo/path/that/exceeds/inline/storage"}}};
+  auto handle = interner.intern(id);
+  EXPECT_EQ(id, interner.lookup(handle));
+}
+
+TEST(ObjectIdInterner, concurrentIntern) {
+  ObjectIdInterner interner;
+  constexpr size_t kThreads = 4;
+  constexpr size_t kIds = 1000;
+
+  // Every thread interns the same sequence of IDs; they must all agree on
+  // the handles.
+  std::vector<std::vector<ObjectIdInterner::Handle>> handles{kThreads};
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&, t] {
+      for (size_t i = 0; i < kIds; ++i) {
+        auto id = ObjectId::sha1(fmt::format("object{}", i));
+        handles[t].push_back(interner.intern(id));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(kIds, interner.size());
+  for (size_t t = 1; t < kThreads; ++t) {
+    EXPECT_EQ(handles[0], handles[t]);
+  }
+  for (size_t i = 0; i < kIds; ++i) {
+    EXPECT_EQ(
+        ObjectId::sha1(fmt::format("object{}", i)),
+        interner.lookup(handles[0][i]));
+  }
+}
+
+} // namespace facebook::eden
@@ -62,6 +62,132 @@ TEST(Tree, testFind) {
   EXPECT_EQ(tree.end(), tree.find(nonExistentPath));
 }
 
+TEST(Tree, testSerializeV2RoundTrip) {
+  auto entryType = TreeEntryType::REGULAR_FILE;
+  TreeEntry entry{testHash, entryType};
+
+  Tree::container entries{kPathMapDefaultCaseSensitive};
+  for (auto i = 0; i < 10; ++i) {
+    auto entryName = fmt::format("file{}.txt", i);
+    entries.emplace(PathComponentPiece{entryName}, entry);
+  }
+  Tree tree(std::move(entries), testHash);
+
+  auto serialized = tree.serializeV2();
+  serialized.coalesce();
+
+  auto outTree = Tree::tryDeserialize(
+      testHash,
+      folly::StringPiece{
+          reinterpret_cast<const char*>(serialized.data()),
+          serialized.length()});
+  ASSERT_TRUE(outTree);
+  EXPECT_EQ(*outTree, tree);
+}
+
+TEST(Tree, testFindEntryInSerializedV2) {
+  TreeEntry fileEntry{testHash, TreeEntryType::REGULAR_FILE};
+  TreeEntry treeEntry{testHash, TreeEntryType::TREE};
+
+  Tree::container entries{kPathMapDefaultCaseSensitive};
+  for (auto i = 0; i < 10; ++i) {
+    auto entryName = fmt::format("file{}.txt", i);
+    entries.emplace(PathComponentPiece{entryName}, fileEntry);
+  }
+  entries.emplace("a_dir"_pc, treeEntry);
+  Tree tree(std::move(entries), testHash);
+
+  auto serialized = tree.serializeV2();
+  serialized.coalesce();
+  folly::StringPiece data{
+      reinterpret_cast<const char*>(serialized.data()), serialized.length()};
+
+  // Every entry is reachable without deserializing the whole tree.
+  for (auto i = 0; i < 10; ++i) {
+    auto entryName = fmt::format("file{}.txt", i);
+    auto found = Tree::findEntry(data, PathComponentPiece{entryName});
+    ASSERT_TRUE(found.has_value());
+    EXPECT_EQ(TreeEntryType::REGULAR_FILE, found->getType());
+    EXPECT_EQ(testHash, found->getHash());
+  }
+
+  auto dir = Tree::findEntry(data, "a_dir"_pc);
+  ASSERT_TRUE(dir.has_value());
+  EXPECT_TRUE(dir->isTree());
+
+  // Absent names and non-V2 buffers return nullopt.
+  EXPECT_FALSE(Tree::findEntry(data, "not_a_file"_pc).has_value());
+  auto v1 = tree.serialize();
+  v1.coalesce();
+  folly::StringPiece v1Data{
+      reinterpret_cast<const char*>(v1.data()), v1.length()};
+  EXPECT_FALSE(Tree::findEntry(v1Data, "a_dir"_pc).has_value());
+}
+
+TEST(Tree, testSerializeV3RoundTrip) {
+  TreeEntry fileEntry{testHash, TreeEntryType::REGULAR_FILE};
+  TreeEntry treeEntry{testHash, TreeEntryType::TREE};
+
+  Tree::container entries{kPathMapDefaultCaseSensitive};
+  for (auto i = 0; i < 70; ++i) {
+    // More than 64 entries so the bitmap spans multiple words.
+    auto entryName = fmt::format("file{:02}.txt", i);
+    entries.emplace(
+        PathComponentPiece{entryName}, i % 7 == 0 ? treeEntry : fileEntry);
+  }
+  Tree tree(std::move(entries), testHash);
+
+  auto serialized = tree.serializeV3();
+  serialized.coalesce();
+  folly::StringPiece data{
+      reinterpret_cast<const char*>(serialized.data()), serialized.length()};
+
+  auto outTree = Tree::tryDeserialize(testHash, data);
+  ASSERT_TRUE(outTree);
+  EXPECT_EQ(*outTree, tree);
+
+  // findEntry also understands V3.
+  auto found = Tree::findEntry(data, "file07.txt"_pc);
+  ASSERT_TRUE(found.has_value());
+  EXPECT_TRUE(found->isTree());
+}
+
+TEST(Tree, testPeekEntryTypes) {
+  TreeEntry fileEntry{testHash, TreeEntryType::REGULAR_FILE};
+  TreeEntry treeEntry{testHash, TreeEntryType::TREE};
+
+  Tree::container entries{kPathMapDefaultCaseSensitive};
+  for (auto i = 0; i < 70; ++i) {
+    auto entryName = fmt::format("file{:02}.txt", i);
+    entries.emplace(
+        PathComponentPiece{entryName}, i % 7 == 0 ? treeEntry : fileEntry);
+  }
+  Tree tree(std::move(entries), testHash);
+
+  auto serialized = tree.serializeV3();
+  serialized.coalesce();
+  folly::StringPiece data{
+      reinterpret_cast<const char*>(serialized.data()), serialized.length()};
+
+  auto bitmap = Tree::peekEntryTypes(data);
+  ASSERT_TRUE(bitmap.has_value());
+  EXPECT_EQ(70, bitmap->entryCount());
+  EXPECT_EQ(10, bitmap->treeCount());
+  uint32_t index = 0;
+  for (const auto& entry : tree) {
+    EXPECT_EQ(entry.second.isTree(), bitmap->isTree(index))
+        << "entry " << entry.first;
+    ++index;
+  }
+
+  // Older formats have no bitmap.
+  auto v2 = tree.serializeV2();
+  v2.coalesce();
+  folly::StringPiece v2Data{
+      reinterpret_cast<const char*>(v2.data()), v2.length()};
+  EXPECT_FALSE(Tree::peekEntryTypes(v2Data).has_value());
+}
+
 TEST(Tree, testSize) {
   auto entryType = TreeEntryType::REGULAR_FILE;
   TreeEntry entry{testHash, entryType};
@@ -20,6 +20,7 @@
 #include "eden/fs/monitor/EdenInstance.h"
 #include "eden/fs/monitor/LogFile.h"
 #include "eden/fs/monitor/LogRotation.h"
+#include "eden/fs/monitor/PerformanceWatchdog.h"
 #include "eden/fs/service/gen-cpp2/EdenServiceAsyncClient.h"
 
 #ifdef __linux__
@@ -101,6 +102,8 @@ EdenMonitor::EdenMonitor(
   }
   log_ = std::make_shared<LogFile>(
       logDir + "edenfs.log"_relpath, maxLogSize, std::move(rotationStrategy));
+
+  perfWatchdog_ = make_unique<PerformanceWatchdog>(this, *config);
 }
 
 EdenMonitor::~EdenMonitor() = default;
@@ -122,6 +125,7 @@ Future<Unit> EdenMonitor::start() {
   return getEdenInstance().thenValue([this](auto&&) {
     XCHECK(edenfs_ != nullptr);
     state_ = State::Running;
+    perfWatchdog_->start();
 #ifdef __linux__
     auto rc = sd_notify(/*unset_environment=*/false, "READY=1");
     if (rc < 0) {
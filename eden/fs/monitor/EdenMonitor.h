@@ -30,6 +30,7 @@ class EdenConfig;
 class EdenInstance;
 class EdenService;
 class LogFile;
+class PerformanceWatchdog;
 
 /**
  * EdenMonitor is the main singleton that drives the monitoring process.
@@ -102,6 +103,7 @@ class EdenMonitor {
   std::unique_ptr<SignalHandler> signalHandler_;
   std::unique_ptr<EdenInstance> edenfs_;
   std::shared_ptr<LogFile> log_;
+  std::unique_ptr<PerformanceWatchdog> perfWatchdog_;
 
   std::string selfExe_;
   std::vector<std::string> selfArgv_;
@@ -0,0 +1,245 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/monitor/PerformanceWatchdog.h"
+
+#include <string.h>
+#include <time.h>
+#include <algorithm>
+
+#include <fmt/format.h>
+#include <folly/ExceptionString.h>
+#include <folly/futures/Future.h>
+#include <folly/logging/xlog.h>
+
+#include "eden/fs/config/EdenConfig.h"
+#include "eden/fs/monitor/EdenMonitor.h"
+#include "eden/fs/service/gen-cpp2/EdenServiceAsyncClient.h"
+#include "eden/fs/utils/FileUtils.h"
+
+namespace facebook::eden {
+
+namespace {
+
+struct tm localTimeNow() {
+  auto now = time(nullptr);
+  struct tm ltime;
+  if (!localtime_r(&now, &ltime)) {
+    memset(&ltime, 0, sizeof(ltime));
+  }
+  return ltime;
+}
+
+} // namespace
+
+PerformanceWatchdog::PerformanceWatchdog(
+    EdenMonitor* monitor,
+    const EdenConfig& config)
+    : AsyncTimeout{monitor->getEventBase()},
+      monitor_{monitor},
+      thresholdUs_{config.monitorPerfWatchdogThresholdUs.getValue()},
+      counterPattern_{config.monitorPerfWatchdogCounterPattern.getValue()},
+      pollInterval_{std::chrono::duration_cast<std::chrono::milliseconds>(
+          config.monitorPerfWatchdogInterval.getValue())},
+      breachPollsNeeded_{
+          std::max<uint64_t>(1, config.monitorPerfWatchdogBreachPolls.getValue())},
+      cooldown_{std::chrono::duration_cast<std::chrono::milliseconds>(
+          config.monitorPerfWatchdogCooldown.getValue())} {}
+
+PerformanceWatchdog::~PerformanceWatchdog() = default;
+
+void PerformanceWatchdog::start() {
+  if (thresholdUs_ == 0) {
+    return;
+  }
+  XLOG(INFO) << "performance watchdog enabled: capturing diagnostics after "
+             << breachPollsNeeded_ << " polls with counters matching "
+             << counterPattern_ << " above " << thresholdUs_ << "us";
+  schedulePoll();
+}
+
+void PerformanceWatchdog::schedulePoll() {
+  scheduleTimeout(pollInterval_);
+}
+
+void PerformanceWatchdog::timeoutExpired() noexcept {
+  try {
+    poll();
+  } catch (const std::exception& ex) {
+    XLOG(WARN) << "error polling EdenFS performance counters: "
+               << folly::exceptionStr(ex);
+    consecutiveBreaches_ = 0;
+  }
+  schedulePoll();
+}
+
+void PerformanceWatchdog::poll() {
+  auto client = monitor_->createEdenThriftClient();
+  client->future_getRegexCounters(counterPattern_)
+      .thenTry([this, client](folly::Try<std::map<std::string, int64_t>> try_) {
+        if (try_.hasException()) {
+          // The daemon may be restarting or too wedged to answer; either
+          // way we have no evidence of a sustained breach.
+          XLOG(DBG3) << "failed to poll EdenFS counters: "
+                     << try_.exception().what();
+          consecutiveBreaches_ = 0;
+          return;
+        }
+        processCounters(try_.value());
+      });
+}
+
+void PerformanceWatchdog::processCounters(
+    const std::map<std::string, int64_t>& counters) {
+  std::string breaches;
+  for (const auto& [name, value] : counters) {
+    if (value > static_cast<int64_t>(thresholdUs_)) {
+      fmt::format_to(
+          std::back_inserter(breaches), FMT_STRING("{} = {}\n"), name, value);
+    }
+  }
+  if (breaches.empty()) {
+    consecutiveBreaches_ = 0;
+    return;
+  }
+  ++consecutiveBreaches_;
+  if (consecutiveBreaches_ < breachPollsNeeded_) {
+    return;
+  }
+  auto now = std::chrono::steady_clock::now();
+  if (lastCapture_ != std::chrono::steady_clock::time_point{} &&
+      now - lastCapture_ < cooldown_) {
+    return;
+  }
+  lastCapture_ = now;
+  captureDiagnostics(std::move(breaches));
+}
+
+void PerformanceWatchdog::captureDiagnostics(std::string breachSummary) {
+  XLOG(WARN) << "EdenFS latency has breached " << thresholdUs_ << "us for "
+             << consecutiveBreaches_ << " polls; capturing diagnostics";
+
+  // Ask for samples covering the whole breach streak, with some margin for
+  // the ramp-up before the first breached poll.
+  auto lookbackSeconds = static_cast<int64_t>(
+      std::chrono::duration_cast<std::chrono::seconds>(
+          pollInterval_ * breachPollsNeeded_)
+          .count() +
+      60);
+
+  auto client = monitor_->createEdenThriftClient();
+  folly::collectAll(
+      client->future_getCounters(),
+      client->future_debugGetStackSamples(lookbackSeconds),
+      client->future_debugGetSlowRequestTraces())
+      .via(monitor_->getEventBase())
+      .thenValue([this, client, breachSummary = std::move(breachSummary)](
+                     auto&& results) {
+        auto& [counters, stackSamples, slowTraces] = results;
+
+        std::string report;
+        auto out = std::back_inserter(report);
+
+        auto ltime = localTimeNow();
+        fmt::format_to(
+            out,
+            FMT_STRING("EdenFS performance diagnostics captured at "
+                       "{:04d}-{:02d}-{:02d} {:02d}:{:02d}:{:02d}\n\n"),
+            ltime.tm_year + 1900,
+            ltime.tm_mon + 1,
+            ltime.tm_mday,
+            ltime.tm_hour,
+            ltime.tm_min,
+            ltime.tm_sec);
+        fmt::format_to(
+            out,
+            FMT_STRING("Counters above {}us:\n{}\n"),
+            thresholdUs_,
+            breachSummary);
+
+        report += "== slow request traces ==\n";
+        if (slowTraces.hasValue()) {
+          for (const auto& trace : *slowTraces->traces()) {
+            fmt::format_to(
+                out,
+                FMT_STRING("{} {}us (completed at {}us)\n"),
+                *trace.opName(),
+                *trace.durationUs(),
+                *trace.completedAtUs());
+            for (const auto& stage : *trace.stages()) {
+              fmt::format_to(
+                  out,
+                  FMT_STRING("  {} +{}us\n"),
+                  *stage.name(),
+                  *stage.offsetUs());
+            }
+          }
+        } else {
+          fmt::format_to(
+              out,
+              FMT_STRING("unavailable: {}\n"),
+              slowTraces.exception().what());
+        }
+
+        report += "\n== stack samples ==\n";
+        if (stackSamples.hasValue()) {
+          for (const auto& sample : *stackSamples->samples()) {
+            fmt::format_to(
+                out,
+                FMT_STRING("{}us {}\n"),
+                *sample.timestampUs(),
+                *sample.threadName());
+            for (const auto& frame : *sample.frames()) {
+              fmt::format_to(out, FMT_STRING("  {}\n"), frame);
+            }
+          }
+        } else {
+          fmt::format_to(
+              out,
+              FMT_STRING("unavailable: {}\n"),
+              stackSamples.exception().what());
+        }
+
+        report += "\n== counters ==\n";
+        if (counters.hasValue()) {
+          for (const auto& [name, value] : counters.value()) {
+            fmt::format_to(out, FMT_STRING("{} {}\n"), name, value);
+          }
+        } else {
+          fmt::format_to(
+              out,
+              FMT_STRING("unavailable: {}\n"),
+              counters.exception().what());
+        }
+
+        writeReport(report);
+      });
+}
+
+void PerformanceWatchdog::writeReport(const std::string& report) {
+  auto ltime = localTimeNow();
+  auto name = fmt::format(
+      FMT_STRING("perf-diagnostics-{:04d}{:02d}{:02d}.{:02d}{:02d}{:02d}.log"),
+      ltime.tm_year + 1900,
+      ltime.tm_mon + 1,
+      ltime.tm_mday,
+      ltime.tm_hour,
+      ltime.tm_min,
+      ltime.tm_sec);
+
+  auto path =
+      monitor_->getEdenDir() + "logs"_relpath + PathComponentPiece{name};
+  auto result = writeFile(path, folly::ByteRange{folly::StringPiece{report}});
+  if (result.hasException()) {
+    XLOG(ERR) << "failed to write performance diagnostics to " << path << ": "
+              << result.exception().what();
+    return;
+  }
+  XLOG(WARN) << "wrote performance diagnostics to " << path;
+}
+
+} // namespace facebook::eden
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+
+#include <folly/io/async/AsyncTimeout.h>
+
+#include "eden/fs/utils/PathFuncs.h"
+
+namespace apache::thrift {
+template <class>
+class Client;
+} // namespace apache::thrift
+
+namespace facebook::eden {
+
+class EdenConfig;
+class EdenMonitor;
+class EdenService;
+
+/**
+ * PerformanceWatchdog periodically polls the latency percentile counters of
+ * the monitored edenfs daemon, and captures a diagnostic report while a
+ * slowness incident is still in progress.
+ *
+ * Slowness incidents are usually over by the time anyone looks at the
+ * affected machine, so the evidence needed to explain them has to be
+ * collected automatically.  When the configured counter pattern reports a
+ * value above the configured threshold for several consecutive polls, the
+ * watchdog fetches the daemon's full counter set, recent profiler stack
+ * samples, and the retained slow request traces over thrift, and writes
+ * them to a timestamped report in the monitor's log directory.  A cooldown
+ * keeps a long incident from producing one report per poll.
+ *
+ * Like the rest of the monitor this class is single threaded: all of its
+ * work runs on the EdenMonitor's EventBase thread.  Polling is best effort;
+ * if the daemon is restarting or the thrift calls fail, the poll is simply
+ * skipped and the breach streak reset.
+ */
+class PerformanceWatchdog : private folly::AsyncTimeout {
+ public:
+  PerformanceWatchdog(EdenMonitor* monitor, const EdenConfig& config);
+  ~PerformanceWatchdog() override;
+
+  /**
+   * Start periodic polling.
+   * Does nothing if the watchdog is disabled (a threshold of 0).
+   */
+  void start();
+
+ private:
+  PerformanceWatchdog(PerformanceWatchdog const&) = delete;
+  PerformanceWatchdog& operator=(PerformanceWatchdog const&) = delete;
+
+  void timeoutExpired() noexcept override;
+  void schedulePoll();
+  void poll();
+
+  /**
+   * Examine one set of polled counters, updating the breach streak and
+   * kicking off a diagnostic capture when it is long enough.
+   */
+  void processCounters(const std::map<std::string, int64_t>& counters);
+
+  /**
+   * Fetch the diagnostic data from the daemon and write the report.
+   * breachSummary describes the counters that triggered the capture.
+   */
+  void captureDiagnostics(std::string breachSummary);
+
+  void writeReport(const std::string& report);
+
+  EdenMonitor* const monitor_;
+
+  uint64_t const thresholdUs_;
+  std::string const counterPattern_;
+  std::chrono::milliseconds const pollInterval_;
+  uint64_t const breachPollsNeeded_;
+  std::chrono::milliseconds const cooldown_;
+
+  uint64_t consecutiveBreaches_{0};
+  std::chrono::steady_clock::time_point lastCapture_;
+};
+
+} // namespace facebook::eden
@@ -148,6 +148,31 @@ class NfsDispatcher {
       FileOffset offset,
       const ObjectFetchContextPtr& context) = 0;
 
+  /**
+   * Return value of the commit method.
+   */
+  struct CommitRes {
+    /** Attributes of the file prior to the commit */
+    std::optional<struct stat> preStat;
+    /** Attributes of the file after the commit */
+    std::optional<struct stat> postStat;
+  };
+
+  /**
+   * Flush data previously written to the file referenced by the InodeNumber
+   * ino to stable storage.
+   *
+   * This backs the COMMIT procedure as well as WRITE procedures with a
+   * stability level above UNSTABLE: a write replied to with UNSTABLE is only
+   * guaranteed to be durable once this completes. When datasync is true only
+   * the file data needs to be flushed, otherwise the file metadata must be
+   * flushed too.
+   */
+  virtual ImmediateFuture<CommitRes> commit(
+      InodeNumber ino,
+      bool datasync,
+      const ObjectFetchContextPtr& context) = 0;
+
   /**
    * Return value of the create method.
    */
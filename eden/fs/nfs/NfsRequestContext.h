@@ -8,10 +8,17 @@
 #pragma once
 
 #include "eden/fs/inodes/RequestContext.h"
+#include "eden/fs/utils/PoolAlloc.h"
 
 namespace facebook::eden {
 
-class NfsRequestContext : public RequestContext {
+/**
+ * One NfsRequestContext is created per NFS request. Requests arrive at high
+ * rates, so allocations are recycled through PoolAlloc instead of going to
+ * the allocator each time.
+ */
+class NfsRequestContext : public RequestContext,
+                          public PoolAlloc<NfsRequestContext> {
  public:
   /**
    * Constructs a new NfsRequestContext. The context should live for the
@@ -7,6 +7,7 @@
 
 #include "eden/fs/nfs/NfsServer.h"
 
+#include <folly/executors/IOThreadPoolExecutor.h>
 #include <folly/executors/thread_factory/NamedThreadFactory.h>
 #include "eden/fs/nfs/Nfsd3.h"
 #include "eden/fs/nfs/portmap/Rpcbindd.h"
@@ -19,6 +20,7 @@ NfsServer::NfsServer(
     folly::EventBase* evb,
     uint64_t numServicingThreads,
     uint64_t maxInflightRequests,
+    uint64_t numIoThreads,
     bool shouldRunOurOwnRpcbindServer,
     const std::shared_ptr<StructuredLogger>& structuredLogger)
     : privHelper_{privHelper},
@@ -27,6 +29,12 @@ NfsServer::NfsServer(
           numServicingThreads,
           std::make_unique<EdenTaskQueue>(maxInflightRequests),
           std::make_unique<folly::NamedThreadFactory>("NfsThreadPool"))),
+      ioThreadPool_(
+          numIoThreads > 0
+              ? std::make_shared<folly::IOThreadPoolExecutor>(
+                    numIoThreads,
+                    std::make_unique<folly::NamedThreadFactory>("NfsIoPool"))
+              : nullptr),
       rpcbindd_(
           shouldRunOurOwnRpcbindServer
               ? std::make_shared<Rpcbindd>(evb_, threadPool_, structuredLogger)
@@ -74,12 +82,14 @@ NfsServer::NfsMountInfo NfsServer::registerMount(
     std::shared_ptr<Notifier> notifier,
     CaseSensitivity caseSensitive,
     uint32_t iosize,
+    bool unstableWrites,
     size_t traceBusCapacity) {
   auto nfsd = std::unique_ptr<Nfsd3, FsChannelDeleter>{new Nfsd3{
       privHelper_,
       AbsolutePath{path},
       evb_,
       threadPool_,
+      ioThreadPool_,
       std::move(dispatcher),
       straceLogger,
       std::move(processInfoCache),
@@ -89,6 +99,7 @@ NfsServer::NfsMountInfo NfsServer::registerMount(
       std::move(notifier),
       caseSensitive,
       iosize,
+      unstableWrites,
       traceBusCapacity}};
   mountd_.registerMount(path, rootIno);
 
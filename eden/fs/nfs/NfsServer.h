@@ -15,6 +15,7 @@
 
 namespace folly {
 class Executor;
+class IOThreadPoolExecutorBase;
 }
 
 namespace facebook::eden {
@@ -37,6 +38,12 @@ class NfsServer {
    * blocking thread pool initialized with numServicingThreads and
    * maxInflightRequests.
    *
+   * When numIoThreads is non-zero, a pool of that many I/O threads is
+   * created and each nfsd client connection is assigned to one of them,
+   * allowing clients that mount with several TCP connections to scale with
+   * the connection count instead of serializing all socket I/O on the main
+   * EventBase. When zero, all socket I/O stays on the passed in EventBase.
+   *
    * One mountd program will be created per NfsServer, while one nfsd program
    * will be created per-mount point, this allows nfsd program to be only aware
    * of its own mount point which greatly simplifies it.
@@ -46,6 +53,7 @@ class NfsServer {
       folly::EventBase* evb,
       uint64_t numServicingThreads,
       uint64_t maxInflightRequests,
+      uint64_t numIoThreads,
       bool shouldRunOurOwnRpcbindServer,
       const std::shared_ptr<StructuredLogger>& structuredLogger);
 
@@ -86,6 +94,7 @@ class NfsServer {
       std::shared_ptr<Notifier> notifier,
       CaseSensitivity caseSensitive,
       uint32_t iosize,
+      bool unstableWrites,
       size_t traceBusCapacity);
 
   /**
@@ -122,6 +131,7 @@ class NfsServer {
   PrivHelper* const privHelper_;
   folly::EventBase* evb_;
   std::shared_ptr<folly::Executor> threadPool_;
+  std::shared_ptr<folly::IOThreadPoolExecutorBase> ioThreadPool_;
   std::shared_ptr<Rpcbindd> rpcbindd_;
   Mountd mountd_;
 };
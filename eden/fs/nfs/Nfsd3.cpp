@@ -46,8 +46,10 @@ class Nfsd3ServerProcessor final : public RpcServerProcessor {
       const std::shared_ptr<StructuredLogger>& structuredLogger,
       CaseSensitivity caseSensitive,
       uint32_t iosize,
+      bool unstableWrites,
       folly::Promise<FsStopDataPtr>& stopPromise,
       ProcessAccessLog& processAccessLog,
+      FsLatencyHistograms& latencyHistograms,
       std::atomic<size_t>& traceDetailedArguments,
       std::shared_ptr<TraceBus<NfsTraceEvent>>& traceBus)
       : dispatcher_(std::move(dispatcher)),
@@ -55,8 +57,10 @@ class Nfsd3ServerProcessor final : public RpcServerProcessor {
         structuredLogger_(structuredLogger),
         caseSensitive_(caseSensitive),
         iosize_(iosize),
+        unstableWrites_(unstableWrites),
         stopPromise_{stopPromise},
         processAccessLog_{processAccessLog},
+        latencyHistograms_{latencyHistograms},
         traceDetailedArguments_(traceDetailedArguments),
         metadataSizeMismatchLogged_(false),
         traceBus_(traceBus) {}
@@ -176,12 +180,16 @@ class Nfsd3ServerProcessor final : public RpcServerProcessor {
   const std::shared_ptr<StructuredLogger> structuredLogger_;
   CaseSensitivity caseSensitive_;
   uint32_t iosize_;
+  // Whether WRITE honors the requested stability level, deferring
+  // durability of UNSTABLE writes to COMMIT. See nfs:unstable-writes.
+  bool unstableWrites_;
   // This promise is owned by the nfs3d. The nfs3d owns an RPC server that owns
   // this server processor. This promise should only be used during the
   // lifetime of  nfs3d. The way we currently enforce this is by waiting for
   // this promise to be set before destroying of the nfs3d.
   folly::Promise<FsStopDataPtr>& stopPromise_;
   ProcessAccessLog& processAccessLog_;
+  FsLatencyHistograms& latencyHistograms_;
   std::atomic_int32_t numberOfClients_;
   std::atomic<size_t>& traceDetailedArguments_;
   // TODO(T136422586): Remove once we've identified the cause of mismatched file
@@ -619,7 +627,11 @@ ImmediateFuture<folly::Unit> Nfsd3ServerProcessor::read(
                           /*eof*/ read.isEof,
                           /*data*/ std::move(read.data),
                       }}}};
-                XdrTrait<READ3res>::serialize(ser, res);
+                // Serialize the reply as an rvalue so that the blob data is
+                // appended to the response by reference and written to the
+                // socket with writev, rather than being copied into the
+                // response buffer.
+                XdrTrait<READ3res>::serialize(ser, std::move(res));
               }
               return folly::unit;
             });
@@ -649,13 +661,34 @@ ImmediateFuture<folly::Unit> Nfsd3ServerProcessor::write(
   queue.append(std::move(args.data));
   auto data = queue.split(args.count);
 
+  auto ino = args.file.ino;
+  auto stable = args.stable;
+
   return dispatcher_
-      ->write(
-          args.file.ino,
-          std::move(data),
-          args.offset,
-          context.getObjectFetchContext())
-      .thenTry([ser = std::move(ser)](
+      ->write(ino, std::move(data), args.offset, context.getObjectFetchContext())
+      .thenValue(
+          [this, ino, stable, &context](NfsDispatcher::WriteRes writeRes)
+              -> ImmediateFuture<NfsDispatcher::WriteRes> {
+            if (!unstableWrites_ || stable == stable_how::UNSTABLE) {
+              return writeRes;
+            }
+            // The client asked for the data to be durable before we reply,
+            // honor that by flushing the file. DATA_SYNC only requires the
+            // file data to be flushed, FILE_SYNC also requires the metadata.
+            return dispatcher_
+                ->commit(
+                    ino,
+                    /*datasync=*/stable == stable_how::DATA_SYNC,
+                    context.getObjectFetchContext())
+                .thenValue([writeRes = std::move(writeRes)](
+                               NfsDispatcher::CommitRes commitRes) mutable {
+                  if (commitRes.postStat.has_value()) {
+                    writeRes.postStat = commitRes.postStat;
+                  }
+                  return std::move(writeRes);
+                });
+          })
+      .thenTry([this, stable, ser = std::move(ser)](
                    folly::Try<NfsDispatcher::WriteRes> writeTry) mutable {
         if (writeTry.hasException()) {
           WRITE3res res{
@@ -676,12 +709,14 @@ ImmediateFuture<folly::Unit> Nfsd3ServerProcessor::write(
                     /*file_wcc*/ statToWccData(
                         writeRes.preStat, writeRes.postStat),
                     /*count*/ folly::to_narrow(writeRes.written),
-                    // TODO(xavierd): the following is a total lie and we
-                    // should call inode->fdatasync() in the case where
-                    // args.stable is anything other than
-                    // stable_how::UNSTABLE. For testing purpose, this is
-                    // OK.
-                    /*committed*/ stable_how::FILE_SYNC,
+                    // With unstable writes enabled, the data was flushed
+                    // above when the client asked for more than UNSTABLE
+                    // and we can truthfully echo the requested stability
+                    // level back. Otherwise, claim FILE_SYNC without
+                    // having flushed anything to preserve the historical
+                    // behavior of this server.
+                    /*committed*/ unstableWrites_ ? stable
+                                                  : stable_how::FILE_SYNC,
                     /*verf*/ makeWriteVerf(),
                 }}}};
           XdrTrait<WRITE3res>::serialize(ser, res);
@@ -1390,11 +1425,38 @@ ImmediateFuture<folly::Unit> Nfsd3ServerProcessor::pathconf(
 }
 
 ImmediateFuture<folly::Unit> Nfsd3ServerProcessor::commit(
-    folly::io::Cursor /*deser*/,
+    folly::io::Cursor deser,
     folly::io::QueueAppender ser,
     NfsRequestContext& context) {
-  serializeReply(ser, accept_stat::PROC_UNAVAIL, context.getXid());
-  return folly::unit;
+  serializeReply(ser, accept_stat::SUCCESS, context.getXid());
+  auto args = XdrTrait<COMMIT3args>::deserialize(deser);
+
+  // The offset and count are merely a hint of the range the client cares
+  // about, the server is always allowed to commit more. Flushing the whole
+  // file data thus satisfies any ranged commit.
+  return dispatcher_
+      ->commit(args.file.ino, /*datasync=*/true, context.getObjectFetchContext())
+      .thenTry([ser = std::move(ser)](
+                   folly::Try<NfsDispatcher::CommitRes> commitTry) mutable {
+        if (commitTry.hasException()) {
+          COMMIT3res res{
+              {{exceptionToNfsError(commitTry.exception()), COMMIT3resfail{}}}};
+          XdrTrait<COMMIT3res>::serialize(ser, res);
+        } else {
+          const auto& commitRes = commitTry.value();
+
+          COMMIT3res res{
+              {{nfsstat3::NFS3_OK,
+                COMMIT3resok{
+                    /*file_wcc*/ statToWccData(
+                        commitRes.preStat, commitRes.postStat),
+                    /*verf*/ makeWriteVerf(),
+                }}}};
+          XdrTrait<COMMIT3res>::serialize(ser, res);
+        }
+
+        return folly::unit;
+      });
 }
 
 NfsArgsDetails formatNull(folly::io::Cursor /*deser*/) {
@@ -1671,9 +1733,15 @@ NfsArgsDetails formatPathconf(folly::io::Cursor deser) {
   return {fmt::format(FMT_STRING("ino={}"), args.object.ino), args.object.ino};
 }
 
-NfsArgsDetails formatCommit(folly::io::Cursor /*deser*/) {
-  // TODO(xavierd): Fill this in.
-  return {""};
+NfsArgsDetails formatCommit(folly::io::Cursor deser) {
+  auto args = XdrTrait<COMMIT3args>::deserialize(deser);
+  return {
+      fmt::format(
+          FMT_STRING("ino={}, offset={}, count={}"),
+          args.file.ino,
+          args.offset,
+          args.count),
+      args.file.ino};
 }
 
 using Handler = ImmediateFuture<folly::Unit> (Nfsd3ServerProcessor::*)(
@@ -1928,7 +1996,11 @@ ImmediateFuture<folly::Unit> Nfsd3ServerProcessor::dispatchRpc(
   auto context = std::make_unique<NfsRequestContext>(
       xid, handlerEntry.name, processAccessLog_);
   context->startRequest(
-      dispatcher_->getStats().copy(), handlerEntry.stat, nullRequestWatch);
+      dispatcher_->getStats().copy(),
+      handlerEntry.stat,
+      nullRequestWatch,
+      &latencyHistograms_.forAccessType(handlerEntry.accessType),
+      handlerEntry.name);
 
   // The data that contextRef reference to is alive for the duration of the
   // handler function and is deleted when context unique_ptr goes out of the
@@ -1950,6 +2022,15 @@ ImmediateFuture<folly::Unit> Nfsd3ServerProcessor::dispatchRpc(
 }
 
 void Nfsd3ServerProcessor::onShutdown(RpcStopData data) {
+  // Each connection funnels its shutdown through here. A client mounted
+  // with several TCP connections tears them down one by one; only the last
+  // one to go away should stop the mount. On takeover, this means only the
+  // last connection's socket is transferred to the new process, the others
+  // are simply closed and the client will reconnect them.
+  if (numberOfClients_.fetch_sub(1, std::memory_order_acq_rel) > 1) {
+    return;
+  }
+
   // Note this triggers the Nfsd3 destruction which will also destroy
   // Nfsd3ServerProcessor. Don't do anything will the Nfsd3ServerProcessor
   // member variables after this!
@@ -1970,6 +2051,7 @@ Nfsd3::Nfsd3(
     AbsolutePath mountPath,
     folly::EventBase* evb,
     std::shared_ptr<folly::Executor> threadPool,
+    std::shared_ptr<folly::IOThreadPoolExecutorBase> ioThreadPool,
     std::unique_ptr<NfsDispatcher> dispatcher,
     const folly::Logger* straceLogger,
     std::shared_ptr<ProcessInfoCache> processInfoCache,
@@ -1979,6 +2061,7 @@ Nfsd3::Nfsd3(
     std::shared_ptr<Notifier> /*notifier*/,
     CaseSensitivity caseSensitive,
     uint32_t iosize,
+    bool unstableWrites,
     size_t traceBusCapacity)
     : privHelper_{privHelper},
       mountPath_{std::move(mountPath)},
@@ -1989,13 +2072,16 @@ Nfsd3::Nfsd3(
               structuredLogger,
               caseSensitive,
               iosize,
+              unstableWrites,
               stopPromise_,
               processAccessLog_,
+              latencyHistograms_,
               traceDetailedArguments_,
               traceBus_),
           evb,
           std::move(threadPool),
-          structuredLogger)),
+          structuredLogger,
+          std::move(ioThreadPool))),
       processAccessLog_(std::move(processInfoCache)),
       invalidationExecutor_{
           folly::SerialExecutor::create(folly::getGlobalCPUExecutor())},
@@ -13,6 +13,7 @@
 #include "eden/fs/inodes/FsChannel.h"
 #include "eden/fs/nfs/NfsDispatcher.h"
 #include "eden/fs/nfs/rpc/RpcServer.h"
+#include "eden/fs/telemetry/DurationHistogram.h"
 #include "eden/fs/telemetry/TraceBus.h"
 #include "eden/fs/utils/CaseSensitivity.h"
 #include "eden/fs/utils/ProcessAccessLog.h"
@@ -119,8 +120,9 @@ class Nfsd3 final : public FsChannel {
    * registered with rpcbind, and thus if a real NFS server is running on this
    * host, EdenFS won't be able to register itself.
    *
-   * All the socket processing will be run on the EventBase passed in. This
-   * also must be called on that EventBase thread.
+   * All the socket processing will be run on the EventBase passed in, or,
+   * when an ioThreadPool is passed in, distributed round-robin across that
+   * pool's EventBases. This also must be called on that EventBase thread.
    *
    * Note: at mount time, EdenFS will manually call mount.nfs with -o port
    * to manually specify the port on which this server is bound, so registering
@@ -131,6 +133,7 @@ class Nfsd3 final : public FsChannel {
       AbsolutePath mountPath,
       folly::EventBase* evb,
       std::shared_ptr<folly::Executor> threadPool,
+      std::shared_ptr<folly::IOThreadPoolExecutorBase> ioThreadPool,
       std::unique_ptr<NfsDispatcher> dispatcher,
       const folly::Logger* straceLogger,
       std::shared_ptr<ProcessInfoCache> processInfoCache,
@@ -140,6 +143,7 @@ class Nfsd3 final : public FsChannel {
       std::shared_ptr<Notifier> notifications,
       CaseSensitivity caseSensitive,
       uint32_t iosize,
+      bool unstableWrites,
       size_t traceBusCapacity);
 
   void destroy() override;
@@ -252,6 +256,10 @@ class Nfsd3 final : public FsChannel {
     return processAccessLog_;
   }
 
+  const FsLatencyHistograms* getLatencyHistograms() const override {
+    return &latencyHistograms_;
+  }
+
   Nfsd3(const Nfsd3&) = delete;
   Nfsd3(Nfsd3&&) = delete;
   Nfsd3& operator=(const Nfsd3&) = delete;
@@ -294,6 +302,7 @@ class Nfsd3 final : public FsChannel {
   folly::Promise<FsStopDataPtr> stopPromise_;
   std::shared_ptr<RpcServer> server_;
   ProcessAccessLog processAccessLog_;
+  FsLatencyHistograms latencyHistograms_;
   // It is critical that this is a SerialExecutor. invalidation for parent
   // directories should happen after children, and we flush invalidations by
   // adding one work item to the queue.
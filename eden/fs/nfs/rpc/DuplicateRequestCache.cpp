@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/nfs/rpc/DuplicateRequestCache.h"
+
+namespace facebook::eden {
+
+folly::Synchronized<DuplicateRequestCache::Shard>&
+DuplicateRequestCache::getShard(const Key& key) {
+  return shards_[KeyHash{}(key) % kNumShards];
+}
+
+DuplicateRequestCache::Lookup DuplicateRequestCache::lookupOrStart(
+    const folly::SocketAddress& client,
+    uint32_t xid,
+    uint32_t proc) {
+  auto key = Key{client, xid, proc};
+  auto now = std::chrono::steady_clock::now();
+  auto shard = getShard(key).wlock();
+  auto it = shard->map.find(key);
+  if (it == shard->map.end() ||
+      now - it->second.insertionTime > kEntryTimeout) {
+    shard->map.set(key, Entry{nullptr, now});
+    return {};
+  }
+  return {true, it->second.reply ? it->second.reply->clone() : nullptr};
+}
+
+void DuplicateRequestCache::complete(
+    const folly::SocketAddress& client,
+    uint32_t xid,
+    uint32_t proc,
+    const std::unique_ptr<folly::IOBuf>& reply) {
+  auto key = Key{client, xid, proc};
+  if (reply && reply->computeChainDataLength() <= kMaxCachedReplySize) {
+    getShard(key).wlock()->map.set(
+        key, Entry{reply->clone(), std::chrono::steady_clock::now()});
+  } else {
+    // The reply is too large to be retained. Forget the request entirely:
+    // large replies are for idempotent procedures which can safely be
+    // re-executed.
+    getShard(key).wlock()->map.erase(key);
+  }
+}
+
+} // namespace facebook::eden
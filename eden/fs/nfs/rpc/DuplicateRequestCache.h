@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <memory>
+
+#include <folly/SocketAddress.h>
+#include <folly/Synchronized.h>
+#include <folly/container/EvictingCacheMap.h>
+#include <folly/hash/Hash.h>
+#include <folly/io/IOBuf.h>
+
+namespace facebook::eden {
+
+/**
+ * Duplicate request cache for the RPC server.
+ *
+ * An NFS client will retransmit a request when it hasn't received a reply in
+ * time, possibly on a brand new connection when the original one broke. For
+ * idempotent procedures, re-executing the request is merely wasted work, but
+ * non-idempotent procedures (WRITE, CREATE, RENAME, ...) may fail or corrupt
+ * state when executed a second time. This cache remembers recently seen
+ * requests, keyed by the client address, transaction ID and procedure number,
+ * so that a retransmission can be answered with the previously sent reply
+ * instead of being re-executed.
+ *
+ * The cache is sharded and each shard is independently locked so that
+ * concurrent requests rarely contend; the critical sections are limited to a
+ * hash table lookup or insertion.
+ */
+class DuplicateRequestCache {
+ public:
+  /**
+   * Result of lookupOrStart().
+   */
+  struct Lookup {
+    /**
+     * True when this request was recently seen and must not be re-executed.
+     */
+    bool isDuplicate = false;
+
+    /**
+     * The reply that was previously sent for this request, when it is still
+     * retained. A duplicate with a null reply is a retransmission of a
+     * request that is still being executed and should simply be dropped: the
+     * client will retransmit again if the reply to the original execution is
+     * lost.
+     */
+    std::unique_ptr<folly::IOBuf> reply;
+  };
+
+  /**
+   * Look the request up in the cache, recording it as in-progress when it
+   * wasn't already present.
+   *
+   * When isDuplicate is false, the caller is expected to execute the request
+   * and hand the reply to complete().
+   */
+  Lookup
+  lookupOrStart(const folly::SocketAddress& client, uint32_t xid, uint32_t proc);
+
+  /**
+   * Record the reply sent for a request previously recorded by
+   * lookupOrStart().
+   *
+   * Replies larger than kMaxCachedReplySize are not retained: these are
+   * replies to READ-like procedures which are idempotent and can safely be
+   * re-executed should the client retransmit them.
+   */
+  void complete(
+      const folly::SocketAddress& client,
+      uint32_t xid,
+      uint32_t proc,
+      const std::unique_ptr<folly::IOBuf>& reply);
+
+  /**
+   * Entries older than this have aged out of the client's retransmission
+   * window and are treated as misses. This bounds the damage of a client
+   * reusing a transaction ID, and recovers requests whose reply was never
+   * recorded.
+   */
+  static constexpr std::chrono::seconds kEntryTimeout{120};
+
+  /**
+   * Replies larger than this are not retained, see complete().
+   */
+  static constexpr size_t kMaxCachedReplySize = 1024;
+
+ private:
+  struct Key {
+    folly::SocketAddress client;
+    uint32_t xid;
+    uint32_t proc;
+
+    bool operator==(const Key& other) const {
+      return xid == other.xid && proc == other.proc && client == other.client;
+    }
+  };
+
+  struct KeyHash {
+    size_t operator()(const Key& key) const {
+      return folly::hash::hash_combine(key.client.hash(), key.xid, key.proc);
+    }
+  };
+
+  struct Entry {
+    /**
+     * The previously sent reply. Null while the request is being executed,
+     * or when the reply was too large to be retained.
+     */
+    std::unique_ptr<folly::IOBuf> reply;
+    std::chrono::steady_clock::time_point insertionTime;
+  };
+
+  static constexpr size_t kNumShards = 16;
+  static constexpr size_t kEntriesPerShard = 256;
+
+  struct Shard {
+    Shard() : map{kEntriesPerShard} {}
+    folly::EvictingCacheMap<Key, Entry, KeyHash> map;
+  };
+
+  folly::Synchronized<Shard>& getShard(const Key& key);
+
+  std::array<folly::Synchronized<Shard>, kNumShards> shards_;
+};
+
+} // namespace facebook::eden
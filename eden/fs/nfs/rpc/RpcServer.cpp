@@ -11,6 +11,7 @@
 
 #include <folly/Exception.h>
 #include <folly/String.h>
+#include <folly/executors/IOThreadPoolExecutor.h>
 #include <folly/executors/QueuedImmediateExecutor.h>
 #include <folly/futures/Future.h>
 #include <folly/io/IOBufQueue.h>
@@ -112,13 +113,25 @@ RpcConnectionHandler::RpcConnectionHandler(
     AsyncSocket::UniquePtr&& socket,
     std::shared_ptr<folly::Executor> threadPool,
     const std::shared_ptr<StructuredLogger>& structuredLogger,
-    std::weak_ptr<RpcServer> owningServer)
+    std::weak_ptr<RpcServer> owningServer,
+    std::shared_ptr<DuplicateRequestCache> duplicateRequestCache)
     : proc_(proc),
       sock_(std::move(socket)),
       threadPool_(std::move(threadPool)),
       errorLogger_(structuredLogger),
       state_(sock_->getEventBase()),
-      owningServer_(std::move(owningServer)) {
+      owningServer_(std::move(owningServer)),
+      duplicateRequestCache_(std::move(duplicateRequestCache)) {
+  if (duplicateRequestCache_) {
+    try {
+      sock_->getPeerAddress(&clientAddress_);
+    } catch (const std::exception& ex) {
+      XLOG(DBG4) << "Unable to obtain the peer address, duplicate requests "
+                    "will not be detected on this connection: "
+                 << folly::exceptionStr(ex);
+      duplicateRequestCache_.reset();
+    }
+  }
   sock_->setReadCB(this);
   proc_->clientConnected();
 }
@@ -277,24 +290,36 @@ std::unique_ptr<folly::IOBuf> RpcConnectionHandler::readOneRequest() noexcept {
   if (!readBuf_.front()) {
     return nullptr;
   }
+  if (readBuf_.chainLength() < bytesNeeded_) {
+    // A previous scan already determined how many bytes the in-progress
+    // fragment needs; nothing to do until they have all arrived.
+    return nullptr;
+  }
   folly::io::Cursor c(readBuf_.front());
+  // Resume after the complete fragments scanned by previous calls.
+  c.skip(scannedBytes_);
   while (true) {
     uint32_t fragmentHeader;
     if (!c.tryReadBE<uint32_t>(fragmentHeader)) {
       // We can't even read the fragment header, bail out.
+      bytesNeeded_ = scannedBytes_ + sizeof(uint32_t);
       return nullptr;
     }
     auto len = fragmentHeader & 0x7fffffff;
     bool isLast = (fragmentHeader & 0x80000000) != 0;
     if (!c.canAdvance(len)) {
       // we don't have a complete request, so try again later
+      bytesNeeded_ = scannedBytes_ + sizeof(uint32_t) + len;
       return nullptr;
     }
     c.skip(len);
+    scannedBytes_ = c.getCurrentPosition();
     if (isLast) {
       break;
     }
   }
+  scannedBytes_ = 0;
+  bytesNeeded_ = 0;
   return readBuf_.split(c.getCurrentPosition());
 }
 
@@ -405,6 +430,20 @@ void RpcConnectionHandler::dispatchAndReply(
       return folly::makeFuture(finalizeFragment(std::move(iobufQueue)));
     }
 
+    if (duplicateRequestCache_) {
+      auto lookup = duplicateRequestCache_->lookupOrStart(
+          clientAddress_, call.xid, call.cbody.proc);
+      if (lookup.isDuplicate) {
+        // The client retransmitted a request we've already seen, likely
+        // because our reply didn't arrive in time. Re-executing it would
+        // re-run non-idempotent procedures, so either resend the reply we
+        // previously sent, or drop the retransmission when the original
+        // execution is still in progress.
+        XLOG(DBG7) << "duplicate request, xid=" << call.xid;
+        return folly::makeFuture(std::move(lookup.reply));
+      }
+    }
+
     XLOG(DBG7) << "dispatching a request";
     auto fut = makeImmediateFutureWith([this,
                                         deser = std::move(deser),
@@ -441,7 +480,12 @@ void RpcConnectionHandler::dispatchAndReply(
               replyServerError(accept_stat::SYSTEM_ERR, call.xid, iobufQueue);
             }
           }
-          return finalizeFragment(std::move(iobufQueue));
+          auto resultBuffer = finalizeFragment(std::move(iobufQueue));
+          if (duplicateRequestCache_) {
+            duplicateRequestCache_->complete(
+                clientAddress_, call.xid, call.cbody.proc, resultBuffer);
+          }
+          return resultBuffer;
         })
         .semi()
         .via(&folly::QueuedImmediateExecutor::instance());
@@ -456,6 +500,11 @@ void RpcConnectionHandler::dispatchAndReply(
           // XXX: This should never happen.
         } else {
           auto resultBuffer = std::move(result).value();
+          if (!resultBuffer) {
+            // Retransmission of a request that is still being executed: the
+            // reply to the original execution will answer it.
+            return;
+          }
           XLOG(DBG7) << "About to write to the socket.";
           // TODO: Wait until the write completes before considering
           // the request finished.
@@ -481,23 +530,43 @@ void RpcServer::connectionAccepted(
     const folly::SocketAddress& clientAddr,
     AcceptInfo /* info */) noexcept {
   XLOG(DBG7) << "Accepted connection from: " << clientAddr;
-  auto socket = AsyncSocket::newSocket(evb_, fd);
-  auto& state = state_.get();
-  state.connectionHandlers.push_back(RpcConnectionHandler::create(
-      proc_,
-      std::move(socket),
-      threadPool_,
-      structuredLogger_,
-      weak_from_this()));
 
-  // At this point we could stop accepting connections with this callback for
-  // nfsd3 because we only support one connected client, and we do not support
-  // reconnects. BUT its tricky to unregister the accept callback.
-  // to unregister and is fine to keep it around for now and just clean it up on
-  // shutdown.
-  //
-  // TODO: Is it really tricky to unregister the accept callback? We could call
-  // stopAccepting() here and removeAcceptCallback.
+  // When an I/O thread pool was given, distribute connections round-robin
+  // across its EventBases so that socket reads and writes for concurrent
+  // connections don't all serialize on the main EventBase. The AsyncSocket
+  // and its handler must be created on the EventBase the socket will be
+  // processed on, while the handler list may only be mutated on the main
+  // EventBase, hence the double hop.
+  auto* ioEvb = ioThreadPool_ ? ioThreadPool_->getEventBase() : evb_;
+  if (ioEvb == evb_) {
+    auto socket = AsyncSocket::newSocket(evb_, fd);
+    registerRpcHandler(RpcConnectionHandler::create(
+        proc_,
+        std::move(socket),
+        threadPool_,
+        structuredLogger_,
+        weak_from_this(),
+        duplicateRequestCache_));
+  } else {
+    ioEvb->runInEventBaseThread([self = shared_from_this(), ioEvb, fd] {
+      auto handler = RpcConnectionHandler::create(
+          self->proc_,
+          AsyncSocket::newSocket(ioEvb, fd),
+          self->threadPool_,
+          self->structuredLogger_,
+          std::weak_ptr<RpcServer>{self},
+          self->duplicateRequestCache_);
+      self->evb_->runInEventBaseThread(
+          [self, handler = std::move(handler)]() mutable {
+            self->registerRpcHandler(std::move(handler));
+          });
+    });
+  }
+
+  // Note that we keep accepting connections on this callback: clients like
+  // the macOS NFS client may open several connections to the same server to
+  // parallelize their requests, and we want each of them to get its own
+  // handler.
 }
 
 void RpcServer::acceptError(const std::exception& ex) noexcept {
@@ -532,10 +601,15 @@ std::shared_ptr<RpcServer> RpcServer::create(
     std::shared_ptr<RpcServerProcessor> proc,
     folly::EventBase* evb,
     std::shared_ptr<folly::Executor> threadPool,
-    const std::shared_ptr<StructuredLogger>& structuredLogger) {
+    const std::shared_ptr<StructuredLogger>& structuredLogger,
+    std::shared_ptr<folly::IOThreadPoolExecutorBase> ioThreadPool) {
   return std::shared_ptr<RpcServer>{
       new RpcServer{
-          std::move(proc), evb, std::move(threadPool), structuredLogger},
+          std::move(proc),
+          evb,
+          std::move(threadPool),
+          structuredLogger,
+          std::move(ioThreadPool)},
       [](RpcServer* p) { p->destroy(); }};
 }
 
@@ -543,12 +617,15 @@ RpcServer::RpcServer(
     std::shared_ptr<RpcServerProcessor> proc,
     folly::EventBase* evb,
     std::shared_ptr<folly::Executor> threadPool,
-    const std::shared_ptr<StructuredLogger>& structuredLogger)
+    const std::shared_ptr<StructuredLogger>& structuredLogger,
+    std::shared_ptr<folly::IOThreadPoolExecutorBase> ioThreadPool)
     : evb_(evb),
       threadPool_(threadPool),
+      ioThreadPool_(std::move(ioThreadPool)),
       structuredLogger_(structuredLogger),
       serverSocket_(new AsyncServerSocket(evb_)),
       proc_(std::move(proc)),
+      duplicateRequestCache_(std::make_shared<DuplicateRequestCache>()),
       state_{evb} {}
 
 void RpcServer::destroy() {
@@ -569,17 +646,18 @@ void RpcServer::initialize(folly::SocketAddress addr) {
 void RpcServer::initializeConnectedSocket(folly::File socket) {
   XLOG(DBG7) << "Initializing server from connected socket: " << socket.fd();
   // Note we don't initialize the accepting socket in this case. This is
-  // meant for server that only ever has one connected socket (nfsd3). Since
-  // we already have the one connected socket, we will not need the
-  // accepting socket to make any more connections.
-  auto& state = state_.get();
-  state.connectionHandlers.push_back(RpcConnectionHandler::create(
+  // meant for a server that is handed an already-connected socket during
+  // takeover. The transferred connection stays on the main EventBase; only
+  // connections accepted by this process are distributed across the I/O
+  // thread pool.
+  registerRpcHandler(RpcConnectionHandler::create(
       proc_,
       AsyncSocket::newSocket(
           evb_, folly::NetworkSocket::fromFd(socket.release())),
       threadPool_,
       structuredLogger_,
-      weak_from_this()));
+      weak_from_this(),
+      duplicateRequestCache_));
 }
 
 void RpcServer::initializeServerSocket(folly::File socket) {
@@ -593,17 +671,63 @@ void RpcServer::initializeServerSocket(folly::File socket) {
   serverSocket_->startAccepting();
 }
 
+void RpcServer::registerRpcHandler(RpcConnectionHandler::UniquePtr handler) {
+  auto& state = state_.get();
+  if (state.acceptStopped) {
+    // A connection assigned to an I/O thread finished its setup after
+    // takeoverStop() already collected the existing handlers. No process
+    // will service this connection, so shut it down; the client will
+    // reconnect to the process taking over.
+    auto* handlerEvb = handler->getEventBase();
+    folly::futures::detachOn(
+        handlerEvb,
+        folly::via(
+            handlerEvb,
+            [handler = std::move(handler)]() mutable {
+              auto* h = handler.get();
+              return h->takeoverStop().defer(
+                  [handler = std::move(handler)](auto&&) {});
+            })
+            .semi());
+    return;
+  }
+  state.connectionHandlers.push_back(std::move(handler));
+}
+
 void RpcServer::unregisterRpcHandler(RpcConnectionHandler* handlerToErase) {
+  if (!evb_->isInEventBaseThread()) {
+    // Handlers whose socket lives on an I/O thread unregister themselves
+    // from their own EventBase, but the handler list may only be touched on
+    // the main EventBase.
+    evb_->runInEventBaseThread([self = shared_from_this(), handlerToErase] {
+      self->unregisterRpcHandler(handlerToErase);
+    });
+    return;
+  }
+
   auto& state = state_.get();
   auto& handlers = state.connectionHandlers;
-  handlers.erase(
-      std::remove_if(
-          handlers.begin(),
-          handlers.end(),
-          [handlerToErase](RpcConnectionHandler::UniquePtr& handler) {
-            return handler.get() == handlerToErase;
-          }),
-      handlers.end());
+  auto it = std::find_if(
+      handlers.begin(),
+      handlers.end(),
+      [handlerToErase](RpcConnectionHandler::UniquePtr& handler) {
+        return handler.get() == handlerToErase;
+      });
+  if (it == handlers.end()) {
+    // takeoverStop() already removed this handler from the list.
+    return;
+  }
+  auto handler = std::move(*it);
+  handlers.erase(it);
+
+  // DelayedDestruction is not thread safe, so release the handler on the
+  // EventBase its socket is processed on; destruction will be deferred
+  // until the handler's last DestructorGuard is dropped there.
+  auto* handlerEvb = handler->getEventBase();
+  if (handlerEvb != evb_) {
+    handlerEvb->runInEventBaseThread(
+        [h = handler.release()] { h->destroy(); });
+  }
 }
 
 folly::SemiFuture<folly::File> RpcServer::takeoverStop() {
@@ -630,7 +754,19 @@ folly::SemiFuture<folly::File> RpcServer::takeoverStop() {
   std::vector<folly::SemiFuture<folly::Unit>> futures;
   futures.reserve(handlers.size());
   for (auto& handler : handlers) {
-    futures.emplace_back(handler->takeoverStop());
+    auto* handlerEvb = handler->getEventBase();
+    if (handlerEvb == evb_) {
+      futures.emplace_back(handler->takeoverStop());
+    } else {
+      // The handler's socket lives on an I/O thread: both takeoverStop()
+      // and the handler's destruction must happen on that EventBase.
+      futures.emplace_back(
+          folly::via(
+              handlerEvb,
+              [h = handler.get()] { return h->takeoverStop(); })
+              .ensure([handler = std::move(handler)] {})
+              .semi());
+    }
   }
 
   auto fd = serverSocket_->getNetworkSocket().toFd();
@@ -696,6 +832,14 @@ void RpcServer::registerService(uint32_t progNumber, uint32_t progVersion) {
   for (auto& addr : addrs) {
     auto [netid, addrStr] = getNetIdAndAddr(addr);
     PortmapMapping4 mapping{progNumber, progVersion, netid, addrStr, "edenfs"};
+    if (std::find(
+            state.mappedPorts.begin(), state.mappedPorts.end(), mapping) !=
+        state.mappedPorts.end()) {
+      // This exact mapping was already registered with rpcbind. Each
+      // setMapping call is a synchronous round trip to the rpcbind daemon
+      // made on the EventBase, so don't pay for it again.
+      continue;
+    }
     state.portMap.setMapping(mapping);
     state.mappedPorts.push_back(std::move(mapping));
   }
@@ -16,12 +16,14 @@
 
 #include "eden/fs/inodes/FsChannel.h"
 #include "eden/fs/nfs/portmap/PortmapClient.h"
+#include "eden/fs/nfs/rpc/DuplicateRequestCache.h"
 #include "eden/fs/nfs/rpc/Rpc.h"
 #include "eden/fs/utils/EventBaseState.h"
 #include "eden/fs/utils/ImmediateFuture.h"
 
 namespace folly {
 class Executor;
+class IOThreadPoolExecutorBase;
 }
 
 namespace facebook::eden {
@@ -121,13 +123,24 @@ class RpcConnectionHandler : public folly::DelayedDestruction,
    */
   folly::SemiFuture<folly::Unit> takeoverStop();
 
+  /**
+   * Return the EventBase that this handler's socket is processed on.
+   *
+   * This may differ from the owning RpcServer's EventBase when connections
+   * are distributed across an I/O thread pool.
+   */
+  folly::EventBase* getEventBase() const {
+    return sock_->getEventBase();
+  }
+
  private:
   RpcConnectionHandler(
       std::shared_ptr<RpcServerProcessor> proc,
       folly::AsyncSocket::UniquePtr&& socket,
       std::shared_ptr<folly::Executor> threadPool,
       const std::shared_ptr<StructuredLogger>& structuredLogger,
-      std::weak_ptr<RpcServer> owningServer);
+      std::weak_ptr<RpcServer> owningServer,
+      std::shared_ptr<DuplicateRequestCache> duplicateRequestCache);
 
   // AsyncReader::ReadCallback
 
@@ -229,6 +242,23 @@ class RpcConnectionHandler : public folly::DelayedDestruction,
 
   folly::IOBufQueue readBuf_{folly::IOBufQueue::cacheChainLength()};
 
+  /**
+   * Framing state for the record currently being accumulated in readBuf_,
+   * so readOneRequest() doesn't re-walk the whole buffered chain every
+   * time another chunk of a large record (a multi-megabyte WRITE3, say)
+   * arrives.
+   *
+   * scannedBytes_ is the number of bytes at the front of readBuf_ already
+   * known to hold complete, non-final fragments of the record; scanning
+   * resumes from there.  bytesNeeded_ is the total number of buffered
+   * bytes required before the fragment being scanned can make progress;
+   * until readBuf_ reaches that length readOneRequest() bails out with a
+   * single length check.  Both are only accessed on the socket's event
+   * base and are reset once a full record is split off.
+   */
+  size_t scannedBytes_{0};
+  size_t bytesNeeded_{0};
+
   /**
    * Status for the rpc connection. The State may only be accessed from the
    * socket's eventbase thread. We use this invariant so that we don't have to
@@ -261,6 +291,20 @@ class RpcConnectionHandler : public folly::DelayedDestruction,
    * shutdown then we can just skip notifying it that we are shutting down.
    */
   std::weak_ptr<RpcServer> owningServer_;
+
+  /**
+   * Cache of recently seen requests, shared by all the connections of the
+   * owning RpcServer so that a retransmission on a new connection is still
+   * detected. Null when the peer address of the socket couldn't be obtained,
+   * in which case retransmitted requests are re-executed like they always
+   * were.
+   */
+  std::shared_ptr<DuplicateRequestCache> duplicateRequestCache_;
+
+  /**
+   * Address of the connected client, used to key duplicateRequestCache_.
+   */
+  folly::SocketAddress clientAddress_;
 };
 
 class RpcServer final : public std::enable_shared_from_this<RpcServer>,
@@ -271,12 +315,21 @@ class RpcServer final : public std::enable_shared_from_this<RpcServer>,
    *
    * Request will be received on the passed EventBase and dispatched to the
    * RpcServerProcessor on the passed in threadPool.
+   *
+   * When an ioThreadPool is passed in, each accepted connection is assigned
+   * round-robin to one of the pool's EventBases and all socket reads and
+   * writes for that connection happen there. This lets clients that open
+   * several connections (such as macOS nconnect-style NFS mounts) scale
+   * with the number of connections rather than serializing all socket I/O
+   * on the main EventBase. The listening socket and the handler list stay
+   * on the main EventBase regardless.
    */
   static std::shared_ptr<RpcServer> create(
       std::shared_ptr<RpcServerProcessor> proc,
       folly::EventBase* evb,
       std::shared_ptr<folly::Executor> threadPool,
-      const std::shared_ptr<StructuredLogger>& structuredLogger);
+      const std::shared_ptr<StructuredLogger>& structuredLogger,
+      std::shared_ptr<folly::IOThreadPoolExecutorBase> ioThreadPool = nullptr);
 
   /**
    * RpcServer must be torn down on its EventBase. destroy() is called by the
@@ -332,7 +385,9 @@ class RpcServer final : public std::enable_shared_from_this<RpcServer>,
    * is shutting down. This informs the server so that the server can stop
    * tracking it.
    *
-   * Must be called on the EventBase.
+   * May be called from any thread: handlers whose socket lives on an I/O
+   * thread call this from their own EventBase and this will hop to the
+   * server's EventBase where the handler list lives.
    */
   void unregisterRpcHandler(RpcConnectionHandler* handlerToErase);
 
@@ -341,7 +396,16 @@ class RpcServer final : public std::enable_shared_from_this<RpcServer>,
       std::shared_ptr<RpcServerProcessor> proc,
       folly::EventBase* evb,
       std::shared_ptr<folly::Executor> threadPool,
-      const std::shared_ptr<StructuredLogger>& structuredLogger);
+      const std::shared_ptr<StructuredLogger>& structuredLogger,
+      std::shared_ptr<folly::IOThreadPoolExecutorBase> ioThreadPool);
+
+  /**
+   * Record a newly connected handler in the server's state.
+   *
+   * Must be called on the EventBase. If the server was already stopped for
+   * takeover, the late handler is shut down instead of being registered.
+   */
+  void registerRpcHandler(RpcConnectionHandler::UniquePtr handler);
 
   ~RpcServer() override;
 
@@ -365,6 +429,10 @@ class RpcServer final : public std::enable_shared_from_this<RpcServer>,
   // Threadpool for processing requests off the main event base.
   std::shared_ptr<folly::Executor> threadPool_;
 
+  // Optional pool of I/O threads that accepted connections are distributed
+  // across. When null, all connections are processed on evb_.
+  std::shared_ptr<folly::IOThreadPoolExecutorBase> ioThreadPool_;
+
   // Logger for logging anomalous things to Scuba
   std::shared_ptr<StructuredLogger> structuredLogger_;
 
@@ -374,6 +442,11 @@ class RpcServer final : public std::enable_shared_from_this<RpcServer>,
   // used to handle requests on the connected sockets.
   std::shared_ptr<RpcServerProcessor> proc_;
 
+  // Remembers recently seen requests so that client retransmissions of
+  // non-idempotent procedures are answered from cache instead of being
+  // re-executed. Shared by all the connections of this server.
+  std::shared_ptr<DuplicateRequestCache> duplicateRequestCache_;
+
   struct PortmapState {
     PortmapClient portMap;
     std::vector<PortmapMapping4> mappedPorts;
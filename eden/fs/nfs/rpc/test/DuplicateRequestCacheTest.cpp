@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/nfs/rpc/DuplicateRequestCache.h"
+
+#include <cstring>
+
+#include <folly/portability/GTest.h>
+
+namespace facebook::eden {
+
+namespace {
+folly::SocketAddress makeClient() {
+  return folly::SocketAddress{"127.0.0.1", 1023};
+}
+
+std::unique_ptr<folly::IOBuf> makeReply(size_t len) {
+  auto buf = folly::IOBuf::create(len);
+  memset(buf->writableTail(), 0xab, len);
+  buf->append(len);
+  return buf;
+}
+} // namespace
+
+TEST(DuplicateRequestCacheTest, firstRequestIsNotADuplicate) {
+  DuplicateRequestCache cache;
+  auto lookup = cache.lookupOrStart(makeClient(), 42, 7);
+  EXPECT_FALSE(lookup.isDuplicate);
+  EXPECT_EQ(lookup.reply, nullptr);
+}
+
+TEST(DuplicateRequestCacheTest, inProgressDuplicateHasNoReply) {
+  DuplicateRequestCache cache;
+  auto client = makeClient();
+  cache.lookupOrStart(client, 42, 7);
+
+  auto lookup = cache.lookupOrStart(client, 42, 7);
+  EXPECT_TRUE(lookup.isDuplicate);
+  EXPECT_EQ(lookup.reply, nullptr);
+}
+
+TEST(DuplicateRequestCacheTest, completedDuplicateReturnsReply) {
+  DuplicateRequestCache cache;
+  auto client = makeClient();
+  cache.lookupOrStart(client, 42, 7);
+
+  auto reply = makeReply(128);
+  cache.complete(client, 42, 7, reply);
+
+  auto lookup = cache.lookupOrStart(client, 42, 7);
+  EXPECT_TRUE(lookup.isDuplicate);
+  ASSERT_NE(lookup.reply, nullptr);
+  EXPECT_TRUE(folly::IOBufEqualTo{}(*lookup.reply, *reply));
+}
+
+TEST(DuplicateRequestCacheTest, largeRepliesAreNotRetained) {
+  DuplicateRequestCache cache;
+  auto client = makeClient();
+  cache.lookupOrStart(client, 42, 7);
+
+  auto reply = makeReply(DuplicateRequestCache::kMaxCachedReplySize + 1);
+  cache.complete(client, 42, 7, reply);
+
+  // The request was forgotten entirely, a retransmission will be
+  // re-executed.
+  auto lookup = cache.lookupOrStart(client, 42, 7);
+  EXPECT_FALSE(lookup.isDuplicate);
+}
+
+TEST(DuplicateRequestCacheTest, differentRequestsDoNotCollide) {
+  DuplicateRequestCache cache;
+  auto client = makeClient();
+  cache.lookupOrStart(client, 42, 7);
+
+  EXPECT_FALSE(cache.lookupOrStart(client, 43, 7).isDuplicate);
+  EXPECT_FALSE(cache.lookupOrStart(client, 42, 8).isDuplicate);
+  EXPECT_FALSE(
+      cache.lookupOrStart(folly::SocketAddress{"127.0.0.1", 1024}, 42, 7)
+          .isDuplicate);
+}
+
+} // namespace facebook::eden
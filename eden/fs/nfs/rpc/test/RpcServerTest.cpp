@@ -7,6 +7,7 @@
 
 #include "eden/fs/nfs/rpc/RpcServer.h"
 
+#include <folly/executors/IOThreadPoolExecutor.h>
 #include <folly/executors/QueuedImmediateExecutor.h>
 #include <folly/portability/GTest.h>
 #include "eden/fs/telemetry/NullStructuredLogger.h"
@@ -18,12 +19,15 @@ using namespace facebook::eden;
 class TestServerProcessor : public RpcServerProcessor {};
 
 struct RpcServerTest : ::testing::Test {
-  std::shared_ptr<RpcServer> createServer() {
+  std::shared_ptr<RpcServer> createServer(
+      std::shared_ptr<folly::IOThreadPoolExecutorBase> ioThreadPool =
+          nullptr) {
     return RpcServer::create(
         std::make_shared<TestServerProcessor>(),
         &evb,
         std::make_shared<folly::QueuedImmediateExecutor>(),
-        std::make_shared<NullStructuredLogger>());
+        std::make_shared<NullStructuredLogger>(),
+        std::move(ioThreadPool));
   }
 
   folly::EventBase evb;
@@ -49,6 +53,19 @@ TEST_F(RpcServerTest, takeover_after_initialize) {
   EXPECT_TRUE(takeover.isReady());
 }
 
+TEST_F(RpcServerTest, takeover_with_io_thread_pool) {
+  auto server =
+      createServer(std::make_shared<folly::IOThreadPoolExecutor>(2));
+
+  folly::SocketAddress addr;
+  addr.setFromIpPort("::0", 0);
+  server->initialize(addr);
+
+  auto takeover = server->takeoverStop();
+  evb.drive();
+  EXPECT_TRUE(takeover.isReady());
+}
+
 TEST_F(RpcServerTest, takeover_from_takeover) {
   auto server = createServer();
 
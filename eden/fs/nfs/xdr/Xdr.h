@@ -10,6 +10,7 @@
 #include <folly/Preprocessor.h>
 #include <folly/io/Cursor.h>
 #include <optional>
+#include <utility>
 #include <variant>
 
 // This PP stuff is mostly copy paste from FOLLY_PP_FOR_EACH, but works with
@@ -135,6 +136,13 @@
           EDEN_PP_DETAIL_FOR_EACH_1(EDEN_PP_DETAIL_NARGS(__VA_ARGS__)), \
           (EDEN_XDR_SER, __VA_ARGS__))                                  \
     }                                                                   \
+    static void serialize(                                              \
+        folly::io::QueueAppender& appender,                             \
+        STRUCT&& a) {                                                   \
+      FB_VA_GLUE(                                                       \
+          EDEN_PP_DETAIL_FOR_EACH_1(EDEN_PP_DETAIL_NARGS(__VA_ARGS__)), \
+          (EDEN_XDR_SER_MOVE, __VA_ARGS__))                             \
+    }                                                                   \
     static STRUCT deserialize(folly::io::Cursor& cursor) {              \
       STRUCT ret;                                                       \
       FB_VA_GLUE(                                                       \
@@ -163,6 +171,14 @@
 #define EDEN_XDR_SER(name) \
   XdrTrait<decltype(a.name)>::serialize(appender, a.name);
 
+// Like EDEN_XDR_SER, but for the rvalue serialize overload: each field is
+// moved into its serializer so that field types with a move-aware XdrTrait
+// (like IOBuf chains) can hand their data to the output queue instead of
+// copying it. Field types without a move-aware XdrTrait simply bind the
+// moved field to their const reference overload.
+#define EDEN_XDR_SER_MOVE(name) \
+  XdrTrait<decltype(a.name)>::serialize(appender, std::move(a.name));
+
 // This is a helper called by FOLLY_PP_FOR_EACH. It emits a call to
 // the de-serializer for a given field name.
 #define EDEN_XDR_DE(name) \
@@ -302,6 +318,17 @@ void serialize_iobuf(
     folly::io::QueueAppender& appender,
     const folly::IOBuf& buf);
 
+/**
+ * Serialize an IOBuf chain that the caller no longer needs. Unlike the
+ * overload above, the chain is handed to the output queue directly instead
+ * of being cloned, so large buffers (like blob data in a READ3 reply) reach
+ * the socket via writev without any per-buffer bookkeeping. The 4-byte
+ * alignment padding is written after the chain as usual.
+ */
+void serialize_iobuf(
+    folly::io::QueueAppender& appender,
+    std::unique_ptr<folly::IOBuf> buf);
+
 /**
  * Skip the padding bytes that were written during serialization.
  */
@@ -393,7 +420,8 @@ struct XdrTrait<std::vector<uint8_t>> {
  * IOBuf are encoded as a variable sized array, similarly to a vector. IOBuf
  * should be preferred to a vector when the data to serialize/deserialize is
  * potentially large, a vector would copy all the data, while an IOBuf would
- * clone the existing cursor.
+ * clone the existing cursor. Serializing an rvalue IOBuf avoids even the
+ * clone by appending the chain itself to the output queue.
  */
 template <>
 struct XdrTrait<std::unique_ptr<folly::IOBuf>> {
@@ -403,6 +431,12 @@ struct XdrTrait<std::unique_ptr<folly::IOBuf>> {
     detail::serialize_iobuf(appender, *buf);
   }
 
+  static void serialize(
+      folly::io::QueueAppender& appender,
+      std::unique_ptr<folly::IOBuf>&& buf) {
+    detail::serialize_iobuf(appender, std::move(buf));
+  }
+
   static std::unique_ptr<folly::IOBuf> deserialize(folly::io::Cursor& cursor) {
     auto len = XdrTrait<uint32_t>::deserialize(cursor);
     auto ret = std::make_unique<folly::IOBuf>();
@@ -519,6 +553,20 @@ struct XdrTrait<XdrVariant<Enum, Vars...>> {
         value.v);
   }
 
+  static void serialize(
+      folly::io::QueueAppender& appender,
+      XdrVariant<Enum, Vars...>&& value) {
+    XdrTrait<Enum>::serialize(appender, value.tag);
+    std::visit(
+        [&appender](auto&& arg) {
+          using ArgType = std::decay_t<decltype(arg)>;
+          if constexpr (!std::is_same_v<ArgType, std::monostate>) {
+            XdrTrait<ArgType>::serialize(appender, std::move(arg));
+          }
+        },
+        std::move(value.v));
+  }
+
   static size_t serializedSize(const XdrVariant<Enum, Vars...>& value) {
     return XdrTrait<Enum>::serializedSize(value.tag) +
         std::visit(
@@ -139,6 +139,45 @@ TEST(XdrSerialize, iobuf) {
   roundtrip(std::move(buf));
 }
 
+TEST(XdrSerialize, iobufMoveSerializeIsZeroCopy) {
+  // Large enough that IOBufQueue links the buffer into the output chain
+  // instead of packing it into the tail, and not 4-byte aligned so the
+  // padding path is exercised too.
+  std::string data(8195, 'x');
+  auto buf = folly::IOBuf::copyBuffer(data);
+  const uint8_t* payload = buf->data();
+
+  auto expected = ser(folly::IOBuf::copyBuffer(data));
+
+  folly::IOBufQueue queue;
+  folly::io::QueueAppender appender(&queue, 1024);
+  XdrTrait<std::unique_ptr<folly::IOBuf>>::serialize(appender, std::move(buf));
+  auto encoded = queue.move();
+
+  EXPECT_TRUE(folly::IOBufEqualTo{}(*encoded, *expected));
+
+  // The payload must have been linked into the output chain by reference,
+  // not copied into the response buffer.
+  bool linked = false;
+  for (const auto& range : *encoded) {
+    if (range.data() == payload) {
+      linked = true;
+    }
+  }
+  EXPECT_TRUE(linked);
+}
+
+TEST(XdrSerialize, structMoveSerialize) {
+  MySerializableStruct s{123, "hello world"};
+  auto expected = ser(s);
+
+  folly::IOBufQueue queue;
+  folly::io::QueueAppender appender(&queue, 1024);
+  XdrTrait<MySerializableStruct>::serialize(appender, std::move(s));
+
+  EXPECT_TRUE(folly::IOBufEqualTo{}(*queue.move(), *expected));
+}
+
 struct ListElement {
   uint32_t value;
 };
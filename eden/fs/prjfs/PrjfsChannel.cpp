@@ -9,6 +9,7 @@
 
 #include "eden/fs/prjfs/PrjfsChannel.h"
 #include <fmt/format.h>
+#include <folly/executors/GlobalExecutor.h>
 #include <folly/logging/xlog.h>
 
 #include "eden/common/utils/StringConv.h"
@@ -431,7 +432,8 @@ PrjfsChannelInner::PrjfsChannelInner(
     ProcessAccessLog& processAccessLog,
     folly::Promise<folly::Unit> deletedPromise,
     std::shared_ptr<Notifier> notifier,
-    size_t prjfsTraceBusCapacity)
+    size_t prjfsTraceBusCapacity,
+    bool useParallelHydration)
     : dispatcher_(std::move(dispatcher)),
       straceLogger_(straceLogger),
       notifier_(std::move(notifier)),
@@ -440,7 +442,8 @@ PrjfsChannelInner::PrjfsChannelInner(
       traceDetailedArguments_(std::atomic<size_t>(0)),
       traceBus_(TraceBus<PrjfsTraceEvent>::create(
           "PrjfsTrace",
-          prjfsTraceBusCapacity)) {
+          prjfsTraceBusCapacity)),
+      useParallelHydration_(useParallelHydration) {
   traceSubscriptionHandles_.push_back(traceBus_->subscribeFunction(
       "PrjFS request tracking", [this](const PrjfsTraceEvent& event) {
         switch (event.getType()) {
@@ -843,6 +846,72 @@ uint64_t BlockAlignTruncate(uint64_t ptr, uint32_t alignment) {
 constexpr uint32_t kMinChunkSize = 512 * 1024; // 512 KiB
 constexpr uint32_t kMaxChunkSize = 5 * 1024 * 1024; // 5 MiB
 
+/**
+ * Number of slices a large hydration request is split into when parallel
+ * hydration is enabled. This bounds both the write concurrency and the
+ * number of concurrently allocated aligned buffers.
+ */
+constexpr uint64_t kMaxParallelWrites = 4;
+
+/**
+ * Write the requested range to the file by carving it into contiguous
+ * slices, each a multiple of the storage device's write alignment, and
+ * writing the slices concurrently on the global CPU executor. Each slice
+ * runs the serial chunked write loop and thus allocates a single chunkSize
+ * buffer.
+ */
+folly::SemiFuture<HRESULT> writeFileChunksInParallel(
+    PRJ_NAMESPACE_VIRTUALIZATION_CONTEXT namespaceVirtualizationContext,
+    Guid dataStreamId,
+    std::shared_ptr<const std::string> content,
+    uint64_t startOffset,
+    uint64_t length,
+    uint64_t chunkSize,
+    uint32_t writeAlignment) {
+  auto sliceLength =
+      BlockAlignTruncate(length / kMaxParallelWrites, writeAlignment);
+  XDCHECK_GT(sliceLength, 0ull);
+
+  std::vector<folly::SemiFuture<HRESULT>> futures;
+  futures.reserve(kMaxParallelWrites);
+  for (uint64_t i = 0; i < kMaxParallelWrites; i++) {
+    auto sliceStart = startOffset + i * sliceLength;
+    // The last slice extends to the end of the requested range.
+    auto sliceEnd = i == kMaxParallelWrites - 1 ? startOffset + length
+                                                : sliceStart + sliceLength;
+    futures.push_back(folly::via(
+                          folly::getGlobalCPUExecutor(),
+                          [namespaceVirtualizationContext,
+                           dataStreamId,
+                           content,
+                           sliceStart,
+                           sliceLength = sliceEnd - sliceStart,
+                           chunkSize] {
+                            return readMultipleFileChunks(
+                                namespaceVirtualizationContext,
+                                dataStreamId,
+                                *content,
+                                /*startOffset=*/sliceStart,
+                                /*length=*/sliceLength,
+                                /*chunkSize=*/chunkSize);
+                          })
+                          .semi());
+  }
+
+  return folly::collectAll(std::move(futures))
+      .deferValue([](std::vector<folly::Try<HRESULT>> tries) {
+        for (auto& result : tries) {
+          if (result.hasException()) {
+            return E_FAIL;
+          }
+          if (FAILED(result.value())) {
+            return result.value();
+          }
+        }
+        return S_OK;
+      });
+}
+
 } // namespace
 
 HRESULT PrjfsChannelInner::getFileData(
@@ -878,7 +947,9 @@ HRESULT PrjfsChannelInner::getFileData(
                         virtualizationContext = virtualizationContext,
                         dataStreamId = std::move(dataStreamId),
                         byteOffset = byteOffset,
-                        length = length](const std::string content) {
+                        length = length,
+                        useParallelHydration = useParallelHydration_](
+                           std::string content) -> ImmediateFuture<folly::Unit> {
               //
               // We should return file data which is smaller than
               // our kMaxChunkSize and meets the memory alignment
@@ -926,6 +997,30 @@ HRESULT PrjfsChannelInner::getFileData(
                   XDCHECK_GT(endOffset, startOffset);
 
                   uint64_t chunkSize = endOffset - startOffset;
+
+                  if (useParallelHydration &&
+                      BlockAlignTruncate(
+                          length / kMaxParallelWrites,
+                          instanceInfo.WriteAlignment) > 0) {
+                    return ImmediateFuture{writeFileChunksInParallel(
+                               virtualizationContext,
+                               dataStreamId,
+                               std::make_shared<const std::string>(
+                                   std::move(content)),
+                               /*startOffset=*/startOffset,
+                               /*length=*/length,
+                               /*chunkSize=*/chunkSize,
+                               instanceInfo.WriteAlignment)}
+                        .thenValue(
+                            [context = std::move(context)](HRESULT result) {
+                              if (FAILED(result)) {
+                                context->sendError(result);
+                              } else {
+                                context->sendSuccess();
+                              }
+                            });
+                  }
+
                   result = readMultipleFileChunks(
                       virtualizationContext,
                       dataStreamId,
@@ -941,6 +1036,7 @@ HRESULT PrjfsChannelInner::getFileData(
               } else {
                 context->sendSuccess();
               }
+              return folly::unit;
             });
       });
 
@@ -1337,7 +1433,8 @@ PrjfsChannel::PrjfsChannel(
       processAccessLog_,
       std::move(innerDeletedPromise),
       std::move(notifier),
-      config_->getEdenConfig()->PrjfsTraceBusCapacity.getValue()));
+      config_->getEdenConfig()->PrjfsTraceBusCapacity.getValue(),
+      config_->getEdenConfig()->prjfsUseParallelHydration.getValue()));
 }
 
 PrjfsChannel::~PrjfsChannel() {
@@ -167,7 +167,8 @@ class PrjfsChannelInner {
       ProcessAccessLog& processAccessLog,
       folly::Promise<folly::Unit> deletedPromise,
       std::shared_ptr<Notifier> notifier,
-      size_t prjfsTraceBusCapacity);
+      size_t prjfsTraceBusCapacity,
+      bool useParallelHydration);
 
   ~PrjfsChannelInner();
 
@@ -476,6 +477,10 @@ class PrjfsChannelInner {
   std::shared_ptr<TraceBus<PrjfsTraceEvent>> traceBus_;
 
   bool symlinksSupported_ = false;
+
+  // Whether getFileData writes the chunks of large files concurrently. See
+  // prjfs:use-parallel-hydration.
+  bool useParallelHydration_ = false;
 };
 
 class PrjfsChannel : public FsChannel {
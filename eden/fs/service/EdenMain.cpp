@@ -166,7 +166,8 @@ void EdenMain::registerStandardBackingStores() {
                 params.serverState->getProcessInfoCache())),
         params.localStore,
         params.sharedStats.copy(),
-        localStoreCaching);
+        localStoreCaching,
+        reloadableConfig);
   });
 
   registerBackingStore(
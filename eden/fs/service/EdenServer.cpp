@@ -29,6 +29,7 @@
 #include <folly/chrono/Conv.h>
 #include <folly/io/async/AsyncSignalHandler.h>
 #include <folly/io/async/HHWheelTimer.h>
+#include <folly/json.h>
 #include <folly/logging/xlog.h>
 #include <folly/portability/GFlags.h>
 #include <folly/stop_watch.h>
@@ -69,6 +70,7 @@
 #include "eden/fs/store/ObjectStore.h"
 #include "eden/fs/store/RocksDbLocalStore.h"
 #include "eden/fs/store/SqliteLocalStore.h"
+#include "eden/fs/store/TieredLocalStore.h"
 #include "eden/fs/store/TreeCache.h"
 #include "eden/fs/store/hg/HgBackingStore.h"
 #include "eden/fs/store/hg/HgQueuedBackingStore.h"
@@ -76,6 +78,7 @@
 #include "eden/fs/telemetry/EdenStats.h"
 #include "eden/fs/telemetry/IHiveLogger.h"
 #include "eden/fs/telemetry/RequestMetricsScope.h"
+#include "eden/fs/telemetry/RequestSpanRecorder.h"
 #include "eden/fs/telemetry/SessionInfo.h"
 #include "eden/fs/telemetry/StructuredLogger.h"
 #include "eden/fs/telemetry/StructuredLoggerFactory.h"
@@ -89,6 +92,8 @@
 #include "eden/fs/utils/NotImplemented.h"
 #include "eden/fs/utils/PathFuncs.h"
 #include "eden/fs/utils/ProcUtil.h"
+#include "eden/fs/utils/StringInterner.h"
+#include "eden/fs/utils/ThreadSampler.h"
 #include "eden/fs/utils/TimeUtil.h"
 #include "eden/fs/utils/UnboundedQueueExecutor.h"
 #include "eden/fs/utils/UserInfo.h"
@@ -145,7 +150,8 @@ DEFINE_int64(
 DEFINE_int64(
     start_delay_minutes,
     10,
-    "Initial delay before first background inode unload");
+    "No longer used; background inode unloading is splayed by the periodic "
+    "task scheduler");
 DEFINE_int64(
     unload_age_minutes,
     6 * 60,
@@ -261,10 +267,13 @@ std::string getCounterNameForFuseRequests(
 
 #ifdef __linux__
 // **not safe to call this function from a fuse thread**
-// this gets the kernels view of the number of pending requests, to do this, it
-// stats the fuse mount root in the filesystem which could call into the FUSE
-// daemon which could cause a deadlock.
-size_t getNumberPendingFuseRequests(const EdenMount* mount) {
+// Resolves the sysfs path holding the kernel's count of pending requests
+// for this mount's FUSE connection. This stats the fuse mount root in the
+// filesystem, which calls into the FUSE daemon itself and could deadlock
+// if invoked from a fuse thread; it can also block whenever the dispatcher
+// is saturated, which is exactly when the counter is interesting. Resolve
+// the path once at registration rather than on every counter poll.
+std::string getPendingFuseRequestsPath(const EdenMount* mount) {
   constexpr StringPiece kFuseInfoDir{"/sys/fs/fuse/connections"};
   constexpr StringPiece kFusePendingRequestFile{"waiting"};
 
@@ -276,14 +285,22 @@ size_t getNumberPendingFuseRequests(const EdenMount* mount) {
       "unable to get FUSE device number for mount ",
       basename(mount->getPath().view()));
 
-  auto pending_request_path = folly::to<std::string>(
+  return folly::to<std::string>(
       kFuseInfoDir,
       kDirSeparator,
       file_metadata.st_dev,
       kDirSeparator,
       kFusePendingRequestFile);
+}
 
-  auto pending_requests = readFile(canonicalPath(pending_request_path));
+// Reads the kernel's view of the number of requests queued on the FUSE
+// connection, i.e. read off the device but not yet completed plus those
+// still waiting to be read.
+size_t readPendingFuseRequests(const std::string& pendingRequestsPath) {
+  if (pendingRequestsPath.empty()) {
+    return 0;
+  }
+  auto pending_requests = readFile(canonicalPath(pendingRequestsPath));
   return pending_requests.hasValue()
       ? folly::to<size_t>(pending_requests.value())
       : 0;
@@ -349,6 +366,29 @@ class EdenServer::ThriftServerEventHandler
 };
 
 static constexpr folly::StringPiece kBlobCacheMemory{"blob_cache.memory"};
+static constexpr folly::StringPiece kTreeCacheMemory{"tree_cache.memory"};
+static constexpr folly::StringPiece kCpuPoolQueueDepth{"cpu_pool.queue_depth"};
+static constexpr folly::StringPiece kCpuPoolQueueDelayUs{
+    "cpu_pool.queue_delay_us"};
+static constexpr folly::StringPiece kStringInternerMemory{
+    "string_interner.memory"};
+
+/**
+ * Counter name suffixes for the per-priority Thrift queue length counters
+ * exported when thrift:use-priority-queues is enabled.
+ */
+static constexpr std::pair<apache::thrift::concurrency::PRIORITY, StringPiece>
+    kThriftQueuePriorities[] = {
+        {apache::thrift::concurrency::HIGH_IMPORTANT, "high_important"},
+        {apache::thrift::concurrency::HIGH, "high"},
+        {apache::thrift::concurrency::IMPORTANT, "important"},
+        {apache::thrift::concurrency::NORMAL, "normal"},
+        {apache::thrift::concurrency::BEST_EFFORT, "best_effort"},
+};
+
+static std::string thriftQueuedRequestsCounterName(StringPiece priorityName) {
+  return fmt::format("thrift.queued_requests.{}", priorityName);
+}
 static constexpr folly::StringPiece kNfsReadCount60{"nfs.read_us.count.60"};
 static constexpr folly::StringPiece kNfsReadDirCount60{
     "nfs.readdir_us.count.60"};
@@ -404,10 +444,39 @@ EdenServer::EdenServer(
       progressManager_{
           std::make_unique<folly::Synchronized<EdenServer::ProgressManager>>()},
       startupStatusChannel_{std::move(startupStatusChannel)} {
+  mountRoutingTable_.store(std::make_shared<const MountRoutingTable>());
+
+  // Where supported, watch the config files with inotify so that hot paths
+  // calling getEdenConfig() never stat them.
+  config_->startFileWatcher();
+
+  {
+    auto edenConfig = config_->getEdenConfig();
+    if (edenConfig->profilerEnabled.getValue()) {
+      ThreadSampler::get().start(
+          std::chrono::duration_cast<std::chrono::milliseconds>(
+              edenConfig->profilerSampleInterval.getValue()));
+    }
+    SlowRequestTraceBuffer::get().configure(
+        edenConfig->slowRequestTraceThreshold.getValue());
+  }
+
   auto counters = fb303::ServiceData::get()->getDynamicCounters();
   counters->registerCallback(kBlobCacheMemory, [this] {
     return this->getBlobCache()->getStats().totalSizeInBytes;
   });
+  counters->registerCallback(kTreeCacheMemory, [this] {
+    return this->getTreeCache()->getStats().totalSizeInBytes;
+  });
+  counters->registerCallback(kCpuPoolQueueDepth, [this] {
+    return this->serverState_->getThreadPool()->getQueueDepth();
+  });
+  counters->registerCallback(kCpuPoolQueueDelayUs, [this] {
+    return this->serverState_->getThreadPool()->getLastQueueDelay().count();
+  });
+  counters->registerCallback(kStringInternerMemory, [] {
+    return StringInterner::get().getTotalBytes();
+  });
 
   registerInodePopulationReportsCallback();
 
@@ -445,8 +514,21 @@ EdenServer::EdenServer(
 }
 
 EdenServer::~EdenServer() {
+  // Stop interrupting threads before they start going away during shutdown.
+  ThreadSampler::get().stop();
+
   auto counters = fb303::ServiceData::get()->getDynamicCounters();
   counters->unregisterCallback(kBlobCacheMemory);
+  counters->unregisterCallback(kTreeCacheMemory);
+  counters->unregisterCallback(kCpuPoolQueueDepth);
+  counters->unregisterCallback(kCpuPoolQueueDelayUs);
+  counters->unregisterCallback(kStringInternerMemory);
+
+  // These are only registered when thrift:use-priority-queues is enabled;
+  // unregistering an absent counter is a no-op.
+  for (const auto& entry : kThriftQueuePriorities) {
+    counters->unregisterCallback(thriftQueuedRequestsCounterName(entry.second));
+  }
 
   unregisterInodePopulationReportsCallback();
 
@@ -534,8 +616,8 @@ void EdenServer::ProgressManager::printProgresses(
     } else {
       content += fmt::format(
           "[{:21}] {:>3}%: fsck on {}{}",
-          std::string(it.fsckPercentComplete * 2, '=') + ">",
-          it.fsckPercentComplete * 10,
+          std::string(it.fsckPercentComplete / 5, '=') + ">",
+          it.fsckPercentComplete,
           it.localDir,
           "\n");
       printedInProgress++;
@@ -713,17 +795,6 @@ void EdenServer::startPeriodicTasks() {
   auto config = serverState_->getReloadableConfig()->getEdenConfig();
   updatePeriodicTaskIntervals(*config);
 
-#ifndef _WIN32
-  // Schedule a periodic job to unload unused inodes based on the last access
-  // time. currently Eden does not have accurate timestamp tracking for inodes,
-  // so using unloadChildrenNow just to validate the behaviour. We will have to
-  // modify current unloadChildrenNow function to unload inodes based on the
-  // last access time.
-  if (FLAGS_unload_interval_minutes > 0) {
-    scheduleInodeUnload(std::chrono::minutes(FLAGS_start_delay_minutes));
-  }
-#endif
-
   backingStoreTask_.updateInterval(1min);
 }
 
@@ -757,6 +828,18 @@ void EdenServer::updatePeriodicTaskIntervals(const EdenConfig& config) {
             config.gcPeriod.getValue()));
   }
 
+#ifndef _WIN32
+  auto inodeUnloadInterval = config.periodicInodeUnloadInterval.getValue();
+  if (inodeUnloadInterval.count() == 0) {
+    // Fall back to the legacy command line flag for deployments that still
+    // enable background inode unloading that way.
+    inodeUnloadInterval = std::chrono::minutes(FLAGS_unload_interval_minutes);
+  }
+  inodeUnloadTask_.updateInterval(
+      std::chrono::duration_cast<std::chrono::milliseconds>(
+          inodeUnloadInterval));
+#endif
+
   if (config.enableNfsServer.getValue() &&
       config.enableNfsCrawlDetection.getValue()) {
     auto interval = config.nfsCrawlInterval.getValue();
@@ -831,36 +914,43 @@ size_t EdenServer::enumerateInProgressCheckouts() {
 
 #ifndef _WIN32
 void EdenServer::unloadInodes() {
-  auto mounts = getMountPoints();
-
-  if (!mounts.empty()) {
-    auto cutoff = std::chrono::system_clock::now() -
-        std::chrono::minutes(FLAGS_unload_age_minutes);
-    auto cutoff_ts = folly::to<timespec>(cutoff);
-    for (auto& mountHandle : mounts) {
-      auto& mount = mountHandle.getEdenMount();
-      auto& rootInode = mountHandle.getRootInode();
-      auto unloaded = rootInode->unloadChildrenLastAccessedBefore(cutoff_ts);
-      if (unloaded) {
-        XLOG(INFO) << "Unloaded " << unloaded
-                   << " inodes in background from mount " << mount.getPath();
-      }
-      mount.getInodeMap()->recordPeriodicInodeUnload(unloaded);
-    }
+  auto config = serverState_->getReloadableConfig()->getEdenConfig();
+  auto age = config->periodicInodeUnloadAge.getValue();
+  if (age.count() == 0) {
+    age = std::chrono::minutes(FLAGS_unload_age_minutes);
   }
+  auto workingSetTarget = config->inodeWorkingSetTarget.getValue();
 
-  scheduleInodeUnload(std::chrono::minutes(FLAGS_unload_interval_minutes));
-}
+  auto cutoff = std::chrono::system_clock::now() -
+      std::chrono::duration_cast<std::chrono::system_clock::duration>(age);
+  auto cutoff_ts = folly::to<timespec>(cutoff);
 
-void EdenServer::scheduleInodeUnload(std::chrono::milliseconds timeout) {
-  mainEventBase_->timer().scheduleTimeoutFn(
-      [this] {
-        XLOG(DBG4) << "Beginning periodic inode unload";
-        unloadInodes();
-      },
-      timeout);
-}
+  for (auto& mountHandle : getMountPoints()) {
+    auto& mount = mountHandle.getEdenMount();
+    auto* inodeMap = mount.getInodeMap();
+
+    if (workingSetTarget != 0) {
+      auto counts = inodeMap->getInodeCounts();
+      if (counts.fileCount + counts.treeCount <= workingSetTarget) {
+        // This mount's loaded inode count is within its working-set target;
+        // don't pay for a tree walk that would unload little or nothing.
+        continue;
+      }
+    }
 
+    folly::stop_watch<> scanWatch;
+    auto unloaded =
+        mountHandle.getRootInode()->unloadChildrenLastAccessedBefore(cutoff_ts);
+    getStats()->addDuration(
+        &InodeMapStats::periodicUnloadScan, scanWatch.elapsed());
+    getStats()->increment(&InodeMapStats::periodicUnloadCount, unloaded);
+    if (unloaded) {
+      XLOG(INFO) << "Unloaded " << unloaded
+                 << " inodes in background from mount " << mount.getPath();
+    }
+    inodeMap->recordPeriodicInodeUnload(unloaded);
+  }
+}
 #endif // !_WIN32
 
 Future<Unit> EdenServer::recover(TakeoverData&& data) {
@@ -903,6 +993,9 @@ void EdenServer::serve() const {
 }
 
 Future<Unit> EdenServer::prepare(std::shared_ptr<StartupLogger> logger) {
+  // Retain the logger so that getStartupProfile() can report the startup
+  // timeline after startup completes.
+  startupLogger_ = logger;
   return prepareImpl(std::move(logger))
       .ensure(
           // Mark the server state as RUNNING once we finish setting up the
@@ -1021,6 +1114,7 @@ Future<Unit> EdenServer::prepareImpl(std::shared_ptr<StartupLogger> logger) {
           throw LocalStoreOpenError(ex.what());
         }
         std::vector<Future<Unit>> mountFutures;
+        folly::stop_watch<std::chrono::milliseconds> mountWatch;
         if (doingTakeover) {
 #ifndef _WIN32
           mountFutures = prepareMountsTakeover(
@@ -1031,14 +1125,49 @@ Future<Unit> EdenServer::prepareImpl(std::shared_ptr<StartupLogger> logger) {
         } else {
           mountFutures = prepareMounts(logger);
         }
+        const auto numMounts = mountFutures.size();
 
         // Return a future that will complete only when all mount points have
         // started and the thrift server is also running.
         mountFutures.emplace_back(std::move(thriftRunningFuture));
-        return folly::collectAllUnsafe(std::move(mountFutures)).unit();
+        return folly::collectAllUnsafe(std::move(mountFutures))
+            .thenValue([this, logger, numMounts, mountWatch](auto&&) {
+              if (numMounts != 0) {
+                logger->log(
+                    "Prepared ",
+                    numMounts,
+                    " mount points in ",
+                    mountWatch.elapsed().count() / 1000.0,
+                    " seconds.");
+              }
+              saveStartupProfile(*logger);
+            });
       });
 }
 
+void EdenServer::saveStartupProfile(const StartupLogger& logger) {
+  auto profilePath =
+      edenDir_.getPath() + PathComponentPiece{"startup_profile.json"};
+
+  folly::dynamic phases = folly::dynamic::array();
+  std::chrono::microseconds previous{0};
+  for (const auto& entry : logger.getTimeline()) {
+    phases.push_back(folly::dynamic::object("name", entry.message)(
+        "elapsed_us", entry.elapsed.count())(
+        "duration_us", (entry.elapsed - previous).count()));
+    previous = entry.elapsed;
+  }
+
+  auto json =
+      folly::toPrettyJson(folly::dynamic::object("phases", std::move(phases)));
+  auto result = writeFileAtomic(profilePath, folly::StringPiece(json));
+  if (result.hasException()) {
+    // Startup profiling is best-effort; don't fail startup over it.
+    XLOG(WARN) << "Failed to write " << profilePath << ": "
+               << result.exception().what();
+  }
+}
+
 std::shared_ptr<cpptoml::table> EdenServer::parseConfig() {
   auto configPath = edenDir_.getPath() + RelativePathPiece{kStateConfig};
 
@@ -1103,6 +1232,13 @@ bool EdenServer::createStorageEngine(cpptoml::table& config) {
         &serverState_->getFaultInjector());
     XLOG(DBG2) << "Created RocksDB store in "
                << watch.elapsed().count() / 1000.0 << " seconds.";
+    if (serverState_->getEdenConfig()->useWriteBackLocalStore.getValue()) {
+      XLOG(DBG2) << "Wrapping RocksDB store in a write-back tier.";
+      localStore_ = make_shared<TieredLocalStore>(
+          std::move(localStore_),
+          serverState_->getThreadPool(),
+          getStats().copy());
+    }
   } else {
     throw std::runtime_error(
         folly::to<string>("invalid storage engine: ", storageEngine));
@@ -1132,17 +1268,25 @@ std::vector<Future<Unit>> EdenServer::prepareMountsTakeover(
   }
 
   for (auto& info : takeoverMounts) {
-    const auto stateDirectory = info.stateDirectory;
+    // Run the per-mount preparation on the server thread pool so that the
+    // synchronous prologue of one mount (config load, mount object creation)
+    // does not delay the others.
+    auto mountPath = info.mountPath;
     auto mountFuture =
-        makeFutureWith([&] {
-          auto initialConfig = CheckoutConfig::loadFromClientDirectory(
-              AbsolutePathPiece{info.mountPath},
-              AbsolutePathPiece{info.stateDirectory});
-
-          return mount(
-              std::move(initialConfig), false, [](auto) {}, std::move(info));
-        })
-            .thenTry([logger, mountPath = info.mountPath](
+        folly::via(
+            serverState_->getThreadPool().get(),
+            [this, info = std::move(info)]() mutable {
+              auto initialConfig = CheckoutConfig::loadFromClientDirectory(
+                  AbsolutePathPiece{info.mountPath},
+                  AbsolutePathPiece{info.stateDirectory});
+
+              return mount(
+                  std::move(initialConfig),
+                  false,
+                  [](auto) {},
+                  std::move(info));
+            })
+            .thenTry([logger, mountPath = std::move(mountPath)](
                          folly::Try<std::shared_ptr<EdenMount>>&& result) {
               if (result.hasValue()) {
                 logger->log("Successfully took over mount ", mountPath);
@@ -1187,43 +1331,50 @@ std::vector<Future<Unit>> EdenServer::prepareMounts(
   logger->log("Remounting ", dirs.size(), " mount points...");
 
   for (const auto& client : dirs.items()) {
-    auto mountFuture = makeFutureWith([&] {
-      auto mountPath = canonicalPath(client.first.stringPiece());
-      auto edenClientPath =
-          edenDir_.getCheckoutStateDir(client.second.stringPiece());
-      auto initialConfig =
-          CheckoutConfig::loadFromClientDirectory(mountPath, edenClientPath);
-      auto progressIndex = progressManager_->wlock()->registerEntry(
-          client.first.asString(), initialConfig->getOverlayPath().c_str());
-
-      return mount(
-                 std::move(initialConfig),
-                 false,
-                 [this, logger, progressIndex](auto percent) {
-                   progressManager_->wlock()->manageProgress(
-                       logger, progressIndex, percent);
-                 })
-          .thenTry([this, logger, mountPath, progressIndex](
-                       folly::Try<std::shared_ptr<EdenMount>>&& result) {
-            if (result.hasValue()) {
-              auto wl = progressManager_->wlock();
-              wl->finishProgress(progressIndex);
-              wl->printProgresses(logger);
-              return makeFuture();
-            } else {
-              incrementStartupMountFailures();
-              auto errorMessage = fmt::format(
-                  "Failed to remount {}: {}\n",
-                  mountPath.value(),
-                  result.exception().what());
-              XLOG(DBG7) << errorMessage;
-              auto wl = progressManager_->wlock();
-              wl->markFailed(progressIndex);
-              wl->printProgresses(logger, errorMessage);
-              return makeFuture<Unit>(std::move(result).exception());
-            }
-          });
-    });
+    // Run the per-mount preparation on the server thread pool so that the
+    // synchronous prologue of one mount (config load, mount object creation)
+    // does not delay the others.
+    auto mountFuture = folly::via(
+        serverState_->getThreadPool().get(),
+        [this,
+         logger,
+         mountName = client.first.asString(),
+         clientName = client.second.asString()] {
+          auto mountPath = canonicalPath(mountName);
+          auto edenClientPath = edenDir_.getCheckoutStateDir(clientName);
+          auto initialConfig = CheckoutConfig::loadFromClientDirectory(
+              mountPath, edenClientPath);
+          auto progressIndex = progressManager_->wlock()->registerEntry(
+              mountName, initialConfig->getOverlayPath().c_str());
+
+          return mount(
+                     std::move(initialConfig),
+                     false,
+                     [this, logger, progressIndex](auto percent) {
+                       progressManager_->wlock()->manageProgress(
+                           logger, progressIndex, percent);
+                     })
+              .thenTry([this, logger, mountPath, progressIndex](
+                           folly::Try<std::shared_ptr<EdenMount>>&& result) {
+                if (result.hasValue()) {
+                  auto wl = progressManager_->wlock();
+                  wl->finishProgress(progressIndex);
+                  wl->printProgresses(logger);
+                  return makeFuture();
+                } else {
+                  incrementStartupMountFailures();
+                  auto errorMessage = fmt::format(
+                      "Failed to remount {}: {}\n",
+                      mountPath.value(),
+                      result.exception().what());
+                  XLOG(DBG7) << errorMessage;
+                  auto wl = progressManager_->wlock();
+                  wl->markFailed(progressIndex);
+                  wl->printProgresses(logger, errorMessage);
+                  return makeFuture<Unit>(std::move(result).exception());
+                }
+              });
+        });
 
     mountFutures.push_back(std::move(mountFuture));
   }
@@ -1353,6 +1504,25 @@ void EdenServer::addToMountPoints(std::shared_ptr<EdenMount> edenMount) {
           fmt::format("mount point \"{}\" is already mounted", mountPath));
     }
   }
+  publishMountRoutingTable();
+}
+
+void EdenServer::publishMountRoutingTable() {
+  auto table = std::make_shared<MountRoutingTable>();
+  {
+    const auto mountPoints = mountPoints_->rlock();
+    for (const auto& [path, info] : *mountPoints) {
+      table->emplace(path.asString(), info.edenMount);
+      // On platforms where the thrift representation of a path differs
+      // from the native one, index the mount under both spellings so the
+      // raw client-supplied string always hits.
+      auto thriftPath = absolutePathToThrift(path);
+      if (thriftPath != path.view()) {
+        table->emplace(std::move(thriftPath), info.edenMount);
+      }
+    }
+  }
+  mountRoutingTable_.store(std::move(table));
 }
 
 void EdenServer::registerStats(std::shared_ptr<EdenMount> edenMount) {
@@ -1366,6 +1536,10 @@ void EdenServer::registerStats(std::shared_ptr<EdenMount> edenMount) {
       edenMount->getCounterName(CounterName::INODEMAP_UNLOADED), [edenMount] {
         return edenMount->getInodeMap()->getInodeCounts().unloadedInodeCount;
       });
+  counters->registerCallback(
+      edenMount->getCounterName(CounterName::INODEMAP_MEMORY), [edenMount] {
+        return edenMount->getInodeMap()->estimateMemoryUsage();
+      });
   counters->registerCallback(
       edenMount->getCounterName(CounterName::PERIODIC_INODE_UNLOAD),
       [edenMount] {
@@ -1399,6 +1573,9 @@ void EdenServer::registerStats(std::shared_ptr<EdenMount> edenMount) {
         auto stats = edenMount->getJournal().getStats();
         return stats ? stats->maxFilesAccumulated : 0;
       });
+  counters->registerCallback(
+      edenMount->getCounterName(CounterName::OVERLAY_DATA_SIZE),
+      [edenMount] { return edenMount->getOverlay()->getDataSize(); });
 #ifndef _WIN32
   if (auto* channel = edenMount->getFuseChannel()) {
     for (auto metric : RequestMetricsScope::requestMetrics) {
@@ -1415,14 +1592,21 @@ void EdenServer::registerStats(std::shared_ptr<EdenMount> edenMount) {
 #endif
 #ifdef __linux__
   if (edenMount->getFuseChannel()) {
+    std::string pendingRequestsPath;
+    try {
+      pendingRequestsPath = getPendingFuseRequestsPath(edenMount.get());
+    } catch (const std::exception& ex) {
+      XLOG(WARN) << "unable to resolve pending FUSE requests path for "
+                 << edenMount->getPath() << ": " << folly::exceptionStr(ex);
+    }
     counters->registerCallback(
         getCounterNameForFuseRequests(
             RequestMetricsScope::RequestStage::PENDING,
             RequestMetricsScope::RequestMetric::COUNT,
             edenMount.get()),
-        [edenMount] {
+        [pendingRequestsPath = std::move(pendingRequestsPath)] {
           try {
-            return getNumberPendingFuseRequests(edenMount.get());
+            return readPendingFuseRequests(pendingRequestsPath);
           } catch (const std::exception&) {
             return size_t{0};
           }
@@ -1437,6 +1621,8 @@ void EdenServer::unregisterStats(EdenMount* edenMount) {
       edenMount->getCounterName(CounterName::INODEMAP_LOADED));
   counters->unregisterCallback(
       edenMount->getCounterName(CounterName::INODEMAP_UNLOADED));
+  counters->unregisterCallback(
+      edenMount->getCounterName(CounterName::INODEMAP_MEMORY));
   counters->unregisterCallback(
       edenMount->getCounterName(CounterName::PERIODIC_INODE_UNLOAD));
   counters->unregisterCallback(
@@ -1449,6 +1635,8 @@ void EdenServer::unregisterStats(EdenMount* edenMount) {
       edenMount->getCounterName(CounterName::JOURNAL_DURATION));
   counters->unregisterCallback(
       edenMount->getCounterName(CounterName::JOURNAL_MAX_FILES_ACCUMULATED));
+  counters->unregisterCallback(
+      edenMount->getCounterName(CounterName::OVERLAY_DATA_SIZE));
 #ifndef _WIN32
   if (edenMount->getFuseChannel()) {
     for (auto metric : RequestMetricsScope::requestMetrics) {
@@ -1556,7 +1744,9 @@ folly::Future<std::shared_ptr<EdenMount>> EdenServer::mount(
       serverState_->getReloadableConfig()->getEdenConfig(),
       initialConfig->getEnableWindowsSymlinks(),
       initialConfig->getCaseSensitive());
-  auto journal = std::make_unique<Journal>(getStats().copy());
+  auto journal = std::make_unique<Journal>(
+      getStats().copy(),
+      initialConfig->getClientDirectory() + "journal-overflow"_pc);
 
   // Create the EdenMount object and insert the mount into the mountPoints_ map.
   auto edenMount = EdenMount::create(
@@ -1577,7 +1767,8 @@ folly::Future<std::shared_ptr<EdenMount>> EdenServer::mount(
       doTakeover ? std::make_optional(optionalTakeover->inodeMap)
                  : std::nullopt,
       doTakeover ? std::make_optional(optionalTakeover->getMountProtocol())
-                 : std::nullopt);
+                 : std::nullopt,
+      doTakeover ? optionalTakeover->mountGeneration : std::nullopt);
 
   // Now actually begin starting the mount point
   return std::move(initFuture)
@@ -1739,12 +1930,15 @@ void EdenServer::mountFinished(
             }));
       })
       .ensure([this, mountPath] {
-        // Erase the EdenMount from our mountPoints_ map
-        const auto mountPoints = mountPoints_->wlock();
-        const auto it = mountPoints->find(mountPath);
-        if (it != mountPoints->end()) {
-          mountPoints->erase(it);
+        {
+          // Erase the EdenMount from our mountPoints_ map
+          const auto mountPoints = mountPoints_->wlock();
+          const auto it = mountPoints->find(mountPath);
+          if (it != mountPoints->end()) {
+            mountPoints->erase(it);
+          }
         }
+        publishMountRoutingTable();
       });
 }
 
@@ -1776,7 +1970,41 @@ EdenServer::MountList EdenServer::getAllMountPoints() const {
   return results;
 }
 
+namespace {
+EdenMountHandle makeUsableMountHandle(const std::shared_ptr<EdenMount>& mount) {
+  if (!mount->isSafeForInodeAccess()) {
+    throw newEdenError(
+        EBUSY,
+        EdenErrorType::POSIX_ERROR,
+        fmt::format(
+            "mount point \"{}\" is still initializing", mount->getPath()));
+  }
+  return {mount, mount->getRootInodeUnchecked()};
+}
+} // namespace
+
 EdenMountHandle EdenServer::getMount(AbsolutePathPiece mountPath) const {
+  const auto table = mountRoutingTable_.load();
+  const auto it = table->find(mountPath.view());
+  if (it == table->end()) {
+    return getMountSlow(mountPath);
+  }
+  return makeUsableMountHandle(it->second);
+}
+
+EdenMountHandle EdenServer::getMountFromThriftPath(
+    const std::string& mountPath) const {
+  const auto table = mountRoutingTable_.load();
+  const auto it = table->find(mountPath);
+  if (it == table->end()) {
+    // The client sent a path spelling we don't index; canonicalize it and
+    // try again.
+    return getMount(absolutePathFromThrift(mountPath));
+  }
+  return makeUsableMountHandle(it->second);
+}
+
+EdenMountHandle EdenServer::getMountSlow(AbsolutePathPiece mountPath) const {
   const auto mountPoints = mountPoints_->rlock();
   const auto it = mountPoints->find(mountPath);
   if (it == mountPoints->end()) {
@@ -1970,6 +2198,27 @@ Future<Unit> EdenServer::createThriftServer() {
       edenConfig->thriftQueueTimeout.getValue()));
   server_->setAllowCheckUnimplementedExtraInterfaces(false);
 
+  if (edenConfig->thriftUsePriorityQueues.getValue()) {
+    // Dispatch requests through one worker pool per priority so that
+    // interactive clients, which declare a QoS class via the standard Thrift
+    // call priority header, do not queue behind bulk daemon traffic.
+    server_->setThreadManagerType(
+        apache::thrift::BaseThriftServer::ThreadManagerType::PRIORITY);
+    auto counters = fb303::ServiceData::get()->getDynamicCounters();
+    for (const auto& entry : kThriftQueuePriorities) {
+      counters->registerCallback(
+          thriftQueuedRequestsCounterName(entry.second),
+          [this, priority = entry.first] {
+            auto threadManager = std::dynamic_pointer_cast<
+                apache::thrift::concurrency::PriorityThreadManager>(
+                server_->getThreadManager());
+            return threadManager
+                ? static_cast<int64_t>(threadManager->pendingTaskCount(priority))
+                : 0;
+          });
+    }
+  }
+
   // Setting this allows us to to only do stopListening() on the stop() call
   // and delay thread-pool join (stop cpu workers + stop workers) untill
   // server object destruction. This specifically matters in the takeover
@@ -2251,11 +2500,18 @@ void EdenServer::refreshBackingStore() {
 }
 
 void EdenServer::manageOverlay() {
+  auto config = serverState_->getEdenConfig();
+  auto softLimit = config->overlaySoftSizeLimit.getValue();
+  auto hardLimit = config->overlayHardSizeLimit.getValue();
+
   const auto mountPoints = mountPoints_->rlock();
   for (const auto& [_, info] : *mountPoints) {
     const auto& mount = info.edenMount;
 
     mount->getOverlay()->maintenance();
+    if (softLimit != 0 || hardLimit != 0) {
+      mount->getOverlay()->checkOverlaySize(softLimit, hardLimit);
+    }
   }
 }
 
@@ -2275,7 +2531,25 @@ ImmediateFuture<uint64_t> EdenServer::garbageCollectWorkingCopy(
 
   auto mountPath = mount.getPath();
   XLOG(DBG1) << "Starting GC for: " << mountPath;
-  return rootInode->invalidateChildrenNotMaterialized(cutoff, context)
+  ImmediateFuture<folly::Unit> dematerializeFuture{folly::unit};
+#ifndef _WIN32
+  if (serverState_->getEdenConfig()->dematerializeUnchangedFiles.getValue()) {
+    // Fold materialized files whose contents still match their source
+    // control blob back to the unmaterialized state first, so the
+    // invalidation pass below can release them too.
+    dematerializeFuture =
+        rootInode->dematerializeUnchangedFiles(context.copy());
+  }
+#endif
+  return std::move(dematerializeFuture)
+      .thenTry([rootInode, cutoff, context = context.copy()](
+                   folly::Try<folly::Unit> dematerializeResult) {
+        if (dematerializeResult.hasException()) {
+          XLOG(WARN) << "error dematerializing unchanged files: "
+                     << dematerializeResult.exception();
+        }
+        return rootInode->invalidateChildrenNotMaterialized(cutoff, context);
+      })
       .ensure([rootInode, lease = std::move(lease)] {
         rootInode->unloadChildrenUnreferencedByFs();
       })
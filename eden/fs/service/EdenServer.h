@@ -23,6 +23,8 @@
 #include <folly/SocketAddress.h>
 #include <folly/Synchronized.h>
 #include <folly/ThreadLocal.h>
+#include <folly/container/F14Map.h>
+#include <folly/experimental/AtomicReadMostlyMainPtr.h>
 #include <folly/futures/SharedPromise.h>
 
 #include "eden/fs/inodes/EdenMountHandle.h"
@@ -205,6 +207,14 @@ class EdenServer : private TakeoverHandler {
   FOLLY_NODISCARD folly::Future<folly::Unit> prepare(
       std::shared_ptr<StartupLogger> logger);
 
+  /**
+   * Returns the logger used during startup, or nullptr if prepare() has not
+   * run (e.g. after recovering from a failed takeover).
+   */
+  std::shared_ptr<StartupLogger> getStartupLogger() const {
+    return startupLogger_;
+  }
+
   /**
    * Run the EdenServer.
    */
@@ -329,6 +339,19 @@ class EdenServer : private TakeoverHandler {
    */
   EdenMountHandle getMount(AbsolutePathPiece mountPath) const;
 
+  /**
+   * Look up an EdenMount by the raw mount path string from a thrift
+   * request.
+   *
+   * This is the thrift hot path: when the client-supplied string matches a
+   * known mount exactly, the mount is resolved with a single lock-free
+   * hash lookup and no path canonicalization.  Non-canonical input falls
+   * back to canonicalizing and calling getMount().
+   *
+   * Throws the same errors as getMount().
+   */
+  EdenMountHandle getMountFromThriftPath(const std::string& mountPath) const;
+
   folly::Future<CheckoutResult> checkOutRevision(
       AbsolutePathPiece mountPath,
       std::string& rootHash,
@@ -531,6 +554,8 @@ class EdenServer : private TakeoverHandler {
   using BackingStoreMap =
       std::unordered_map<BackingStoreKey, std::shared_ptr<BackingStore>>;
   using MountMap = PathMap<EdenMountInfo, AbsolutePath>;
+  using MountRoutingTable =
+      folly::F14FastMap<std::string, std::shared_ptr<EdenMount>>;
   class ThriftServerEventHandler;
 
   // Forbidden copy constructor and assignment operator
@@ -540,17 +565,9 @@ class EdenServer : private TakeoverHandler {
   void startPeriodicTasks();
   void updatePeriodicTaskIntervals(const EdenConfig& config);
 
-  /**
-   * Schedule a call to unloadInodes() to happen after timeout
-   * has expired.
-   * Must be called only from the mainEventBase_ thread.
-   */
-  void scheduleInodeUnload(std::chrono::milliseconds timeout);
-
-  // Perform unloading of inodes based on their last access time
-  // and then schedule another call to unloadInodes() to happen
-  // at the next appropriate interval.  The unload attempt applies to
-  // all mounts.
+  // Unload inodes that have not been accessed recently from all mounts
+  // whose loaded inode count exceeds the configured working-set target.
+  // Scheduled periodically by inodeUnloadTask_.
   void unloadInodes();
 
   FOLLY_NODISCARD folly::Future<folly::Unit> createThriftServer();
@@ -584,6 +601,13 @@ class EdenServer : private TakeoverHandler {
    */
   void saveConfig(const cpptoml::table& root);
 
+  /**
+   * Write the startup timeline recorded by the given logger to
+   * startup_profile.json in the EdenFS state directory.  Failures are logged
+   * and otherwise ignored.
+   */
+  void saveStartupProfile(const StartupLogger& logger);
+
   /**
    * Open local storage engine for caching source control data.
    * Returns whether the config was modified.
@@ -612,6 +636,24 @@ class EdenServer : private TakeoverHandler {
   // This also makes sure we don't have this path mounted already.
   void addToMountPoints(std::shared_ptr<EdenMount> edenMount);
 
+  /**
+   * Rebuild and publish mountRoutingTable_ from mountPoints_.
+   *
+   * Must be called after any change to the set of mount points, and must
+   * not be called while holding the mountPoints_ lock.
+   */
+  void publishMountRoutingTable();
+
+  /**
+   * Resolve a mount against the authoritative mountPoints_ map.
+   *
+   * This is the slow path for getMount(), used when mountRoutingTable_
+   * has no entry for the path: either the path needs the PathMap's
+   * case-sensitivity handling, or the table has not caught up with a
+   * concurrent mount addition yet.
+   */
+  EdenMountHandle getMountSlow(AbsolutePathPiece mountPath) const;
+
   // Registers (or removes) stats callbacks for edenMount.
   // These are here rather than in EdenMount because we need to
   // hold an owning reference to the mount to safely sample stats.
@@ -680,6 +722,20 @@ class EdenServer : private TakeoverHandler {
 
   std::shared_ptr<folly::Synchronized<MountMap>> mountPoints_;
 
+  /**
+   * A read-mostly snapshot of the mount points, keyed by both the
+   * canonical mount path and its thrift string representation.
+   *
+   * This lets the thrift hot path resolve a mount with one lock-free hash
+   * lookup on the client-supplied string, avoiding per-request path
+   * canonicalization and contention on the mountPoints_ lock.  Lookups
+   * here are exact string matches; paths that need the PathMap's
+   * case-sensitivity handling fall back to mountPoints_.  The table is
+   * republished by publishMountRoutingTable() whenever a mount is added
+   * or removed.
+   */
+  folly::AtomicReadMostlyMainPtr<const MountRoutingTable> mountRoutingTable_;
+
 #ifndef _WIN32
   /**
    * A server that waits on a new edenfs process to attempt
@@ -812,6 +868,13 @@ class EdenServer : private TakeoverHandler {
 
   std::shared_ptr<StartupStatusChannel> startupStatusChannel_;
 
+  /**
+   * The logger used during startup.  Retained so that the startup timeline
+   * can be served via the getStartupProfile() thrift call; set in prepare()
+   * before the thrift server starts accepting connections.
+   */
+  std::shared_ptr<StartupLogger> startupLogger_;
+
   PeriodicFnTask<&EdenServer::reloadConfig> reloadConfigTask_{
       this,
       "reload_config"};
@@ -831,6 +894,11 @@ class EdenServer : private TakeoverHandler {
   PeriodicFnTask<&EdenServer::garbageCollectAllMounts> gcTask_{
       this,
       "working_copy_gc"};
+#ifndef _WIN32
+  PeriodicFnTask<&EdenServer::unloadInodes> inodeUnloadTask_{
+      this,
+      "inode_unload"};
+#endif
   PeriodicFnTask<&EdenServer::detectNfsCrawl> detectNfsCrawlTask_{
       this,
       "detect_nfs_crawl"};
@@ -19,9 +19,12 @@
 #include <folly/FileUtil.h>
 #include <folly/Portability.h>
 #include <folly/String.h>
+#include <folly/CancellationToken.h>
+#include <folly/container/EvictingCacheMap.h>
 #include <folly/chrono/Conv.h>
 #include <folly/executors/SerialExecutor.h>
 #include <folly/futures/Future.h>
+#include <folly/hash/Hash.h>
 #include <folly/logging/Logger.h>
 #include <folly/logging/xlog.h>
 #include <folly/stop_watch.h>
@@ -54,6 +57,7 @@
 #include "eden/fs/privhelper/PrivHelper.h"
 #include "eden/fs/prjfs/PrjfsChannel.h"
 #include "eden/fs/service/EdenServer.h"
+#include "eden/fs/service/StartupLogger.h"
 #include "eden/fs/service/ThriftGetObjectImpl.h"
 #include "eden/fs/service/ThriftGlobImpl.h"
 #include "eden/fs/service/ThriftPermissionChecker.h"
@@ -74,6 +78,8 @@
 #include "eden/fs/store/ScmStatusDiffCallback.h"
 #include "eden/fs/store/TreeCache.h"
 #include "eden/fs/store/hg/HgQueuedBackingStore.h"
+#include "eden/fs/telemetry/DurationHistogram.h"
+#include "eden/fs/telemetry/RequestSpanRecorder.h"
 #include "eden/fs/telemetry/SessionInfo.h"
 #include "eden/fs/telemetry/TaskTrace.h"
 #include "eden/fs/telemetry/Tracing.h"
@@ -81,11 +87,14 @@
 #include "eden/fs/utils/Clock.h"
 #include "eden/fs/utils/EdenError.h"
 #include "eden/fs/utils/FaultInjector.h"
+#include "eden/fs/utils/GlobMatcher.h"
+#include "eden/fs/utils/IDGen.h"
 #include "eden/fs/utils/NotImplemented.h"
 #include "eden/fs/utils/ProcUtil.h"
 #include "eden/fs/utils/SourceLocation.h"
 #include "eden/fs/utils/StatTimes.h"
 #include "eden/fs/utils/String.h"
+#include "eden/fs/utils/ThreadSampler.h"
 
 using folly::Future;
 using folly::makeFuture;
@@ -200,10 +209,26 @@ class ThriftFetchContext : public ObjectFetchContext {
     }
   }
 
+  /**
+   * Attach the calling connection's cancellation token, so walks and
+   * queued imports issued for this request are abandoned if the client
+   * goes away. Should only be set for requests whose result is worthless
+   * once the caller has disconnected; background requests deliberately
+   * outlive their caller.
+   */
+  void setCancellationToken(folly::CancellationToken token) {
+    cancellationToken_ = std::move(token);
+  }
+
+  folly::CancellationToken getCancellationToken() const override {
+    return cancellationToken_;
+  }
+
  private:
   OptionalProcessId pid_;
   std::string_view endpoint_;
   std::unordered_map<std::string, std::string> requestInfo_;
+  folly::CancellationToken cancellationToken_;
 };
 
 class PrefetchFetchContext : public ObjectFetchContext {
@@ -553,8 +578,7 @@ EdenMountHandle EdenServiceHandler::lookupMount(
 }
 
 EdenMountHandle EdenServiceHandler::lookupMount(const std::string& mountId) {
-  auto mountPath = absolutePathFromThrift(mountId);
-  return server_->getMount(mountPath);
+  return server_->getMountFromThriftPath(mountId);
 }
 
 std::unique_ptr<apache::thrift::AsyncProcessor>
@@ -1255,6 +1279,8 @@ apache::thrift::ServerStream<TaskEvent> EdenServiceHandler::traceTaskEvents(
         taskEvent.threadId() = event.threadId;
         taskEvent.duration() = event.duration.count();
         taskEvent.start() = event.start.count();
+        taskEvent.onCpuDuration() = event.onCpu.count();
+        taskEvent.runqueueWaitDuration() = event.runqueueWait.count();
         publisher.next(taskEvent);
       });
 
@@ -1498,6 +1524,12 @@ void convertHgImportTraceEventToHgEvent(
     case HgImportTraceEvent::QUEUE:
       te.eventType_ref() = HgEventType::QUEUE;
       break;
+    case HgImportTraceEvent::DEDUP:
+      te.eventType_ref() = HgEventType::DEDUP;
+      break;
+    case HgImportTraceEvent::DEQUEUE:
+      te.eventType_ref() = HgEventType::DEQUEUE;
+      break;
     case HgImportTraceEvent::START:
       te.eventType_ref() = HgEventType::START;
       break;
@@ -1686,21 +1718,35 @@ class StreamingDiffCallback : public DiffCallback {
   explicit StreamingDiffCallback(
       std::shared_ptr<
           folly::Synchronized<ThriftStreamPublisherOwner<ChangedFileResult>>>
-          publisher)
-      : publisher_{std::move(publisher)} {}
-
-  void ignoredPath(RelativePathPiece, dtype_t) override {}
+          publisher,
+      bool publishIgnored = false,
+      Journal::FileChangeFilter filter = {})
+      : publisher_{std::move(publisher)},
+        publishIgnored_{publishIgnored},
+        filter_{std::move(filter)} {}
+
+  void ignoredPath(RelativePathPiece path, dtype_t type) override {
+    if (publishIgnored_ && matchesFilter(path)) {
+      publishFile(*publisher_, path.view(), ScmFileStatus::IGNORED, type);
+    }
+  }
 
   void addedPath(RelativePathPiece path, dtype_t type) override {
-    publishFile(*publisher_, path.view(), ScmFileStatus::ADDED, type);
+    if (matchesFilter(path)) {
+      publishFile(*publisher_, path.view(), ScmFileStatus::ADDED, type);
+    }
   }
 
   void removedPath(RelativePathPiece path, dtype_t type) override {
-    publishFile(*publisher_, path.view(), ScmFileStatus::REMOVED, type);
+    if (matchesFilter(path)) {
+      publishFile(*publisher_, path.view(), ScmFileStatus::REMOVED, type);
+    }
   }
 
   void modifiedPath(RelativePathPiece path, dtype_t type) override {
-    publishFile(*publisher_, path.view(), ScmFileStatus::MODIFIED, type);
+    if (matchesFilter(path)) {
+      publishFile(*publisher_, path.view(), ScmFileStatus::MODIFIED, type);
+    }
   }
 
   void diffError(RelativePathPiece /*path*/, const folly::exception_wrapper& ew)
@@ -1710,9 +1756,74 @@ class StreamingDiffCallback : public DiffCallback {
   }
 
  private:
+  bool matchesFilter(RelativePathPiece path) const {
+    return !filter_ || filter_(path);
+  }
+
   std::shared_ptr<
       folly::Synchronized<ThriftStreamPublisherOwner<ChangedFileResult>>>
       publisher_;
+  bool publishIgnored_;
+  Journal::FileChangeFilter filter_;
+};
+
+/**
+ * A DiffCallback wrapper that requests cancellation of the diff walk once
+ * roughly `limit` entries have been recorded. The walk only checks for
+ * cancellation at directory granularity, so somewhat more than `limit`
+ * entries may be reported.
+ */
+class LimitedDiffCallback : public DiffCallback {
+ public:
+  LimitedDiffCallback(
+      DiffCallback* inner,
+      uint64_t limit,
+      std::shared_ptr<folly::CancellationSource> cancellationSource)
+      : inner_{inner},
+        remaining_{static_cast<int64_t>(limit)},
+        cancellationSource_{std::move(cancellationSource)} {}
+
+  void ignoredPath(RelativePathPiece path, dtype_t type) override {
+    inner_->ignoredPath(path, type);
+    recordEntry();
+  }
+
+  void addedPath(RelativePathPiece path, dtype_t type) override {
+    inner_->addedPath(path, type);
+    recordEntry();
+  }
+
+  void removedPath(RelativePathPiece path, dtype_t type) override {
+    inner_->removedPath(path, type);
+    recordEntry();
+  }
+
+  void modifiedPath(RelativePathPiece path, dtype_t type) override {
+    inner_->modifiedPath(path, type);
+    recordEntry();
+  }
+
+  void diffError(RelativePathPiece path, const folly::exception_wrapper& ew)
+      override {
+    inner_->diffError(path, ew);
+  }
+
+  bool wasTruncated() const {
+    return truncated_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  void recordEntry() {
+    if (remaining_.fetch_sub(1, std::memory_order_relaxed) == 1) {
+      truncated_.store(true, std::memory_order_relaxed);
+      cancellationSource_->requestCancellation();
+    }
+  }
+
+  DiffCallback* inner_;
+  std::atomic<int64_t> remaining_;
+  std::atomic<bool> truncated_{false};
+  std::shared_ptr<folly::CancellationSource> cancellationSource_;
 };
 
 /**
@@ -1743,15 +1854,20 @@ ImmediateFuture<folly::Unit> diffBetweenRoots(
   return std::move(fut).ensure([diffContext = std::move(diffContext)] {});
 }
 
-} // namespace
-
+/**
+ * Shared implementation of streamChangesSince and streamSelectedChangesSince.
+ *
+ * When a filter is provided it is pushed down into the Journal accumulation
+ * and applied to commit-transition diff output, so the work done and the
+ * bytes serialized are proportional to the number of matching paths rather
+ * than the total number of changes.
+ */
 apache::thrift::ResponseAndServerStream<ChangesSinceResult, ChangedFileResult>
-EdenServiceHandler::streamChangesSince(
-    std::unique_ptr<StreamChangesSinceParams> params) {
-  auto helper = INSTRUMENT_THRIFT_CALL_WITH_STAT(
-      DBG3, &ThriftStats::streamChangesSince, *params->mountPoint_ref());
-  auto mountHandle = lookupMount(params->mountPoint());
-  const auto& fromPosition = *params->fromPosition_ref();
+streamChangesSinceImpl(
+    EdenMountHandle mountHandle,
+    const JournalPosition& fromPosition,
+    Journal::FileChangeFilter filter,
+    std::unique_ptr<ThriftRequestScope> helper) {
   auto& fetchContext = helper->getFetchContext();
 
   // Streaming in Thrift can be done via a Stream Generator, or via a Stream
@@ -1773,7 +1889,7 @@ EdenServiceHandler::streamChangesSince(
   // its limitSequence parameter and we want the changes *since*
   // the provided sequence number.
   auto summed = mountHandle.getJournal().accumulateRange(
-      *fromPosition.sequenceNumber_ref() + 1);
+      *fromPosition.sequenceNumber_ref() + 1, filter);
 
   ChangesSinceResult result;
   if (!summed) {
@@ -1835,7 +1951,8 @@ EdenServiceHandler::streamChangesSince(
   }
 
   if (summed->snapshotTransitions.size() > 1) {
-    auto callback = std::make_shared<StreamingDiffCallback>(sharedPublisher);
+    auto callback = std::make_shared<StreamingDiffCallback>(
+        sharedPublisher, /*publishIgnored=*/false, std::move(filter));
 
     std::vector<ImmediateFuture<folly::Unit>> futures;
     for (auto rootIt = summed->snapshotTransitions.begin();
@@ -1866,7 +1983,7 @@ EdenServiceHandler::streamChangesSince(
     }
 
     folly::futures::detachOn(
-        server_->getServerState()->getThreadPool().get(),
+        mountHandle.getEdenMount().getMountThreadPool(),
         collectAllSafe(std::move(futures))
             // Make sure that the edenMount, callback, helper and
             // cancellationSource lives for the duration of the stream by
@@ -1890,11 +2007,108 @@ EdenServiceHandler::streamChangesSince(
   return {std::move(result), std::move(serverStream)};
 }
 
+} // namespace
+
+apache::thrift::ResponseAndServerStream<ChangesSinceResult, ChangedFileResult>
+EdenServiceHandler::streamChangesSince(
+    std::unique_ptr<StreamChangesSinceParams> params) {
+  auto helper = INSTRUMENT_THRIFT_CALL_WITH_STAT(
+      DBG3, &ThriftStats::streamChangesSince, *params->mountPoint_ref());
+  auto mountHandle = lookupMount(params->mountPoint());
+  return streamChangesSinceImpl(
+      std::move(mountHandle),
+      *params->fromPosition_ref(),
+      Journal::FileChangeFilter{},
+      std::move(helper));
+}
+
 apache::thrift::ResponseAndServerStream<ChangesSinceResult, ChangedFileResult>
 EdenServiceHandler::streamSelectedChangesSince(
-    std::unique_ptr<StreamSelectedChangesSinceParams>) {
-  NOT_IMPLEMENTED();
+    std::unique_ptr<StreamSelectedChangesSinceParams> params) {
+  auto& changesParams = *params->changesParams_ref();
+  auto helper = INSTRUMENT_THRIFT_CALL_WITH_STAT(
+      DBG3,
+      &ThriftStats::streamSelectedChangesSince,
+      *changesParams.mountPoint_ref());
+  auto mountHandle = lookupMount(changesParams.mountPoint());
+
+  auto options = GlobOptions::DEFAULT;
+  if (mountHandle.getEdenMount().getCheckoutConfig()->getCaseSensitive() ==
+      CaseSensitivity::Insensitive) {
+    options |= GlobOptions::CASE_INSENSITIVE;
+  }
+  auto matchers = std::make_shared<std::vector<GlobMatcher>>();
+  for (const auto& glob : *params->filter_ref()->globs_ref()) {
+    auto matcher = GlobMatcher::createCached(glob, options);
+    if (matcher.hasError()) {
+      throw newEdenError(
+          EdenErrorType::ARGUMENT_ERROR,
+          "Invalid glob (",
+          matcher.error(),
+          "): ",
+          glob);
+    }
+    matchers->push_back(std::move(matcher).value());
+  }
+
+  return streamChangesSinceImpl(
+      std::move(mountHandle),
+      *changesParams.fromPosition_ref(),
+      [matchers = std::move(matchers)](RelativePathPiece path) {
+        for (const auto& matcher : *matchers) {
+          if (matcher.match(path.view())) {
+            return true;
+          }
+        }
+        return false;
+      },
+      std::move(helper));
+}
+
+namespace {
+/**
+ * Copies an accumulated journal range into the wire FileDelta format.
+ * Shared by the single-shot and paged changed-files queries.
+ */
+void fillFileDelta(
+    FileDelta& out,
+    const JournalDeltaRange& summed,
+    RootIdCodec& rootIdCodec,
+    uint64_t mountGeneration) {
+  out.toPosition_ref()->sequenceNumber_ref() = summed.toSequence;
+  out.toPosition_ref()->snapshotHash_ref() =
+      rootIdCodec.renderRootId(summed.snapshotTransitions.back());
+  out.toPosition_ref()->mountGeneration_ref() = mountGeneration;
+
+  out.fromPosition_ref()->sequenceNumber_ref() = summed.fromSequence;
+  out.fromPosition_ref()->snapshotHash_ref() =
+      rootIdCodec.renderRootId(summed.snapshotTransitions.front());
+  out.fromPosition_ref()->mountGeneration_ref() = mountGeneration;
+
+  // Watchman polls this on every journal wakeup, so avoid incremental
+  // reallocation while copying the paths out.
+  out.changedPaths_ref()->reserve(summed.changedFilesInOverlay.size());
+  for (const auto& entry : summed.changedFilesInOverlay) {
+    auto& path = entry.first;
+    auto& changeInfo = entry.second;
+    if (changeInfo.isNew()) {
+      out.createdPaths_ref()->emplace_back(path.asString());
+    } else {
+      out.changedPaths_ref()->emplace_back(path.asString());
+    }
+  }
+
+  out.uncleanPaths_ref()->reserve(summed.uncleanPaths.size());
+  for (auto& path : summed.uncleanPaths) {
+    out.uncleanPaths_ref()->emplace_back(path.asString());
+  }
+
+  out.snapshotTransitions_ref()->reserve(summed.snapshotTransitions.size());
+  for (auto& hash : summed.snapshotTransitions) {
+    out.snapshotTransitions_ref()->push_back(rootIdCodec.renderRootId(hash));
+  }
 }
+} // namespace
 
 void EdenServiceHandler::getFilesChangedSince(
     FileDelta& out,
@@ -1929,38 +2143,62 @@ void EdenServiceHandler::getFilesChangedSince(
           "Journal entry range has been truncated.");
     }
 
-    RootIdCodec& rootIdCodec = mountHandle.getObjectStore();
-
-    out.toPosition_ref()->sequenceNumber_ref() = summed->toSequence;
-    out.toPosition_ref()->snapshotHash_ref() =
-        rootIdCodec.renderRootId(summed->snapshotTransitions.back());
-    out.toPosition_ref()->mountGeneration_ref() =
-        mountHandle.getEdenMount().getMountGeneration();
-
-    out.fromPosition_ref()->sequenceNumber_ref() = summed->fromSequence;
-    out.fromPosition_ref()->snapshotHash_ref() =
-        rootIdCodec.renderRootId(summed->snapshotTransitions.front());
-    out.fromPosition_ref()->mountGeneration_ref() =
-        *out.toPosition_ref()->mountGeneration_ref();
-
-    for (const auto& entry : summed->changedFilesInOverlay) {
-      auto& path = entry.first;
-      auto& changeInfo = entry.second;
-      if (changeInfo.isNew()) {
-        out.createdPaths_ref()->emplace_back(path.asString());
-      } else {
-        out.changedPaths_ref()->emplace_back(path.asString());
-      }
-    }
+    fillFileDelta(
+        out,
+        *summed,
+        mountHandle.getObjectStore(),
+        mountHandle.getEdenMount().getMountGeneration());
+  }
+}
 
-    for (auto& path : summed->uncleanPaths) {
-      out.uncleanPaths_ref()->emplace_back(path.asString());
-    }
+void EdenServiceHandler::getFilesChangedSincePage(
+    ChangedSincePage& out,
+    std::unique_ptr<ChangedSincePageParams> params) {
+  auto helper = INSTRUMENT_THRIFT_CALL(DBG3, *params->mountPoint());
+  auto mountHandle = lookupMount(params->mountPoint());
+
+  if (*params->maxDeltas_ref() <= 0) {
+    throw newEdenError(
+        EINVAL, EdenErrorType::ARGUMENT_ERROR, "maxDeltas must be positive");
+  }
+
+  const auto& fromPosition = *params->fromPosition_ref();
+  checkMountGeneration(
+      fromPosition, mountHandle.getEdenMount(), "fromPosition"sv);
+
+  // The +1 is because the core merge stops at the item prior to
+  // its limitSequence parameter and we want the changes *since*
+  // the provided sequence number.
+  auto summed = mountHandle.getJournal().accumulatePage(
+      *fromPosition.sequenceNumber_ref() + 1,
+      static_cast<size_t>(*params->maxDeltas_ref()));
+
+  auto& delta = *out.delta_ref();
+
+  // We set the default toPosition to be where we where if summed is null
+  delta.toPosition_ref()->sequenceNumber_ref() =
+      *fromPosition.sequenceNumber_ref();
+  delta.toPosition_ref()->snapshotHash_ref() = *fromPosition.snapshotHash_ref();
+  delta.toPosition_ref()->mountGeneration_ref() =
+      mountHandle.getEdenMount().getMountGeneration();
+
+  delta.fromPosition_ref() = *delta.toPosition_ref();
+  out.hasMore_ref() = false;
 
-    out.snapshotTransitions_ref()->reserve(summed->snapshotTransitions.size());
-    for (auto& hash : summed->snapshotTransitions) {
-      out.snapshotTransitions_ref()->push_back(rootIdCodec.renderRootId(hash));
+  if (summed) {
+    if (summed->isTruncated) {
+      throw newEdenError(
+          EDOM,
+          EdenErrorType::JOURNAL_TRUNCATED,
+          "Journal entry range has been truncated.");
     }
+
+    fillFileDelta(
+        delta,
+        *summed,
+        mountHandle.getObjectStore(),
+        mountHandle.getEdenMount().getMountGeneration());
+    out.hasMore_ref() = summed->hasMoreDeltas;
   }
 }
 
@@ -2371,7 +2609,15 @@ EdenServiceHandler::getEntryAttributes(
                   &edenMount,
                   &paths,
                   fetchContext = fetchContext.copy(),
-                  reqBitmask](auto&&) mutable {
+                  reqBitmask](auto&&) mutable
+                 -> ImmediateFuture<std::vector<folly::Try<EntryAttributes>>> {
+        if (server_->getServerState()
+                ->getEdenConfig()
+                ->thriftBatchedAttributeLookups.getValue()) {
+          return getEntryAttributesBatched(
+              edenMount, paths, reqBitmask, fetchContext);
+        }
+
         vector<ImmediateFuture<EntryAttributes>> futures;
         for (const auto& path : paths) {
           futures.emplace_back(getEntryAttributesForPath(
@@ -2383,6 +2629,142 @@ EdenServiceHandler::getEntryAttributes(
       });
 }
 
+ImmediateFuture<std::vector<folly::Try<EntryAttributes>>>
+EdenServiceHandler::getEntryAttributesBatched(
+    const EdenMount& edenMount,
+    const std::vector<std::string>& paths,
+    EntryAttributeFlags reqBitmask,
+    const ObjectFetchContextPtr& fetchContext) {
+  // Attribute queries commonly request thousands of files that share parent
+  // directories. Group the paths by parent so each shared prefix is walked
+  // once, instead of walking every path independently from the root.
+  struct PendingEntry {
+    size_t index;
+    RelativePath path;
+  };
+  using IndexedTry = std::pair<size_t, folly::Try<EntryAttributes>>;
+
+  std::map<RelativePath, std::vector<PendingEntry>> groups;
+  std::vector<ImmediateFuture<std::vector<IndexedTry>>> groupFutures;
+
+  auto resolveIndividually = [&](size_t index, const std::string& path) {
+    groupFutures.emplace_back(
+        getEntryAttributesForPath(edenMount, reqBitmask, path, fetchContext)
+            .thenTry([index](folly::Try<EntryAttributes> result) {
+              std::vector<IndexedTry> out;
+              out.emplace_back(index, std::move(result));
+              return out;
+            }));
+  };
+
+  for (size_t index = 0; index < paths.size(); ++index) {
+    const auto& path = paths[index];
+    if (path.empty()) {
+      // Let the single-path resolution produce the error so the reported
+      // message matches the unbatched walk exactly.
+      resolveIndividually(index, path);
+      continue;
+    }
+    try {
+      RelativePath relativePath{path};
+      auto parent = relativePath.dirname().copy();
+      groups[std::move(parent)].push_back(
+          PendingEntry{index, std::move(relativePath)});
+    } catch (const std::exception&) {
+      resolveIndividually(index, path);
+    }
+  }
+
+  for (auto& group : groups) {
+    groupFutures.emplace_back(
+        edenMount.getVirtualInode(group.first, fetchContext)
+            .thenTry([this,
+                      &edenMount,
+                      reqBitmask,
+                      fetchContext = fetchContext.copy(),
+                      entries = std::move(group.second)](
+                         folly::Try<VirtualInode> parentTry) mutable
+                     -> ImmediateFuture<std::vector<IndexedTry>> {
+              std::vector<size_t> indices;
+              std::vector<ImmediateFuture<EntryAttributes>> attrFutures;
+              indices.reserve(entries.size());
+              attrFutures.reserve(entries.size());
+
+              if (parentTry.hasException()) {
+                // The parent walk failed. Resolve each path individually so
+                // the per-path errors match the unbatched walk exactly.
+                for (auto& entry : entries) {
+                  indices.push_back(entry.index);
+                  attrFutures.emplace_back(getEntryAttributesForPath(
+                      edenMount, reqBitmask, entry.path.view(), fetchContext));
+                }
+              } else {
+                auto& parentInode = parentTry.value();
+                for (auto& entry : entries) {
+                  indices.push_back(entry.index);
+                  attrFutures.emplace_back(
+                      parentInode
+                          .getOrFindChild(
+                              entry.path.basename(),
+                              entry.path,
+                              edenMount.getObjectStore(),
+                              fetchContext)
+                          .thenValue([&edenMount,
+                                      reqBitmask,
+                                      path = entry.path.copy(),
+                                      fetchContext = fetchContext.copy()](
+                                         VirtualInode&& virtualInode) {
+                            return virtualInode.getEntryAttributes(
+                                reqBitmask,
+                                path,
+                                edenMount.getObjectStore(),
+                                fetchContext);
+                          }));
+                }
+              }
+
+              return facebook::eden::collectAll(std::move(attrFutures))
+                  .thenValue(
+                      [indices = std::move(indices)](
+                          std::vector<folly::Try<EntryAttributes>>&& tries) {
+                        std::vector<IndexedTry> out;
+                        out.reserve(tries.size());
+                        for (size_t i = 0; i < tries.size(); ++i) {
+                          out.emplace_back(indices[i], std::move(tries[i]));
+                        }
+                        return out;
+                      });
+            }));
+  }
+
+  return facebook::eden::collectAll(std::move(groupFutures))
+      .thenValue(
+          [numPaths = paths.size()](
+              std::vector<folly::Try<std::vector<IndexedTry>>>&& groupTries) {
+            std::vector<folly::Try<EntryAttributes>> results;
+            results.resize(numPaths);
+            for (auto& groupTry : groupTries) {
+              if (groupTry.hasException()) {
+                // Can't recover which indices this group covered; the
+                // uninitialized results are filled in below.
+                continue;
+              }
+              for (auto& indexedTry : groupTry.value()) {
+                results[indexedTry.first] = std::move(indexedTry.second);
+              }
+            }
+            for (auto& result : results) {
+              if (!result.hasValue() && !result.hasException()) {
+                result = folly::Try<EntryAttributes>{newEdenError(
+                    EIO,
+                    EdenErrorType::GENERIC_ERROR,
+                    "failed to resolve entry attributes")};
+              }
+            }
+            return results;
+          });
+}
+
 ImmediateFuture<EntryAttributes> EdenServiceHandler::getEntryAttributesForPath(
     const EdenMount& edenMount,
     EntryAttributeFlags reqBitmask,
@@ -2578,6 +2960,92 @@ EdenServiceHandler::semifuture_getAttributesFromFilesV2(
       .semi();
 }
 
+folly::SemiFuture<std::unique_ptr<GetAttributesFromFilesBatchResult>>
+EdenServiceHandler::semifuture_getAttributesFromFilesBatch(
+    std::unique_ptr<GetAttributesFromFilesBatchParams> params) {
+  auto helper = INSTRUMENT_THRIFT_CALL(
+      DBG3, fmt::format("{} mount requests", params->requests()->size()));
+  auto& fetchContext = helper->getFetchContext();
+
+  // Build a GetAttributesFromFilesResultV2 whose every path reports the
+  // same error, for requests that fail as a whole (unknown mount, sync
+  // failure) without failing the rest of the batch.
+  auto errorResultForPaths = [](const std::vector<std::string>& paths,
+                                const folly::exception_wrapper& ex) {
+    GetAttributesFromFilesResultV2 result;
+    result.res_ref()->reserve(paths.size());
+    for (size_t i = 0; i < paths.size(); ++i) {
+      FileAttributeDataOrErrorV2 pathError;
+      pathError.error_ref() = newEdenError(ex);
+      result.res_ref()->emplace_back(std::move(pathError));
+    }
+    return result;
+  };
+
+  std::vector<ImmediateFuture<GetAttributesFromFilesResultV2>> futures;
+  futures.reserve(params->requests()->size());
+  for (auto& request : *params->requests()) {
+    auto reqBitmask = EntryAttributeFlags::raw(*request.requestedAttributes());
+    std::vector<std::string>& paths = request.paths().value();
+    try {
+      auto mountHandle = lookupMount(request.mountPoint());
+      futures.emplace_back(
+          getEntryAttributes(
+              mountHandle.getEdenMount(),
+              paths,
+              reqBitmask,
+              *request.sync(),
+              fetchContext)
+              .thenTry([reqBitmask, mountHandle, &paths, errorResultForPaths](
+                           folly::Try<std::vector<folly::Try<EntryAttributes>>>
+                               allRes) {
+                if (allRes.hasException()) {
+                  return errorResultForPaths(paths, allRes.exception());
+                }
+                GetAttributesFromFilesResultV2 result;
+                result.res_ref()->reserve(allRes.value().size());
+                size_t index = 0;
+                for (const auto& tryAttributes : allRes.value()) {
+                  result.res_ref()->emplace_back(serializeEntryAttributes(
+                      mountHandle.getObjectStore(),
+                      basename(paths.at(index)),
+                      tryAttributes,
+                      reqBitmask));
+                  ++index;
+                }
+                return result;
+              }));
+    } catch (const std::exception&) {
+      futures.emplace_back(errorResultForPaths(
+          paths, folly::exception_wrapper{std::current_exception()}));
+    }
+  }
+
+  return wrapImmediateFuture(
+             std::move(helper),
+             collectAll(std::move(futures))
+                 .thenValue(
+                     [](std::vector<folly::Try<GetAttributesFromFilesResultV2>>&&
+                            mountResults) {
+                       auto res =
+                           std::make_unique<GetAttributesFromFilesBatchResult>();
+                       res->res_ref()->reserve(mountResults.size());
+                       for (auto& mountResult : mountResults) {
+                         // The per-request futures convert their own
+                         // failures into per-path errors above.
+                         res->res_ref()->emplace_back(
+                             std::move(mountResult.value()));
+                       }
+                       return res;
+                     }))
+      .ensure([params = std::move(params)]() {
+        // keeps the params memory around for the duration of the thrift call,
+        // so that we can safely use the paths by reference to avoid making
+        // copies.
+      })
+      .semi();
+}
+
 folly::SemiFuture<std::unique_ptr<SetPathObjectIdResult>>
 EdenServiceHandler::semifuture_setPathObjectId(
     std::unique_ptr<SetPathObjectIdParams> params) {
@@ -2800,7 +3268,7 @@ EdenServiceHandler::semifuture_ensureMaterialized(
 
   if (background) {
     folly::futures::detachOn(
-        server_->getServerState()->getThreadPool().get(),
+        mountHandle.getEdenMount().getMountThreadPool(),
         std::move(ensureMaterializedFuture));
     return folly::unit;
   } else {
@@ -2812,6 +3280,31 @@ EdenServiceHandler::semifuture_ensureMaterialized(
 #endif
 }
 
+namespace {
+/**
+ * Cache of completed predictiveGlobFiles results, keyed by the checked-out
+ * commit and the prediction profile. Entries record the journal sequence at
+ * which they were computed and are only replayed while the journal has not
+ * moved, so any working copy modification forces a fresh evaluation.
+ */
+struct PredictiveGlobCacheEntry {
+  uint64_t journalSequence;
+  std::shared_ptr<const Glob> glob;
+};
+
+constexpr size_t kPredictiveGlobCacheSize = 32;
+
+folly::Synchronized<
+    folly::EvictingCacheMap<std::string, PredictiveGlobCacheEntry>>&
+predictiveGlobCache() {
+  // Process-lifetime cache; deliberately leaked.
+  static auto* cache = new folly::Synchronized<
+      folly::EvictingCacheMap<std::string, PredictiveGlobCacheEntry>>{
+      std::in_place, kPredictiveGlobCacheSize};
+  return *cache;
+}
+} // namespace
+
 folly::SemiFuture<std::unique_ptr<Glob>>
 EdenServiceHandler::semifuture_predictiveGlobFiles(
     std::unique_ptr<GlobParams> params) {
@@ -2873,6 +3366,40 @@ EdenServiceHandler::semifuture_predictiveGlobFiles(
   auto& fetchContext = helper->getPrefetchFetchContext();
   bool background = *params->background();
 
+  // The prediction inputs change slowly and commit trees are immutable, so
+  // the repeated form of this call can be answered from cache. Requests
+  // that prefetch have fetch side effects and are never cached.
+  std::string cacheKey;
+  uint64_t journalSequence = 0;
+  if (serverState->getEdenConfig()->globUsePredictiveGlobCache.getValue() &&
+      !*params->prefetchFiles_ref() && !*params->suppressFileList_ref() &&
+      !background) {
+    if (auto latest = mountHandle.getJournal().getLatest()) {
+      journalSequence = latest->sequenceID;
+    }
+    cacheKey = fmt::format(
+        "{}|{}|{}|{}|{}|{}|{}|{}|{}|{}{}{}",
+        mountHandle.getEdenMount().getPath().view(),
+        mountHandle.getObjectStore().renderRootId(
+            mountHandle.getEdenMount().getCheckedOutRootId()),
+        user,
+        repo,
+        os,
+        numResults,
+        startTime.value_or(0),
+        endTime.value_or(0),
+        sandcastleAlias.value_or(""),
+        *params->includeDotfiles_ref(),
+        *params->wantDtype_ref(),
+        *params->listOnlyFiles());
+    auto cache = predictiveGlobCache().wlock();
+    auto it = cache->find(cacheKey);
+    if (it != cache->end() &&
+        it->second.journalSequence == journalSequence) {
+      return folly::makeSemiFuture(std::make_unique<Glob>(*it->second.glob));
+    }
+  }
+
   auto future =
       ImmediateFuture{
           usageService_->getTopUsedDirs(
@@ -2890,12 +3417,20 @@ EdenServiceHandler::semifuture_predictiveGlobFiles(
           })
           .thenTry([mountHandle,
                     params = std::move(params),
-                    helper = std::move(helper)](
+                    helper = std::move(helper),
+                    cacheKey = std::move(cacheKey),
+                    journalSequence](
                        folly::Try<std::unique_ptr<Glob>> tryGlob) {
             if (tryGlob.hasException()) {
               auto& ew = tryGlob.exception();
               XLOG(ERR) << "Error fetching predictive file globs: "
                         << folly::exceptionStr(ew);
+            } else if (!cacheKey.empty()) {
+              predictiveGlobCache().wlock()->set(
+                  cacheKey,
+                  PredictiveGlobCacheEntry{
+                      journalSequence,
+                      std::make_shared<const Glob>(**tryGlob)});
             }
             return tryGlob;
           });
@@ -2929,18 +3464,83 @@ EdenServiceHandler::semifuture_globFiles(std::unique_ptr<GlobParams> params) {
 
   auto mountHandle = lookupMount(params->mountPoint());
 
-  auto globFut = std::move(backgroundFuture)
-                     .thenValue([mountHandle,
-                                 serverState = server_->getServerState(),
-                                 globs = std::move(*params->globs()),
-                                 globber = std::move(globber),
-                                 &context](auto&&) mutable {
-                       return globber.glob(
-                           mountHandle.getEdenMountPtr(),
-                           serverState,
-                           std::move(globs),
-                           context);
-                     });
+  auto globFut = [&]() -> ImmediateFuture<std::unique_ptr<Glob>> {
+    auto serverState = server_->getServerState();
+    // Collapse identical concurrent foreground glob queries onto one
+    // in-flight evaluation. Prefetch and background requests are left
+    // alone: prefetches have fetch side effects, and background requests
+    // return before the result is computed anyway.
+    bool collapseDuplicates = !isBackground &&
+        !*params->prefetchFiles_ref() &&
+        serverState->getReloadableConfig()
+            ->getEdenConfig()
+            ->thriftCollapseDuplicateRequests.getValue();
+    uint64_t argsHash = 0;
+    if (collapseDuplicates) {
+      argsHash = folly::hash::hash_combine(
+          *params->includeDotfiles_ref(),
+          *params->wantDtype_ref(),
+          *params->suppressFileList_ref(),
+          *params->listOnlyFiles(),
+          *params->searchRoot_ref(),
+          params->globs_ref()->size());
+      for (const auto& glob : *params->globs_ref()) {
+        argsHash = folly::hash::hash_combine(argsHash, glob);
+      }
+      for (const auto& revision : *params->revisions_ref()) {
+        argsHash = folly::hash::hash_combine(argsHash, revision);
+      }
+    }
+
+    if (!isBackground && !collapseDuplicates) {
+      // A foreground result is worthless once the caller disconnects:
+      // abandon the walk and any queued imports if the client goes away.
+      // Background requests deliberately outlive their caller, and a
+      // collapsed evaluation may be serving other callers.
+      if (auto* requestContext = getRequestContext()) {
+        helper->getThriftFetchContext().setCancellationToken(
+            requestContext->getConnectionContext()->getCancellationToken());
+      }
+    }
+
+    auto compute = [mountHandle,
+                    serverState,
+                    globs = std::move(*params->globs()),
+                    globber = std::move(globber),
+                    fetchContext = context.copy()]() mutable {
+      return globber.glob(
+          mountHandle.getEdenMountPtr(),
+          serverState,
+          std::move(globs),
+          fetchContext);
+    };
+
+    if (collapseDuplicates) {
+      uint64_t journalSequence = 0;
+      if (auto latest = mountHandle.getJournal().getLatest()) {
+        journalSequence = latest->sequenceID;
+      }
+      return globFilesCollapser_
+          .collapse(
+              {mountHandle.getEdenMount().getPath().asString(),
+               "globFiles",
+               argsHash,
+               journalSequence},
+              serverState->getStats(),
+              [compute = std::move(compute)]() mutable {
+                return compute().thenValue([](std::unique_ptr<Glob> glob) {
+                  return std::shared_ptr<Glob>{std::move(glob)};
+                });
+              })
+          .thenValue([](std::shared_ptr<Glob> glob) {
+            return std::make_unique<Glob>(*glob);
+          });
+    }
+
+    return std::move(backgroundFuture)
+        .thenValue(
+            [compute = std::move(compute)](auto&&) mutable { return compute(); });
+  }();
   globFut = std::move(globFut).ensure(
       [mountHandle, helper = std::move(helper), params = std::move(params)] {});
 
@@ -2960,6 +3560,98 @@ EdenServiceHandler::semifuture_globFiles(std::unique_ptr<GlobParams> params) {
   return std::move(globFut).semi().via(serial);
 }
 
+apache::thrift::ServerStream<StreamGlobMatch>
+EdenServiceHandler::streamGlobFiles(std::unique_ptr<GlobParams> params) {
+  TaskTraceBlock block{"EdenServiceHandler::streamGlobFiles"};
+  if (*params->prefetchFiles_ref() || *params->background()) {
+    throw newEdenError(
+        EINVAL,
+        EdenErrorType::ARGUMENT_ERROR,
+        "streamGlobFiles does not support prefetchFiles or background");
+  }
+  ThriftGlobImpl globber{*params};
+  auto helper = INSTRUMENT_THRIFT_CALL(
+      DBG3,
+      *params->mountPoint_ref(),
+      toLogArg(*params->globs_ref()),
+      globber.logString());
+  auto& context = helper->getFetchContext();
+
+  maybeLogExpensiveGlob(
+      *params->globs(),
+      *params->searchRoot_ref(),
+      globber,
+      context,
+      server_->getServerState());
+
+  auto mountHandle = lookupMount(params->mountPoint());
+
+  auto cancellationSource = std::make_shared<folly::CancellationSource>();
+  auto [serverStream, publisher] =
+      apache::thrift::ServerStream<StreamGlobMatch>::createPublisher(
+          [cancellationSource] { cancellationSource->requestCancellation(); });
+  auto sharedPublisher = std::make_shared<
+      folly::Synchronized<ThriftStreamPublisherOwner<StreamGlobMatch>>>(
+      ThriftStreamPublisherOwner{std::move(publisher)});
+
+  bool wantDtype = *params->wantDtype_ref();
+
+  // Evaluate the globs on a background thread so the Thrift client can
+  // interrupt us whenever desired, then publish the matches one at a time
+  // rather than serializing the entire result into a single Glob response.
+  auto globFut =
+      makeNotReadyImmediateFuture()
+          .thenValue([mountHandle,
+                      serverState = server_->getServerState(),
+                      globs = std::move(*params->globs()),
+                      globber = std::move(globber),
+                      fetchContext = context.copy()](auto&&) mutable {
+            return globber.glob(
+                mountHandle.getEdenMountPtr(),
+                serverState,
+                std::move(globs),
+                fetchContext);
+          })
+          .thenValue([sharedPublisher,
+                      wantDtype,
+                      token = cancellationSource->getToken()](
+                         std::unique_ptr<Glob> glob) {
+            auto numMatches = glob->matchingFiles_ref()->size();
+            for (size_t i = 0; i < numMatches; ++i) {
+              if (token.isCancellationRequested()) {
+                break;
+              }
+              StreamGlobMatch match;
+              match.name() = std::move((*glob->matchingFiles_ref())[i]);
+              if (wantDtype) {
+                match.dtype() = (*glob->dtypes_ref())[i];
+              }
+              match.originHash() = std::move((*glob->originHashes_ref())[i]);
+              sharedPublisher->rlock()->next(std::move(match));
+            }
+          })
+          .thenTry([sharedPublisher,
+                    mountHandle,
+                    helper = std::move(helper),
+                    cancellationSource,
+                    params = std::move(params)](
+                       folly::Try<folly::Unit> result) mutable {
+            if (result.hasException()) {
+              auto publisher = std::move(*sharedPublisher->wlock());
+              std::move(publisher).next(
+                  newEdenError(std::move(result).exception()));
+            }
+            // Destroying the last reference to the publisher completes the
+            // stream.
+          });
+
+  folly::futures::detachOn(
+      mountHandle.getEdenMount().getMountThreadPool(),
+      std::move(globFut).semi());
+
+  return std::move(serverStream);
+}
+
 folly::SemiFuture<folly::Unit> EdenServiceHandler::semifuture_prefetchFiles(
     std::unique_ptr<PrefetchParams> params) {
   ThriftGlobImpl globber{*params};
@@ -3008,15 +3700,143 @@ folly::SemiFuture<folly::Unit> EdenServiceHandler::semifuture_prefetchFiles(
       .semi();
 }
 
-folly::SemiFuture<struct folly::Unit> EdenServiceHandler::semifuture_chown(
-    FOLLY_MAYBE_UNUSED std::unique_ptr<std::string> mountPoint,
-    FOLLY_MAYBE_UNUSED int32_t uid,
-    FOLLY_MAYBE_UNUSED int32_t gid) {
-#ifndef _WIN32
-  auto handle = lookupMount(mountPoint);
-  return handle.getEdenMount().chown(uid, gid).ensure([handle] {}).semi();
-#else
-  NOT_IMPLEMENTED();
+namespace {
+// Upper bound on remembered prefetch sessions; finished sessions beyond
+// this are garbage collected by the next startPrefetch() call.
+constexpr size_t kMaxPrefetchSessions = 1024;
+} // namespace
+
+void EdenServiceHandler::startPrefetch(
+    StartPrefetchResult& result,
+    std::unique_ptr<PrefetchParams> params) {
+  ThriftGlobImpl globber{*params};
+  auto helper = INSTRUMENT_THRIFT_CALL(
+      DBG2,
+      *params->mountPoint_ref(),
+      toLogArg(*params->globs_ref()),
+      globber.logString());
+
+  maybeLogExpensiveGlob(
+      *params->globs(),
+      *params->searchRoot_ref(),
+      globber,
+      helper->getFetchContext(),
+      server_->getServerState());
+
+  auto mountHandle = lookupMount(params->mountPoint());
+
+  auto session = std::make_shared<PrefetchSession>();
+  session->progress = std::make_shared<PrefetchProgressState>();
+  globber.setManagedPrefetch(
+      session->progress, session->cancellationSource.getToken());
+
+  auto prefetchId = static_cast<int64_t>(generateUniqueID());
+  {
+    auto sessions = prefetchSessions_.wlock();
+    // Finished sessions are kept so progress stays queryable, but garbage
+    // collect them once the map grows large.
+    if (sessions->size() >= kMaxPrefetchSessions) {
+      for (auto it = sessions->begin(); it != sessions->end();) {
+        if (it->second->state.load() != PrefetchState::RUNNING) {
+          it = sessions->erase(it);
+        } else {
+          ++it;
+        }
+      }
+    }
+    sessions->emplace(prefetchId, session);
+  }
+
+  auto future =
+      makeNotReadyImmediateFuture()
+          .thenValue([mountHandle,
+                      serverState = server_->getServerState(),
+                      globs = std::move(*params->globs()),
+                      globber = std::move(globber),
+                      context = helper->getPrefetchFetchContext().copy()](
+                         auto&&) mutable {
+            return globber.glob(
+                mountHandle.getEdenMountPtr(),
+                serverState,
+                std::move(globs),
+                context);
+          })
+          .ensure([mountHandle] {})
+          .thenTry([session,
+                    helper = std::move(helper),
+                    params = std::move(params)](
+                       folly::Try<std::unique_ptr<Glob>> tryGlob) {
+            if (tryGlob.hasException()) {
+              if (session->cancellationSource.isCancellationRequested()) {
+                session->state.store(PrefetchState::CANCELLED);
+              } else {
+                *session->error.wlock() =
+                    folly::exceptionStr(tryGlob.exception()).toStdString();
+                session->state.store(PrefetchState::FAILED);
+              }
+            } else {
+              session->state.store(PrefetchState::COMPLETE);
+            }
+          });
+
+  folly::futures::detachOn(
+      mountHandle.getEdenMount().getMountThreadPool(),
+      std::move(future).semi());
+
+  result.prefetchId_ref() = prefetchId;
+}
+
+void EdenServiceHandler::getPrefetchProgress(
+    PrefetchProgress& result,
+    int64_t prefetchId) {
+  auto helper = INSTRUMENT_THRIFT_CALL(DBG3);
+  auto sessions = prefetchSessions_.rlock();
+  auto it = sessions->find(prefetchId);
+  if (it == sessions->end()) {
+    throw newEdenError(
+        ENOENT,
+        EdenErrorType::ARGUMENT_ERROR,
+        "unknown prefetch id: ",
+        prefetchId);
+  }
+  const auto& session = it->second;
+  result.state_ref() = session->state.load();
+  result.totalBlobs_ref() = static_cast<int64_t>(
+      session->progress->totalBlobs.load(std::memory_order_relaxed));
+  result.fetchedBlobs_ref() = static_cast<int64_t>(
+      session->progress->fetchedBlobs.load(std::memory_order_relaxed));
+  auto error = session->error.rlock();
+  if (!error->empty()) {
+    result.error_ref() = *error;
+  }
+}
+
+void EdenServiceHandler::cancelPrefetch(int64_t prefetchId) {
+  auto helper = INSTRUMENT_THRIFT_CALL(DBG2);
+  auto sessions = prefetchSessions_.rlock();
+  auto it = sessions->find(prefetchId);
+  if (it == sessions->end()) {
+    throw newEdenError(
+        ENOENT,
+        EdenErrorType::ARGUMENT_ERROR,
+        "unknown prefetch id: ",
+        prefetchId);
+  }
+  // The running prefetch notices the cancellation at the next batch
+  // boundary and records the CANCELLED state itself. Cancelling a prefetch
+  // that already finished is a no-op.
+  it->second->cancellationSource.requestCancellation();
+}
+
+folly::SemiFuture<struct folly::Unit> EdenServiceHandler::semifuture_chown(
+    FOLLY_MAYBE_UNUSED std::unique_ptr<std::string> mountPoint,
+    FOLLY_MAYBE_UNUSED int32_t uid,
+    FOLLY_MAYBE_UNUSED int32_t gid) {
+#ifndef _WIN32
+  auto handle = lookupMount(mountPoint);
+  return handle.getEdenMount().chown(uid, gid).ensure([handle] {}).semi();
+#else
+  NOT_IMPLEMENTED();
 #endif // !_WIN32
 }
 
@@ -3068,26 +3888,316 @@ EdenServiceHandler::semifuture_getScmStatusV2(
                                    ->getReloadableConfig()
                                    ->getEdenConfig()
                                    ->enforceParents.getValue();
+
+  if (params->resultLimit_ref().has_value() && *params->resultLimit_ref() > 0) {
+    // A result limit was requested: run the diff with a callback that
+    // cancels the rest of the walk once the limit is reached. The resulting
+    // partial status bypasses the status cache maintained by the plain
+    // EdenMount::diff.
+    auto cancellationSource = std::make_shared<folly::CancellationSource>();
+    auto token = folly::CancellationToken::merge(
+        context->getConnectionContext()->getCancellationToken(),
+        cancellationSource->getToken());
+    auto statusCallback = std::make_unique<ScmStatusDiffCallback>();
+    auto limitedCallback = std::make_unique<LimitedDiffCallback>(
+        statusCallback.get(),
+        static_cast<uint64_t>(*params->resultLimit_ref()),
+        std::move(cancellationSource));
+    auto* callbackPtr = limitedCallback.get();
+
+    return wrapImmediateFuture(
+               std::move(helper),
+               mountHandle.getEdenMount()
+                   .diff(
+                       mountHandle.getRootInode(),
+                       callbackPtr,
+                       rootId,
+                       *params->listIgnored_ref(),
+                       enforceParents,
+                       std::move(token),
+                       fetchContext)
+                   .ensure([mountHandle] {})
+                   .thenValue([this,
+                               statusCallback = std::move(statusCallback),
+                               limitedCallback = std::move(limitedCallback)](
+                                  auto&&) {
+                     auto result = std::make_unique<GetScmStatusResult>();
+                     result->status_ref() = statusCallback->extractStatus();
+                     result->version_ref() = server_->getVersion();
+                     if (limitedCallback->wasTruncated()) {
+                       result->truncated_ref() = true;
+                     }
+                     return result;
+                   }))
+        .semi();
+  }
+
+  auto listIgnored = *params->listIgnored_ref();
+  auto compute = [mountHandle,
+                  rootId,
+                  token = context->getConnectionContext()->getCancellationToken(),
+                  fetchContext = fetchContext.copy(),
+                  listIgnored,
+                  enforceParents]() {
+    return mountHandle.getEdenMount()
+        .diff(
+            mountHandle.getRootInode(),
+            rootId,
+            token,
+            fetchContext,
+            listIgnored,
+            enforceParents)
+        .ensure([mountHandle] {})
+        .thenValue([](std::unique_ptr<ScmStatus>&& status) {
+          return std::shared_ptr<ScmStatus>{std::move(status)};
+        });
+  };
+
+  auto statusFuture = [&]() -> ImmediateFuture<std::shared_ptr<ScmStatus>> {
+    if (!server_->getServerState()
+             ->getReloadableConfig()
+             ->getEdenConfig()
+             ->thriftCollapseDuplicateRequests.getValue()) {
+      return compute();
+    }
+    // Tools routinely race identical status queries against the same mount.
+    // Attach this caller to any in-flight computation of the same status
+    // rather than walking the tree again. The key includes the journal
+    // sequence so requests racing with working copy writes never share a
+    // result across a modification. Note that a collapsed caller rides the
+    // first caller's cancellation token.
+    uint64_t journalSequence = 0;
+    if (auto latest = mountHandle.getJournal().getLatest()) {
+      journalSequence = latest->sequenceID;
+    }
+    return scmStatusCollapser_.collapse(
+        {mountHandle.getEdenMount().getPath().asString(),
+         "getScmStatusV2",
+         folly::hash::hash_combine(parsedCommit, listIgnored, enforceParents),
+         journalSequence},
+        server_->getServerState()->getStats(),
+        std::move(compute));
+  }();
+
   return wrapImmediateFuture(
              std::move(helper),
-             mountHandle.getEdenMount()
-                 .diff(
-                     mountHandle.getRootInode(),
-                     rootId,
-                     context->getConnectionContext()->getCancellationToken(),
-                     fetchContext,
-                     *params->listIgnored_ref(),
-                     enforceParents)
-                 .ensure([mountHandle] {})
-                 .thenValue([this](std::unique_ptr<ScmStatus>&& status) {
+             std::move(statusFuture)
+                 .thenValue([this](std::shared_ptr<ScmStatus> status) {
                    auto result = std::make_unique<GetScmStatusResult>();
-                   result->status_ref() = std::move(*status);
+                   result->status_ref() = *status;
                    result->version_ref() = server_->getVersion();
                    return result;
                  }))
       .semi();
 }
 
+apache::thrift::ResponseAndServerStream<StreamScmStatusResult, ChangedFileResult>
+EdenServiceHandler::streamScmStatusV2(
+    std::unique_ptr<GetScmStatusParams> params) {
+  auto rootIdOptions = params->rootIdOptions_ref().ensure();
+  auto helper = INSTRUMENT_THRIFT_CALL(
+      DBG3,
+      *params->mountPoint_ref(),
+      folly::to<string>("commitHash=", logHash(*params->commit_ref())),
+      folly::to<string>("listIgnored=", *params->listIgnored_ref()));
+  helper->getThriftFetchContext().fillClientRequestInfo(params->cri_ref());
+  auto& fetchContext = helper->getFetchContext();
+  auto mountHandle = lookupMount(params->mountPoint());
+
+  std::string parsedCommit = resolveRootId(
+      std::move(*params->commit_ref()), rootIdOptions, mountHandle);
+  auto rootId = mountHandle.getObjectStore().parseRootId(parsedCommit);
+
+  const auto& enforceParents = server_->getServerState()
+                                   ->getReloadableConfig()
+                                   ->getEdenConfig()
+                                   ->enforceParents.getValue();
+
+  auto cancellationSource = std::make_shared<folly::CancellationSource>();
+  auto [serverStream, publisher] =
+      apache::thrift::ServerStream<ChangedFileResult>::createPublisher(
+          [cancellationSource] { cancellationSource->requestCancellation(); });
+  auto sharedPublisher = std::make_shared<
+      folly::Synchronized<ThriftStreamPublisherOwner<ChangedFileResult>>>(
+      ThriftStreamPublisherOwner{std::move(publisher)});
+  auto callback = std::make_shared<StreamingDiffCallback>(
+      sharedPublisher, /*publishIgnored=*/*params->listIgnored_ref());
+
+  // Run the diff on a background thread so the Thrift client can close the
+  // stream - which cancels the rest of the walk - whenever desired.
+  auto future =
+      makeNotReadyImmediateFuture()
+          .thenValue([mountHandle,
+                      rootId,
+                      listIgnored = *params->listIgnored_ref(),
+                      enforceParents,
+                      token = cancellationSource->getToken(),
+                      fetchContext = fetchContext.copy(),
+                      callback](auto&&) {
+            return mountHandle.getEdenMount().diff(
+                mountHandle.getRootInode(),
+                callback.get(),
+                rootId,
+                listIgnored,
+                enforceParents,
+                token,
+                fetchContext);
+          })
+          .thenTry([mountHandle,
+                    sharedPublisher,
+                    callback,
+                    helper = std::move(helper),
+                    cancellationSource,
+                    params = std::move(params)](
+                       folly::Try<folly::Unit> result) mutable {
+            if (result.hasException()) {
+              auto publisher = std::move(*sharedPublisher->wlock());
+              std::move(publisher).next(
+                  newEdenError(std::move(result).exception()));
+            }
+            // Destroying the last reference to the publisher completes the
+            // stream.
+          });
+
+  folly::futures::detachOn(
+      mountHandle.getEdenMount().getMountThreadPool(),
+      std::move(future).semi());
+
+  StreamScmStatusResult result;
+  result.version() = server_->getVersion();
+  return {std::move(result), std::move(serverStream)};
+}
+
+apache::thrift::ServerStream<UnmountBatchResult>
+EdenServiceHandler::streamUnmountBatch(
+    std::unique_ptr<UnmountBatchParams> params) {
+  auto helper = INSTRUMENT_THRIFT_CALL(INFO, toLogArg(*params->mountPoints()));
+
+  std::vector<AbsolutePath> mountPaths;
+  if (params->mountPoints()->empty()) {
+    for (const auto& edenMount : server_->getAllMountPoints()) {
+      mountPaths.push_back(edenMount->getPath());
+    }
+  } else {
+    for (const auto& mountPoint : *params->mountPoints()) {
+      mountPaths.push_back(absolutePathFromThrift(mountPoint));
+    }
+  }
+
+  auto [serverStream, publisher] =
+      apache::thrift::ServerStream<UnmountBatchResult>::createPublisher([] {
+        // Unmounts already in flight are not cancelable; let them finish.
+      });
+  auto sharedPublisher = std::make_shared<
+      folly::Synchronized<ThriftStreamPublisherOwner<UnmountBatchResult>>>(
+      ThriftStreamPublisherOwner{std::move(publisher)});
+
+  // Run the unmounts in parallel and publish each mount's outcome as it
+  // completes. A failed unmount is reported in its result rather than
+  // terminating the stream, so one wedged mount does not hide the others.
+  std::vector<ImmediateFuture<folly::Unit>> futures;
+  futures.reserve(mountPaths.size());
+  for (const auto& mountPath : mountPaths) {
+    futures.push_back(
+        makeImmediateFutureWith(
+            [&]() { return ImmediateFuture{server_->unmount(mountPath)}; })
+            .thenTry([sharedPublisher,
+                      mountPath](folly::Try<folly::Unit> result) {
+              UnmountBatchResult outcome;
+              outcome.mountPoint() = absolutePathToThrift(mountPath);
+              if (result.hasException()) {
+                outcome.error() = newEdenError(std::move(result).exception());
+              }
+              sharedPublisher->rlock()->next(std::move(outcome));
+            }));
+  }
+
+  folly::futures::detachOn(
+      server_->getServerState()->getThreadPool().get(),
+      facebook::eden::collectAll(std::move(futures))
+          .thenTry([sharedPublisher, helper = std::move(helper)](auto&&) {
+            // Destroying the last reference to the publisher completes the
+            // stream.
+          })
+          .semi());
+  return std::move(serverStream);
+}
+
+apache::thrift::ServerStream<ScmStatusBatchResult>
+EdenServiceHandler::streamScmStatusForMounts(
+    std::unique_ptr<ScmStatusBatchParams> params) {
+  auto helper = INSTRUMENT_THRIFT_CALL(
+      DBG2,
+      toLogArg(*params->mountPoints()),
+      folly::to<string>("listIgnored=", *params->listIgnored()));
+  auto& fetchContext = helper->getFetchContext();
+
+  std::vector<std::string> mountPoints = *params->mountPoints();
+  if (mountPoints.empty()) {
+    for (const auto& edenMount : server_->getAllMountPoints()) {
+      mountPoints.push_back(absolutePathToThrift(edenMount->getPath()));
+    }
+  }
+
+  auto cancellationSource = std::make_shared<folly::CancellationSource>();
+  auto [serverStream, publisher] =
+      apache::thrift::ServerStream<ScmStatusBatchResult>::createPublisher(
+          [cancellationSource] { cancellationSource->requestCancellation(); });
+  auto sharedPublisher = std::make_shared<
+      folly::Synchronized<ThriftStreamPublisherOwner<ScmStatusBatchResult>>>(
+      ThriftStreamPublisherOwner{std::move(publisher)});
+
+  auto listIgnored = *params->listIgnored();
+
+  // Diff every requested mount in parallel and publish each mount's status
+  // as its walk finishes. Each mount is diffed against its own working copy
+  // parent; per-mount failures (including unknown mount points) are
+  // reported in the result rather than terminating the stream.
+  std::vector<ImmediateFuture<folly::Unit>> futures;
+  futures.reserve(mountPoints.size());
+  for (auto& mountPoint : mountPoints) {
+    auto statusFuture = makeImmediateFutureWith(
+        [&]() -> ImmediateFuture<std::unique_ptr<ScmStatus>> {
+          auto mountHandle = lookupMount(mountPoint);
+          auto rootId = mountHandle.getEdenMount().getWorkingCopyParent();
+          return mountHandle.getEdenMount()
+              .diff(
+                  mountHandle.getRootInode(),
+                  rootId,
+                  cancellationSource->getToken(),
+                  fetchContext.copy(),
+                  listIgnored,
+                  /*enforceCurrentParent=*/false)
+              .ensure([mountHandle] {});
+        });
+    futures.push_back(
+        std::move(statusFuture)
+            .thenTry([sharedPublisher, mountPoint = std::move(mountPoint)](
+                         folly::Try<std::unique_ptr<ScmStatus>> result) {
+              ScmStatusBatchResult outcome;
+              outcome.mountPoint() = mountPoint;
+              if (result.hasException()) {
+                outcome.error() = newEdenError(std::move(result).exception());
+              } else {
+                outcome.status() = std::move(*result.value());
+              }
+              sharedPublisher->rlock()->next(std::move(outcome));
+            }));
+  }
+
+  folly::futures::detachOn(
+      server_->getServerState()->getThreadPool().get(),
+      facebook::eden::collectAll(std::move(futures))
+          .thenTry([sharedPublisher,
+                    helper = std::move(helper),
+                    cancellationSource](auto&&) {
+            // Destroying the last reference to the publisher completes the
+            // stream.
+          })
+          .semi());
+  return std::move(serverStream);
+}
+
 folly::SemiFuture<std::unique_ptr<ScmStatus>>
 EdenServiceHandler::semifuture_getScmStatus(
     unique_ptr<string> mountPoint,
@@ -3733,6 +4843,62 @@ void EdenServiceHandler::debugListActivityRecordings(
   result.recordings_ref() = recordings;
 }
 
+void EdenServiceHandler::debugSetSamplingProfilerEnabled(bool enabled) {
+  auto helper = INSTRUMENT_THRIFT_CALL(DBG2, enabled);
+  if (enabled) {
+    auto config = server_->getServerState()->getEdenConfig();
+    ThreadSampler::get().start(
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            config->profilerSampleInterval.getValue()));
+  } else {
+    ThreadSampler::get().stop();
+  }
+}
+
+void EdenServiceHandler::debugGetStackSamples(
+    DebugGetStackSamplesResult& result,
+    int64_t lookbackSeconds) {
+  auto helper = INSTRUMENT_THRIFT_CALL(DBG3, lookbackSeconds);
+  auto since = lookbackSeconds > 0
+      ? std::chrono::system_clock::now() - std::chrono::seconds(lookbackSeconds)
+      : std::chrono::system_clock::time_point{};
+  for (auto& sample : ThreadSampler::get().getSamples(since)) {
+    ProfilerStackSample thriftSample;
+    thriftSample.timestampUs_ref() =
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            sample.timestamp.time_since_epoch())
+            .count();
+    thriftSample.threadName_ref() = std::move(sample.threadName);
+    thriftSample.frames_ref() = std::move(sample.frames);
+    result.samples_ref()->push_back(std::move(thriftSample));
+  }
+}
+
+void EdenServiceHandler::debugGetSlowRequestTraces(
+    DebugGetSlowRequestTracesResult& result) {
+  auto helper = INSTRUMENT_THRIFT_CALL(DBG3);
+  for (auto& trace : SlowRequestTraceBuffer::get().getTraces()) {
+    SlowRequestTrace thriftTrace;
+    thriftTrace.completedAtUs_ref() =
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            trace.completedAt.time_since_epoch())
+            .count();
+    thriftTrace.opName_ref() = std::move(trace.opName);
+    thriftTrace.durationUs_ref() =
+        std::chrono::duration_cast<std::chrono::microseconds>(trace.duration)
+            .count();
+    for (auto& stage : trace.stages) {
+      RequestTraceStage thriftStage;
+      thriftStage.name_ref() = std::move(stage.name);
+      thriftStage.offsetUs_ref() =
+          std::chrono::duration_cast<std::chrono::microseconds>(stage.offset)
+              .count();
+      thriftTrace.stages_ref()->push_back(std::move(thriftStage));
+    }
+    result.traces_ref()->push_back(std::move(thriftTrace));
+  }
+}
+
 void EdenServiceHandler::debugGetInodePath(
     InodePathDebugInfo& info,
     std::unique_ptr<std::string> mountPoint,
@@ -3828,6 +4994,218 @@ void EdenServiceHandler::getAccessCounts(
   }
 }
 
+namespace {
+
+FsLatencyHistogram thriftHistogram(const DurationHistogram& histogram) {
+  FsLatencyHistogram result;
+  auto counts = histogram.snapshot();
+  result.bucketCounts_ref() =
+      std::vector<int64_t>{counts.begin(), counts.end()};
+  return result;
+}
+
+} // namespace
+
+void EdenServiceHandler::getFsLatencyHistograms(
+    GetFsLatencyHistogramsResult& result) {
+  auto helper = INSTRUMENT_THRIFT_CALL(DBG4);
+
+  for (auto& handle : server_->getMountPoints()) {
+    auto& mount = handle.getEdenMount();
+    auto* channel = mount.getFsChannel();
+    if (!channel) {
+      continue;
+    }
+    auto* histograms = channel->getLatencyHistograms();
+    if (!histograms) {
+      continue;
+    }
+    MountFsLatencyHistograms& mountHistograms =
+        result.histogramsByMount_ref()[mount.getPath().value()];
+    mountHistograms.read_ref() = thriftHistogram(histograms->read);
+    mountHistograms.write_ref() = thriftHistogram(histograms->write);
+    mountHistograms.other_ref() = thriftHistogram(histograms->other);
+  }
+}
+
+void EdenServiceHandler::getCacheStats(GetCacheStatsResult& result) {
+  auto helper = INSTRUMENT_THRIFT_CALL(DBG4);
+
+  auto fillCacheStats = [](CacheStats& thriftStats, const auto& stats) {
+    thriftStats.entryCount_ref() = stats.objectCount;
+    thriftStats.totalSizeInBytes_ref() = stats.totalSizeInBytes;
+    thriftStats.hitCount_ref() = stats.hitCount;
+    thriftStats.missCount_ref() = stats.missCount;
+    thriftStats.evictionCount_ref() = stats.evictionCount;
+    thriftStats.dropCount_ref() = stats.dropCount;
+    thriftStats.reuseDistanceBuckets_ref() = std::vector<int64_t>{
+        stats.reuseDistanceBuckets.begin(), stats.reuseDistanceBuckets.end()};
+    thriftStats.insertsByInterest_ref() = std::vector<int64_t>{
+        stats.insertsByInterest.begin(), stats.insertsByInterest.end()};
+    thriftStats.unusedEvictionsByInterest_ref() = std::vector<int64_t>{
+        stats.unusedEvictionsByInterest.begin(),
+        stats.unusedEvictionsByInterest.end()};
+    thriftStats.speculativeBypassCount_ref() = stats.speculativeBypassCount;
+  };
+
+  fillCacheStats(
+      *result.blobCacheStats_ref(), server_->getBlobCache()->getStats());
+  fillCacheStats(
+      *result.treeCacheStats_ref(), server_->getTreeCache()->getStats());
+
+  for (auto& [key, value] : fb303::ServiceData::get()->getCounters()) {
+    if (folly::StringPiece{key}.startsWith("local_store.")) {
+      result.localStoreCounters_ref()[key] = value;
+    }
+  }
+}
+
+void EdenServiceHandler::getMemoryBreakdown(GetMemoryBreakdownResult& result) {
+  auto helper = INSTRUMENT_THRIFT_CALL(DBG4);
+
+  for (auto& handle : server_->getMountPoints()) {
+    auto& mount = handle.getEdenMount();
+    MountMemoryBreakdown breakdown;
+    breakdown.inodeMapBytes_ref() =
+        mount.getInodeMap()->estimateMemoryUsage();
+    breakdown.journalBytes_ref() = mount.getJournal().estimateMemoryUsage();
+    result.mounts_ref()[absolutePathToThrift(mount.getPath())] =
+        std::move(breakdown);
+  }
+
+  result.blobCacheBytes_ref() =
+      server_->getBlobCache()->getStats().totalSizeInBytes;
+  result.treeCacheBytes_ref() =
+      server_->getTreeCache()->getStats().totalSizeInBytes;
+
+  if (auto privateBytes = proc_util::calculatePrivateBytes()) {
+    result.processPrivateBytes_ref() = privateBytes.value();
+  }
+}
+
+namespace {
+
+void addAccessCounts(AccessCounts& into, const AccessCounts& from) {
+  *into.fsChannelTotal_ref() += *from.fsChannelTotal_ref();
+  *into.fsChannelReads_ref() += *from.fsChannelReads_ref();
+  *into.fsChannelWrites_ref() += *from.fsChannelWrites_ref();
+  *into.fsChannelBackingStoreImports_ref() +=
+      *from.fsChannelBackingStoreImports_ref();
+  *into.fsChannelDurationNs_ref() += *from.fsChannelDurationNs_ref();
+  *into.fsChannelMemoryCacheImports_ref() +=
+      *from.fsChannelMemoryCacheImports_ref();
+  *into.fsChannelDiskCacheImports_ref() += *from.fsChannelDiskCacheImports_ref();
+}
+
+} // namespace
+
+AccessRateSnapshot EdenServiceHandler::computeAccessRateSnapshot(
+    std::chrono::seconds window) {
+  AccessRateSnapshot snapshot;
+  snapshot.timestampUs_ref() =
+      std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::system_clock::now().time_since_epoch())
+          .count();
+  snapshot.windowSeconds_ref() = window.count();
+  snapshot.cmdsByPid_ref() =
+      server_->getServerState()->getProcessInfoCache()->getAllProcessNames();
+
+  // Parent lookups hit /proc, so cache them across mounts within a snapshot.
+  std::unordered_map<pid_t, pid_t> parents;
+  auto lookupParent = [&](pid_t pid) -> pid_t {
+    auto it = parents.find(pid);
+    if (it != parents.end()) {
+      return it->second;
+    }
+    auto ppid = proc_util::getParentProcessId(pid).value_or(0);
+    parents.emplace(pid, ppid);
+    return ppid;
+  };
+
+  for (auto& handle : server_->getMountPoints()) {
+    auto& mount = handle.getEdenMount();
+    auto& mountStr = mount.getPath().value();
+    auto counts = mount.getProcessAccessLog().getAccessCounts(window);
+
+    std::unordered_map<pid_t, AttributedAccesses> entries;
+    // Seed an entry with each accessing process's own counts.
+    for (auto& [pid, accessCounts] : counts) {
+      auto& entry = entries[pid];
+      entry.pid_ref() = pid;
+      entry.own_ref() = accessCounts;
+    }
+    // Roll each process's own counts up its ancestor chain, creating
+    // zero-own entries for ancestors that issued no accesses themselves.
+    for (auto& [pid, accessCounts] : counts) {
+      pid_t current = pid;
+      // Bound the walk to defend against ppid cycles caused by pid reuse.
+      for (int depth = 0; depth < 64; ++depth) {
+        auto& entry = entries[current];
+        entry.pid_ref() = current;
+        addAccessCounts(*entry.rollup_ref(), accessCounts);
+        auto parent = lookupParent(current);
+        entry.parentPid_ref() = parent;
+        // Stop before charging init/launchd; rolling everything up to pid 1
+        // makes the rollup meaningless.
+        if (parent <= 1 || parent == current) {
+          break;
+        }
+        current = parent;
+      }
+    }
+
+    auto& list = snapshot.accessesByMount_ref()[mountStr];
+    list.reserve(entries.size());
+    for (auto& [pid, entry] : entries) {
+      (void)pid;
+      list.push_back(std::move(entry));
+    }
+  }
+  return snapshot;
+}
+
+apache::thrift::ServerStream<AccessRateSnapshot>
+EdenServiceHandler::streamAccessRates(int64_t windowSeconds) {
+  auto helper = INSTRUMENT_THRIFT_CALL(DBG3, windowSeconds);
+
+  // ProcessAccessLog retains ten seconds of per-second buckets.
+  auto window = std::chrono::seconds{
+      std::max<int64_t>(1, std::min<int64_t>(windowSeconds, 10))};
+
+  struct StreamState {
+    std::atomic<bool> cancelled{false};
+  };
+  auto state = std::make_shared<StreamState>();
+
+  auto [serverStream, publisher] =
+      apache::thrift::ServerStream<AccessRateSnapshot>::createPublisher(
+          [state] { state->cancelled.store(true, std::memory_order_release); });
+
+  auto publisherOwner =
+      std::make_shared<ThriftStreamPublisherOwner<AccessRateSnapshot>>(
+          std::move(publisher));
+
+  // Publish one snapshot per window until the client disconnects. The loop
+  // holds itself alive through the shared function object; the cycle is
+  // broken explicitly on cancellation so the captures can be destroyed.
+  auto loop = std::make_shared<std::function<void()>>();
+  *loop = [this, state, publisherOwner, window, loop]() {
+    folly::futures::sleep(window)
+        .via(server_->getServerState()->getThreadPool().get())
+        .thenValue([this, state, publisherOwner, window, loop](auto&&) {
+          if (state->cancelled.load(std::memory_order_acquire)) {
+            *loop = {};
+            return;
+          }
+          publisherOwner->next(computeAccessRateSnapshot(window));
+          (*loop)();
+        });
+  };
+  (*loop)();
+
+  return std::move(serverStream);
+}
+
 void EdenServiceHandler::clearAndCompactLocalStore() {
   auto helper = INSTRUMENT_THRIFT_CALL(DBG1);
   server_->getLocalStore()->clearCachesAndCompactAll();
@@ -3945,7 +5323,7 @@ EdenServiceHandler::semifuture_debugInvalidateNonMaterialized(
     return std::move(invalFut).semi();
   } else {
     folly::futures::detachOn(
-        server_->getServerState()->getThreadPool().get(),
+        mountHandle.getEdenMount().getMountThreadPool(),
         std::move(invalFut).semi());
     return std::make_unique<DebugInvalidateResponse>();
   }
@@ -4237,6 +5615,52 @@ void EdenServiceHandler::getRetroactiveHgEvents(
   result.events() = std::move(thriftEvents);
 }
 
+namespace {
+HgImportStageDwell convertDwellStage(
+    const HgImportDwellStats::Stage& stage) {
+  HgImportStageDwell result;
+  result.count() = stage.count;
+  result.totalDurationUs() = stage.totalDurationUs;
+  result.maxDurationUs() = stage.maxDurationUs;
+  result.histogram() =
+      std::vector<int64_t>(stage.histogram.begin(), stage.histogram.end());
+  return result;
+}
+} // namespace
+
+void EdenServiceHandler::getHgImportDwellTimes(
+    GetHgImportDwellTimesResult& result,
+    std::unique_ptr<GetHgImportDwellTimesParams> params) {
+  auto mountHandle = lookupMount(params->mountPoint());
+  auto backingStore = mountHandle.getObjectStore().getBackingStore();
+  std::shared_ptr<HgQueuedBackingStore> hgBackingStore =
+      castToHgQueuedBackingStore(
+          backingStore, mountHandle.getEdenMount().getPath());
+
+  std::vector<HgImportDwellTimes> byPriority;
+  for (const auto& [priority, stats] : hgBackingStore->getImportDwellStats()) {
+    HgImportDwellTimes dwellTimes;
+    switch (priority) {
+      case ImportPriority::Class::Low:
+        dwellTimes.priority() = HgImportPriority::LOW;
+        break;
+      case ImportPriority::Class::Normal:
+        dwellTimes.priority() = HgImportPriority::NORMAL;
+        break;
+      case ImportPriority::Class::High:
+        dwellTimes.priority() = HgImportPriority::HIGH;
+        break;
+    }
+    dwellTimes.queueDwell() = convertDwellStage(stats.queueDwell);
+    dwellTimes.execution() = convertDwellStage(stats.execution);
+    dwellTimes.total() = convertDwellStage(stats.total);
+    dwellTimes.deduplicatedRequests() = stats.deduplicated;
+    byPriority.push_back(std::move(dwellTimes));
+  }
+
+  result.byPriority() = std::move(byPriority);
+}
+
 void EdenServiceHandler::getRetroactiveInodeEvents(
     GetRetroactiveInodeEventsResult& result,
     std::unique_ptr<GetRetroactiveInodeEventsParams> params) {
@@ -4407,6 +5831,25 @@ void EdenServiceHandler::getDaemonInfo(DaemonInfo& result) {
   fillDaemonInfo(result);
 }
 
+void EdenServiceHandler::getStartupProfile(StartupProfile& result) {
+  auto helper = INSTRUMENT_THRIFT_CALL(DBG4);
+  auto logger = server_->getStartupLogger();
+  if (!logger) {
+    // prepare() did not run; e.g. we recovered from a failed takeover.
+    return;
+  }
+
+  std::chrono::microseconds previous{0};
+  for (const auto& entry : logger->getTimeline()) {
+    StartupPhase phase;
+    phase.name_ref() = entry.message;
+    phase.elapsedUs_ref() = entry.elapsed.count();
+    phase.durationUs_ref() = (entry.elapsed - previous).count();
+    previous = entry.elapsed;
+    result.phases_ref()->push_back(std::move(phase));
+  }
+}
+
 apache::thrift::ResponseAndServerStream<DaemonInfo, std::string>
 EdenServiceHandler::streamStartStatus() {
   DaemonInfo result;
@@ -8,11 +8,16 @@
 #pragma once
 
 #include <fb303/BaseService.h>
+#include <folly/CancellationToken.h>
+#include <folly/Synchronized.h>
+#include <folly/container/F14Map.h>
+#include <atomic>
 #include <optional>
 #include "eden/common/os/ProcessId.h"
 #include "eden/fs/eden-config.h"
 #include "eden/fs/inodes/EdenMountHandle.h"
 #include "eden/fs/inodes/InodePtrFwd.h"
+#include "eden/fs/service/ThriftRequestCollapser.h"
 #include "eden/fs/service/gen-cpp2/StreamingEdenService.h"
 #include "eden/fs/telemetry/ActivityBuffer.h"
 #include "eden/fs/telemetry/TraceBus.h"
@@ -40,6 +45,7 @@ class ObjectFetchContext;
 using ObjectFetchContextPtr = RefPtr<ObjectFetchContext>;
 struct EntryAttributes;
 struct EntryAttributeFlags;
+struct PrefetchProgressState;
 template <typename T>
 class ImmediateFuture;
 class UsageService;
@@ -156,6 +162,10 @@ class EdenServiceHandler : virtual public StreamingEdenServiceSvIf,
       std::unique_ptr<std::string> mountPoint,
       std::unique_ptr<JournalPosition> fromPosition) override;
 
+  void getFilesChangedSincePage(
+      ChangedSincePage& out,
+      std::unique_ptr<ChangedSincePageParams> params) override;
+
   void setJournalMemoryLimit(
       std::unique_ptr<PathString> mountPoint,
       int64_t limit) override;
@@ -189,6 +199,10 @@ class EdenServiceHandler : virtual public StreamingEdenServiceSvIf,
   semifuture_getAttributesFromFilesV2(
       std::unique_ptr<GetAttributesFromFilesParams> params) override;
 
+  folly::SemiFuture<std::unique_ptr<GetAttributesFromFilesBatchResult>>
+  semifuture_getAttributesFromFilesBatch(
+      std::unique_ptr<GetAttributesFromFilesBatchParams> params) override;
+
   folly::SemiFuture<std::unique_ptr<ReaddirResult>> semifuture_readdir(
       std::unique_ptr<ReaddirParams> params) override;
 
@@ -198,6 +212,15 @@ class EdenServiceHandler : virtual public StreamingEdenServiceSvIf,
   folly::SemiFuture<folly::Unit> semifuture_prefetchFiles(
       std::unique_ptr<PrefetchParams> params) override;
 
+  void startPrefetch(
+      StartPrefetchResult& result,
+      std::unique_ptr<PrefetchParams> params) override;
+
+  void getPrefetchProgress(PrefetchProgress& result, int64_t prefetchId)
+      override;
+
+  void cancelPrefetch(int64_t prefetchId) override;
+
   folly::SemiFuture<std::unique_ptr<Glob>> semifuture_predictiveGlobFiles(
       std::unique_ptr<GlobParams> params) override;
 
@@ -230,6 +253,9 @@ class EdenServiceHandler : virtual public StreamingEdenServiceSvIf,
       std::unique_ptr<::facebook::eden::TraceTaskEventsRequest> request)
       override;
 
+  apache::thrift::ServerStream<AccessRateSnapshot> streamAccessRates(
+      int64_t windowSeconds) override;
+
   folly::SemiFuture<std::unique_ptr<GetScmStatusResult>>
   semifuture_getScmStatusV2(
       std::unique_ptr<GetScmStatusParams> params) override;
@@ -241,6 +267,19 @@ class EdenServiceHandler : virtual public StreamingEdenServiceSvIf,
   streamSelectedChangesSince(
       std::unique_ptr<StreamSelectedChangesSinceParams> params) override;
 
+  apache::thrift::ServerStream<StreamGlobMatch> streamGlobFiles(
+      std::unique_ptr<GlobParams> params) override;
+
+  apache::thrift::
+      ResponseAndServerStream<StreamScmStatusResult, ChangedFileResult>
+      streamScmStatusV2(std::unique_ptr<GetScmStatusParams> params) override;
+
+  apache::thrift::ServerStream<UnmountBatchResult> streamUnmountBatch(
+      std::unique_ptr<UnmountBatchParams> params) override;
+
+  apache::thrift::ServerStream<ScmStatusBatchResult> streamScmStatusForMounts(
+      std::unique_ptr<ScmStatusBatchParams> params) override;
+
   folly::SemiFuture<std::unique_ptr<ScmStatus>> semifuture_getScmStatus(
       std::unique_ptr<std::string> mountPoint,
       bool listIgnored,
@@ -306,6 +345,15 @@ class EdenServiceHandler : virtual public StreamingEdenServiceSvIf,
       ListActivityRecordingsResult& result,
       std::unique_ptr<std::string> mountPoint) override;
 
+  void debugSetSamplingProfilerEnabled(bool enabled) override;
+
+  void debugGetStackSamples(
+      DebugGetStackSamplesResult& result,
+      int64_t lookbackSeconds) override;
+
+  void debugGetSlowRequestTraces(
+      DebugGetSlowRequestTracesResult& result) override;
+
   void debugGetInodePath(
       InodePathDebugInfo& inodePath,
       std::unique_ptr<std::string> mountPoint,
@@ -318,6 +366,12 @@ class EdenServiceHandler : virtual public StreamingEdenServiceSvIf,
   void getAccessCounts(GetAccessCountsResult& result, int64_t duration)
       override;
 
+  void getFsLatencyHistograms(GetFsLatencyHistogramsResult& result) override;
+
+  void getCacheStats(GetCacheStatsResult& result) override;
+
+  void getMemoryBreakdown(GetMemoryBreakdownResult& result) override;
+
   void clearAndCompactLocalStore() override;
 
   void debugClearLocalStoreCaches() override;
@@ -356,6 +410,10 @@ class EdenServiceHandler : virtual public StreamingEdenServiceSvIf,
       GetRetroactiveHgEventsResult& result,
       std::unique_ptr<GetRetroactiveHgEventsParams> params) override;
 
+  void getHgImportDwellTimes(
+      GetHgImportDwellTimesResult& result,
+      std::unique_ptr<GetHgImportDwellTimesParams> params) override;
+
   void getRetroactiveInodeEvents(
       GetRetroactiveInodeEventsResult& result,
       std::unique_ptr<GetRetroactiveInodeEventsParams> params) override;
@@ -378,6 +436,8 @@ class EdenServiceHandler : virtual public StreamingEdenServiceSvIf,
 
   void getDaemonInfo(DaemonInfo& result) override;
 
+  void getStartupProfile(StartupProfile& result) override;
+
   apache::thrift::ResponseAndServerStream<DaemonInfo, std::string>
   streamStartStatus() override;
   /**
@@ -438,6 +498,12 @@ class EdenServiceHandler : virtual public StreamingEdenServiceSvIf,
 
   void fillDaemonInfo(DaemonInfo& info);
 
+  /**
+   * Computes one per-process access attribution snapshot covering the last
+   * `window` seconds across all mounts, including process-tree rollup.
+   */
+  AccessRateSnapshot computeAccessRateSnapshot(std::chrono::seconds window);
+
   /**
    * Returns attributes requested by `reqBitmask` for each path in `paths`.
    *
@@ -456,9 +522,45 @@ class EdenServiceHandler : virtual public StreamingEdenServiceSvIf,
       std::string_view path,
       const ObjectFetchContextPtr& fetchContext);
 
+  /**
+   * Like the loop in getEntryAttributes, but groups the paths by parent
+   * directory so each shared prefix is only walked once. The returned
+   * attributes are in the same order as `paths`.
+   */
+  ImmediateFuture<std::vector<folly::Try<EntryAttributes>>>
+  getEntryAttributesBatched(
+      const EdenMount& edenMount,
+      const std::vector<std::string>& paths,
+      EntryAttributeFlags reqBitmask,
+      const ObjectFetchContextPtr& fetchContext);
+
   folly::Synchronized<std::unordered_map<uint64_t, ThriftRequestTraceEvent>>
       outstandingThriftRequests_;
 
+  /**
+   * State for a prefetch started via startPrefetch(), kept so that progress
+   * can be polled and the prefetch cancelled. Finished sessions stay in
+   * prefetchSessions_ until garbage collected by the next startPrefetch()
+   * call.
+   */
+  struct PrefetchSession {
+    std::shared_ptr<PrefetchProgressState> progress;
+    folly::CancellationSource cancellationSource;
+    std::atomic<PrefetchState> state{PrefetchState::RUNNING};
+    folly::Synchronized<std::string> error;
+  };
+
+  folly::Synchronized<
+      folly::F14FastMap<int64_t, std::shared_ptr<PrefetchSession>>>
+      prefetchSessions_;
+
+  /**
+   * Collapse identical concurrent status and glob queries onto a single
+   * in-flight computation. See ThriftRequestCollapser.
+   */
+  ThriftRequestCollapser<std::shared_ptr<ScmStatus>> scmStatusCollapser_;
+  ThriftRequestCollapser<std::shared_ptr<Glob>> globFilesCollapser_;
+
   const std::vector<std::string> originalCommandLine_;
   EdenServer* const server_;
 
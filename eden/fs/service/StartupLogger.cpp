@@ -108,10 +108,18 @@ void StartupLogger::success(uint64_t startTimeInSeconds) {
 void StartupLogger::writeMessage(folly::LogLevel level, StringPiece message) {
   static folly::Logger logger("eden.fs.startup");
   FB_LOG_RAW(logger, level, __FILE__, __LINE__, __func__) << message;
+  timeline_.wlock()->push_back(TimelineEntry{
+      message.str(),
+      std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::steady_clock::now() - startTime_)});
   writeMessageImpl(level, message);
   startupStatusChannel_->publish(message);
 }
 
+std::vector<StartupLogger::TimelineEntry> StartupLogger::getTimeline() const {
+  return *timeline_.rlock();
+}
+
 DaemonStartupLogger::DaemonStartupLogger(
     std::shared_ptr<StartupStatusChannel> startupStatusChannel)
     : StartupLogger(std::move(startupStatusChannel)) {}
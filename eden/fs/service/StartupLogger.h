@@ -10,6 +10,9 @@
 #include <fmt/ranges.h>
 #include <folly/File.h>
 #include <folly/Range.h>
+#include <folly/Synchronized.h>
+#include <chrono>
+#include <vector>
 #include <folly/lang/Assume.h>
 #include <folly/logging/LogLevel.h>
 #include <folly/portability/GFlags.h>
@@ -69,6 +72,15 @@ std::shared_ptr<StartupLogger> daemonizeIfRequested(
  */
 class StartupLogger {
  public:
+  /**
+   * One milestone in the startup sequence: the message that was logged and
+   * how long after process start it was emitted.
+   */
+  struct TimelineEntry {
+    std::string message;
+    std::chrono::microseconds elapsed;
+  };
+
   explicit StartupLogger(
       std::shared_ptr<StartupStatusChannel> startupStatusChannel);
 
@@ -135,6 +147,13 @@ class StartupLogger {
    */
   void success(uint64_t startTimeInSeconds);
 
+  /**
+   * Returns a copy of the startup timeline recorded so far.  Every message
+   * logged through this class is a milestone; the elapsed time of each entry
+   * is measured from construction of the logger.
+   */
+  std::vector<TimelineEntry> getTimeline() const;
+
  protected:
   void writeMessage(folly::LogLevel level, folly::StringPiece message);
 
@@ -145,6 +164,11 @@ class StartupLogger {
   [[noreturn]] virtual void failAndExitImpl(uint8_t exitCode) = 0;
 
   std::shared_ptr<StartupStatusChannel> startupStatusChannel_;
+
+ private:
+  const std::chrono::steady_clock::time_point startTime_{
+      std::chrono::steady_clock::now()};
+  folly::Synchronized<std::vector<TimelineEntry>> timeline_;
 };
 
 class DaemonStartupLogger : public StartupLogger {
@@ -7,8 +7,13 @@
 
 #include "eden/fs/service/ThriftGlobImpl.h"
 
+#include <folly/Synchronized.h>
+#include <folly/TokenBucket.h>
+#include <folly/container/EvictingCacheMap.h>
+#include <folly/futures/Future.h>
 #include <folly/logging/LogLevel.h>
 #include <folly/logging/xlog.h>
+#include <algorithm>
 #include <memory>
 #include "eden/fs/inodes/EdenMount.h"
 #include "eden/fs/inodes/GlobNode.h"
@@ -46,6 +51,33 @@ void compileGlobs(const std::vector<std::string>& globs, GlobNodeImpl& root) {
     throw newEdenError(exc);
   }
 }
+
+// Recursive suffix queries ("**/*.cpp" and friends) dominate Buck's target
+// discovery traffic, and the same revisions and patterns are queried over
+// and over. Commit trees are immutable, so a completed response for a given
+// revision set is also immutable and can be replayed without walking the
+// tree again.
+constexpr size_t kSuffixQueryCacheSize = 32;
+
+using SuffixQueryCache =
+    folly::EvictingCacheMap<std::string, std::shared_ptr<const Glob>>;
+
+folly::Synchronized<SuffixQueryCache>& suffixQueryCache() {
+  static auto* cache = new folly::Synchronized<SuffixQueryCache>{
+      std::in_place, kSuffixQueryCacheSize};
+  return *cache;
+}
+
+// Returns true if this glob is a recursive suffix query like "**/*.cpp":
+// a pattern whose only wildcards are the leading "**/*".
+bool isSuffixQuery(const std::string& glob) {
+  constexpr std::string_view prefix = "**/*.";
+  if (glob.size() <= prefix.size() ||
+      std::string_view{glob}.substr(0, prefix.size()) != prefix) {
+    return false;
+  }
+  return glob.find_first_of("*?[\\/", prefix.size()) == std::string::npos;
+}
 } // namespace
 
 ThriftGlobImpl::ThriftGlobImpl(const GlobParams& params)
@@ -87,6 +119,38 @@ ImmediateFuture<std::unique_ptr<Glob>> ThriftGlobImpl::glob(
   if (!(searchRootUser_.empty() || searchRootUser_ == ".")) {
     searchRoot = RelativePath{searchRootUser_};
   }
+
+  // When enabled, independent subtree evaluations run on the server's
+  // thread pool instead of inline on this thread.
+  folly::Executor* globExecutor = nullptr;
+  if (serverState->getEdenConfig()->globUseParallelEvaluation.getValue()) {
+    globExecutor = serverState->getThreadPool().get();
+  }
+  // Completed recursive suffix queries against explicit revisions can be
+  // answered from the cache: the queried trees are immutable, so the same
+  // revisions and patterns always yield the same response. Prefetching
+  // requests still walk the tree so that blob fetches are issued.
+  std::string suffixQueryCacheKey;
+  if (serverState->getEdenConfig()->globUseSuffixQueryCache.getValue() &&
+      !rootHashes_.empty() && !prefetchFiles_ && !suppressFileList_ &&
+      std::all_of(globs.begin(), globs.end(), isSuffixQuery)) {
+    suffixQueryCacheKey = fmt::format(
+        "{}|{}|{}|{}|{}{}{}{}",
+        edenMount->getPath().view(),
+        fmt::join(rootHashes_, ","),
+        searchRootUser_,
+        fmt::join(globs, ","),
+        includeDotfiles_,
+        wantDtype_,
+        listOnlyFiles_,
+        windowsSymlinksEnabled);
+    auto cache = suffixQueryCache().wlock();
+    auto it = cache->find(suffixQueryCacheKey);
+    if (it != cache->end()) {
+      return std::make_unique<Glob>(*it->second);
+    }
+  }
+
   std::shared_ptr<GlobTree> globTree = nullptr;
   std::shared_ptr<GlobNode> globNode = nullptr;
 
@@ -124,7 +188,8 @@ ImmediateFuture<std::unique_ptr<Glob>> ThriftGlobImpl::glob(
                    fetchContext = fetchContext.copy(),
                    fileBlobsToPrefetch,
                    globResults,
-                   &originRootId](std::shared_ptr<const Tree>&& tree) mutable {
+                   &originRootId,
+                   globExecutor](std::shared_ptr<const Tree>&& tree) mutable {
                     return globTree->evaluate(
                         edenMount->getObjectStore(),
                         fetchContext,
@@ -132,35 +197,80 @@ ImmediateFuture<std::unique_ptr<Glob>> ThriftGlobImpl::glob(
                         std::move(tree),
                         fileBlobsToPrefetch.get(),
                         *globResults,
-                        originRootId);
+                        originRootId,
+                        globExecutor);
                   }));
     }
   } else {
-    globNode = std::make_shared<GlobNode>(
-        includeDotfiles_,
+    auto caseSensitivity =
         serverState->getEdenConfig()->globUseMountCaseSensitivity.getValue()
-            ? edenMount->getCheckoutConfig()->getCaseSensitive()
-            : CaseSensitivity::Sensitive);
-    compileGlobs(globs, *globNode);
+        ? edenMount->getCheckoutConfig()->getCaseSensitive()
+        : CaseSensitivity::Sensitive;
     const RootId& originRootId =
         originRootIds->emplace_back(edenMount->getCheckedOutRootId());
-    globFutures.emplace_back(
-        edenMount->getInodeSlow(searchRoot, fetchContext)
-            .thenValue([fetchContext = fetchContext.copy(),
-                        globNode,
-                        edenMount,
-                        fileBlobsToPrefetch,
-                        globResults,
-                        &originRootId](InodePtr inode) mutable {
-              return globNode->evaluate(
-                  edenMount->getObjectStore(),
-                  fetchContext,
-                  RelativePathPiece(),
-                  inode.asTreePtr(),
-                  fileBlobsToPrefetch.get(),
-                  *globResults,
-                  originRootId);
-            }));
+
+    // When the root is not materialized, the entire working copy is
+    // byte-identical to the checked out commit, so the glob can be
+    // evaluated against raw Trees straight from the tree cache - exactly
+    // as the explicit-revision path above does - without registering an
+    // inode for every directory the glob visits.
+    bool evaluateAgainstTrees = false;
+    if (serverState->getEdenConfig()->globUseTreeEvaluation.getValue()) {
+      auto rootInode = edenMount->getRootInode();
+      evaluateAgainstTrees =
+          rootInode && !rootInode->getContents().rlock()->isMaterialized();
+    }
+
+    if (evaluateAgainstTrees) {
+      globTree = std::make_shared<GlobTree>(includeDotfiles_, caseSensitivity);
+      compileGlobs(globs, *globTree);
+      globFutures.emplace_back(
+          resolveTree(
+              *edenMount->getObjectStore(),
+              fetchContext,
+              edenMount->getCheckedOutRootTree(),
+              searchRoot)
+              .thenValue(
+                  [edenMount,
+                   globTree,
+                   fetchContext = fetchContext.copy(),
+                   fileBlobsToPrefetch,
+                   globResults,
+                   &originRootId,
+                   globExecutor](std::shared_ptr<const Tree>&& tree) mutable {
+                    return globTree->evaluate(
+                        edenMount->getObjectStore(),
+                        fetchContext,
+                        RelativePathPiece(),
+                        std::move(tree),
+                        fileBlobsToPrefetch.get(),
+                        *globResults,
+                        originRootId,
+                        globExecutor);
+                  }));
+    } else {
+      globNode = std::make_shared<GlobNode>(includeDotfiles_, caseSensitivity);
+      compileGlobs(globs, *globNode);
+      globFutures.emplace_back(
+          edenMount->getInodeSlow(searchRoot, fetchContext)
+              .thenValue([fetchContext = fetchContext.copy(),
+                          globNode,
+                          edenMount,
+                          fileBlobsToPrefetch,
+                          globResults,
+                          &originRootId,
+                          globExecutor](InodePtr inode) mutable {
+                return globNode->evaluate(
+                    edenMount->getObjectStore(),
+                    fetchContext,
+                    RelativePathPiece(),
+                    inode.asTreePtr(),
+                    fileBlobsToPrefetch.get(),
+                    *globResults,
+                    originRootId,
+                    globExecutor);
+              }));
+    }
   }
 
   auto prefetchFuture =
@@ -208,6 +318,8 @@ ImmediateFuture<std::unique_ptr<Glob>> ThriftGlobImpl::glob(
                listOnlyFiles = listOnlyFiles_,
                fetchContext = fetchContext.copy(),
                windowsSymlinksEnabled = windowsSymlinksEnabled,
+               prefetchProgress = prefetchProgress_,
+               prefetchCancellation = prefetchCancellation_,
                config = serverState->getEdenConfig()](
                   std::vector<GlobResult>&& results) mutable
               -> ImmediateFuture<std::unique_ptr<Glob>> {
@@ -237,15 +349,99 @@ ImmediateFuture<std::unique_ptr<Glob>> ThriftGlobImpl::glob(
                   }
                 }
                 if (fileBlobsToPrefetch) {
-                  std::vector<ImmediateFuture<folly::Unit>> futures;
-
+                  constexpr size_t kBatchSize = 20480;
                   auto store = edenMount->getObjectStore();
+
+                  if (prefetchProgress) {
+                    // Managed prefetch: fetch batches one at a time so that
+                    // progress is meaningful, cancellation takes effect at
+                    // batch boundaries, and the configured rate limit can
+                    // pace the fetches.
+                    auto blobs = std::make_shared<std::vector<ObjectId>>(
+                        *fileBlobsToPrefetch->rlock());
+                    prefetchProgress->totalBlobs.store(
+                        blobs->size(), std::memory_order_relaxed);
+                    auto rate =
+                        config->prefetchThrottleBlobsPerSecond.getValue();
+                    auto bucket = rate > 0
+                        ? std::make_shared<folly::TokenBucket>(
+                              static_cast<double>(rate),
+                              std::max<double>(
+                                  static_cast<double>(rate), kBatchSize))
+                        : nullptr;
+
+                    ImmediateFuture<folly::Unit> prefetches{std::in_place};
+                    for (size_t start = 0; start < blobs->size();
+                         start += kBatchSize) {
+                      auto count =
+                          std::min(kBatchSize, blobs->size() - start);
+                      prefetches =
+                          std::move(prefetches)
+                              .thenValue([store,
+                                          blobs,
+                                          start,
+                                          count,
+                                          bucket,
+                                          prefetchProgress,
+                                          prefetchCancellation,
+                                          fetchContext = fetchContext.copy()](
+                                             auto&&)
+                                             -> ImmediateFuture<folly::Unit> {
+                                if (prefetchCancellation
+                                        .isCancellationRequested()) {
+                                  throw newEdenError(
+                                      EINTR,
+                                      EdenErrorType::GENERIC_ERROR,
+                                      "prefetch cancelled");
+                                }
+                                ImmediateFuture<folly::Unit> throttle{
+                                    std::in_place};
+                                if (bucket) {
+                                  auto napTime =
+                                      bucket->consumeWithBorrowNonBlocking(
+                                          static_cast<double>(count));
+                                  if (napTime.has_value() && *napTime > 0) {
+                                    throttle = folly::futures::sleep(
+                                        std::chrono::duration_cast<
+                                            std::chrono::milliseconds>(
+                                            std::chrono::duration<double>(
+                                                *napTime)));
+                                  }
+                                }
+                                return std::move(throttle)
+                                    .thenValue([store,
+                                                blobs,
+                                                start,
+                                                count,
+                                                fetchContext](auto&&) {
+                                      return store->prefetchBlobs(
+                                          folly::Range{
+                                              blobs->data() + start, count},
+                                          fetchContext);
+                                    })
+                                    .thenValue([prefetchProgress,
+                                                count](auto&&) {
+                                      prefetchProgress->fetchedBlobs
+                                          .fetch_add(
+                                              count,
+                                              std::memory_order_relaxed);
+                                      return folly::unit;
+                                    });
+                              });
+                    }
+                    return std::move(prefetches)
+                        .thenValue([glob = std::move(out)](auto&&) mutable {
+                          return std::move(glob);
+                        });
+                  }
+
+                  std::vector<ImmediateFuture<folly::Unit>> futures;
                   auto blobs = fileBlobsToPrefetch->rlock();
                   auto range = folly::Range{blobs->data(), blobs->size()};
 
-                  while (range.size() > 20480) {
-                    auto curRange = range.subpiece(0, 20480);
-                    range.advance(20480);
+                  while (range.size() > kBatchSize) {
+                    auto curRange = range.subpiece(0, kBatchSize);
+                    range.advance(kBatchSize);
                     futures.emplace_back(
                         store->prefetchBlobs(curRange, fetchContext));
                   }
@@ -267,9 +463,26 @@ ImmediateFuture<std::unique_ptr<Glob>> ThriftGlobImpl::glob(
                 // keep globRoot and originRootIds alive until the end
               });
 
+  if (!suffixQueryCacheKey.empty()) {
+    return std::move(prefetchFuture)
+        .thenValue([key = std::move(suffixQueryCacheKey)](
+                       std::unique_ptr<Glob> glob) mutable {
+          suffixQueryCache().wlock()->set(
+              std::move(key), std::make_shared<const Glob>(*glob));
+          return glob;
+        });
+  }
+
   return prefetchFuture;
 }
 
+void ThriftGlobImpl::setManagedPrefetch(
+    std::shared_ptr<PrefetchProgressState> progress,
+    folly::CancellationToken token) {
+  prefetchProgress_ = std::move(progress);
+  prefetchCancellation_ = std::move(token);
+}
+
 std::string ThriftGlobImpl::logString() {
   return fmt::format(
       "ThriftGlobImpl {{ includeDotFiles={}, prefetchFiles={}, suppressFileList={}, wantDtype={}, listOnlyFiles={}, rootHashes={}, searchRootUser={} }}",
@@ -7,10 +7,12 @@
 
 #pragma once
 
+#include <atomic>
 #include <memory>
 #include <string>
 #include <vector>
 
+#include <folly/CancellationToken.h>
 #include <folly/Range.h>
 #include "eden/fs/utils/ImmediateFuture.h"
 #include "eden/fs/utils/RefPtr.h"
@@ -27,11 +29,34 @@ class PrefetchParams;
 class ObjectFetchContext;
 using ObjectFetchContextPtr = RefPtr<ObjectFetchContext>;
 
+/**
+ * Progress of a managed blob prefetch, shared between the running glob and
+ * the Thrift progress API.
+ */
+struct PrefetchProgressState {
+  std::atomic<uint64_t> totalBlobs{0};
+  std::atomic<uint64_t> fetchedBlobs{0};
+};
+
 class ThriftGlobImpl {
  public:
   explicit ThriftGlobImpl(const GlobParams& params);
   explicit ThriftGlobImpl(const PrefetchParams& params);
 
+  /**
+   * Makes this glob's blob prefetch observable and controllable: progress
+   * is published to progress, the prefetch stops at the next batch boundary
+   * once token is cancelled, and batches are throttled to
+   * store:prefetch-throttle-blobs-per-second when that is non-zero.
+   *
+   * Blob batches are fetched sequentially rather than submitted to the
+   * store all at once, so a managed prefetch holds at most one outstanding
+   * batch.
+   */
+  void setManagedPrefetch(
+      std::shared_ptr<PrefetchProgressState> progress,
+      folly::CancellationToken token);
+
   // TODO: shared_ptr<EdenMount> is not sufficient to ensure an EdenMount is
   // usable for the duration of this glob. Either pass EdenMountHandle or
   // .ensure() the lifetime of EdenMountHandle outlives the call.
@@ -52,6 +77,8 @@ class ThriftGlobImpl {
   bool listOnlyFiles_{false};
   std::vector<std::string> rootHashes_;
   folly::StringPiece searchRootUser_;
+  std::shared_ptr<PrefetchProgressState> prefetchProgress_;
+  folly::CancellationToken prefetchCancellation_;
 };
 
 } // namespace facebook::eden
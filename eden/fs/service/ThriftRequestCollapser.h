@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#pragma once
+
+#include <folly/Synchronized.h>
+#include <folly/container/F14Map.h>
+#include <folly/futures/SharedPromise.h>
+#include <folly/hash/Hash.h>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "eden/fs/telemetry/EdenStats.h"
+#include "eden/fs/utils/ImmediateFuture.h"
+
+namespace facebook::eden {
+
+/**
+ * Collapses identical concurrent Thrift queries onto one in-flight
+ * computation.
+ *
+ * Tools routinely race identical read-only queries against the same mount:
+ * an IDE, Buck and a shell prompt all asking for status at once. When a
+ * request arrives whose key matches a computation that is still in flight,
+ * the new caller is attached to that computation's result instead of
+ * repeating the work.
+ *
+ * The key must incorporate everything the result depends on - typically the
+ * mount, the method, a hash of the arguments and the current journal
+ * sequence number, so that requests racing with working copy modifications
+ * never share results across a modification.
+ *
+ * The result is shared between all attached callers, so Result should be a
+ * shared_ptr (or otherwise cheap to copy). Results are not cached: once the
+ * computation completes and the attached callers have been served, the next
+ * identical request computes again.
+ */
+template <typename Result>
+class ThriftRequestCollapser {
+ public:
+  struct RequestKey {
+    std::string mountPoint;
+    /** The Thrift method name. Must point at a string literal. */
+    std::string_view method;
+    uint64_t argsHash;
+    uint64_t journalSequence;
+
+    bool operator==(const RequestKey& other) const {
+      return argsHash == other.argsHash &&
+          journalSequence == other.journalSequence &&
+          method == other.method && mountPoint == other.mountPoint;
+    }
+  };
+
+  struct RequestKeyHash {
+    size_t operator()(const RequestKey& key) const {
+      return folly::hash::hash_combine(
+          key.mountPoint, key.method, key.argsHash, key.journalSequence);
+    }
+  };
+
+  /**
+   * Runs compute() and returns its result, unless a computation with the
+   * same key is already in flight, in which case compute() is not invoked
+   * and the returned future is attached to the in-flight computation
+   * instead.
+   *
+   * Hits and misses are recorded in ThriftStats so the collapse rate is
+   * visible in counters.
+   */
+  template <typename ComputeFunc>
+  ImmediateFuture<Result> collapse(
+      RequestKey key,
+      const EdenStatsPtr& stats,
+      ComputeFunc&& compute) {
+    std::shared_ptr<folly::SharedPromise<Result>> promise;
+    {
+      auto inflight = inflight_.wlock();
+      auto it = inflight->find(key);
+      if (it != inflight->end()) {
+        stats->increment(&ThriftStats::requestCollapseHit);
+        return ImmediateFuture<Result>{it->second->getSemiFuture()};
+      }
+      stats->increment(&ThriftStats::requestCollapseMiss);
+      promise = std::make_shared<folly::SharedPromise<Result>>();
+      inflight->emplace(key, promise);
+    }
+
+    // The computation runs outside the lock; identical requests arriving
+    // before it completes attach to the promise above.
+    return std::forward<ComputeFunc>(compute)().thenTry(
+        [this, key = std::move(key), promise = std::move(promise)](
+            folly::Try<Result> result) -> ImmediateFuture<Result> {
+          inflight_.wlock()->erase(key);
+          promise->setTry(folly::Try<Result>{result});
+          return ImmediateFuture<Result>{std::move(result)};
+        });
+  }
+
+ private:
+  folly::Synchronized<folly::F14FastMap<
+      RequestKey,
+      std::shared_ptr<folly::SharedPromise<Result>>,
+      RequestKeyHash>>
+      inflight_;
+};
+
+} // namespace facebook::eden
@@ -163,6 +163,32 @@ struct DaemonInfo {
   4: optional float uptime;
 }
 
+/**
+ * One milestone in the daemon's startup sequence.
+ */
+struct StartupPhase {
+  /**
+   * The startup message logged when this phase completed.
+   */
+  1: string name;
+  /**
+   * Microseconds from process start until this phase completed.
+   */
+  2: i64 elapsedUs;
+  /**
+   * Microseconds spent in this phase, i.e. since the previous phase
+   * completed.
+   */
+  3: i64 durationUs;
+}
+
+/**
+ * A machine-readable timeline of the daemon's startup sequence.
+ */
+struct StartupProfile {
+  1: list<StartupPhase> phases;
+}
+
 /**
 * Information about the privhelper process
 */
@@ -478,6 +504,24 @@ struct GetAttributesFromFilesResultV2 {
   1: list<FileAttributeDataOrErrorV2> res;
 }
 
+/**
+ * Parameters for the getAttributesFromFilesBatch() function: one entry per
+ * queried mount, each with its own path list, attribute set and sync
+ * behavior.
+ */
+struct GetAttributesFromFilesBatchParams {
+  1: list<GetAttributesFromFilesParams> requests;
+}
+
+/**
+ * Return value for the getAttributesFromFilesBatch() function. res[i] holds
+ * the result for requests[i]; within it, the per-path results follow the
+ * conventions of getAttributesFromFilesV2.
+ */
+struct GetAttributesFromFilesBatchResult {
+  1: list<GetAttributesFromFilesResultV2> res;
+}
+
 struct ReaddirParams {
   1: PathString mountPoint;
   2: list<PathString> directoryPaths;
@@ -568,6 +612,41 @@ struct FileDelta {
   7: list<ThriftRootId> snapshotTransitions;
 }
 
+/**
+ * Argument to getFilesChangedSincePage.
+ */
+struct ChangedSincePageParams {
+  1: PathString mountPoint;
+  /**
+   * The position to resume from. The first page uses the client's last
+   * known position; each later page uses the toPosition of the page
+   * before it.
+   */
+  2: JournalPosition fromPosition;
+  /**
+   * Upper bound on the number of journal entries merged into this page.
+   * Must be positive. A page served from the journal's on-disk overflow
+   * tier may cover more entries than this, but overflow segments are
+   * pre-merged summaries, so the response stays bounded regardless.
+   */
+  3: i64 maxDeltas;
+}
+
+/**
+ * One bounded page of journal history returned by getFilesChangedSincePage.
+ */
+struct ChangedSincePage {
+  /**
+   * The changes covered by this page. delta.toPosition is the bookmark
+   * to pass as fromPosition when fetching the next page.
+   */
+  1: FileDelta delta;
+  /**
+   * True when more journal history remains past delta.toPosition.
+   */
+  2: bool hasMore;
+}
+
 struct DebugGetRawJournalParams {
   1: PathString mountPoint;
   2: optional i32 limit;
@@ -885,6 +964,40 @@ struct ListActivityRecordingsResult {
   1: list<ActivityRecorderResult> recordings;
 }
 
+// A single stack sample captured by the in-process sampling profiler.
+struct ProfilerStackSample {
+  // Microseconds since the unix epoch at which the sample was taken.
+  1: i64 timestampUs;
+  2: string threadName;
+  // Symbolized stack frames, innermost first.
+  3: list<string> frames;
+}
+
+struct DebugGetStackSamplesResult {
+  1: list<ProfilerStackSample> samples;
+}
+
+// One named point on a slow request's critical path, e.g. "dispatch",
+// "store_get_blob", "fetch_network", "reply".
+struct RequestTraceStage {
+  1: string name;
+  // Microseconds from the start of the request to this stage.
+  2: i64 offsetUs;
+}
+
+struct SlowRequestTrace {
+  // Microseconds since the unix epoch at which the request completed.
+  1: i64 completedAtUs;
+  // The channel opcode name, e.g. "FUSE_OPEN" or "GETATTR".
+  2: string opName;
+  3: i64 durationUs;
+  4: list<RequestTraceStage> stages;
+}
+
+struct DebugGetSlowRequestTracesResult {
+  1: list<SlowRequestTrace> traces;
+}
+
 struct SetLogLevelResult {
   1: bool categoryCreated;
 }
@@ -913,6 +1026,66 @@ struct CacheStats {
   4: i64 missCount;
   5: i64 evictionCount;
   6: i64 dropCount;
+  /**
+   * Log2 histogram of reuse distances observed on cache hits: bucket i
+   * counts hits that occurred within [2^(i-1), 2^i) cache accesses of the
+   * previous access to the same object. A hit with reuse distance d would
+   * still have been a hit in any cache retaining the last d accessed
+   * objects, so this histogram predicts the hit rate other cache sizes
+   * would achieve. Populated by getCacheStats but not getStatInfo.
+   */
+  7: optional list<i64> reuseDistanceBuckets;
+  /**
+   * Fresh inserts and never-hit-before-eviction ("unused") capacity
+   * evictions, indexed by the interest class the object was inserted with
+   * (0 = UnlikelyNeededAgain, 1 = WantHandle, 2 = LikelyNeededAgain).
+   * Comparing the two gives the waste rate of each insertion class.
+   * Populated by getCacheStats but not getStatInfo.
+   */
+  8: optional list<i64> insertsByInterest;
+  9: optional list<i64> unusedEvictionsByInterest;
+  /**
+   * UnlikelyNeededAgain inserts the cache refused because recent inserts of
+   * that class were mostly evicted unused. Populated by getCacheStats but
+   * not getStatInfo.
+   */
+  10: optional i64 speculativeBypassCount;
+}
+
+/**
+ * Return value of getCacheStats, a unified view over EdenFS's object caches.
+ */
+struct GetCacheStatsResult {
+  1: CacheStats blobCacheStats;
+  2: CacheStats treeCacheStats;
+  /**
+   * The local_store.* fb303 counters (on-disk cache request outcomes), so
+   * callers can compute LocalStore hit rates from the same snapshot.
+   */
+  3: map<string, i64> localStoreCounters;
+}
+
+/**
+ * Estimated memory retained by the major per-mount data structures.
+ */
+struct MountMemoryBreakdown {
+  /** Bytes retained by the InodeMap and the loaded inodes it tracks. */
+  1: i64 inodeMapBytes;
+  /** Bytes retained by journal deltas. */
+  2: i64 journalBytes;
+}
+
+struct GetMemoryBreakdownResult {
+  1: map<PathString, MountMemoryBreakdown> mounts;
+  /** Bytes held by the in-memory blob cache, shared by all mounts. */
+  2: i64 blobCacheBytes;
+  /** Bytes held by the in-memory tree cache, shared by all mounts. */
+  3: i64 treeCacheBytes;
+  /**
+   * Linux-only: private dirty bytes for the whole process, so the accounted
+   * structures can be compared against actual memory use.
+   */
+  4: optional i64 processPrivateBytes;
 }
 
 /*
@@ -1032,6 +1205,11 @@ enum HgEventType {
   QUEUE = 1,
   START = 2,
   FINISH = 3,
+  // A worker thread pulled the request out of the import queue.
+  DEQUEUE = 4,
+  // The request was attached to an identical in-flight request instead of
+  // being queued.
+  DEDUP = 5,
 }
 
 enum HgResourceType {
@@ -1085,6 +1263,47 @@ struct GetRetroactiveHgEventsResult {
   1: list<HgEvent> events;
 }
 
+/**
+ * Dwell-time summary for one stage of the hg import pipeline. The histogram
+ * uses logarithmic buckets: <1ms, <10ms, <100ms, <1s, <10s and >=10s.
+ */
+struct HgImportStageDwell {
+  1: i64 count;
+  2: i64 totalDurationUs;
+  3: i64 maxDurationUs;
+  4: list<i64> histogram;
+}
+
+/**
+ * Dwell-time summaries for the imports of one priority class.
+ */
+struct HgImportDwellTimes {
+  1: HgImportPriority priority;
+  // Time between a request being enqueued and a worker dequeuing it.
+  2: HgImportStageDwell queueDwell;
+  // Time between dispatch to the store and the import completing.
+  3: HgImportStageDwell execution;
+  // End-to-end time between enqueue and completion.
+  4: HgImportStageDwell total;
+  // Requests attached to an identical in-flight request. These only
+  // contribute to `total`.
+  5: i64 deduplicatedRequests;
+}
+
+/**
+ * Parameters for the getHgImportDwellTimes() function.
+ */
+struct GetHgImportDwellTimesParams {
+  1: PathString mountPoint;
+}
+
+/**
+ * Return value for the getHgImportDwellTimes() function.
+ */
+struct GetHgImportDwellTimesResult {
+  1: list<HgImportDwellTimes> byPriority;
+}
+
 enum InodeType {
   TREE = 0,
   FILE = 1,
@@ -1121,6 +1340,12 @@ struct TaskEvent {
   // Both duration and start are in microseconds (μs)
   5: unsigned64 duration;
   6: unsigned64 start;
+  // Microseconds of `duration` the thread spent running on a CPU; the
+  // remainder was spent blocked or waiting to be scheduled.
+  7: unsigned64 onCpuDuration;
+  // Microseconds the thread spent runnable on the kernel run queue during
+  // the task. Only populated on Linux with scheduler stats enabled.
+  8: unsigned64 runqueueWaitDuration;
 }
 
 /**
@@ -1301,6 +1526,32 @@ struct PrefetchParams {
   7: optional PredictiveFetch predictiveGlob;
 }
 
+/** The state of a prefetch started via startPrefetch(). */
+enum PrefetchState {
+  RUNNING = 0,
+  COMPLETE = 1,
+  FAILED = 2,
+  CANCELLED = 3,
+}
+
+struct StartPrefetchResult {
+  /** Identifies the prefetch to getPrefetchProgress() and cancelPrefetch(). */
+  1: i64 prefetchId;
+}
+
+struct PrefetchProgress {
+  1: PrefetchState state;
+  /**
+   * The number of blobs matched by the globs. 0 while glob evaluation is
+   * still in progress.
+   */
+  2: i64 totalBlobs;
+  /** The number of matched blobs whose prefetch has completed. */
+  3: i64 fetchedBlobs;
+  /** Set when state is FAILED. */
+  4: optional string error;
+}
+
 /** Params for globFiles(). */
 struct GlobParams {
   1: PathString mountPoint;
@@ -1379,6 +1630,49 @@ struct GetAccessCountsResult {
 // 3: map<pid_t, AccessCount> thriftAccesses
 }
 
+// Per-process access attribution over a sampling window, with counts rolled
+// up the process tree so parent build tools are charged for their children.
+struct AttributedAccesses {
+  1: pid_t pid;
+  // 0 when the parent is unknown (e.g. the process already exited).
+  2: pid_t parentPid;
+  // Accesses performed by this process alone during the window.
+  3: AccessCounts own;
+  // Accesses performed by this process and all of its known descendants.
+  4: AccessCounts rollup;
+}
+
+struct AccessRateSnapshot {
+  // Microseconds since the unix epoch at which this snapshot was computed.
+  1: i64 timestampUs;
+  // Length of the sampling window the counts cover; divide the counts by
+  // this to get per-second rates.
+  2: i64 windowSeconds;
+  3: map<PathString, list<AttributedAccesses>> accessesByMount;
+  4: map<pid_t, binary> cmdsByPid;
+}
+
+// A log-scale latency histogram. bucketCounts[i] counts requests whose
+// latency fell in [2^(i-1), 2^i) microseconds; bucket 0 counts
+// sub-microsecond requests. Counters are cumulative since the channel was
+// mounted; pollers should diff successive snapshots.
+struct FsLatencyHistogram {
+  1: list<i64> bucketCounts;
+}
+
+// Per-mount request latency histograms, one per access family using the
+// same read/write/other categorization as AccessCounts.
+struct MountFsLatencyHistograms {
+  1: FsLatencyHistogram read;
+  2: FsLatencyHistogram write;
+  3: FsLatencyHistogram other;
+}
+
+struct GetFsLatencyHistogramsResult {
+  // Mounts whose channel type does not maintain histograms are omitted.
+  1: map<PathString, MountFsLatencyHistograms> histogramsByMount;
+}
+
 enum TracePointEvent {
   // Start of a new block
   START = 0,
@@ -1444,6 +1738,13 @@ struct GetScmStatusResult {
   // the current EdenFS version and warn the user if EdenFS is running an old
   // or known-bad version.
   2: string version;
+
+  /**
+   * Set to true when the diff was stopped early because
+   * GetScmStatusParams.resultLimit was reached. The status then contains an
+   * arbitrary non-exhaustive subset of the changed files.
+   */
+  3: optional bool truncated;
 }
 
 /**
@@ -1488,6 +1789,17 @@ struct GetScmStatusParams {
   4: optional ClientRequestInfo cri;
 
   5: optional RootIdOptions rootIdOptions;
+
+  /**
+   * If set, stop diffing once roughly this many entries have been recorded
+   * and set GetScmStatusResult.truncated. Callers that only need to know
+   * whether the working copy is dirty can use a small limit to avoid paying
+   * for a full status on large checkouts.
+   *
+   * The returned status may contain somewhat more than this many entries as
+   * the walk only stops at directory granularity.
+   */
+  6: optional i64 resultLimit;
 }
 
 /**
@@ -1768,6 +2080,19 @@ service EdenService extends fb303_core.BaseService {
     2: JournalPosition fromPosition,
   ) throws (1: EdenError ex);
 
+  /** A paged variant of getFilesChangedSince for catching up over a long
+   * journal range without materializing it as one giant response.
+   * Each page merges a bounded number of journal entries; the returned
+   * delta.toPosition is the bookmark to resume from, and hasMore reports
+   * whether further pages remain. The client drives the pace, so a
+   * subscriber reconnecting with a very old position never forces the
+   * daemon to buffer the entire range at once.
+   * Throws the same ERANGE and EDOM errors as getFilesChangedSince.
+   */
+  ChangedSincePage getFilesChangedSincePage(
+    1: ChangedSincePageParams params,
+  ) throws (1: EdenError ex);
+
   /** Sets the memory limit on the journal such that the journal will forget
    * old data to keep itself under a certain estimated memory use.
    */
@@ -1845,6 +2170,18 @@ service EdenService extends fb303_core.BaseService {
     1: GetAttributesFromFilesParams params,
   ) throws (1: EdenError ex);
 
+  /**
+   * Batched form of getAttributesFromFilesV2 for queries that span several
+   * mounts. The per-mount requests are fanned out internally in parallel
+   * and the replies returned in request order, so multi-repo tools issue
+   * one round trip instead of one call per mount. A request against an
+   * unknown or unmounted path does not fail the batch; every path in that
+   * request reports the error individually.
+   */
+  GetAttributesFromFilesBatchResult getAttributesFromFilesBatch(
+    1: GetAttributesFromFilesBatchParams params,
+  ) throws (1: EdenError ex);
+
   /**
    * DEPRECATED - prefer getAttributesFromFilesV2.
    *
@@ -1907,6 +2244,39 @@ service EdenService extends fb303_core.BaseService {
     priority = 'BEST_EFFORT',
   );
 
+  /**
+   * Starts a managed background prefetch of the files matching the given
+   * globs and returns immediately with an id that can be used to poll
+   * progress or cancel.
+   *
+   * Unlike prefetchFiles with background=true, blob fetching is throttled
+   * by store:prefetch-throttle-blobs-per-second (when non-zero) so a large
+   * warm-up does not crowd out interactive fetches. A cancelled or failed
+   * prefetch can simply be started again: blobs fetched by the earlier
+   * attempt are served from local caches, so the retry resumes roughly
+   * where the previous attempt stopped.
+   */
+  StartPrefetchResult startPrefetch(1: PrefetchParams params) throws (
+    1: EdenError ex,
+  ) (priority = 'BEST_EFFORT');
+
+  /**
+   * Returns the progress of a prefetch started via startPrefetch().
+   *
+   * Progress for completed prefetches remains queryable for a while, but
+   * is eventually garbage collected; a missing id raises EdenError.
+   */
+  PrefetchProgress getPrefetchProgress(1: i64 prefetchId) throws (
+    1: EdenError ex,
+  );
+
+  /**
+   * Cancels a prefetch started via startPrefetch(). Cancellation takes
+   * effect at the next batch boundary; a prefetch that already finished is
+   * left untouched.
+   */
+  void cancelPrefetch(1: i64 prefetchId) throws (1: EdenError ex);
+
   /**
    * Gets a list of a user's most accessed directories, performs
    * prefetching as specified by PredictiveGlobParams, and returns
@@ -1994,6 +2364,14 @@ service EdenService extends fb303_core.BaseService {
    */
   DaemonInfo getDaemonInfo() throws (1: EdenError ex) (priority = 'IMPORTANT');
 
+  /**
+   * Returns the timeline of the most recent daemon startup, so fleet tooling
+   * can track startup performance across releases. The same data is written
+   * to startup_profile.json in the EdenFS state directory once startup
+   * completes.
+   */
+  StartupProfile getStartupProfile() throws (1: EdenError ex);
+
   /**
   * Returns information about the privhelper process, including accesibility.
   */
@@ -2162,6 +2540,39 @@ service EdenService extends fb303_core.BaseService {
     1: PathString mountPoint,
   );
 
+  /**
+   * Enable or disable the in-process sampling profiler.
+   *
+   * The profiler is also started automatically at daemon startup when
+   * `profiler:enabled` is set in the EdenFS config. Stopping the profiler
+   * retains the already buffered samples. Only effective on Linux.
+   */
+  void debugSetSamplingProfilerEnabled(1: bool enabled) throws (
+    1: EdenError ex,
+  );
+
+  /**
+   * Get the stack samples buffered by the in-process sampling profiler.
+   *
+   * Returns samples taken within the last lookbackSeconds, or everything
+   * still buffered if lookbackSeconds is 0, oldest first.
+   */
+  DebugGetStackSamplesResult debugGetStackSamples(
+    1: i64 lookbackSeconds,
+  ) throws (1: EdenError ex);
+
+  /**
+   * Get the critical-path traces retained for recent slow filesystem
+   * requests, oldest first.
+   *
+   * Requests whose total latency met the telemetry:slow-request-trace-threshold
+   * config value record per-stage timestamps (dispatch, object store probe,
+   * backing fetch, reply) and are kept in a fixed-size ring buffer.
+   */
+  DebugGetSlowRequestTracesResult debugGetSlowRequestTraces() throws (
+    1: EdenError ex,
+  );
+
   /**
    * Get the InodePathDebugInfo for the inode that corresponds to the given
    * inode number. This provides the path for the inode and also indicates
@@ -2192,6 +2603,33 @@ service EdenService extends fb303_core.BaseService {
     1: EdenError ex,
   );
 
+  /**
+   * Returns per-mount FUSE/NFS request latency histograms in a single bulk
+   * snapshot.
+   *
+   * This call is designed for cheap periodic polling: the server reads the
+   * histogram counters without taking any per-counter locks, so polling once
+   * a second has negligible overhead.
+   */
+  GetFsLatencyHistogramsResult getFsLatencyHistograms() throws (
+    1: EdenError ex,
+  );
+
+  /**
+   * Returns hit/miss/eviction counters and reuse-distance histograms for the
+   * in-memory blob and tree caches, plus the LocalStore outcome counters, in
+   * one consistent call. Intended for cache-size tuning; see
+   * CacheStats.reuseDistanceBuckets.
+   */
+  GetCacheStatsResult getCacheStats() throws (1: EdenError ex);
+
+  /**
+   * Returns the estimated memory retained by each mount's InodeMap and
+   * journal along with the shared blob and tree cache sizes, so growth in a
+   * particular structure can be identified without a heap dump.
+   */
+  GetMemoryBreakdownResult getMemoryBreakdown() throws (1: EdenError ex);
+
   /**
    * Start recording paths of the files fetched from the backing store.
    *
@@ -2310,6 +2748,15 @@ service EdenService extends fb303_core.BaseService {
     1: GetRetroactiveHgEventsParams params,
   ) throws (1: EdenError ex);
 
+  /**
+   * Gets aggregated dwell-time histograms for the hg import pipeline of a
+   * mount, broken down by priority class. Useful for telling a slow store
+   * apart from a bad queueing policy when import latency regresses.
+   */
+  GetHgImportDwellTimesResult getHgImportDwellTimes(
+    1: GetHgImportDwellTimesParams params,
+  ) throws (1: EdenError ex);
+
   /**
    * Gets a list of inode events stored in a specified EdenMount's
    * ActivityBuffer. Used for retroactive debugging by the `eden trace inode
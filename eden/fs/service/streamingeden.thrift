@@ -102,6 +102,76 @@ struct StreamSelectedChangesSinceParams {
   2: GlobFilter filter;
 }
 
+/**
+ * A single match emitted by streamGlobFiles.
+ */
+struct StreamGlobMatch {
+  1: eden.PathString name;
+  /**
+   * Only set when GlobParams.wantDtype was true.
+   */
+  2: optional eden.OsDtype dtype;
+  /**
+   * The commit, from GlobParams.revisions, in which this match was found.
+   * See Glob.originHashes for the exact semantics.
+   */
+  3: binary originHash;
+}
+
+/**
+ * Return value of streamScmStatusV2. The entries themselves arrive on the
+ * stream.
+ */
+struct StreamScmStatusResult {
+  /**
+   * The version of the EdenFS daemon, as in GetScmStatusResult.version.
+   */
+  1: string version;
+}
+
+/**
+ * Argument to streamUnmountBatch.
+ */
+struct UnmountBatchParams {
+  /**
+   * The mounts to unmount. An empty list means every mount currently known
+   * to the daemon.
+   */
+  1: list<eden.PathString> mountPoints;
+}
+
+/**
+ * Per-mount outcome of streamUnmountBatch. error is set when unmounting
+ * that mount failed; a failure for one mount does not terminate the
+ * stream.
+ */
+struct UnmountBatchResult {
+  1: eden.PathString mountPoint;
+  2: optional eden.EdenError error;
+}
+
+/**
+ * Argument to streamScmStatusForMounts.
+ */
+struct ScmStatusBatchParams {
+  /**
+   * The mounts to compute status for. An empty list means every mount
+   * currently known to the daemon.
+   */
+  1: list<eden.PathString> mountPoints;
+  2: bool listIgnored = false;
+}
+
+/**
+ * Per-mount outcome of streamScmStatusForMounts. Exactly one of status and
+ * error is set; a failure for one mount does not terminate the stream.
+ */
+struct ScmStatusBatchResult {
+  1: eden.PathString mountPoint;
+  2: optional eden.ScmStatus status;
+  3: optional eden.EdenError error;
+}
+
 struct TraceTaskEventsRequest {}
 
 typedef binary EdenStartStatusUpdate
@@ -177,6 +247,17 @@ service StreamingEdenService extends eden.EdenService {
    */
   stream<eden.TaskEvent> traceTaskEvents(1: TraceTaskEventsRequest request);
 
+  /**
+   * Returns a stream of per-process access attribution snapshots, one per
+   * window, covering all mounts.
+   *
+   * Each snapshot charges accesses to the processes that issued them and
+   * also rolls the counts up the process tree, so a parent build tool is
+   * charged for its children. windowSeconds is clamped to the range of
+   * history ProcessAccessLog retains (currently 1 to 10 seconds).
+   */
+  stream<eden.AccessRateSnapshot> streamAccessRates(1: i64 windowSeconds);
+
   /**
    * Returns a stream of changes since the given JournalPosition.
    *
@@ -201,9 +282,13 @@ service StreamingEdenService extends eden.EdenService {
   );
 
   /**
-   * Same as the API above but only returns files that match the globs in filter.
-   * This API is intend to replace the above API but it's currently under development.
-   * NOT YET READY FOR PROD USE
+   * Same as the API above but only returns files that match the globs in
+   * filter. The filtering happens on the server, inside the journal
+   * accumulation, so subscriptions that only care about a small part of the
+   * repository cost proportionally to the number of matching files.
+   *
+   * Globs use gitignore syntax and match against the full path from the
+   * mount root; use "dir/**" to subscribe to everything below a directory.
    */
   ChangesSinceResult, stream<
     ChangedFileResult throws (1: eden.EdenError ex)
@@ -211,6 +296,64 @@ service StreamingEdenService extends eden.EdenService {
     1: StreamSelectedChangesSinceParams params,
   ) throws (1: eden.EdenError ex);
 
+  /**
+   * Streaming equivalent of globFiles.
+   *
+   * Matches are emitted as they are converted rather than buffered into a
+   * single Glob response, so clients can start processing immediately and
+   * the server does not hold the full Thrift response in memory for large
+   * results. Unlike globFiles, matches are not emitted in any particular
+   * order; the deduplication guarantees are the same as Glob.matchingFiles.
+   *
+   * GlobParams.prefetchFiles and GlobParams.background are not supported by
+   * this API and are rejected with an ARGUMENT_ERROR.
+   */
+  stream<StreamGlobMatch throws (1: eden.EdenError ex)> streamGlobFiles(
+    1: eden.GlobParams params,
+  ) throws (1: eden.EdenError ex);
+
+  /**
+   * Streaming equivalent of getScmStatusV2.
+   *
+   * Status entries are emitted as the diff walk finds them instead of being
+   * accumulated into a single ScmStatus, so clients can start processing
+   * immediately and can close the stream early once they have seen enough;
+   * closing the stream cancels the rest of the walk. Ignored files are only
+   * emitted when GetScmStatusParams.listIgnored is set.
+   *
+   * GetScmStatusParams.resultLimit is ignored by this API: clients control
+   * truncation directly by closing the stream.
+   */
+  StreamScmStatusResult, stream<
+    ChangedFileResult throws (1: eden.EdenError ex)
+  > streamScmStatusV2(1: eden.GetScmStatusParams params) throws (
+    1: eden.EdenError ex,
+  );
+
+  /**
+   * Unmounts a set of mounts, running the unmounts in parallel inside the
+   * daemon, and streams one result per mount as it completes.
+   *
+   * Fleet management tooling that previously looped over unmount() paid a
+   * full round trip per mount and serialized the unmounts; this runs them
+   * concurrently and reports each outcome as soon as it is known. Failures
+   * are reported per mount in UnmountBatchResult.error so one wedged mount
+   * does not hide the others.
+   */
+  stream<UnmountBatchResult> streamUnmountBatch(1: UnmountBatchParams params);
+
+  /**
+   * Computes working copy status for a set of mounts in parallel and
+   * streams one result per mount as it completes.
+   *
+   * Each mount is diffed against its own working copy parent: a bulk
+   * status check asks "which mounts are dirty", not how a mount compares
+   * to a caller-chosen commit. Use getScmStatusV2 for the latter.
+   */
+  stream<ScmStatusBatchResult> streamScmStatusForMounts(
+    1: ScmStatusBatchParams params,
+  );
+
   /**
    * Returns the basic status from EdenFS as one would get from getDaemonInfo
    * and a stream of updates of the EdenFS startup process if EdenFS is
@@ -5,6 +5,7 @@
  * GNU General Public License version 2.
  */
 
+#include <folly/CancellationToken.h>
 #include <folly/portability/GTest.h>
 #include <cstddef>
 #include <memory>
@@ -75,4 +76,130 @@ TEST(ThriftGlobImplTest, testGlobFilesNotLoadingInode) {
   // - foo/bar/dir2/file.txt
   assertInodeCounters(inodeMap, loaded + 6, unloaded);
 }
+
+TEST(ThriftGlobImplTest, testSuffixQueryCache) {
+  FakeTreeBuilder builder;
+  builder.setFile("foo/bar/dir1/file.txt", "contents");
+  builder.setFile("foo/bar/dir2/file.txt", "contents");
+  builder.setFile("foo/bar/dir2/other.cpp", "contents");
+  TestMount mount{builder};
+  mount.updateEdenConfig({{"glob:use-suffix-query-cache", "true"}});
+  auto edenMount = mount.getEdenMount();
+  auto rootId = edenMount->getObjectStore()->renderRootId(
+      edenMount->getCheckedOutRootId());
+
+  GlobParams params;
+  params.revisions_ref() = {rootId};
+
+  auto first = ThriftGlobImpl{params}
+                   .glob(
+                       edenMount,
+                       mount.getServerState(),
+                       std::vector<std::string>{"**/*.txt"},
+                       ObjectFetchContext::getNullContext())
+                   .get();
+  EXPECT_EQ(
+      (std::vector<std::string>{
+          "foo/bar/dir1/file.txt", "foo/bar/dir2/file.txt"}),
+      *first->matchingFiles_ref());
+
+  // The second identical query is answered from the suffix query cache and
+  // must return the same results as the full walk.
+  auto second = ThriftGlobImpl{params}
+                    .glob(
+                        edenMount,
+                        mount.getServerState(),
+                        std::vector<std::string>{"**/*.txt"},
+                        ObjectFetchContext::getNullContext())
+                    .get();
+  EXPECT_EQ(*first->matchingFiles_ref(), *second->matchingFiles_ref());
+  EXPECT_EQ(*first->originHashes_ref(), *second->originHashes_ref());
+}
+
+TEST(ThriftGlobImplTest, testTreeEvaluationOnCleanWorkingCopy) {
+  FakeTreeBuilder builder;
+  builder.setFile("foo/bar/dir1/file.txt", "contents");
+  builder.setFile("foo/bar/dir2/file.txt", "contents");
+  TestMount mount{builder};
+  auto edenMount = mount.getEdenMount();
+  auto* inodeMap = edenMount->getInodeMap();
+
+  auto [loaded, unloaded] = getInodeCounters(inodeMap);
+
+  auto result = ThriftGlobImpl{GlobParams{}}
+                    .glob(
+                        edenMount,
+                        mount.getServerState(),
+                        std::vector<std::string>{"foo/bar/*"},
+                        ObjectFetchContext::getNullContext())
+                    .get();
+  EXPECT_EQ(
+      (std::vector<std::string>{"foo/bar/dir1", "foo/bar/dir2"}),
+      *result->matchingFiles_ref());
+
+  // The working copy is clean, so the glob was evaluated against raw Trees
+  // and must not have loaded or registered any inodes.
+  assertInodeCounters(inodeMap, loaded, unloaded);
+
+  // Once the working copy is materialized, the glob walks inodes again and
+  // reflects local modifications.
+  mount.addFile("foo/bar/untracked.txt", "new");
+  result = ThriftGlobImpl{GlobParams{}}
+               .glob(
+                   edenMount,
+                   mount.getServerState(),
+                   std::vector<std::string>{"foo/bar/*"},
+                   ObjectFetchContext::getNullContext())
+               .get();
+  EXPECT_EQ(
+      (std::vector<std::string>{
+          "foo/bar/dir1", "foo/bar/dir2", "foo/bar/untracked.txt"}),
+      *result->matchingFiles_ref());
+}
+
+TEST(ThriftGlobImplTest, testManagedPrefetchReportsProgress) {
+  auto serverState = createTestServerState();
+  FakeTreeBuilder builder;
+  builder.setFile("foo/bar/dir1/file.txt", "contents");
+  builder.setFile("foo/bar/dir2/file.txt", "contents");
+  TestMount mount{builder};
+
+  // PrefetchParams enable blob prefetching by default.
+  auto globber = ThriftGlobImpl{PrefetchParams{}};
+  auto progress = std::make_shared<PrefetchProgressState>();
+  folly::CancellationSource cancellationSource;
+  globber.setManagedPrefetch(progress, cancellationSource.getToken());
+
+  auto globFuture = globber.glob(
+      mount.getEdenMount(),
+      serverState,
+      std::vector<std::string>{"**/*.txt"},
+      ObjectFetchContext::getNullContext());
+  auto result = std::move(globFuture).get();
+
+  EXPECT_EQ(2, progress->totalBlobs.load());
+  EXPECT_EQ(2, progress->fetchedBlobs.load());
+}
+
+TEST(ThriftGlobImplTest, testManagedPrefetchStopsWhenCancelled) {
+  auto serverState = createTestServerState();
+  FakeTreeBuilder builder;
+  builder.setFile("foo/bar/dir1/file.txt", "contents");
+  TestMount mount{builder};
+
+  auto globber = ThriftGlobImpl{PrefetchParams{}};
+  auto progress = std::make_shared<PrefetchProgressState>();
+  folly::CancellationSource cancellationSource;
+  globber.setManagedPrefetch(progress, cancellationSource.getToken());
+  cancellationSource.requestCancellation();
+
+  auto globFuture = globber.glob(
+      mount.getEdenMount(),
+      serverState,
+      std::vector<std::string>{"**/*.txt"},
+      ObjectFetchContext::getNullContext());
+  EXPECT_THROW(std::move(globFuture).get(), EdenError);
+  EXPECT_EQ(0, progress->fetchedBlobs.load());
+}
+
 } // namespace facebook::eden
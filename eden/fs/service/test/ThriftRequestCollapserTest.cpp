@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/service/ThriftRequestCollapser.h"
+
+#include <folly/futures/Promise.h>
+#include <folly/portability/gtest.h>
+
+namespace facebook::eden {
+
+namespace {
+
+using Collapser = ThriftRequestCollapser<std::shared_ptr<int>>;
+
+Collapser::RequestKey makeKey(uint64_t argsHash, uint64_t journalSequence) {
+  return Collapser::RequestKey{
+      "/mount", "testMethod", argsHash, journalSequence};
+}
+
+} // namespace
+
+TEST(ThriftRequestCollapserTest, duplicateCallersAttachToOneComputation) {
+  auto stats = makeRefPtr<EdenStats>();
+  Collapser collapser;
+
+  folly::Promise<std::shared_ptr<int>> promise;
+  size_t computeCount = 0;
+
+  auto first = collapser.collapse(makeKey(1, 1), stats, [&] {
+    ++computeCount;
+    return ImmediateFuture<std::shared_ptr<int>>{promise.getSemiFuture()};
+  });
+  auto second = collapser.collapse(makeKey(1, 1), stats, [&] {
+    ++computeCount;
+    return ImmediateFuture<std::shared_ptr<int>>{promise.getSemiFuture()};
+  });
+
+  EXPECT_EQ(1, computeCount);
+  EXPECT_FALSE(first.isReady());
+  EXPECT_FALSE(second.isReady());
+
+  promise.setValue(std::make_shared<int>(42));
+  EXPECT_EQ(42, *std::move(first).get());
+  EXPECT_EQ(42, *std::move(second).get());
+}
+
+TEST(ThriftRequestCollapserTest, differentKeysComputeIndependently) {
+  auto stats = makeRefPtr<EdenStats>();
+  Collapser collapser;
+
+  folly::Promise<std::shared_ptr<int>> promise;
+  size_t computeCount = 0;
+
+  auto first = collapser.collapse(makeKey(1, 1), stats, [&] {
+    ++computeCount;
+    return ImmediateFuture<std::shared_ptr<int>>{promise.getSemiFuture()};
+  });
+  // Same arguments at a different journal position must not share a result.
+  auto second = collapser.collapse(makeKey(1, 2), stats, [&] {
+    ++computeCount;
+    return ImmediateFuture<std::shared_ptr<int>>{
+        std::make_shared<int>(17)};
+  });
+
+  EXPECT_EQ(2, computeCount);
+  EXPECT_EQ(17, *std::move(second).get());
+
+  promise.setValue(std::make_shared<int>(42));
+  EXPECT_EQ(42, *std::move(first).get());
+}
+
+TEST(ThriftRequestCollapserTest, completedComputationsAreNotCached) {
+  auto stats = makeRefPtr<EdenStats>();
+  Collapser collapser;
+
+  size_t computeCount = 0;
+  auto compute = [&] {
+    ++computeCount;
+    return ImmediateFuture<std::shared_ptr<int>>{std::make_shared<int>(42)};
+  };
+
+  EXPECT_EQ(42, *collapser.collapse(makeKey(1, 1), stats, compute).get());
+  EXPECT_EQ(42, *collapser.collapse(makeKey(1, 1), stats, compute).get());
+  EXPECT_EQ(2, computeCount);
+}
+
+TEST(ThriftRequestCollapserTest, errorsPropagateToAllCallers) {
+  auto stats = makeRefPtr<EdenStats>();
+  Collapser collapser;
+
+  folly::Promise<std::shared_ptr<int>> promise;
+
+  auto first = collapser.collapse(makeKey(1, 1), stats, [&] {
+    return ImmediateFuture<std::shared_ptr<int>>{promise.getSemiFuture()};
+  });
+  auto second = collapser.collapse(makeKey(1, 1), stats, [&] {
+    ADD_FAILURE() << "duplicate caller must not compute";
+    return ImmediateFuture<std::shared_ptr<int>>{promise.getSemiFuture()};
+  });
+
+  promise.setException(std::runtime_error{"diff failed"});
+  EXPECT_THROW(std::move(first).get(), std::runtime_error);
+  EXPECT_THROW(std::move(second).get(), std::runtime_error);
+
+  // A failed computation is removed from the in-flight map, so the next
+  // request computes again.
+  auto third = collapser.collapse(makeKey(1, 1), stats, [&] {
+    return ImmediateFuture<std::shared_ptr<int>>{std::make_shared<int>(7)};
+  });
+  EXPECT_EQ(7, *std::move(third).get());
+}
+
+} // namespace facebook::eden
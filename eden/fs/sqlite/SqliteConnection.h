@@ -18,6 +18,14 @@ enum class SqliteDbStatus { NOT_YET_OPENED, FAILED_TO_OPEN, OPEN, CLOSED };
 struct SqliteConnection {
   sqlite3* db{nullptr};
   SqliteDbStatus status{SqliteDbStatus::NOT_YET_OPENED};
+
+  /**
+   * True while a transaction opened via SqliteDatabase::beginTransaction()
+   * is outstanding on this connection.  SqliteDatabase::transaction() calls
+   * made in the meantime join that transaction instead of nesting BEGIN,
+   * which SQLite does not support.
+   */
+  bool inExplicitTransaction{false};
 };
 
 using LockedSqliteConnection = folly::Synchronized<SqliteConnection>::LockedPtr;
@@ -80,6 +80,42 @@ void SqliteDatabase::openDb() {
   cache_ = std::make_unique<StatementCache>(lockedState);
 }
 
+void SqliteDatabase::openReaderPool(size_t numReaders) {
+  {
+    auto lockedState = conn_.wlock();
+    if (lockedState->status != SqliteDbStatus::OPEN) {
+      throw std::runtime_error(
+          "the reader pool must be opened after the database itself");
+    }
+  }
+  if (dbPath_ == ":memory:") {
+    // An in-memory database is private to its connection; additional
+    // connections would see a different, empty database.
+    XLOG(DBG4) << "not opening a reader pool for an in-memory database";
+    return;
+  }
+  if (!readers_.empty()) {
+    throw std::runtime_error("the reader pool has already been opened");
+  }
+  for (size_t i = 0; i < numReaders; ++i) {
+    sqlite3* db = nullptr;
+    auto result =
+        sqlite3_open_v2(dbPath_.c_str(), &db, SQLITE_OPEN_READONLY, nullptr);
+    if (result != SQLITE_OK) {
+      // sqlite3_close handles nullptr fine
+      // @lint-ignore CLANGTIDY
+      sqlite3_close(db);
+      checkSqliteResult(nullptr, result);
+    }
+    auto reader = std::make_unique<folly::Synchronized<SqliteConnection>>();
+    auto lockedReader = reader->wlock();
+    lockedReader->db = db;
+    lockedReader->status = SqliteDbStatus::OPEN;
+    lockedReader.unlock();
+    readers_.push_back(std::move(reader));
+  }
+}
+
 void SqliteDatabase::close() {
   auto db = conn_.wlock();
   db->status = SqliteDbStatus::CLOSED;
@@ -91,6 +127,14 @@ void SqliteDatabase::close() {
     sqlite3_close(db->db);
     db->db = nullptr;
   }
+  for (auto& reader : readers_) {
+    auto lockedReader = reader->wlock();
+    lockedReader->status = SqliteDbStatus::CLOSED;
+    if (lockedReader->db) {
+      sqlite3_close(lockedReader->db);
+      lockedReader->db = nullptr;
+    }
+  }
 }
 
 SqliteDatabase::~SqliteDatabase() {
@@ -115,9 +159,40 @@ LockedSqliteConnection SqliteDatabase::lock() {
   return db;
 }
 
+LockedSqliteConnection SqliteDatabase::lockForRead() {
+  if (readers_.empty()) {
+    return lock();
+  }
+  auto start = nextReader_.fetch_add(1, std::memory_order_relaxed);
+  // Prefer an uncontended reader so concurrent readers spread across the
+  // pool instead of queueing behind each other.
+  for (size_t i = 0; i < readers_.size(); ++i) {
+    if (auto reader = readers_[(start + i) % readers_.size()]->tryWLock()) {
+      if (reader->status == SqliteDbStatus::OPEN) {
+        return reader;
+      }
+      throw std::runtime_error(
+          "the SqliteDatabase database has already been closed");
+    }
+  }
+  // Every reader is busy; wait on our round-robin slot.
+  auto reader = readers_[start % readers_.size()]->wlock();
+  if (reader->status != SqliteDbStatus::OPEN) {
+    throw std::runtime_error(
+        "the SqliteDatabase database has already been closed");
+  }
+  return reader;
+}
+
 void SqliteDatabase::transaction(
     const std::function<void(LockedSqliteConnection&)>& func) {
   auto conn = lock();
+  if (conn->inExplicitTransaction) {
+    // Join the transaction opened by beginTransaction(); it is committed or
+    // rolled back by whoever opened it.
+    func(conn);
+    return;
+  }
   try {
     cache_->beginTransaction.get(conn)->step();
     func(conn);
@@ -129,6 +204,40 @@ void SqliteDatabase::transaction(
   }
 }
 
+void SqliteDatabase::beginTransaction() {
+  auto conn = lock();
+  if (conn->inExplicitTransaction) {
+    throw std::runtime_error("a SQLite transaction is already open");
+  }
+  cache_->beginTransaction.get(conn)->step();
+  conn->inExplicitTransaction = true;
+}
+
+void SqliteDatabase::commitTransaction() {
+  auto conn = lock();
+  if (!conn->inExplicitTransaction) {
+    throw std::runtime_error("no SQLite transaction is open");
+  }
+  try {
+    cache_->commitTransaction.get(conn)->step();
+    conn->inExplicitTransaction = false;
+  } catch (const std::exception& ex) {
+    cache_->rollbackTransaction.get(conn)->step();
+    conn->inExplicitTransaction = false;
+    XLOG(WARN) << "SQLite transaction failed to commit: " << ex.what();
+    throw;
+  }
+}
+
+void SqliteDatabase::rollbackTransaction() {
+  auto conn = lock();
+  if (!conn->inExplicitTransaction) {
+    throw std::runtime_error("no SQLite transaction is open");
+  }
+  conn->inExplicitTransaction = false;
+  cache_->rollbackTransaction.get(conn)->step();
+}
+
 void SqliteDatabase::checkpoint() {
   if (auto conn = conn_.tryWLock()) {
     XLOG(DBG6) << "Checkpoint thread acquired SQLite lock";
@@ -150,4 +259,21 @@ void SqliteDatabase::checkpoint() {
     XLOG(DBG6) << "Checkpoint skipped: write lock is held by other threads";
   }
 }
+
+void SqliteDatabase::incrementalVacuum(uint64_t pages) {
+  if (auto conn = conn_.tryWLock()) {
+    try {
+      auto query = fmt::format("PRAGMA incremental_vacuum({})", pages);
+      checkSqliteResult(
+          conn->db,
+          sqlite3_exec(conn->db, query.c_str(), nullptr, nullptr, nullptr));
+      XLOG(DBG6) << "Incremental vacuum completed";
+    } catch (const std::exception&) {
+      // Exception is logged in `checkSqliteResult`
+    }
+  } else {
+    XLOG(DBG6)
+        << "Incremental vacuum skipped: write lock is held by other threads";
+  }
+}
 } // namespace facebook::eden
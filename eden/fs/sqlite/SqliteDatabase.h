@@ -9,6 +9,9 @@
 
 #include <folly/Synchronized.h>
 #include <sqlite3.h>
+#include <atomic>
+#include <memory>
+#include <vector>
 
 #include "eden/fs/sqlite/SqliteConnection.h"
 #include "eden/fs/utils/PathFuncs.h"
@@ -77,6 +80,29 @@ class SqliteDatabase {
    */
   LockedSqliteConnection lock();
 
+  /**
+   * Open numReaders additional read-only connections to the database for use
+   * by lockForRead().
+   *
+   * Parallel readers rely on SQLite WAL mode, so this must be called after
+   * openDb() once the caller has configured the journal mode.  It is
+   * incompatible with locking_mode=EXCLUSIVE, which prevents any other
+   * connection from reading the database.  In-memory databases are private
+   * to their connection and never get a reader pool.
+   */
+  void openReaderPool(size_t numReaders);
+
+  /**
+   * Obtain a connection suitable for a read-only query without waiting on
+   * writers.  Prefers an uncontended connection from the reader pool; when
+   * openReaderPool() was never called this falls back to lock().
+   *
+   * Statements prepared against one connection may not be used with
+   * another, so cached PersistentSqliteStatement instances built against
+   * the main connection cannot be executed on the returned connection.
+   */
+  LockedSqliteConnection lockForRead();
+
   /**
    * Executes a SQLite transaction. If the lambda body throws any error, the
    * transaction will be rolled back. This function returns a boolean to
@@ -93,8 +119,36 @@ class SqliteDatabase {
    */
   void transaction(const std::function<void(LockedSqliteConnection&)>& func);
 
+  /**
+   * Open a transaction that spans multiple calls on the main connection,
+   * for coalescing a group of writes into one commit.  Until
+   * commitTransaction() or rollbackTransaction() is called, transaction()
+   * invocations join the open transaction instead of committing on their
+   * own; their writes become durable together at commitTransaction().
+   *
+   * The connection lock is not held in between, so reads on the same
+   * connection may observe the uncommitted writes, matching SQLite
+   * same-connection semantics.
+   */
+  void beginTransaction();
+
+  /** Commit the transaction opened by beginTransaction(). */
+  void commitTransaction();
+
+  /** Roll back the transaction opened by beginTransaction(). */
+  void rollbackTransaction();
+
   void checkpoint();
 
+  /**
+   * Reclaim up to `pages` free pages from the database file (0 reclaims all
+   * of them). Only has an effect when the database was created with
+   * auto_vacuum=INCREMENTAL; otherwise this is a no-op. Like checkpoint(),
+   * this skips the work if another thread holds the connection so it can be
+   * called opportunistically from maintenance.
+   */
+  void incrementalVacuum(uint64_t pages = 0);
+
  private:
   struct StatementCache;
 
@@ -104,6 +158,14 @@ class SqliteDatabase {
 
   folly::Synchronized<SqliteConnection> conn_;
 
+  /**
+   * Read-only connections handed out by lockForRead(), empty unless
+   * openReaderPool() was called.  The vector itself is only mutated while
+   * opening and closing the database.
+   */
+  std::vector<std::unique_ptr<folly::Synchronized<SqliteConnection>>> readers_;
+  std::atomic<uint64_t> nextReader_{0};
+
   std::unique_ptr<StatementCache> cache_;
 };
 } // namespace facebook::eden
@@ -13,6 +13,7 @@
 #include "eden/fs/sqlite/PersistentSqliteStatement.h"
 #include "eden/fs/sqlite/SqliteDatabase.h"
 #include "eden/fs/sqlite/SqliteStatement.h"
+#include "eden/fs/testharness/TempFile.h"
 
 namespace facebook::eden {
 
@@ -81,4 +82,42 @@ TEST_F(SqliteTest, testPersistentSqliteStatement) {
     exec->step();
   }
 }
+
+TEST(SqliteReaderPoolTest, readersSeeCommittedWrites) {
+  auto tempDir = makeTempDir();
+  auto dbPath = canonicalPath(tempDir.path().string()) + "test.db"_pc;
+  SqliteDatabase db{dbPath.piece()};
+  {
+    auto conn = db.lock();
+    SqliteStatement(conn, "PRAGMA journal_mode=WAL").step();
+    SqliteStatement(conn, "CREATE TABLE test (id INTEGER PRIMARY KEY)").step();
+  }
+  db.openReaderPool(2);
+
+  {
+    auto conn = db.lock();
+    SqliteStatement(conn, "INSERT INTO test (id) VALUES (1)").step();
+  }
+
+  // Issue more reads than there are pooled connections so the fallback to a
+  // busy reader slot is exercised too.
+  for (int i = 0; i < 4; ++i) {
+    auto conn = db.lockForRead();
+    SqliteStatement stmt{conn, "SELECT count(*) FROM test"};
+    ASSERT_TRUE(stmt.step());
+    EXPECT_EQ(1, stmt.columnUint64(0));
+  }
+}
+
+TEST(SqliteReaderPoolTest, inMemoryDatabaseFallsBackToMainConnection) {
+  // An in-memory database is private to its connection, so no reader pool is
+  // created and lockForRead() uses the main connection.
+  SqliteDatabase db{SqliteDatabase::inMemory};
+  db.openReaderPool(2);
+
+  auto conn = db.lockForRead();
+  SqliteStatement stmt{conn, "SELECT 1"};
+  ASSERT_TRUE(stmt.step());
+  EXPECT_EQ(1, stmt.columnUint64(0));
+}
 } // namespace facebook::eden
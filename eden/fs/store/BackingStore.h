@@ -166,6 +166,19 @@ class BackingStore : public RootIdCodec, public ObjectIdCodec {
 
   virtual void periodicManagementTask() {}
 
+  /**
+   * Number of object fetch requests queued inside this BackingStore that
+   * have not started being serviced yet.
+   *
+   * This is used as a backpressure signal by speculative work such as
+   * readdir tree prefetching, so that background fetches back off while
+   * interactive fetches are already waiting on the store. Stores that
+   * service requests inline and never queue them can keep the default of 0.
+   */
+  virtual size_t getPendingImportCount() const {
+    return 0;
+  }
+
   /**
    * Subclass of BackingStore will override these functions to record file
    * paths fetched. After startRecordingFetch() is called, the BackingStore
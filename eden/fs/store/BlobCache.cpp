@@ -6,29 +6,99 @@
  */
 
 #include "eden/fs/store/BlobCache.h"
+#include <folly/compression/Compression.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <folly/executors/thread_factory/NamedThreadFactory.h>
 #include "eden/fs/config/EdenConfig.h"
 #include "eden/fs/config/ReloadableConfig.h"
 
 namespace facebook::eden {
 
+namespace {
+std::shared_ptr<folly::Executor> makeEvictionExecutor(
+    const EdenConfig& config) {
+  if (!config.inMemoryBlobCacheBackgroundEviction.getValue()) {
+    return nullptr;
+  }
+  return std::make_shared<folly::CPUThreadPoolExecutor>(
+      1, std::make_shared<folly::NamedThreadFactory>("BlobCacheEvict"));
+}
+} // namespace
+
 BlobCache::BlobCache(
     PrivateTag,
     std::shared_ptr<ReloadableConfig> config,
     EdenStatsPtr stats)
-    : BlobCache{
-          PrivateTag{},
+    : ObjectCache<Blob, ObjectCacheFlavor::InterestHandle>{
           config->getEdenConfig()->inMemoryBlobCacheSize.getValue(),
           config->getEdenConfig()->inMemoryBlobCacheMinimumItems.getValue(),
-          std::move(stats)} {}
+          config->getEdenConfig()->inMemoryBlobCacheShards.getValue(),
+          0,
+          makeEvictionExecutor(*config->getEdenConfig())},
+      stats_{std::move(stats)} {
+  auto victimSize = config->getEdenConfig()
+                        ->inMemoryBlobCacheCompressedVictimSize.getValue();
+  if (victimSize > 0) {
+    enableCompressedVictimCache(victimSize);
+  }
+}
 
 BlobCache::BlobCache(
     PrivateTag,
     size_t maximumSize,
     size_t minimumCount,
+    size_t compressedVictimCacheSize,
     EdenStatsPtr stats)
     : ObjectCache<
           Blob,
           ObjectCacheFlavor::InterestHandle>{maximumSize, minimumCount},
-      stats_{std::move(stats)} {}
+      stats_{std::move(stats)} {
+  if (compressedVictimCacheSize > 0) {
+    enableCompressedVictimCache(compressedVictimCacheSize);
+  }
+}
+
+BlobCache::~BlobCache() = default;
+
+void BlobCache::enableCompressedVictimCache(size_t maximumSizeBytes) {
+  victimCache_ =
+      ObjectCache<CompressedBlob, ObjectCacheFlavor::Simple>::create(
+          maximumSizeBytes, 0);
+  codec_ = folly::io::getCodec(folly::io::CodecType::ZSTD);
+  // Only capacity evictions land here, not interest-handle drops or clear():
+  // a blob squeezed out to make room is likely still wanted, while a dropped
+  // one is not. The callback runs under this cache's shard lock and only
+  // touches the separately-locked victim tier, so it cannot reenter.
+  setEvictionCallback([this](const ObjectId& id, const ObjectPtr& blob) {
+    auto compressed = codec_->compress(&blob->getContents());
+    victimCache_->insertSimple(
+        id,
+        std::make_shared<const CompressedBlob>(
+            std::move(*compressed), blob->getSize()));
+  });
+}
+
+BlobCache::GetResult BlobCache::get(const ObjectId& hash, Interest interest) {
+  auto handle = getInterestHandle(hash, interest);
+  if (handle.object) {
+    stats_->increment(&ObjectStoreStats::getBlobFromMemory);
+    return handle;
+  }
+  if (victimCache_) {
+    if (auto compressed = victimCache_->getSimple(hash)) {
+      auto uncompressed = codec_->uncompress(
+          &compressed->getCompressedContents(),
+          compressed->getUncompressedSize());
+      auto blob = std::make_shared<const Blob>(std::move(*uncompressed));
+      // Promote back into the uncompressed tier. The compressed copy stays
+      // in the victim tier: re-inserting it on a later eviction is a no-op,
+      // which saves recompressing a blob that ping-pongs between tiers.
+      auto interestHandle = insertInterestHandle(hash, blob, interest);
+      stats_->increment(&ObjectStoreStats::getBlobFromCompressedMemory);
+      return GetResult{std::move(blob), std::move(interestHandle)};
+    }
+  }
+  return handle;
+}
 
 } // namespace facebook::eden
@@ -11,12 +11,47 @@
 #include "eden/fs/store/ObjectCache.h"
 #include "eden/fs/telemetry/EdenStats.h"
 
+namespace folly::io {
+class Codec;
+} // namespace folly::io
+
 namespace facebook::eden {
 
 class ReloadableConfig;
 
 using BlobInterestHandle = ObjectInterestHandle<Blob>;
 
+/**
+ * A zstd-compressed copy of a blob evicted from BlobCache, held by its
+ * optional second-chance tier. Budget accounting uses the compressed
+ * footprint, so the tier holds roughly a compression-ratio multiple of the
+ * blobs a same-sized uncompressed cache would.
+ */
+class CompressedBlob {
+ public:
+  CompressedBlob(folly::IOBuf compressed, size_t uncompressedSize)
+      : compressed_{std::move(compressed)},
+        compressedSize_{compressed_.computeChainDataLength()},
+        uncompressedSize_{uncompressedSize} {}
+
+  const folly::IOBuf& getCompressedContents() const {
+    return compressed_;
+  }
+
+  size_t getUncompressedSize() const {
+    return uncompressedSize_;
+  }
+
+  size_t getSizeBytes() const {
+    return compressedSize_;
+  }
+
+ private:
+  const folly::IOBuf compressed_;
+  const size_t compressedSize_;
+  const size_t uncompressedSize_;
+};
+
 /**
  * An in-memory LRU cache for loaded blobs. It is parameterized by both a
  * maximum cache size and a minimum entry count. The cache tries to evict
@@ -42,7 +77,19 @@ class BlobCache : public ObjectCache<Blob, ObjectCacheFlavor::InterestHandle> {
   static std::shared_ptr<BlobCache>
   create(size_t maximumSize, size_t minimumCount, EdenStatsPtr stats) {
     return std::make_shared<BlobCache>(
-        PrivateTag{}, maximumSize, minimumCount, std::move(stats));
+        PrivateTag{}, maximumSize, minimumCount, 0, std::move(stats));
+  }
+  static std::shared_ptr<BlobCache> create(
+      size_t maximumSize,
+      size_t minimumCount,
+      size_t compressedVictimCacheSize,
+      EdenStatsPtr stats) {
+    return std::make_shared<BlobCache>(
+        PrivateTag{},
+        maximumSize,
+        minimumCount,
+        compressedVictimCacheSize,
+        std::move(stats));
   }
 
   explicit BlobCache(
@@ -53,8 +100,9 @@ class BlobCache : public ObjectCache<Blob, ObjectCacheFlavor::InterestHandle> {
       PrivateTag,
       size_t maximumSize,
       size_t minimumCount,
+      size_t compressedVictimCacheSize,
       EdenStatsPtr stats);
-  ~BlobCache() = default;
+  ~BlobCache();
 
   /**
    * If a blob for the given hash is in cache, return it. If the blob is not in
@@ -70,13 +118,7 @@ class BlobCache : public ObjectCache<Blob, ObjectCacheFlavor::InterestHandle> {
    */
   GetResult get(
       const ObjectId& hash,
-      Interest interest = Interest::LikelyNeededAgain) {
-    auto handle = getInterestHandle(hash, interest);
-    if (handle.object) {
-      stats_->increment(&ObjectStoreStats::getBlobFromMemory);
-    }
-    return handle;
-  }
+      Interest interest = Interest::LikelyNeededAgain);
 
   /**
    * Inserts a blob into the cache for future lookup. If the new total size
@@ -85,6 +127,10 @@ class BlobCache : public ObjectCache<Blob, ObjectCacheFlavor::InterestHandle> {
    *
    * Optionally returns an interest handle that, when dropped, evicts the
    * inserted blob.
+   *
+   * Inserts with UnlikelyNeededAgain interest may be bypassed when recent
+   * inserts of that class have mostly been evicted unused; see the
+   * speculative waste gate in ObjectCache.
    */
   BlobInterestHandle insert(
       ObjectId id,
@@ -94,7 +140,28 @@ class BlobCache : public ObjectCache<Blob, ObjectCacheFlavor::InterestHandle> {
   }
 
  private:
+  /**
+   * Sets up the compressed second-chance tier: blobs evicted from this cache
+   * to make room are compressed into the tier's separate byte budget, and a
+   * later get() that misses here decompresses and re-promotes them.
+   * Source-file blobs routinely compress around 3:1, so the tier roughly
+   * triples effective cache capacity per byte, and decompressing on a hit is
+   * far cheaper than refetching the blob from the backing store.
+   */
+  void enableCompressedVictimCache(size_t maximumSizeBytes);
+
   EdenStatsPtr stats_;
+
+  /**
+   * Optional compressed tier holding recently evicted blobs; null when
+   * disabled. See enableCompressedVictimCache().
+   */
+  std::shared_ptr<ObjectCache<CompressedBlob, ObjectCacheFlavor::Simple>>
+      victimCache_;
+
+  /// zstd codec shared by the eviction callback and get(); only set when
+  /// victimCache_ is.
+  std::unique_ptr<folly::io::Codec> codec_;
 };
 
 } // namespace facebook::eden
@@ -10,6 +10,7 @@
 #include <folly/Portability.h>
 #include <folly/Synchronized.h>
 #include <folly/logging/xlog.h>
+#include <atomic>
 #include <memory>
 #include <vector>
 
@@ -17,9 +18,11 @@
 #include "eden/fs/model/Tree.h"
 #include "eden/fs/model/TreeEntry.h"
 #include "eden/fs/store/BackingStore.h"
+#include "eden/fs/store/DiffCallback.h"
 #include "eden/fs/store/DiffContext.h"
 #include "eden/fs/store/ObjectStore.h"
 #include "eden/fs/store/ScmStatusDiffCallback.h"
+#include "eden/fs/store/TreeDiffMemoCache.h"
 #include "eden/fs/utils/ImmediateFuture.h"
 #include "eden/fs/utils/PathFuncs.h"
 
@@ -47,6 +50,23 @@ struct TreeAndId {
   }
 };
 
+FOLLY_NODISCARD ImmediateFuture<Unit> diffTreePairWithMemo(
+    DiffContext* context,
+    DiffCallback& callback,
+    RelativePathPiece currentPath,
+    const ObjectId& scmHash,
+    const ObjectId& wdHash);
+FOLLY_NODISCARD ImmediateFuture<Unit> diffAddedTree(
+    DiffContext* context,
+    DiffCallback& callback,
+    RelativePathPiece currentPath,
+    ObjectId wdHash);
+FOLLY_NODISCARD ImmediateFuture<Unit> diffRemovedTree(
+    DiffContext* context,
+    DiffCallback& callback,
+    RelativePathPiece currentPath,
+    ObjectId scmHash);
+
 struct ChildFutures {
   void add(RelativePath&& path, ImmediateFuture<Unit>&& future) {
     paths.emplace_back(std::move(path));
@@ -66,11 +86,12 @@ struct ChildFutures {
  */
 void processRemovedSide(
     DiffContext* context,
+    DiffCallback& callback,
     ChildFutures& childFutures,
     RelativePathPiece currentPath,
     const Tree::value_type& scmEntry) {
   auto entryPath = currentPath + scmEntry.first;
-  context->callback->removedPath(
+  callback.removedPath(
       entryPath,
       filteredEntryDtype(
           scmEntry.second.getDtype(), context->getWindowsSymlinksEnabled()));
@@ -78,7 +99,7 @@ void processRemovedSide(
     return;
   }
   auto childFuture =
-      diffRemovedTree(context, entryPath, scmEntry.second.getHash());
+      diffRemovedTree(context, callback, entryPath, scmEntry.second.getHash());
   childFutures.add(std::move(entryPath), std::move(childFuture));
 }
 
@@ -91,19 +112,20 @@ void processRemovedSide(
  */
 void processAddedSide(
     DiffContext* context,
+    DiffCallback& callback,
     ChildFutures& childFutures,
     RelativePathPiece currentPath,
     const Tree::value_type& wdEntry) {
   auto entryPath = currentPath + wdEntry.first;
   bool windowsSymlinksEnabled = context->getWindowsSymlinksEnabled();
 
-  context->callback->addedPath(
+  callback.addedPath(
       entryPath,
       filteredEntryDtype(wdEntry.second.getDtype(), windowsSymlinksEnabled));
 
   if (wdEntry.second.isTree()) {
     auto childFuture =
-        diffAddedTree(context, entryPath, wdEntry.second.getHash());
+        diffAddedTree(context, callback, entryPath, wdEntry.second.getHash());
     childFutures.add(std::move(entryPath), std::move(childFuture));
   }
 }
@@ -113,6 +135,7 @@ void processAddedSide(
  */
 void processBothPresent(
     DiffContext* context,
+    DiffCallback& callback,
     ChildFutures& childFutures,
     RelativePathPiece currentPath,
     const Tree::value_type& scmEntry,
@@ -130,9 +153,10 @@ void processBothPresent(
               scmEntry.second.getHash(), wdEntry.second.getHash())) {
         return;
       }
-      context->callback->modifiedPath(entryPath, wdEntry.second.getDtype());
-      auto childFuture = diffTrees(
+      callback.modifiedPath(entryPath, wdEntry.second.getDtype());
+      auto childFuture = diffTreePairWithMemo(
           context,
+          callback,
           entryPath,
           scmEntry.second.getHash(),
           wdEntry.second.getHash());
@@ -140,30 +164,30 @@ void processBothPresent(
     } else {
       // tree-to-file
       // Add a ADDED entry for this path and a removal of the directory
-      context->callback->addedPath(
+      callback.addedPath(
           entryPath,
           filteredEntryDtype(
               wdEntry.second.getDtype(), windowsSymlinksEnabled));
 
       // Report everything in scmTree as REMOVED
-      context->callback->removedPath(entryPath, scmEntry.second.getDtype());
-      auto childFuture =
-          diffRemovedTree(context, entryPath, scmEntry.second.getHash());
+      callback.removedPath(entryPath, scmEntry.second.getDtype());
+      auto childFuture = diffRemovedTree(
+          context, callback, entryPath, scmEntry.second.getHash());
       childFutures.add(std::move(entryPath), std::move(childFuture));
     }
   } else {
     if (isTreeWD) {
       // file-to-tree
       // Add a REMOVED entry for this path
-      context->callback->removedPath(
+      callback.removedPath(
           entryPath,
           filteredEntryDtype(
               scmEntry.second.getDtype(), windowsSymlinksEnabled));
 
       // Report everything in wdEntry as ADDED
-      context->callback->addedPath(entryPath, wdEntry.second.getDtype());
+      callback.addedPath(entryPath, wdEntry.second.getDtype());
       auto childFuture =
-          diffAddedTree(context, entryPath, wdEntry.second.getHash());
+          diffAddedTree(context, callback, entryPath, wdEntry.second.getHash());
       childFutures.add(std::move(entryPath), std::move(childFuture));
     } else {
       // file-to-file diff
@@ -187,12 +211,12 @@ void processBothPresent(
                     wdEntry.second.getHash(),
                     context->getFetchContext())
                 .thenValue([entryPath = entryPath.copy(),
-                            context,
+                            &callback,
                             dtype = filteredEntryDtype(
                                 scmEntry.second.getDtype(),
                                 windowsSymlinksEnabled)](bool equal) {
                   if (!equal) {
-                    context->callback->modifiedPath(entryPath, dtype);
+                    callback.modifiedPath(entryPath, dtype);
                   }
                 });
         childFutures.add(std::move(entryPath), std::move(compareEntryContents));
@@ -202,11 +226,11 @@ void processBothPresent(
 }
 
 FOLLY_NODISCARD ImmediateFuture<Unit> waitOnResults(
-    DiffContext* context,
+    DiffCallback& callback,
     ChildFutures&& childFutures) {
   XDCHECK_EQ(childFutures.paths.size(), childFutures.futures.size());
   return collectAll(std::move(childFutures.futures))
-      .thenValue([context, paths = std::move(childFutures.paths)](
+      .thenValue([&callback, paths = std::move(childFutures.paths)](
                      vector<Try<Unit>>&& results) {
         XDCHECK_EQ(paths.size(), results.size());
         for (size_t idx = 0; idx < results.size(); ++idx) {
@@ -215,7 +239,7 @@ FOLLY_NODISCARD ImmediateFuture<Unit> waitOnResults(
             continue;
           }
           XLOG(ERR) << "error computing SCM diff for " << paths.at(idx);
-          context->callback->diffError(paths.at(idx), result.exception());
+          callback.diffError(paths.at(idx), result.exception());
         }
       });
 }
@@ -230,6 +254,7 @@ FOLLY_NODISCARD ImmediateFuture<Unit> waitOnResults(
  */
 FOLLY_NODISCARD ImmediateFuture<Unit> computeTreeDiff(
     DiffContext* context,
+    DiffCallback& callback,
     RelativePathPiece currentPath,
     TreePtr scmTree,
     TreePtr wdTree) {
@@ -250,35 +275,37 @@ FOLLY_NODISCARD ImmediateFuture<Unit> computeTreeDiff(
         break;
       }
       // This entry is present in wdTree but not scmTree
-      processAddedSide(context, childFutures, currentPath, *wdIter);
+      processAddedSide(context, callback, childFutures, currentPath, *wdIter);
       ++wdIter;
     } else if (wdIter == wdEnd) {
       // This entry is present in scmTree but not wdTree
-      processRemovedSide(context, childFutures, currentPath, *scmIter);
+      processRemovedSide(context, callback, childFutures, currentPath, *scmIter);
       ++scmIter;
     } else {
       auto compare = comparePathPiece(
           scmIter->first, wdIter->first, context->getCaseSensitive());
       if (compare == CompareResult::BEFORE) {
-        processRemovedSide(context, childFutures, currentPath, *scmIter);
+        processRemovedSide(
+            context, callback, childFutures, currentPath, *scmIter);
         ++scmIter;
       } else if (compare == CompareResult::AFTER) {
-        processAddedSide(context, childFutures, currentPath, *wdIter);
+        processAddedSide(context, callback, childFutures, currentPath, *wdIter);
         ++wdIter;
       } else {
         processBothPresent(
-            context, childFutures, currentPath, *scmIter, *wdIter);
+            context, callback, childFutures, currentPath, *scmIter, *wdIter);
         ++scmIter;
         ++wdIter;
       }
     }
   }
 
-  return waitOnResults(context, std::move(childFutures));
+  return waitOnResults(callback, std::move(childFutures));
 }
 
 FOLLY_NODISCARD ImmediateFuture<Unit> diffTrees(
     DiffContext* context,
+    DiffCallback& callback,
     RelativePathPiece currentPath,
     TreePtr scmTree,
     TreePtr wdTree) {
@@ -289,11 +316,12 @@ FOLLY_NODISCARD ImmediateFuture<Unit> diffTrees(
   }
 
   return computeTreeDiff(
-      context, currentPath, std::move(scmTree), std::move(wdTree));
+      context, callback, currentPath, std::move(scmTree), std::move(wdTree));
 }
 
 FOLLY_NODISCARD ImmediateFuture<Unit> diffTrees(
     DiffContext* context,
+    DiffCallback& callback,
     RelativePathPiece currentPath,
     ImmediateFuture<TreeAndId> scmFuture,
     ImmediateFuture<TreeAndId> wdFuture) {
@@ -306,6 +334,7 @@ FOLLY_NODISCARD ImmediateFuture<Unit> diffTrees(
   return std::move(treesFuture)
       .thenValue(
           [context,
+           &callback,
            copiedCurrentPath = std::move(copiedCurrentPath),
            currentPath](std::tuple<TreeAndId, TreeAndId> tup)
               -> ImmediateFuture<folly::Unit> {
@@ -326,6 +355,7 @@ FOLLY_NODISCARD ImmediateFuture<Unit> diffTrees(
                 : currentPath;
             return diffTrees(
                 context,
+                callback,
                 pathPiece,
                 std::move(scmTree.tree),
                 std::move(wdTree.tree));
@@ -339,6 +369,187 @@ ImmediateFuture<TreeAndId> getTreeAndId(DiffContext* context, ObjectId id) {
       });
 }
 
+/**
+ * Forwards every event to the wrapped callback while also recording it
+ * relative to the root of the subtree pair being diffed, so the finished
+ * result can be stored in the TreeDiffMemoCache and replayed later under a
+ * different path prefix.
+ *
+ * Recording is abandoned (though forwarding continues) if the subtree
+ * reports an error or produces an unreasonably large result.
+ */
+class MemoizingDiffCallback : public DiffCallback {
+ public:
+  MemoizingDiffCallback(DiffCallback& inner, RelativePath prefix)
+      : inner_{inner}, prefix_{std::move(prefix)} {}
+
+  void ignoredPath(RelativePathPiece path, dtype_t type) override {
+    // Pure tree-pair diffs never consult ignore rules, so nothing should
+    // reach here; forward without recording to stay conservative.
+    usable_.store(false, std::memory_order_relaxed);
+    inner_.ignoredPath(path, type);
+  }
+
+  void addedPath(RelativePathPiece path, dtype_t type) override {
+    record(TreeDiffMemoCache::ChangeType::Added, path, type);
+    inner_.addedPath(path, type);
+  }
+
+  void removedPath(RelativePathPiece path, dtype_t type) override {
+    record(TreeDiffMemoCache::ChangeType::Removed, path, type);
+    inner_.removedPath(path, type);
+  }
+
+  void modifiedPath(RelativePathPiece path, dtype_t type) override {
+    record(TreeDiffMemoCache::ChangeType::Modified, path, type);
+    inner_.modifiedPath(path, type);
+  }
+
+  void diffError(RelativePathPiece path, const folly::exception_wrapper& ew)
+      override {
+    usable_.store(false, std::memory_order_relaxed);
+    inner_.diffError(path, ew);
+  }
+
+  /**
+   * Returns the recorded entries, or null if the result must not be
+   * memoized.
+   */
+  TreeDiffMemoCache::Result extractResult() {
+    if (!usable_.load(std::memory_order_relaxed)) {
+      return nullptr;
+    }
+    return std::make_shared<const std::vector<TreeDiffMemoCache::Entry>>(
+        std::move(*entries_.wlock()));
+  }
+
+ private:
+  void record(
+      TreeDiffMemoCache::ChangeType change,
+      RelativePathPiece path,
+      dtype_t type) {
+    auto view = path.view();
+    if (!prefix_.empty()) {
+      // Strip "<prefix>/"; every reported path lives under the subtree.
+      if (view.size() <= prefix_.view().size() ||
+          view.substr(0, prefix_.view().size()) != prefix_.view()) {
+        usable_.store(false, std::memory_order_relaxed);
+        return;
+      }
+      view = view.substr(prefix_.view().size() + 1);
+    }
+    auto entries = entries_.wlock();
+    if (entries->size() >= kMaxEntries) {
+      // Hanging a huge result off one LRU slot defeats the point of a
+      // bounded memo; let pathological subtrees recompute instead.
+      usable_.store(false, std::memory_order_relaxed);
+      return;
+    }
+    entries->emplace_back(
+        TreeDiffMemoCache::Entry{RelativePath{view}, change, type});
+  }
+
+  static constexpr size_t kMaxEntries = 4096;
+
+  DiffCallback& inner_;
+  const RelativePath prefix_;
+  std::atomic<bool> usable_{true};
+  folly::Synchronized<std::vector<TreeDiffMemoCache::Entry>> entries_;
+};
+
+void replayMemoizedDiff(
+    DiffCallback& callback,
+    RelativePathPiece currentPath,
+    const std::vector<TreeDiffMemoCache::Entry>& entries) {
+  for (const auto& entry : entries) {
+    auto path = currentPath + entry.path;
+    switch (entry.change) {
+      case TreeDiffMemoCache::ChangeType::Added:
+        callback.addedPath(path, entry.dtype);
+        break;
+      case TreeDiffMemoCache::ChangeType::Removed:
+        callback.removedPath(path, entry.dtype);
+        break;
+      case TreeDiffMemoCache::ChangeType::Modified:
+        callback.modifiedPath(path, entry.dtype);
+        break;
+    }
+  }
+}
+
+/**
+ * Diff the trees with the given ids, consulting the DiffContext's memo cache
+ * when it has one. A hit replays the stored differences without loading
+ * either tree; a miss runs the diff under a recording callback and stores
+ * the finished result.
+ */
+FOLLY_NODISCARD ImmediateFuture<Unit> diffTreePairWithMemo(
+    DiffContext* context,
+    DiffCallback& callback,
+    RelativePathPiece currentPath,
+    const ObjectId& scmHash,
+    const ObjectId& wdHash) {
+  const auto& memo = context->getDiffMemoCache();
+  if (!memo) {
+    return diffTrees(
+        context,
+        callback,
+        currentPath,
+        getTreeAndId(context, scmHash),
+        getTreeAndId(context, wdHash));
+  }
+
+  if (auto cached = memo->get(scmHash, wdHash)) {
+    replayMemoizedDiff(callback, currentPath, *cached);
+    return folly::unit;
+  }
+
+  auto recorder =
+      std::make_shared<MemoizingDiffCallback>(callback, currentPath.copy());
+  return diffTrees(
+             context,
+             *recorder,
+             currentPath,
+             getTreeAndId(context, scmHash),
+             getTreeAndId(context, wdHash))
+      .thenValue([context, memo, recorder, scmHash, wdHash](Unit) {
+        // A cancelled walk returned early; its truncated output must not be
+        // replayed for anybody else.
+        if (!context->isCancelled()) {
+          if (auto result = recorder->extractResult()) {
+            memo->put(scmHash, wdHash, std::move(result));
+          }
+        }
+        return folly::unit;
+      });
+}
+
+FOLLY_NODISCARD ImmediateFuture<Unit> diffAddedTree(
+    DiffContext* context,
+    DiffCallback& callback,
+    RelativePathPiece currentPath,
+    ObjectId wdHash) {
+  return diffTrees(
+      context,
+      callback,
+      currentPath,
+      TreeAndId::null(),
+      getTreeAndId(context, std::move(wdHash)));
+}
+
+FOLLY_NODISCARD ImmediateFuture<Unit> diffRemovedTree(
+    DiffContext* context,
+    DiffCallback& callback,
+    RelativePathPiece currentPath,
+    ObjectId scmHash) {
+  return diffTrees(
+      context,
+      callback,
+      currentPath,
+      getTreeAndId(context, std::move(scmHash)),
+      TreeAndId::null());
+}
+
 } // namespace
 
 ImmediateFuture<Unit>
@@ -347,6 +558,7 @@ diffRoots(DiffContext* context, const RootId& root1, const RootId& root2) {
   auto future2 = context->store->getRootTree(root2, context->getFetchContext());
   return diffTrees(
       context,
+      *context->callback,
       RelativePathPiece{},
       std::move(future1).thenValue([](ObjectStore::GetRootTreeResult tree) {
         return TreeAndId{tree.tree, tree.treeId};
@@ -361,27 +573,24 @@ ImmediateFuture<Unit> diffTrees(
     RelativePathPiece currentPath,
     ObjectId scmHash,
     ObjectId wdHash) {
-  return diffTrees(
-      context,
-      currentPath,
-      getTreeAndId(context, scmHash),
-      getTreeAndId(context, wdHash));
+  return diffTreePairWithMemo(
+      context, *context->callback, currentPath, scmHash, wdHash);
 }
 
 ImmediateFuture<Unit> diffAddedTree(
     DiffContext* context,
     RelativePathPiece currentPath,
     ObjectId wdHash) {
-  return diffTrees(
-      context, currentPath, TreeAndId::null(), getTreeAndId(context, wdHash));
+  return diffAddedTree(
+      context, *context->callback, currentPath, std::move(wdHash));
 }
 
 ImmediateFuture<Unit> diffRemovedTree(
     DiffContext* context,
     RelativePathPiece currentPath,
     ObjectId scmHash) {
-  return diffTrees(
-      context, currentPath, getTreeAndId(context, scmHash), TreeAndId::null());
+  return diffRemovedTree(
+      context, *context->callback, currentPath, std::move(scmHash));
 }
 
 } // namespace facebook::eden
@@ -10,6 +10,7 @@
 #include "eden/fs/model/git/GitIgnoreStack.h"
 #include "eden/fs/model/git/TopLevelIgnores.h"
 #include "eden/fs/store/ObjectStore.h"
+#include "eden/fs/store/TreeDiffMemoCache.h"
 
 namespace facebook::eden {
 
@@ -21,18 +22,26 @@ DiffContext::DiffContext(
     CaseSensitivity caseSensitive,
     bool windowsSymlinksEnabled,
     std::shared_ptr<ObjectStore> os,
-    std::unique_ptr<TopLevelIgnores> topLevelIgnores)
+    std::unique_ptr<TopLevelIgnores> topLevelIgnores,
+    std::shared_ptr<TreeDiffMemoCache> diffMemoCache)
     : callback{cb},
       store{std::move(os)},
       listIgnored{listIgnored},
       topLevelIgnores_(std::move(topLevelIgnores)),
-      cancellation_{std::move(cancellation)},
+      // Also honor cancellation requested through the fetch context, so a
+      // diff whose initiating request is abandoned stops walking even when
+      // the caller didn't thread an explicit token through.
+      cancellation_{folly::CancellationToken::merge(
+          std::move(cancellation),
+          fetchContext->getCancellationToken())},
       statsContext_{makeRefPtr<StatsFetchContext>(
           fetchContext->getClientPid(),
           fetchContext->getCause(),
           fetchContext->getCauseDetail(),
-          fetchContext->getRequestInfo())},
+          fetchContext->getRequestInfo(),
+          cancellation_)},
       fetchContext_{statsContext_.copy()},
+      diffMemoCache_{std::move(diffMemoCache)},
       caseSensitive_{caseSensitive},
       windowsSymlinksEnabled_{windowsSymlinksEnabled} {}
 
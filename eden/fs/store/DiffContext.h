@@ -20,6 +20,7 @@ class ImmediateFuture;
 class DiffCallback;
 class GitIgnoreStack;
 class ObjectStore;
+class TreeDiffMemoCache;
 class UserInfo;
 class TopLevelIgnores;
 class EdenMount;
@@ -43,7 +44,8 @@ class DiffContext {
       CaseSensitivity caseSensitive,
       bool windowsSymlinksEnabled,
       std::shared_ptr<ObjectStore> os,
-      std::unique_ptr<TopLevelIgnores> topLevelIgnores);
+      std::unique_ptr<TopLevelIgnores> topLevelIgnores,
+      std::shared_ptr<TreeDiffMemoCache> diffMemoCache = nullptr);
 
   DiffContext(const DiffContext&) = delete;
   DiffContext& operator=(const DiffContext&) = delete;
@@ -82,6 +84,14 @@ class DiffContext {
     return windowsSymlinksEnabled_;
   }
 
+  /**
+   * Memo of finished tree-pair diff results shared across diff operations on
+   * the same mount, or null when memoization is disabled.
+   */
+  const std::shared_ptr<TreeDiffMemoCache>& getDiffMemoCache() const {
+    return diffMemoCache_;
+  }
+
  private:
   std::unique_ptr<TopLevelIgnores> topLevelIgnores_;
   const folly::CancellationToken cancellation_;
@@ -92,6 +102,8 @@ class DiffContext {
   // reference count on every fetch.
   ObjectFetchContextPtr fetchContext_;
 
+  std::shared_ptr<TreeDiffMemoCache> diffMemoCache_;
+
   // Controls the case sensitivity of the diff operation.
   CaseSensitivity caseSensitive_;
 
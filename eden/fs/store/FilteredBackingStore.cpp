@@ -278,19 +278,30 @@ FilteredBackingStore::getTreeEntryForObjectId(
 folly::SemiFuture<BackingStore::GetTreeResult> FilteredBackingStore::getTree(
     const ObjectId& id,
     const ObjectFetchContextPtr& context) {
+  {
+    auto cache = filteredTreeCache_.wlock();
+    auto it = cache->find(id);
+    if (it != cache->end()) {
+      return folly::makeSemiFuture(GetTreeResult{
+          it->second, ObjectFetchContext::Origin::FromMemoryCache});
+    }
+  }
+
   auto filteredId = FilteredObjectId::fromObjectId(id);
   auto unfilteredTree = backingStore_->getTree(filteredId.object(), context);
   return std::move(unfilteredTree)
       .deferValue([self = shared_from_this(),
+                   id,
                    filteredId = std::move(filteredId)](GetTreeResult&& result) {
         auto filterRes = self->filterImpl(
             result.tree, filteredId.path(), filteredId.filter());
         return std::move(filterRes)
-            .thenValue([filteredId, origin = result.origin](
+            .thenValue([self, id, filteredId, origin = result.origin](
                            std::unique_ptr<PathMap<TreeEntry>> pathMap) {
               auto tree = std::make_shared<Tree>(
                   std::move(*pathMap), ObjectId{filteredId.getValue()});
               pathMap.reset();
+              self->filteredTreeCache_.wlock()->set(id, tree);
               return GetTreeResult{std::move(tree), origin};
             })
             .semi();
@@ -326,6 +337,10 @@ void FilteredBackingStore::periodicManagementTask() {
   backingStore_->periodicManagementTask();
 }
 
+size_t FilteredBackingStore::getPendingImportCount() const {
+  return backingStore_->getPendingImportCount();
+}
+
 void FilteredBackingStore::startRecordingFetch() {
   backingStore_->startRecordingFetch();
 }
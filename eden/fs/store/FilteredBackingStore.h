@@ -7,6 +7,9 @@
 
 #pragma once
 
+#include <folly/Synchronized.h>
+#include <folly/container/EvictingCacheMap.h>
+
 #include "eden/fs/store/BackingStore.h"
 #include "eden/fs/store/filter/Filter.h"
 #include "eden/fs/store/filter/FilteredObjectId.h"
@@ -65,6 +68,8 @@ class FilteredBackingStore
 
   void periodicManagementTask() override;
 
+  size_t getPendingImportCount() const override;
+
   void startRecordingFetch() override;
 
   std::unordered_set<std::string> stopRecordingFetch() override;
@@ -120,8 +125,24 @@ class FilteredBackingStore
   }
 
  private:
+  static constexpr size_t kFilteredTreeCacheSize = 10000;
+
   std::shared_ptr<BackingStore> backingStore_;
 
+  /**
+   * Memoized filtered trees, keyed by their filtered ObjectId.
+   *
+   * A FilteredObjectId fully determines the filtered result: it encodes the
+   * underlying tree object, the tree's path, and the filter id, and filter
+   * results are deterministic for a given (filter, tree) pair. Memoizing
+   * lets repeated traversals of large filtered mounts skip both the
+   * underlying tree fetch and the per-entry filter evaluation. The cached
+   * trees are shared with callers, so entries only cost a pointer plus the
+   * LRU bookkeeping while a caller retains the tree.
+   */
+  folly::Synchronized<folly::EvictingCacheMap<ObjectId, TreePtr>>
+      filteredTreeCache_{folly::in_place, kFilteredTreeCacheSize};
+
   // Allows FilteredBackingStore creator to specify how they want to filter
   // paths. This returns true if the given path is filtered in the given
   // filterId
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/store/KeyFilter.h"
+
+#include <folly/hash/Hash.h>
+
+namespace facebook::eden {
+
+namespace {
+/**
+ * Derive two independent 64-bit hashes for double hashing; probe i uses
+ * bit (h1 + i * h2) % kNumBits.
+ */
+std::pair<uint64_t, uint64_t> hashKey(folly::ByteRange key) {
+  auto h1 = folly::hash::fnv64_buf(key.data(), key.size());
+  return {h1, folly::hash::twang_mix64(h1)};
+}
+} // namespace
+
+void KeyFilter::reset(bool enabled) {
+  bits_.clear();
+  if (enabled) {
+    bits_.resize(kNumBits / 64, 0);
+  } else {
+    bits_.shrink_to_fit();
+  }
+}
+
+void KeyFilter::add(folly::ByteRange key) {
+  if (bits_.empty()) {
+    return;
+  }
+  auto [h1, h2] = hashKey(key);
+  for (uint64_t i = 0; i < kNumHashes; ++i) {
+    auto bit = (h1 + i * h2) % kNumBits;
+    bits_[bit / 64] |= uint64_t{1} << (bit % 64);
+  }
+}
+
+bool KeyFilter::mightContain(folly::ByteRange key) const {
+  if (bits_.empty()) {
+    return true;
+  }
+  auto [h1, h2] = hashKey(key);
+  for (uint64_t i = 0; i < kNumHashes; ++i) {
+    auto bit = (h1 + i * h2) % kNumBits;
+    if (!(bits_[bit / 64] & (uint64_t{1} << (bit % 64)))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace facebook::eden
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#pragma once
+
+#include <folly/Range.h>
+#include <cstdint>
+#include <vector>
+
+namespace facebook::eden {
+
+/**
+ * An in-memory approximate-membership filter over the keys of a single
+ * LocalStore key space, used to short-circuit negative lookups.
+ *
+ * The filter can only answer "definitely absent" while it is complete: it
+ * must have seen every key ever written to the key space.  It is therefore
+ * enabled only when the key space is known to be empty -- a freshly created
+ * store, or immediately after the key space is cleared -- and records keys
+ * as they are written from then on.  When completeness cannot be guaranteed
+ * the filter stays disabled and mightContain() always returns true, so
+ * lookups behave exactly as they did without the filter.
+ *
+ * A false positive (mightContain() returning true for an absent key) just
+ * falls through to a real storage lookup.  False negatives are impossible
+ * by construction.
+ *
+ * KeyFilter performs no synchronization of its own; callers are expected to
+ * wrap it in folly::Synchronized or similar.
+ */
+class KeyFilter {
+ public:
+  /**
+   * Clear the filter.  If enabled is true the key space is known to be
+   * empty and the filter starts answering mightContain() precisely;
+   * otherwise the filter is disabled and mightContain() always returns
+   * true.
+   */
+  void reset(bool enabled);
+
+  /**
+   * Record a key that is being written to the key space.  A no-op when the
+   * filter is disabled.
+   */
+  void add(folly::ByteRange key);
+
+  /**
+   * Return false only if the key was definitely never added since the
+   * filter was last enabled.  Always returns true when disabled.
+   */
+  bool mightContain(folly::ByteRange key) const;
+
+  bool enabled() const {
+    return !bits_.empty();
+  }
+
+ private:
+  static constexpr uint64_t kNumBits = 16 * 1024 * 1024;
+  static constexpr uint64_t kNumHashes = 4;
+
+  /**
+   * The filter bit array, 2MiB when enabled and empty when disabled.
+   */
+  std::vector<uint64_t> bits_;
+};
+
+} // namespace facebook::eden
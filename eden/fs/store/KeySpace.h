@@ -102,6 +102,12 @@ class KeySpace {
       8,
       "recasdigestproxyhash",
       Deprecated{}};
+  // Tree IDs fetched under a checkout root, keyed by the rendered root ID.
+  // Used to warm tree caches when the same root is activated again.
+  static constexpr KeySpaceRecord TreeFetchLogFamily{
+      9,
+      "treefetchlog",
+      Ephemeral{&EdenConfig::localStoreTreeFetchLogSizeLimit}};
 
   static constexpr const KeySpaceRecord* kAll[] = {
       &BlobFamily,
@@ -112,7 +118,8 @@ class KeySpace {
       &BlobSizeFamily,
       &ScsProxyHashFamily,
       &TreeMetaDataFamily,
-      &ReCasDigestProxyHashFamily};
+      &ReCasDigestProxyHashFamily,
+      &TreeFetchLogFamily};
   static constexpr size_t kTotalCount = std::size(kAll);
 
  private:
@@ -21,6 +21,9 @@
 #include "eden/fs/model/Tree.h"
 #include "eden/fs/model/git/GitBlob.h"
 #include "eden/fs/model/git/GitTree.h"
+#ifndef _WIN32
+#include "eden/fs/store/PackedBlobMetadata.h"
+#endif
 #include "eden/fs/store/SerializedBlobMetadata.h"
 #include "eden/fs/store/StoreResult.h"
 #include "eden/fs/telemetry/EdenStats.h"
@@ -57,6 +60,14 @@ FOLLY_ALWAYS_INLINE std::shared_ptr<T> parse(
 
 LocalStore::LocalStore(EdenStatsPtr edenStats) : stats_{std::move(edenStats)} {}
 
+LocalStore::~LocalStore() = default;
+
+#ifndef _WIN32
+void LocalStore::enablePackedBlobMetadata(AbsolutePathPiece path) {
+  packedBlobMetadata_ = std::make_unique<PackedBlobMetadata>(path);
+}
+#endif
+
 void LocalStore::clearDeprecatedKeySpaces() {
   for (auto& ks : KeySpace::kAll) {
     if (ks->isDeprecated()) {
@@ -73,6 +84,11 @@ void LocalStore::clearCachesAndCompactAll() {
     }
     compactKeySpace(ks);
   }
+#ifndef _WIN32
+  if (packedBlobMetadata_) {
+    packedBlobMetadata_->clear();
+  }
+#endif
 }
 
 void LocalStore::clearCaches() {
@@ -81,6 +97,13 @@ void LocalStore::clearCaches() {
       clearKeySpace(ks);
     }
   }
+  // The packed segment fronts the BlobMetaDataFamily key space and must not
+  // outlive its contents.
+#ifndef _WIN32
+  if (packedBlobMetadata_) {
+    packedBlobMetadata_->clear();
+  }
+#endif
 }
 
 void LocalStore::compactStorage() {
@@ -170,12 +193,22 @@ ImmediateFuture<BlobPtr> LocalStore::getBlob(const ObjectId& id) const {
 ImmediateFuture<BlobMetadataPtr> LocalStore::getBlobMetadata(
     const ObjectId& id) const {
   DurationScope stat{stats_, &LocalStoreStats::getBlobMetadata};
+#ifndef _WIN32
+  if (packedBlobMetadata_) {
+    if (auto metadata = packedBlobMetadata_->get(id)) {
+      stats_->increment(&LocalStoreStats::getBlobMetadataSuccess);
+      return std::make_shared<const BlobMetadata>(std::move(*metadata));
+    }
+  }
+#endif
   return getImmediateFuture(KeySpace::BlobMetaDataFamily, id)
       .thenValue(
-          [id, stat = std::move(stat), stats = stats_.copy()](
-              StoreResult&& data) -> BlobMetadataPtr {
+          [id,
+           stat = std::move(stat),
+           stats = stats_.copy(),
+           self = weak_from_this()](StoreResult&& data) -> BlobMetadataPtr {
             if (data.isValid()) {
-              return parse<const BlobMetadata>(
+              auto metadata = parse<const BlobMetadata>(
                   id,
                   "BlobMetadata",
                   stats,
@@ -184,6 +217,17 @@ ImmediateFuture<BlobMetadataPtr> LocalStore::getBlobMetadata(
                   [&id, &data]() {
                     return SerializedBlobMetadata::parse(id, data);
                   });
+#ifndef _WIN32
+              if (metadata) {
+                // Promote key-value store hits into the packed segment so
+                // repeated batch stat workloads are served by it.
+                if (auto store = self.lock();
+                    store && store->packedBlobMetadata_) {
+                  store->packedBlobMetadata_->stage(id, *metadata);
+                }
+              }
+#endif
+              return metadata;
             }
 
             stats->increment(&LocalStoreStats::getBlobMetadataFailure);
@@ -231,6 +275,11 @@ void LocalStore::putBlobMetadata(
   SerializedBlobMetadata metadataBytes(metadata);
 
   put(KeySpace::BlobMetaDataFamily, hashBytes, metadataBytes.slice());
+#ifndef _WIN32
+  if (packedBlobMetadata_) {
+    packedBlobMetadata_->stage(id, metadata);
+  }
+#endif
 }
 
 void LocalStore::WriteBatch::putBlobMetadata(
@@ -288,7 +337,13 @@ LocalStore::WriteBatch::~WriteBatch() {}
 
 void LocalStore::periodicManagementTask(const EdenConfig& /* config */) {
   // Individual store subclasses can provide their own implementations for
-  // periodic management.
+  // periodic management; overrides should call through to this base
+  // implementation.
+#ifndef _WIN32
+  if (packedBlobMetadata_) {
+    packedBlobMetadata_->flush();
+  }
+#endif
 }
 
 } // namespace facebook::eden
@@ -29,6 +29,7 @@ namespace facebook::eden {
 
 class EdenStats;
 class EdenConfig;
+class PackedBlobMetadata;
 class StoreResult;
 
 using EdenStatsPtr = RefPtr<EdenStats>;
@@ -53,7 +54,7 @@ using EdenStatsPtr = RefPtr<EdenStats>;
 class LocalStore : public std::enable_shared_from_this<LocalStore> {
  public:
   explicit LocalStore(EdenStatsPtr edenStats);
-  virtual ~LocalStore() = default;
+  virtual ~LocalStore();
 
   /**
    * Open the underlying store. This must be called before calling any other
@@ -261,6 +262,20 @@ class LocalStore : public std::enable_shared_from_this<LocalStore> {
 
   virtual void periodicManagementTask(const EdenConfig& config);
 
+ protected:
+#ifndef _WIN32
+  /**
+   * Enables the packed blob metadata cache tier, backed by a segment file
+   * at the given path.
+   *
+   * Subclasses with on-disk storage call this from open(). getBlobMetadata
+   * answers from the packed segment when it can and promotes key-value
+   * store hits into it, so batch stat workloads are served by mmap'd
+   * binary searches instead of repeated point lookups.
+   */
+  void enablePackedBlobMetadata(AbsolutePathPiece path);
+#endif
+
  private:
   /**
    * Compute the serialized version of the tree in a (not coalesced) IOBuf.
@@ -272,6 +287,15 @@ class LocalStore : public std::enable_shared_from_this<LocalStore> {
   static folly::IOBuf serializeTree(const Tree& tree);
 
   EdenStatsPtr stats_;
+
+#ifndef _WIN32
+  /**
+   * Packed blob metadata cache tier; null unless the subclass called
+   * enablePackedBlobMetadata(). Set once during open() and never reset, so
+   * reads don't need to synchronize on it.
+   */
+  std::unique_ptr<PackedBlobMetadata> packedBlobMetadata_;
+#endif
 };
 
 } // namespace facebook::eden
@@ -6,6 +6,11 @@
  */
 
 #include "eden/fs/store/LocalStoreCachedBackingStore.h"
+#include <folly/CppAttributes.h>
+#include <folly/futures/Future.h>
+#include <folly/logging/xlog.h>
+#include "eden/fs/config/EdenConfig.h"
+#include "eden/fs/config/ReloadableConfig.h"
 #include "eden/fs/model/Blob.h"
 #include "eden/fs/model/BlobMetadata.h"
 #include "eden/fs/model/Tree.h"
@@ -13,17 +18,55 @@
 #include "eden/fs/telemetry/EdenStats.h"
 #include "eden/fs/utils/ImmediateFuture.h"
 
+namespace {
+
+using namespace facebook::eden;
+
+/**
+ * Fetch context used for child tree read-ahead. The low priority keeps the
+ * speculative fetches behind any demand fetch in the backing store's import
+ * queue.
+ */
+class ChildTreePrefetchContext : public ObjectFetchContext {
+ public:
+  Cause getCause() const override {
+    return Cause::Prefetch;
+  }
+
+  std::optional<std::string_view> getCauseDetail() const override {
+    return "child-tree-readahead";
+  }
+
+  ImportPriority getPriority() const override {
+    return ImportPriority{ImportPriority::Class::Low};
+  }
+
+  const std::unordered_map<std::string, std::string>* FOLLY_NULLABLE
+  getRequestInfo() const override {
+    return nullptr;
+  }
+};
+
+ObjectFetchContextPtr getChildTreePrefetchContext() {
+  static auto* p = new ChildTreePrefetchContext;
+  return ObjectFetchContextPtr::singleton(*p);
+}
+
+} // namespace
+
 namespace facebook::eden {
 
 LocalStoreCachedBackingStore::LocalStoreCachedBackingStore(
     std::shared_ptr<BackingStore> backingStore,
     std::shared_ptr<LocalStore> localStore,
     EdenStatsPtr stats,
-    LocalStoreCachedBackingStore::CachingPolicy cachingPolicy)
+    LocalStoreCachedBackingStore::CachingPolicy cachingPolicy,
+    std::shared_ptr<ReloadableConfig> config)
     : backingStore_{std::move(backingStore)},
       localStore_{std::move(localStore)},
       stats_{std::move(stats)},
-      cachingPolicy_{cachingPolicy} {
+      cachingPolicy_{cachingPolicy},
+      config_{std::move(config)} {
   XCHECK_NE(
       cachingPolicy_, LocalStoreCachedBackingStore::CachingPolicy::NoCaching);
 }
@@ -82,7 +125,8 @@ LocalStoreCachedBackingStore::getTree(
                 // TODO: This is a good use for toUnsafeFuture to ensure the
                 // tree is cached even if the resulting future is never
                 // consumed.
-                .thenValue([self](GetTreeResult result) {
+                .thenValue([self, context = context.copy()](
+                               GetTreeResult result) {
                   if (result.tree) {
                     auto batch = self->localStore_->beginWrite();
                     if (self->shouldCache(LocalStoreCachedBackingStore::
@@ -109,6 +153,18 @@ LocalStoreCachedBackingStore::getTree(
                     batch->flush();
                     self->stats_->increment(
                         &ObjectStoreStats::getTreeFromBackingStore);
+
+                    // Read ahead of the walk: children of a demand-fetched
+                    // tree are very likely to be requested next. Don't read
+                    // ahead on behalf of prefetches to avoid recursively
+                    // walking the whole repository.
+                    if (self->config_ &&
+                        self->config_->getEdenConfig()
+                            ->childTreePrefetch.getValue() &&
+                        context->getCause() !=
+                            ObjectFetchContext::Cause::Prefetch) {
+                      self->prefetchChildTrees(*result.tree);
+                    }
                   }
 
                   return result;
@@ -228,6 +284,23 @@ LocalStoreCachedBackingStore::getBlob(
       .semi();
 }
 
+void LocalStoreCachedBackingStore::prefetchChildTrees(const Tree& tree) {
+  auto context = getChildTreePrefetchContext();
+  for (const auto& [name, entry] : tree) {
+    if (entry.isTree()) {
+      // The fetched trees land in the LocalStore via the regular getTree
+      // caching path; the results themselves are dropped.
+      folly::futures::detachOnGlobalCPUExecutor(
+          getTree(entry.getHash(), context)
+              .deferValue([](GetTreeResult&&) {})
+              .deferError([](folly::exception_wrapper&& ew) {
+                XLOG(DBG4) << "child tree read-ahead failed: "
+                           << folly::exceptionStr(ew);
+              }));
+    }
+  }
+}
+
 folly::SemiFuture<folly::Unit> LocalStoreCachedBackingStore::prefetchBlobs(
     ObjectIdRange ids,
     const ObjectFetchContextPtr& context) {
@@ -238,6 +311,10 @@ void LocalStoreCachedBackingStore::periodicManagementTask() {
   backingStore_->periodicManagementTask();
 }
 
+size_t LocalStoreCachedBackingStore::getPendingImportCount() const {
+  return backingStore_->getPendingImportCount();
+}
+
 void LocalStoreCachedBackingStore::startRecordingFetch() {
   backingStore_->startRecordingFetch();
 }
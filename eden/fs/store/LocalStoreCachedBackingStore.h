@@ -15,6 +15,8 @@ namespace facebook::eden {
 class BackingStore;
 class LocalStore;
 class EdenStats;
+class ReloadableConfig;
+class Tree;
 
 using EdenStatsPtr = RefPtr<EdenStats>;
 
@@ -49,7 +51,8 @@ class LocalStoreCachedBackingStore
       std::shared_ptr<BackingStore> backingStore,
       std::shared_ptr<LocalStore> localStore,
       EdenStatsPtr stats,
-      CachingPolicy cachingPolicy);
+      CachingPolicy cachingPolicy,
+      std::shared_ptr<ReloadableConfig> config = nullptr);
   ~LocalStoreCachedBackingStore() override;
 
   ObjectComparison compareObjectsById(const ObjectId& one, const ObjectId& two)
@@ -79,6 +82,8 @@ class LocalStoreCachedBackingStore
 
   void periodicManagementTask() override;
 
+  size_t getPendingImportCount() const override;
+
   void startRecordingFetch() override;
   std::unordered_set<std::string> stopRecordingFetch() override;
 
@@ -116,10 +121,22 @@ class LocalStoreCachedBackingStore
    */
   bool shouldCache(CachingPolicy object) const;
 
+  /**
+   * Enqueue low-priority fetches for the child trees of a freshly fetched
+   * tree. During checkout and directory walks the access pattern is almost
+   * always "parent then all children", so warming the caches ahead of demand
+   * lets the backing store round trips overlap with inode materialization
+   * instead of serializing behind it. Only triggered for demand fetches --
+   * prefetch-caused fetches never read ahead, which bounds the read-ahead to
+   * one level beyond the demand-loaded tree.
+   */
+  void prefetchChildTrees(const Tree& tree);
+
   std::shared_ptr<BackingStore> backingStore_;
   std::shared_ptr<LocalStore> localStore_;
   EdenStatsPtr stats_;
   CachingPolicy cachingPolicy_;
+  std::shared_ptr<ReloadableConfig> config_;
 };
 
 } // namespace facebook::eden
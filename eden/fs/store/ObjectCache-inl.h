@@ -6,7 +6,9 @@
  */
 
 #include <folly/MapUtil.h>
+#include <folly/lang/Bits.h>
 #include <folly/logging/xlog.h>
+#include <algorithm>
 #include <utility>
 
 #include "eden/fs/store/ObjectCache.h"
@@ -61,20 +63,40 @@ template <typename ObjectType, ObjectCacheFlavor Flavor>
 std::shared_ptr<ObjectCache<ObjectType, Flavor>>
 ObjectCache<ObjectType, Flavor>::create(
     size_t maximumCacheSizeBytes,
-    size_t minimumEntryCount) {
+    size_t minimumEntryCount,
+    size_t shardCount,
+    size_t protectedSegmentPercent,
+    std::shared_ptr<folly::Executor> evictionExecutor) {
   // Allow make_shared with private constructor.
   struct OC : ObjectCache<ObjectType, Flavor> {
-    OC(size_t x, size_t y) : ObjectCache<ObjectType, Flavor>{x, y} {}
+    OC(size_t w, size_t x, size_t y, size_t z, std::shared_ptr<folly::Executor> e)
+        : ObjectCache<ObjectType, Flavor>{w, x, y, z, std::move(e)} {}
   };
-  return std::make_shared<OC>(maximumCacheSizeBytes, minimumEntryCount);
+  return std::make_shared<OC>(
+      maximumCacheSizeBytes,
+      minimumEntryCount,
+      shardCount,
+      protectedSegmentPercent,
+      std::move(evictionExecutor));
 }
 
 template <typename ObjectType, ObjectCacheFlavor Flavor>
 ObjectCache<ObjectType, Flavor>::ObjectCache(
     size_t maximumCacheSizeBytes,
-    size_t minimumEntryCount)
-    : maximumCacheSizeBytes_{maximumCacheSizeBytes},
-      minimumEntryCount_{minimumEntryCount} {}
+    size_t minimumEntryCount,
+    size_t shardCount,
+    size_t protectedSegmentPercent,
+    std::shared_ptr<folly::Executor> evictionExecutor)
+    : maximumShardSizeBytes_{
+          maximumCacheSizeBytes / std::max<size_t>(1, shardCount)},
+      minimumShardEntryCount_{
+          (minimumEntryCount + std::max<size_t>(1, shardCount) - 1) /
+          std::max<size_t>(1, shardCount)},
+      protectedShardSizeBytes_{
+          maximumShardSizeBytes_ * std::min<size_t>(100, protectedSegmentPercent) /
+          100},
+      evictionExecutor_{std::move(evictionExecutor)},
+      shards_{std::max<size_t>(1, shardCount)} {}
 
 template <typename ObjectType, ObjectCacheFlavor Flavor>
 template <ObjectCacheFlavor F>
@@ -90,7 +112,7 @@ ObjectCache<ObjectType, Flavor>::getInterestHandle(
   // runs after the lock is released.
   ObjectInterestHandle<ObjectType> interestHandle;
 
-  auto state = state_.lock();
+  auto state = shardFor(hash).lock();
 
   auto item = getImpl(hash, *state);
   if (!item) {
@@ -129,7 +151,7 @@ typename std::enable_if_t<
     typename ObjectCache<ObjectType, Flavor>::ObjectPtr>
 ObjectCache<ObjectType, Flavor>::getSimple(const ObjectId& hash) {
   XLOG(DBG6) << "BlobCache::getSimple " << hash;
-  auto state = state_.lock();
+  auto state = shardFor(hash).lock();
 
   if (auto item = getImpl(hash, *state)) {
     return item->object;
@@ -142,6 +164,7 @@ typename ObjectCache<ObjectType, Flavor>::CacheItem*
 ObjectCache<ObjectType, Flavor>::getImpl(const ObjectId& hash, State& state) {
   XLOG(DBG6) << "ObjectCache::getImpl " << hash;
   auto* item = folly::get_ptr(state.items, hash);
+  auto accessSeq = accessSequence_.fetch_add(1, std::memory_order_relaxed) + 1;
   if (!item) {
     XLOG(DBG6) << "ObjectCache::getImpl missed";
     ++state.missCount;
@@ -149,13 +172,51 @@ ObjectCache<ObjectType, Flavor>::getImpl(const ObjectId& hash, State& state) {
   } else {
     XLOG(DBG6) << "ObjectCache::getImpl hit";
 
-    // TODO: Should we avoid promoting if interest is UnlikelyNeededAgain?
-    // For now, we'll try not to be too clever.
-    state.evictionQueue.splice(
-        state.evictionQueue.end(),
-        state.evictionQueue,
-        state.evictionQueue.iterator_to(*item));
+    if (!isSegmented()) {
+      // TODO: Should we avoid promoting if interest is UnlikelyNeededAgain?
+      // For now, we'll try not to be too clever.
+      state.evictionQueue.splice(
+          state.evictionQueue.end(),
+          state.evictionQueue,
+          state.evictionQueue.iterator_to(*item));
+    } else if (item->isProtected) {
+      state.protectedQueue.splice(
+          state.protectedQueue.end(),
+          state.protectedQueue,
+          state.protectedQueue.iterator_to(*item));
+    } else {
+      // A second hit promotes the item from the probationary segment into
+      // the protected segment.
+      state.evictionQueue.erase(state.evictionQueue.iterator_to(*item));
+      state.protectedQueue.push_back(*item);
+      item->isProtected = true;
+      state.protectedSize += item->object->getSizeBytes();
+
+      // Keep the protected segment within its byte budget by demoting its
+      // least recently used items back to the MRU end of the probationary
+      // segment, where they remain reachable but are eligible for eviction.
+      while (state.protectedSize > protectedShardSizeBytes_ &&
+             !state.protectedQueue.empty()) {
+        auto& demoted = state.protectedQueue.front();
+        state.protectedQueue.pop_front();
+        demoted.isProtected = false;
+        state.protectedSize -= demoted.object->getSizeBytes();
+        state.evictionQueue.push_back(demoted);
+      }
+    }
     ++state.hitCount;
+
+    // Record how many cache accesses elapsed since this item was last
+    // touched. This hit would have occurred in any cache retaining at least
+    // that many recently accessed objects, which is what lets the collector
+    // model hit rates for other cache sizes.
+    auto distance = accessSeq - item->lastAccessSeq;
+    item->lastAccessSeq = accessSeq;
+    item->accessedSinceInsert = true;
+    size_t bucket = std::min(
+        kReuseDistanceBucketCount - 1,
+        static_cast<size_t>(folly::findLastSet(distance)));
+    reuseDistanceBuckets_[bucket].fetch_add(1, std::memory_order_relaxed);
   }
 
   return item;
@@ -176,6 +237,17 @@ ObjectCache<ObjectType, Flavor>::insertInterestHandle(
   // runs after the lock is released.
   ObjectInterestHandle<ObjectType> interestHandle{};
 
+  if (interest == Interest::UnlikelyNeededAgain && !admitSpeculativeInsert()) {
+    // Recent speculative inserts have mostly been evicted without a single
+    // hit, so caching this one is almost certainly wasted work. Skip the
+    // cache entirely; the handle still lets the caller retrieve the object
+    // while it keeps the object alive, which is exactly what it would
+    // observe if the insert had been evicted immediately.
+    speculativeBypassCount_.fetch_add(1, std::memory_order_relaxed);
+    interestHandle.object_ = object;
+    return interestHandle;
+  }
+
   auto cacheItemGeneration = generateUniqueID();
 
   if (interest == Interest::WantHandle) {
@@ -188,7 +260,7 @@ ObjectCache<ObjectType, Flavor>::insertInterestHandle(
 
   XLOG(DBG6) << "  creating entry with generation=" << cacheItemGeneration;
 
-  auto state = state_.lock();
+  auto state = shardFor(id).lock();
   auto [item, inserted] = insertImpl(std::move(id), std::move(object), *state);
   switch (interest) {
     case Interest::UnlikelyNeededAgain:
@@ -200,6 +272,8 @@ ObjectCache<ObjectType, Flavor>::insertInterestHandle(
   }
   if (inserted) { // new entry we need to set the generation number
     item->generation = cacheItemGeneration;
+    item->insertionInterest = interest;
+    recordInsert(interest);
   } else {
     XLOG(DBG6) << "duplicate entry, using generation " << item->generation;
     // Inserting duplicate entry - use its generation.
@@ -218,8 +292,10 @@ ObjectCache<ObjectType, Flavor>::insertSimple(
     ObjectId id,
     ObjectCache<ObjectType, Flavor>::ObjectPtr object) {
   XLOG(DBG6) << "ObjectCache::insertSimple " << id;
-  auto state = state_.lock();
-  insertImpl(std::move(id), std::move(object), *state);
+  auto state = shardFor(id).lock();
+  if (insertImpl(std::move(id), std::move(object), *state).second) {
+    recordInsert(Interest::LikelyNeededAgain);
+  }
 }
 
 template <typename ObjectType, ObjectCacheFlavor Flavor>
@@ -240,6 +316,12 @@ ObjectCache<ObjectType, Flavor>::insertImpl(
 
   auto* itemPtr = &iter->second;
   if (inserted) {
+    // A fresh insert is an access too: it competes for cache space just like
+    // a lookup. The usual miss-then-insert sequence therefore counts as two
+    // accesses, a small consistent bias that doesn't affect the shape of the
+    // histogram.
+    itemPtr->lastAccessSeq =
+        accessSequence_.fetch_add(1, std::memory_order_relaxed) + 1;
     try {
       state.evictionQueue.push_back(*itemPtr);
     } catch (const std::exception&) {
@@ -247,51 +329,152 @@ ObjectCache<ObjectType, Flavor>::insertImpl(
       throw;
     }
     state.totalSize += size;
-    evictUntilFits(state);
+    if (!evictionExecutor_) {
+      evictUntilFits(state);
+    } else if (
+        state.totalSize > maximumShardSizeBytes_ && !state.evictionScheduled) {
+      // Evicting inline would stall the inserting thread while the shard
+      // lock is held; hand the work to the eviction executor instead. The
+      // weak_ptr lets queued tasks outlive the cache safely, and the
+      // evictionScheduled flag coalesces a burst of inserts into one task.
+      state.evictionScheduled = true;
+      evictionExecutor_->add(
+          [self = this->weak_from_this(), id = itemPtr->id]() {
+            if (auto cache = self.lock()) {
+              auto shard = cache->shardFor(id).lock();
+              shard->evictionScheduled = false;
+              cache->evictUntilFits(*shard);
+            }
+          });
+    }
+  } else if (itemPtr->isProtected) {
+    state.protectedQueue.splice(
+        state.protectedQueue.end(),
+        state.protectedQueue,
+        state.protectedQueue.iterator_to(*itemPtr));
   } else {
     state.evictionQueue.splice(
         state.evictionQueue.end(),
         state.evictionQueue,
         state.evictionQueue.iterator_to(*itemPtr));
   }
+  if (!inserted) {
+    // A redundant insert means the object was produced on demand again, so
+    // the cached copy has proven its worth.
+    itemPtr->accessedSinceInsert = true;
+  }
   return std::make_pair(itemPtr, inserted);
 }
 
 template <typename ObjectType, ObjectCacheFlavor Flavor>
 bool ObjectCache<ObjectType, Flavor>::contains(const ObjectId& hash) const {
-  auto state = state_.lock();
+  auto state = shardFor(hash).lock();
   return 1 == state->items.count(hash);
 }
 
 template <typename ObjectType, ObjectCacheFlavor Flavor>
 void ObjectCache<ObjectType, Flavor>::clear() {
   XLOG(DBG6) << "ObjectCache::clear";
-  auto state = state_.lock();
-  state->totalSize = 0;
-  state->evictionQueue.clear();
-  state->items.clear();
+  for (auto& shard : shards_) {
+    auto state = shard.lock();
+    state->totalSize = 0;
+    state->protectedSize = 0;
+    state->evictionQueue.clear();
+    state->protectedQueue.clear();
+    state->items.clear();
+  }
 }
 
 template <typename ObjectType, ObjectCacheFlavor Flavor>
 typename ObjectCache<ObjectType, Flavor>::Stats
 ObjectCache<ObjectType, Flavor>::getStats() const {
-  auto state = state_.lock();
+  // Shards are locked one at a time, so the result is not a single atomic
+  // snapshot across the whole cache. That is fine for the counters reported
+  // here.
   Stats stats;
-  stats.objectCount = state->items.size();
-  stats.totalSizeInBytes = state->totalSize;
-  stats.hitCount = state->hitCount;
-  stats.missCount = state->missCount;
-  stats.evictionCount = state->evictionCount;
-  stats.dropCount = state->dropCount;
+  for (const auto& shard : shards_) {
+    auto state = shard.lock();
+    stats.objectCount += state->items.size();
+    stats.totalSizeInBytes += state->totalSize;
+    stats.hitCount += state->hitCount;
+    stats.missCount += state->missCount;
+    stats.evictionCount += state->evictionCount;
+    stats.dropCount += state->dropCount;
+  }
+  stats.reuseDistanceBuckets.reserve(kReuseDistanceBucketCount);
+  for (const auto& bucket : reuseDistanceBuckets_) {
+    stats.reuseDistanceBuckets.push_back(
+        bucket.load(std::memory_order_relaxed));
+  }
+  for (size_t i = 0; i < kInterestCount; ++i) {
+    stats.insertsByInterest[i] =
+        insertsByInterest_[i].load(std::memory_order_relaxed);
+    stats.unusedEvictionsByInterest[i] =
+        unusedEvictionsByInterest_[i].load(std::memory_order_relaxed);
+  }
+  stats.speculativeBypassCount =
+      speculativeBypassCount_.load(std::memory_order_relaxed);
   return stats;
 }
 
+template <typename ObjectType, ObjectCacheFlavor Flavor>
+void ObjectCache<ObjectType, Flavor>::recordInsert(Interest interest) noexcept {
+  insertsByInterest_[static_cast<size_t>(interest)].fetch_add(
+      1, std::memory_order_relaxed);
+  if (interest != Interest::UnlikelyNeededAgain) {
+    return;
+  }
+  auto inserts =
+      speculativeWindowInserts_.fetch_add(1, std::memory_order_relaxed) + 1;
+  if (inserts >= kSpeculativeWasteWindow) {
+    // Halve both decayed counters, preserving the waste ratio while letting
+    // old history fade. Concurrent updates between the loads and stores can
+    // lose a few counts, which is harmless for a heuristic.
+    speculativeWindowInserts_.store(inserts / 2, std::memory_order_relaxed);
+    speculativeWindowUnusedEvictions_.store(
+        speculativeWindowUnusedEvictions_.load(std::memory_order_relaxed) / 2,
+        std::memory_order_relaxed);
+  }
+}
+
+template <typename ObjectType, ObjectCacheFlavor Flavor>
+bool ObjectCache<ObjectType, Flavor>::admitSpeculativeInsert() noexcept {
+  auto inserts = speculativeWindowInserts_.load(std::memory_order_relaxed);
+  if (inserts < kSpeculativeWasteMinimumSamples) {
+    return true;
+  }
+  auto unused =
+      speculativeWindowUnusedEvictions_.load(std::memory_order_relaxed);
+  if (unused * 100 < inserts * kSpeculativeWasteThresholdPercent) {
+    return true;
+  }
+  // The gate is closed. Admit an occasional probe anyway: without probes no
+  // speculative object would ever be inserted again, the window counters
+  // would freeze, and the gate could never reopen once the workload changes.
+  return speculativeProbeCounter_.fetch_add(1, std::memory_order_relaxed) %
+      kSpeculativeProbeInterval ==
+      0;
+}
+
+template <typename ObjectType, ObjectCacheFlavor Flavor>
+void ObjectCache<ObjectType, Flavor>::recordUnusedEviction(
+    const CacheItem& item) noexcept {
+  if (item.accessedSinceInsert) {
+    return;
+  }
+  unusedEvictionsByInterest_[static_cast<size_t>(item.insertionInterest)]
+      .fetch_add(1, std::memory_order_relaxed);
+  if (item.insertionInterest == Interest::UnlikelyNeededAgain) {
+    speculativeWindowUnusedEvictions_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
 template <typename ObjectType, ObjectCacheFlavor Flavor>
 void ObjectCache<ObjectType, Flavor>::dropInterestHandle(
     const ObjectId& hash,
     uint64_t generation) noexcept {
   XLOG(DBG6) << "dropInterestHandle " << hash << " generation=" << generation;
-  auto state = state_.lock();
+  auto state = shardFor(hash).lock();
 
   auto* item = folly::get_ptr(state->items, hash);
   if (!item) {
@@ -313,7 +496,12 @@ void ObjectCache<ObjectType, Flavor>::dropInterestHandle(
   }
 
   if (--item->referenceCount == 0) {
-    state->evictionQueue.erase(state->evictionQueue.iterator_to(*item));
+    if (item->isProtected) {
+      state->protectedQueue.erase(state->protectedQueue.iterator_to(*item));
+      state->protectedSize -= item->object->getSizeBytes();
+    } else {
+      state->evictionQueue.erase(state->evictionQueue.iterator_to(*item));
+    }
     ++state->dropCount;
     evictItem(*state, *item);
   }
@@ -323,21 +511,50 @@ template <typename ObjectType, ObjectCacheFlavor Flavor>
 void ObjectCache<ObjectType, Flavor>::evictUntilFits(State& state) noexcept {
   XLOG(DBG6) << "ObjectCache::evictUntilFits "
              << "state.totalSize=" << state.totalSize
-             << ", maximumCacheSizeBytes_=" << maximumCacheSizeBytes_
+             << ", maximumShardSizeBytes_=" << maximumShardSizeBytes_
              << ", evictionQueue.size()=" << state.evictionQueue.size()
-             << ", minimumEntryCount_=" << minimumEntryCount_;
-  while (state.totalSize > maximumCacheSizeBytes_ &&
-         state.evictionQueue.size() > minimumEntryCount_) {
+             << ", minimumShardEntryCount_=" << minimumShardEntryCount_;
+  while (state.totalSize > maximumShardSizeBytes_ &&
+         state.evictionQueue.size() + state.protectedQueue.size() >
+             minimumShardEntryCount_) {
     evictOne(state);
   }
 }
 
 template <typename ObjectType, ObjectCacheFlavor Flavor>
 void ObjectCache<ObjectType, Flavor>::evictOne(State& state) noexcept {
-  const auto& front = state.evictionQueue.front();
-  state.evictionQueue.pop_front();
-  ++state.evictionCount;
-  evictItem(state, front);
+  // The probationary queue is always drained before the protected segment
+  // so scans over cold objects cannot displace the hot working set.
+  if (!state.evictionQueue.empty()) {
+    const auto& front = state.evictionQueue.front();
+    state.evictionQueue.pop_front();
+    ++state.evictionCount;
+    recordUnusedEviction(front);
+    notifyEviction(front);
+    evictItem(state, front);
+  } else {
+    const auto& front = state.protectedQueue.front();
+    state.protectedQueue.pop_front();
+    state.protectedSize -= front.object->getSizeBytes();
+    ++state.evictionCount;
+    recordUnusedEviction(front);
+    notifyEviction(front);
+    evictItem(state, front);
+  }
+}
+
+template <typename ObjectType, ObjectCacheFlavor Flavor>
+void ObjectCache<ObjectType, Flavor>::notifyEviction(
+    const CacheItem& item) noexcept {
+  if (!evictionCallback_) {
+    return;
+  }
+  try {
+    evictionCallback_(item.id, item.object);
+  } catch (const std::exception& e) {
+    XLOG(WARNING) << "eviction callback failed for " << item.id << ": "
+                  << e.what();
+  }
 }
 
 template <typename ObjectType, ObjectCacheFlavor Flavor>
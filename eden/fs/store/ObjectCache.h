@@ -7,12 +7,17 @@
 
 #pragma once
 
+#include <folly/Executor.h>
+#include <folly/Function.h>
 #include <folly/IntrusiveList.h>
 #include <folly/Synchronized.h>
 #include <folly/container/F14Map.h>
 #include <folly/synchronization/DistributedMutex.h>
+#include <array>
+#include <atomic>
 #include <list>
 #include <mutex>
+#include <vector>
 
 #include "eden/fs/model/ObjectId.h"
 
@@ -133,6 +138,9 @@ class ObjectCache
     LikelyNeededAgain,
   };
 
+  /** Number of Interest values; sizes the per-interest stat arrays. */
+  static constexpr size_t kInterestCount = 3;
+
   struct GetResult {
     ObjectPtr object;
     ObjectInterestHandle<ObjectType> interestHandle;
@@ -145,11 +153,87 @@ class ObjectCache
     uint64_t missCount{0};
     uint64_t evictionCount{0};
     uint64_t dropCount{0};
+
+    /**
+     * Log2 histogram of reuse distances observed on cache hits. Bucket i
+     * counts hits whose reuse distance was in [2^(i-1), 2^i) accesses;
+     * see reuseDistanceBuckets_ for the exact semantics.
+     */
+    std::vector<uint64_t> reuseDistanceBuckets;
+
+    /**
+     * Fresh inserts, indexed by the Interest the object was inserted with.
+     * Simple-flavor caches count under LikelyNeededAgain.
+     */
+    std::array<uint64_t, kInterestCount> insertsByInterest{};
+
+    /**
+     * Capacity evictions of objects that were never hit between insertion
+     * and eviction, indexed by insertion Interest. Such objects were cached
+     * for nothing; comparing against insertsByInterest gives the waste rate
+     * of each insertion class. Interest-handle drops and clear() are not
+     * counted.
+     */
+    std::array<uint64_t, kInterestCount> unusedEvictionsByInterest{};
+
+    /**
+     * UnlikelyNeededAgain inserts refused by the speculative waste gate;
+     * see insertInterestHandle().
+     */
+    uint64_t speculativeBypassCount{0};
   };
 
+  static constexpr size_t kReuseDistanceBucketCount = 32;
+
+  /**
+   * Parameters of the speculative-insert waste gate. Inserts with
+   * UnlikelyNeededAgain interest are speculative: the caller itself does not
+   * expect to read the object again, so caching it only pays off if some
+   * other reader shows up before it is evicted. When, over the recent decay
+   * window, at least kSpeculativeWasteThresholdPercent of such inserts were
+   * evicted without a single hit (and at least
+   * kSpeculativeWasteMinimumSamples were observed), further speculative
+   * inserts are bypassed entirely instead of churning the eviction queue.
+   * Every kSpeculativeProbeInterval-th bypassed insert is still admitted as
+   * a probe so the waste estimate keeps tracking the workload and the gate
+   * can reopen when speculative objects start getting hits again.
+   */
+  static constexpr uint64_t kSpeculativeWasteMinimumSamples = 256;
+  static constexpr uint64_t kSpeculativeWasteThresholdPercent = 75;
+  static constexpr uint64_t kSpeculativeWasteWindow = 2048;
+  static constexpr uint64_t kSpeculativeProbeInterval = 16;
+
+  /**
+   * Create a cache with the given total size budget.
+   *
+   * shardCount splits the cache into independent LRU shards, each guarded by
+   * its own lock and receiving an equal slice of the size budget. A value of
+   * 1 preserves the historical single-lock behavior; larger values let
+   * concurrent get/insert calls on different objects proceed in parallel
+   * instead of serializing on one lock. shardCount is rounded up to at least
+   * 1.
+   *
+   * protectedSegmentPercent, when non-zero, turns each shard into a
+   * segmented (scan-resistant) LRU. Newly inserted objects land in a
+   * probationary segment and are only promoted into a protected segment --
+   * sized at the given percentage of the shard's byte budget -- once they
+   * are hit again. Evictions drain the probationary segment first, so a
+   * one-off scan over many cold objects (e.g. a recursive status walk)
+   * churns the probationary segment without evicting the hot working set. A
+   * value of 0 keeps the historical single-queue LRU behavior.
+   *
+   * evictionExecutor, when non-null, moves eviction off the inserting
+   * thread: inserts that push a shard over its byte budget only enqueue an
+   * eviction task to the executor instead of evicting inline while the shard
+   * lock is held. The shard may transiently exceed its budget until the task
+   * runs. When null, inserts evict inline as before.
+   */
   static std::shared_ptr<ObjectCache<ObjectType, Flavor>> create(
       size_t maximumCacheSizeBytes,
-      size_t minimumEntryCount);
+      size_t minimumEntryCount,
+      size_t shardCount = 1,
+      size_t protectedSegmentPercent = 0,
+      std::shared_ptr<folly::Executor> evictionExecutor = nullptr);
   ~ObjectCache() {
     clear();
   }
@@ -191,6 +275,11 @@ class ObjectCache
    *
    * Optionally returns an interest handle that, when dropped, evicts the
    * inserted object.
+   *
+   * An UnlikelyNeededAgain insert may be silently bypassed when recent
+   * inserts of that class have mostly been evicted without ever being hit;
+   * see the kSpeculativeWaste constants. The returned handle still
+   * references the object either way.
    */
   template <ObjectCacheFlavor F = Flavor>
   typename std::enable_if_t<
@@ -221,6 +310,21 @@ class ObjectCache
    */
   void clear();
 
+  /**
+   * Registers a callback invoked with each object evicted to make room for
+   * new insertions. Interest-handle drops and clear() do not count: those
+   * objects were given up on, not squeezed out. Intended for layering a
+   * victim tier behind the cache.
+   *
+   * The callback runs while the owning shard's lock is held, so it must be
+   * reasonably quick and must not call back into this cache. Must be set
+   * before the cache is shared between threads.
+   */
+  void setEvictionCallback(
+      folly::Function<void(const ObjectId&, const ObjectPtr&)> callback) {
+    evictionCallback_ = std::move(callback);
+  }
+
   /**
    * Return information about the current size of the cache and the total number
    * of hits and misses.
@@ -228,7 +332,12 @@ class ObjectCache
   Stats getStats() const;
 
  protected:
-  explicit ObjectCache(size_t maximumCacheSizeBytes, size_t minimumEntryCount);
+  explicit ObjectCache(
+      size_t maximumCacheSizeBytes,
+      size_t minimumEntryCount,
+      size_t shardCount = 1,
+      size_t protectedSegmentPercent = 0,
+      std::shared_ptr<folly::Executor> evictionExecutor = nullptr);
 
  private:
   /*
@@ -261,6 +370,10 @@ class ObjectCache
     ObjectPtr object;
     folly::SafeIntrusiveListHook hook;
 
+    /// The value of accessSequence_ when this item was last inserted or hit.
+    /// Guarded by the owning shard's lock.
+    uint64_t lastAccessSeq{0};
+
     /// Incremented on every LikelyNeededAgain or WantInterestHandle.
     /// Decremented on every dropInterestHandle. Evicted if it reaches zero.
     uint64_t referenceCount{0};
@@ -268,15 +381,43 @@ class ObjectCache
     /// Given a unique value upon allocation. Used to verify InterestHandle
     /// matches this specific item.
     uint64_t generation{std::numeric_limits<uint64_t>::max()};
+
+    /// True when the item lives in the protected segment of a segmented
+    /// shard. Always false when segmentation is disabled.
+    bool isProtected{false};
+
+    /// True once the item has been hit (or redundantly inserted) after its
+    /// insertion. An item evicted with this still false was cached for
+    /// nothing. Guarded by the owning shard's lock.
+    bool accessedSinceInsert{false};
+
+    /// The Interest the item was inserted with, for attributing wasted
+    /// evictions. Simple-flavor caches leave the default. Guarded by the
+    /// owning shard's lock.
+    Interest insertionInterest{Interest::LikelyNeededAgain};
   };
 
   struct State {
     size_t totalSize{0};
     folly::F14NodeMap<ObjectId, CacheItem> items;
 
-    /// Entries are evicted from the front of the queue.
+    /// Entries are evicted from the front of the queue. With segmentation
+    /// enabled this is the probationary segment; without it, this is the
+    /// only queue.
     folly::CountedIntrusiveList<CacheItem, &CacheItem::hook> evictionQueue;
 
+    /// Protected segment of a segmented shard. Hits in the probationary
+    /// queue promote items here; this queue is only drained once the
+    /// probationary queue is empty or when it outgrows its byte budget.
+    folly::CountedIntrusiveList<CacheItem, &CacheItem::hook> protectedQueue;
+
+    /// Total byte size of the items in protectedQueue.
+    size_t protectedSize{0};
+
+    /// True while a background eviction task for this shard is queued on
+    /// evictionExecutor_, so a burst of inserts enqueues only one task.
+    bool evictionScheduled{false};
+
     uint64_t hitCount{0};
     uint64_t missCount{0};
     uint64_t evictionCount{0};
@@ -305,13 +446,94 @@ class ObjectCache
 
   void dropInterestHandle(const ObjectId& hash, uint64_t generation) noexcept;
 
+  /**
+   * Records a fresh insert in the per-interest counters and, for
+   * speculative inserts, in the decayed window feeding the waste gate.
+   */
+  void recordInsert(Interest interest) noexcept;
+
+  /**
+   * Returns false when the speculative waste gate is closed and this insert
+   * is not one of the periodic probes. See the kSpeculativeWaste constants.
+   */
+  bool admitSpeculativeInsert() noexcept;
+
+  /**
+   * Called for capacity evictions; counts the eviction as wasted if the
+   * item was never hit after insertion.
+   */
+  void recordUnusedEviction(const CacheItem& item) noexcept;
+
+  void notifyEviction(const CacheItem& item) noexcept;
+
   void evictUntilFits(State& state) noexcept;
   void evictOne(State& state) noexcept;
   void evictItem(State&, const CacheItem& item) noexcept;
 
-  const size_t maximumCacheSizeBytes_;
-  const size_t minimumEntryCount_;
-  folly::Synchronized<State, folly::DistributedMutex> state_;
+  /**
+   * Returns the shard that owns the given hash. Every operation on a single
+   * object only touches its owning shard, so operations on objects living in
+   * different shards never contend.
+   */
+  folly::Synchronized<State, folly::DistributedMutex>& shardFor(
+      const ObjectId& hash) {
+    return shards_[hash.getHashCode() % shards_.size()];
+  }
+
+  const folly::Synchronized<State, folly::DistributedMutex>& shardFor(
+      const ObjectId& hash) const {
+    return shards_[hash.getHashCode() % shards_.size()];
+  }
+
+  bool isSegmented() const {
+    return protectedShardSizeBytes_ != 0;
+  }
+
+  /// Per-shard slice of the total size budget.
+  const size_t maximumShardSizeBytes_;
+  /// Per-shard slice of the minimum entry count.
+  const size_t minimumShardEntryCount_;
+  /// Per-shard byte budget of the protected segment; 0 disables
+  /// segmentation.
+  const size_t protectedShardSizeBytes_;
+  /// When set, eviction runs on this executor instead of inline in the
+  /// inserting thread.
+  const std::shared_ptr<folly::Executor> evictionExecutor_;
+  std::vector<folly::Synchronized<State, folly::DistributedMutex>> shards_;
+
+  /// Invoked for objects evicted to make room; see setEvictionCallback().
+  folly::Function<void(const ObjectId&, const ObjectPtr&)> evictionCallback_;
+
+  /// Counts every get and insert across all shards. Used to timestamp items
+  /// so hits can compute their reuse distance.
+  std::atomic<uint64_t> accessSequence_{0};
+
+  /// Log2 histogram of reuse distances: on each hit, the number of cache
+  /// accesses since the item was last touched is recorded here. A hit with
+  /// reuse distance d would still have been a hit in any cache that retains
+  /// at least the last d accessed objects, so integrating this histogram
+  /// estimates the hit rate a different cache size would achieve.
+  std::array<std::atomic<uint64_t>, kReuseDistanceBucketCount>
+      reuseDistanceBuckets_{};
+
+  /// Cumulative per-interest insert and wasted-eviction counters reported
+  /// through getStats().
+  std::array<std::atomic<uint64_t>, kInterestCount> insertsByInterest_{};
+  std::array<std::atomic<uint64_t>, kInterestCount>
+      unusedEvictionsByInterest_{};
+  std::atomic<uint64_t> speculativeBypassCount_{0};
+
+  /// Decayed counters feeding the speculative waste gate. Both are halved
+  /// whenever the insert counter reaches kSpeculativeWasteWindow, so the
+  /// gate tracks recent behavior rather than all-time averages. The updates
+  /// race benignly: the gate is a heuristic and a slightly stale ratio only
+  /// delays it by a few inserts.
+  std::atomic<uint64_t> speculativeWindowInserts_{0};
+  std::atomic<uint64_t> speculativeWindowUnusedEvictions_{0};
+
+  /// Counts gate-closed speculative inserts so that every
+  /// kSpeculativeProbeInterval-th one is admitted as a probe.
+  std::atomic<uint64_t> speculativeProbeCounter_{0};
 
   friend class ObjectInterestHandle<ObjectType>;
 };
@@ -7,6 +7,8 @@
 
 #pragma once
 
+#include <folly/CancellationToken.h>
+#include <chrono>
 #include <optional>
 #include <string_view>
 #include <unordered_map>
@@ -18,6 +20,7 @@
 namespace facebook::eden {
 
 class ObjectId;
+class RequestSpanRecorder;
 
 class ObjectFetchContext;
 
@@ -86,6 +89,55 @@ class ObjectFetchContext : public RefCounted {
     return kDefaultImportPriority;
   }
 
+  /**
+   * An identifier for the mount this fetch originated from. Several mounts
+   * can share one backing store and thus one import queue; the queue uses
+   * this key to bound how many in-flight imports a single mount may occupy,
+   * so a massive prefetch on one mount cannot monopolize the worker pool.
+   * Contexts that do not know their mount share the anonymous group.
+   */
+  virtual std::optional<std::string_view> getMountId() const {
+    return std::nullopt;
+  }
+
+  /**
+   * An optional deadline for fetches issued under this context. The deadline
+   * is propagated into the import queue, where requests with a nearer
+   * deadline are dispatched ahead of equal-priority requests without one, so
+   * interactive calls are not starved behind large batches of background
+   * traffic. A request whose deadline has already passed when it is dequeued
+   * is failed immediately instead of dispatched, so a deadline also bounds
+   * how long a hopeless fetch may occupy a queue slot.
+   */
+  virtual std::optional<std::chrono::steady_clock::time_point> getDeadline()
+      const {
+    return std::nullopt;
+  }
+
+  /**
+   * A cancellation token for the client request that initiated this fetch.
+   * Long walks (diff, glob) poll it between directories and the import queue
+   * drops queued-but-unstarted fetches whose every requester has cancelled,
+   * so work issued on behalf of an abandoned request stops consuming workers
+   * and import bandwidth. The default token can never fire.
+   */
+  virtual folly::CancellationToken getCancellationToken() const {
+    return {};
+  }
+
+  bool isCancelled() const {
+    return getCancellationToken().isCancellationRequested();
+  }
+
+  /**
+   * The slow-request span recorder of the filesystem request that initiated
+   * this fetch, if one is attached. Lower layers use this to timestamp
+   * critical-path stages of a request as it moves through the object store.
+   */
+  virtual RequestSpanRecorder* getSpanRecorder() const {
+    return nullptr;
+  }
+
   // RequestInfo keys used by ReCasBackingStore
   inline static const std::string kSessionIdField = "session-id";
   inline static const std::string kCacheSessionIdField = "cache-session-id";
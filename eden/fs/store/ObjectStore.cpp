@@ -21,6 +21,7 @@
 #include "eden/fs/store/ObjectFetchContext.h"
 #include "eden/fs/store/TreeCache.h"
 #include "eden/fs/telemetry/EdenStats.h"
+#include "eden/fs/telemetry/RequestSpanRecorder.h"
 #include "eden/fs/telemetry/StructuredLogger.h"
 #include "eden/fs/telemetry/TaskTrace.h"
 #include "eden/fs/utils/Bug.h"
@@ -69,6 +70,8 @@ ObjectStore::ObjectStore(
     bool windowsSymlinksEnabled,
     CaseSensitivity caseSensitive)
     : metadataCache_{folly::in_place, kCacheSize},
+      auxDataMissCache_{folly::in_place, kAuxDataMissCacheSize},
+      metadataFetchLeases_{kMetadataFetchLeaseSize},
       treeCache_{std::move(treeCache)},
       backingStore_{std::move(backingStore)},
       stats_{std::move(stats)},
@@ -80,6 +83,11 @@ ObjectStore::ObjectStore(
       windowsSymlinksEnabled_{windowsSymlinksEnabled} {
   XCHECK(backingStore_);
   XCHECK(stats_);
+  const auto& maybeBlakeKey = edenConfig_->blake3Key.getValue();
+  if (maybeBlakeKey) {
+    blake3Key_ = Blake3::Key{folly::ByteRange{folly::StringPiece{
+        maybeBlakeKey->data(), maybeBlakeKey->size()}}};
+  }
 }
 
 ObjectStore::~ObjectStore() {}
@@ -201,6 +209,9 @@ ImmediateFuture<shared_ptr<const Tree>> ObjectStore::getTree(
     const ObjectFetchContextPtr& fetchContext) const {
   TaskTraceBlock block{"ObjectStore::getTree"};
   DurationScope statScope{stats_, &ObjectStoreStats::getTree};
+  if (auto* spanRecorder = fetchContext->getSpanRecorder()) {
+    spanRecorder->addStage("store_get_tree");
+  }
 
   // Check in the LocalStore first
 
@@ -248,6 +259,87 @@ ImmediateFuture<shared_ptr<const Tree>> ObjectStore::getTree(
       });
 }
 
+ImmediateFuture<std::vector<TreePtr>> ObjectStore::getTrees(
+    ObjectIdRange ids,
+    const ObjectFetchContextPtr& fetchContext) const {
+  // Dedupe the requested IDs so each unique tree is only fetched once, and
+  // remember where each unique tree needs to be copied in the result.
+  std::unordered_map<ObjectId, std::vector<size_t>> resultIndices;
+  for (size_t i = 0; i < ids.size(); i++) {
+    resultIndices[ids[i]].push_back(i);
+  }
+
+  auto results = std::make_shared<std::vector<TreePtr>>(ids.size());
+  std::vector<ImmediateFuture<folly::Unit>> futures;
+  futures.reserve(resultIndices.size());
+
+  // Probe the TreeCache for every unique ID up front so only the misses turn
+  // into BackingStore fetches. The BackingStore sees the misses
+  // back-to-back, giving its import queue the chance to batch them.
+  for (auto& [id, indices] : resultIndices) {
+    futures.push_back(getTree(id, fetchContext)
+                          .thenValue([results, indices = std::move(indices)](
+                                         TreePtr tree) {
+                            for (auto index : indices) {
+                              (*results)[index] = tree;
+                            }
+                            return folly::unit;
+                          }));
+  }
+
+  return collectAllSafe(std::move(futures))
+      .thenValue(
+          [results](std::vector<folly::Unit>&&) { return std::move(*results); });
+}
+
+ImmediateFuture<std::vector<std::shared_ptr<const Blob>>> ObjectStore::getBlobs(
+    ObjectIdRange ids,
+    const ObjectFetchContextPtr& fetchContext) const {
+  // Dedupe the requested IDs so each unique blob is only fetched once, and
+  // remember where each unique blob needs to be copied in the result.
+  std::unordered_map<ObjectId, std::vector<size_t>> resultIndices;
+  for (size_t i = 0; i < ids.size(); i++) {
+    resultIndices[ids[i]].push_back(i);
+  }
+
+  auto uniqueIds = std::make_shared<std::vector<ObjectId>>();
+  uniqueIds->reserve(resultIndices.size());
+  for (const auto& [id, indices] : resultIndices) {
+    uniqueIds->push_back(id);
+  }
+
+  auto results =
+      std::make_shared<std::vector<std::shared_ptr<const Blob>>>(ids.size());
+
+  // Hand the entire batch to the BackingStore as one prefetch so its local
+  // cache is warmed with a single round trip, then resolve the individual
+  // blobs, which will now mostly be served locally.
+  return prefetchBlobs(
+             ObjectIdRange{uniqueIds->data(), uniqueIds->size()}, fetchContext)
+      .thenValue([self = shared_from_this(),
+                  fetchContext = fetchContext.copy(),
+                  resultIndices = std::move(resultIndices),
+                  uniqueIds,
+                  results](folly::Unit) mutable {
+        std::vector<ImmediateFuture<folly::Unit>> futures;
+        futures.reserve(resultIndices.size());
+        for (auto& [id, indices] : resultIndices) {
+          futures.push_back(
+              self->getBlob(id, fetchContext)
+                  .thenValue([results, indices = std::move(indices)](
+                                 std::shared_ptr<const Blob> blob) {
+                    for (auto index : indices) {
+                      (*results)[index] = blob;
+                    }
+                    return folly::unit;
+                  }));
+        }
+        return collectAllSafe(std::move(futures));
+      })
+      .thenValue(
+          [results](std::vector<folly::Unit>&&) { return std::move(*results); });
+}
+
 ImmediateFuture<folly::Unit> ObjectStore::prefetchBlobs(
     ObjectIdRange ids,
     const ObjectFetchContextPtr& fetchContext) const {
@@ -269,6 +361,9 @@ ImmediateFuture<shared_ptr<const Blob>> ObjectStore::getBlob(
     const ObjectId& id,
     const ObjectFetchContextPtr& fetchContext) const {
   DurationScope statScope{stats_, &ObjectStoreStats::getBlob};
+  if (auto* spanRecorder = fetchContext->getSpanRecorder()) {
+    spanRecorder->addStage("store_get_blob");
+  }
 
   deprioritizeWhenFetchHeavy(*fetchContext);
   return ImmediateFuture<BackingStore::GetBlobResult>{
@@ -312,6 +407,21 @@ std::optional<BlobMetadata> ObjectStore::getBlobMetadataFromInMemoryCache(
   return std::nullopt;
 }
 
+ImmediateFuture<BlobMetadata> ObjectStore::computeBlobMetadataFromBlob(
+    const ObjectId& id,
+    const ObjectFetchContextPtr& fetchContext) const {
+  return getBlob(id, fetchContext)
+      .thenValue([self = shared_from_this(), id](auto&& blob) {
+        self->stats_->increment(&ObjectStoreStats::getBlobMetadataFromBlob);
+        BlobMetadata metadata{
+            Hash20::sha1(blob->getContents()),
+            self->computeBlake3(*blob),
+            blob->getSize()};
+        self->metadataCache_.wlock()->set(id, metadata);
+        return metadata;
+      });
+}
+
 ImmediateFuture<BlobMetadata> ObjectStore::getBlobMetadata(
     const ObjectId& id,
     const ObjectFetchContextPtr& fetchContext,
@@ -341,6 +451,44 @@ ImmediateFuture<BlobMetadata> ObjectStore::getBlobMetadata(
     return std::move(inMemoryCacheBlobMetadata).value();
   }
 
+  // Everyone below misses the in-memory cache and would repeat the same
+  // BackingStore work, so concurrent identical requests attach to a single
+  // in-flight lease instead.
+  auto lease = metadataFetchLeases_.get(
+      id,
+      [self = shared_from_this(),
+       fetchContext = fetchContext.copy(),
+       blake3Needed](const ObjectId& leaseId) {
+        return self->fetchBlobMetadata(leaseId, fetchContext, blake3Needed)
+            .thenTry([self, leaseId](folly::Try<BlobMetadata> result) {
+              // Drop the lease before fulfilling it so a later failure is
+              // retried rather than replayed from the lease cache.
+              self->metadataFetchLeases_.erase(leaseId);
+              return std::make_shared<BlobMetadata>(
+                  std::move(result).value());
+            })
+            .semi()
+            .toUnsafeFuture();
+      });
+  return ImmediateFuture<std::shared_ptr<BlobMetadata>>{std::move(lease).semi()}
+      .thenValue([statScope = std::move(statScope)](
+                     std::shared_ptr<BlobMetadata> metadata) {
+        return *metadata;
+      });
+}
+
+ImmediateFuture<BlobMetadata> ObjectStore::fetchBlobMetadata(
+    const ObjectId& id,
+    const ObjectFetchContextPtr& fetchContext,
+    bool blake3Needed) const {
+  // If the BackingStore is already known to not have aux data for this
+  // object, skip the pointless probe and derive the metadata from the blob
+  // contents directly.
+  if (auxDataMissCache_.rlock()->exists(id)) {
+    stats_->increment(&ObjectStoreStats::getBlobMetadataFromAuxMissCache);
+    return computeBlobMetadataFromBlob(id, fetchContext);
+  }
+
   deprioritizeWhenFetchHeavy(*fetchContext);
 
   return ImmediateFuture<BackingStore::GetBlobMetaResult>{
@@ -349,13 +497,17 @@ ImmediateFuture<BlobMetadata> ObjectStore::getBlobMetadata(
           [self = shared_from_this(),
            fetchContext = fetchContext.copy(),
            id,
-           statScope = std::move(statScope),
            blake3Needed](BackingStore::GetBlobMetaResult result)
               -> ImmediateFuture<BlobMetadata> {
             if (!result.blobMeta) {
               self->stats_->increment(&ObjectStoreStats::getBlobMetadataFailed);
-              XLOG(DBG2) << "unable to find aux data for " << id;
-              throwf<std::domain_error>("aux data {} not found", id);
+              XLOG(DBG2) << "unable to find aux data for " << id
+                         << ", computing it from the blob";
+              // Remember the miss so future metadata queries for this object
+              // don't have to re-probe the BackingStore before falling back
+              // to the blob.
+              self->auxDataMissCache_.wlock()->set(id, true);
+              return self->computeBlobMetadataFromBlob(id, fetchContext);
             }
 
             auto metadata = std::move(result.blobMeta);
@@ -386,6 +538,40 @@ ImmediateFuture<BlobMetadata> ObjectStore::getBlobMetadata(
           });
 }
 
+ImmediateFuture<std::vector<BlobMetadata>> ObjectStore::getBlobMetadatas(
+    ObjectIdRange ids,
+    const ObjectFetchContextPtr& fetchContext) const {
+  // Dedupe the requested IDs so each unique blob's metadata is only resolved
+  // once, and remember where each result needs to be copied.
+  std::unordered_map<ObjectId, std::vector<size_t>> resultIndices;
+  for (size_t i = 0; i < ids.size(); i++) {
+    resultIndices[ids[i]].push_back(i);
+  }
+
+  auto results = std::make_shared<std::vector<BlobMetadata>>(
+      ids.size(), BlobMetadata{Hash20{}, std::nullopt, 0});
+  std::vector<ImmediateFuture<folly::Unit>> futures;
+  futures.reserve(resultIndices.size());
+
+  // Probe the in-memory metadata cache for every unique ID up front so only
+  // the misses turn into BackingStore fetches. The BackingStore sees the
+  // misses back-to-back, giving its import queue the chance to batch them.
+  for (auto& [id, indices] : resultIndices) {
+    futures.push_back(getBlobMetadata(id, fetchContext)
+                          .thenValue([results, indices = std::move(indices)](
+                                         BlobMetadata metadata) {
+                            for (auto index : indices) {
+                              (*results)[index] = metadata;
+                            }
+                            return folly::unit;
+                          }));
+  }
+
+  return collectAllSafe(std::move(futures))
+      .thenValue(
+          [results](std::vector<folly::Unit>&&) { return std::move(*results); });
+}
+
 ImmediateFuture<uint64_t> ObjectStore::getBlobSize(
     const ObjectId& id,
     const ObjectFetchContextPtr& context) const {
@@ -401,13 +587,14 @@ ImmediateFuture<Hash20> ObjectStore::getBlobSha1(
 }
 
 Hash32 ObjectStore::computeBlake3(const Blob& blob) const {
-  const auto content = blob.getContents();
-  const auto& maybeBlakeKey = edenConfig_->blake3Key.getValue();
-  return maybeBlakeKey ? Hash32::keyedBlake3(
-                             folly::ByteRange{folly::StringPiece{
-                                 maybeBlakeKey->data(), maybeBlakeKey->size()}},
-                             content)
-                       : Hash32::blake3(content);
+  auto hasher = blake3Key_ ? Blake3{*blake3Key_} : Blake3{};
+  for (const auto r : blob.getContents()) {
+    hasher.update(r.data(), r.size());
+  }
+
+  Hash32 blake3;
+  hasher.finalize(blake3.mutableBytes());
+  return blake3;
 }
 
 ImmediateFuture<Hash32> ObjectStore::getBlobBlake3(
@@ -11,8 +11,10 @@
 #include <folly/container/EvictingCacheMap.h>
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
 #include <folly/logging/xlog.h>
+#include "eden/fs/digest/Blake3.h"
 #include "eden/fs/model/BlobMetadata.h"
 #include "eden/fs/model/Hash.h"
 #include "eden/fs/model/RootId.h"
@@ -23,6 +25,7 @@
 #include "eden/fs/store/ImportPriority.h"
 #include "eden/fs/store/ObjectFetchContext.h"
 #include "eden/fs/utils/CaseSensitivity.h"
+#include "eden/fs/utils/LeaseCache.h"
 #include "eden/fs/utils/RefPtr.h"
 
 namespace facebook::eden {
@@ -195,6 +198,35 @@ class ObjectStore : public IObjectStore,
       const ObjectId& id,
       const ObjectFetchContextPtr& context) const override;
 
+  /**
+   * Get multiple Blobs by ID in a single batch.
+   *
+   * Duplicate IDs are only fetched once, and misses are handed to the
+   * BackingStore as a single prefetch batch before being resolved, rather
+   * than as independent round trips. The returned blobs are in the same
+   * order as the passed in IDs.
+   *
+   * The caller is responsible for making sure that the ObjectIdRange stays
+   * valid for as long as the returned ImmediateFuture.
+   */
+  ImmediateFuture<std::vector<std::shared_ptr<const Blob>>> getBlobs(
+      ObjectIdRange ids,
+      const ObjectFetchContextPtr& context) const;
+
+  /**
+   * Get multiple Trees by ID in a single batch.
+   *
+   * Duplicate IDs are only fetched once, and the TreeCache is probed for all
+   * IDs up front so only misses reach the BackingStore. The returned trees
+   * are in the same order as the passed in IDs.
+   *
+   * The caller is responsible for making sure that the ObjectIdRange stays
+   * valid for as long as the returned ImmediateFuture.
+   */
+  ImmediateFuture<std::vector<TreePtr>> getTrees(
+      ObjectIdRange ids,
+      const ObjectFetchContextPtr& context) const;
+
   /**
    * Get metadata about a Blob.
    *
@@ -207,6 +239,22 @@ class ObjectStore : public IObjectStore,
       const ObjectFetchContextPtr& context,
       bool blake3Needed = false) const;
 
+  /**
+   * Get metadata about multiple Blobs in a single batch.
+   *
+   * Duplicate IDs are only resolved once. Each unique ID probes the
+   * in-memory metadata cache first, so only misses reach the BackingStore,
+   * and those are issued back-to-back so its import queue can batch them
+   * into one round trip. The returned metadata is in the same order as the
+   * passed in IDs.
+   *
+   * The caller is responsible for making sure that the ObjectIdRange stays
+   * valid for as long as the returned ImmediateFuture.
+   */
+  ImmediateFuture<std::vector<BlobMetadata>> getBlobMetadatas(
+      ObjectIdRange ids,
+      const ObjectFetchContextPtr& context) const;
+
   /**
    * Get metadata about a Blob from EdenFS's in memory BlobMetadata cache.
    *
@@ -306,7 +354,29 @@ class ObjectStore : public IObjectStore,
 
   Hash32 computeBlake3(const Blob& blob) const;
 
+  /**
+   * Fetch the blob and derive its full metadata (SHA-1, Blake3 and size) from
+   * the contents. The result is stored in the in-memory metadata cache so the
+   * blob doesn't have to be imported again for subsequent metadata queries.
+   */
+  ImmediateFuture<BlobMetadata> computeBlobMetadataFromBlob(
+      const ObjectId& id,
+      const ObjectFetchContextPtr& fetchContext) const;
+
+  /**
+   * The slow path of getBlobMetadata: resolve the metadata from the
+   * BackingStore, falling back to deriving it from the blob contents, and
+   * populate the in-memory metadata cache. Callers must have already missed
+   * in metadataCache_.
+   */
+  ImmediateFuture<BlobMetadata> fetchBlobMetadata(
+      const ObjectId& id,
+      const ObjectFetchContextPtr& fetchContext,
+      bool blake3Needed) const;
+
   static constexpr size_t kCacheSize = 1000000;
+  static constexpr size_t kAuxDataMissCacheSize = 100000;
+  static constexpr size_t kMetadataFetchLeaseSize = 4096;
 
   /**
    * During status and checkout, it's common to look up the SHA-1 for a given
@@ -325,6 +395,27 @@ class ObjectStore : public IObjectStore,
   mutable folly::Synchronized<folly::EvictingCacheMap<ObjectId, BlobMetadata>>
       metadataCache_;
 
+  /**
+   * Negative cache of objects whose aux data is known to be missing from the
+   * BackingStore. For these objects, metadata must be derived by importing
+   * the whole blob and hashing it. Remembering the misses lets us skip the
+   * pointless BackingStore aux data probe and, combined with metadataCache_,
+   * ensures the expensive blob import and hash only happens once per object
+   * instead of every time a build system stats the same generated file.
+   */
+  mutable folly::Synchronized<folly::EvictingCacheMap<ObjectId, bool>>
+      auxDataMissCache_;
+
+  /**
+   * Collapses concurrent metadata fetches for the same object onto one
+   * BackingStore request. Wide fanout - getAttributesFromFiles statting the
+   * same generated file from 100 threads - otherwise issues that many
+   * identical fetches, all missing metadataCache_ before the first one
+   * lands. Leases are erased once the fetch completes; the bound only
+   * matters if something leaks.
+   */
+  mutable LeaseCache<ObjectId, BlobMetadata> metadataFetchLeases_;
+
   /**
    * During glob, we need to read a lot of trees, but we avoid loading inodes,
    * so this means we go to RocksDB for each tree read. To avoid needing to hit
@@ -359,6 +450,13 @@ class ObjectStore : public IObjectStore,
   std::shared_ptr<StructuredLogger> structuredLogger_;
   std::shared_ptr<const EdenConfig> edenConfig_;
 
+  /**
+   * The configured BLAKE3 key, parsed and validated once so per-blob hash
+   * computation does not re-check it. The config snapshot above is fixed
+   * for this ObjectStore's lifetime, so the key cannot change under us.
+   */
+  std::optional<Blake3::Key> blake3Key_;
+
   // Is this ObjectStore case sensitive? This only matters for methods returning
   // Tree.
   CaseSensitivity caseSensitive_;
@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#ifndef _WIN32
+
+#include "eden/fs/store/PackedBlobMetadata.h"
+
+#include <algorithm>
+
+#include <folly/Conv.h>
+#include <folly/Exception.h>
+#include <folly/logging/xlog.h>
+
+namespace facebook::eden {
+
+namespace detail {
+
+PackedBlobMetadataRecord::PackedBlobMetadataRecord(
+    folly::ByteRange id,
+    const BlobMetadata& metadata)
+    : size{metadata.size},
+      keyLength{static_cast<uint8_t>(id.size())},
+      hasBlake3{metadata.blake3.has_value()} {
+  XDCHECK_LE(id.size(), kMaxKeyLength);
+  memset(key, 0, sizeof(key));
+  memcpy(key, id.data(), id.size());
+  memcpy(sha1, metadata.sha1.getBytes().data(), sizeof(sha1));
+  if (metadata.blake3.has_value()) {
+    memcpy(blake3, metadata.blake3->getBytes().data(), sizeof(blake3));
+  } else {
+    memset(blake3, 0, sizeof(blake3));
+  }
+}
+
+int PackedBlobMetadataRecord::compareKey(folly::ByteRange id) const {
+  auto commonLength = std::min<size_t>(keyLength, id.size());
+  if (int cmp = memcmp(key, id.data(), commonLength)) {
+    return cmp;
+  }
+  return keyLength < id.size() ? -1 : keyLength > id.size() ? 1 : 0;
+}
+
+BlobMetadata PackedBlobMetadataRecord::toBlobMetadata() const {
+  std::optional<Hash32> blake3Hash;
+  if (hasBlake3) {
+    blake3Hash = Hash32{folly::ByteRange{blake3, sizeof(blake3)}};
+  }
+  return BlobMetadata{
+      Hash20{folly::ByteRange{sha1, sizeof(sha1)}}, blake3Hash, size};
+}
+
+} // namespace detail
+
+namespace {
+
+using Record = detail::PackedBlobMetadataRecord;
+using Segment = MappedDiskVector<Record>;
+
+Segment openSegment(const std::string& path) {
+  try {
+    return Segment::open(path);
+  } catch (const std::exception& ex) {
+    // The segment is only a cache of records that still live in the
+    // key-value store, so anything unreadable is simply thrown away.
+    XLOG(WARNING) << "discarding unreadable packed blob metadata segment "
+                  << path << ": " << ex.what();
+    return Segment::createOrOverwrite(path);
+  }
+}
+
+} // namespace
+
+PackedBlobMetadata::PackedBlobMetadata(AbsolutePathPiece path)
+    : path_{path.asString()}, segment_{openSegment(path_)} {}
+
+std::optional<BlobMetadata> PackedBlobMetadata::get(const ObjectId& id) const {
+  auto idBytes = id.getBytes();
+  if (idBytes.size() > Record::kMaxKeyLength) {
+    return std::nullopt;
+  }
+
+  {
+    auto staged = staged_.rlock();
+    auto it = staged->find(
+        std::string{reinterpret_cast<const char*>(idBytes.data()),
+                    idBytes.size()});
+    if (it != staged->end()) {
+      return it->second;
+    }
+  }
+
+  auto segment = segment_.rlock();
+  size_t low = 0;
+  size_t high = segment->size();
+  while (low < high) {
+    size_t mid = low + (high - low) / 2;
+    int cmp = (*segment)[mid].compareKey(idBytes);
+    if (cmp < 0) {
+      low = mid + 1;
+    } else if (cmp > 0) {
+      high = mid;
+    } else {
+      return (*segment)[mid].toBlobMetadata();
+    }
+  }
+  return std::nullopt;
+}
+
+void PackedBlobMetadata::stage(
+    const ObjectId& id,
+    const BlobMetadata& metadata) {
+  auto idBytes = id.getBytes();
+  if (idBytes.size() > Record::kMaxKeyLength) {
+    return;
+  }
+
+  size_t stagedCount;
+  {
+    auto staged = staged_.wlock();
+    staged->insert_or_assign(
+        std::string{reinterpret_cast<const char*>(idBytes.data()),
+                    idBytes.size()},
+        metadata);
+    stagedCount = staged->size();
+  }
+
+  if (stagedCount >= kMaxStagedRecords) {
+    flush();
+  }
+}
+
+void PackedBlobMetadata::flush() {
+  // Hold the staging buffer's lock across the merge so a concurrent get()
+  // sees each record in at least one of the two tiers at all times.
+  auto staged = staged_.wlock();
+  if (staged->empty()) {
+    return;
+  }
+
+  auto segment = segment_.wlock();
+
+  auto tmpPath = folly::to<std::string>(path_, ".tmp");
+  auto newSegment = Segment::createOrOverwrite(tmpPath);
+  try {
+    // Both tiers are sorted in the same order, so this is a plain linear
+    // merge. Staged records win on a duplicate key; metadata is content
+    // addressed so the values are identical anyway.
+    size_t packedIndex = 0;
+    for (const auto& [key, metadata] : *staged) {
+      auto keyBytes = folly::ByteRange{
+          reinterpret_cast<const uint8_t*>(key.data()), key.size()};
+      while (packedIndex < segment->size() &&
+             (*segment)[packedIndex].compareKey(keyBytes) < 0) {
+        newSegment.emplace_back((*segment)[packedIndex]);
+        ++packedIndex;
+      }
+      if (packedIndex < segment->size() &&
+          (*segment)[packedIndex].compareKey(keyBytes) == 0) {
+        ++packedIndex;
+      }
+      newSegment.emplace_back(keyBytes, metadata);
+    }
+    while (packedIndex < segment->size()) {
+      newSegment.emplace_back((*segment)[packedIndex]);
+      ++packedIndex;
+    }
+
+    if (rename(tmpPath.c_str(), path_.c_str())) {
+      folly::throwSystemError(
+          "rename() failed while flushing packed blob metadata");
+    }
+  } catch (const std::exception& ex) {
+    XLOG(WARNING) << "failed to flush packed blob metadata to " << path_
+                  << ": " << ex.what();
+    unlink(tmpPath.c_str());
+    return;
+  }
+
+  // newSegment's file descriptor now refers to the renamed segment, so it
+  // can simply replace the old mapping.
+  *segment = std::move(newSegment);
+  staged->clear();
+}
+
+void PackedBlobMetadata::clear() {
+  auto staged = staged_.wlock();
+  auto segment = segment_.wlock();
+  staged->clear();
+  *segment = Segment::createOrOverwrite(path_);
+}
+
+size_t PackedBlobMetadata::packedRecordCount() const {
+  return segment_.rlock()->size();
+}
+
+} // namespace facebook::eden
+
+#endif
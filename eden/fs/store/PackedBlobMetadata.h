@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#pragma once
+
+#ifndef _WIN32
+
+#include <cstring>
+#include <map>
+#include <optional>
+#include <string>
+
+#include <folly/Synchronized.h>
+
+#include "eden/fs/model/BlobMetadata.h"
+#include "eden/fs/model/ObjectId.h"
+#include "eden/fs/utils/MappedDiskVector.h"
+#include "eden/fs/utils/PathFuncs.h"
+
+namespace facebook::eden {
+
+namespace detail {
+
+/**
+ * One blob metadata entry in the packed segment.
+ *
+ * Records are fixed width so the segment can be memory-mapped and binary
+ * searched without any per-record parsing or allocation. ObjectIds are
+ * variable length, so the key is stored inline up to kMaxKeyLength bytes;
+ * longer IDs simply aren't packed and fall through to the key-value store.
+ */
+struct PackedBlobMetadataRecord {
+  enum { VERSION = 1 };
+
+  static constexpr size_t kMaxKeyLength = 32;
+
+  PackedBlobMetadataRecord(folly::ByteRange id, const BlobMetadata& metadata);
+
+  /**
+   * Compares this record's key to the given ObjectId bytes, with memcmp
+   * semantics. The ordering (lexicographic, shorter keys first on a shared
+   * prefix) matches std::string's operator< so the staging map and the
+   * segment sort identically.
+   */
+  int compareKey(folly::ByteRange id) const;
+
+  BlobMetadata toBlobMetadata() const;
+
+  uint64_t size;
+  uint8_t keyLength;
+  uint8_t hasBlake3;
+  uint8_t key[kMaxKeyLength];
+  uint8_t sha1[Hash20::RAW_SIZE];
+  uint8_t blake3[Hash32::RAW_SIZE];
+};
+
+} // namespace detail
+
+/**
+ * A packed, memory-mapped cache of BlobMetadata records maintained in front
+ * of the BlobMetaDataFamily key space.
+ *
+ * Batch stat workloads (e.g. a build's hash phase) read metadata for
+ * hundreds of thousands of blobs; answering each from the key-value store
+ * costs a point lookup plus value deserialization. This class keeps the
+ * same records as fixed-width entries in a single sorted, mmap'd segment,
+ * so a lookup is a binary search over shared pages and a hit allocates
+ * nothing but the returned BlobMetadata.
+ *
+ * Writes are staged in memory and merged into the segment when flush() is
+ * called (LocalStore does so from its periodic management task) or when the
+ * staging buffer grows large. The segment is strictly a cache: a miss falls
+ * through to the key-value store, and losing staged records in a crash only
+ * costs that fallback. Blob metadata is content addressed, so a packed
+ * record can never go stale.
+ *
+ * This class is thread-safe.
+ */
+class PackedBlobMetadata {
+ public:
+  /**
+   * Opens the packed segment at the given path, creating it if necessary.
+   * An unreadable or corrupt segment is discarded and recreated empty; it
+   * only caches data that is re-derivable from the key-value store.
+   */
+  explicit PackedBlobMetadata(AbsolutePathPiece path);
+
+  /**
+   * Looks up metadata for the given ID in the staging buffer and the packed
+   * segment. Returns std::nullopt on a miss.
+   */
+  std::optional<BlobMetadata> get(const ObjectId& id) const;
+
+  /**
+   * Records metadata for the given ID in the staging buffer. IDs longer
+   * than kMaxKeyLength are ignored.
+   */
+  void stage(const ObjectId& id, const BlobMetadata& metadata);
+
+  /**
+   * Merges the staging buffer into the packed segment. The merged segment
+   * is written to a temporary file and atomically renamed into place, so a
+   * crash mid-flush leaves the previous segment intact.
+   */
+  void flush();
+
+  /**
+   * Discards the staging buffer and the packed segment. Called when the
+   * BlobMetaDataFamily key space is cleared so the cache doesn't outlive
+   * the data it fronts.
+   */
+  void clear();
+
+  /**
+   * Returns the number of records in the packed segment. Primarily for
+   * tests and diagnostics.
+   */
+  size_t packedRecordCount() const;
+
+ private:
+  using Segment = MappedDiskVector<detail::PackedBlobMetadataRecord>;
+
+  /**
+   * Flushing inline when the staging buffer gets this large bounds memory
+   * during bulk imports at the cost of an occasional segment rewrite on a
+   * reader thread.
+   */
+  static constexpr size_t kMaxStagedRecords = 64 * 1024;
+
+  const std::string path_;
+
+  /**
+   * Keys are raw ObjectId bytes. std::map keeps the staged records in the
+   * same order as the segment, so flush() is a linear merge.
+   *
+   * Lock order: staged_ before segment_.
+   */
+  folly::Synchronized<std::map<std::string, BlobMetadata>> staged_;
+
+  folly::Synchronized<Segment> segment_;
+};
+
+} // namespace facebook::eden
+
+#endif
@@ -7,8 +7,11 @@
 
 #include "eden/fs/store/RocksDbLocalStore.h"
 
+#include <algorithm>
 #include <array>
 #include <atomic>
+#include <numeric>
+#include <optional>
 
 #include <fb303/ServiceData.h>
 #include <folly/String.h>
@@ -137,6 +140,9 @@ rocksdb::Slice _createSlice(folly::ByteRange bytes) {
   return Slice(reinterpret_cast<const char*>(bytes.data()), bytes.size());
 }
 
+using KeyFilterArray =
+    std::array<folly::Synchronized<KeyFilter>, KeySpace::kTotalCount>;
+
 class RocksDbWriteBatch : public LocalStore::WriteBatch {
  public:
   void put(KeySpace keySpace, folly::ByteRange key, folly::ByteRange value)
@@ -150,12 +156,16 @@ class RocksDbWriteBatch : public LocalStore::WriteBatch {
   // Use LocalStore::beginWrite() to create a write batch
   RocksDbWriteBatch(
       Synchronized<RocksDbLocalStore::RockDBState>::ConstRLockedPtr&& dbHandles,
+      KeyFilterArray* keyFilters,
       size_t bufferSize);
 
   void flushIfNeeded();
 
   folly::Synchronized<RocksDbLocalStore::RockDBState>::ConstRLockedPtr
       lockedDB_;
+  // Owned by the RocksDbLocalStore, which outlives the batch since the
+  // batch holds the DB handle lock.
+  KeyFilterArray* keyFilters_;
   rocksdb::WriteBatch writeBatch_;
   size_t bufSize_;
 };
@@ -190,9 +200,11 @@ void RocksDbWriteBatch::flushIfNeeded() {
 
 RocksDbWriteBatch::RocksDbWriteBatch(
     Synchronized<RocksDbLocalStore::RockDBState>::ConstRLockedPtr&& dbHandles,
+    KeyFilterArray* keyFilters,
     size_t bufSize)
     : LocalStore::WriteBatch(),
       lockedDB_(std::move(dbHandles)),
+      keyFilters_(keyFilters),
       writeBatch_(bufSize),
       bufSize_(bufSize) {}
 
@@ -207,6 +219,7 @@ void RocksDbWriteBatch::put(
     KeySpace keySpace,
     folly::ByteRange key,
     folly::ByteRange value) {
+  (*keyFilters_)[keySpace->index].wlock()->add(key);
   writeBatch_.Put(
       lockedDB_->handles->columns[keySpace->index].get(),
       _createSlice(key),
@@ -219,6 +232,7 @@ void RocksDbWriteBatch::put(
     KeySpace keySpace,
     folly::ByteRange key,
     std::vector<folly::ByteRange> valueSlices) {
+  (*keyFilters_)[keySpace->index].wlock()->add(key);
   std::vector<Slice> slices;
 
   for (auto& valueSlice : valueSlices) {
@@ -318,6 +332,13 @@ void RocksDbLocalStore::open() {
         std::make_unique<RocksHandles>(openDB(pathToDb_.piece(), mode_));
     handles->status = RockDbHandleStatus::OPEN;
   }
+  initializeKeyFilters();
+#ifndef _WIN32
+  // The packed blob metadata segment lives in the RocksDB directory.
+  // RocksDB only manages files matching its own naming scheme, so it
+  // leaves the segment alone.
+  enablePackedBlobMetadata(pathToDb_ + "packed-blob-metadata"_pc);
+#endif
   // Publish fb303 stats once when we first open the DB.
   // These will be kept up-to-date later by the periodicManagementTask() call.
   XLOG(DBG2) << "RocksDB opened, computing statistics ...";
@@ -384,6 +405,24 @@ void RocksDbLocalStore::repairDB(AbsolutePathPiece path) {
   }
 }
 
+void RocksDbLocalStore::initializeKeyFilters() {
+  auto handlesLock = getHandles();
+  auto& handles = handlesLock->handles;
+  for (auto& ks : KeySpace::kAll) {
+    uint64_t numKeys = 0;
+    auto haveEstimate = handles->db->GetIntProperty(
+        handles->columns[ks->index].get(),
+        rocksdb::DB::Properties::kEstimateNumKeys,
+        &numKeys);
+    auto enabled = ks->isEphemeral() && haveEstimate && numKeys == 0;
+    keyFilters_[ks->index].wlock()->reset(enabled);
+    if (enabled) {
+      XLOG(DBG2) << "enabling negative lookup filter for empty column family "
+                 << ks->name;
+    }
+  }
+}
+
 void RocksDbLocalStore::clearKeySpace(KeySpace keySpace) {
   auto handlesLock = getHandles();
   auto& handles = handlesLock->handles;
@@ -418,6 +457,10 @@ void RocksDbLocalStore::clearKeySpace(KeySpace keySpace) {
         columnFamily->GetName(),
         "\" column family");
   }
+
+  // The column family is now known to be empty, so the negative lookup
+  // filter can start answering precisely again.
+  keyFilters_[keySpace->index].wlock()->reset(keySpace->isEphemeral());
 }
 
 void RocksDbLocalStore::compactKeySpace(KeySpace keySpace) {
@@ -441,6 +484,10 @@ void RocksDbLocalStore::compactKeySpace(KeySpace keySpace) {
 
 StoreResult RocksDbLocalStore::get(KeySpace keySpace, ByteRange key) const {
   TaskTraceBlock block{"RocksDbLocalStore::get"};
+  ioOpCount_.fetch_add(1, std::memory_order_relaxed);
+  if (!keyFilters_[keySpace->index].rlock()->mightContain(key)) {
+    return StoreResult::missing(keySpace, key);
+  }
   auto handlesLock = getHandles();
   auto& handles = handlesLock->handles;
   string value;
@@ -470,6 +517,7 @@ FOLLY_NODISCARD folly::Future<std::vector<StoreResult>>
 RocksDbLocalStore::getBatch(
     KeySpace keySpace,
     const std::vector<folly::ByteRange>& keys) const {
+  ioOpCount_.fetch_add(keys.size(), std::memory_order_relaxed);
   std::vector<folly::Future<std::vector<StoreResult>>> futures;
 
   std::vector<std::shared_ptr<std::vector<std::string>>> batches;
@@ -494,25 +542,45 @@ RocksDbLocalStore::getBatch(
               XLOG(DBG3) << __func__ << " starting to actually do work";
               auto handlesLock = store->getHandles();
               auto& handles = handlesLock->handles;
+              auto numKeys = keys->size();
+
+              // All keys in a batch live in the same column family, so we
+              // can use the batched single-column-family MultiGet. Handing
+              // it the keys in sorted order lets RocksDB visit each SST
+              // block once instead of re-seeking per key, which is where
+              // most of the win comes from on bursty tree imports.
+              std::vector<size_t> order(numKeys);
+              std::iota(order.begin(), order.end(), size_t{0});
+              std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+                return keys->at(a) < keys->at(b);
+              });
+
               std::vector<Slice> keySlices;
-              std::vector<std::string> values;
-              std::vector<rocksdb::ColumnFamilyHandle*> columns;
-              for (auto& key : *keys) {
-                keySlices.emplace_back(key);
-                columns.emplace_back(handles->columns[keySpace->index].get());
+              keySlices.reserve(numKeys);
+              for (auto index : order) {
+                keySlices.emplace_back(keys->at(index));
               }
-              auto statuses = handles->db->MultiGet(
-                  ReadOptions(), columns, keySlices, &values);
-
-              std::vector<StoreResult> results;
-              for (size_t i = 0; i < keys->size(); ++i) {
+              std::vector<rocksdb::PinnableSlice> values(numKeys);
+              std::vector<rocksdb::Status> statuses(numKeys);
+              handles->db->MultiGet(
+                  ReadOptions(),
+                  handles->columns[keySpace->index].get(),
+                  numKeys,
+                  keySlices.data(),
+                  values.data(),
+                  statuses.data(),
+                  /*sorted_input=*/true);
+
+              std::vector<std::optional<StoreResult>> sorted(numKeys);
+              for (size_t i = 0; i < numKeys; ++i) {
                 auto& status = statuses[i];
                 if (!status.ok()) {
                   if (status.IsNotFound()) {
                     // Return an empty StoreResult
-                    results.push_back(StoreResult::missing(
+                    sorted[order[i]] = StoreResult::missing(
                         keySpace,
-                        folly::ByteRange{folly::StringPiece{keys->at(i)}}));
+                        folly::ByteRange{
+                            folly::StringPiece{keys->at(order[i])}});
                     continue;
                   }
 
@@ -526,10 +594,17 @@ RocksDbLocalStore::getBatch(
                   throw RocksException::build(
                       status,
                       "failed to get ",
-                      folly::hexlify(keys->at(i)),
+                      folly::hexlify(keys->at(order[i])),
                       " from local store");
                 }
-                results.emplace_back(std::move(values[i]));
+                sorted[order[i]] =
+                    StoreResult{values[i].ToString()};
+              }
+
+              std::vector<StoreResult> results;
+              results.reserve(numKeys);
+              for (auto& result : sorted) {
+                results.emplace_back(std::move(result).value());
               }
               return results;
             }));
@@ -549,6 +624,9 @@ RocksDbLocalStore::getBatch(
 }
 
 bool RocksDbLocalStore::hasKey(KeySpace keySpace, folly::ByteRange key) const {
+  if (!keyFilters_[keySpace->index].rlock()->mightContain(key)) {
+    return false;
+  }
   string value;
   auto handlesLock = getHandles();
   auto& handles = handlesLock->handles;
@@ -575,13 +653,16 @@ bool RocksDbLocalStore::hasKey(KeySpace keySpace, folly::ByteRange key) const {
 
 std::unique_ptr<LocalStore::WriteBatch> RocksDbLocalStore::beginWrite(
     size_t bufSize) {
-  return std::make_unique<RocksDbWriteBatch>(getHandles(), bufSize);
+  return std::make_unique<RocksDbWriteBatch>(
+      getHandles(), &keyFilters_, bufSize);
 }
 
 void RocksDbLocalStore::put(
     KeySpace keySpace,
     folly::ByteRange key,
     folly::ByteRange value) {
+  ioOpCount_.fetch_add(1, std::memory_order_relaxed);
+  keyFilters_[keySpace->index].wlock()->add(key);
   auto handlesLock = getHandles();
   auto& handles = handlesLock->handles;
   handles->db->Put(
@@ -638,12 +719,38 @@ uint64_t RocksDbLocalStore::getApproximateSize(KeySpace keySpace) const {
 }
 
 void RocksDbLocalStore::periodicManagementTask(const EdenConfig& config) {
+  // Flushes the packed blob metadata segment, among other things.
+  LocalStore::periodicManagementTask(config);
+
   // Compute and publish the stats
   auto before = computeStats(/*publish=*/true, &config);
 
+  auto currentIoOpCount = ioOpCount_.load(std::memory_order_relaxed);
+  auto opsSinceLastRun = currentIoOpCount - lastPeriodicIoOpCount_;
+  lastPeriodicIoOpCount_ = currentIoOpCount;
+
   // If any ephemeral column's size is more than its configured limit,
   // trigger garbage collection.
   if (before.excessiveKeySpaces.any()) {
+    // Clearing and compacting the caching column families competes with
+    // interactive fetches for disk bandwidth, so prefer to wait for an idle
+    // window: if the store served more operations than the configured
+    // threshold since the last management run, defer the GC.  Deferral is
+    // bounded so a persistently busy store still gets collected eventually.
+    auto idleThreshold = config.localStoreAutoGCIdleOpsThreshold.getValue();
+    if (idleThreshold != 0 && opsSinceLastRun >= idleThreshold &&
+        autoGCDeferralCount_ <
+            config.localStoreAutoGCMaxDeferrals.getValue()) {
+      ++autoGCDeferralCount_;
+      XLOG(INFO) << "deferring automatic local store garbage collection: "
+                 << opsSinceLastRun
+                 << " store operations since the last management run "
+                 << "(deferral " << autoGCDeferralCount_ << ")";
+      fb303::fbData->incrementCounter(
+          folly::to<string>(statsPrefix_, "auto_gc.deferred"));
+      return;
+    }
+    autoGCDeferralCount_ = 0;
     std::string keySpaceNames;
     for (auto& ks : KeySpace::kAll) {
       if (before.excessiveKeySpaces.test(ks->index)) {
@@ -9,9 +9,12 @@
 
 #include <folly/CppAttributes.h>
 #include <folly/Synchronized.h>
+#include <array>
+#include <atomic>
 #include <bitset>
 
 #include "eden/fs/rocksdb/RocksHandles.h"
+#include "eden/fs/store/KeyFilter.h"
 #include "eden/fs/store/LocalStore.h"
 #include "eden/fs/utils/UnboundedQueueExecutor.h"
 
@@ -121,11 +124,48 @@ class RocksDbLocalStore final : public LocalStore {
    */
   SizeSummary computeStats(bool publish, const EdenConfig* config);
 
+  /**
+   * Enable the key filter of each ephemeral column family that is empty at
+   * open time; see keyFilters_.
+   */
+  void initializeKeyFilters();
+
   void triggerAutoGC(SizeSummary before);
   void autoGCFinished(bool successful, uint64_t ephemeralSizeBefore);
 
   std::shared_ptr<StructuredLogger> structuredLogger_;
   const std::string statsPrefix_{"local_store."};
+
+  /**
+   * Approximate count of read and write operations served by this store,
+   * used by periodicManagementTask() to detect idle windows before starting
+   * garbage collection.  Bumped with relaxed ordering on the hot paths, so
+   * the count is only approximate; that is fine for idle detection.
+   */
+  mutable std::atomic<uint64_t> ioOpCount_{0};
+
+  /**
+   * The value of ioOpCount_ at the end of the previous management run, and
+   * how many consecutive runs have deferred GC waiting for an idle window.
+   * Only accessed from periodicManagementTask(), which is invoked serially
+   * from the periodic task thread.
+   */
+  uint64_t lastPeriodicIoOpCount_{0};
+  uint64_t autoGCDeferralCount_{0};
+
+  /**
+   * Per-key-space filters used to short-circuit lookups of keys that are
+   * definitely not present, skipping the RocksDB point lookup.  A filter is
+   * only enabled when its column family is known to be empty -- at open()
+   * for a fresh store, or after clearKeySpace() -- and every write path
+   * records its keys, so the filter never produces a false "missing".  Only
+   * ephemeral column families are ever enabled; the emptiness check at open
+   * relies on a RocksDB size estimate, and an incorrect negative answer for
+   * a persistent family could not be recovered by refetching.
+   */
+  mutable std::array<folly::Synchronized<KeyFilter>, KeySpace::kTotalCount>
+      keyFilters_;
+
   FaultInjector& faultInjector_;
   mutable UnboundedQueueExecutor ioPool_;
   folly::Synchronized<AutoGCState> autoGCState_;
@@ -23,6 +23,11 @@ using std::string;
 
 namespace {
 
+/**
+ * The number of read-only connections opened for parallel reads.
+ */
+constexpr size_t kNumReaderConnections = 4;
+
 /**
  * Implements the write batching helper.
  * In an ideal world, we'd just start a transaction and have the WriteBatch
@@ -130,6 +135,10 @@ void SqliteLocalStore::open() {
     }
   }
 
+  // With WAL enabled, additional read-only connections can run queries in
+  // parallel with each other and with writes on the main connection.
+  db_.openReaderPool(kNumReaderConnections);
+
   clearDeprecatedKeySpaces();
 }
 
@@ -147,7 +156,7 @@ void SqliteLocalStore::clearKeySpace(KeySpace keySpace) {
 void SqliteLocalStore::compactKeySpace(KeySpace) {}
 
 StoreResult SqliteLocalStore::get(KeySpace keySpace, ByteRange key) const {
-  auto db = db_.lock();
+  auto db = db_.lockForRead();
 
   SqliteStatement stmt(
       db, "select value from ", keySpace->name, " where key = ?");
@@ -165,7 +174,7 @@ StoreResult SqliteLocalStore::get(KeySpace keySpace, ByteRange key) const {
 }
 
 bool SqliteLocalStore::hasKey(KeySpace keySpace, ByteRange key) const {
-  auto db = db_.lock();
+  auto db = db_.lockForRead();
 
   SqliteStatement stmt(db, "select 1 from ", keySpace->name, " where key = ?");
 
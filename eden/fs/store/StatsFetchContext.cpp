@@ -14,8 +14,12 @@ StatsFetchContext::StatsFetchContext(
     OptionalProcessId pid,
     Cause cause,
     std::optional<std::string_view> causeDetail,
-    const std::unordered_map<std::string, std::string>* requestInfo)
-    : clientPid_{pid}, cause_{cause}, causeDetail_{std::move(causeDetail)} {
+    const std::unordered_map<std::string, std::string>* requestInfo,
+    folly::CancellationToken cancellationToken)
+    : clientPid_{pid},
+      cause_{cause},
+      causeDetail_{std::move(causeDetail)},
+      cancellationToken_{std::move(cancellationToken)} {
   if (requestInfo) {
     requestInfo_ = *requestInfo;
   }
@@ -25,7 +29,8 @@ StatsFetchContext::StatsFetchContext(const StatsFetchContext& other)
     : clientPid_{other.clientPid_},
       cause_{other.cause_},
       causeDetail_{other.causeDetail_},
-      requestInfo_{other.requestInfo_} {
+      requestInfo_{other.requestInfo_},
+      cancellationToken_{other.cancellationToken_} {
   for (size_t y = 0; y < ObjectFetchContext::kObjectTypeEnumMax; ++y) {
     for (size_t x = 0; x < ObjectFetchContext::kOriginEnumMax; ++x) {
       // This could almost certainly use a more relaxed memory ordering.
@@ -38,7 +43,8 @@ StatsFetchContext::StatsFetchContext(StatsFetchContext&& other) noexcept
     : clientPid_{other.clientPid_},
       cause_{other.cause_},
       causeDetail_{other.causeDetail_},
-      requestInfo_{std::move(other.requestInfo_)} {
+      requestInfo_{std::move(other.requestInfo_)},
+      cancellationToken_{std::move(other.cancellationToken_)} {
   for (size_t y = 0; y < ObjectFetchContext::kObjectTypeEnumMax; ++y) {
     for (size_t x = 0; x < ObjectFetchContext::kOriginEnumMax; ++x) {
       // This could almost certainly use a more relaxed memory ordering.
@@ -53,6 +59,7 @@ StatsFetchContext& StatsFetchContext::operator=(
   cause_ = std::move(other.cause_);
   causeDetail_ = std::move(other.causeDetail_);
   requestInfo_ = std::move(other.requestInfo_);
+  cancellationToken_ = std::move(other.cancellationToken_);
   for (size_t y = 0; y < ObjectFetchContext::kObjectTypeEnumMax; ++y) {
     for (size_t x = 0; x < ObjectFetchContext::kOriginEnumMax; ++x) {
       // This could almost certainly use a more relaxed memory ordering.
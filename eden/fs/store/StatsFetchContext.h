@@ -47,7 +47,8 @@ class StatsFetchContext : public ObjectFetchContext {
       OptionalProcessId pid,
       Cause cause,
       std::optional<std::string_view> causeDetail,
-      const std::unordered_map<std::string, std::string>* requestInfo);
+      const std::unordered_map<std::string, std::string>* requestInfo,
+      folly::CancellationToken cancellationToken = {});
   StatsFetchContext(const StatsFetchContext& other);
 
   // TODO: When ObjectFetchContext is passed by refcounted pointer, make this
@@ -78,6 +79,10 @@ class StatsFetchContext : public ObjectFetchContext {
     return &requestInfo_;
   }
 
+  folly::CancellationToken getCancellationToken() const override {
+    return cancellationToken_;
+  }
+
  private:
   std::atomic<uint64_t> counts_[ObjectFetchContext::kObjectTypeEnumMax]
                                [ObjectFetchContext::kOriginEnumMax] = {};
@@ -85,6 +90,7 @@ class StatsFetchContext : public ObjectFetchContext {
   Cause cause_ = Cause::Unknown;
   std::optional<std::string_view> causeDetail_;
   std::unordered_map<std::string, std::string> requestInfo_;
+  folly::CancellationToken cancellationToken_;
 };
 
 using StatsFetchContextPtr = RefPtr<StatsFetchContext>;
@@ -0,0 +1,267 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/store/TieredLocalStore.h"
+
+#include <folly/Executor.h>
+#include <folly/String.h>
+#include <folly/futures/Future.h>
+#include <folly/logging/xlog.h>
+
+#include "eden/fs/store/KeySpace.h"
+#include "eden/fs/store/StoreResult.h"
+#include "eden/fs/telemetry/EdenStats.h"
+
+namespace facebook::eden {
+
+using folly::StringPiece;
+
+namespace {
+class TieredWriteBatch : public LocalStore::WriteBatch {
+ public:
+  explicit TieredWriteBatch(TieredLocalStore* store) : store_(store) {
+    storage_.resize(KeySpace::kTotalCount);
+  }
+
+  void put(KeySpace keySpace, folly::ByteRange key, folly::ByteRange value)
+      override {
+    storage_[keySpace->index][StringPiece(key)] = StringPiece(value).str();
+  }
+
+  void put(
+      KeySpace keySpace,
+      folly::ByteRange key,
+      std::vector<folly::ByteRange> valueSlices) override {
+    std::string value;
+    for (const auto& slice : valueSlices) {
+      value.append(reinterpret_cast<const char*>(slice.data()), slice.size());
+    }
+    put(keySpace, key, StringPiece(value));
+  }
+
+  void flush() override {
+    // TieredLocalStore::put routes each entry to the write-back buffer or
+    // the persistent store depending on the key space.
+    for (auto& ks : KeySpace::kAll) {
+      for (const auto& it : storage_[ks->index]) {
+        store_->put(ks, folly::StringPiece(it.first), StringPiece(it.second));
+      }
+      storage_[ks->index].clear();
+    }
+  }
+
+ private:
+  TieredLocalStore* store_;
+  std::vector<folly::StringKeyedUnorderedMap<std::string>> storage_;
+};
+} // namespace
+
+TieredLocalStore::TieredLocalStore(
+    std::shared_ptr<LocalStore> persistentStore,
+    std::shared_ptr<folly::Executor> flushExecutor,
+    EdenStatsPtr edenStats,
+    size_t maxPendingBytes)
+    : LocalStore{std::move(edenStats)},
+      persistentStore_{std::move(persistentStore)},
+      flushExecutor_{std::move(flushExecutor)},
+      maxPendingBytes_{maxPendingBytes} {
+  pending_.wlock()->maps.resize(KeySpace::kTotalCount);
+}
+
+TieredLocalStore::~TieredLocalStore() {
+  try {
+    flush();
+  } catch (const std::exception& ex) {
+    XLOG(WARN) << "error draining write-back buffer during shutdown: "
+               << folly::exceptionStr(ex);
+  }
+}
+
+void TieredLocalStore::open() {
+  persistentStore_->open();
+}
+
+void TieredLocalStore::close() {
+  flush();
+  persistentStore_->close();
+}
+
+void TieredLocalStore::clearKeySpace(KeySpace keySpace) {
+  {
+    auto pending = pending_.wlock();
+    auto& map = pending->maps[keySpace->index];
+    for (const auto& it : map) {
+      pending->bytes -= it.first.size() + it.second.size();
+    }
+    map.clear();
+  }
+  persistentStore_->clearKeySpace(keySpace);
+}
+
+void TieredLocalStore::compactKeySpace(KeySpace keySpace) {
+  flush();
+  persistentStore_->compactKeySpace(keySpace);
+}
+
+StoreResult TieredLocalStore::get(KeySpace keySpace, folly::ByteRange key)
+    const {
+  {
+    auto pending = pending_.rlock();
+    auto& map = pending->maps[keySpace->index];
+    auto it = map.find(StringPiece(key));
+    if (it != map.end()) {
+      return StoreResult(std::string(it->second));
+    }
+  }
+  return persistentStore_->get(keySpace, key);
+}
+
+folly::Future<std::vector<StoreResult>> TieredLocalStore::getBatch(
+    KeySpace keySpace,
+    const std::vector<folly::ByteRange>& keys) const {
+  std::vector<std::optional<StoreResult>> results(keys.size());
+  auto missingKeys = std::make_shared<std::vector<folly::ByteRange>>();
+  std::vector<size_t> missingIndexes;
+  {
+    auto pending = pending_.rlock();
+    auto& map = pending->maps[keySpace->index];
+    for (size_t i = 0; i < keys.size(); ++i) {
+      auto it = map.find(StringPiece(keys[i]));
+      if (it != map.end()) {
+        results[i] = StoreResult(std::string(it->second));
+      } else {
+        missingKeys->push_back(keys[i]);
+        missingIndexes.push_back(i);
+      }
+    }
+  }
+
+  auto finalize = [](std::vector<std::optional<StoreResult>>&& entries) {
+    std::vector<StoreResult> out;
+    out.reserve(entries.size());
+    for (auto& entry : entries) {
+      out.emplace_back(std::move(entry).value());
+    }
+    return out;
+  };
+
+  if (missingKeys->empty()) {
+    return folly::makeFuture(finalize(std::move(results)));
+  }
+
+  return persistentStore_->getBatch(keySpace, *missingKeys)
+      .thenValue([results = std::move(results),
+                  // Keep the key storage alive for the duration of the
+                  // lookup; getBatch requires the keys to outlive the future.
+                  missingKeys,
+                  missingIndexes = std::move(missingIndexes),
+                  finalize](std::vector<StoreResult>&& fetched) mutable {
+        for (size_t i = 0; i < missingIndexes.size(); ++i) {
+          results[missingIndexes[i]] = std::move(fetched[i]);
+        }
+        return finalize(std::move(results));
+      });
+}
+
+bool TieredLocalStore::hasKey(KeySpace keySpace, folly::ByteRange key) const {
+  {
+    auto pending = pending_.rlock();
+    auto& map = pending->maps[keySpace->index];
+    if (map.find(StringPiece(key)) != map.end()) {
+      return true;
+    }
+  }
+  return persistentStore_->hasKey(keySpace, key);
+}
+
+void TieredLocalStore::put(
+    KeySpace keySpace,
+    folly::ByteRange key,
+    folly::ByteRange value) {
+  if (!keySpace->isEphemeral()) {
+    // Losing persistent key spaces in a crash is not recoverable, so they
+    // are written through rather than buffered.
+    persistentStore_->put(keySpace, key, value);
+    return;
+  }
+  putBuffered(keySpace, key, value);
+}
+
+void TieredLocalStore::putBuffered(
+    KeySpace keySpace,
+    folly::ByteRange key,
+    folly::ByteRange value) {
+  bool overLimit;
+  {
+    auto pending = pending_.wlock();
+    pending->maps[keySpace->index][StringPiece(key)] =
+        StringPiece(value).str();
+    pending->bytes += key.size() + value.size();
+    overLimit = pending->bytes >= maxPendingBytes_;
+  }
+  if (overLimit) {
+    // Drain inline to bound memory; this briefly blocks the writer, which
+    // is the backpressure we want when writes outrun the flusher.
+    flush();
+  } else {
+    scheduleFlush();
+  }
+}
+
+void TieredLocalStore::scheduleFlush() {
+  if (flushScheduled_.exchange(true)) {
+    return;
+  }
+  auto weakSelf = std::weak_ptr<TieredLocalStore>{
+      std::static_pointer_cast<TieredLocalStore>(shared_from_this())};
+  flushExecutor_->add([weakSelf = std::move(weakSelf)] {
+    auto self = weakSelf.lock();
+    if (!self) {
+      // The store is gone; the destructor drained the buffer.
+      return;
+    }
+    // Clear the flag before draining so puts that land mid-drain schedule
+    // another pass rather than getting stuck in the buffer.
+    self->flushScheduled_.store(false);
+    self->flush();
+  });
+}
+
+void TieredLocalStore::flush() {
+  PendingWrites writes;
+  writes.maps.resize(KeySpace::kTotalCount);
+  {
+    auto pending = pending_.wlock();
+    if (pending->bytes == 0) {
+      return;
+    }
+    std::swap(writes, *pending);
+    pending->maps.resize(KeySpace::kTotalCount);
+  }
+
+  auto batch = persistentStore_->beginWrite();
+  for (auto& ks : KeySpace::kAll) {
+    for (const auto& it : writes.maps[ks->index]) {
+      batch->put(
+          ks,
+          folly::ByteRange{folly::StringPiece{it.first}},
+          folly::ByteRange{folly::StringPiece{it.second}});
+    }
+  }
+  batch->flush();
+}
+
+std::unique_ptr<LocalStore::WriteBatch> TieredLocalStore::beginWrite(size_t) {
+  return std::make_unique<TieredWriteBatch>(this);
+}
+
+void TieredLocalStore::periodicManagementTask(const EdenConfig& config) {
+  flush();
+  persistentStore_->periodicManagementTask(config);
+}
+
+} // namespace facebook::eden
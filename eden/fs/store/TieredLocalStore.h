@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include <folly/Synchronized.h>
+#include <folly/experimental/StringKeyedUnorderedMap.h>
+
+#include "eden/fs/store/LocalStore.h"
+
+namespace folly {
+class Executor;
+}
+
+namespace facebook::eden {
+
+/**
+ * A LocalStore that buffers writes to ephemeral key spaces in memory and
+ * flushes them to a persistent store in the background.
+ *
+ * Checkout and import caching write thousands of trees and blobs to the
+ * local store on the critical path; writing them straight to RocksDB stalls
+ * on WAL writes. With this store those puts complete at memory speed and a
+ * background task drains the buffer into the persistent store.
+ *
+ * Crash safety is scoped per key space: writes to Persistent key spaces
+ * (proxy hashes) are passed straight through to the underlying store, since
+ * losing them breaks re-importing. Ephemeral key spaces are caches that can
+ * be repopulated from the backing store, so losing buffered entries in a
+ * crash only costs a refetch.
+ *
+ * Reads consult the write-back buffer before the persistent store, so a
+ * buffered entry is visible immediately.
+ */
+class TieredLocalStore final : public LocalStore {
+ public:
+  /**
+   * Wraps persistentStore. Buffered writes are drained on flushExecutor;
+   * a put that pushes the buffer past maxPendingBytes drains it inline,
+   * bounding memory at the cost of briefly blocking that writer.
+   */
+  TieredLocalStore(
+      std::shared_ptr<LocalStore> persistentStore,
+      std::shared_ptr<folly::Executor> flushExecutor,
+      EdenStatsPtr edenStats,
+      size_t maxPendingBytes = kDefaultMaxPendingBytes);
+  ~TieredLocalStore() override;
+
+  void open() override;
+  void close() override;
+  void clearKeySpace(KeySpace keySpace) override;
+  void compactKeySpace(KeySpace keySpace) override;
+  StoreResult get(KeySpace keySpace, folly::ByteRange key) const override;
+  FOLLY_NODISCARD folly::Future<std::vector<StoreResult>> getBatch(
+      KeySpace keySpace,
+      const std::vector<folly::ByteRange>& keys) const override;
+  bool hasKey(KeySpace keySpace, folly::ByteRange key) const override;
+  void put(KeySpace keySpace, folly::ByteRange key, folly::ByteRange value)
+      override;
+  std::unique_ptr<LocalStore::WriteBatch> beginWrite(
+      size_t bufSize = 0) override;
+  void periodicManagementTask(const EdenConfig& config) override;
+
+  /**
+   * Synchronously drains the write-back buffer into the persistent store.
+   * Primarily for tests and shutdown.
+   */
+  void flush();
+
+ private:
+  static constexpr size_t kDefaultMaxPendingBytes = 64 * 1024 * 1024;
+
+  struct PendingWrites {
+    std::vector<folly::StringKeyedUnorderedMap<std::string>> maps;
+    size_t bytes{0};
+  };
+
+  void putBuffered(
+      KeySpace keySpace,
+      folly::ByteRange key,
+      folly::ByteRange value);
+  void scheduleFlush();
+
+  std::shared_ptr<LocalStore> persistentStore_;
+  std::shared_ptr<folly::Executor> flushExecutor_;
+  size_t maxPendingBytes_;
+  folly::Synchronized<PendingWrites> pending_;
+  std::atomic<bool> flushScheduled_{false};
+};
+
+} // namespace facebook::eden
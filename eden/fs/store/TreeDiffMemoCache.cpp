@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/store/TreeDiffMemoCache.h"
+
+namespace facebook::eden {
+
+TreeDiffMemoCache::TreeDiffMemoCache(size_t maximumEntries)
+    : cache_{folly::in_place, maximumEntries} {}
+
+TreeDiffMemoCache::Result TreeDiffMemoCache::get(
+    const ObjectId& scmId,
+    const ObjectId& wdId) {
+  // Hits mutate the LRU list, so take the write lock even for lookup.
+  auto cache = cache_.wlock();
+  auto iter = cache->find(Key{scmId, wdId});
+  if (iter == cache->end()) {
+    return nullptr;
+  }
+  return iter->second;
+}
+
+void TreeDiffMemoCache::put(
+    const ObjectId& scmId,
+    const ObjectId& wdId,
+    Result result) {
+  cache_.wlock()->set(Key{scmId, wdId}, std::move(result));
+}
+
+} // namespace facebook::eden
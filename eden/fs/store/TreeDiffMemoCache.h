@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#pragma once
+
+#include <folly/Synchronized.h>
+#include <folly/container/EvictingCacheMap.h>
+#include <folly/hash/Hash.h>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "eden/fs/model/ObjectId.h"
+#include "eden/fs/utils/DirType.h"
+#include "eden/fs/utils/PathFuncs.h"
+
+namespace facebook::eden {
+
+/**
+ * A bounded memo of finished tree-pair diff results.
+ *
+ * Two source control trees are immutable, so the set of differences between
+ * them never changes and can be replayed on a later diff of the same
+ * (scmTree, wdTree) pair without loading either tree. Repeated status calls
+ * on a mount with a stable dirty set hit the same unmaterialized subtree
+ * pairs over and over; with the memo only materialized paths are re-walked.
+ *
+ * Entries are recorded relative to the root of the subtree pair so a hit can
+ * be replayed under any path prefix. Results that ended in a diff error or a
+ * cancelled walk are never stored.
+ *
+ * It is safe to use this object from arbitrary threads.
+ */
+class TreeDiffMemoCache {
+ public:
+  enum class ChangeType : uint8_t {
+    Added,
+    Removed,
+    Modified,
+  };
+
+  struct Entry {
+    /** Path of the difference, relative to the subtree pair's root. */
+    RelativePath path;
+    ChangeType change;
+    dtype_t dtype;
+  };
+
+  using Result = std::shared_ptr<const std::vector<Entry>>;
+
+  explicit TreeDiffMemoCache(size_t maximumEntries);
+
+  /**
+   * Returns the memoized differences between the two trees, or null if the
+   * pair has not been memoized. A hit refreshes the pair's LRU position.
+   */
+  Result get(const ObjectId& scmId, const ObjectId& wdId);
+
+  void put(const ObjectId& scmId, const ObjectId& wdId, Result result);
+
+ private:
+  using Key = std::pair<ObjectId, ObjectId>;
+
+  struct KeyHash {
+    size_t operator()(const Key& key) const {
+      return folly::hash::hash_combine(
+          key.first.getHashCode(), key.second.getHashCode());
+    }
+  };
+
+  folly::Synchronized<folly::EvictingCacheMap<Key, Result, KeyHash>> cache_;
+};
+
+} // namespace facebook::eden
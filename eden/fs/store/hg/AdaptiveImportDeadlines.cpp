@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/store/hg/AdaptiveImportDeadlines.h"
+
+#include <algorithm>
+
+namespace facebook::eden {
+
+void AdaptiveImportDeadlines::recordLatency(
+    Operation operation,
+    std::chrono::microseconds duration) {
+  baselineFor(operation).histogram.record(duration);
+}
+
+std::optional<std::chrono::steady_clock::time_point>
+AdaptiveImportDeadlines::deriveDeadline(
+    Operation operation,
+    std::chrono::microseconds minimumBudget,
+    std::chrono::microseconds maximumBudget) {
+  auto& baseline = baselineFor(operation);
+  const auto counts = baseline.histogram.snapshot();
+  const auto now = std::chrono::steady_clock::now();
+
+  uint64_t total = 0;
+  std::array<uint64_t, DurationHistogram::kBucketCount> windowCounts;
+  {
+    auto window = baseline.window.wlock();
+    if (now - window->lastRotation >= kRotationInterval) {
+      window->windowBase = std::move(window->rotationBase);
+      window->rotationBase = counts;
+      window->lastRotation = now;
+    }
+    for (size_t i = 0; i < DurationHistogram::kBucketCount; ++i) {
+      const auto base =
+          i < window->windowBase.size() ? window->windowBase[i] : 0;
+      windowCounts[i] = counts[i] - base;
+      total += windowCounts[i];
+    }
+  }
+
+  if (total < kMinimumSamples) {
+    return std::nullopt;
+  }
+
+  // The smallest bucket whose cumulative count covers 99% of the window.
+  const uint64_t target = total - total / 100;
+  uint64_t cumulative = 0;
+  size_t bucket = DurationHistogram::kBucketCount - 1;
+  for (size_t i = 0; i < DurationHistogram::kBucketCount; ++i) {
+    cumulative += windowCounts[i];
+    if (cumulative >= target) {
+      bucket = i;
+      break;
+    }
+  }
+
+  // Take the bucket's upper bound so the estimate is never below the true
+  // quantile; the last bucket is unbounded, so double its lower bound.
+  const uint64_t p99Us = bucket + 1 < DurationHistogram::kBucketCount
+      ? DurationHistogram::bucketLowerBoundUs(bucket + 1)
+      : 2 * DurationHistogram::bucketLowerBoundUs(bucket);
+
+  const auto budget = std::clamp(
+      std::chrono::microseconds{p99Us * kBudgetMultiplier},
+      minimumBudget,
+      maximumBudget);
+  return now + budget;
+}
+
+} // namespace facebook::eden
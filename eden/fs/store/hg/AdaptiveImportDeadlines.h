@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include <folly/Synchronized.h>
+
+#include "eden/fs/telemetry/DurationHistogram.h"
+
+namespace facebook::eden {
+
+/**
+ * Derives per-operation-class import deadlines from rolling latency
+ * baselines.
+ *
+ * A static import timeout is either too tight for a cold cache or leaves
+ * hopeless requests occupying queue slots for minutes during a partial
+ * store outage. Instead, every completed fetch records its latency here,
+ * and new imports receive a deadline a generous multiple of the recent
+ * p99 of their operation class. The import queue fails requests whose
+ * deadline has already passed when they are dequeued, freeing their slots
+ * for requests that can still complete in time.
+ *
+ * Latencies are kept in DurationHistograms, which are cheap enough to
+ * record into from every fetch. The "rolling" part is implemented by
+ * snapshotting the histogram on a fixed cadence and differencing against
+ * the snapshot from two rotations ago, so the baseline tracks the last
+ * one to two rotation intervals rather than the whole process lifetime.
+ */
+class AdaptiveImportDeadlines {
+ public:
+  enum class Operation : size_t { Tree = 0, Blob = 1, BlobMeta = 2 };
+  static constexpr size_t kOperationCount = 3;
+
+  /**
+   * Records the observed latency of a completed fetch. Lock-free; called
+   * from every import worker.
+   */
+  void recordLatency(Operation operation, std::chrono::microseconds duration);
+
+  /**
+   * Returns now + clamp(kBudgetMultiplier * p99, minimumBudget,
+   * maximumBudget) for the operation class, or nullopt until the rolling
+   * window holds at least kMinimumSamples latencies. Without a baseline
+   * there is no way to tell a hopeless request from a merely slow store,
+   * so the caller falls back to issuing the import with no deadline.
+   */
+  std::optional<std::chrono::steady_clock::time_point> deriveDeadline(
+      Operation operation,
+      std::chrono::microseconds minimumBudget,
+      std::chrono::microseconds maximumBudget);
+
+  /**
+   * A request is declared hopeless once it has been pending this many
+   * times the recent p99. Large enough that queueing delay behind a
+   * normal burst never trips it; a store outage overshoots it easily.
+   */
+  static constexpr uint64_t kBudgetMultiplier = 20;
+
+  /** Baselines start being served after this many recorded latencies. */
+  static constexpr uint64_t kMinimumSamples = 100;
+
+  /** How often the rolling window advances. */
+  static constexpr std::chrono::minutes kRotationInterval{5};
+
+ private:
+  struct Window {
+    std::chrono::steady_clock::time_point lastRotation;
+    /**
+     * Bucket counts at the rotation before last; the rolling window is
+     * the histogram's current counts minus these. Empty means zero, so a
+     * fresh baseline covers the whole process history until two
+     * rotations have passed.
+     */
+    std::vector<uint64_t> windowBase;
+    /** Bucket counts at the last rotation; becomes windowBase next. */
+    std::vector<uint64_t> rotationBase;
+  };
+
+  struct Baseline {
+    DurationHistogram histogram;
+    folly::Synchronized<Window> window;
+  };
+
+  Baseline& baselineFor(Operation operation) {
+    return baselines_[static_cast<size_t>(operation)];
+  }
+
+  std::array<Baseline, kOperationCount> baselines_;
+};
+
+} // namespace facebook::eden
@@ -557,28 +557,78 @@ folly::Future<TreePtr> HgBackingStore::importTreeManifestImpl(
   return importTreeImpl(manifestNode, objectId, path);
 }
 
-SemiFuture<BlobPtr> HgBackingStore::fetchBlobFromHgImporter(
-    HgProxyHash hgInfo) {
-  return folly::via(
-      importThreadPool_.get(),
-      [this,
-       hgInfo = std::move(hgInfo),
-       &liveImportBlobWatches = liveImportBlobWatches_] {
-        Importer& importer = getThreadLocalImporter();
-        folly::stop_watch<std::chrono::milliseconds> watch;
-        RequestMetricsScope queueTracker{&liveImportBlobWatches};
-        auto blob =
-            importer.importFileContents(hgInfo.path(), hgInfo.revHash());
-        stats_->addDuration(
-            &HgBackingStoreStats::importBlobDuration, watch.elapsed());
-
-        if (blob) {
-          stats_->increment(&HgBackingStoreStats::importBlobSuccess);
-        } else {
-          stats_->increment(&HgBackingStoreStats::importBlobFailure);
-        }
-        return blob;
-      });
+SemiFuture<std::vector<folly::Try<BlobPtr>>>
+HgBackingStore::fetchBlobsFromHgImporter(std::vector<HgProxyHash> hgInfos) {
+  // Spread the blobs across the importer threads so that several helper
+  // processes work on the batch concurrently, and let each thread pipeline
+  // its share over its helper's pipe in a single exchange.
+  const size_t numChunks =
+      std::max<size_t>(static_cast<size_t>(FLAGS_num_hg_import_threads), 1);
+  const size_t chunkSize = (hgInfos.size() + numChunks - 1) / numChunks;
+
+  std::vector<folly::SemiFuture<std::vector<folly::Try<BlobPtr>>>> futures;
+  std::vector<size_t> chunkSizes;
+  for (size_t start = 0; start < hgInfos.size(); start += chunkSize) {
+    auto end = std::min(start + chunkSize, hgInfos.size());
+    std::vector<HgProxyHash> chunk{
+        std::make_move_iterator(hgInfos.begin() + start),
+        std::make_move_iterator(hgInfos.begin() + end)};
+    chunkSizes.push_back(chunk.size());
+
+    futures.emplace_back(folly::via(
+        importThreadPool_.get(),
+        [this,
+         chunk = std::move(chunk),
+         &liveImportBlobWatches = liveImportBlobWatches_] {
+          Importer& importer = getThreadLocalImporter();
+          folly::stop_watch<std::chrono::milliseconds> watch;
+          RequestMetricsScope queueTracker{&liveImportBlobWatches};
+
+          std::vector<std::pair<RelativePath, Hash20>> requests;
+          requests.reserve(chunk.size());
+          for (const auto& hgInfo : chunk) {
+            requests.emplace_back(hgInfo.path().copy(), hgInfo.revHash());
+          }
+
+          auto blobs = importer.importFileContents(requests);
+          stats_->addDuration(
+              &HgBackingStoreStats::importBlobDuration, watch.elapsed());
+
+          for (const auto& blob : blobs) {
+            if (blob.hasValue() && blob.value()) {
+              stats_->increment(&HgBackingStoreStats::importBlobSuccess);
+            } else {
+              stats_->increment(&HgBackingStoreStats::importBlobFailure);
+            }
+          }
+          return blobs;
+        }));
+  }
+
+  return folly::collectAll(std::move(futures))
+      .deferValue(
+          [chunkSizes = std::move(chunkSizes)](
+              std::vector<folly::Try<std::vector<folly::Try<BlobPtr>>>>&&
+                  chunks) {
+            std::vector<folly::Try<BlobPtr>> results;
+            for (size_t i = 0; i < chunks.size(); ++i) {
+              auto& chunkTry = chunks[i];
+              if (chunkTry.hasValue()) {
+                for (auto& blob : chunkTry.value()) {
+                  results.emplace_back(std::move(blob));
+                }
+              } else {
+                // The whole chunk failed (for instance the helper process
+                // could not be restarted); spread the error to each of its
+                // blobs.
+                for (size_t j = 0; j < chunkSizes[i]; ++j) {
+                  results.emplace_back(
+                      folly::Try<BlobPtr>{chunkTry.exception()});
+                }
+              }
+            }
+            return results;
+          });
 }
 
 folly::StringPiece HgBackingStore::stringOfHgImportObject(
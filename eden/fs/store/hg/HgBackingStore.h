@@ -12,6 +12,7 @@
 #include <folly/Executor.h>
 #include <folly/Range.h>
 #include <folly/Synchronized.h>
+#include <folly/Try.h>
 
 #include "eden/fs/eden-config.h"
 #include "eden/fs/store/BackingStore.h"
@@ -128,12 +129,26 @@ class HgBackingStore {
 
   // Get blob step functions
 
-  folly::SemiFuture<BlobPtr> fetchBlobFromHgImporter(HgProxyHash hgInfo);
+  /**
+   * Fetch all the given blobs through the hg importer fallback.
+   *
+   * The blobs are spread across the importer threads, and each thread
+   * pipelines its share over its helper process in a single exchange, so
+   * fallback throughput scales with the importer pool instead of paying one
+   * pipe round trip per blob. Results are returned in the same order as
+   * hgInfos.
+   */
+  folly::SemiFuture<std::vector<folly::Try<BlobPtr>>> fetchBlobsFromHgImporter(
+      std::vector<HgProxyHash> hgInfos);
 
   HgDatapackStore& getDatapackStore() {
     return datapackStore_;
   }
 
+  folly::Executor* getServerThreadPool() {
+    return serverThreadPool_;
+  }
+
   std::optional<folly::StringPiece> getRepoName() {
     return std::optional<folly::StringPiece>{repoName_};
   }
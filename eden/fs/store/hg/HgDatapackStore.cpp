@@ -245,8 +245,8 @@ void HgDatapackStore::getBlobBatch(const ImportRequestsList& importRequests) {
         auto& [importRequestList, watch] = importRequestsMap[nodeId];
         auto result = content.hasException()
             ? folly::Try<BlobPtr>{content.exception()}
-            : folly::Try{
-                  std::make_shared<BlobPtr::element_type>(*content.value())};
+            : folly::Try{std::make_shared<BlobPtr::element_type>(
+                  std::move(*content.value()))};
         for (auto& importRequest : importRequestList) {
           importRequest->getPromise<BlobPtr>()->setWith(
               [&]() -> folly::Try<BlobPtr> { return result; });
@@ -21,11 +21,17 @@ HgImportRequest::HgImportRequest(
     ImportPriority priority,
     ObjectFetchContext::Cause cause,
     OptionalProcessId pid,
+    Deadline deadline,
+    std::optional<std::string> mountId,
+    folly::CancellationToken cancellationToken,
     folly::Promise<typename RequestType::Response>&& promise)
     : request_(std::move(request)),
       priority_(priority),
       cause_(cause),
       pid_(pid),
+      deadline_(deadline),
+      mountId_(std::move(mountId)),
+      cancellationTokens_{std::move(cancellationToken)},
       promise_(std::move(promise)) {}
 
 template <typename RequestType, typename... Input>
@@ -33,6 +39,9 @@ std::shared_ptr<HgImportRequest> HgImportRequest::makeRequest(
     ImportPriority priority,
     ObjectFetchContext::Cause cause,
     OptionalProcessId pid,
+    Deadline deadline,
+    std::optional<std::string> mountId,
+    folly::CancellationToken cancellationToken,
     Input&&... input) {
   auto promise = folly::Promise<typename RequestType::Response>{};
   return std::make_shared<HgImportRequest>(
@@ -40,6 +49,9 @@ std::shared_ptr<HgImportRequest> HgImportRequest::makeRequest(
       priority,
       cause,
       pid,
+      deadline,
+      std::move(mountId),
+      std::move(cancellationToken),
       std::move(promise));
 }
 
@@ -48,8 +60,19 @@ std::shared_ptr<HgImportRequest> HgImportRequest::makeBlobImportRequest(
     const HgProxyHash& proxyHash,
     ImportPriority priority,
     ObjectFetchContext::Cause cause,
-    OptionalProcessId pid) {
-  return makeRequest<BlobImport>(priority, cause, pid, hash, proxyHash);
+    OptionalProcessId pid,
+    Deadline deadline,
+    std::optional<std::string> mountId,
+    folly::CancellationToken cancellationToken) {
+  return makeRequest<BlobImport>(
+      priority,
+      cause,
+      pid,
+      deadline,
+      std::move(mountId),
+      std::move(cancellationToken),
+      hash,
+      proxyHash);
 }
 
 std::shared_ptr<HgImportRequest> HgImportRequest::makeTreeImportRequest(
@@ -57,8 +80,19 @@ std::shared_ptr<HgImportRequest> HgImportRequest::makeTreeImportRequest(
     const HgProxyHash& proxyHash,
     ImportPriority priority,
     ObjectFetchContext::Cause cause,
-    OptionalProcessId pid) {
-  return makeRequest<TreeImport>(priority, cause, pid, hash, proxyHash);
+    OptionalProcessId pid,
+    Deadline deadline,
+    std::optional<std::string> mountId,
+    folly::CancellationToken cancellationToken) {
+  return makeRequest<TreeImport>(
+      priority,
+      cause,
+      pid,
+      deadline,
+      std::move(mountId),
+      std::move(cancellationToken),
+      hash,
+      proxyHash);
 }
 
 std::shared_ptr<HgImportRequest> HgImportRequest::makeBlobMetaImportRequest(
@@ -66,8 +100,19 @@ std::shared_ptr<HgImportRequest> HgImportRequest::makeBlobMetaImportRequest(
     const HgProxyHash& proxyHash,
     ImportPriority priority,
     ObjectFetchContext::Cause cause,
-    OptionalProcessId pid) {
-  return makeRequest<BlobMetaImport>(priority, cause, pid, hash, proxyHash);
+    OptionalProcessId pid,
+    Deadline deadline,
+    std::optional<std::string> mountId,
+    folly::CancellationToken cancellationToken) {
+  return makeRequest<BlobMetaImport>(
+      priority,
+      cause,
+      pid,
+      deadline,
+      std::move(mountId),
+      std::move(cancellationToken),
+      hash,
+      proxyHash);
 }
 
 } // namespace facebook::eden
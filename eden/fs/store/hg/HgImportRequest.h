@@ -7,7 +7,12 @@
 
 #pragma once
 
+#include <folly/CancellationToken.h>
 #include <folly/futures/Promise.h>
+#include <algorithm>
+#include <chrono>
+#include <optional>
+#include <string>
 #include <utility>
 #include <variant>
 
@@ -49,6 +54,12 @@ class HgImportRequest {
   using TreeImport = BaseImport<TreePtr>;
   using BlobMetaImport = BaseImport<BlobMetadataPtr>;
 
+  /**
+   * An optional point in time by which the requester would like this import
+   * to be dispatched. See ObjectFetchContext::getDeadline.
+   */
+  using Deadline = std::optional<std::chrono::steady_clock::time_point>;
+
   /**
    * Allocate a blob request.
    */
@@ -57,7 +68,10 @@ class HgImportRequest {
       const HgProxyHash& proxyHash,
       ImportPriority priority,
       ObjectFetchContext::Cause cause,
-      OptionalProcessId pid);
+      OptionalProcessId pid,
+      Deadline deadline = std::nullopt,
+      std::optional<std::string> mountId = std::nullopt,
+      folly::CancellationToken cancellationToken = {});
 
   /**
    * Allocate a tree request.
@@ -67,14 +81,20 @@ class HgImportRequest {
       const HgProxyHash& proxyHash,
       ImportPriority priority,
       ObjectFetchContext::Cause cause,
-      OptionalProcessId pid);
+      OptionalProcessId pid,
+      Deadline deadline = std::nullopt,
+      std::optional<std::string> mountId = std::nullopt,
+      folly::CancellationToken cancellationToken = {});
 
   static std::shared_ptr<HgImportRequest> makeBlobMetaImportRequest(
       const ObjectId& hash,
       const HgProxyHash& proxyHash,
       ImportPriority priority,
       ObjectFetchContext::Cause cause,
-      OptionalProcessId pid);
+      OptionalProcessId pid,
+      Deadline deadline = std::nullopt,
+      std::optional<std::string> mountId = std::nullopt,
+      folly::CancellationToken cancellationToken = {});
 
   /**
    * Implementation detail of the make*Request functions from above. Do not
@@ -86,6 +106,9 @@ class HgImportRequest {
       ImportPriority priority,
       ObjectFetchContext::Cause cause,
       OptionalProcessId pid,
+      Deadline deadline,
+      std::optional<std::string> mountId,
+      folly::CancellationToken cancellationToken,
       folly::Promise<typename RequestType::Response>&& promise);
 
   ~HgImportRequest() = default;
@@ -123,6 +146,58 @@ class HgImportRequest {
     priority_ = priority;
   }
 
+  Deadline getDeadline() const noexcept {
+    return deadline_;
+  }
+
+  /**
+   * Tighten this request's deadline to the earlier of its current one and
+   * the given one. Used when a deduplicated request arrives with a nearer
+   * deadline. Returns true if the deadline changed.
+   */
+  bool mergeDeadline(Deadline deadline) noexcept {
+    if (deadline && (!deadline_ || *deadline < *deadline_)) {
+      deadline_ = deadline;
+      return true;
+    }
+    return false;
+  }
+
+  /**
+   * The mount this fetch originated from, when known. Used by
+   * HgImportRequestQueue to bound how many in-flight imports each mount may
+   * occupy.
+   */
+  const std::optional<std::string>& getMountId() const noexcept {
+    return mountId_;
+  }
+
+  /**
+   * Record that a deduplicated requester is also waiting on this import, so
+   * abandonment tracks every attached requester, not just the first.
+   */
+  void mergeCancellation(const HgImportRequest& duplicate) {
+    cancellationTokens_.insert(
+        cancellationTokens_.end(),
+        duplicate.cancellationTokens_.begin(),
+        duplicate.cancellationTokens_.end());
+  }
+
+  /**
+   * True when every requester attached to this import has cancelled. The
+   * queue drops abandoned requests instead of dispatching them. Requesters
+   * without a real cancellation token (the default token can never fire)
+   * keep the import alive.
+   */
+  bool isAbandoned() const {
+    return std::all_of(
+        cancellationTokens_.begin(),
+        cancellationTokens_.end(),
+        [](const folly::CancellationToken& token) {
+          return token.isCancellationRequested();
+        });
+  }
+
   template <typename T>
   folly::Promise<T>* getPromise() {
     auto promise = std::get_if<folly::Promise<T>>(&promise_); // Promise<T>
@@ -150,6 +225,9 @@ class HgImportRequest {
       ImportPriority priority,
       ObjectFetchContext::Cause cause,
       OptionalProcessId pid,
+      Deadline deadline,
+      std::optional<std::string> mountId,
+      folly::CancellationToken cancellationToken,
       Input&&... input);
 
   HgImportRequest(const HgImportRequest&) = delete;
@@ -165,6 +243,10 @@ class HgImportRequest {
   ImportPriority priority_;
   ObjectFetchContext::Cause cause_;
   OptionalProcessId pid_;
+  Deadline deadline_;
+  std::optional<std::string> mountId_;
+  /// One token per attached requester; see isAbandoned(). Never empty.
+  std::vector<folly::CancellationToken> cancellationTokens_;
   Response promise_;
   uint64_t unique_ = generateUniqueID();
   std::chrono::steady_clock::time_point requestTime_ =
@@ -173,7 +255,18 @@ class HgImportRequest {
   friend bool operator<(
       const HgImportRequest& lhs,
       const HgImportRequest& rhs) {
-    return lhs.priority_ < rhs.priority_;
+    if (lhs.priority_ != rhs.priority_) {
+      return lhs.priority_ < rhs.priority_;
+    }
+    // Within a priority, a request with an earlier deadline is dispatched
+    // first; a request without a deadline comes after any that have one.
+    if (lhs.deadline_ != rhs.deadline_) {
+      if (!lhs.deadline_ || !rhs.deadline_) {
+        return !lhs.deadline_;
+      }
+      return *lhs.deadline_ > *rhs.deadline_;
+    }
+    return false;
   }
 };
 
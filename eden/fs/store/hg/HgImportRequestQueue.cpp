@@ -8,11 +8,70 @@
 #include "eden/fs/store/hg/HgImportRequestQueue.h"
 #include <folly/MapUtil.h>
 #include <folly/futures/Future.h>
+#include <folly/logging/xlog.h>
 #include <algorithm>
+#include <chrono>
+#include <optional>
 #include "eden/fs/config/ReloadableConfig.h"
+#include "eden/fs/store/hg/HgQueuedBackingStore.h"
+#include "eden/fs/telemetry/TraceBus.h"
 
 namespace facebook::eden {
 
+namespace {
+
+const ObjectId& requestHash(HgImportRequest& request) {
+  if (auto* tree = request.getRequest<HgImportRequest::TreeImport>()) {
+    return tree->hash;
+  }
+  if (auto* blob = request.getRequest<HgImportRequest::BlobImport>()) {
+    return blob->hash;
+  }
+  return request.getRequest<HgImportRequest::BlobMetaImport>()->hash;
+}
+
+template <typename ImportType>
+void failPromises(HgImportRequest& request, folly::exception_wrapper error) {
+  auto* import = request.getRequest<ImportType>();
+  for (auto& promise : import->promises) {
+    promise.setException(error);
+  }
+  request.getPromise<typename ImportType::Response>()->setException(
+      std::move(error));
+}
+
+void failAllPromises(HgImportRequest& request, folly::exception_wrapper error) {
+  if (request.isType<HgImportRequest::TreeImport>()) {
+    failPromises<HgImportRequest::TreeImport>(request, std::move(error));
+  } else if (request.isType<HgImportRequest::BlobImport>()) {
+    failPromises<HgImportRequest::BlobImport>(request, std::move(error));
+  } else {
+    failPromises<HgImportRequest::BlobMetaImport>(request, std::move(error));
+  }
+}
+
+/**
+ * Fail every promise attached to an abandoned request with
+ * folly::OperationCancelled.
+ */
+void failAsAbandoned(HgImportRequest& request) {
+  failAllPromises(
+      request, folly::make_exception_wrapper<folly::OperationCancelled>());
+}
+
+/**
+ * Fail every promise attached to a request whose deadline passed while it
+ * was still queued. Once a deadline has expired, the fetch can no longer
+ * be useful; failing it immediately frees its slot for requests that can
+ * still complete in time.
+ */
+void failAsExpired(HgImportRequest& request) {
+  failAllPromises(
+      request, folly::make_exception_wrapper<folly::FutureTimeout>());
+}
+
+} // namespace
+
 void HgImportRequestQueue::stop() {
   auto state = state_.lock();
   if (state->running) {
@@ -54,11 +113,22 @@ folly::Future<std::shared_ptr<const T>> HgImportRequestQueue::enqueue(
         folly::makePromiseContract<std::shared_ptr<const T>>();
     trackedImport->promises.emplace_back(std::move(promise));
 
+    // The already queued request inherits the priority and deadline of the
+    // duplicate, so a high-priority fetch is never stuck behind the
+    // low-priority request that happened to be queued first.
+    bool reordered = false;
     if (existingRequest->getPriority() < request->getPriority()) {
       existingRequest->setPriority(request->getPriority());
+      reordered = true;
+    }
+    if (existingRequest->mergeDeadline(request->getDeadline())) {
+      reordered = true;
+    }
+    existingRequest->mergeCancellation(*request);
 
-      // Since the new request has a higher priority than the already present
-      // one, we need to re-order the heap.
+    if (reordered) {
+      // Since the tracked request is now more urgent than before, we need to
+      // re-order the heap.
       //
       // TODO(xavierd): this has a O(n) complexity, and enqueing tons of
       // duplicated requests will thus lead to a quadratic complexity.
@@ -71,6 +141,33 @@ folly::Future<std::shared_ptr<const T>> HgImportRequestQueue::enqueue(
           });
     }
 
+    if (traceBus_) {
+      HgImportTraceEvent::ResourceType resourceType;
+      if constexpr (std::is_same_v<ImportType, HgImportRequest::TreeImport>) {
+        resourceType = HgImportTraceEvent::TREE;
+      } else if constexpr (std::is_same_v<
+                               ImportType,
+                               HgImportRequest::BlobMetaImport>) {
+        resourceType = HgImportTraceEvent::BLOBMETA;
+      } else {
+        resourceType = HgImportTraceEvent::BLOB;
+      }
+      // The event carries the attached requester's unique, so a trace of
+      // that requester shows queue -> dedup -> finish while the tracked
+      // request carries the dequeue and start events.
+      auto event = HgImportTraceEvent::dedup(
+          request->getUnique(),
+          resourceType,
+          request->getRequest<ImportType>()->proxyHash,
+          request->getPriority().getClass(),
+          request->getCause(),
+          request->getPid());
+      // Publishing may block if the trace bus is at capacity; don't hold up
+      // other enqueues and dequeues on it.
+      state.unlock();
+      traceBus_->publish(std::move(event));
+    }
+
     return std::move(future).toUnsafeFuture();
   }
 
@@ -123,6 +220,13 @@ HgImportRequestQueue::combineAndClearRequestQueues() {
 std::vector<std::shared_ptr<HgImportRequest>> HgImportRequestQueue::dequeue() {
   size_t count;
   std::vector<std::shared_ptr<HgImportRequest>>* queue = nullptr;
+  ImportQueue* importQueue = nullptr;
+
+  const auto edenConfig = config_->getEdenConfig();
+  const auto batchWindow = edenConfig->importBatchWindow.getValue();
+  const auto maxInflightPerMount =
+      edenConfig->maxInflightImportRequestsPerMount.getValue();
+  std::optional<std::chrono::steady_clock::time_point> batchDeadline;
 
   auto state = state_.lock();
   while (true) {
@@ -143,12 +247,14 @@ std::vector<std::shared_ptr<HgImportRequest>> HgImportRequestQueue::dequeue() {
       count = config_->getEdenConfig()->importBatchSizeTree.getValue();
       highestPriority = state->treeQueue.queue.front()->getPriority();
       queue = &state->treeQueue.queue;
+      importQueue = &state->treeQueue;
     }
 
     if (!state->blobMetaQueue.queue.empty()) {
       auto priority = state->blobMetaQueue.queue.front()->getPriority();
       if (!queue || priority > highestPriority) {
         queue = &state->blobMetaQueue.queue;
+        importQueue = &state->blobMetaQueue;
         count = config_->getEdenConfig()->importBatchSizeBlobMeta.getValue();
         highestPriority = priority;
       }
@@ -158,35 +264,121 @@ std::vector<std::shared_ptr<HgImportRequest>> HgImportRequestQueue::dequeue() {
       auto priority = state->blobQueue.queue.front()->getPriority();
       if (!queue || priority > highestPriority) {
         queue = &state->blobQueue.queue;
+        importQueue = &state->blobQueue;
         count = config_->getEdenConfig()->importBatchSize.getValue();
         highestPriority = priority;
       }
     }
 
-    if (queue) {
-      break;
-    } else {
+    if (!queue) {
       queueCV_.wait(state.as_lock());
+      continue;
     }
-  }
 
-  count = std::min(count, queue->size());
-  std::vector<std::shared_ptr<HgImportRequest>> result;
-  result.reserve(count);
-  for (size_t i = 0; i < count; i++) {
-    std::pop_heap(
-        queue->begin(),
-        queue->end(),
-        [](const std::shared_ptr<HgImportRequest>& lhs,
-           const std::shared_ptr<HgImportRequest>& rhs) {
-          return (*lhs) < (*rhs);
-        });
-
-    result.emplace_back(std::move(queue->back()));
-    queue->pop_back();
-  }
+    if (batchWindow.count() != 0 && queue->size() < count) {
+      // A batch is available but not yet full. Briefly wait for more
+      // requests to arrive so bursty fetches fill the batch and amortize the
+      // importer round-trip, instead of dispatching batches of size 1.
+      auto now = std::chrono::steady_clock::now();
+      if (!batchDeadline) {
+        batchDeadline = now + batchWindow;
+      }
+      if (now < *batchDeadline) {
+        queueCV_.wait_until(state.as_lock(), *batchDeadline);
+        queue = nullptr;
+        importQueue = nullptr;
+        continue;
+      }
+    }
+
+    auto comparator = [](const std::shared_ptr<HgImportRequest>& lhs,
+                         const std::shared_ptr<HgImportRequest>& rhs) {
+      return (*lhs) < (*rhs);
+    };
+
+    count = std::min(count, queue->size());
+    std::vector<std::shared_ptr<HgImportRequest>> result;
+    result.reserve(count);
+
+    // Requests belonging to a mount that has reached its in-flight limit are
+    // set aside and pushed back onto the heap afterwards, so one mount's
+    // flood of imports cannot occupy every worker.
+    std::vector<std::shared_ptr<HgImportRequest>> deferred;
+    std::vector<std::shared_ptr<HgImportRequest>> dropped;
+    std::vector<std::shared_ptr<HgImportRequest>> expired;
+    const auto now = std::chrono::steady_clock::now();
+    while (result.size() < count && !queue->empty()) {
+      std::pop_heap(queue->begin(), queue->end(), comparator);
+      auto request = std::move(queue->back());
+      queue->pop_back();
+
+      if (request->isAbandoned()) {
+        // Every requester of this import has cancelled; drop it instead of
+        // spending a worker slot and an importer round-trip on data nobody
+        // is waiting for.
+        importQueue->requestTracker.erase(requestHash(*request));
+        dropped.emplace_back(std::move(request));
+        continue;
+      }
+
+      if (auto deadline = request->getDeadline();
+          deadline && *deadline <= now) {
+        // The deadline passed while the request sat in the queue; fail it
+        // fast instead of fetching data the requester has given up on.
+        importQueue->requestTracker.erase(requestHash(*request));
+        expired.emplace_back(std::move(request));
+        continue;
+      }
+
+      if (maxInflightPerMount != 0 && request->getMountId()) {
+        auto& inflight = state->inflightByMount[*request->getMountId()];
+        if (inflight >= maxInflightPerMount) {
+          deferred.emplace_back(std::move(request));
+          continue;
+        }
+        ++inflight;
+      }
+      result.emplace_back(std::move(request));
+    }
+
+    for (auto& request : deferred) {
+      queue->emplace_back(std::move(request));
+      std::push_heap(queue->begin(), queue->end(), comparator);
+    }
+
+    if (!dropped.empty() || !expired.empty()) {
+      XLOG(DBG4) << "dropping " << dropped.size()
+                 << " abandoned and failing " << expired.size()
+                 << " expired import requests";
+      // Fulfil the promises without holding the queue lock: setting an
+      // exception may run continuations inline.
+      state.unlock();
+      for (auto& request : dropped) {
+        failAsAbandoned(*request);
+      }
+      for (auto& request : expired) {
+        failAsExpired(*request);
+      }
+      if (!result.empty()) {
+        return result;
+      }
+      state = state_.lock();
+      queue = nullptr;
+      importQueue = nullptr;
+      continue;
+    }
 
-  return result;
+    if (!result.empty()) {
+      return result;
+    }
+
+    // Every dispatchable request belongs to a mount at its in-flight limit.
+    // Wait for an import to finish (markImportAsFinished notifies) or for
+    // requests from other mounts to arrive.
+    queueCV_.wait(state.as_lock());
+    queue = nullptr;
+    importQueue = nullptr;
+  }
 }
 
 } // namespace facebook::eden
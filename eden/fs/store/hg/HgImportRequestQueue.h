@@ -12,6 +12,7 @@
 #include <folly/container/F14Map.h>
 #include <condition_variable>
 #include <mutex>
+#include <string>
 #include <vector>
 #include "eden/fs/model/Hash.h"
 #include "eden/fs/store/hg/HgImportRequest.h"
@@ -20,12 +21,24 @@
 namespace facebook::eden {
 
 class ReloadableConfig;
+struct HgImportTraceEvent;
+template <typename TraceEvent>
+class TraceBus;
 
 class HgImportRequestQueue {
  public:
   explicit HgImportRequestQueue(std::shared_ptr<ReloadableConfig> config)
       : config_(std::move(config)) {}
 
+  /**
+   * Attach the trace bus that dedup-attach events are published to. Called
+   * by the owning HgQueuedBackingStore before any request is enqueued; the
+   * queue publishes nothing when no bus is attached.
+   */
+  void setTraceBus(std::shared_ptr<TraceBus<HgImportTraceEvent>> traceBus) {
+    traceBus_ = std::move(traceBus);
+  }
+
   /**
    * Enqueue a blob request to the queue.
    *
@@ -110,6 +123,13 @@ class HgImportRequestQueue {
     ImportQueue treeQueue;
     ImportQueue blobQueue;
     ImportQueue blobMetaQueue;
+
+    /**
+     * Number of dequeued-but-unfinished requests per mount. Used by
+     * dequeue() to bound how much of the worker pool a single mount may
+     * occupy; see hg:max-inflight-import-requests-per-mount.
+     */
+    folly::F14FastMap<std::string, uint64_t> inflightByMount;
   };
 
   /**
@@ -121,6 +141,7 @@ class HgImportRequestQueue {
           state);
 
   std::shared_ptr<ReloadableConfig> config_;
+  std::shared_ptr<TraceBus<HgImportTraceEvent>> traceBus_;
   folly::Synchronized<State, std::mutex> state_;
   std::condition_variable queueCV_;
 };
@@ -139,6 +160,18 @@ void HgImportRequestQueue::markImportAsFinished(
       import = std::move(importReq->second);
       requestTracker.erase(importReq);
     }
+
+    if (import && import->getMountId()) {
+      auto inflight = state->inflightByMount.find(*import->getMountId());
+      if (inflight != state->inflightByMount.end()) {
+        if (--inflight->second == 0) {
+          state->inflightByMount.erase(inflight);
+        }
+        // A worker may be waiting for this mount to drop below its in-flight
+        // limit.
+        queueCV_.notify_all();
+      }
+    }
   }
 
   if (!import) {
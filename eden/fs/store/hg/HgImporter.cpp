@@ -264,13 +264,61 @@ BlobPtr HgImporter::importFileContents(
   // Ask the import helper process for the file contents
   auto requestID = sendFileRequest(path, blobHash);
 
+  return readFileContentsResponse(requestID, path, blobHash);
+}
+
+std::vector<folly::Try<BlobPtr>> HgImporter::importFileContents(
+    const std::vector<std::pair<RelativePath, Hash20>>& requests) {
+  XLOG(DBG5) << "requesting contents of " << requests.size() << " files";
+
+  // Write all the requests to the helper before reading any response, so
+  // the helper can work on the next file while we consume the response for
+  // the previous one, instead of paying a full pipe round trip per file.
+  std::vector<TransactionID> txnIDs;
+  txnIDs.reserve(requests.size());
+  for (const auto& [path, blobHash] : requests) {
+    txnIDs.push_back(sendFileRequest(path, blobHash));
+  }
+
+  std::vector<folly::Try<BlobPtr>> results;
+  results.reserve(requests.size());
+  for (size_t i = 0; i < requests.size(); ++i) {
+    const auto& [path, blobHash] = requests[i];
+    try {
+      results.emplace_back(readFileContentsResponse(txnIDs[i], path, blobHash));
+    } catch (const HgImporterError&) {
+      // The pipe to the helper process is no longer usable, so the responses
+      // for the remaining requests can never be read. Let the caller
+      // (normally HgImporterManager) restart the helper and retry.
+      throw;
+    } catch (const std::exception& ex) {
+      // The helper reported an error for this file only and keeps
+      // responding; the response stream is still in sync, so keep reading
+      // the remaining responses.
+      results.emplace_back(folly::Try<BlobPtr>{
+          folly::exception_wrapper{std::current_exception(), ex}});
+    }
+  }
+  return results;
+}
+
+BlobPtr HgImporter::readFileContentsResponse(
+    TransactionID txnID,
+    RelativePathPiece path,
+    Hash20 blobHash) {
   // Read the response.  The response body contains the file contents,
   // which is exactly what we want to return.
   //
   // Note: For now we expect to receive the entire contents in a single chunk.
   // In the future we might want to consider if it is more efficient to receive
   // the body data in fixed-size chunks, particularly for very large files.
-  auto header = readChunkHeader(requestID, "CMD_CAT_FILE");
+  auto header = readChunkHeader(txnID, "CMD_CAT_FILE");
+  auto buf = IOBuf(IOBuf::CREATE, header.dataLength);
+
+  readFromHelper(
+      buf.writableTail(), header.dataLength, "CMD_CAT_FILE response body");
+  buf.append(header.dataLength);
+
   if (header.dataLength < sizeof(uint64_t)) {
     auto msg = fmt::format(
         "CMD_CAT_FILE response for blob {} ({}, {}) "
@@ -283,11 +331,6 @@ BlobPtr HgImporter::importFileContents(
     XLOG(ERR) << msg;
     throw std::runtime_error(std::move(msg));
   }
-  auto buf = IOBuf(IOBuf::CREATE, header.dataLength);
-
-  readFromHelper(
-      buf.writableTail(), header.dataLength, "CMD_CAT_FILE response body");
-  buf.append(header.dataLength);
 
   // The last 8 bytes of the response are the body length.
   // Ensure that this looks correct, and advance the buffer past this data to
@@ -653,6 +696,15 @@ BlobPtr HgImporterManager::importFileContents(
       __func__);
 }
 
+std::vector<folly::Try<BlobPtr>> HgImporterManager::importFileContents(
+    const std::vector<std::pair<RelativePath, Hash20>>& requests) {
+  return retryOnError(
+      [&](HgImporter* importer) {
+        return importer->importFileContents(requests);
+      },
+      __func__);
+}
+
 std::unique_ptr<IOBuf> HgImporterManager::fetchTree(
     RelativePathPiece path,
     Hash20 pathManifestNode) {
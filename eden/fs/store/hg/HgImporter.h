@@ -8,9 +8,12 @@
 #pragma once
 
 #include <folly/Range.h>
+#include <folly/Try.h>
 #include <folly/portability/GFlags.h>
 #include <folly/portability/IOVec.h>
 #include <optional>
+#include <utility>
+#include <vector>
 
 #include "eden/fs/eden-config.h"
 #include "eden/fs/model/BlobFwd.h"
@@ -79,6 +82,22 @@ class Importer {
       RelativePathPiece path,
       Hash20 blobHash) = 0;
 
+  /**
+   * Import the contents of several files in one pipelined exchange.
+   *
+   * All requests are written to the helper process before any response is
+   * read, so the pipe round trip that importFileContents() pays per file is
+   * only paid once for the whole batch. The protocol's per-request
+   * transaction IDs are used to match each response to its request.
+   *
+   * Results are returned in the same order as the requests. An error that
+   * only affects a single file (the helper keeps responding afterwards) is
+   * captured in the corresponding Try; an error that leaves the helper
+   * process unusable is thrown and fails the whole batch.
+   */
+  virtual std::vector<folly::Try<BlobPtr>> importFileContents(
+      const std::vector<std::pair<RelativePath, Hash20>>& requests) = 0;
+
   /**
    * Import tree and store it in the datapack
    *
@@ -124,6 +143,8 @@ class HgImporter : public Importer {
 
   Hash20 resolveManifestNode(folly::StringPiece revName) override;
   BlobPtr importFileContents(RelativePathPiece path, Hash20 blobHash) override;
+  std::vector<folly::Try<BlobPtr>> importFileContents(
+      const std::vector<std::pair<RelativePath, Hash20>>& requests) override;
   std::unique_ptr<folly::IOBuf> fetchTree(
       RelativePathPiece path,
       Hash20 pathManifestNode) override;
@@ -217,6 +238,16 @@ class HgImporter : public Importer {
    */
   [[noreturn]] void readErrorAndThrow(const ChunkHeader& header);
 
+  /**
+   * Read and validate the CMD_CAT_FILE response for a previously sent file
+   * request. The full response chunk is always consumed, so the response
+   * stream stays in sync even when this throws.
+   */
+  BlobPtr readFileContentsResponse(
+      TransactionID txnID,
+      RelativePathPiece path,
+      Hash20 blobHash);
+
   void readFromHelper(void* buf, uint32_t size, folly::StringPiece context);
   void
   writeToHelper(struct iovec* iov, size_t numIov, folly::StringPiece context);
@@ -297,6 +328,8 @@ class HgImporterManager : public Importer {
   Hash20 resolveManifestNode(folly::StringPiece revName) override;
 
   BlobPtr importFileContents(RelativePathPiece path, Hash20 blobHash) override;
+  std::vector<folly::Try<BlobPtr>> importFileContents(
+      const std::vector<std::pair<RelativePath, Hash20>>& requests) override;
   std::unique_ptr<folly::IOBuf> fetchTree(
       RelativePathPiece path,
       Hash20 pathManifestNode) override;
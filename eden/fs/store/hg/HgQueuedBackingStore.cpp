@@ -7,6 +7,7 @@
 
 #include "eden/fs/store/hg/HgQueuedBackingStore.h"
 
+#include <algorithm>
 #include <chrono>
 #include <thread>
 #include <utility>
@@ -14,8 +15,10 @@
 
 #include <re2/re2.h>
 
+#include <folly/CppAttributes.h>
 #include <folly/Range.h>
 #include <folly/String.h>
+#include <folly/executors/QueuedImmediateExecutor.h>
 #include <folly/futures/Future.h>
 #include <folly/logging/xlog.h>
 #include <folly/portability/GFlags.h>
@@ -25,8 +28,10 @@
 #include "eden/fs/model/Blob.h"
 #include "eden/fs/service/ThriftUtil.h"
 #include "eden/fs/store/BackingStoreLogger.h"
+#include "eden/fs/store/KeySpace.h"
 #include "eden/fs/store/LocalStore.h"
 #include "eden/fs/store/ObjectFetchContext.h"
+#include "eden/fs/store/StoreResult.h"
 #include "eden/fs/store/hg/HgBackingStore.h"
 #include "eden/fs/store/hg/HgImportRequest.h"
 #include "eden/fs/store/hg/HgProxyHash.h"
@@ -50,6 +55,44 @@ static_assert(CheckSize<HgImportTraceEvent, 72>());
 // 10 MB overhead per backing repo is tolerable.
 static_assert(
     CheckEqual<7200000, kTraceBusCapacity * sizeof(HgImportTraceEvent)>());
+
+std::optional<std::string> copyMountId(
+    std::optional<std::string_view> mountId) {
+  return mountId ? std::make_optional(std::string{*mountId}) : std::nullopt;
+}
+
+// Bounds both the serialized size of a tree fetch log entry in the
+// LocalStore and the number of imports a warm-up pass may enqueue.
+constexpr size_t kTreeFetchLogMaxEntries = 20000;
+
+/**
+ * Fetch context used when replaying the tree fetch log. The low priority
+ * keeps the replayed imports behind any demand fetch in the import queue.
+ */
+class TreeFetchLogContext : public ObjectFetchContext {
+ public:
+  Cause getCause() const override {
+    return Cause::Prefetch;
+  }
+
+  std::optional<std::string_view> getCauseDetail() const override {
+    return "tree-fetch-log";
+  }
+
+  ImportPriority getPriority() const override {
+    return ImportPriority{ImportPriority::Class::Low};
+  }
+
+  const std::unordered_map<std::string, std::string>* FOLLY_NULLABLE
+  getRequestInfo() const override {
+    return nullptr;
+  }
+};
+
+ObjectFetchContextPtr getTreeFetchLogContext() {
+  static auto* p = new TreeFetchLogContext;
+  return ObjectFetchContextPtr::singleton(*p);
+}
 } // namespace
 
 HgImportTraceEvent::HgImportTraceEvent(
@@ -111,6 +154,14 @@ HgQueuedBackingStore::HgQueuedBackingStore(
       [this](const HgImportTraceEvent& event) {
         activityBuffer_.addEvent(event);
       });
+
+  dwellStatsHandle_ = traceBus_->subscribeFunction(
+      folly::to<std::string>("hg-dwell-stats-", getRepoName().value_or("")),
+      [this](const HgImportTraceEvent& event) { recordDwellEvent(event); });
+
+  // Let the queue publish dedup-attach events alongside the queue/dequeue
+  // events published here.
+  queue_.setTraceBus(traceBus_);
 }
 
 HgQueuedBackingStore::~HgQueuedBackingStore() {
@@ -145,37 +196,45 @@ void HgQueuedBackingStore::processBlobImportRequests(
   backingStore_->getDatapackStore().getBlobBatch(requests);
 
   {
-    std::vector<folly::SemiFuture<folly::Unit>> futures;
-    futures.reserve(requests.size());
+    std::vector<std::shared_ptr<HgImportRequest>> retries;
+    std::vector<HgProxyHash> proxyHashes;
 
     for (auto& request : requests) {
       auto* promise = request->getPromise<BlobPtr>();
       if (promise->isFulfilled()) {
         stats_->addDuration(&HgBackingStoreStats::fetchBlob, watch.elapsed());
+        importDeadlines_.recordLatency(
+            AdaptiveImportDeadlines::Operation::Blob, watch.elapsed());
         continue;
       }
 
       // The blobs were either not found locally, or, when EdenAPI is enabled,
       // not found on the server. Let's import the blob through the hg importer.
       // TODO(xavierd): remove when EdenAPI has been rolled out everywhere.
-      auto fetchSemiFuture = backingStore_->fetchBlobFromHgImporter(
+      proxyHashes.emplace_back(
           request->getRequest<HgImportRequest::BlobImport>()->proxyHash);
-      futures.emplace_back(
-          std::move(fetchSemiFuture)
-              .defer([request = std::move(request),
-                      watch,
-                      stats = stats_.copy()](auto&& result) mutable {
-                XLOG(DBG4)
-                    << "Imported blob from HgImporter for "
-                    << request->getRequest<HgImportRequest::BlobImport>()->hash;
-                stats->addDuration(
-                    &HgBackingStoreStats::fetchBlob, watch.elapsed());
-                request->getPromise<HgImportRequest::BlobImport::Response>()
-                    ->setTry(std::forward<decltype(result)>(result));
-              }));
+      retries.emplace_back(std::move(request));
     }
 
-    folly::collectAll(futures).wait();
+    if (!retries.empty()) {
+      // All the missing blobs are fetched in one pipelined pass over the
+      // importer processes instead of a pipe round trip per blob.
+      auto results =
+          backingStore_->fetchBlobsFromHgImporter(std::move(proxyHashes))
+              .getTry();
+
+      for (size_t i = 0; i < retries.size(); ++i) {
+        auto& request = retries[i];
+        XLOG(DBG4) << "Imported blob from HgImporter for "
+                   << request->getRequest<HgImportRequest::BlobImport>()->hash;
+        stats_->addDuration(&HgBackingStoreStats::fetchBlob, watch.elapsed());
+        importDeadlines_.recordLatency(
+            AdaptiveImportDeadlines::Operation::Blob, watch.elapsed());
+        request->getPromise<HgImportRequest::BlobImport::Response>()->setTry(
+            results.hasValue() ? std::move(results.value()[i])
+                               : folly::Try<BlobPtr>{results.exception()});
+      }
+    }
   }
 }
 
@@ -209,6 +268,8 @@ void HgQueuedBackingStore::processTreeImportRequests(
       auto* promise = request->getPromise<TreePtr>();
       if (promise->isFulfilled()) {
         stats_->addDuration(&HgBackingStoreStats::fetchTree, watch.elapsed());
+        importDeadlines_.recordLatency(
+            AdaptiveImportDeadlines::Operation::Tree, watch.elapsed());
         continue;
       }
 
@@ -219,7 +280,8 @@ void HgQueuedBackingStore::processTreeImportRequests(
       auto treeSemiFuture = backingStore_->getTree(request);
       futures.emplace_back(
           std::move(treeSemiFuture)
-              .defer([request = std::move(request),
+              .defer([this,
+                      request = std::move(request),
                       watch,
                       stats = stats_.copy()](auto&& result) mutable {
                 XLOG(DBG4)
@@ -227,6 +289,8 @@ void HgQueuedBackingStore::processTreeImportRequests(
                     << request->getRequest<HgImportRequest::TreeImport>()->hash;
                 stats->addDuration(
                     &HgBackingStoreStats::fetchTree, watch.elapsed());
+                importDeadlines_.recordLatency(
+                    AdaptiveImportDeadlines::Operation::Tree, watch.elapsed());
                 request->getPromise<HgImportRequest::TreeImport::Response>()
                     ->setTry(std::forward<decltype(result)>(result));
               }));
@@ -265,6 +329,8 @@ void HgQueuedBackingStore::processBlobMetaImportRequests(
       if (promise->isFulfilled()) {
         stats_->addDuration(
             &HgBackingStoreStats::fetchBlobMetadata, watch.elapsed());
+        importDeadlines_.recordLatency(
+            AdaptiveImportDeadlines::Operation::BlobMeta, watch.elapsed());
         continue;
       }
 
@@ -277,6 +343,54 @@ void HgQueuedBackingStore::processBlobMetaImportRequests(
   }
 }
 
+std::optional<std::chrono::steady_clock::time_point>
+HgQueuedBackingStore::deriveImportDeadline(
+    const ObjectFetchContextPtr& context,
+    AdaptiveImportDeadlines::Operation operation) {
+  auto deadline = context->getDeadline();
+  if (!config_) {
+    return deadline;
+  }
+  auto edenConfig = config_->getEdenConfig();
+  if (!edenConfig->adaptiveImportDeadlines.getValue()) {
+    return deadline;
+  }
+  auto derived = importDeadlines_.deriveDeadline(
+      operation,
+      std::chrono::duration_cast<std::chrono::microseconds>(
+          edenConfig->adaptiveImportDeadlineMin.getValue()),
+      std::chrono::duration_cast<std::chrono::microseconds>(
+          edenConfig->adaptiveImportDeadlineMax.getValue()));
+  if (derived && (!deadline || *derived < *deadline)) {
+    return derived;
+  }
+  return deadline;
+}
+
+namespace {
+
+/**
+ * Publish a DEQUEUE trace event for every request in a freshly dequeued
+ * batch, marking the end of their queue dwell.
+ */
+template <typename ImportType>
+void publishDequeueEvents(
+    TraceBus<HgImportTraceEvent>& traceBus,
+    HgImportTraceEvent::ResourceType resourceType,
+    const std::vector<std::shared_ptr<HgImportRequest>>& requests) {
+  for (auto& request : requests) {
+    traceBus.publish(HgImportTraceEvent::dequeue(
+        request->getUnique(),
+        resourceType,
+        request->getRequest<ImportType>()->proxyHash,
+        request->getPriority().getClass(),
+        request->getCause(),
+        request->getPid()));
+  }
+}
+
+} // namespace
+
 void HgQueuedBackingStore::processRequest() {
   folly::setThreadName("hgqueue");
   for (;;) {
@@ -289,15 +403,88 @@ void HgQueuedBackingStore::processRequest() {
     const auto& first = requests.at(0);
 
     if (first->isType<HgImportRequest::BlobImport>()) {
+      publishDequeueEvents<HgImportRequest::BlobImport>(
+          *traceBus_, HgImportTraceEvent::BLOB, requests);
       processBlobImportRequests(std::move(requests));
     } else if (first->isType<HgImportRequest::TreeImport>()) {
+      publishDequeueEvents<HgImportRequest::TreeImport>(
+          *traceBus_, HgImportTraceEvent::TREE, requests);
       processTreeImportRequests(std::move(requests));
     } else if (first->isType<HgImportRequest::BlobMetaImport>()) {
+      publishDequeueEvents<HgImportRequest::BlobMetaImport>(
+          *traceBus_, HgImportTraceEvent::BLOBMETA, requests);
       processBlobMetaImportRequests(std::move(requests));
     }
   }
 }
 
+void HgImportDwellStats::Stage::addSample(std::chrono::microseconds duration) {
+  auto us = static_cast<uint64_t>(std::max<int64_t>(duration.count(), 0));
+  ++count;
+  totalDurationUs += us;
+  maxDurationUs = std::max(maxDurationUs, us);
+
+  // Logarithmic bucket boundaries, in microseconds: 1ms, 10ms, 100ms, 1s,
+  // 10s. Everything else lands in the final bucket.
+  static constexpr std::array<uint64_t, kNumBuckets - 1> kBoundsUs = {
+      1'000, 10'000, 100'000, 1'000'000, 10'000'000};
+  size_t bucket = 0;
+  while (bucket < kBoundsUs.size() && us >= kBoundsUs[bucket]) {
+    ++bucket;
+  }
+  ++histogram[bucket];
+}
+
+void HgQueuedBackingStore::recordDwellEvent(const HgImportTraceEvent& event) {
+  auto now = event.monotonicTime;
+  auto state = dwellState_.wlock();
+  switch (event.eventType) {
+    case HgImportTraceEvent::QUEUE:
+      state->pending[event.unique] = DwellState::PendingImport{now, {}};
+      break;
+    case HgImportTraceEvent::DEDUP:
+      ++state->byPriority[event.importPriority].deduplicated;
+      break;
+    case HgImportTraceEvent::DEQUEUE: {
+      auto it = state->pending.find(event.unique);
+      if (it != state->pending.end()) {
+        state->byPriority[event.importPriority].queueDwell.addSample(
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                now - it->second.queueTime));
+      }
+      break;
+    }
+    case HgImportTraceEvent::START: {
+      auto it = state->pending.find(event.unique);
+      if (it != state->pending.end()) {
+        it->second.startTime = now;
+      }
+      break;
+    }
+    case HgImportTraceEvent::FINISH: {
+      auto it = state->pending.find(event.unique);
+      if (it != state->pending.end()) {
+        auto& stats = state->byPriority[event.importPriority];
+        stats.total.addSample(
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                now - it->second.queueTime));
+        if (it->second.startTime) {
+          stats.execution.addSample(
+              std::chrono::duration_cast<std::chrono::microseconds>(
+                  now - *it->second.startTime));
+        }
+        state->pending.erase(it);
+      }
+      break;
+    }
+  }
+}
+
+std::map<ImportPriority::Class, HgImportDwellStats>
+HgQueuedBackingStore::getImportDwellStats() const {
+  return dwellState_.rlock()->byPriority;
+}
+
 ObjectComparison HgQueuedBackingStore::compareObjectsById(
     const ObjectId& one,
     const ObjectId& two) {
@@ -413,6 +600,7 @@ folly::SemiFuture<BackingStore::GetTreeResult> HgQueuedBackingStore::getTree(
           backingStore_->getDatapackStore().getTreeLocal(id, proxyHash)) {
     XLOG(DBG5) << "imported tree of '" << proxyHash.path() << "', "
                << proxyHash.revHash().toString() << " from hgcache";
+    prefetchTreeProxyHashes(tree);
     return folly::makeSemiFuture(GetTreeResult{
         std::move(tree), ObjectFetchContext::Origin::FromDiskCache});
   }
@@ -432,7 +620,10 @@ HgQueuedBackingStore::getTreeImpl(
         proxyHash,
         context->getPriority(),
         context->getCause(),
-        context->getClientPid());
+        context->getClientPid(),
+        deriveImportDeadline(context, AdaptiveImportDeadlines::Operation::Tree),
+        copyMountId(context->getMountId()),
+        context->getCancellationToken());
     uint64_t unique = request->getUnique();
 
     auto importTracker =
@@ -461,13 +652,212 @@ HgQueuedBackingStore::getTreeImpl(
         });
   });
 
-  return std::move(getTreeFuture)
+  auto treeFuture = std::move(getTreeFuture)
       .thenTry([this, id](folly::Try<TreePtr>&& result) {
         this->queue_.markImportAsFinished<TreePtr::element_type>(id, result);
         auto tree = std::move(result).value();
+        recordTreeFetch(id);
+        prefetchTreeProxyHashes(tree);
         return GetTreeResult{
             std::move(tree), ObjectFetchContext::Origin::FromNetworkFetch};
       });
+
+  std::chrono::nanoseconds hedgeDelay{0};
+  if (config_) {
+    hedgeDelay = config_->getEdenConfig()->hgHedgedTreeImportDelay.getValue();
+  }
+  if (hedgeDelay.count() == 0 ||
+      context->getCause() == ObjectFetchContext::Cause::Prefetch) {
+    return std::move(treeFuture);
+  }
+
+  return hedgeTreeImport(
+      std::move(treeFuture), id, proxyHash, context, hedgeDelay);
+}
+
+folly::SemiFuture<BackingStore::GetTreeResult>
+HgQueuedBackingStore::hedgeTreeImport(
+    folly::Future<GetTreeResult> treeFuture,
+    const ObjectId& id,
+    const HgProxyHash& proxyHash,
+    const ObjectFetchContextPtr& context,
+    std::chrono::nanoseconds delay) {
+  auto hedgeFuture =
+      folly::futures::sleep(delay)
+          .via(backingStore_->getServerThreadPool())
+          .thenValue([this,
+                      id,
+                      path = proxyHash.path().copy(),
+                      manifestId = proxyHash.revHash(),
+                      context = context.copy()](folly::Unit) {
+            stats_->increment(&HgBackingStoreStats::hedgedTreeImport);
+            auto tree = backingStore_->getDatapackStore().getTree(
+                path, manifestId, id, context);
+            if (!tree) {
+              throwf<std::domain_error>(
+                  "hedged import did not find tree {}", manifestId);
+            }
+            return GetTreeResult{
+                std::move(tree), ObjectFetchContext::Origin::FromNetworkFetch};
+          });
+
+  return folly::collectAnyWithoutException(
+             std::move(treeFuture), std::move(hedgeFuture))
+      .deferValue([this](std::pair<size_t, GetTreeResult>&& result) {
+        if (result.first == 1) {
+          stats_->increment(&HgBackingStoreStats::hedgedTreeImportWin);
+        }
+        return std::move(result.second);
+      });
+}
+
+void HgQueuedBackingStore::prefetchTreeProxyHashes(const TreePtr& tree) {
+  if (!tree || !config_->getEdenConfig()->hgTreeProxyHashPrefetch.getValue()) {
+    return;
+  }
+
+  auto ids = std::make_unique<std::vector<ObjectId>>();
+  for (const auto& entry : *tree) {
+    const auto& id = entry.second.getHash();
+    // Embedded proxy hashes are decoded straight from the object ID; only
+    // legacy 20-byte IDs are resolved through the LocalStore.
+    if (id.size() == Hash20::RAW_SIZE) {
+      ids->push_back(id);
+    }
+  }
+  if (ids->empty()) {
+    return;
+  }
+
+  // HgProxyHash::getBatch requires the passed range to outlive the future,
+  // keep the vector alive until it completes. The batched read runs on the
+  // LocalStore's IO executor; nothing waits on it and failures are ignored
+  // as the point lookup on the fetch path will surface any real error.
+  auto& idsRef = *ids;
+  folly::futures::detachOn(
+      &folly::QueuedImmediateExecutor::instance(),
+      HgProxyHash::getBatch(localStore_.get(), idsRef, *stats_)
+          .semi()
+          .deferValue([](std::vector<HgProxyHash>&&) {})
+          .deferError([](const folly::exception_wrapper&) {})
+          .deferEnsure([ids = std::move(ids)] {}));
+}
+
+void HgQueuedBackingStore::recordTreeFetch(const ObjectId& id) {
+  if (!config_ || !config_->getEdenConfig()->hgTreeFetchLog.getValue()) {
+    return;
+  }
+
+  auto log = treeFetchLog_.wlock();
+  if (!log->root.has_value() || log->ids.size() >= kTreeFetchLogMaxEntries) {
+    return;
+  }
+  log->ids.insert(id);
+}
+
+void HgQueuedBackingStore::rotateTreeFetchLog(const RootId& rootId) {
+  std::optional<std::string> previousRoot;
+  folly::F14FastSet<ObjectId> previousIds;
+  {
+    auto log = treeFetchLog_.wlock();
+    if (log->root == rootId.value()) {
+      // The active root is re-resolved on remounts and during checkout;
+      // only a change of root rotates the log.
+      return;
+    }
+    previousRoot = std::exchange(log->root, rootId.value());
+    previousIds = std::exchange(log->ids, {});
+  }
+
+  if (previousRoot.has_value() && !previousIds.empty()) {
+    writeTreeFetchLog(*previousRoot, previousIds);
+  }
+  warmTreeFetchLog(rootId);
+}
+
+void HgQueuedBackingStore::warmTreeFetchLog(const RootId& rootId) {
+  auto result = folly::makeTryWith([&] {
+    return localStore_->get(
+        KeySpace::TreeFetchLogFamily,
+        folly::ByteRange{folly::StringPiece{rootId.value()}});
+  });
+  if (result.hasException()) {
+    XLOG(DBG2) << "failed to read tree fetch log for " << rootId << ": "
+               << folly::exceptionStr(result.exception());
+    return;
+  }
+  if (!result->isValid()) {
+    return;
+  }
+
+  auto context = getTreeFetchLogContext();
+  auto data = result->bytes();
+  size_t numEnqueued = 0;
+  while (!data.empty() && numEnqueued < kTreeFetchLogMaxEntries) {
+    auto size = static_cast<size_t>(static_cast<uint8_t>(data.front()));
+    data.advance(1);
+    if (size == 0 || data.size() < size) {
+      XLOG(DBG2) << "corrupt tree fetch log for " << rootId
+                 << ", stopping replay";
+      break;
+    }
+    ObjectId id{data.subpiece(0, size)};
+    data.advance(size);
+
+    // Only embedded proxy hashes can be resolved without a LocalStore
+    // lookup; legacy IDs are rare enough not to be worth replaying. The log
+    // comes from disk, so treat an unparseable ID as corruption rather than
+    // letting the exception out of the mount path.
+    std::optional<HgProxyHash> proxyHash;
+    try {
+      proxyHash = HgProxyHash::tryParseEmbeddedProxyHash(id);
+    } catch (const std::exception&) {
+      XLOG(DBG2) << "corrupt tree fetch log for " << rootId
+                 << ", stopping replay";
+      break;
+    }
+    if (!proxyHash.has_value()) {
+      continue;
+    }
+
+    // The fetches land in the hgcache via the regular import path; the
+    // results themselves are dropped.
+    folly::futures::detachOn(
+        &folly::QueuedImmediateExecutor::instance(),
+        getTreeImpl(id, *proxyHash, context)
+            .deferValue([](GetTreeResult&&) {})
+            .deferError([](const folly::exception_wrapper& ew) {
+              XLOG(DBG4) << "tree fetch log replay failed: "
+                         << folly::exceptionStr(ew);
+            }));
+    ++numEnqueued;
+  }
+
+  XLOG(DBG2) << "replaying " << numEnqueued << " tree imports for " << rootId;
+}
+
+void HgQueuedBackingStore::writeTreeFetchLog(
+    const std::string& root,
+    const folly::F14FastSet<ObjectId>& ids) {
+  std::string value;
+  for (const auto& id : ids) {
+    auto bytes = id.getBytes();
+    if (bytes.empty() || bytes.size() > 255) {
+      continue;
+    }
+    value.push_back(static_cast<char>(bytes.size()));
+    value.append(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+  }
+
+  try {
+    localStore_->put(
+        KeySpace::TreeFetchLogFamily,
+        folly::ByteRange{folly::StringPiece{root}},
+        folly::ByteRange{folly::StringPiece{value}});
+  } catch (const std::exception& ex) {
+    XLOG(DBG2) << "failed to write tree fetch log for " << root << ": "
+               << folly::exceptionStr(ex);
+  }
 }
 
 folly::SemiFuture<BackingStore::GetBlobResult> HgQueuedBackingStore::getBlob(
@@ -511,7 +901,10 @@ HgQueuedBackingStore::getBlobImpl(
         proxyHash,
         context->getPriority(),
         context->getCause(),
-        context->getClientPid());
+        context->getClientPid(),
+        deriveImportDeadline(context, AdaptiveImportDeadlines::Operation::Blob),
+        copyMountId(context->getMountId()),
+        context->getCancellationToken());
     auto unique = request->getUnique();
 
     auto importTracker =
@@ -598,7 +991,11 @@ HgQueuedBackingStore::getBlobMetadataImpl(
         proxyHash,
         context->getPriority(),
         context->getCause(),
-        context->getClientPid());
+        context->getClientPid(),
+        deriveImportDeadline(
+            context, AdaptiveImportDeadlines::Operation::BlobMeta),
+        copyMountId(context->getMountId()),
+        context->getCancellationToken());
     auto unique = request->getUnique();
 
     auto importTracker =
@@ -641,6 +1038,9 @@ ImmediateFuture<BackingStore::GetRootTreeResult>
 HgQueuedBackingStore::getRootTree(
     const RootId& rootId,
     const ObjectFetchContextPtr& context) {
+  if (config_ && config_->getEdenConfig()->hgTreeFetchLog.getValue()) {
+    rotateTreeFetchLog(rootId);
+  }
   return backingStore_->getRootTree(rootId, context);
 }
 
@@ -742,6 +1142,20 @@ size_t HgQueuedBackingStore::getImportMetric(
       metric, getImportWatches(stage, object));
 }
 
+size_t HgQueuedBackingStore::getPendingImportCount() const {
+  size_t count = 0;
+  for (auto object :
+       {HgBackingStore::HgImportObject::BLOB,
+        HgBackingStore::HgImportObject::TREE,
+        HgBackingStore::HgImportObject::BLOBMETA}) {
+    count += getImportMetric(
+        RequestMetricsScope::RequestStage::PENDING,
+        object,
+        RequestMetricsScope::RequestMetric::COUNT);
+  }
+  return count;
+}
+
 RequestMetricsScope::LockedRequestWatchList&
 HgQueuedBackingStore::getImportWatches(
     RequestMetricsScope::RequestStage stage,
@@ -801,6 +1215,21 @@ folly::SemiFuture<folly::Unit> HgQueuedBackingStore::importManifestForRoot(
 }
 
 void HgQueuedBackingStore::periodicManagementTask() {
+  if (config_ && config_->getEdenConfig()->hgTreeFetchLog.getValue()) {
+    // Persist the trees recorded so far under the active root, so the log
+    // survives a restart that never rotates to a different root.
+    std::optional<std::string> root;
+    folly::F14FastSet<ObjectId> ids;
+    {
+      auto log = treeFetchLog_.rlock();
+      root = log->root;
+      ids = log->ids;
+    }
+    if (root.has_value() && !ids.empty()) {
+      writeTreeFetchLog(*root, ids);
+    }
+  }
+
   backingStore_->periodicManagementTask();
 }
 
@@ -9,15 +9,23 @@
 
 #include <folly/Range.h>
 #include <folly/Synchronized.h>
+#include <folly/container/F14Map.h>
+#include <folly/container/F14Set.h>
 #include <sys/types.h>
+#include <array>
 #include <atomic>
+#include <chrono>
+#include <map>
 #include <memory>
+#include <optional>
+#include <string>
 #include <vector>
 
 #include "eden/fs/model/Hash.h"
 #include "eden/fs/store/BackingStore.h"
 #include "eden/fs/store/ImportPriority.h"
 #include "eden/fs/store/ObjectFetchContext.h"
+#include "eden/fs/store/hg/AdaptiveImportDeadlines.h"
 #include "eden/fs/store/hg/HgBackingStore.h"
 #include "eden/fs/store/hg/HgImportRequestQueue.h"
 #include "eden/fs/telemetry/ActivityBuffer.h"
@@ -36,7 +44,13 @@ class StructuredLogger;
 
 struct HgImportTraceEvent : TraceEventBase {
   enum EventType : uint8_t {
+    // In pipeline order. A request that is never deduplicated goes through
+    // QUEUE, DEQUEUE, START and FINISH; a deduplicated requester only sees
+    // QUEUE, DEDUP and FINISH under its own `unique` since the work itself
+    // is carried by the request it was attached to.
     QUEUE,
+    DEDUP,
+    DEQUEUE,
     START,
     FINISH,
   };
@@ -58,6 +72,28 @@ struct HgImportTraceEvent : TraceEventBase {
         unique, QUEUE, resourceType, proxyHash, priority, cause, pid};
   }
 
+  static HgImportTraceEvent dedup(
+      uint64_t unique,
+      ResourceType resourceType,
+      const HgProxyHash& proxyHash,
+      ImportPriority::Class priority,
+      ObjectFetchContext::Cause cause,
+      OptionalProcessId pid) {
+    return HgImportTraceEvent{
+        unique, DEDUP, resourceType, proxyHash, priority, cause, pid};
+  }
+
+  static HgImportTraceEvent dequeue(
+      uint64_t unique,
+      ResourceType resourceType,
+      const HgProxyHash& proxyHash,
+      ImportPriority::Class priority,
+      ObjectFetchContext::Cause cause,
+      OptionalProcessId pid) {
+    return HgImportTraceEvent{
+        unique, DEQUEUE, resourceType, proxyHash, priority, cause, pid};
+  }
+
   static HgImportTraceEvent start(
       uint64_t unique,
       ResourceType resourceType,
@@ -110,6 +146,43 @@ struct HgImportTraceEvent : TraceEventBase {
   OptionalProcessId pid;
 };
 
+/**
+ * Aggregate dwell times for the imports of one priority class, derived from
+ * the HgImportTraceEvent stream. Used to tell a slow store apart from a bad
+ * queueing policy: a regression in queueDwell with a steady execution stage
+ * points at the queue, and vice versa.
+ */
+struct HgImportDwellStats {
+  /**
+   * Durations observed for one pipeline stage. The histogram uses
+   * logarithmic buckets: <1ms, <10ms, <100ms, <1s, <10s and >=10s.
+   */
+  struct Stage {
+    static constexpr size_t kNumBuckets = 6;
+
+    uint64_t count = 0;
+    uint64_t totalDurationUs = 0;
+    uint64_t maxDurationUs = 0;
+    std::array<uint64_t, kNumBuckets> histogram{};
+
+    void addSample(std::chrono::microseconds duration);
+  };
+
+  /** Time between a request being enqueued and a worker dequeuing it. */
+  Stage queueDwell;
+  /** Time between dispatch to the store and the import completing. */
+  Stage execution;
+  /** End-to-end time between enqueue and completion. */
+  Stage total;
+  /**
+   * Requests that were attached to an identical in-flight request instead
+   * of being queued. These only contribute to the `total` stage; the queue
+   * and execution stages are accounted to the request that carried the
+   * actual import.
+   */
+  uint64_t deduplicated = 0;
+};
+
 /**
  * An Hg backing store implementation that will put incoming blob/tree import
  * requests into a job queue, then a pool of workers will work on fulfilling
@@ -136,6 +209,15 @@ class HgQueuedBackingStore final : public BackingStore {
     return *traceBus_;
   }
 
+  /**
+   * Returns a snapshot of the per-priority-class dwell-time aggregates.
+   *
+   * The aggregates are maintained by a TraceBus subscriber, so events
+   * published by an import that just completed may not be reflected yet.
+   */
+  std::map<ImportPriority::Class, HgImportDwellStats> getImportDwellStats()
+      const;
+
   ObjectComparison compareObjectsById(const ObjectId& one, const ObjectId& two)
       override;
 
@@ -188,6 +270,8 @@ class HgQueuedBackingStore final : public BackingStore {
       HgBackingStore::HgImportObject object,
       RequestMetricsScope::RequestMetric metric) const;
 
+  size_t getPendingImportCount() const override;
+
   void startRecordingFetch() override;
   std::unordered_set<std::string> stopRecordingFetch() override;
 
@@ -225,6 +309,16 @@ class HgQueuedBackingStore final : public BackingStore {
    */
   void processRequest();
 
+  /**
+   * The deadline to attach to a new import request: the context's own
+   * deadline when it has one, tightened by the adaptively derived deadline
+   * for the operation class when hg:adaptive-import-deadlines is enabled.
+   * See AdaptiveImportDeadlines.
+   */
+  std::optional<std::chrono::steady_clock::time_point> deriveImportDeadline(
+      const ObjectFetchContextPtr& context,
+      AdaptiveImportDeadlines::Operation operation);
+
   void logMissingProxyHash();
 
   /**
@@ -269,6 +363,72 @@ class HgQueuedBackingStore final : public BackingStore {
       const HgProxyHash& proxyHash,
       const ObjectFetchContextPtr& context);
 
+  /**
+   * Race `treeFuture` against a second fetch of the same tree issued
+   * directly against the datapack store after `delay`, returning whichever
+   * response arrives first.
+   *
+   * The hedge bypasses the import queue, so it cannot collapse with the
+   * original request and genuinely runs on a second connection; concurrent
+   * callers still deduplicate against the queued request as usual. The
+   * losing fetch is left to finish in the background and its result is
+   * discarded.
+   */
+  folly::SemiFuture<GetTreeResult> hedgeTreeImport(
+      folly::Future<GetTreeResult> treeFuture,
+      const ObjectId& id,
+      const HgProxyHash& proxyHash,
+      const ObjectFetchContextPtr& context,
+      std::chrono::nanoseconds delay);
+
+  /**
+   * Warm the LocalStore for the proxy hashes of a freshly imported tree's
+   * entries.
+   *
+   * Entries of a tree are overwhelmingly likely to be fetched right after
+   * their parent, and their proxy hashes were written together in the same
+   * WriteBatch, so a single batched read brings all of them into the RocksDB
+   * block cache ahead of the point lookups that HgProxyHash::load will
+   * issue. Only entries using the legacy object ID format are considered;
+   * embedded proxy hashes are decoded in place and need no warming. This is
+   * purely speculative: errors are swallowed and nothing waits on the
+   * result.
+   */
+  void prefetchTreeProxyHashes(const TreePtr& tree);
+
+  /**
+   * Record that a tree was imported from the server while the current
+   * checkout root was active. No-op unless hg:tree-fetch-log is enabled or
+   * before the first getRootTree call of this session.
+   */
+  void recordTreeFetch(const ObjectId& id);
+
+  /**
+   * Make `rootId` the active root of the tree fetch log.
+   *
+   * Flushes the trees recorded under the previous root to the
+   * TreeFetchLogFamily of the LocalStore, then replays the log stored for
+   * `rootId` (if any) by enqueuing low-priority imports for the listed
+   * trees. Called from getRootTree, which both mounting and checking out go
+   * through.
+   */
+  void rotateTreeFetchLog(const RootId& rootId);
+
+  /**
+   * Enqueue low-priority tree imports for every tree recorded under
+   * `rootId` in a previous session. Failures are logged and swallowed;
+   * nothing waits on the imports.
+   */
+  void warmTreeFetchLog(const RootId& rootId);
+
+  /**
+   * Serialize `ids` and store them in the TreeFetchLogFamily under `root`.
+   * Write failures are logged and swallowed.
+   */
+  void writeTreeFetchLog(
+      const std::string& root,
+      const folly::F14FastSet<ObjectId>& ids);
+
   /**
    * Logs a backing store fetch to scuba if the path being fetched is in the
    * configured paths to log. The path is derived from the proxy hash.
@@ -327,6 +487,13 @@ class HgQueuedBackingStore final : public BackingStore {
    */
   HgImportRequestQueue queue_;
 
+  /**
+   * Rolling fetch latency baselines, one per operation class, from which
+   * deadlines for new imports are derived when
+   * hg:adaptive-import-deadlines is enabled.
+   */
+  AdaptiveImportDeadlines importDeadlines_;
+
   /**
    * The worker thread pool. These threads will be running `processRequest`
    * forever to process incoming import requests
@@ -345,6 +512,18 @@ class HgQueuedBackingStore final : public BackingStore {
   folly::Synchronized<std::chrono::steady_clock::time_point>
       lastMissingProxyHashLog_;
 
+  /**
+   * Trees imported from the server since the active checkout root was last
+   * rotated. `root` is the rendered RootId the entries belong to; it is
+   * nullopt until the first getRootTree call. Flushed to the LocalStore by
+   * rotateTreeFetchLog and periodicManagementTask.
+   */
+  struct TreeFetchLog {
+    std::optional<std::string> root;
+    folly::F14FastSet<ObjectId> ids;
+  };
+  folly::Synchronized<TreeFetchLog> treeFetchLog_;
+
   // Track metrics for queued imports
   mutable RequestMetricsScope::LockedRequestWatchList pendingImportBlobWatches_;
   mutable RequestMetricsScope::LockedRequestWatchList
@@ -355,12 +534,37 @@ class HgQueuedBackingStore final : public BackingStore {
 
   ActivityBuffer<HgImportTraceEvent> activityBuffer_;
 
+  /**
+   * Folds one trace event into dwellState_. Runs on the TraceBus background
+   * thread.
+   */
+  void recordDwellEvent(const HgImportTraceEvent& event);
+
+  /**
+   * Correlates QUEUE/DEDUP/DEQUEUE/START/FINISH events by their `unique` to
+   * compute per-stage dwell times. Every QUEUE is paired with a FINISH (the
+   * import futures publish FINISH from an ensure() block), so `pending` is
+   * bounded by the number of outstanding imports.
+   */
+  struct DwellState {
+    struct PendingImport {
+      std::chrono::steady_clock::time_point queueTime;
+      std::optional<std::chrono::steady_clock::time_point> startTime;
+    };
+    folly::F14FastMap<uint64_t, PendingImport> pending;
+    std::map<ImportPriority::Class, HgImportDwellStats> byPriority;
+  };
+  folly::Synchronized<DwellState> dwellState_;
+
   // The traceBus_ and hgTraceHandle_ should be last so any internal subscribers
   // can capture [this].
   std::shared_ptr<TraceBus<HgImportTraceEvent>> traceBus_;
 
   // Handle for TraceBus subscription.
   TraceSubscriptionHandle<HgImportTraceEvent> hgTraceHandle_;
+
+  // Handle for the dwell-time aggregation subscription.
+  TraceSubscriptionHandle<HgImportTraceEvent> dwellStatsHandle_;
 };
 
 } // namespace facebook::eden
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/store/hg/AdaptiveImportDeadlines.h"
+
+#include <folly/portability/GTest.h>
+
+using namespace facebook::eden;
+using namespace std::chrono_literals;
+
+using Operation = AdaptiveImportDeadlines::Operation;
+
+namespace {
+
+void recordMany(
+    AdaptiveImportDeadlines& deadlines,
+    Operation operation,
+    std::chrono::microseconds latency,
+    uint64_t count) {
+  for (uint64_t i = 0; i < count; ++i) {
+    deadlines.recordLatency(operation, latency);
+  }
+}
+
+} // namespace
+
+TEST(AdaptiveImportDeadlinesTest, noDeadlineUntilEnoughSamples) {
+  AdaptiveImportDeadlines deadlines;
+
+  EXPECT_FALSE(deadlines.deriveDeadline(Operation::Blob, 1s, 60s).has_value());
+
+  recordMany(
+      deadlines,
+      Operation::Blob,
+      10ms,
+      AdaptiveImportDeadlines::kMinimumSamples - 1);
+  EXPECT_FALSE(deadlines.deriveDeadline(Operation::Blob, 1s, 60s).has_value());
+
+  deadlines.recordLatency(Operation::Blob, 10ms);
+  EXPECT_TRUE(deadlines.deriveDeadline(Operation::Blob, 1s, 60s).has_value());
+
+  // Baselines are tracked per operation class.
+  EXPECT_FALSE(deadlines.deriveDeadline(Operation::Tree, 1s, 60s).has_value());
+}
+
+TEST(AdaptiveImportDeadlinesTest, budgetScalesWithBaseline) {
+  AdaptiveImportDeadlines deadlines;
+
+  recordMany(deadlines, Operation::Blob, 100ms, 1000);
+
+  auto before = std::chrono::steady_clock::now();
+  auto deadline = deadlines.deriveDeadline(Operation::Blob, 1s, 60s);
+  auto after = std::chrono::steady_clock::now();
+  ASSERT_TRUE(deadline.has_value());
+
+  // The p99 estimate for a 100ms baseline is the enclosing power-of-two
+  // bucket's upper bound (~131ms); the budget is kBudgetMultiplier times
+  // that, well inside the one second floor and sixty second ceiling.
+  EXPECT_GE(*deadline, before + 2s);
+  EXPECT_LE(*deadline, after + 4s);
+}
+
+TEST(AdaptiveImportDeadlinesTest, budgetIsClamped) {
+  AdaptiveImportDeadlines deadlines;
+
+  // A sub-millisecond baseline (everything in the hgcache) clamps to the
+  // floor, so normal queueing delay cannot trip the deadline.
+  recordMany(deadlines, Operation::Blob, 100us, 1000);
+  auto before = std::chrono::steady_clock::now();
+  auto deadline = deadlines.deriveDeadline(Operation::Blob, 5s, 60s);
+  auto after = std::chrono::steady_clock::now();
+  ASSERT_TRUE(deadline.has_value());
+  EXPECT_GE(*deadline, before + 5s);
+  EXPECT_LE(*deadline, after + 5s);
+
+  // A pathologically slow baseline clamps to the ceiling instead of
+  // reproducing the multi-minute hangs the deadlines exist to prevent.
+  recordMany(deadlines, Operation::Tree, 10s, 1000);
+  before = std::chrono::steady_clock::now();
+  deadline = deadlines.deriveDeadline(Operation::Tree, 5s, 60s);
+  after = std::chrono::steady_clock::now();
+  ASSERT_TRUE(deadline.has_value());
+  EXPECT_GE(*deadline, before + 60s);
+  EXPECT_LE(*deadline, after + 60s);
+}
@@ -5,11 +5,13 @@
  * GNU General Public License version 2.
  */
 
+#include <folly/CancellationToken.h>
 #include <folly/Try.h>
 #include <folly/logging/xlog.h>
 #include <folly/portability/GTest.h>
 #include <array>
 #include <memory>
+#include <thread>
 
 #include "eden/fs/config/ReloadableConfig.h"
 #include "eden/fs/model/Hash.h"
@@ -586,3 +588,292 @@ TEST_F(HgImportRequestQueueTest, twoDuplicateRequestsDifferentPriority) {
         request->getRequest<HgImportRequest::BlobImport>()->hash, expBlob);
   }
 }
+
+TEST_F(HgImportRequestQueueTest, batchWindowWaitsForFullBatch) {
+  rawEdenConfig->importBatchSize.setValue(2, ConfigSourceType::UserConfig, true);
+  rawEdenConfig->importBatchWindow.setValue(
+      std::chrono::seconds{10}, ConfigSourceType::UserConfig, true);
+  auto queue = HgImportRequestQueue{edenConfig};
+
+  auto hash1 = insertBlobImportRequest(
+      queue, ImportPriority(ImportPriority::Class::Normal, 5));
+
+  // The dequeuing thread sees a batch of 1 and waits out the batch window;
+  // the second enqueue wakes it up with a full batch.
+  std::thread enqueuer([&] {
+    /* sleep override */
+    std::this_thread::sleep_for(std::chrono::milliseconds{10});
+    insertBlobImportRequest(
+        queue, ImportPriority(ImportPriority::Class::Normal, 5));
+  });
+
+  auto dequeued = queue.dequeue();
+  enqueuer.join();
+  EXPECT_EQ(2, dequeued.size());
+  EXPECT_EQ(
+      hash1, dequeued.at(0)->getRequest<HgImportRequest::BlobImport>()->hash);
+
+  for (auto& request : dequeued) {
+    auto blob = folly::makeTryWith(
+        [] { return std::make_shared<BlobPtr::element_type>(folly::IOBuf{}); });
+    queue.markImportAsFinished<BlobPtr::element_type>(
+        request->getRequest<HgImportRequest::BlobImport>()->hash, blob);
+  }
+}
+
+TEST_F(HgImportRequestQueueTest, noBatchWindowDispatchesImmediately) {
+  rawEdenConfig->importBatchSize.setValue(2, ConfigSourceType::UserConfig, true);
+  auto queue = HgImportRequestQueue{edenConfig};
+
+  insertBlobImportRequest(
+      queue, ImportPriority(ImportPriority::Class::Normal, 5));
+
+  // With the default window of 0, a partial batch is dispatched right away.
+  auto dequeued = queue.dequeue();
+  EXPECT_EQ(1, dequeued.size());
+
+  auto blob = folly::makeTryWith(
+      [] { return std::make_shared<BlobPtr::element_type>(folly::IOBuf{}); });
+  queue.markImportAsFinished<BlobPtr::element_type>(
+      dequeued.at(0)->getRequest<HgImportRequest::BlobImport>()->hash, blob);
+}
+
+TEST_F(HgImportRequestQueueTest, deadlineOrdersEqualPriorityRequests) {
+  auto queue = HgImportRequestQueue{edenConfig};
+
+  auto noDeadlineHash = insertBlobImportRequest(
+      queue, ImportPriority(ImportPriority::Class::Normal, 5));
+
+  auto hgRevHash = uniqueHash();
+  auto proxyHash = HgProxyHash{RelativePath{"some_blob"}, hgRevHash};
+  auto deadlineHash = ObjectId{proxyHash.getValue()};
+  queue.enqueueBlob(HgImportRequest::makeBlobImportRequest(
+      deadlineHash,
+      proxyHash,
+      ImportPriority(ImportPriority::Class::Normal, 5),
+      ObjectFetchContext::Cause::Unknown,
+      std::nullopt,
+      std::chrono::steady_clock::now() + std::chrono::minutes{10}));
+
+  // Despite being enqueued last, the request with a deadline is dispatched
+  // ahead of the equal-priority request without one.
+  for (auto& expected : {deadlineHash, noDeadlineHash}) {
+    auto request = queue.dequeue().at(0);
+    EXPECT_EQ(
+        expected, request->getRequest<HgImportRequest::BlobImport>()->hash);
+
+    auto blob = folly::makeTryWith(
+        [] { return std::make_shared<BlobPtr::element_type>(folly::IOBuf{}); });
+    queue.markImportAsFinished<BlobPtr::element_type>(
+        request->getRequest<HgImportRequest::BlobImport>()->hash, blob);
+  }
+}
+
+TEST_F(HgImportRequestQueueTest, duplicateRequestInheritsDeadline) {
+  auto queue = HgImportRequestQueue{edenConfig};
+
+  auto otherHash = insertBlobImportRequest(
+      queue, ImportPriority(ImportPriority::Class::Normal, 5));
+
+  auto hgRevHash = uniqueHash();
+  auto proxyHash = HgProxyHash{RelativePath{"some_blob"}, hgRevHash};
+  auto [sharedHash, noDeadlineRequest] = makeBlobImportRequestWithHash(
+      ImportPriority(ImportPriority::Class::Normal, 5), proxyHash);
+  queue.enqueueBlob(std::move(noDeadlineRequest));
+
+  // A deduplicated request with a deadline tightens the queued request's
+  // deadline, moving it ahead of other equal-priority traffic.
+  queue.enqueueBlob(HgImportRequest::makeBlobImportRequest(
+      sharedHash,
+      proxyHash,
+      ImportPriority(ImportPriority::Class::Normal, 5),
+      ObjectFetchContext::Cause::Unknown,
+      std::nullopt,
+      std::chrono::steady_clock::now() + std::chrono::minutes{10}));
+
+  for (auto& expected : {sharedHash, otherHash}) {
+    auto request = queue.dequeue().at(0);
+    EXPECT_EQ(
+        expected, request->getRequest<HgImportRequest::BlobImport>()->hash);
+
+    auto blob = folly::makeTryWith(
+        [] { return std::make_shared<BlobPtr::element_type>(folly::IOBuf{}); });
+    queue.markImportAsFinished<BlobPtr::element_type>(
+        request->getRequest<HgImportRequest::BlobImport>()->hash, blob);
+  }
+}
+
+namespace {
+ObjectId insertBlobImportRequestForMount(
+    HgImportRequestQueue& queue,
+    ImportPriority priority,
+    std::string mountId) {
+  auto hgRevHash = uniqueHash();
+  auto proxyHash = HgProxyHash{RelativePath{"some_blob"}, hgRevHash};
+  auto hash = ObjectId{proxyHash.getValue()};
+  queue.enqueueBlob(HgImportRequest::makeBlobImportRequest(
+      hash,
+      std::move(proxyHash),
+      priority,
+      ObjectFetchContext::Cause::Unknown,
+      std::nullopt,
+      std::nullopt,
+      std::move(mountId)));
+  return hash;
+}
+
+void finishBlobRequest(
+    HgImportRequestQueue& queue,
+    const std::shared_ptr<HgImportRequest>& request) {
+  auto blob = folly::makeTryWith(
+      [] { return std::make_shared<BlobPtr::element_type>(folly::IOBuf{}); });
+  queue.markImportAsFinished<BlobPtr::element_type>(
+      request->getRequest<HgImportRequest::BlobImport>()->hash, blob);
+}
+} // namespace
+
+TEST_F(HgImportRequestQueueTest, perMountInflightLimit) {
+  rawEdenConfig->maxInflightImportRequestsPerMount.setValue(
+      1, ConfigSourceType::UserConfig, true);
+  auto queue = HgImportRequestQueue{edenConfig};
+
+  auto mountAFirst = insertBlobImportRequestForMount(
+      queue, ImportPriority(ImportPriority::Class::Normal, 5), "/mnt/a");
+  auto mountASecond = insertBlobImportRequestForMount(
+      queue, ImportPriority(ImportPriority::Class::Normal, 4), "/mnt/a");
+  auto mountB = insertBlobImportRequestForMount(
+      queue, ImportPriority(ImportPriority::Class::Normal, 3), "/mnt/b");
+
+  auto first = queue.dequeue().at(0);
+  EXPECT_EQ(
+      mountAFirst, first->getRequest<HgImportRequest::BlobImport>()->hash);
+
+  // Mount A is at its in-flight limit, so its higher-priority second request
+  // is passed over in favor of mount B's request.
+  auto second = queue.dequeue().at(0);
+  EXPECT_EQ(mountB, second->getRequest<HgImportRequest::BlobImport>()->hash);
+
+  // Finishing mount A's import frees up its slot.
+  finishBlobRequest(queue, first);
+  auto third = queue.dequeue().at(0);
+  EXPECT_EQ(
+      mountASecond, third->getRequest<HgImportRequest::BlobImport>()->hash);
+
+  finishBlobRequest(queue, second);
+  finishBlobRequest(queue, third);
+}
+
+TEST_F(HgImportRequestQueueTest, abandonedRequestIsDroppedAtDequeue) {
+  auto queue = HgImportRequestQueue{edenConfig};
+
+  folly::CancellationSource cancellation;
+  auto hgRevHash = uniqueHash();
+  auto proxyHash = HgProxyHash{RelativePath{"some_blob"}, hgRevHash};
+  auto cancelledHash = ObjectId{proxyHash.getValue()};
+  auto cancelledFuture =
+      queue.enqueueBlob(HgImportRequest::makeBlobImportRequest(
+          cancelledHash,
+          proxyHash,
+          ImportPriority(ImportPriority::Class::Normal, 6),
+          ObjectFetchContext::Cause::Unknown,
+          std::nullopt,
+          std::nullopt,
+          std::nullopt,
+          cancellation.getToken()));
+
+  auto liveHash = insertBlobImportRequest(
+      queue, ImportPriority(ImportPriority::Class::Normal, 5));
+
+  // The requester goes away before a worker picks the request up: the queue
+  // drops it instead of dispatching it and fails its promise.
+  cancellation.requestCancellation();
+
+  auto request = queue.dequeue().at(0);
+  EXPECT_EQ(liveHash, request->getRequest<HgImportRequest::BlobImport>()->hash);
+  ASSERT_TRUE(cancelledFuture.isReady());
+  EXPECT_THROW(std::move(cancelledFuture).get(), folly::OperationCancelled);
+  finishBlobRequest(queue, request);
+
+  // The drop also cleared the de-duplication tracker, so a later request
+  // for the same object is imported afresh.
+  auto [rerequestedHash, rerequested] = makeBlobImportRequestWithHash(
+      ImportPriority(ImportPriority::Class::Normal, 5), proxyHash);
+  auto rerequestedFuture = queue.enqueueBlob(std::move(rerequested));
+  auto retried = queue.dequeue().at(0);
+  EXPECT_EQ(
+      rerequestedHash,
+      retried->getRequest<HgImportRequest::BlobImport>()->hash);
+  finishBlobRequest(queue, retried);
+  EXPECT_NE(nullptr, std::move(rerequestedFuture).get());
+}
+
+TEST_F(HgImportRequestQueueTest, expiredDeadlineFailsAtDequeue) {
+  auto queue = HgImportRequestQueue{edenConfig};
+
+  auto hgRevHash = uniqueHash();
+  auto proxyHash = HgProxyHash{RelativePath{"some_blob"}, hgRevHash};
+  auto expiredHash = ObjectId{proxyHash.getValue()};
+  auto expiredFuture = queue.enqueueBlob(HgImportRequest::makeBlobImportRequest(
+      expiredHash,
+      proxyHash,
+      ImportPriority(ImportPriority::Class::Normal, 6),
+      ObjectFetchContext::Cause::Unknown,
+      std::nullopt,
+      std::chrono::steady_clock::now() - std::chrono::seconds{1}));
+
+  auto liveHash = insertBlobImportRequest(
+      queue, ImportPriority(ImportPriority::Class::Normal, 5));
+
+  // The deadline passed while the request sat in the queue: dequeue fails
+  // it instead of spending a worker slot on a fetch nobody can use.
+  auto request = queue.dequeue().at(0);
+  EXPECT_EQ(liveHash, request->getRequest<HgImportRequest::BlobImport>()->hash);
+  ASSERT_TRUE(expiredFuture.isReady());
+  EXPECT_THROW(std::move(expiredFuture).get(), folly::FutureTimeout);
+  finishBlobRequest(queue, request);
+
+  // The expiry also cleared the de-duplication tracker, so a later request
+  // for the same object is imported afresh.
+  auto [rerequestedHash, rerequested] = makeBlobImportRequestWithHash(
+      ImportPriority(ImportPriority::Class::Normal, 5), proxyHash);
+  auto rerequestedFuture = queue.enqueueBlob(std::move(rerequested));
+  auto retried = queue.dequeue().at(0);
+  EXPECT_EQ(
+      rerequestedHash,
+      retried->getRequest<HgImportRequest::BlobImport>()->hash);
+  finishBlobRequest(queue, retried);
+  EXPECT_NE(nullptr, std::move(rerequestedFuture).get());
+}
+
+TEST_F(HgImportRequestQueueTest, duplicateRequesterKeepsImportAlive) {
+  auto queue = HgImportRequestQueue{edenConfig};
+
+  folly::CancellationSource cancellation;
+  auto hgRevHash = uniqueHash();
+  auto proxyHash = HgProxyHash{RelativePath{"some_blob"}, hgRevHash};
+  auto hash = ObjectId{proxyHash.getValue()};
+  queue.enqueueBlob(HgImportRequest::makeBlobImportRequest(
+      hash,
+      proxyHash,
+      ImportPriority(ImportPriority::Class::Normal, 5),
+      ObjectFetchContext::Cause::Unknown,
+      std::nullopt,
+      std::nullopt,
+      std::nullopt,
+      cancellation.getToken()));
+
+  // A second requester without a real cancellation token deduplicates onto
+  // the queued request.
+  auto [dupHash, duplicate] = makeBlobImportRequestWithHash(
+      ImportPriority(ImportPriority::Class::Normal, 5), proxyHash);
+  auto dupFuture = queue.enqueueBlob(std::move(duplicate));
+
+  // The first requester cancelling must not drop the import; the second
+  // requester is still waiting on it.
+  cancellation.requestCancellation();
+
+  auto request = queue.dequeue().at(0);
+  EXPECT_EQ(hash, request->getRequest<HgImportRequest::BlobImport>()->hash);
+  finishBlobRequest(queue, request);
+  EXPECT_NE(nullptr, std::move(dupFuture).get());
+}
@@ -5,6 +5,7 @@
  * GNU General Public License version 2.
  */
 
+#include <folly/String.h>
 #include <folly/experimental/TestUtil.h>
 #include <folly/futures/Future.h>
 #include <folly/portability/GMock.h>
@@ -89,6 +90,46 @@ TEST_F(HgImportTest, importTest) {
       std::exception);
 }
 
+TEST_F(HgImportTest, pipelinedImportTest) {
+  if (!testEnvironmentSupportsHg()) {
+    GTEST_SKIP();
+  }
+
+  // Set up the initial commit
+  repo_.mkdir("foo");
+  StringPiece barData = "this is a test file\n";
+  RelativePathPiece barPath{"foo/bar.txt"};
+  repo_.writeFile(barPath, barData);
+  StringPiece bazData = "this is another test file\n";
+  RelativePathPiece bazPath{"foo/baz.txt"};
+  repo_.writeFile(bazPath, bazData);
+  repo_.hg("add", "foo");
+  repo_.commit("Initial commit");
+
+  HgImporter importer(repo_.path(), stats_.copy());
+
+  // `hg manifest --debug` prints one "<40 hex digit hash> <mode>   <path>"
+  // line per file, in path order.
+  auto output = repo_.hg("manifest", "--debug");
+  std::vector<StringPiece> lines;
+  folly::split('\n', output, lines);
+  Hash20 barHash{lines.at(0).subpiece(0, 40)};
+  Hash20 bazHash{lines.at(1).subpiece(0, 40)};
+
+  // A failed request in the middle of a batch must not prevent the
+  // responses for the requests after it from being read.
+  std::vector<std::pair<RelativePath, Hash20>> requests;
+  requests.emplace_back(RelativePath{barPath}, barHash);
+  requests.emplace_back(RelativePath{barPath}, makeTestHash20("123"));
+  requests.emplace_back(RelativePath{bazPath}, bazHash);
+
+  auto results = importer.importFileContents(requests);
+  ASSERT_EQ(3, results.size());
+  EXPECT_BLOB_EQ(results.at(0).value(), barData);
+  EXPECT_TRUE(results.at(1).hasException());
+  EXPECT_BLOB_EQ(results.at(2).value(), bazData);
+}
+
 // TODO(T33797958): Check hg_importer_helper's exit code on Windows (in
 // HgImportTest).
 #ifndef _WIN32
@@ -9,6 +9,9 @@
 #include <folly/experimental/TestUtil.h>
 #include <folly/logging/xlog.h>
 #include <folly/portability/GTest.h>
+#include <chrono>
+#include <map>
+#include <thread>
 
 #include "eden/fs/config/EdenConfig.h"
 #include "eden/fs/config/ReloadableConfig.h"
@@ -119,6 +122,55 @@ TEST_F(HgQueuedBackingStoreTest, getBlob) {
   }
 }
 
+TEST_F(HgQueuedBackingStoreTest, importDwellStats) {
+  auto queuedStore = makeQueuedStore();
+  auto tree =
+      queuedStore->getRootTree(commit1, ObjectFetchContext::getNullContext())
+          .get(kTestTimeout);
+
+  for (auto& [name, entry] : *tree.tree) {
+    if (name == "foo.txt") {
+      auto [blob, origin] =
+          queuedStore
+              ->getBlob(entry.getHash(), ObjectFetchContext::getNullContext())
+              .get(kTestTimeout);
+    }
+  }
+
+  // The aggregates are folded in on the TraceBus background thread, so wait
+  // for the blob import's events to be processed.
+  auto deadline = std::chrono::steady_clock::now() + kTestTimeout;
+  std::map<ImportPriority::Class, HgImportDwellStats> stats;
+  while (std::chrono::steady_clock::now() < deadline) {
+    stats = queuedStore->getImportDwellStats();
+    auto it = stats.find(ImportPriority::Class::Normal);
+    if (it != stats.end() && it->second.total.count >= 1 &&
+        it->second.execution.count >= 1) {
+      break;
+    }
+    std::this_thread::sleep_for(1ms);
+  }
+
+  const auto& normal = stats.at(ImportPriority::Class::Normal);
+  EXPECT_GE(normal.total.count, 1ul);
+  EXPECT_GE(normal.queueDwell.count, 1ul);
+  EXPECT_GE(normal.execution.count, 1ul);
+  EXPECT_EQ(normal.deduplicated, 0ul);
+
+  // Every sample lands in exactly one histogram bucket.
+  auto bucketSum = [](const HgImportDwellStats::Stage& stage) {
+    uint64_t sum = 0;
+    for (auto bucket : stage.histogram) {
+      sum += bucket;
+    }
+    return sum;
+  };
+  EXPECT_EQ(bucketSum(normal.total), normal.total.count);
+  EXPECT_EQ(bucketSum(normal.queueDwell), normal.queueDwell.count);
+  EXPECT_EQ(bucketSum(normal.execution), normal.execution.count);
+  EXPECT_LE(normal.queueDwell.maxDurationUs, normal.total.maxDurationUs);
+}
+
 TEST(HgQueuedBackingStore_ObjectId, round_trip_object_IDs) {
   Hash20 testHash{
       folly::StringPiece{"0123456789abcdef0123456789abcdef01234567"}};
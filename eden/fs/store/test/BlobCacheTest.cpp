@@ -95,6 +95,47 @@ TEST(BlobCache, can_forget_cached_entries) {
   EXPECT_FALSE(cache->get(hash4).object);
 }
 
+TEST(
+    BlobCache,
+    capacity_eviction_lands_in_compressed_victim_cache_and_is_retrievable) {
+  auto cache = BlobCache::create(10, 0, 1000, makeRefPtr<EdenStats>());
+  cache->insert(hash3, blob3);
+  cache->insert(hash9, blob9); // evicts blob3 into the victim tier
+
+  EXPECT_EQ(9, cache->getStats().totalSizeInBytes);
+
+  auto result = cache->get(hash3);
+  ASSERT_TRUE(result.object);
+  EXPECT_TRUE(folly::IOBufEqualTo{}(
+      blob3->getContents(), result.object->getContents()))
+      << "decompressed blob must round-trip the original contents";
+
+  // The hit re-promoted blob3 into the uncompressed tier, evicting blob9.
+  EXPECT_EQ(3, cache->getStats().totalSizeInBytes);
+  EXPECT_TRUE(cache->get(hash9).object)
+      << "blob9 should come back from the victim tier in turn";
+}
+
+TEST(BlobCache, dropped_interest_handle_does_not_populate_victim_cache) {
+  auto cache = BlobCache::create(100, 0, 1000, makeRefPtr<EdenStats>());
+  auto handle = cache->insert(
+      hash3,
+      std::make_shared<Blob>("333"_sp),
+      BlobCache::Interest::WantHandle);
+  handle.reset();
+
+  EXPECT_FALSE(cache->get(hash3).object)
+      << "a blob nobody wanted should not get a second chance";
+}
+
+TEST(BlobCache, evicted_blob_is_not_retrievable_without_victim_cache) {
+  auto cache = BlobCache::create(10, 0, makeRefPtr<EdenStats>());
+  cache->insert(hash3, blob3);
+  cache->insert(hash9, blob9); // evicts blob3
+
+  EXPECT_FALSE(cache->get(hash3).object);
+}
+
 TEST(BlobCache, does_not_forget_blob_until_last_handle_is_forgotten) {
   auto cache = BlobCache::create(100, 0, makeRefPtr<EdenStats>());
   auto blob = std::make_shared<Blob>("newblob"_sp);
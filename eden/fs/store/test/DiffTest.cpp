@@ -21,6 +21,7 @@
 #include "eden/fs/store/ObjectStore.h"
 #include "eden/fs/store/ScmStatusDiffCallback.h"
 #include "eden/fs/store/TreeCache.h"
+#include "eden/fs/store/TreeDiffMemoCache.h"
 #include "eden/fs/telemetry/EdenStats.h"
 #include "eden/fs/telemetry/NullStructuredLogger.h"
 #include "eden/fs/testharness/FakeBackingStore.h"
@@ -92,7 +93,8 @@ class DiffTest : public ::testing::Test {
       DiffCallback* callback,
       std::unique_ptr<TopLevelIgnores> topLevelIgnores,
       bool listIgnored = true,
-      CaseSensitivity caseSensitive = kPathMapDefaultCaseSensitive) {
+      CaseSensitivity caseSensitive = kPathMapDefaultCaseSensitive,
+      std::shared_ptr<TreeDiffMemoCache> memoCache = nullptr) {
     return std::make_unique<DiffContext>(
         callback,
         folly::CancellationToken{},
@@ -101,7 +103,8 @@ class DiffTest : public ::testing::Test {
         caseSensitive,
         true,
         store_,
-        std::move(topLevelIgnores));
+        std::move(topLevelIgnores),
+        std::move(memoCache));
   }
 
   Future<ScmStatus> diffCommitsFuture(
@@ -110,12 +113,17 @@ class DiffTest : public ::testing::Test {
       std::string userIgnoreContents = {},
       std::string systemIgnoreContents = {},
       bool listIgnored = true,
-      CaseSensitivity caseSensitive = kPathMapDefaultCaseSensitive) {
+      CaseSensitivity caseSensitive = kPathMapDefaultCaseSensitive,
+      std::shared_ptr<TreeDiffMemoCache> memoCache = nullptr) {
     auto callback = std::make_unique<ScmStatusDiffCallback>();
     auto topLevelIgnores = std::make_unique<TopLevelIgnores>(
         std::move(userIgnoreContents), std::move(systemIgnoreContents));
     auto diffContext = makeDiffContext(
-        callback.get(), std::move(topLevelIgnores), listIgnored, caseSensitive);
+        callback.get(),
+        std::move(topLevelIgnores),
+        listIgnored,
+        caseSensitive,
+        std::move(memoCache));
 
     auto fut = diffTrees(diffContext.get(), RelativePathPiece{}, hash1, hash2);
     return std::move(fut)
@@ -219,6 +227,74 @@ TEST_F(DiffTest, basicDiff) {
           Pair("a/b/1.txt", ScmFileStatus::REMOVED)));
 }
 
+TEST_F(DiffTest, memoCacheRecordsAndReplaysTreePairDiffs) {
+  FakeTreeBuilder builder;
+  builder.setFile("src/foo.c", "foo");
+  builder.finalize(backingStore_, /* setReady */ true);
+  backingStore_->putCommit("1", builder)->setReady();
+
+  auto builder2 = builder.clone();
+  builder2.replaceFile("src/foo.c", "foo v2");
+  builder2.finalize(backingStore_, /* setReady */ true);
+  backingStore_->putCommit("2", builder2)->setReady();
+
+  auto root1 = store_
+                   ->getRootTree(
+                       RootId{"1"}, ObjectFetchContext::getNullContext())
+                   .get(100ms)
+                   .treeId;
+  auto root2 = store_
+                   ->getRootTree(
+                       RootId{"2"}, ObjectFetchContext::getNullContext())
+                   .get(100ms)
+                   .treeId;
+
+  auto memo = std::make_shared<TreeDiffMemoCache>(16);
+  auto result =
+      diffCommitsFuture(
+          root1, root2, {}, {}, true, kPathMapDefaultCaseSensitive, memo)
+          .get(100ms);
+  EXPECT_THAT(
+      *result.entries_ref(),
+      UnorderedElementsAre(Pair("src/foo.c", ScmFileStatus::MODIFIED)));
+
+  // The finished walk should have been memoized for the root pair.
+  EXPECT_NE(nullptr, memo->get(root1, root2));
+
+  // Replace the memoized result so a second diff of the same pair proves
+  // whether the memo is replayed instead of the trees being re-walked.
+  auto injected = std::make_shared<std::vector<TreeDiffMemoCache::Entry>>();
+  injected->push_back(TreeDiffMemoCache::Entry{
+      RelativePath{"injected.txt"},
+      TreeDiffMemoCache::ChangeType::Added,
+      dtype_t::Regular});
+  memo->put(root1, root2, std::move(injected));
+
+  auto replayed =
+      diffCommitsFuture(
+          root1, root2, {}, {}, true, kPathMapDefaultCaseSensitive, memo)
+          .get(100ms);
+  EXPECT_THAT(
+      *replayed.entries_ref(),
+      UnorderedElementsAre(Pair("injected.txt", ScmFileStatus::ADDED)));
+}
+
+TEST_F(DiffTest, diffWithoutMemoCacheIsUnaffected) {
+  FakeTreeBuilder builder;
+  builder.setFile("src/foo.c", "foo");
+  builder.finalize(backingStore_, /* setReady */ true);
+  backingStore_->putCommit("1", builder)->setReady();
+
+  auto builder2 = builder.clone();
+  builder2.replaceFile("src/foo.c", "foo v2");
+  builder2.finalize(backingStore_, /* setReady */ true);
+  backingStore_->putCommit("2", builder2)->setReady();
+
+  auto first = diffCommits("1", "2").get(100ms);
+  auto second = diffCommits("1", "2").get(100ms);
+  EXPECT_EQ(*first.entries_ref(), *second.entries_ref());
+}
+
 TEST_F(DiffTest, directoryOrdering) {
   FakeTreeBuilder builder;
 
@@ -368,6 +368,41 @@ TEST_F(FakeFilteredBackingStoreTest, getTree) {
   EXPECT_EQ(treeOID, std::move(future5).get(0ms).tree->getHash());
 }
 
+TEST_F(FakeFilteredBackingStoreTest, getTreeMemoized) {
+  // Populate some files and a root tree in the store
+  auto foo_id = makeTestHash("f00");
+  (void)wrappedStore_->putBlob(foo_id, "this is foo\n");
+  auto [bar, bar_id] = wrappedStore_->putBlob("barbarbarbar\n");
+
+  auto rootHash = makeTestHash("10101010");
+  auto treeHash = FilteredObjectId(RelativePath{""}, kTestFilter1, rootHash);
+  auto treeOID = ObjectId{treeHash.getValue()};
+  auto* rootDir = wrappedStore_->putTree(
+      rootHash,
+      {
+          {"bar", bar_id},
+          // "foo" will be filtered once the filter is applied
+          {"foo", foo_id, FakeBlobType::REGULAR_FILE},
+      });
+
+  auto future1 =
+      filteredStore_->getTree(treeOID, ObjectFetchContext::getNullContext());
+  EXPECT_FALSE(future1.isReady());
+  rootDir->trigger();
+  auto result1 = std::move(future1).get(0ms);
+  EXPECT_EQ(1, result1.tree->size());
+
+  // The same filtered tree should now be served from the memoization cache
+  // without hitting the wrapped store: the future is ready without a
+  // trigger() call.
+  auto future2 =
+      filteredStore_->getTree(treeOID, ObjectFetchContext::getNullContext());
+  auto result2 = std::move(future2).get(0ms);
+  EXPECT_EQ(ObjectFetchContext::Origin::FromMemoryCache, result2.origin);
+  EXPECT_EQ(result1.tree->getHash(), result2.tree->getHash());
+  EXPECT_EQ(result1.tree->size(), result2.tree->size());
+}
+
 TEST_F(FakeFilteredBackingStoreTest, getRootTree) {
   // Set up one commit with a root tree
   auto dir1Hash = makeTestHash("abc");
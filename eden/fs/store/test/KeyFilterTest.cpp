@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/store/KeyFilter.h"
+
+#include <folly/portability/GTest.h>
+
+namespace {
+
+using namespace facebook::eden;
+using namespace folly::string_piece_literals;
+
+TEST(KeyFilterTest, disabledFilterAlwaysMightContain) {
+  KeyFilter filter;
+  EXPECT_FALSE(filter.enabled());
+  EXPECT_TRUE(filter.mightContain("key"_sp));
+
+  filter.reset(/*enabled=*/false);
+  EXPECT_FALSE(filter.enabled());
+  EXPECT_TRUE(filter.mightContain("key"_sp));
+
+  // add() on a disabled filter is a no-op.
+  filter.add("key"_sp);
+  EXPECT_TRUE(filter.mightContain("other"_sp));
+}
+
+TEST(KeyFilterTest, enabledFilterTracksAddedKeys) {
+  KeyFilter filter;
+  filter.reset(/*enabled=*/true);
+  EXPECT_TRUE(filter.enabled());
+  EXPECT_FALSE(filter.mightContain("key"_sp));
+
+  filter.add("key"_sp);
+  EXPECT_TRUE(filter.mightContain("key"_sp));
+  EXPECT_FALSE(filter.mightContain("otherkey"_sp));
+}
+
+TEST(KeyFilterTest, resetClearsState) {
+  KeyFilter filter;
+  filter.reset(/*enabled=*/true);
+  filter.add("key"_sp);
+
+  filter.reset(/*enabled=*/true);
+  EXPECT_FALSE(filter.mightContain("key"_sp));
+
+  filter.add("key"_sp);
+  filter.reset(/*enabled=*/false);
+  EXPECT_FALSE(filter.enabled());
+  EXPECT_TRUE(filter.mightContain("key"_sp));
+}
+
+TEST(KeyFilterTest, neverProducesFalseNegatives) {
+  KeyFilter filter;
+  filter.reset(/*enabled=*/true);
+  std::vector<std::string> keys;
+  for (int i = 0; i < 1000; ++i) {
+    keys.push_back("key" + std::to_string(i));
+    filter.add(folly::StringPiece{keys.back()});
+  }
+  for (const auto& key : keys) {
+    EXPECT_TRUE(filter.mightContain(folly::StringPiece{key}));
+  }
+}
+
+} // namespace
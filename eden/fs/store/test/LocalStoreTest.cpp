@@ -259,6 +259,27 @@ TEST_P(LocalStoreTest, testMultipleBlobWriters) {
   EXPECT_EQ("hello world1_4", result1_4.piece());
 }
 
+TEST_P(LocalStoreTest, testGetBatch) {
+  store_->put(KeySpace::BlobFamily, "key1"_sp, "blob1"_sp);
+  store_->put(KeySpace::BlobFamily, "key2"_sp, "blob2"_sp);
+  store_->put(KeySpace::BlobFamily, "key3"_sp, "blob3"_sp);
+
+  // Results must come back in request order, even though the keys are
+  // handed over unsorted and some of them are missing.
+  std::vector<folly::ByteRange> keys = {
+      folly::ByteRange{"key3"_sp},
+      folly::ByteRange{"missing"_sp},
+      folly::ByteRange{"key1"_sp},
+      folly::ByteRange{"key2"_sp},
+  };
+  auto results = store_->getBatch(KeySpace::BlobFamily, keys).get();
+  ASSERT_EQ(4, results.size());
+  EXPECT_EQ("blob3", results[0].piece());
+  EXPECT_FALSE(results[1].isValid());
+  EXPECT_EQ("blob1", results[2].piece());
+  EXPECT_EQ("blob2", results[3].piece());
+}
+
 TEST_P(LocalStoreTest, testClearKeySpace) {
   store_->put(KeySpace::BlobFamily, "key1"_sp, "blob1"_sp);
   store_->put(KeySpace::BlobFamily, "key2"_sp, "blob2"_sp);
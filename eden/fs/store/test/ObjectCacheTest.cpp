@@ -6,6 +6,7 @@
  */
 
 #include "eden/fs/store/ObjectCache.h"
+#include <folly/executors/ManualExecutor.h>
 #include <folly/portability/GTest.h>
 
 using namespace folly::literals;
@@ -66,6 +67,96 @@ const auto object11 = std::make_shared<CacheObject>(hash11, 11);
  * simple non-interest-handle test cases
  */
 
+TEST(ObjectCache, testShardedInsertAndGet) {
+  // A generous per-shard budget so nothing is evicted in this test.
+  auto cache =
+      ObjectCache<CacheObject, ObjectCacheFlavor::Simple>::create(1000, 1, 4);
+
+  cache->insertSimple(object3->getHash(), object3);
+  cache->insertSimple(object4->getHash(), object4);
+  cache->insertSimple(object5->getHash(), object5);
+
+  EXPECT_EQ(object3, cache->getSimple(object3->getHash()));
+  EXPECT_EQ(object4, cache->getSimple(object4->getHash()));
+  EXPECT_EQ(object5, cache->getSimple(object5->getHash()));
+
+  auto stats = cache->getStats();
+  EXPECT_EQ(3, stats.objectCount);
+  EXPECT_EQ(12, stats.totalSizeInBytes);
+  EXPECT_EQ(3, stats.hitCount);
+
+  cache->clear();
+  EXPECT_FALSE(cache->contains(object3->getHash()));
+  EXPECT_EQ(0, cache->getStats().objectCount);
+}
+
+TEST(ObjectCache, testSegmentedCacheSurvivesScans) {
+  // 10 byte budget, half of which is reserved for the protected segment.
+  auto cache = ObjectCache<CacheObject, ObjectCacheFlavor::Simple>::create(
+      10, 0, 1, 50);
+
+  // A second hit promotes object3 into the protected segment.
+  cache->insertSimple(object3->getHash(), object3);
+  EXPECT_EQ(object3, cache->getSimple(object3->getHash()));
+
+  // Scan through enough cold objects to evict everything in a plain LRU.
+  cache->insertSimple(object3a->getHash(), object3a);
+  cache->insertSimple(object3b->getHash(), object3b);
+  cache->insertSimple(object3c->getHash(), object3c);
+  cache->insertSimple(object4->getHash(), object4);
+  cache->insertSimple(object5->getHash(), object5);
+
+  // The promoted object survives the scan; the scanned objects churned
+  // through the probationary segment.
+  EXPECT_EQ(object3, cache->getSimple(object3->getHash()));
+  EXPECT_FALSE(cache->contains(object3a->getHash()));
+}
+
+TEST(ObjectCache, testReuseDistanceHistogram) {
+  auto cache =
+      ObjectCache<CacheObject, ObjectCacheFlavor::Simple>::create(1000, 1);
+
+  cache->insertSimple(object3->getHash(), object3);
+  // Immediate re-access: 1 access since the insert, so bucket 1 ([1, 2)).
+  EXPECT_EQ(object3, cache->getSimple(object3->getHash()));
+
+  // Touch two other objects, then come back: reuse distance 3, bucket 2.
+  cache->insertSimple(object4->getHash(), object4);
+  cache->insertSimple(object5->getHash(), object5);
+  EXPECT_EQ(object3, cache->getSimple(object3->getHash()));
+
+  auto stats = cache->getStats();
+  ASSERT_EQ(
+      ObjectCache<CacheObject, ObjectCacheFlavor::Simple>::
+          kReuseDistanceBucketCount,
+      stats.reuseDistanceBuckets.size());
+  EXPECT_EQ(1, stats.reuseDistanceBuckets[1]);
+  EXPECT_EQ(1, stats.reuseDistanceBuckets[2]);
+}
+
+TEST(ObjectCache, testBackgroundEviction) {
+  auto executor = std::make_shared<folly::ManualExecutor>();
+  auto cache = ObjectCache<CacheObject, ObjectCacheFlavor::Simple>::create(
+      10, 1, 1, 0, executor);
+
+  cache->insertSimple(object3->getHash(), object3);
+  cache->insertSimple(object3a->getHash(), object3a);
+  cache->insertSimple(object3b->getHash(), object3b);
+  cache->insertSimple(object3c->getHash(), object3c);
+
+  // Nothing is evicted until the eviction task runs; the cache transiently
+  // exceeds its size budget.
+  EXPECT_EQ(4, cache->getStats().objectCount);
+  EXPECT_EQ(12, cache->getStats().totalSizeInBytes);
+
+  executor->drain();
+
+  EXPECT_FALSE(cache->contains(object3->getHash()));
+  EXPECT_TRUE(cache->contains(object3a->getHash()));
+  EXPECT_TRUE(cache->contains(object3b->getHash()));
+  EXPECT_TRUE(cache->contains(object3c->getHash()));
+}
+
 TEST(ObjectCache, testSimpleInsert) {
   auto cache =
       ObjectCache<CacheObject, ObjectCacheFlavor::Simple>::create(10, 1);
@@ -553,3 +644,68 @@ TEST(
   handle3.reset();
   EXPECT_TRUE(cache->contains(hash3));
 }
+
+TEST(ObjectCache, unused_evictions_are_attributed_to_insertion_interest) {
+  using InterestCache =
+      ObjectCache<CacheObject, ObjectCacheFlavor::InterestHandle>;
+  auto cache = InterestCache::create(10, 0);
+
+  // object3 is hit after insertion; object4 never is. Inserting object9
+  // pushes both out.
+  cache->insertInterestHandle(
+      object3->getHash(), object3, InterestCache::Interest::LikelyNeededAgain);
+  EXPECT_TRUE(cache->getInterestHandle(hash3).object);
+  cache->insertInterestHandle(
+      object4->getHash(),
+      object4,
+      InterestCache::Interest::UnlikelyNeededAgain);
+  cache->insertInterestHandle(
+      object9->getHash(), object9, InterestCache::Interest::LikelyNeededAgain);
+
+  auto stats = cache->getStats();
+  auto likely =
+      static_cast<size_t>(InterestCache::Interest::LikelyNeededAgain);
+  auto unlikely =
+      static_cast<size_t>(InterestCache::Interest::UnlikelyNeededAgain);
+  EXPECT_EQ(2, stats.insertsByInterest[likely]);
+  EXPECT_EQ(1, stats.insertsByInterest[unlikely]);
+  EXPECT_EQ(0, stats.unusedEvictionsByInterest[likely])
+      << "object3 was hit before its eviction";
+  EXPECT_EQ(1, stats.unusedEvictionsByInterest[unlikely])
+      << "object4 was evicted without ever being hit";
+}
+
+TEST(ObjectCache, wasted_speculative_inserts_are_bypassed) {
+  using InterestCache =
+      ObjectCache<CacheObject, ObjectCacheFlavor::InterestHandle>;
+  // Room for ten 3-byte objects.
+  auto cache = InterestCache::create(30, 0);
+
+  // A long run of speculative inserts that are never read back: every insert
+  // past capacity evicts an earlier unused one, so the observed waste rate
+  // approaches 100% and the gate closes partway through.
+  const uint64_t total = InterestCache::kSpeculativeWasteMinimumSamples * 2;
+  for (uint64_t i = 0; i < total; ++i) {
+    auto id = ObjectId::sha1("speculative" + std::to_string(i));
+    cache->insertInterestHandle(
+        id,
+        std::make_shared<CacheObject>(id, 3),
+        InterestCache::Interest::UnlikelyNeededAgain);
+  }
+
+  auto stats = cache->getStats();
+  auto unlikely =
+      static_cast<size_t>(InterestCache::Interest::UnlikelyNeededAgain);
+  EXPECT_GT(stats.speculativeBypassCount, 0);
+  // Periodic probes are still admitted while the gate is closed, so the
+  // waste estimate keeps tracking the workload and the gate can reopen.
+  EXPECT_GT(
+      stats.insertsByInterest[unlikely],
+      InterestCache::kSpeculativeWasteMinimumSamples);
+  EXPECT_LT(stats.insertsByInterest[unlikely], total);
+
+  // The gate only affects speculative inserts; demanded objects still cache.
+  cache->insertInterestHandle(
+      object3->getHash(), object3, InterestCache::Interest::LikelyNeededAgain);
+  EXPECT_TRUE(cache->contains(hash3));
+}
@@ -181,6 +181,48 @@ TEST_F(ObjectStoreTest, getTree_tracks_second_read_from_local_store) {
   EXPECT_EQ(ObjectFetchContext::FromDiskCache, request.origin);
 }
 
+TEST_F(ObjectStoreTest, getBlobs_dedupes_and_preserves_order) {
+  auto otherBlobId = putReadyBlob("otherblob");
+  std::vector<ObjectId> ids{readyBlobId, otherBlobId, readyBlobId};
+
+  auto blobs = objectStore
+                   ->getBlobs(ObjectIdRange{ids.data(), ids.size()}, context)
+                   .get(0ms);
+  ASSERT_EQ(3, blobs.size());
+  EXPECT_EQ("readyblob", blobs[0]->getContents().clone()->moveToFbString());
+  EXPECT_EQ("otherblob", blobs[1]->getContents().clone()->moveToFbString());
+  EXPECT_EQ(blobs[0], blobs[2]);
+
+  // The duplicated ID must only hit the backing store once.
+  EXPECT_EQ(1, fakeBackingStore->getAccessCount(readyBlobId));
+}
+
+TEST_F(ObjectStoreTest, getTrees_dedupes_and_preserves_order) {
+  std::vector<ObjectId> ids{readyTreeId, readyTreeId};
+
+  auto trees = objectStore
+                   ->getTrees(ObjectIdRange{ids.data(), ids.size()}, context)
+                   .get(0ms);
+  ASSERT_EQ(2, trees.size());
+  EXPECT_EQ(readyTreeId, trees[0]->getHash());
+  EXPECT_EQ(trees[0], trees[1]);
+  EXPECT_EQ(1, fakeBackingStore->getAccessCount(readyTreeId));
+}
+
+TEST_F(ObjectStoreTest, getBlobMetadatas_dedupes_and_preserves_order) {
+  auto otherBlobId = putReadyBlob("otherblob!");
+  std::vector<ObjectId> ids{readyBlobId, otherBlobId, readyBlobId};
+
+  auto metadatas =
+      objectStore
+          ->getBlobMetadatas(ObjectIdRange{ids.data(), ids.size()}, context)
+          .get(0ms);
+  ASSERT_EQ(3, metadatas.size());
+  EXPECT_EQ(9, metadatas[0].size);
+  EXPECT_EQ(10, metadatas[1].size);
+  EXPECT_EQ(metadatas[0].sha1, metadatas[2].sha1);
+}
+
 TEST_F(ObjectStoreTest, getBlobSize_tracks_backing_store_read) {
   objectStore->getBlobSize(readyBlobId, context).get(0ms);
   ASSERT_EQ(1, loggingContext->requests.size());
@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#ifndef _WIN32
+
+#include "eden/fs/store/PackedBlobMetadata.h"
+
+#include <fmt/format.h>
+#include <folly/portability/GTest.h>
+
+#include "eden/fs/model/Hash.h"
+#include "eden/fs/testharness/TempFile.h"
+#include "eden/fs/utils/PathFuncs.h"
+
+namespace facebook::eden {
+
+namespace {
+
+ObjectId makeId(folly::StringPiece name) {
+  return ObjectId::sha1(folly::ByteRange{name});
+}
+
+BlobMetadata makeMetadata(folly::StringPiece contents) {
+  return BlobMetadata{
+      Hash20::sha1(folly::ByteRange{contents}),
+      Hash32::blake3(folly::ByteRange{contents}),
+      contents.size()};
+}
+
+void expectEqualMetadata(
+    const BlobMetadata& expected,
+    const std::optional<BlobMetadata>& actual) {
+  ASSERT_TRUE(actual.has_value());
+  EXPECT_EQ(expected.sha1, actual->sha1);
+  EXPECT_EQ(expected.blake3, actual->blake3);
+  EXPECT_EQ(expected.size, actual->size);
+}
+
+} // namespace
+
+class PackedBlobMetadataTest : public ::testing::Test {
+ protected:
+  AbsolutePath segmentPath() const {
+    return canonicalPath(tmpDir_.path().string()) + "packed-blob-metadata"_pc;
+  }
+
+  folly::test::TemporaryDirectory tmpDir_ = makeTempDir("eden_packed_meta_");
+};
+
+TEST_F(PackedBlobMetadataTest, staged_records_are_visible_before_flush) {
+  PackedBlobMetadata packed{segmentPath()};
+
+  auto metadata = makeMetadata("contents");
+  packed.stage(makeId("one"), metadata);
+
+  EXPECT_EQ(0ul, packed.packedRecordCount());
+  expectEqualMetadata(metadata, packed.get(makeId("one")));
+  EXPECT_EQ(std::nullopt, packed.get(makeId("two")));
+}
+
+TEST_F(PackedBlobMetadataTest, flushed_records_survive_reopen) {
+  auto one = makeMetadata("one contents");
+  auto two = makeMetadata("two contents");
+
+  {
+    PackedBlobMetadata packed{segmentPath()};
+    packed.stage(makeId("one"), one);
+    packed.stage(makeId("two"), two);
+    packed.flush();
+    EXPECT_EQ(2ul, packed.packedRecordCount());
+  }
+
+  PackedBlobMetadata packed{segmentPath()};
+  expectEqualMetadata(one, packed.get(makeId("one")));
+  expectEqualMetadata(two, packed.get(makeId("two")));
+  EXPECT_EQ(std::nullopt, packed.get(makeId("three")));
+}
+
+TEST_F(PackedBlobMetadataTest, flush_merges_into_existing_segment) {
+  PackedBlobMetadata packed{segmentPath()};
+
+  for (size_t i = 0; i < 100; ++i) {
+    packed.stage(makeId(fmt::format("even{}", i)), makeMetadata("contents"));
+  }
+  packed.flush();
+  for (size_t i = 0; i < 100; ++i) {
+    packed.stage(makeId(fmt::format("odd{}", i)), makeMetadata("contents"));
+  }
+  packed.flush();
+
+  EXPECT_EQ(200ul, packed.packedRecordCount());
+  for (size_t i = 0; i < 100; ++i) {
+    EXPECT_TRUE(packed.get(makeId(fmt::format("even{}", i))).has_value());
+    EXPECT_TRUE(packed.get(makeId(fmt::format("odd{}", i))).has_value());
+  }
+}
+
+TEST_F(PackedBlobMetadataTest, restaging_a_key_does_not_duplicate_it) {
+  PackedBlobMetadata packed{segmentPath()};
+
+  auto metadata = makeMetadata("contents");
+  packed.stage(makeId("one"), metadata);
+  packed.flush();
+  packed.stage(makeId("one"), metadata);
+  packed.flush();
+
+  EXPECT_EQ(1ul, packed.packedRecordCount());
+  expectEqualMetadata(metadata, packed.get(makeId("one")));
+}
+
+TEST_F(PackedBlobMetadataTest, oversized_object_ids_are_not_packed) {
+  PackedBlobMetadata packed{segmentPath()};
+
+  // 40 bytes exceeds the record's inline key capacity.
+  ObjectId longId{folly::ByteRange{folly::StringPiece{
+      "0123456789012345678901234567890123456789"}}};
+  packed.stage(longId, makeMetadata("contents"));
+  packed.flush();
+
+  EXPECT_EQ(0ul, packed.packedRecordCount());
+  EXPECT_EQ(std::nullopt, packed.get(longId));
+}
+
+TEST_F(PackedBlobMetadataTest, metadata_without_blake3_round_trips) {
+  PackedBlobMetadata packed{segmentPath()};
+
+  BlobMetadata metadata{
+      Hash20::sha1(folly::ByteRange{folly::StringPiece{"contents"}}),
+      std::nullopt,
+      8};
+  packed.stage(makeId("one"), metadata);
+  packed.flush();
+
+  auto found = packed.get(makeId("one"));
+  ASSERT_TRUE(found.has_value());
+  EXPECT_EQ(metadata.sha1, found->sha1);
+  EXPECT_EQ(std::nullopt, found->blake3);
+  EXPECT_EQ(8ul, found->size);
+}
+
+TEST_F(PackedBlobMetadataTest, clear_drops_staged_and_packed_records) {
+  PackedBlobMetadata packed{segmentPath()};
+
+  packed.stage(makeId("one"), makeMetadata("contents"));
+  packed.flush();
+  packed.stage(makeId("two"), makeMetadata("contents"));
+  packed.clear();
+
+  EXPECT_EQ(0ul, packed.packedRecordCount());
+  EXPECT_EQ(std::nullopt, packed.get(makeId("one")));
+  EXPECT_EQ(std::nullopt, packed.get(makeId("two")));
+}
+
+} // namespace facebook::eden
+
+#endif
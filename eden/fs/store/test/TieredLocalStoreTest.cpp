@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/store/TieredLocalStore.h"
+
+#include <folly/executors/ManualExecutor.h>
+
+#include "eden/fs/store/MemoryLocalStore.h"
+#include "eden/fs/store/test/LocalStoreTest.h"
+#include "eden/fs/telemetry/EdenStats.h"
+
+namespace {
+
+using namespace facebook::eden;
+using namespace folly::string_piece_literals;
+
+LocalStoreImplResult makeTieredLocalStore(FaultInjector*) {
+  // The generic LocalStore tests never drain the executor; buffered entries
+  // stay visible through the write-back tier regardless.
+  return {
+      std::nullopt,
+      std::make_shared<TieredLocalStore>(
+          std::make_shared<MemoryLocalStore>(makeRefPtr<EdenStats>()),
+          std::make_shared<folly::ManualExecutor>(),
+          makeRefPtr<EdenStats>())};
+}
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdeprecated-declarations"
+INSTANTIATE_TEST_CASE_P(
+    Tiered,
+    LocalStoreTest,
+    ::testing::Values(makeTieredLocalStore));
+
+INSTANTIATE_TEST_CASE_P(
+    Tiered,
+    OpenCloseLocalStoreTest,
+    ::testing::Values(makeTieredLocalStore));
+#pragma clang diagnostic pop
+
+class TieredLocalStoreTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    persistentStore_ = std::make_shared<MemoryLocalStore>(
+        makeRefPtr<EdenStats>());
+    flushExecutor_ = std::make_shared<folly::ManualExecutor>();
+    store_ = std::make_shared<TieredLocalStore>(
+        persistentStore_, flushExecutor_, makeRefPtr<EdenStats>());
+    store_->open();
+  }
+
+  std::shared_ptr<MemoryLocalStore> persistentStore_;
+  std::shared_ptr<folly::ManualExecutor> flushExecutor_;
+  std::shared_ptr<TieredLocalStore> store_;
+};
+
+TEST_F(TieredLocalStoreTest, bufferedWritesAreVisibleBeforeFlush) {
+  store_->put(KeySpace::BlobFamily, "key"_sp, "value"_sp);
+
+  // The entry is readable through the tiered store, but has not yet reached
+  // the persistent tier.
+  EXPECT_EQ("value", store_->get(KeySpace::BlobFamily, "key"_sp).piece());
+  EXPECT_FALSE(persistentStore_->hasKey(KeySpace::BlobFamily, "key"_sp));
+
+  flushExecutor_->drain();
+  EXPECT_EQ(
+      "value", persistentStore_->get(KeySpace::BlobFamily, "key"_sp).piece());
+  EXPECT_EQ("value", store_->get(KeySpace::BlobFamily, "key"_sp).piece());
+}
+
+TEST_F(TieredLocalStoreTest, persistentKeySpacesWriteThrough) {
+  store_->put(KeySpace::HgProxyHashFamily, "proxy"_sp, "hash"_sp);
+
+  // No executor drain: persistent key spaces bypass the write-back buffer.
+  EXPECT_EQ(
+      "hash",
+      persistentStore_->get(KeySpace::HgProxyHashFamily, "proxy"_sp).piece());
+}
+
+TEST_F(TieredLocalStoreTest, explicitFlushDrainsBuffer) {
+  store_->put(KeySpace::BlobFamily, "key"_sp, "value"_sp);
+  store_->flush();
+  EXPECT_EQ(
+      "value", persistentStore_->get(KeySpace::BlobFamily, "key"_sp).piece());
+}
+
+TEST_F(TieredLocalStoreTest, overLimitPutFlushesInline) {
+  auto smallStore = std::make_shared<TieredLocalStore>(
+      persistentStore_,
+      flushExecutor_,
+      makeRefPtr<EdenStats>(),
+      /*maxPendingBytes=*/1);
+  smallStore->put(KeySpace::BlobFamily, "key"_sp, "value"_sp);
+
+  // The put exceeded the buffer limit, so it drained without the executor.
+  EXPECT_EQ(
+      "value", persistentStore_->get(KeySpace::BlobFamily, "key"_sp).piece());
+}
+
+TEST_F(TieredLocalStoreTest, getBatchMergesBufferAndPersistentTier) {
+  persistentStore_->put(KeySpace::BlobFamily, "persisted"_sp, "old"_sp);
+  store_->put(KeySpace::BlobFamily, "buffered"_sp, "new"_sp);
+
+  auto results = store_
+                     ->getBatch(
+                         KeySpace::BlobFamily,
+                         {folly::ByteRange{"buffered"_sp},
+                          folly::ByteRange{"persisted"_sp},
+                          folly::ByteRange{"missing"_sp}})
+                     .get();
+  ASSERT_EQ(3, results.size());
+  EXPECT_EQ("new", results[0].piece());
+  EXPECT_EQ("old", results[1].piece());
+  EXPECT_FALSE(results[2].isValid());
+}
+
+TEST_F(TieredLocalStoreTest, clearKeySpaceDropsBufferedEntries) {
+  store_->put(KeySpace::BlobFamily, "key"_sp, "value"_sp);
+  store_->clearKeySpace(KeySpace::BlobFamily);
+
+  EXPECT_FALSE(store_->hasKey(KeySpace::BlobFamily, "key"_sp));
+  flushExecutor_->drain();
+  EXPECT_FALSE(persistentStore_->hasKey(KeySpace::BlobFamily, "key"_sp));
+}
+
+TEST_F(TieredLocalStoreTest, writeBatchRoutesPerKeySpace) {
+  auto batch = store_->beginWrite();
+  batch->put(KeySpace::BlobFamily, "blob"_sp, "blobValue"_sp);
+  batch->put(KeySpace::HgProxyHashFamily, "proxy"_sp, "hash"_sp);
+  batch->flush();
+
+  // The persistent entry wrote through; the ephemeral one is buffered.
+  EXPECT_EQ(
+      "hash",
+      persistentStore_->get(KeySpace::HgProxyHashFamily, "proxy"_sp).piece());
+  EXPECT_FALSE(persistentStore_->hasKey(KeySpace::BlobFamily, "blob"_sp));
+  EXPECT_EQ("blobValue", store_->get(KeySpace::BlobFamily, "blob"_sp).piece());
+
+  flushExecutor_->drain();
+  EXPECT_EQ(
+      "blobValue",
+      persistentStore_->get(KeySpace::BlobFamily, "blob"_sp).piece());
+}
+
+} // namespace
@@ -7,15 +7,25 @@
 
 #include "eden/fs/takeover/TakeoverData.h"
 
+#include <algorithm>
 #include <memory>
 #include <stdexcept>
 #include <variant>
 
 #include <fmt/format.h>
+#include <folly/Exception.h>
+#include <folly/FileUtil.h>
+#include <folly/Varint.h>
+#include <folly/io/Cursor.h>
 #include <folly/io/IOBuf.h>
 #include <folly/logging/xlog.h>
 #include "folly/Likely.h"
 
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
 #include <thrift/lib/cpp2/protocol/Serializer.h>
 
 #include "eden/fs/utils/Bug.h"
@@ -46,6 +56,64 @@ TakeoverMountProtocol getTakeoverMountProtocol(
       mountInfo.mountPath);
 }
 
+#ifdef __linux__
+/**
+ * Size of the protocol header sent over the socket when SHM_PAYLOAD is in
+ * use: the version, the header size, and the capability bits. SHM_PAYLOAD
+ * requires capability matching, so the full version 7 style header is always
+ * present.
+ */
+constexpr size_t kShmHeaderLength = 2 * sizeof(uint32_t) + sizeof(uint64_t);
+
+/**
+ * Write everything after the protocol header in `data` into an anonymous
+ * in-memory file, then trim `data` down to just the header. The returned
+ * file's fd must be sent as the first file of the takeover message.
+ */
+folly::File exportPayloadToMemfd(folly::IOBuf& data) {
+  auto fd = memfd_create("eden_takeover_payload", MFD_CLOEXEC);
+  folly::checkUnixError(fd, "memfd_create failed for takeover payload");
+  folly::File file{fd, /*ownsFd=*/true};
+
+  folly::io::Cursor cursor{&data};
+  cursor.skip(kShmHeaderLength);
+  while (!cursor.isAtEnd()) {
+    auto bytes = cursor.peekBytes();
+    auto written = folly::writeFull(file.fd(), bytes.data(), bytes.size());
+    folly::checkUnixError(written, "error writing takeover payload to memfd");
+    cursor.skip(bytes.size());
+  }
+
+  folly::io::Cursor headerCursor{&data};
+  folly::IOBuf header;
+  headerCursor.clone(header, kShmHeaderLength);
+  data = std::move(header);
+  return file;
+}
+
+/**
+ * Read the serialized takeover payload back out of the in-memory file sent
+ * by the server.
+ */
+folly::IOBuf importPayloadFromFd(const folly::File& file) {
+  struct stat st;
+  folly::checkUnixError(
+      fstat(file.fd(), &st), "fstat failed on takeover payload fd");
+  auto size = static_cast<size_t>(st.st_size);
+  folly::IOBuf buf{folly::IOBuf::CREATE, size};
+  auto bytesRead = folly::preadFull(file.fd(), buf.writableTail(), size, 0);
+  folly::checkUnixError(bytesRead, "error reading takeover payload");
+  if (static_cast<size_t>(bytesRead) != size) {
+    throwf<std::runtime_error>(
+        "short read of takeover payload: expected {} bytes, got {}",
+        size,
+        bytesRead);
+  }
+  buf.append(size);
+  return buf;
+}
+#endif // __linux__
+
 } // namespace
 #endif
 
@@ -79,7 +147,13 @@ const uint64_t kSupportedCapabilities = TakeoverCapabilities::FUSE |
     TakeoverCapabilities::RESULT_TYPE_SERIALIZATION |
     TakeoverCapabilities::ORDERED_FDS | TakeoverCapabilities::OPTIONAL_MOUNTD |
     TakeoverCapabilities::CAPABILITY_MATCHING |
-    TakeoverCapabilities::INCLUDE_HEADER_SIZE;
+    TakeoverCapabilities::INCLUDE_HEADER_SIZE
+#ifdef __linux__
+    // The shared memory payload transport relies on memfd_create(), so we
+    // only advertise it on Linux. Non-Linux peers simply negotiate it away.
+    | TakeoverCapabilities::SHM_PAYLOAD
+#endif
+    | TakeoverCapabilities::COMPACT_INODE_TABLE;
 
 std::optional<int32_t> TakeoverData::computeCompatibleVersion(
     const std::set<int32_t>& versions,
@@ -118,6 +192,18 @@ uint64_t TakeoverData::computeCompatibleCapabilities(
     throw std::runtime_error{
         "Optional mountd can not be used without ordered file descriptors"};
   }
+  if ((compatible & TakeoverCapabilities::SHM_PAYLOAD) &&
+      ((compatible & TakeoverCapabilities::CAPABILITY_MATCHING) == 0)) {
+    throw std::runtime_error{
+        "The shared memory payload can not be used without capability "
+        "matching"};
+  }
+  if ((compatible & TakeoverCapabilities::COMPACT_INODE_TABLE) &&
+      ((compatible & TakeoverCapabilities::CAPABILITY_MATCHING) == 0)) {
+    throw std::runtime_error{
+        "The compact inode table can not be used without capability "
+        "matching"};
+  }
 
   return compatible;
 }
@@ -164,6 +250,12 @@ uint64_t TakeoverData::versionToCapabilities(int32_t version) {
 }
 
 int32_t TakeoverData::capabilitiesToVersion(uint64_t capabilities) {
+  // SHM_PAYLOAD and COMPACT_INODE_TABLE are negotiated purely through
+  // capability matching and are not part of any version's capability set,
+  // so ignore them when mapping back to a version number to advertise.
+  capabilities &= ~static_cast<uint64_t>(TakeoverCapabilities::SHM_PAYLOAD);
+  capabilities &=
+      ~static_cast<uint64_t>(TakeoverCapabilities::COMPACT_INODE_TABLE);
   if (capabilities == 0) {
     return kTakeoverProtocolVersionNeverSupported;
   }
@@ -282,12 +374,31 @@ void TakeoverData::deserializeFd(FileDescriptorType type, folly::File& file) {
 void TakeoverData::serialize(
     uint64_t protocolCapabilities,
     UnixSocket::Message& msg) {
+  msg.data = serializePayload(protocolCapabilities);
+  serializeFds(protocolCapabilities, msg);
+}
+
+folly::IOBuf TakeoverData::serializePayload(uint64_t protocolCapabilities) {
   if (protocolCapabilities & TakeoverCapabilities::ORDERED_FDS) {
-    // note this needs to happen before serialization of the msg because we
-    // serialize the order into the message.
+    // note this needs to happen before serialization of the payload because
+    // we serialize the order into the message.
     generalFDOrder = generateGeneralFdOrder(protocolCapabilities);
   }
-  msg.data = serialize(protocolCapabilities);
+  return serialize(protocolCapabilities);
+}
+
+void TakeoverData::serializeFds(
+    uint64_t protocolCapabilities,
+    UnixSocket::Message& msg) {
+#ifdef __linux__
+  if (protocolCapabilities & TakeoverCapabilities::SHM_PAYLOAD) {
+    // Move the bulk payload out of the socket message and into an anonymous
+    // in-memory file, leaving only the protocol header in msg.data. The
+    // payload fd travels ahead of the general fds and is not part of
+    // generalFDOrder.
+    msg.files.push_back(exportPayloadToMemfd(msg.data));
+  }
+#endif
   if (protocolCapabilities & TakeoverCapabilities::ORDERED_FDS) {
     for (auto& fdType : generalFDOrder) {
       serializeFd(fdType, msg.files);
@@ -358,7 +469,21 @@ folly::IOBuf TakeoverData::serializePing() {
 TakeoverData TakeoverData::deserialize(UnixSocket::Message& msg) {
   auto capabilities = TakeoverData::getProtocolCapabilities(&msg.data);
 
-  auto data = TakeoverData::deserialize(capabilities, &msg.data);
+  auto* payloadBuf = &msg.data;
+#ifdef __linux__
+  folly::IOBuf shmPayload;
+  if ((capabilities & TakeoverCapabilities::SHM_PAYLOAD) &&
+      !msg.files.empty()) {
+    // The bulk payload was sent in an in-memory file rather than through the
+    // socket; its fd is the first file of the message. Error messages are
+    // still sent entirely in msg.data with no files attached, which the
+    // files.empty() check above handles.
+    shmPayload = importPayloadFromFd(msg.files.front());
+    msg.files.erase(msg.files.begin());
+    payloadBuf = &shmPayload;
+  }
+#endif
+  auto data = TakeoverData::deserialize(capabilities, payloadBuf);
   // when we serialize the mountd socket we have three general files instead
   // of two
   const auto mountPointFilesOffset =
@@ -557,10 +682,22 @@ IOBuf TakeoverData::serializeThrift(uint64_t protocolCapabilities) {
           sizeof(fuseChannelInfo->connInfo)};
     }
 
-    serializedMount.inodeMap_ref() = mount.inodeMap;
+    if (protocolCapabilities & TakeoverCapabilities::COMPACT_INODE_TABLE) {
+      SerializedInodeMap compactMap;
+      compactMap.compactUnloadedInodes_ref() =
+          compactEncodeInodeMap(mount.inodeMap);
+      serializedMount.inodeMap_ref() = std::move(compactMap);
+    } else {
+      serializedMount.inodeMap_ref() = mount.inodeMap;
+    }
 
     serializedMount.mountProtocol_ref() = mountProtocol;
 
+    if (mount.mountGeneration.has_value()) {
+      serializedMount.mountGeneration_ref() =
+          static_cast<int64_t>(*mount.mountGeneration);
+    }
+
     serializedMounts.emplace_back(std::move(serializedMount));
   }
 
@@ -669,6 +806,13 @@ TakeoverData TakeoverData::deserializeThriftMounts(
     std::vector<SerializedMountInfo>& serializedMounts) {
   TakeoverData data;
   for (auto& serializedMount : serializedMounts) {
+    // If the peer sent the delta-encoded inode table, expand it back into
+    // the struct form the rest of the code consumes.
+    auto& inodeMap = *serializedMount.inodeMap_ref();
+    if (auto compact = inodeMap.compactUnloadedInodes_ref()) {
+      auto decoded = compactDecodeInodeMap(*compact);
+      inodeMap = std::move(decoded);
+    }
     switch (*serializedMount.mountProtocol_ref()) {
       case TakeoverMountProtocol::UNKNOWN:
         if (protocolCapabilities & TakeoverCapabilities::MOUNT_TYPES) {
@@ -707,9 +851,144 @@ TakeoverData TakeoverData::deserializeThriftMounts(
         throw std::runtime_error(
             "impossible enum variant for TakeoverMountProtocol");
     }
+    if (auto generation = serializedMount.mountGeneration_ref()) {
+      data.mountPoints.back().mountGeneration =
+          static_cast<uint64_t>(*generation);
+    }
   }
   return data;
 }
+
+namespace {
+
+// Flag bits stored in the per-entry flag byte of the compact inode table.
+constexpr uint64_t kCompactEntryUnlinked = 1 << 0;
+constexpr uint64_t kCompactEntryHasHash = 1 << 1;
+
+void appendVarint(std::string& out, uint64_t value) {
+  uint8_t buf[folly::kMaxVarintLength64];
+  auto length = folly::encodeVarint(value, buf);
+  out.append(reinterpret_cast<const char*>(buf), length);
+}
+
+uint64_t readVarint(folly::ByteRange& range) {
+  auto result = folly::tryDecodeVarint(range);
+  if (!result.hasValue()) {
+    throw std::runtime_error(
+        "truncated or malformed varint in compact inode table");
+  }
+  return result.value();
+}
+
+folly::StringPiece readBytes(folly::ByteRange& range, uint64_t length) {
+  if (length > range.size()) {
+    throw std::runtime_error("truncated compact inode table");
+  }
+  folly::StringPiece result{
+      reinterpret_cast<const char*>(range.data()),
+      static_cast<size_t>(length)};
+  range.advance(static_cast<size_t>(length));
+  return result;
+}
+
+} // namespace
+
+std::string TakeoverData::compactEncodeInodeMap(
+    const SerializedInodeMap& inodeMap) {
+  // Sorting by inode number keeps the gaps small, and since inodes are
+  // typically registered in allocation order the sort is nearly free.
+  // Sibling entries also tend to sort near each other, which is what makes
+  // the shared name-prefix compression effective.
+  auto entries = *inodeMap.unloadedInodes_ref();
+  std::sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) {
+    return *a.inodeNumber_ref() < *b.inodeNumber_ref();
+  });
+
+  std::string out;
+  appendVarint(out, entries.size());
+
+  uint64_t previousInode = 0;
+  folly::StringPiece previousName;
+  for (const auto& entry : entries) {
+    auto inodeNumber = static_cast<uint64_t>(*entry.inodeNumber_ref());
+    appendVarint(out, inodeNumber - previousInode);
+    previousInode = inodeNumber;
+    appendVarint(out, static_cast<uint64_t>(*entry.parentInode_ref()));
+
+    uint64_t flags = 0;
+    if (*entry.isUnlinked_ref()) {
+      flags |= kCompactEntryUnlinked;
+    }
+    if (entry.hash_ref().has_value()) {
+      flags |= kCompactEntryHasHash;
+    }
+    appendVarint(out, flags);
+    appendVarint(out, static_cast<uint32_t>(*entry.mode_ref()));
+    appendVarint(out, static_cast<uint64_t>(*entry.numFsReferences_ref()));
+
+    folly::StringPiece name{*entry.name_ref()};
+    size_t shared = 0;
+    auto limit = std::min(name.size(), previousName.size());
+    while (shared < limit && name[shared] == previousName[shared]) {
+      ++shared;
+    }
+    appendVarint(out, shared);
+    appendVarint(out, name.size() - shared);
+    out.append(name.data() + shared, name.size() - shared);
+    previousName = name;
+
+    if (entry.hash_ref().has_value()) {
+      appendVarint(out, entry.hash_ref()->size());
+      out.append(*entry.hash_ref());
+    }
+  }
+  return out;
+}
+
+SerializedInodeMap TakeoverData::compactDecodeInodeMap(
+    folly::StringPiece data) {
+  folly::ByteRange range{data};
+  auto count = readVarint(range);
+
+  SerializedInodeMap inodeMap;
+  auto& entries = *inodeMap.unloadedInodes_ref();
+  entries.reserve(count);
+
+  uint64_t previousInode = 0;
+  std::string previousName;
+  for (uint64_t i = 0; i < count; ++i) {
+    SerializedInodeMapEntry entry;
+    previousInode += readVarint(range);
+    entry.inodeNumber_ref() = static_cast<int64_t>(previousInode);
+    entry.parentInode_ref() = static_cast<int64_t>(readVarint(range));
+    auto flags = readVarint(range);
+    entry.isUnlinked_ref() = (flags & kCompactEntryUnlinked) != 0;
+    entry.mode_ref() = static_cast<int32_t>(readVarint(range));
+    entry.numFsReferences_ref() = static_cast<int64_t>(readVarint(range));
+
+    auto sharedLength = readVarint(range);
+    if (sharedLength > previousName.size()) {
+      throw std::runtime_error(
+          "compact inode table entry shares more name bytes than the "
+          "previous entry has");
+    }
+    auto suffix = readBytes(range, readVarint(range));
+    std::string name = previousName.substr(0, sharedLength);
+    name.append(suffix.data(), suffix.size());
+    previousName = name;
+    entry.name_ref() = std::move(name);
+
+    if (flags & kCompactEntryHasHash) {
+      entry.hash_ref() = readBytes(range, readVarint(range)).str();
+    }
+    entries.emplace_back(std::move(entry));
+  }
+  if (!range.empty()) {
+    throw std::runtime_error(
+        "trailing bytes after the last compact inode table entry");
+  }
+  return inodeMap;
+}
 #endif
 
 } // namespace facebook::eden
@@ -110,6 +110,30 @@ class TakeoverCapabilities {
     // Indicates that we include the size of the header in the header itself.
     // This will allow us to more safely evolve the header in the future.
     INCLUDE_HEADER_SIZE = 1 << 10,
+
+    // Indicates that the bulk of the takeover payload (the serialized mount
+    // and inode tables) is written into an anonymous in-memory file whose fd
+    // is passed as the first file of the takeover message, instead of being
+    // streamed through the unix socket. Only the small protocol header is
+    // sent in the message data. This keeps the socket transfer O(1) in the
+    // number of inodes. Error messages are still sent entirely in the message
+    // data with no files attached.
+    //
+    // This capability is negotiated purely through capability matching; no
+    // protocol version implies it, and it requires CAPABILITY_MATCHING. It is
+    // only advertised on Linux, where memfd_create() is available.
+    SHM_PAYLOAD = 1 << 11,
+
+    // Indicates that the unloaded inode table of each mount is sent
+    // delta-encoded (entries sorted by inode number, varint gaps, shared
+    // name-prefix compression) in SerializedInodeMap::compactUnloadedInodes
+    // instead of as a list of thrift structs. On large mounts the inode
+    // table dominates the takeover payload, so this directly shrinks the
+    // stop-the-world window of a daemon upgrade.
+    //
+    // This capability is negotiated purely through capability matching; no
+    // protocol version implies it, and it requires CAPABILITY_MATCHING.
+    COMPACT_INODE_TABLE = 1 << 12,
   };
 };
 
@@ -256,6 +280,15 @@ class TakeoverData {
     FsChannelInfo channelInfo;
 
     SerializedInodeMap inodeMap;
+
+    /**
+     * The mount generation of this mount in the old process, if it sent
+     * one. Preserving the generation across a graceful takeover keeps
+     * journal positions held by clients valid, so subscribers like
+     * Watchman revalidate their caches incrementally instead of treating
+     * the restarted daemon as a brand new mount and re-crawling it.
+     */
+    std::optional<uint64_t> mountGeneration;
   };
 
   /**
@@ -284,6 +317,25 @@ class TakeoverData {
    */
   void serialize(uint64_t protocolCapabilities, UnixSocket::Message& msg);
 
+  /**
+   * Serialize the bulk takeover payload - everything except the file
+   * descriptors - into a buffer.
+   *
+   * This is the expensive half of serialize(): for servers with many loaded
+   * inodes building this buffer takes a while, so callers may want to do it
+   * eagerly while they wait on other work (e.g. the ready ping round trip).
+   * This records the fd order in the payload when the protocol calls for it,
+   * so serializeFds() must be called on the same TakeoverData instance with
+   * the same protocolCapabilities to complete the message.
+   */
+  folly::IOBuf serializePayload(uint64_t protocolCapabilities);
+
+  /**
+   * Move this TakeoverData's file descriptors into msg.files, in the order
+   * recorded by serializePayload().
+   */
+  void serializeFds(uint64_t protocolCapabilities, UnixSocket::Message& msg);
+
   /**
    * Serialize an exception.
    */
@@ -322,6 +374,29 @@ class TakeoverData {
    */
   static bool shouldSerdeNFSInfo(uint32_t protocolVersionCapabilies);
 
+  /**
+   * Delta-encode an unloaded inode table, as negotiated by the
+   * COMPACT_INODE_TABLE capability.
+   *
+   * All integers are varint-encoded. The format is the entry count followed
+   * by the entries sorted by ascending inode number, each encoded as: the
+   * gap from the previous entry's inode number (the absolute number for the
+   * first entry), the parent inode number, a flag byte (bit 0: unlinked,
+   * bit 1: a hash follows), the mode, the FS reference count, the length of
+   * the name prefix shared with the previous entry's name, the rest of the
+   * name, and finally the hash when the flag bit is set. An absent hash
+   * means the inode is materialized, matching SerializedInodeMapEntry.
+   */
+  static std::string compactEncodeInodeMap(const SerializedInodeMap& inodeMap);
+
+  /**
+   * Decode a table produced by compactEncodeInodeMap. The entries come back
+   * sorted by inode number; their original order is not preserved, which is
+   * fine since InodeMap does not depend on it. Throws std::runtime_error on
+   * malformed input.
+   */
+  static SerializedInodeMap compactDecodeInodeMap(folly::StringPiece data);
+
   /**
    * The main eden lock file that prevents two edenfs processes from running at
    * the same time.
@@ -77,7 +77,8 @@ class TakeoverServer::ConnHandler {
       TakeoverData&& data);
 
   FOLLY_NODISCARD folly::Future<folly::Unit> sendTakeoverData(
-      TakeoverData&& data);
+      TakeoverData&& data,
+      std::optional<folly::IOBuf> payload = std::nullopt);
 
   template <typename... Args>
   [[noreturn]] void fail(Args&&... args) {
@@ -223,8 +224,22 @@ Future<Unit> TakeoverServer::ConnHandler::pingThenSendTakeoverData(
   msg.data = TakeoverData::serializePing();
 
   auto& state = state_.get();
+  auto pingFuture = state.socket.send(std::move(msg));
+
+  // Serialize the bulk takeover payload while the ping round trip is in
+  // flight.  The mounts have already stopped serving IO at this point, so
+  // any serialization work we can overlap with the client's reply directly
+  // shortens the blackout.  If serialization fails, leave the payload empty;
+  // sendTakeoverData() will hit the same error after the ping completes and
+  // report it to the client through the existing error path.
+  std::optional<folly::IOBuf> payload;
+  try {
+    payload = data.serializePayload(state.protocolCapabilities);
+  } catch (const std::exception& ex) {
+    XLOG(WARN) << "takeover payload serialization failed: " << ex.what();
+  }
 
-  return state.socket.send(std::move(msg))
+  return std::move(pingFuture)
       .thenValue([this](auto&&) {
         // Wait for the ping reply. Here we just give it a few seconds to
         // respond.
@@ -237,7 +252,7 @@ Future<Unit> TakeoverServer::ConnHandler::pingThenSendTakeoverData(
         auto& state = state_.get();
         return state.socket.receive(timeout);
       })
-      .thenTry([this, data = std::move(data)](
+      .thenTry([this, data = std::move(data), payload = std::move(payload)](
                    folly::Try<UnixSocket::Message>&& msg) mutable {
         if (msg.hasException()) {
           // If we got an exception on sending or receiving here, we should
@@ -252,12 +267,13 @@ Future<Unit> TakeoverServer::ConnHandler::pingThenSendTakeoverData(
 
           return makeFuture<Unit>(msg.exception());
         }
-        return sendTakeoverData(std::move(data));
+        return sendTakeoverData(std::move(data), std::move(payload));
       });
 }
 
 Future<Unit> TakeoverServer::ConnHandler::sendTakeoverData(
-    TakeoverData&& data) {
+    TakeoverData&& data,
+    std::optional<folly::IOBuf> payload) {
   // Before sending the takeover data, we must close the server's
   // local and backing store. This is important for ensuring the RocksDB
   // lock is released so the client can take over.
@@ -267,7 +283,14 @@ Future<Unit> TakeoverServer::ConnHandler::sendTakeoverData(
 
   UnixSocket::Message msg;
   try {
-    data.serialize(state.protocolCapabilities, msg);
+    if (payload.has_value()) {
+      // The bulk payload was already serialized during the ping round trip;
+      // all that remains is to attach the file descriptors.
+      msg.data = std::move(payload).value();
+      data.serializeFds(state.protocolCapabilities, msg);
+    } else {
+      data.serialize(state.protocolCapabilities, msg);
+    }
     for (auto& file : msg.files) {
       XLOG(DBG7) << "sending fd for takeover: " << file.fd();
     }
@@ -37,6 +37,12 @@ struct SerializedInodeMapEntry {
 
 struct SerializedInodeMap {
   2: list<SerializedInodeMapEntry> unloadedInodes;
+  // Delta-encoded replacement for unloadedInodes, set when the
+  // COMPACT_INODE_TABLE capability is negotiated: entries are sorted by
+  // inode number and encoded with varint gaps and shared name-prefix
+  // compression. See TakeoverData::compactEncodeInodeMap for the exact
+  // format. When this field is set, unloadedInodes is left empty.
+  3: optional binary compactUnloadedInodes;
 }
 
 struct SerializedFileHandleMap {}
@@ -69,6 +75,13 @@ struct SerializedMountInfo {
   6: SerializedInodeMap inodeMap;
 
   7: TakeoverMountProtocol mountProtocol = TakeoverMountProtocol.UNKNOWN;
+
+  // The mount generation of this mount in the old process. The new
+  // process adopts this value so that journal positions held by clients
+  // remain valid across a graceful takeover. Optional for compatibility
+  // with peers that do not send it; when unset, the new process assigns
+  // a fresh generation as it would for a cold mount.
+  8: optional i64 mountGeneration;
 }
 
 // TODO(T110300475): remove after SerializedTakeoverResult becomes stable. Should be
@@ -5,6 +5,9 @@
  * GNU General Public License version 2.
  */
 
+#include <algorithm>
+#include <optional>
+
 #include <folly/Exception.h>
 #include <folly/experimental/TestUtil.h>
 #include <folly/futures/Future.h>
@@ -413,6 +416,184 @@ TEST(Takeover, sixToSeven) {
           TakeoverData::kTakeoverProtocolVersionSix));
 }
 
+#ifdef __linux__
+TEST(Takeover, shmPayload) {
+  // Exercise the shared memory payload transport explicitly: the bulk of the
+  // serialized takeover data travels in a memfd rather than over the socket.
+  simpleTestImpl(
+      CheckMountdSocket::YES,
+      kSupportedTakeoverVersions,
+      kSupportedTakeoverVersions,
+      kSupportedCapabilities | TakeoverCapabilities::SHM_PAYLOAD,
+      kSupportedCapabilities | TakeoverCapabilities::SHM_PAYLOAD);
+}
+
+TEST(Takeover, shmPayloadOneSided) {
+  // If only one side supports the shared memory payload, capability matching
+  // must negotiate it away and the takeover should fall back to sending the
+  // payload through the socket.
+  const auto kNoShmCapabilities = kSupportedCapabilities &
+      ~static_cast<uint64_t>(TakeoverCapabilities::SHM_PAYLOAD);
+  simpleTestImpl(
+      CheckMountdSocket::YES,
+      kSupportedTakeoverVersions,
+      kSupportedTakeoverVersions,
+      kNoShmCapabilities,
+      kSupportedCapabilities | TakeoverCapabilities::SHM_PAYLOAD);
+
+  simpleTestImpl(
+      CheckMountdSocket::YES,
+      kSupportedTakeoverVersions,
+      kSupportedTakeoverVersions,
+      kSupportedCapabilities | TakeoverCapabilities::SHM_PAYLOAD,
+      kNoShmCapabilities);
+}
+#endif
+
+namespace {
+/**
+ * Build an inode map that exercises the interesting corners of the compact
+ * encoding: shared name prefixes, a large inode number gap, an unlinked
+ * entry, and the three hash states (unset = materialized, empty string =
+ * legacy materialized, and a real binary hash).
+ */
+SerializedInodeMap makeTestInodeMap() {
+  auto makeEntry = [](int64_t inodeNumber,
+                      int64_t parentInode,
+                      folly::StringPiece name,
+                      bool isUnlinked,
+                      std::optional<std::string> hash) {
+    SerializedInodeMapEntry entry;
+    entry.inodeNumber_ref() = inodeNumber;
+    entry.parentInode_ref() = parentInode;
+    entry.name_ref() = name.str();
+    entry.isUnlinked_ref() = isUnlinked;
+    entry.numFsReferences_ref() = 1;
+    entry.mode_ref() = S_IFREG | 0644;
+    if (hash.has_value()) {
+      entry.hash_ref() = std::move(hash).value();
+    }
+    return entry;
+  };
+
+  SerializedInodeMap inodeMap;
+  auto& entries = *inodeMap.unloadedInodes_ref();
+  // Deliberately out of inode-number order: the encoder sorts.
+  entries.push_back(makeEntry(
+      100, 1, "README.md", false, std::string{"\x01\x02\x03\x04", 4}));
+  entries.push_back(makeEntry(99, 1, "README.txt", false, std::nullopt));
+  entries.push_back(makeEntry(
+      1'000'000'000, 99, "unrelated-name", true, std::string{}));
+  entries.push_back(
+      makeEntry(101, 100, "README.md.orig", false, std::nullopt));
+  return inodeMap;
+}
+
+void sortEntriesByInodeNumber(std::vector<SerializedInodeMapEntry>& entries) {
+  std::sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) {
+    return *a.inodeNumber_ref() < *b.inodeNumber_ref();
+  });
+}
+
+/**
+ * Perform a takeover of a single mount carrying a populated inode map and
+ * verify the client receives the same entries, regardless of whether the
+ * compact encoding was negotiated.
+ */
+void takeoverWithInodeMapImpl(
+    uint64_t clientCapabilities,
+    uint64_t serverCapabilities) {
+  TemporaryDirectory tmpDir("eden_takeover_test");
+  AbsolutePath tmpDirPath = canonicalPath(tmpDir.path().string());
+
+  TakeoverData serverData;
+  auto lockFilePath = tmpDirPath + "lock"_pc;
+  serverData.lockFile = folly::File{lockFilePath.view(), O_RDWR | O_CREAT};
+  auto thriftSocketPath = tmpDirPath + "thrift"_pc;
+  serverData.thriftSocket =
+      folly::File{thriftSocketPath.view(), O_RDWR | O_CREAT};
+  auto mountdSocketPath = tmpDirPath + "mountd"_pc;
+  serverData.mountdServerSocket =
+      folly::File{mountdSocketPath.view(), O_RDWR | O_CREAT};
+
+  auto mountPath = tmpDirPath + "mount1"_pc;
+  auto clientPath = tmpDirPath + "client1"_pc;
+  auto fusePath = tmpDirPath + "fuse1"_pc;
+  serverData.mountPoints.emplace_back(
+      mountPath,
+      clientPath,
+      FuseChannelData{
+          folly::File{fusePath.view(), O_RDWR | O_CREAT}, fuse_init_out{}},
+      makeTestInodeMap());
+  constexpr uint64_t kMountGeneration = 0x1234567890abcdefULL;
+  serverData.mountPoints.back().mountGeneration = kMountGeneration;
+
+  TestHandler handler{std::move(serverData)};
+  auto result = runTakeover(
+      tmpDir,
+      &handler,
+      kSupportedTakeoverVersions,
+      kSupportedTakeoverVersions,
+      clientCapabilities,
+      serverCapabilities);
+  ASSERT_TRUE(result.hasValue());
+  auto& clientData = result.value();
+  ASSERT_EQ(1, clientData.mountPoints.size());
+
+  // The compact encoding does not preserve entry order, so sort both sides
+  // before comparing.
+  auto expected = *makeTestInodeMap().unloadedInodes_ref();
+  sortEntriesByInodeNumber(expected);
+  auto actual = *clientData.mountPoints.at(0).inodeMap.unloadedInodes_ref();
+  sortEntriesByInodeNumber(actual);
+  EXPECT_EQ(expected, actual);
+
+  // The mount generation must survive the trip so the new process can
+  // adopt it.
+  EXPECT_EQ(kMountGeneration, clientData.mountPoints.at(0).mountGeneration);
+}
+} // namespace
+
+TEST(Takeover, compactInodeMapRoundTrip) {
+  auto original = makeTestInodeMap();
+  auto encoded = TakeoverData::compactEncodeInodeMap(original);
+  auto decoded = TakeoverData::compactDecodeInodeMap(encoded);
+
+  auto expected = *original.unloadedInodes_ref();
+  sortEntriesByInodeNumber(expected);
+  auto actual = *decoded.unloadedInodes_ref();
+  sortEntriesByInodeNumber(actual);
+  EXPECT_EQ(expected, actual);
+}
+
+TEST(Takeover, compactInodeMapEmpty) {
+  auto encoded = TakeoverData::compactEncodeInodeMap(SerializedInodeMap{});
+  auto decoded = TakeoverData::compactDecodeInodeMap(encoded);
+  EXPECT_TRUE(decoded.unloadedInodes_ref()->empty());
+}
+
+TEST(Takeover, compactInodeMapRejectsTruncatedInput) {
+  auto encoded = TakeoverData::compactEncodeInodeMap(makeTestInodeMap());
+  encoded.resize(encoded.size() / 2);
+  EXPECT_THROW(
+      TakeoverData::compactDecodeInodeMap(encoded), std::runtime_error);
+}
+
+TEST(Takeover, compactInodeTable) {
+  // Both sides support the compact inode table, so the negotiated protocol
+  // sends the delta-encoded form over the wire.
+  takeoverWithInodeMapImpl(kSupportedCapabilities, kSupportedCapabilities);
+}
+
+TEST(Takeover, compactInodeTableOneSided) {
+  // If only one side supports the compact inode table, capability matching
+  // must negotiate it away and the full struct form is sent instead.
+  const auto kNoCompactCapabilities = kSupportedCapabilities &
+      ~static_cast<uint64_t>(TakeoverCapabilities::COMPACT_INODE_TABLE);
+  takeoverWithInodeMapImpl(kNoCompactCapabilities, kSupportedCapabilities);
+  takeoverWithInodeMapImpl(kSupportedCapabilities, kNoCompactCapabilities);
+}
+
 TEST(Takeover, atypicalVersionCapability) {
   simpleTestImpl(
       CheckMountdSocket::YES,
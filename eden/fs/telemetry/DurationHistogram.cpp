@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/telemetry/DurationHistogram.h"
+
+#include <folly/lang/Bits.h>
+
+#include <algorithm>
+
+namespace facebook::eden {
+
+void DurationHistogram::record(std::chrono::microseconds duration) noexcept {
+  auto us = duration.count();
+  // findLastSet returns the 1-based index of the most significant set bit,
+  // and 0 for 0, which maps [2^(i-1), 2^i) to bucket i and 0us to bucket 0.
+  size_t index = us <= 0
+      ? 0
+      : std::min(
+            kBucketCount - 1,
+            static_cast<size_t>(
+                folly::findLastSet(static_cast<uint64_t>(us))));
+  buckets_[index].fetch_add(1, std::memory_order_relaxed);
+}
+
+std::vector<uint64_t> DurationHistogram::snapshot() const {
+  std::vector<uint64_t> result;
+  result.reserve(kBucketCount);
+  for (auto& bucket : buckets_) {
+    result.push_back(bucket.load(std::memory_order_relaxed));
+  }
+  return result;
+}
+
+uint64_t DurationHistogram::bucketLowerBoundUs(size_t index) {
+  return index == 0 ? 0 : uint64_t(1) << (index - 1);
+}
+
+} // namespace facebook::eden
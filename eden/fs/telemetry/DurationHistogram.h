@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include "eden/fs/utils/ProcessAccessLog.h"
+
+namespace facebook::eden {
+
+/**
+ * A fixed-size, log-scale latency histogram with lock-free recording.
+ *
+ * Unlike the fb303 quantile stats in EdenStats, which aggregate process-wide,
+ * a DurationHistogram is a plain value type that can be instantiated per
+ * mount. Buckets are powers of two in microseconds, so there are ten buckets
+ * of sub-millisecond resolution before the 1ms mark.
+ *
+ * record() is two relaxed atomic increments and may be called concurrently
+ * from any thread. snapshot() reads the counters without synchronization;
+ * since buckets are monotonically increasing counters, a point-in-time
+ * snapshot is always internally consistent enough for rate computation by a
+ * periodic poller.
+ */
+class DurationHistogram {
+ public:
+  /**
+   * Bucket i counts durations in [2^(i-1), 2^i) microseconds; bucket 0
+   * counts sub-microsecond durations, and the last bucket absorbs
+   * everything from ~17 seconds up.
+   */
+  static constexpr size_t kBucketCount = 26;
+
+  void record(std::chrono::microseconds duration) noexcept;
+
+  /**
+   * Returns a point-in-time copy of the bucket counters.
+   */
+  std::vector<uint64_t> snapshot() const;
+
+  /**
+   * Returns the inclusive lower bound, in microseconds, of the given bucket.
+   */
+  static uint64_t bucketLowerBoundUs(size_t index);
+
+ private:
+  std::array<std::atomic<uint64_t>, kBucketCount> buckets_{};
+};
+
+/**
+ * The per-mount latency histograms kept by an FsChannel, one per access
+ * family. FUSE and NFS categorize each opcode as read, write, or other; the
+ * channel's handler tables already record that categorization for
+ * ProcessAccessLog, and the same one is used here.
+ */
+struct FsLatencyHistograms {
+  DurationHistogram read;
+  DurationHistogram write;
+  DurationHistogram other;
+
+  DurationHistogram& forAccessType(ProcessAccessLog::AccessType type) {
+    switch (type) {
+      case ProcessAccessLog::AccessType::FsChannelRead:
+        return read;
+      case ProcessAccessLog::AccessType::FsChannelWrite:
+        return write;
+      default:
+        return other;
+    }
+  }
+};
+
+} // namespace facebook::eden
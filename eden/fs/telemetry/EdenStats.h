@@ -26,9 +26,11 @@ struct LocalStoreStats;
 struct HgBackingStoreStats;
 struct HgImporterStats;
 struct JournalStats;
+struct CheckoutStats;
 struct ThriftStats;
 struct TelemetryStats;
 struct OverlayStats;
+struct TreeInodeStats;
 struct InodeMapStats;
 struct InodeMetadataTableStats;
 
@@ -123,9 +125,11 @@ class EdenStats : public RefCounted {
   ThreadLocal<HgBackingStoreStats> hgBackingStoreStats_;
   ThreadLocal<HgImporterStats> hgImporterStats_;
   ThreadLocal<JournalStats> journalStats_;
+  ThreadLocal<CheckoutStats> checkoutStats_;
   ThreadLocal<ThriftStats> thriftStats_;
   ThreadLocal<TelemetryStats> telemetryStats_;
   ThreadLocal<OverlayStats> overlayStats_;
+  ThreadLocal<TreeInodeStats> treeInodeStats_;
   ThreadLocal<InodeMapStats> inodeMapStats_;
   ThreadLocal<InodeMetadataTableStats> inodeMetadataTableStats_;
 };
@@ -174,6 +178,11 @@ inline JournalStats& EdenStats::getStatsForCurrentThread<JournalStats>() {
   return *journalStats_.get();
 }
 
+template <>
+inline CheckoutStats& EdenStats::getStatsForCurrentThread<CheckoutStats>() {
+  return *checkoutStats_.get();
+}
+
 template <>
 inline ThriftStats& EdenStats::getStatsForCurrentThread<ThriftStats>() {
   return *thriftStats_.get();
@@ -189,6 +198,11 @@ inline OverlayStats& EdenStats::getStatsForCurrentThread<OverlayStats>() {
   return *overlayStats_.get();
 }
 
+template <>
+inline TreeInodeStats& EdenStats::getStatsForCurrentThread<TreeInodeStats>() {
+  return *treeInodeStats_.get();
+}
+
 template <>
 inline InodeMapStats& EdenStats::getStatsForCurrentThread<InodeMapStats>() {
   return *inodeMapStats_.get();
@@ -247,6 +261,8 @@ struct FuseStats : StatsGroup<FuseStats> {
   Duration poll{"fuse.poll_us"};
   Duration forgetmulti{"fuse.forgetmulti_us"};
   Duration fallocate{"fuse.fallocate_us"};
+
+  Counter invalidationsDeduplicated{"fuse.invalidations_deduplicated"};
 };
 
 struct NfsStats : StatsGroup<NfsStats> {
@@ -309,6 +325,8 @@ struct ObjectStoreStats : StatsGroup<ObjectStoreStats> {
   Duration getBlobMetadata{"store.get_blob_metadata_us"};
 
   Counter getBlobFromMemory{"object_store.get_blob.memory"};
+  Counter getBlobFromCompressedMemory{
+      "object_store.get_blob.compressed_memory"};
   Counter getBlobFromLocalStore{"object_store.get_blob.local_store"};
   Counter getBlobFromBackingStore{"object_store.get_blob.backing_store"};
 
@@ -324,6 +342,8 @@ struct ObjectStoreStats : StatsGroup<ObjectStoreStats> {
   Counter getLocalBlobMetadataFromBackingStore{
       "object_store.get_blob_metadata.backing_store_cache"};
   Counter getBlobMetadataFromBlob{"object_store.get_blob_metadata.blob"};
+  Counter getBlobMetadataFromAuxMissCache{
+      "object_store.get_blob_metadata.aux_miss_cache"};
   Counter getBlobMetadataFailed{"object_store.get_blob_metadata_failed"};
 };
 
@@ -353,6 +373,8 @@ struct LocalStoreStats : StatsGroup<LocalStoreStats> {
 struct HgBackingStoreStats : StatsGroup<HgBackingStoreStats> {
   Duration getTree{"store.hg.get_tree_us"};
   Duration fetchTree{"store.hg.fetch_tree_us"};
+  Counter hedgedTreeImport{"store.hg.hedged_tree_import"};
+  Counter hedgedTreeImportWin{"store.hg.hedged_tree_import_win"};
   Duration importTreeDuration{"store.hg.import_tree_us"};
   Counter importTreeSuccess{"store.hg.import_tree_success"};
   Counter importTreeFailure{"store.hg.import_tree_failure"};
@@ -382,11 +404,25 @@ struct HgImporterStats : StatsGroup<HgImporterStats> {
 struct JournalStats : StatsGroup<JournalStats> {
   Counter truncatedReads{"journal.truncated_reads"};
   Counter filesAccumulated{"journal.files_accumulated"};
+  Counter subscriberNotificationsDelivered{
+      "journal.subscriber_notifications_delivered"};
+  Counter slowSubscriberDeliveries{"journal.slow_subscriber_deliveries"};
+};
+
+struct CheckoutStats : StatsGroup<CheckoutStats> {
+  Duration invalidationFlush{"checkout.invalidation_flush_us"};
 };
 
 struct ThriftStats : StatsGroup<ThriftStats> {
   Duration streamChangesSince{
       "thrift.StreamingEdenService.streamChangesSince.streaming_time_us"};
+
+  Duration streamSelectedChangesSince{
+      "thrift.StreamingEdenService.streamSelectedChangesSince"
+      ".streaming_time_us"};
+
+  Counter requestCollapseHit{"thrift.request_collapse_hit"};
+  Counter requestCollapseMiss{"thrift.request_collapse_miss"};
 };
 
 struct TelemetryStats : StatsGroup<TelemetryStats> {
@@ -406,6 +442,20 @@ struct OverlayStats : StatsGroup<OverlayStats> {
   Duration renameChild{"overlay.rename_child_us"};
   Counter loadOverlayDirHit{"overlay.load_overlay_dir_hit"};
   Counter loadOverlayDirMiss{"overlay.load_overlay_dir_miss"};
+  Duration gcTreeCollection{"overlay.gc_tree_collection_us"};
+  Counter gcInodesReclaimed{"overlay.gc_inodes_reclaimed"};
+};
+
+struct TreeInodeStats : StatsGroup<TreeInodeStats> {
+  /**
+   * Child lookups by name in TreeInode::getOrFindChild. Comparing
+   * lookup_child_not_found against lookup_child shows how ENOENT-heavy a
+   * mount's lookup traffic is; a miss is resolved entirely from the
+   * in-memory DirContents, so a high ratio is not itself a problem unless
+   * the raw rate is high too.
+   */
+  Counter lookupChild{"tree_inode.lookup_child"};
+  Counter lookupChildNotFound{"tree_inode.lookup_child_not_found"};
 };
 
 struct InodeMapStats : StatsGroup<InodeMapStats> {
@@ -414,6 +464,8 @@ struct InodeMapStats : StatsGroup<InodeMapStats> {
   Counter lookupTreeInodeMiss{"inode_map.lookup_tree_inode_miss"};
   Counter lookupBlobInodeMiss{"inode_map.lookup_blob_inode_miss"};
   Counter lookupInodeError{"inode_map.lookup_inode_error"};
+  Duration periodicUnloadScan{"inode_map.periodic_unload_scan_us"};
+  Counter periodicUnloadCount{"inode_map.periodic_unload_count"};
 };
 
 struct InodeMetadataTableStats : StatsGroup<InodeMetadataTableStats> {
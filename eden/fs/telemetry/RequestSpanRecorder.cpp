@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/telemetry/RequestSpanRecorder.h"
+
+namespace facebook::eden {
+
+SlowRequestTraceBuffer& SlowRequestTraceBuffer::get() {
+  // Intentionally leaked: requests may complete during shutdown after static
+  // destructors have begun.
+  static SlowRequestTraceBuffer* instance = new SlowRequestTraceBuffer();
+  return *instance;
+}
+
+void SlowRequestTraceBuffer::configure(std::chrono::nanoseconds threshold) {
+  thresholdNs_.store(threshold.count(), std::memory_order_release);
+}
+
+void SlowRequestTraceBuffer::add(Trace trace) {
+  auto traces = traces_.wlock();
+  if (traces->size() >= kCapacity) {
+    traces->pop_front();
+  }
+  traces->push_back(std::move(trace));
+}
+
+std::vector<SlowRequestTraceBuffer::Trace> SlowRequestTraceBuffer::getTraces()
+    const {
+  auto traces = traces_.rlock();
+  return std::vector<Trace>{traces->begin(), traces->end()};
+}
+
+} // namespace facebook::eden
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include <folly/Synchronized.h>
+
+namespace facebook::eden {
+
+/**
+ * Records the critical path of a single filesystem request as a sequence of
+ * named stages with offsets from the request's start, so one slow open() can
+ * be decomposed after the fact into dispatch, object store probe, backing
+ * fetch, and reply time.
+ *
+ * A recorder is attached to a RequestContext when slow-request tracing is
+ * enabled and stages may be added from whichever thread the request is
+ * currently executing on.
+ */
+class RequestSpanRecorder {
+ public:
+  struct Stage {
+    std::string name;
+    /** Offset from the start of the request. */
+    std::chrono::nanoseconds offset;
+  };
+
+  RequestSpanRecorder() : start_{std::chrono::steady_clock::now()} {}
+
+  void addStage(std::string name) {
+    auto offset = std::chrono::steady_clock::now() - start_;
+    stages_.wlock()->push_back(Stage{std::move(name), offset});
+  }
+
+  std::chrono::nanoseconds elapsed() const {
+    return std::chrono::steady_clock::now() - start_;
+  }
+
+  std::vector<Stage> extractStages() {
+    return std::move(*stages_.wlock());
+  }
+
+ private:
+  const std::chrono::steady_clock::time_point start_;
+  folly::Synchronized<std::vector<Stage>> stages_;
+};
+
+/**
+ * Process-wide ring buffer of completed slow-request traces.
+ *
+ * Requests whose total latency meets the configured threshold deposit their
+ * span recorder's stages here when they complete; the most recent traces are
+ * retained and can be fetched via the debugGetSlowRequestTraces thrift call.
+ * A threshold of zero disables tracing entirely, in which case requests do
+ * not allocate recorders at all.
+ */
+class SlowRequestTraceBuffer {
+ public:
+  struct Trace {
+    /** Wall clock time at which the request completed. */
+    std::chrono::system_clock::time_point completedAt;
+    /** The channel opcode name, e.g. "FUSE_OPEN" or "GETATTR". */
+    std::string opName;
+    std::chrono::nanoseconds duration;
+    std::vector<RequestSpanRecorder::Stage> stages;
+  };
+
+  static SlowRequestTraceBuffer& get();
+
+  bool isEnabled() const {
+    return thresholdNs_.load(std::memory_order_acquire) != 0;
+  }
+
+  std::chrono::nanoseconds threshold() const {
+    return std::chrono::nanoseconds{
+        thresholdNs_.load(std::memory_order_acquire)};
+  }
+
+  /**
+   * Sets the latency threshold above which completed requests are retained.
+   * Zero disables tracing.
+   */
+  void configure(std::chrono::nanoseconds threshold);
+
+  void add(Trace trace);
+
+  /**
+   * Returns the retained traces, oldest first.
+   */
+  std::vector<Trace> getTraces() const;
+
+ private:
+  static constexpr size_t kCapacity = 256;
+
+  std::atomic<std::chrono::nanoseconds::rep> thresholdNs_{0};
+  folly::Synchronized<std::deque<Trace>> traces_;
+};
+
+} // namespace facebook::eden
@@ -7,9 +7,12 @@
 
 #include "eden/fs/telemetry/TaskTrace.h"
 
+#include <folly/FileUtil.h>
+#include <folly/portability/Time.h>
 #include <folly/system/ThreadId.h>
 #include <folly/system/ThreadName.h>
 #include <chrono>
+#include <cstdio>
 
 namespace facebook::eden {
 
@@ -17,6 +20,42 @@ namespace {
 void publish(TaskTraceEvent&& event) {
   TaskTraceEvent::getTraceBus()->publish(std::move(event));
 }
+
+/**
+ * Nanoseconds this thread has spent executing on a CPU. The difference
+ * between two samples bounds how much of a wall-clock interval was spent
+ * off-CPU (blocked or waiting to be scheduled).
+ */
+uint64_t threadCpuNs() {
+  timespec ts{};
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) {
+    return 0;
+  }
+  return uint64_t(ts.tv_sec) * 1000000000 + uint64_t(ts.tv_nsec);
+}
+
+/**
+ * Nanoseconds this thread has spent runnable but waiting on the kernel run
+ * queue. Only available on Linux when CONFIG_SCHEDSTATS is enabled; returns
+ * zero elsewhere.
+ */
+uint64_t threadRunqueueWaitNs() {
+#ifdef __linux__
+  // Format: "<ran ns> <runqueue wait ns> <timeslice count>"
+  std::string contents;
+  if (!folly::readFile("/proc/thread-self/schedstat", contents)) {
+    return 0;
+  }
+  unsigned long long ranNs = 0;
+  unsigned long long waitNs = 0;
+  if (sscanf(contents.c_str(), "%llu %llu", &ranNs, &waitNs) != 2) {
+    return 0;
+  }
+  return waitNs;
+#else
+  return 0;
+#endif
+}
 } // namespace
 
 const std::shared_ptr<TraceBus<TaskTraceEvent>>& TaskTraceEvent::getTraceBus() {
@@ -33,6 +72,8 @@ TaskTraceBlock::TaskTraceBlock(std::string_view task) {
     threadName = folly::getCurrentThreadName().value_or("<unknown>");
     threadId = folly::getOSThreadID();
     start = std::chrono::steady_clock::now();
+    startOnCpuNs = threadCpuNs();
+    startRunqueueWaitNs = threadRunqueueWaitNs();
   }
 }
 
@@ -43,12 +84,18 @@ TaskTraceBlock::~TaskTraceBlock() {
 
   auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
       std::chrono::steady_clock::now() - start);
+  auto onCpuNs = threadCpuNs() - startOnCpuNs;
+  auto runqueueWaitNs = threadRunqueueWaitNs() - startRunqueueWaitNs;
   publish(TaskTraceEvent(
       name,
       threadName,
       threadId,
       elapsed,
       std::chrono::duration_cast<std::chrono::microseconds>(
-          start.time_since_epoch())));
+          start.time_since_epoch()),
+      std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::nanoseconds(onCpuNs)),
+      std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::nanoseconds(runqueueWaitNs))));
 }
 } // namespace facebook::eden
@@ -21,18 +21,28 @@ struct TaskTraceEvent : TraceEventBase {
   uint64_t threadId;
   std::chrono::microseconds duration;
   std::chrono::microseconds start;
+  // How much of `duration` the thread actually spent running on a CPU.
+  // `duration - onCpu` is time the task was blocked or preempted.
+  std::chrono::microseconds onCpu;
+  // How long the thread sat runnable on the kernel run queue during the
+  // task. Only available on Linux (/proc schedstat); zero elsewhere.
+  std::chrono::microseconds runqueueWait;
 
   TaskTraceEvent(
       std::string_view name,
       std::string threadName,
       uint64_t threadId,
       std::chrono::microseconds duration,
-      std::chrono::microseconds start)
+      std::chrono::microseconds start,
+      std::chrono::microseconds onCpu,
+      std::chrono::microseconds runqueueWait)
       : name(name),
         threadName(std::move(threadName)),
         threadId(threadId),
         duration(duration),
-        start(start) {}
+        start(start),
+        onCpu(onCpu),
+        runqueueWait(runqueueWait) {}
 
   static const std::shared_ptr<TraceBus<TaskTraceEvent>>& getTraceBus();
 };
@@ -42,6 +52,8 @@ struct TaskTraceBlock {
   std::string threadName;
   uint64_t threadId{0};
   std::chrono::steady_clock::time_point start;
+  uint64_t startOnCpuNs{0};
+  uint64_t startRunqueueWaitNs{0};
 
   template <size_t size>
   explicit TaskTraceBlock(const char (&name)[size])
@@ -23,12 +23,12 @@ TraceBus<TraceEvent>::TraceBus(
     PrivateConstructorTag,
     std::string name,
     size_t bufferCapacity)
-    : name_{std::move(name)}, bufferCapacity_{bufferCapacity} {
+    : name_{std::move(name)},
+      bufferCapacity_{bufferCapacity},
+      queue_{bufferCapacity} {
   XCHECK_GT(bufferCapacity_, 0u) << "Buffer capacity must not be zero";
 
-  state_.unsafeGetUnlocked().writeBuffer.reserve(bufferCapacity_);
-
-  // Allocate the backbuffer here rather than in the thread so std::bad_alloc
+  // Allocate the read buffer here rather than in the thread so std::bad_alloc
   // can be caught.
   std::vector<TraceEvent> readBuffer;
   readBuffer.reserve(bufferCapacity);
@@ -45,10 +45,15 @@ TraceBus<TraceEvent>::TraceBus(
 
 template <typename TraceEvent>
 TraceBus<TraceEvent>::~TraceBus() {
-  state_.lock()->done = true;
-  emptyCV_.notify_one();
+  done_.store(true, std::memory_order_release);
+  sem_.post();
   thread_.join();
 
+  if (auto dropped = droppedEvents_.load(std::memory_order_relaxed)) {
+    XLOG(WARN) << "TraceBus(" << name_ << ") dropped " << dropped
+               << " events because subscribers could not keep up";
+  }
+
   auto& state = state_.unsafeGetUnlocked();
   auto* p = state.subscriptions;
   while (p) {
@@ -63,25 +68,21 @@ template <typename... Args>
 void TraceBus<TraceEvent>::publish(Args&&... args) noexcept {
   static_assert(std::is_nothrow_constructible_v<TraceEvent, Args&&...>);
 
-  bool wake;
-  {
-    auto state = state_.lock();
-    XCHECK(!state->done) << "Illegal to publish concurrently with destruction";
-    if (state->writeBuffer.size() == bufferCapacity_) {
-      // If the buffer is full then the capacity is potentially set too low. Log
-      // an appropriate warning and then block until we have room to append the
-      // current event.
-      logFullOnce();
-      fullCV_.wait(state.as_lock(), [&] {
-        return state->writeBuffer.size() < bufferCapacity_;
-      });
-    }
-    wake = state->writeBuffer.empty();
-    state->writeBuffer.emplace_back(std::forward<Args>(args)...);
-    state->sequenceNumber++;
-  }
-  if (wake) {
-    emptyCV_.notify_one();
+  XDCHECK(!done_.load(std::memory_order_relaxed))
+      << "Illegal to publish concurrently with destruction";
+
+  if (queue_.write(std::optional<TraceEvent>{
+          std::in_place, std::forward<Args>(args)...})) {
+    // The queue write must happen before the sequence number increment: see
+    // the comment on sequenceNumber_.
+    sequenceNumber_.fetch_add(1, std::memory_order_acq_rel);
+    sem_.post();
+  } else {
+    // Subscribers cannot keep up. Drop the event rather than blocking the
+    // publisher, which may be a latency-sensitive dispatcher thread.
+    sequenceNumber_.fetch_add(1, std::memory_order_acq_rel);
+    droppedEvents_.fetch_add(1, std::memory_order_relaxed);
+    logFullOnce();
   }
 }
 
@@ -103,8 +104,9 @@ void TraceBus<TraceEvent>::unsubscribe(void* subscription) noexcept {
   auto* sub = static_cast<Subscription*>(subscription);
 
   auto state = state_.lock();
-  // Signal to threadLoop that `sub` should be deleted.
-  sub->unsubscribe = state->sequenceNumber;
+  // Signal to threadLoop that `sub` should be deleted once it has observed
+  // this many published events.
+  sub->unsubscribe = sequenceNumber_.load(std::memory_order_acquire);
 
   // At this point, the memory referenced by `sub` must not be accessed as it
   // may be deleted at any moment.
@@ -114,12 +116,13 @@ template <typename TraceEvent>
 void TraceBus<TraceEvent>::logFullOnce() noexcept {
   folly::call_once(logIfFullFlag_, [&]() noexcept {
     try {
-      XLOG(WARN) << "TraceBus(" << name_ << ") is full; blocking. Is capacity "
+      XLOG(WARN) << "TraceBus(" << name_
+                 << ") is full; dropping events. Is capacity "
                  << bufferCapacity_ << " sufficient?";
     } catch (std::exception& e) {
       fprintf(
           stderr,
-          "TraceBus(%s) is full; blocking. Is capacity %" PRIu64
+          "TraceBus(%s) is full; dropping events. Is capacity %" PRIu64
           "sufficient?\n"
           "Logging failed with %s\n",
           name_.c_str(),
@@ -133,15 +136,11 @@ void TraceBus<TraceEvent>::logFullOnce() noexcept {
 template <typename TraceEvent>
 void TraceBus<TraceEvent>::threadLoop(
     std::vector<TraceEvent>& readBuffer) noexcept {
-  // This function does no allocation and throws no exceptions.
-
-  bool done = false;
   uint64_t lastObservedSequenceNumber = 0;
-  while (!done) {
+  while (true) {
     XCHECK(readBuffer.empty())
         << "Avoid waiting while holding references to things";
 
-    Subscription* head;
     {
       auto state = state_.lock();
 
@@ -169,33 +168,35 @@ void TraceBus<TraceEvent>::threadLoop(
         p = next;
       }
 
-      // TODO: If it were safe to access Subscription::unsubscribe when the lock
-      // weren't held, it would be possible to check the unsubscribe sequence
-      // number in the event iteration loop below and short-circuit observation
-      // of events published after unsubscription.
-      //
-      // This probably isn't important.
-      lastObservedSequenceNumber = state->sequenceNumber;
-
       if (state->subscriptions == nullptr) {
         hasSubscription_.store(false, std::memory_order_release);
       }
+    }
 
-      // If no events are buffered, sleep until events are delivered or we are
-      // signaled to terminate.
-      emptyCV_.wait(state.as_lock(), [&] {
-        return state->done || !state->writeBuffer.empty();
-      });
-      std::swap(state->writeBuffer, readBuffer);
-      done = state->done;
+    // Sleep until at least one event has been published or the destructor
+    // asks us to stop.
+    sem_.wait();
+    // Consume any additional posts. Every consumed post had its event
+    // enqueued before the post, so the drain below will pick them all up.
+    while (sem_.try_wait()) {
+    }
 
-      head = state->subscriptions;
+    const bool done = done_.load(std::memory_order_acquire);
+
+    // Every event counted by this load has already been written to the queue
+    // (or dropped), so the drain below observes all of them.
+    const uint64_t sequenceSnapshot =
+        sequenceNumber_.load(std::memory_order_acquire);
+
+    std::optional<TraceEvent> event;
+    while (queue_.read(event)) {
+      readBuffer.push_back(std::move(*event));
     }
 
-    // If the publish buffer filled, it's possible a publisher is waiting for
-    // space, so wake them.
-    if (readBuffer.size() == bufferCapacity_) {
-      fullCV_.notify_all();
+    Subscription* head;
+    {
+      auto state = state_.lock();
+      head = state->subscriptions;
     }
 
     for (auto* sub = head; sub; sub = sub->next) {
@@ -213,7 +214,14 @@ void TraceBus<TraceEvent>::threadLoop(
       }
     }
 
+    lastObservedSequenceNumber = sequenceSnapshot;
     readBuffer.clear();
+
+    if (done) {
+      // All events published before destruction began have been drained and
+      // observed, so it is safe to exit.
+      return;
+    }
   }
 }
 
@@ -7,11 +7,15 @@
 
 #pragma once
 
+#include <folly/MPMCQueue.h>
 #include <folly/Synchronized.h>
 #include <folly/synchronization/CallOnce.h>
+#include <folly/synchronization/LifoSem.h>
 #include <stdint.h>
+#include <atomic>
 #include <chrono>
 #include <memory>
+#include <optional>
 #include <thread>
 #include <utility>
 
@@ -137,25 +141,20 @@ class TraceSubscriptionHandle {
 };
 
 /**
- * TraceBus is a reliable, fixed-capacity event trace that runs subscription
- * callbacks on a background thread. It is intended for lightweight telemetry
- * computation: if the subscriptions perform heavy computation and events are
- * submitted more frequently than they're processed, publish() will block.
+ * TraceBus is a fixed-capacity event trace that runs subscription callbacks
+ * on a background thread. It is intended for lightweight telemetry
+ * computation on hot paths: publish() never blocks and never takes a lock,
+ * so it is safe to publish from latency-sensitive dispatch code even while
+ * subscribers are attached.
  *
- * Note: this blocking behavior then waits for subscribers to finish processing
- * events, and if any locks are held that are subsequently attempted to be
- * acquired by a tracebus subscriber, this can cause a deadlock. As a general
- * rule one should try to avoid publishing to tracebus while holding any locks
- * and should be very careful when subscribers attempt to acquire locks.
+ * If events are submitted faster than subscribers can process them and the
+ * queue fills up, further events are dropped rather than blocking the
+ * publisher. Drops are counted and can be queried with droppedEventCount().
  *
  * The capacity should be selected based on the expected usage in context.
- * Memory usage will be capacity * sizeof(TraceEvent) * 2, but a capacity too
- * small will block publishers. The buffer is not intended to prevent all
- * publishers from blocking, but to absorb latency in the case that subscribers
- * briefly cannot keep up.
- *
- * Ideally, capacity would be dynamically determined with algorithms similar to
- * network protocols, but a small fixed-size buffer should be sufficient.
+ * Memory usage will be roughly capacity * sizeof(TraceEvent) * 2, but a
+ * capacity too small will drop events whenever subscribers briefly cannot
+ * keep up.
  */
 template <typename TraceEvent>
 class TraceBus : public std::enable_shared_from_this<TraceBus<TraceEvent>> {
@@ -192,13 +191,21 @@ class TraceBus : public std::enable_shared_from_this<TraceBus<TraceEvent>> {
 
   /**
    * Publishes an event into the trace queue. The constructor must not throw.
-   * Also, do not publish() while holding any locks that might be acquired by a
-   * subscriber. This may cause deadlock if TraceBus capacity is reached, as
-   * publish() will block until subscribers can finish.
+   *
+   * Never blocks and never takes a lock: if the queue is full because
+   * subscribers cannot keep up, the event is dropped and counted in
+   * droppedEventCount().
    */
   template <typename... Args>
   void publish(Args&&... event) noexcept;
 
+  /**
+   * Total number of events dropped so far because the queue was full.
+   */
+  uint64_t droppedEventCount() const noexcept {
+    return droppedEvents_.load(std::memory_order_relaxed);
+  }
+
   /**
    * Subscribe to published events. If the subscriber throws, it will
    * automatically be unsubscribed.
@@ -265,8 +272,8 @@ class TraceBus : public std::enable_shared_from_this<TraceBus<TraceEvent>> {
     bool hasThrownException = false;
 
     // If nonzero, unsubscription has been requested after the corresponding
-    // sequenceNumber events have been observed. Only written or read while the
-    // lock is held.
+    // number of published events have been observed. Only written or read
+    // while the lock is held.
     uint64_t unsubscribe = 0;
 
     // Subscriptions form a linked list. Subscriptions insert to the head of the
@@ -278,22 +285,31 @@ class TraceBus : public std::enable_shared_from_this<TraceBus<TraceEvent>> {
   };
 
   struct State {
-    bool done = false;
     Subscription* subscriptions = nullptr;
-    std::vector<TraceEvent> writeBuffer;
-    // Incremented every publish()
-    uint64_t sequenceNumber = 1;
   };
 
   const std::string name_;
   const size_t bufferCapacity_;
 
+  // The subscription list is the only state behind a lock; publish() touches
+  // none of it.
   folly::Synchronized<State, std::mutex> state_;
   std::atomic_bool hasSubscription_{false};
-  // Encodes the condition done || !writeBuffer.empty()
-  std::condition_variable emptyCV_;
-  // Encodes the condition writeBuffer.size() < bufferCapacity_
-  std::condition_variable fullCV_;
+
+  // Published events. The optional wrapper gives the background thread a
+  // default-constructible slot to read into without requiring TraceEvent to
+  // be default constructible.
+  folly::MPMCQueue<std::optional<TraceEvent>> queue_;
+  // Posted once per publish() so the background thread can sleep while the
+  // queue is empty.
+  folly::LifoSem sem_;
+  // Incremented every publish(), including dropped events. The queue write
+  // always happens before the increment, so once the background thread reads
+  // a value here, every event counted by it is visible in the queue (or was
+  // dropped).
+  std::atomic<uint64_t> sequenceNumber_{1};
+  std::atomic<uint64_t> droppedEvents_{0};
+  std::atomic<bool> done_{false};
   folly::once_flag logIfFullFlag_;
   std::thread thread_;
 
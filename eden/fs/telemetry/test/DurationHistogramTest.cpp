@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/telemetry/DurationHistogram.h"
+
+#include <folly/portability/GTest.h>
+
+using namespace facebook::eden;
+using namespace std::literals::chrono_literals;
+
+TEST(DurationHistogram, buckets_durations_by_power_of_two) {
+  DurationHistogram histogram;
+  histogram.record(0us);
+  histogram.record(1us);
+  histogram.record(2us);
+  histogram.record(3us);
+  histogram.record(1000us);
+
+  auto counts = histogram.snapshot();
+  EXPECT_EQ(1, counts[0]);
+  EXPECT_EQ(1, counts[1]);
+  EXPECT_EQ(2, counts[2]);
+  // 1000us lands in [512us, 1024us).
+  EXPECT_EQ(1, counts[10]);
+}
+
+TEST(DurationHistogram, huge_durations_land_in_last_bucket) {
+  DurationHistogram histogram;
+  histogram.record(std::chrono::hours{1});
+  auto counts = histogram.snapshot();
+  EXPECT_EQ(1, counts[DurationHistogram::kBucketCount - 1]);
+}
+
+TEST(DurationHistogram, bucket_lower_bounds) {
+  EXPECT_EQ(0, DurationHistogram::bucketLowerBoundUs(0));
+  EXPECT_EQ(1, DurationHistogram::bucketLowerBoundUs(1));
+  EXPECT_EQ(512, DurationHistogram::bucketLowerBoundUs(10));
+}
+
+TEST(DurationHistogram, sub_millisecond_resolution) {
+  // The collector relies on ten distinct buckets below 1ms.
+  DurationHistogram histogram;
+  for (uint64_t us = 1; us < 1024; us *= 2) {
+    histogram.record(std::chrono::microseconds{us});
+  }
+  auto counts = histogram.snapshot();
+  for (size_t i = 1; i <= 10; ++i) {
+    EXPECT_EQ(1, counts[i]) << "bucket " << i;
+  }
+}
@@ -25,6 +25,31 @@ TEST(TaskTraceTest, subscription) {
   EXPECT_EQ("hello", std::move(future).get(1000ms));
 }
 
+TEST(TaskTraceTest, onCpuAccounting) {
+  auto bus = TaskTraceEvent::getTraceBus();
+  folly::Promise<TaskTraceEvent> promise;
+  auto future = promise.getFuture();
+  auto handle = bus->subscribeFunction("sub", [&](TaskTraceEvent event) {
+    promise.setValue(std::move(event));
+  });
+
+  {
+    TaskTraceBlock block{"busy"};
+    // Burn a little CPU so the thread time clock has a chance to advance.
+    volatile uint64_t sink = 0;
+    auto deadline = std::chrono::steady_clock::now() + 5ms;
+    while (std::chrono::steady_clock::now() < deadline) {
+      sink += 1;
+    }
+  }
+
+  auto event = std::move(future).get(1000ms);
+  EXPECT_GT(event.onCpu.count(), 0);
+  // The thread cannot have run longer than the task's wall-clock duration.
+  // Allow a little slack since the two clocks are sampled separately.
+  EXPECT_LE(event.onCpu, event.duration + 1ms);
+}
+
 // When there is no subscriber active, the block should not collect environment
 // information nor send the event to TraceBus.
 TEST(TaskTraceTest, noSubscriber) {
@@ -30,8 +30,9 @@ TEST(TraceBusTest, publish_reaches_subscriber) {
   EXPECT_EQ(1234, std::move(future).get(1000ms));
 }
 
-TEST(TraceBusTest, publishes_exceed_capacity) {
+TEST(TraceBusTest, publishes_exceeding_capacity_drop_rather_than_block) {
   std::vector<int> values;
+  uint64_t dropped = 0;
   {
     auto bus = TraceBus<int>::create("bus", 1);
     auto handle =
@@ -40,11 +41,15 @@ TEST(TraceBusTest, publishes_exceed_capacity) {
     for (int i = 0; i < 100; ++i) {
       bus->publish(i);
     }
+    dropped = bus->droppedEventCount();
   }
 
-  XCHECK_EQ(100ul, values.size());
-  for (int i = 0; i < 100; ++i) {
-    XCHECK_EQ(i, values[i]);
+  // Every event is either observed or counted as dropped, and the observed
+  // events arrive in publish order.
+  XCHECK_EQ(100ul, values.size() + dropped);
+  XCHECK_GE(values.size(), 1ul);
+  for (size_t i = 1; i < values.size(); ++i) {
+    XCHECK_LT(values[i - 1], values[i]);
   }
 }
 
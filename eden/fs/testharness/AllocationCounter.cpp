@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/testharness/AllocationCounter.h"
+
+#ifndef _WIN32
+
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+thread_local size_t threadAllocationCount{0};
+
+void* countedAlloc(std::size_t size) noexcept {
+  ++threadAllocationCount;
+  return std::malloc(size ? size : 1);
+}
+
+void* countedAlignedAlloc(std::size_t size, std::size_t align) noexcept {
+  ++threadAllocationCount;
+  if (align < sizeof(void*)) {
+    align = sizeof(void*);
+  }
+  void* result = nullptr;
+  if (posix_memalign(&result, align, size ? size : 1) != 0) {
+    return nullptr;
+  }
+  return result;
+}
+
+} // namespace
+
+namespace facebook::eden {
+
+AllocationCounterScope::AllocationCounterScope()
+    : startCount_{threadAllocationCount} {}
+
+size_t AllocationCounterScope::count() const {
+  return threadAllocationCount - startCount_;
+}
+
+} // namespace facebook::eden
+
+// Counting replacements for the global allocation functions. They live in
+// the same translation unit as AllocationCounterScope so that linking any
+// test that uses the scope also pulls in the replacements; a test binary
+// that doesn't reference the scope is left entirely alone.
+
+void* operator new(std::size_t size) {
+  if (void* result = countedAlloc(size)) {
+    return result;
+  }
+  throw std::bad_alloc{};
+}
+
+void* operator new[](std::size_t size) {
+  if (void* result = countedAlloc(size)) {
+    return result;
+  }
+  throw std::bad_alloc{};
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+  return countedAlloc(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+  return countedAlloc(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t align) {
+  if (void* result =
+          countedAlignedAlloc(size, static_cast<std::size_t>(align))) {
+    return result;
+  }
+  throw std::bad_alloc{};
+}
+
+void* operator new[](std::size_t size, std::align_val_t align) {
+  if (void* result =
+          countedAlignedAlloc(size, static_cast<std::size_t>(align))) {
+    return result;
+  }
+  throw std::bad_alloc{};
+}
+
+void* operator new(
+    std::size_t size,
+    std::align_val_t align,
+    const std::nothrow_t&) noexcept {
+  return countedAlignedAlloc(size, static_cast<std::size_t>(align));
+}
+
+void* operator new[](
+    std::size_t size,
+    std::align_val_t align,
+    const std::nothrow_t&) noexcept {
+  return countedAlignedAlloc(size, static_cast<std::size_t>(align));
+}
+
+void operator delete(void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept {
+  std::free(ptr);
+}
+
+#else
+
+namespace facebook::eden {
+
+// The counting replacements above rely on posix_memalign and are not built
+// on Windows, so there is nothing to count there: a scope constructs
+// normally but always reports zero.
+
+AllocationCounterScope::AllocationCounterScope() : startCount_{0} {}
+
+size_t AllocationCounterScope::count() const {
+  return 0;
+}
+
+} // namespace facebook::eden
+
+#endif
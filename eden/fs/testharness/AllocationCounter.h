@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+namespace facebook::eden {
+
+/**
+ * Counts heap allocations made by the current thread while the scope is
+ * alive.
+ *
+ * Using this class pulls counting replacements of the global operator
+ * new/delete into the binary, so it must only be linked into test code.
+ * Only allocations made on the calling thread are observed: drive the
+ * operation under test to completion on this thread (see
+ * TestMount::drainServerExecutor) before reading count().
+ *
+ * Intended for allocation-budget fences over hot operations. Assert a
+ * generous upper bound that catches order-of-magnitude regressions; exact
+ * counts churn with every toolchain and library update and make the fence
+ * flaky. Per-site attribution is out of scope here — use a heap profiler
+ * to find where a blown budget went.
+ */
+class AllocationCounterScope {
+ public:
+  AllocationCounterScope();
+
+  AllocationCounterScope(const AllocationCounterScope&) = delete;
+  AllocationCounterScope& operator=(const AllocationCounterScope&) = delete;
+
+  /**
+   * Number of operator new invocations on this thread since this scope was
+   * constructed.
+   *
+   * Always returns 0 on Windows: the counting allocator replacements are
+   * only built on Unix, so budget assertions must be guarded out there.
+   */
+  size_t count() const;
+
+ private:
+  size_t startCount_;
+};
+
+} // namespace facebook::eden
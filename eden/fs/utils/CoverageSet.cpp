@@ -6,96 +6,157 @@
  */
 
 #include "eden/fs/utils/CoverageSet.h"
+
+#include <algorithm>
+
 #include <folly/logging/xlog.h>
 
 namespace facebook::eden {
 
+namespace {
+
+/**
+ * Pending intervals beyond this count are merged into the sorted storage.
+ * Keeping the buffer small bounds the linear scan in covers() while still
+ * amortizing the merge cost across many scattered adds.
+ */
+constexpr size_t kMaxPendingIntervals = 16;
+
+} // namespace
+
 void CoverageSet::clear() {
-  set_.clear();
+  intervals_.clear();
+  pending_.clear();
+  minBegin_ = 0;
+  maxEnd_ = 0;
 }
 
 bool CoverageSet::empty() const noexcept {
-  return set_.empty();
+  return intervals_.empty() && pending_.empty();
 }
 
 void CoverageSet::add(size_t begin, size_t end) {
-  using Set = std::set<Interval>;
-  using Iter = Set::iterator;
-
   XCHECK_LE(begin, end)
       << "End of interval must be greater than or equal to begin";
   if (begin == end) {
     return;
   }
 
-  Iter right = set_.lower_bound(Interval{begin, end});
-  Iter left = right == set_.begin() ? set_.end() : std::prev(right);
-
-  // While the xcode 10 clang compiler is C++17, its libc++ doesn't
-  // implement node_type/extract from C++17, so we need to live
-  // without it for now.  When that support is available, we can
-  // remove this ifdef.
-#ifdef __APPLE__
-  auto erase = [&](Iter iter) -> void { set_.erase(iter); };
-#else
-  // To avoid allocation when possible, save up to one node that can be
-  // modified before reinsertion.
-  Set::node_type reuse_handle;
-
-  auto erase = [&](Iter iter) -> void {
-    if (reuse_handle) {
-      set_.erase(iter);
-    } else {
-      reuse_handle = set_.extract(iter);
-    }
-  };
-#endif
-
-  // In the case that the new interval is completely subsumed by an existing
-  // interval, this code currently rebalances once on the erase and once on the
-  // reinsertion. At the cost of some additional checks, the rebalances could be
-  // avoided. This optimization probably isn't worth much under typical usage.
-
-  if (left != set_.end() && left->end == begin) {
-    begin = left->begin;
-    erase(left);
+  if (empty()) {
+    minBegin_ = begin;
+    maxEnd_ = end;
+  } else {
+    minBegin_ = std::min(minBegin_, begin);
+    maxEnd_ = std::max(maxEnd_, end);
   }
-  while (right != set_.end() && end >= right->begin) {
-    auto next = std::next(right);
-    end = std::max(end, right->end);
-    erase(right);
-    right = next;
+
+  if (!pending_.empty()) {
+    auto& last = pending_.back();
+    // Sequential reads extend the most recently added interval. Grow it in
+    // place instead of queueing another entry.
+    if (begin <= last.end && end >= last.begin) {
+      last.begin = std::min(last.begin, begin);
+      last.end = std::max(last.end, end);
+      return;
+    }
   }
 
-#ifndef __APPLE__
-  if (reuse_handle) {
-    reuse_handle.value().begin = begin;
-    reuse_handle.value().end = end;
-    set_.insert(std::move(reuse_handle));
-  } else
-#endif
-  {
-    set_.insert(Interval{begin, end});
+  pending_.push_back(Interval{begin, end});
+  if (pending_.size() >= kMaxPendingIntervals) {
+    flushPending();
   }
 }
 
-bool CoverageSet::covers(size_t begin, size_t end) const noexcept {
+bool CoverageSet::covers(size_t begin, size_t end) const {
   XCHECK_LE(begin, end)
       << "End of interval must be greater than or equal to begin";
   if (begin == end) {
     return true;
   }
+  if (empty() || begin < minBegin_ || end > maxEnd_) {
+    // Cheap rejection without touching the pending buffer. This is the common
+    // case while a file is still being read sequentially: the queried range
+    // extends past everything seen so far.
+    return false;
+  }
 
-  auto right = set_.upper_bound(Interval{begin, end});
-  if (right == set_.begin()) {
+  // A single interval, pending or merged, may already cover the query.
+  for (const auto& interval : pending_) {
+    if (interval.begin <= begin && end <= interval.end) {
+      return true;
+    }
+  }
+  auto findCovering = [&]() -> bool {
+    auto iter = std::upper_bound(
+        intervals_.begin(),
+        intervals_.end(),
+        begin,
+        [](size_t value, const Interval& interval) {
+          return value < interval.begin;
+        });
+    if (iter == intervals_.begin()) {
+      return false;
+    }
+    --iter;
+    return iter->begin <= begin && end <= iter->end;
+  };
+  if (findCovering()) {
+    return true;
+  }
+  if (pending_.empty()) {
     return false;
   }
-  auto left = std::prev(right);
-  return left->begin <= begin && end <= left->end;
+
+  // The query may span several not-yet-merged intervals; merge and retry.
+  flushPending();
+  return findCovering();
+}
+
+size_t CoverageSet::getIntervalCount() const {
+  flushPending();
+  return intervals_.size();
 }
 
-size_t CoverageSet::getIntervalCount() const noexcept {
-  return set_.size();
+void CoverageSet::flushPending() const {
+  if (pending_.empty()) {
+    return;
+  }
+
+  std::sort(
+      pending_.begin(),
+      pending_.end(),
+      [](const Interval& a, const Interval& b) { return a.begin < b.begin; });
+
+  // Merge the two sorted sequences, coalescing overlapping and adjacent
+  // intervals as they are appended.
+  std::vector<Interval> merged;
+  merged.reserve(intervals_.size() + pending_.size());
+  auto append = [&](const Interval& interval) {
+    if (!merged.empty() && interval.begin <= merged.back().end) {
+      merged.back().end = std::max(merged.back().end, interval.end);
+    } else {
+      merged.push_back(interval);
+    }
+  };
+
+  auto left = intervals_.begin();
+  auto right = pending_.begin();
+  while (left != intervals_.end() && right != pending_.end()) {
+    if (left->begin <= right->begin) {
+      append(*left++);
+    } else {
+      append(*right++);
+    }
+  }
+  for (; left != intervals_.end(); ++left) {
+    append(*left);
+  }
+  for (; right != pending_.end(); ++right) {
+    append(*right);
+  }
+
+  intervals_.swap(merged);
+  pending_.clear();
 }
 
 } // namespace facebook::eden
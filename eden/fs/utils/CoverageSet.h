@@ -8,13 +8,19 @@
 #pragma once
 
 #include <cstddef>
-#include <set>
+#include <vector>
 
 namespace facebook::eden {
 
 /**
  * Tracks contiguous coverage of intervals. Intervals are added dynamically.
  * Then whether a given interval is fully covered can be queried.
+ *
+ * Intervals are stored in a flat sorted vector rather than a node-based tree.
+ * Newly-added intervals are batched in a small pending buffer and merged into
+ * the sorted storage lazily, so the common sequential-read pattern of
+ * extending the most recent interval is O(1) and does not touch the rest of
+ * the structure.
  */
 class CoverageSet {
  public:
@@ -37,29 +43,47 @@ class CoverageSet {
    * Returns true if the interval [begin, end) is fully covered by the
    * previously-inserted intervals.
    */
-  bool covers(size_t begin, size_t end) const noexcept;
+  bool covers(size_t begin, size_t end) const;
 
   /**
    * Returns the number of intervals currently being tracked. This function is
    * primarily for tests.
    */
-  size_t getIntervalCount() const noexcept;
+  size_t getIntervalCount() const;
 
  private:
   struct Interval {
     size_t begin;
     size_t end;
-
-    bool operator<(const Interval& other) const noexcept {
-      return begin < other.begin;
-    }
   };
 
   /**
-   * The intervals are non-overlapping and non-adjacent. begin < end for all
-   * intervals.
+   * Merges pending_ into intervals_, coalescing overlapping and adjacent
+   * intervals. Logically const; only the lazily-maintained representation
+   * changes.
+   */
+  void flushPending() const;
+
+  /**
+   * The intervals are sorted by begin, non-overlapping, and non-adjacent.
+   * begin < end for all intervals. Mutable so that queries can merge the
+   * pending buffer lazily.
+   */
+  mutable std::vector<Interval> intervals_;
+
+  /**
+   * Recently-added intervals that have not yet been merged into intervals_.
+   * These may overlap each other and intervals_, and are in insertion order.
+   */
+  mutable std::vector<Interval> pending_;
+
+  /**
+   * Lower and upper bounds over all tracked intervals, maintained eagerly so
+   * that queries extending past the covered region can fail without merging
+   * the pending buffer. Only meaningful when !empty().
    */
-  std::set<Interval> set_;
+  size_t minBegin_ = 0;
+  size_t maxEnd_ = 0;
 };
 
 } // namespace facebook::eden
@@ -8,6 +8,9 @@
 #include "eden/fs/utils/GlobMatcher.h"
 
 #include <fmt/core.h>
+#include <folly/Synchronized.h>
+#include <folly/container/EvictingCacheMap.h>
+#include <folly/hash/Hash.h>
 #include <folly/logging/xlog.h>
 #include <algorithm>
 #include <limits>
@@ -348,6 +351,51 @@ Expected<GlobMatcher, string> GlobMatcher::create(
   return GlobMatcher(std::move(result), caseSensitive);
 }
 
+namespace {
+struct CachedPatternKey {
+  std::string pattern;
+  GlobOptions options;
+
+  bool operator==(const CachedPatternKey& other) const {
+    return options == other.options && pattern == other.pattern;
+  }
+};
+
+struct CachedPatternKeyHash {
+  size_t operator()(const CachedPatternKey& key) const {
+    return folly::hash::hash_combine(
+        key.pattern, static_cast<uint32_t>(key.options));
+  }
+};
+
+constexpr size_t kCompiledPatternCacheSize = 2048;
+
+using CompiledPatternCache =
+    folly::EvictingCacheMap<CachedPatternKey, GlobMatcher, CachedPatternKeyHash>;
+} // namespace
+
+Expected<GlobMatcher, string> GlobMatcher::createCached(
+    std::string_view glob,
+    GlobOptions options) {
+  static auto* cache = new folly::Synchronized<CompiledPatternCache>{
+      std::in_place, kCompiledPatternCacheSize};
+
+  CachedPatternKey key{string{glob}, options};
+  {
+    auto lockedCache = cache->wlock();
+    auto it = lockedCache->find(key);
+    if (it != lockedCache->end()) {
+      return it->second;
+    }
+  }
+
+  auto compiled = create(glob, options);
+  if (compiled.hasValue()) {
+    cache->wlock()->set(std::move(key), compiled.value());
+  }
+  return compiled;
+}
+
 Expected<size_t, string> GlobMatcher::parseBracketExpr(
     std::string_view glob,
     size_t idx,
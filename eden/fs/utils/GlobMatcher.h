@@ -69,6 +69,19 @@ class GlobMatcher {
       std::string_view glob,
       GlobOptions options);
 
+  /**
+   * Create a GlobMatcher object from a glob pattern, consulting a
+   * process-wide cache of compiled patterns.
+   *
+   * Tools like Buck repeatedly issue glob requests with the same patterns,
+   * so copying the compiled form out of the cache is cheaper than
+   * re-parsing the pattern on every request. Compilation failures are not
+   * cached.
+   */
+  static folly::Expected<GlobMatcher, std::string> createCached(
+      std::string_view glob,
+      GlobOptions options);
+
   /**
    * Match a string against this glob pattern.
    *
@@ -32,7 +32,9 @@ GlobNodeImpl::GlobNodeImpl(
     if (caseSensitive == CaseSensitivity::Insensitive) {
       options |= GlobOptions::CASE_INSENSITIVE;
     }
-    auto compiled = GlobMatcher::create(pattern, options);
+    // Buck tends to re-send the same patterns on every request, so consult
+    // the process-wide compiled pattern cache rather than re-parsing.
+    auto compiled = GlobMatcher::createCached(pattern, options);
     if (compiled.hasError()) {
       throw std::system_error(
           EINVAL,
@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <folly/Executor.h>
 #include <folly/futures/Future.h>
 #include <ostream>
 #include "eden/fs/model/Tree.h"
@@ -137,8 +138,14 @@ class GlobNodeImpl {
       ROOT&& root,
       PrefetchList* fileBlobsToPrefetch,
       ResultList& globResult,
-      const RootId& originRootId) const {
+      const RootId& originRootId,
+      folly::Executor* executor) const {
     TaskTraceBlock block{"GlobNodeImpl::evaluateRecursiveComponentImpl"};
+    if (context->isCancelled()) {
+      // The requester is gone; stop expanding the walk rather than loading
+      // and matching trees whose results nobody will read.
+      return makeImmediateFuture<folly::Unit>(folly::OperationCancelled{});
+    }
     std::vector<RelativePath> subDirNames;
     std::vector<ImmediateFuture<folly::Unit>> futures;
     {
@@ -170,7 +177,8 @@ class GlobNodeImpl {
             subDirNames.emplace_back(std::move(candidateName));
           } else {
             futures.emplace_back(
-                store->getTree(entry.second.getHash(), context)
+                viaIfExecutor(
+                    executor, store->getTree(entry.second.getHash(), context))
                     .thenValue(
                         [candidateName = std::move(candidateName),
                          rootPath = rootPath.copy(),
@@ -179,7 +187,8 @@ class GlobNodeImpl {
                          this,
                          fileBlobsToPrefetch,
                          &globResult,
-                         &originRootId](std::shared_ptr<const Tree> tree) {
+                         &originRootId,
+                         executor](std::shared_ptr<const Tree> tree) {
                           return evaluateRecursiveComponentImpl<
                               TreeRoot,
                               TreeRootPtr>(
@@ -190,7 +199,8 @@ class GlobNodeImpl {
                               TreeRoot(std::move(tree)),
                               fileBlobsToPrefetch,
                               globResult,
-                              originRootId);
+                              originRootId,
+                              executor);
                         }));
           }
         }
@@ -202,7 +212,7 @@ class GlobNodeImpl {
       auto childTreeFuture =
           root.getOrLoadChildTree(candidateName.basename(), context);
       futures.emplace_back(
-          std::move(childTreeFuture)
+          viaIfExecutor(executor, std::move(childTreeFuture))
               .thenValue([candidateName = std::move(candidateName),
                           rootPath = rootPath.copy(),
                           store,
@@ -210,7 +220,8 @@ class GlobNodeImpl {
                           this,
                           fileBlobsToPrefetch,
                           &globResult,
-                          &originRootId](ROOTPtr dir) {
+                          &originRootId,
+                          executor](ROOTPtr dir) {
                 return evaluateRecursiveComponentImpl<ROOT, ROOTPtr>(
                     store,
                     context,
@@ -219,7 +230,8 @@ class GlobNodeImpl {
                     ROOT(std::move(dir)),
                     fileBlobsToPrefetch,
                     globResult,
-                    originRootId);
+                    originRootId,
+                    executor);
               }));
     }
 
@@ -246,8 +258,14 @@ class GlobNodeImpl {
       ROOT&& root,
       PrefetchList* fileBlobsToPrefetch,
       ResultList& globResult,
-      const RootId& originRootId) const {
+      const RootId& originRootId,
+      folly::Executor* executor) const {
     TaskTraceBlock block{"GlobNodeImpl::evaluateImpl"};
+    if (context->isCancelled()) {
+      // Fail rather than return partial results: a silently truncated glob
+      // could otherwise end up in result caches.
+      return makeImmediateFuture<folly::Unit>(folly::OperationCancelled{});
+    }
     std::vector<std::pair<PathComponentPiece, GlobNodeImpl*>> recurse;
     std::vector<ImmediateFuture<folly::Unit>> futures;
 
@@ -260,7 +278,8 @@ class GlobNodeImpl {
           std::forward<ROOT>(root),
           fileBlobsToPrefetch,
           globResult,
-          originRootId));
+          originRootId,
+          executor));
     }
 
     auto recurseIfNecessary = [&](PathComponentPiece name,
@@ -273,7 +292,7 @@ class GlobNodeImpl {
           recurse.emplace_back(name, node);
         } else {
           futures.emplace_back(
-              store->getTree(entry->getHash(), context)
+              viaIfExecutor(executor, store->getTree(entry->getHash(), context))
                   .thenValue(
                       [candidateName = rootPath + name,
                        store,
@@ -281,7 +300,8 @@ class GlobNodeImpl {
                        innerNode = node,
                        fileBlobsToPrefetch,
                        &globResult,
-                       &originRootId](std::shared_ptr<const Tree> dir) mutable {
+                       &originRootId,
+                       executor](std::shared_ptr<const Tree> dir) mutable {
                         return innerNode->evaluateImpl<TreeRoot, TreeRootPtr>(
                             store,
                             context,
@@ -289,7 +309,8 @@ class GlobNodeImpl {
                             TreeRoot(std::move(dir)),
                             fileBlobsToPrefetch,
                             globResult,
-                            originRootId);
+                            originRootId,
+                            executor);
                       }));
         }
       }
@@ -349,14 +370,15 @@ class GlobNodeImpl {
 
     for (auto& item : recurse) {
       futures.emplace_back(
-          root.getOrLoadChildTree(item.first, context)
+          viaIfExecutor(executor, root.getOrLoadChildTree(item.first, context))
               .thenValue([store,
                           context = context.copy(),
                           candidateName = rootPath + item.first,
                           node = item.second,
                           fileBlobsToPrefetch,
                           &globResult,
-                          &originRootId](ROOTPtr dir) {
+                          &originRootId,
+                          executor](ROOTPtr dir) {
                 return node->evaluateImpl<ROOT, ROOTPtr>(
                     store,
                     context,
@@ -364,7 +386,8 @@ class GlobNodeImpl {
                     ROOT(std::move(dir)),
                     fileBlobsToPrefetch,
                     globResult,
-                    originRootId);
+                    originRootId,
+                    executor);
               }));
     }
 
@@ -385,6 +408,25 @@ class GlobNodeImpl {
   }
 
  private:
+  /**
+   * Hops a future onto the executor when one was provided, so that the
+   * continuation attached to it (an independent subtree evaluation) runs
+   * on the executor rather than inline on the thread that completed the
+   * future. This is what allows wide globs to evaluate subtrees in
+   * parallel: with cached trees the futures are otherwise already complete
+   * and the whole walk would run serially on the calling thread. A null
+   * executor preserves the inline evaluation.
+   */
+  template <typename T>
+  static ImmediateFuture<T> viaIfExecutor(
+      folly::Executor* executor,
+      ImmediateFuture<T> future) {
+    if (!executor) {
+      return future;
+    }
+    return ImmediateFuture<T>{std::move(future).semi().via(executor).semi()};
+  }
+
   // Returns the next glob node token.
   // This is the text from the start of pattern up to the first
   // slash, or the end of the string is there was no slash.
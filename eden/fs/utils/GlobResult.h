@@ -11,11 +11,17 @@
 #include "eden/fs/store/ObjectStore.h"
 #include "eden/fs/utils/DirType.h"
 #include "eden/fs/utils/PathFuncs.h"
+#include "eden/fs/utils/StringInterner.h"
 
 namespace facebook::eden {
 
 struct GlobResult {
-  RelativePath name;
+  // The matched path, interned in the process-wide StringInterner. Tools
+  // poll the same globs over the same files constantly, so sharing one copy
+  // of each matched path avoids reallocating identical strings for every
+  // query. Matched paths name files in the repository, so the interned
+  // vocabulary is bounded by the working copy's contents.
+  RelativePathPiece name;
   dtype_t dtype;
   // Currently this is the commit hash for the commit to which this file
   // belongs. But should eden move away from commit hashes this may become
@@ -44,13 +50,14 @@ struct GlobResult {
   // of Globresult::evaluate ensures that the hashes have a lifetime that
   // exceeds that of the GlobResults returned.
   GlobResult(RelativePathPiece name, dtype_t dtype, const RootId& originHash)
-      : name(name.copy()), dtype(dtype), originHash(&originHash) {}
+      : name(StringInterner::get().intern(name)),
+        dtype(dtype),
+        originHash(&originHash) {}
 
-  GlobResult(
-      RelativePath&& name,
-      dtype_t dtype,
-      const RootId& originHash) noexcept
-      : name(std::move(name)), dtype(dtype), originHash(&originHash) {}
+  GlobResult(RelativePath&& name, dtype_t dtype, const RootId& originHash)
+      : name(StringInterner::get().intern(name.piece())),
+        dtype(dtype),
+        originHash(&originHash) {}
 };
 
 using ResultList = folly::Synchronized<std::vector<GlobResult>>;
@@ -20,7 +20,8 @@ ImmediateFuture<folly::Unit> GlobTree::evaluate(
     std::shared_ptr<const Tree> tree,
     PrefetchList* fileBlobsToPrefetch,
     ResultList& globResult,
-    const RootId& originRootId) const {
+    const RootId& originRootId,
+    folly::Executor* executor) const {
   return evaluateImpl<GlobNodeImpl::TreeRoot, GlobNodeImpl::TreeRootPtr>(
              store.get(),
              context,
@@ -28,7 +29,8 @@ ImmediateFuture<folly::Unit> GlobTree::evaluate(
              GlobNodeImpl::TreeRoot(std::move(tree)),
              fileBlobsToPrefetch,
              globResult,
-             originRootId)
+             originRootId,
+             executor)
       // Make sure the store stays alive for the duration of globbing.
       .ensure([store] {});
 }
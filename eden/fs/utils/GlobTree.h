@@ -35,6 +35,8 @@ class GlobTree : public GlobNodeImpl {
    * @param tree metadata structure of files
    * @param fileBlobstoPrefetch a nullable list of files to fetch during
    * globbing
+   * @param executor a nullable executor to run independent subtree
+   * evaluations on rather than inline on the calling thread
    */
   ImmediateFuture<folly::Unit> evaluate(
       std::shared_ptr<ObjectStore> store,
@@ -43,7 +45,8 @@ class GlobTree : public GlobNodeImpl {
       std::shared_ptr<const Tree> tree,
       PrefetchList* fileBlobsToPrefetch,
       ResultList& globResult,
-      const RootId& originRootId) const;
+      const RootId& originRootId,
+      folly::Executor* executor = nullptr) const;
 };
 
 } // namespace facebook::eden
@@ -232,12 +232,18 @@ ImmediateFuture<T>::thenTry(Func&& func) && {
     // In the case where Func returns an ImmediateFuture, we need to
     // transform that return value into a SemiFuture so that the return
     // type is a SemiFuture<> and not a SemiFuture<ImmediateFuture<>>.
-    auto semiFut = std::move(*this).semi().defer(std::forward<Func>(func));
+    //
+    // The unwrapping happens inside the deferred callback itself rather
+    // than in a second defer link: every defer allocates a future core,
+    // and deep chains of pending continuations are common in the
+    // dispatchers.
     if constexpr (detail::isImmediateFuture<FuncRetType>::value) {
-      return std::move(semiFut).deferValue(
-          [](auto&& immFut) { return std::move(immFut).semi(); });
+      return std::move(*this).semi().defer(
+          [func = std::forward<Func>(func)](folly::Try<T>&& try_) mutable {
+            return std::move(func)(std::move(try_)).semi();
+          });
     } else {
-      return semiFut;
+      return std::move(*this).semi().defer(std::forward<Func>(func));
     }
   }
 }
@@ -400,10 +406,14 @@ collectAll(Fs&&... fs) {
     Result results;
   };
 
+  if ((fs.isReady() && ...)) {
+    // All the values are at hand: build the result tuple in place without
+    // allocating the promise/context pair below.
+    return Result{std::move(fs).getTry()...};
+  }
+
   std::vector<folly::SemiFuture<folly::Unit>> semis;
 
-  // TODO: fast-path the case where everything is ready and avoid allocations
-  // entirely.
   auto ctx = std::make_shared<Context>();
   folly::futures::detail::foreach(
       [&](auto i, auto&& f) {
@@ -417,16 +427,6 @@ collectAll(Fs&&... fs) {
       },
       static_cast<Fs&&>(fs)...);
 
-  if (semis.empty()) {
-    // Since all the ImmediateFuture were ready, the Context hasn't been
-    // copied to any lambdas, and thus will be destroyed once this lambda
-    // returns. This will make the returned SemiFuture ready which the
-    // ImmediateFuture constructor will extract the value from.
-    auto fut = ctx->p.getSemiFuture();
-    ctx.reset();
-    return fut;
-  }
-
   return folly::collectAll(std::move(semis)).deferValue([ctx](auto&&) {
     return ctx->p.getSemiFuture();
   });
@@ -6,12 +6,26 @@
  */
 
 #pragma once
+#include <array>
+#include <memory>
+#include <mutex>
+
 #include <folly/container/EvictingCacheMap.h>
 #include <folly/futures/Future.h>
 #include <folly/futures/SharedPromise.h>
 
 namespace facebook::eden {
 
+/**
+ * An LRU cache of leases: the first get() for a key invokes the fetcher and
+ * every concurrent get() for the same key attaches to that single in-flight
+ * fetch instead of repeating it.
+ *
+ * The cache is split into shards, each with its own lock and LRU list, so
+ * that wide fanout over different keys does not convoy on one mutex. A
+ * single key always maps to the same shard, preserving the one-fetch-per-key
+ * guarantee.
+ */
 template <typename KEY, typename VAL, typename HASH = std::hash<KEY>>
 class LeaseCache {
  public:
@@ -21,56 +35,106 @@ class LeaseCache {
   using FetchFunc = std::function<FutureType(const KEY& key)>;
 
  private:
-  std::mutex lock_;
-  folly::EvictingCacheMap<KEY, SharedPromiseType, HASH> cache_;
+  /**
+   * Sixteen shards is plenty to keep concurrent fetchers for distinct keys
+   * from contending, while keeping the fixed memory cost small.
+   */
+  static constexpr size_t kNumShards = 16;
+
+  struct Shard {
+    std::mutex lock;
+    folly::EvictingCacheMap<KEY, SharedPromiseType, HASH> cache;
+
+    Shard(size_t maxSize, size_t clearSize) : cache(maxSize, clearSize) {}
+  };
+
+  std::array<std::unique_ptr<Shard>, kNumShards> shards_;
   FetchFunc fetcher_;
 
+  Shard& getShard(const KEY& key) {
+    return *shards_[HASH{}(key) % kNumShards];
+  }
+
+  /**
+   * Each shard holds an equal slice of the overall capacity, rounded up so
+   * the total is never less than the requested size.
+   */
+  static constexpr size_t perShardSize(size_t size) {
+    return (size + kNumShards - 1) / kNumShards;
+  }
+
  public:
-  LeaseCache(size_t maxSize, FetchFunc fetcher, size_t clearSize = 1)
-      : cache_(maxSize, clearSize), fetcher_(fetcher) {}
+  explicit LeaseCache(
+      size_t maxSize,
+      FetchFunc fetcher = nullptr,
+      size_t clearSize = 1) {
+    for (auto& shard : shards_) {
+      shard = std::make_unique<Shard>(perShardSize(maxSize), clearSize);
+    }
+    fetcher_ = std::move(fetcher);
+  }
 
   void set(const KEY& key, ValuePtr val) {
-    std::lock_guard<std::mutex> g(lock_);
+    auto& shard = getShard(key);
+    std::lock_guard<std::mutex> g(shard.lock);
     auto entry = std::make_shared<typename SharedPromiseType::element_type>();
     entry->setValue(val);
-    cache_.set(key, entry);
+    shard.cache.set(key, entry);
   }
 
   void erase(const KEY& key) {
-    std::lock_guard<std::mutex> g(lock_);
-    cache_.erase(key);
+    auto& shard = getShard(key);
+    std::lock_guard<std::mutex> g(shard.lock);
+    shard.cache.erase(key);
   }
 
   void setMaxSize(size_t size) {
-    cache_.setMaxSize(size);
+    for (auto& shard : shards_) {
+      std::lock_guard<std::mutex> g(shard->lock);
+      shard->cache.setMaxSize(perShardSize(size));
+    }
   }
 
-  FutureType get(const KEY& key) {
+  /**
+   * Like get(key), but runs the supplied fetcher on a miss instead of the
+   * one passed to the constructor. Only the caller that actually misses
+   * invokes it; everyone else attaches to the resulting lease.
+   */
+  FutureType get(const KEY& key, const FetchFunc& fetcher) {
     SharedPromiseType entry;
+    auto& shard = getShard(key);
 
     {
-      std::lock_guard<std::mutex> g(lock_);
+      std::lock_guard<std::mutex> g(shard.lock);
 
-      auto it = cache_.find(key);
-      if (it != cache_.end()) {
+      auto it = shard.cache.find(key);
+      if (it != shard.cache.end()) {
         entry = it->second;
         return entry->getFuture();
       }
 
       entry = std::make_shared<typename SharedPromiseType::element_type>();
-      cache_.set(key, entry);
+      shard.cache.set(key, entry);
     }
 
+    // The fetch runs outside the lock so slow fetches never block lookups,
+    // including lookups of other keys in the same shard.
     auto future = entry->getFuture();
 
-    fetcher_(key).thenTry(
+    fetcher(key).thenTry(
         [entry](folly::Try<ValuePtr>&& t) { entry->setTry(std::move(t)); });
 
     return future;
   }
 
+  FutureType get(const KEY& key) {
+    return get(key, fetcher_);
+  }
+
   bool exists(const KEY& key) {
-    return cache_.exists(key);
+    auto& shard = getShard(key);
+    std::lock_guard<std::mutex> g(shard.lock);
+    return shard.cache.exists(key);
   }
 };
 
@@ -15,6 +15,7 @@
 #include <folly/File.h>
 #include <folly/FileUtil.h>
 #include <folly/Range.h>
+#include <folly/String.h>
 #include <folly/logging/xlog.h>
 
 #ifndef _WIN32
@@ -126,7 +127,8 @@ class MappedDiskVector {
   template <typename... OldVersions>
   static MappedDiskVector open(
       folly::StringPiece path,
-      bool shouldPopulate = false) {
+      bool shouldPopulate = false,
+      bool useHugePages = false) {
     folly::File file{path, O_RDWR | O_CREAT | O_CLOEXEC, 0600};
 
     if (!file.try_lock()) {
@@ -138,7 +140,7 @@ class MappedDiskVector {
         fstat(file.fd(), &st), "fstat failed on MappedDiskVector path ", path);
 
     if (st.st_size == 0) {
-      return initializeFromScratch(std::move(file));
+      return initializeFromScratch(std::move(file), useHugePages);
     }
 
     Header header;
@@ -185,7 +187,11 @@ class MappedDiskVector {
             header.recordSize));
       }
       return MappedDiskVector{
-          std::move(file), st.st_size, header.entryCount, shouldPopulate};
+          std::move(file),
+          st.st_size,
+          header.entryCount,
+          shouldPopulate,
+          useHugePages};
     }
 
     // Try to migrate from an old record format if any match.
@@ -246,6 +252,7 @@ class MappedDiskVector {
     end_ = other.end_;
     map_ = other.map_;
     mapSizeInBytes_ = other.mapSizeInBytes_;
+    useHugePages_ = other.useHugePages_;
 
     other.begin_ = nullptr;
     other.end_ = nullptr;
@@ -263,6 +270,7 @@ class MappedDiskVector {
     end_ = other.end_;
     map_ = other.map_;
     mapSizeInBytes_ = other.mapSizeInBytes_;
+    useHugePages_ = other.useHugePages_;
 
     other.begin_ = nullptr;
     other.end_ = nullptr;
@@ -338,6 +346,10 @@ class MappedDiskVector {
 
       begin_ = reinterpret_cast<T*>(static_cast<Header*>(newMap) + 1);
       end_ = begin_ + oldSize;
+
+      // mremap may return a new region without the old mapping's advice, so
+      // reapply it after growth.
+      adviseHugePagesIfRequested();
     }
 
     T* out = end_;
@@ -365,6 +377,19 @@ class MappedDiskVector {
     return end_[-1];
   }
 
+  /**
+   * Schedules asynchronous writeback of the mapping's dirty pages via
+   * msync(MS_ASYNC).  The kernel flushes dirty pages on its own schedule, but
+   * calling this periodically bounds how much unwritten data can accumulate
+   * between flushes without ever blocking on disk I/O.
+   */
+  void sync() {
+    if (msync(map_, mapSizeInBytes_, MS_ASYNC)) {
+      XLOG(WARNING) << "msync failed on MappedDiskVector: "
+                    << folly::errnoStr(errno);
+    }
+  }
+
  private:
   static constexpr uint32_t kMagic = 0x0056444d; // "MDV\0"
 
@@ -385,7 +410,9 @@ class MappedDiskVector {
 
   static constexpr size_t GROWTH_IN_PAGES = 256;
 
-  static MappedDiskVector initializeFromScratch(folly::File file) {
+  static MappedDiskVector initializeFromScratch(
+      folly::File file,
+      bool useHugePages = false) {
     // Start the file large enough to handle the header and a little under one
     // round one of growth.
     constexpr size_t initialSize = GROWTH_IN_PAGES * detail::kPageSize;
@@ -413,14 +440,15 @@ class MappedDiskVector {
     }
 
     return MappedDiskVector{
-        std::move(file), initialSize, header.entryCount, false};
+        std::move(file), initialSize, header.entryCount, false, useHugePages};
   }
 
   explicit MappedDiskVector(
       folly::File file,
       off_t fileSize,
       size_t currentEntryCount,
-      bool populate)
+      bool populate,
+      bool useHugePages = false)
       : file_(std::move(file)) {
     // It's worth keeping the file and mapping a whole number of pages to
     // avoid wasting an partial page at the end.  Note that this is an
@@ -465,6 +493,8 @@ class MappedDiskVector {
 
     map_ = map;
     mapSizeInBytes_ = desiredSize;
+    useHugePages_ = useHugePages;
+    adviseHugePagesIfRequested();
     static_assert(
         alignof(Header) >= alignof(T),
         "T must not have stricter alignment requirements than Header");
@@ -505,6 +535,22 @@ class MappedDiskVector {
     return end_;
   }
 
+  /**
+   * Best-effort request for transparent hugepage backing of the mapping.
+   * Only has an effect on Linux; a failure is logged and otherwise ignored
+   * since hugepages are purely a performance optimization.
+   */
+  void adviseHugePagesIfRequested() {
+#ifdef MADV_HUGEPAGE
+    if (useHugePages_) {
+      if (madvise(map_, mapSizeInBytes_, MADV_HUGEPAGE)) {
+        XLOG(WARNING) << "madvise(MADV_HUGEPAGE) failed on MappedDiskVector: "
+                      << folly::errnoStr(errno);
+      }
+    }
+#endif
+  }
+
   Header& header() {
     return *static_cast<Header*>(map_);
   }
@@ -519,6 +565,7 @@ class MappedDiskVector {
 
   void* map_{nullptr};
   size_t mapSizeInBytes_{0}; // must be nonzero, multiple of page size
+  bool useHugePages_{false};
 
   folly::File file_;
 
@@ -115,10 +115,11 @@ CanonicalData canonicalPathData(std::string_view path) {
     }
   };
 
-  for (const char* p = path.data(); p != path.data() + path.size(); ++p) {
-    if (detail::isDirSeparator(*p)) {
-      processSlash(p);
-    }
+  const char* pathEnd = path.data() + path.size();
+  for (const char* p = detail::findDirSeparator(path.data(), pathEnd);
+       p != pathEnd;
+       p = detail::findDirSeparator(p + 1, pathEnd)) {
+    processSlash(p);
   }
   if (componentStart != path.data() + path.size()) {
     processSlash(path.data() + path.size());
@@ -17,6 +17,7 @@
 #include <folly/String.h>
 #include <folly/hash/Hash.h>
 #include <folly/logging/xlog.h>
+#include <cstring>
 #include <iterator>
 #include <optional>
 #include <type_traits>
@@ -65,6 +66,46 @@ inline constexpr bool isDirSeparator(std::string_view str) {
   return str.size() == 1 && isDirSeparator(str[0]);
 }
 
+/**
+ * Return a pointer to the first directory separator in [begin, end), or end
+ * if there is none.
+ *
+ * Path splitting happens on every lookup, so on POSIX this defers to memchr,
+ * which libc implementations vectorize. Windows paths may use either
+ * separator and are scanned byte-wise.
+ */
+inline const char* findDirSeparator(const char* begin, const char* end) {
+  if constexpr (folly::kIsWindows) {
+    while (begin != end && !isDirSeparator(*begin)) {
+      ++begin;
+    }
+    return begin;
+  } else {
+    auto* p = static_cast<const char*>(
+        memchr(begin, kDirSeparator, static_cast<size_t>(end - begin)));
+    return p ? p : end;
+  }
+}
+
+/**
+ * Return a pointer to the last directory separator in [begin, end), or
+ * nullptr if there is none. Uses memrchr where available.
+ */
+inline const char* findLastDirSeparator(const char* begin, const char* end) {
+#ifdef __linux__
+  return static_cast<const char*>(
+      memrchr(begin, kDirSeparator, static_cast<size_t>(end - begin)));
+#else
+  while (end != begin) {
+    --end;
+    if (isDirSeparator(*end)) {
+      return end;
+    }
+  }
+  return nullptr;
+#endif
+}
+
 inline bool isAbsoluteRoot(std::string_view path) {
   return path == kRootStr;
 }
@@ -267,6 +308,30 @@ struct AsciiLessThanCaseInsensitive {
   }
 };
 
+/**
+ * Case-insensitive ASCII equality for path pieces.
+ *
+ * Strings compared on case-insensitive mounts usually match with identical
+ * case, so try a plain memcmp (which libc vectorizes) before falling back
+ * to the byte-wise folding comparison.
+ */
+inline bool isAsciiCaseInsensitiveEqual(
+    std::string_view left,
+    std::string_view right) {
+  if (left.size() != right.size()) {
+    return false;
+  }
+  if (left.empty() || memcmp(left.data(), right.data(), left.size()) == 0) {
+    return true;
+  }
+  return std::equal(
+      left.begin(),
+      left.end(),
+      right.begin(),
+      right.end(),
+      folly::AsciiCaseInsensitive{});
+}
+
 namespace detail {
 
 // Helper for equality testing, borrowed from
@@ -401,12 +466,8 @@ struct PathOperators {
           if (caseSensitive == CaseSensitivity::Sensitive) {
             return leftStringPiece == rightStringPiece;
           } else {
-            return std::equal(
-                leftStringPiece.begin(),
-                leftStringPiece.end(),
-                rightStringPiece.begin(),
-                rightStringPiece.end(),
-                folly::AsciiCaseInsensitive{});
+            return isAsciiCaseInsensitiveEqual(
+                leftStringPiece, rightStringPiece);
           }
         }
 
@@ -427,12 +488,7 @@ struct PathOperators {
       if (caseSensitive == CaseSensitivity::Sensitive) {
         return leftStringPiece == rightStringPiece;
       } else {
-        return std::equal(
-            leftStringPiece.begin(),
-            leftStringPiece.end(),
-            rightStringPiece.begin(),
-            rightStringPiece.end(),
-            folly::AsciiCaseInsensitive{});
+        return isAsciiCaseInsensitiveEqual(leftStringPiece, rightStringPiece);
       }
     }
   }
@@ -664,6 +720,22 @@ class PathBase :
     return Piece(view(), SkipPathSanityCheck());
   }
 
+  /**
+   * Replace this path's contents with a copy of the given piece,
+   * reusing any storage this path has already allocated.
+   * Skips sanity checks: the piece was checked when it was constructed.
+   * The template gunk only enables this method if we are the
+   * Stored flavor of this type.
+   */
+  template <
+      typename StorageAlias = Storage,
+      typename = typename std::enable_if<
+          std::is_same<StorageAlias, std::string>::value>::type>
+  void assign(Piece piece) {
+    auto value = piece.view();
+    path_.assign(value.data(), value.size());
+  }
+
   /// Implicit conversion to Piece
   /* implicit */ operator Piece() const {
     return piece();
@@ -919,9 +991,7 @@ class ComposedPathIterator {
     }
 
     ++pos_;
-    while (pos_ < path_.data() + path_.size() && !isDirSeparator(*pos_)) {
-      ++pos_;
-    }
+    pos_ = findDirSeparator(pos_, path_.data() + path_.size());
   }
 
   // Move the iterator backwards in the path.
@@ -942,9 +1012,8 @@ class ComposedPathIterator {
     }
 
     --pos_;
-    while (pos_ > stopPos && !isDirSeparator(*pos_)) {
-      --pos_;
-    }
+    auto* sep = findLastDirSeparator(stopPos + 1, pos_ + 1);
+    pos_ = sep ? sep : stopPos;
   }
 
   /// the path we're iterating over.
@@ -985,21 +1054,16 @@ class PathComponentIterator {
         "PathComponentIterator should only be constructed from a non-stored path");
 
     if (IsReverse) {
-      start_ = pathEnd_;
       end_ = pathEnd_;
       // Back start_ up to just after the last kDirSeparator
-      while (start_ != pathBegin_ && !isDirSeparator(*(start_ - 1))) {
-        --start_;
-      }
+      auto* sep = findLastDirSeparator(pathBegin_, pathEnd_);
+      start_ = sep ? sep + 1 : pathBegin_;
     } else {
       // Skip over any leading slash, to handle absolute paths
       start_ = pathBegin_;
 
       // Advance end_ until the next slash or the end of the path
-      end_ = start_;
-      while (end_ != pathEnd_ && !isDirSeparator(*end_)) {
-        ++end_;
-      }
+      end_ = findDirSeparator(start_, pathEnd_);
     }
   }
 
@@ -1105,9 +1169,7 @@ class PathComponentIterator {
     }
     ++end_;
     start_ = end_;
-    while (end_ != pathEnd_ && !isDirSeparator(*end_)) {
-      ++end_;
-    }
+    end_ = findDirSeparator(end_, pathEnd_);
   }
 
   // Move the iterator backwards in the path.
@@ -1120,9 +1182,8 @@ class PathComponentIterator {
 
     --start_;
     end_ = start_;
-    while (start_ != pathBegin_ && !isDirSeparator(*(start_ - 1))) {
-      --start_;
-    }
+    auto* sep = findLastDirSeparator(pathBegin_, start_);
+    start_ = sep ? sep + 1 : pathBegin_;
   }
 
   /// the path we're iterating over.
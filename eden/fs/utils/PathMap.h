@@ -8,9 +8,12 @@
 #pragma once
 #include <folly/FBVector.h>
 #include <folly/Portability.h>
+#include <folly/container/F14Map.h>
 #include <algorithm>
 #include <functional>
 #include <iterator>
+#include <memory>
+#include <string>
 #include <utility>
 #include "eden/fs/utils/CaseSensitivity.h"
 #include "eden/fs/utils/PathFuncs.h"
@@ -31,6 +34,9 @@ namespace facebook::eden {
  *   it is better to pre-sort the data to be inserted.
  * - Since insert and erase operations move the vector contents around,
  *   those operations invalidate iterators.
+ * - Case insensitive maps additionally keep a hash index from the
+ *   case-folded key to its vector position, so find() does not pay a
+ *   case-folding comparison per binary search probe.
  */
 template <typename Value, typename Key = PathComponent>
 class PathMap : private folly::fbvector<std::pair<Key, Value>> {
@@ -80,6 +86,93 @@ class PathMap : private folly::fbvector<std::pair<Key, Value>> {
   // Hold an instance of the comparator.
   Compare compare_;
 
+  /**
+   * For case insensitive maps, an index from the case-folded key to its
+   * position in the sorted vector, so find() is a single hash lookup
+   * instead of a binary search whose every probe pays a case-folding
+   * comparison. Case sensitive maps (the common case on Linux) never
+   * allocate the index and only pay one null pointer of overhead.
+   *
+   * The index is maintained eagerly by the mutating operations rather
+   * than rebuilt lazily: const find() may be called concurrently by
+   * readers holding a shared lock (DirContents lives in a
+   * folly::Synchronized), so it must not mutate. Positions at or after
+   * an insertion or erasure point shift by one, mirroring the vector
+   * elements they refer to; that walk is O(n), matching the shifting
+   * cost the vector itself already pays for those operations.
+   */
+  using FoldedIndex = folly::F14FastMap<std::string, size_type>;
+  std::unique_ptr<FoldedIndex> foldedIndex_;
+
+  /**
+   * Fold a key to the representation used by the index: ASCII lowercase,
+   * matching the equivalence classes of AsciiLessThanCaseInsensitive. On
+   * Windows, backslash separators are normalized so composed paths that
+   * compare equal component-wise also fold equal.
+   */
+  static std::string foldKey(Piece key) {
+    std::string folded{key.view()};
+    for (char& c : folded) {
+      if (folly::kIsWindows && c == '\\') {
+        c = '/';
+      } else {
+        c = AsciiLessThanCaseInsensitive::toLower(c);
+      }
+    }
+    return folded;
+  }
+
+  void initializeIndex() {
+    if (compare_.caseSensitive_ == CaseSensitivity::Insensitive) {
+      foldedIndex_ = std::make_unique<FoldedIndex>();
+    }
+  }
+
+  /** Rebuild the index from scratch to match the vector contents. */
+  void reindex() {
+    if (!foldedIndex_) {
+      return;
+    }
+    foldedIndex_->clear();
+    foldedIndex_->reserve(size());
+    size_type idx = 0;
+    for (const auto& pair : *this) {
+      (*foldedIndex_)[foldKey(Piece(pair.first))] = idx++;
+    }
+  }
+
+  /** Record an insertion at position pos, shifting later entries up. */
+  void indexInserted(size_type pos) {
+    if (!foldedIndex_) {
+      return;
+    }
+    for (auto& entry : *foldedIndex_) {
+      if (entry.second >= pos) {
+        ++entry.second;
+      }
+    }
+    (*foldedIndex_)[foldKey(Piece((begin() + pos)->first))] = pos;
+  }
+
+  /** Record erasure of positions [first, last), shifting later entries
+   * down. Must be called before the vector elements are destroyed. */
+  void indexErased(size_type first, size_type last) {
+    if (!foldedIndex_) {
+      return;
+    }
+    const auto removed = last - first;
+    for (auto iter = foldedIndex_->begin(); iter != foldedIndex_->end();) {
+      if (iter->second >= first && iter->second < last) {
+        iter = foldedIndex_->erase(iter);
+      } else {
+        if (iter->second >= last) {
+          iter->second -= removed;
+        }
+        ++iter;
+      }
+    }
+  }
+
  public:
   // Various type aliases to satisfy container concepts.
   using key_type = Key;
@@ -99,7 +192,9 @@ class PathMap : private folly::fbvector<std::pair<Key, Value>> {
   using const_reverse_iterator = typename Vector::const_reverse_iterator;
 
   // Construct empty.
-  explicit PathMap(CaseSensitivity caseSensitive) : compare_(caseSensitive) {}
+  explicit PathMap(CaseSensitivity caseSensitive) : compare_(caseSensitive) {
+    initializeIndex();
+  }
 
   // Populate from an initializer_list.
   PathMap(std::initializer_list<value_type> init, CaseSensitivity caseSensitive)
@@ -117,13 +212,33 @@ class PathMap : private folly::fbvector<std::pair<Key, Value>> {
     // enough to matter, the cost of iterating will be dwarfed by the cost
     // of growing the storage several times during population.
     this->reserve(std::distance(first, last));
+    // Append everything and sort once rather than paying a shifting insert
+    // per element; sources like Tree entries are usually already sorted, in
+    // which case this is a single O(n) verification pass.
     for (; first != last; ++first) {
-      insert(*first);
+      Vector::push_back(*first);
     }
+    if (!std::is_sorted(begin(), end(), compare_)) {
+      std::stable_sort(begin(), end(), compare_);
+    }
+    // Match insert() semantics for duplicated keys: the first occurrence
+    // wins. stable_sort keeps equal keys in input order, so unique drops the
+    // later ones.
+    auto newEnd = std::unique(
+        begin(), end(), [this](const Pair& a, const Pair& b) {
+          return !compare_(a, b) && !compare_(b, a);
+        });
+    Vector::erase(newEnd, end());
+    initializeIndex();
+    reindex();
   }
 
   // Inherit the underlying vector copy/assignment.
-  PathMap(const PathMap& other) : Vector(other), compare_(other.compare_) {}
+  PathMap(const PathMap& other) : Vector(other), compare_(other.compare_) {
+    if (other.foldedIndex_) {
+      foldedIndex_ = std::make_unique<FoldedIndex>(*other.foldedIndex_);
+    }
+  }
   PathMap& operator=(const PathMap& other) {
     PathMap(other).swap(*this);
     return *this;
@@ -131,7 +246,9 @@ class PathMap : private folly::fbvector<std::pair<Key, Value>> {
 
   // inherit Move construction.
   PathMap(PathMap&& other) noexcept
-      : Vector(std::move(other)), compare_(other.compare_) {}
+      : Vector(std::move(other)),
+        compare_(other.compare_),
+        foldedIndex_(std::move(other.foldedIndex_)) {}
   PathMap& operator=(PathMap&& other) {
     other.swap(*this);
     return *this;
@@ -142,12 +259,10 @@ class PathMap : private folly::fbvector<std::pair<Key, Value>> {
   using Vector::capacity;
   using Vector::cbegin;
   using Vector::cend;
-  using Vector::clear;
   using Vector::crbegin;
   using Vector::crend;
   using Vector::empty;
   using Vector::end;
-  using Vector::erase;
   using Vector::max_size;
   using Vector::rbegin;
   using Vector::rend;
@@ -158,6 +273,32 @@ class PathMap : private folly::fbvector<std::pair<Key, Value>> {
   void swap(PathMap& other) noexcept {
     Vector::swap(other);
     std::swap(compare_, other.compare_);
+    std::swap(foldedIndex_, other.foldedIndex_);
+  }
+
+  // Remove all entries.
+  void clear() {
+    Vector::clear();
+    if (foldedIndex_) {
+      foldedIndex_->clear();
+    }
+  }
+
+  /** Erase the entry at the given position.
+   * Returns an iterator to the following entry. */
+  iterator erase(const_iterator pos) {
+    auto idx = static_cast<size_type>(pos - cbegin());
+    indexErased(idx, idx + 1);
+    return Vector::erase(pos);
+  }
+
+  /** Erase the entries in the range [first, last).
+   * Returns an iterator to the entry following the erased range. */
+  iterator erase(const_iterator first, const_iterator last) {
+    indexErased(
+        static_cast<size_type>(first - cbegin()),
+        static_cast<size_type>(last - cbegin()));
+    return Vector::erase(first, last);
   }
 
   /**
@@ -177,8 +318,18 @@ class PathMap : private folly::fbvector<std::pair<Key, Value>> {
 
   /** Find using the Piece representation of a key.
    * Does not allocate a copy of the key string.
+   *
+   * On case insensitive maps this is a single hash lookup in the folded
+   * index rather than a binary search whose every probe case-folds the
+   * key; folding the lookup key stays allocation free for component
+   * lengths within the small-string optimization.
    */
   iterator find(Piece key) {
+    if (foldedIndex_) {
+      auto indexIter = foldedIndex_->find(foldKey(key));
+      return indexIter == foldedIndex_->end() ? end()
+                                              : begin() + indexIter->second;
+    }
     auto iter = lower_bound(key);
     if (iter != end() && !compare_(key, iter->first)) {
       // Found it
@@ -191,6 +342,11 @@ class PathMap : private folly::fbvector<std::pair<Key, Value>> {
    * Does not allocate a copy of the key string.
    */
   const_iterator find(Piece key) const {
+    if (foldedIndex_) {
+      auto indexIter = foldedIndex_->find(foldKey(key));
+      return indexIter == foldedIndex_->end() ? end()
+                                              : begin() + indexIter->second;
+    }
     auto iter = lower_bound(key);
     if (iter != end() && !compare_(key, iter->first)) {
       // Found it
@@ -212,7 +368,9 @@ class PathMap : private folly::fbvector<std::pair<Key, Value>> {
     }
 
     // Otherwise, iter is the insertion point
-    return std::make_pair(Vector::insert(iter, val), true);
+    iter = Vector::insert(iter, val);
+    indexInserted(static_cast<size_type>(iter - begin()));
+    return std::make_pair(iter, true);
   }
 
   /** Emplace a new key-value pair by constructing it in-place.
@@ -233,6 +391,49 @@ class PathMap : private folly::fbvector<std::pair<Key, Value>> {
     // Otherwise, iter is the insertion point
     iter = Vector::emplace(
         iter, std::make_pair(Key(key), Value(std::forward<Args>(args)...)));
+    indexInserted(static_cast<size_type>(iter - begin()));
+    return std::make_pair(iter, true);
+  }
+
+  /** Emplace a key-value pair that is expected to sort after every key
+   * already in the map, as when populating from an already sorted source
+   * such as a Tree's entries. When the expectation holds the pair is
+   * appended without the shifting insert that emplace() pays; otherwise
+   * this falls back to a regular emplace, so callers iterating a
+   * differently ordered source stay correct. */
+  template <typename... Args>
+  std::pair<iterator, bool> emplaceSorted(Piece key, Args&&... args) {
+    if (!empty() && !compare_(Vector::back().first, key)) {
+      return emplace(key, std::forward<Args>(args)...);
+    }
+
+    Vector::emplace_back(
+        std::make_pair(Key(key), Value(std::forward<Args>(args)...)));
+    if (foldedIndex_) {
+      // An append never shifts existing positions, so bulk population via
+      // emplaceSorted keeps O(1) index maintenance per entry.
+      (*foldedIndex_)[foldKey(key)] = size() - 1;
+    }
+    return std::make_pair(std::prev(end()), true);
+  }
+
+  /** Emplace overload taking ownership of an already constructed Key,
+   * avoiding a copy of the key's storage when the caller no longer needs
+   * it. */
+  template <typename... Args>
+  std::pair<iterator, bool> emplace(Key&& key, Args&&... args) {
+    auto iter = lower_bound(key.piece());
+
+    if (iter != end() && !compare_(key.piece(), iter->first)) {
+      // Found it; leave it alone
+      return std::make_pair(iter, false);
+    }
+
+    // Otherwise, iter is the insertion point
+    iter = Vector::emplace(
+        iter,
+        std::make_pair(std::move(key), Value(std::forward<Args>(args)...)));
+    indexInserted(static_cast<size_type>(iter - begin()));
     return std::make_pair(iter, true);
   }
 
@@ -248,6 +449,7 @@ class PathMap : private folly::fbvector<std::pair<Key, Value>> {
 
     // Not yet present, make a new one at the insertion point
     iter = Vector::insert(iter, std::make_pair(Key(key), mapped_type()));
+    indexInserted(static_cast<size_type>(iter - begin()));
     return iter->second;
   }
 
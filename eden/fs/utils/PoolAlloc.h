@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#pragma once
+
+#include <folly/MPMCQueue.h>
+#include <cassert>
+#include <cstddef>
+#include <new>
+
+namespace facebook::eden {
+
+/**
+ * A mixin that recycles a class's allocations through a fixed-capacity pool.
+ *
+ * Objects allocated and freed at high rates - one per filesystem request,
+ * say - spend a measurable fraction of their cost in the allocator. Deriving
+ * from PoolAlloc<T> replaces T's operator new and operator delete: new pops
+ * a previously-freed block from a lock-free pool when one is available, and
+ * delete pushes the block back unless the pool is already full. When the
+ * pool is empty or full, behavior degrades gracefully to the global
+ * allocator, so the pool's capacity bounds memory held in reserve rather
+ * than limiting concurrency.
+ *
+ * The pool hands out blocks sized exactly for T, so only the most-derived
+ * class may mix in PoolAlloc. Allocations of any other size (for example, a
+ * further-derived class) bypass the pool. The pool itself is never
+ * destroyed; blocks it holds at shutdown are intentionally leaked.
+ */
+template <typename T, size_t kCapacity = 256>
+class PoolAlloc {
+ public:
+  static void* operator new(std::size_t size) {
+    static_assert(
+        alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__,
+        "PoolAlloc only supports default-aligned types");
+    if (size != sizeof(T)) {
+      return ::operator new(size);
+    }
+    void* recycled;
+    if (pool().read(recycled)) {
+      return recycled;
+    }
+    return ::operator new(size);
+  }
+
+  static void operator delete(void* ptr, std::size_t size) {
+    if (size != sizeof(T) || !pool().write(ptr)) {
+      ::operator delete(ptr);
+    }
+  }
+
+ private:
+  static folly::MPMCQueue<void*>& pool() {
+    static auto* instance = new folly::MPMCQueue<void*>{kCapacity};
+    return *instance;
+  }
+};
+
+} // namespace facebook::eden
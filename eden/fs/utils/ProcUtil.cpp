@@ -12,6 +12,7 @@
 #include <optional>
 #include <vector>
 
+#include <fmt/core.h>
 #include <folly/Conv.h>
 #include <folly/FileUtil.h>
 #include <folly/String.h>
@@ -286,4 +287,42 @@ ProcessList readProcessIdsForPath(FOLLY_MAYBE_UNUSED const AbsolutePath& path) {
   return pids;
 }
 
+std::optional<pid_t> getParentProcessId(FOLLY_MAYBE_UNUSED pid_t pid) {
+#ifdef __linux__
+  std::string contents;
+  if (!folly::readFile(
+          fmt::format("/proc/{}/stat", pid).c_str(), contents)) {
+    return std::nullopt;
+  }
+  // The comm field is surrounded by parentheses and may itself contain
+  // spaces and parentheses, so scan from the last ')'. The fields after it
+  // are the process state followed by the parent pid.
+  auto pos = contents.rfind(')');
+  if (pos == std::string::npos) {
+    return std::nullopt;
+  }
+  std::vector<folly::StringPiece> fields;
+  folly::split(
+      ' ', folly::StringPiece{contents}.subpiece(pos + 1), fields, true);
+  if (fields.size() < 2) {
+    return std::nullopt;
+  }
+  auto ppid = folly::tryTo<pid_t>(fields[1]);
+  if (!ppid.hasValue()) {
+    return std::nullopt;
+  }
+  return ppid.value();
+#elif defined(__APPLE__)
+  struct proc_bsdinfo info {};
+  auto rc =
+      proc_pidinfo(pid, PROC_PIDTBSDINFO, 0, &info, PROC_PIDTBSDINFO_SIZE);
+  if (rc != PROC_PIDTBSDINFO_SIZE) {
+    return std::nullopt;
+  }
+  return static_cast<pid_t>(info.pbi_ppid);
+#else
+  return std::nullopt;
+#endif
+}
+
 } // namespace facebook::eden::proc_util
@@ -133,5 +133,13 @@ using ProcessList = std::vector<pid_t>;
  */
 ProcessList readProcessIdsForPath(const AbsolutePath& path);
 
+/**
+ * Looks up the parent process ID of the given process.
+ *
+ * Returns std::nullopt if the process has already exited, if the lookup
+ * fails, or on platforms where the lookup is not implemented.
+ */
+std::optional<pid_t> getParentProcessId(pid_t pid);
+
 } // namespace proc_util
 } // namespace facebook::eden
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/utils/StringInterner.h"
+
+#include <cstring>
+
+namespace facebook::eden {
+
+StringInterner& StringInterner::get() {
+  static StringInterner* interner = new StringInterner;
+  return *interner;
+}
+
+std::string_view StringInterner::intern(std::string_view str) {
+  if (str.empty()) {
+    return std::string_view{};
+  }
+
+  auto it = map_.find(str);
+  if (it != map_.end()) {
+    return it->first;
+  }
+
+  auto copy = copyIntoArena(str);
+  // If another thread interned the same string while we were copying, insert
+  // returns its entry and our arena copy is wasted - harmless, and rare.
+  auto result = map_.insert(copy, 1);
+  return result.first->first;
+}
+
+std::string_view StringInterner::copyIntoArena(std::string_view str) {
+  std::lock_guard<std::mutex> g(arenaLock_);
+
+  char* dest;
+  if (str.size() > kBlockSize) {
+    // Oversized strings get a dedicated block, inserted before the current
+    // bump block so the bump block's remaining space isn't wasted.
+    auto block = std::make_unique<char[]>(str.size());
+    dest = block.get();
+    auto insertAt = blocks_.empty() ? blocks_.end() : blocks_.end() - 1;
+    blocks_.insert(insertAt, std::move(block));
+  } else {
+    if (currentBlockUsed_ + str.size() > kBlockSize) {
+      blocks_.push_back(std::make_unique<char[]>(kBlockSize));
+      currentBlockUsed_ = 0;
+    }
+    dest = blocks_.back().get() + currentBlockUsed_;
+    currentBlockUsed_ += str.size();
+  }
+
+  memcpy(dest, str.data(), str.size());
+  totalBytes_.fetch_add(str.size(), std::memory_order_relaxed);
+  return std::string_view{dest, str.size()};
+}
+
+} // namespace facebook::eden
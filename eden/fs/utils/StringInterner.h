@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+#include <folly/concurrency/ConcurrentHashMap.h>
+
+#include "eden/fs/utils/PathFuncs.h"
+
+namespace facebook::eden {
+
+/**
+ * A process-wide interner for frequently repeated strings, such as path
+ * components and glob result paths. The same names ("src", "BUCK",
+ * "__init__.py") are otherwise allocated over and over across hot
+ * structures.
+ *
+ * Interned strings are copied once into chunked storage that is never freed,
+ * so the returned views stay valid for the lifetime of the process. Looking
+ * up an already-interned string is lock-free; only the first occurrence of a
+ * string takes a mutex to copy it into the arena.
+ *
+ * Because storage is never reclaimed, only intern strings drawn from a
+ * bounded vocabulary - names of files that exist in the repository, not
+ * arbitrary user input. Total usage is visible via getTotalBytes() and the
+ * string_interner.memory counter.
+ */
+class StringInterner {
+ public:
+  /**
+   * Returns the process-wide interner. Leaked on purpose so interned views
+   * never dangle, even in late shutdown code.
+   */
+  static StringInterner& get();
+
+  /**
+   * Returns a view of an interned copy of str, valid for the lifetime of
+   * the process. Identical inputs always return the same view.
+   */
+  std::string_view intern(std::string_view str);
+
+  PathComponentPiece intern(PathComponentPiece piece) {
+    return PathComponentPiece{intern(piece.view())};
+  }
+
+  RelativePathPiece intern(RelativePathPiece piece) {
+    return RelativePathPiece{intern(piece.view())};
+  }
+
+  /**
+   * The number of distinct strings interned so far.
+   */
+  size_t getStringCount() const {
+    return map_.size();
+  }
+
+  /**
+   * Arena bytes used by interned string data.
+   */
+  size_t getTotalBytes() const {
+    return totalBytes_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  StringInterner() = default;
+  StringInterner(const StringInterner&) = delete;
+  StringInterner& operator=(const StringInterner&) = delete;
+
+  std::string_view copyIntoArena(std::string_view str);
+
+  static constexpr size_t kBlockSize = 64 * 1024;
+
+  /**
+   * Maps each interned string to itself: the key is a view into the arena
+   * and doubles as the canonical copy handed back to callers.
+   */
+  folly::ConcurrentHashMap<std::string_view, uint8_t> map_;
+
+  std::mutex arenaLock_;
+  std::vector<std::unique_ptr<char[]>> blocks_;
+  size_t currentBlockUsed_{kBlockSize};
+  std::atomic<size_t> totalBytes_{0};
+};
+
+} // namespace facebook::eden
@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/utils/StripedSerialExecutor.h"
+
+#include <folly/executors/SerialExecutor.h>
+
+#include "eden/fs/utils/Bug.h"
+
+namespace facebook::eden {
+
+StripedSerialExecutor::StripedSerialExecutor(
+    folly::Executor::KeepAlive<> parent,
+    size_t numLanes) {
+  if (numLanes == 0) {
+    EDEN_BUG() << "StripedSerialExecutor requires at least one lane";
+  }
+  lanes_.reserve(numLanes);
+  for (size_t i = 0; i < numLanes; ++i) {
+    lanes_.push_back(folly::SerialExecutor::create(parent));
+  }
+}
+
+StripedSerialExecutor::~StripedSerialExecutor() = default;
+
+void StripedSerialExecutor::add(folly::Func func) {
+  auto lane = next_.fetch_add(1, std::memory_order_relaxed) % lanes_.size();
+  lanes_[lane]->add(std::move(func));
+}
+
+} // namespace facebook::eden
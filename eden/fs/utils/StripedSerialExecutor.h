@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include <folly/Executor.h>
+
+namespace folly {
+class SerialExecutor;
+}
+
+namespace facebook::eden {
+
+/**
+ * An Executor that stripes work across a fixed number of serialized lanes
+ * running on a shared parent executor.
+ *
+ * Each EdenMount routes its background work through its own
+ * StripedSerialExecutor over the server's CPU pool. Because a lane runs at
+ * most one task at a time, a group with N lanes can occupy at most N of the
+ * parent pool's threads no matter how much work it enqueues, so one mount's
+ * storm cannot crowd every other mount out of the pool. Keeping a mount's
+ * work on a few threads at a time also keeps its hot structures - InodeMap
+ * buckets, caches - warmer than letting every pool thread take a turn.
+ *
+ * Idle lanes cost nothing: parent pool threads serve whichever lanes have
+ * work, so threads left idle by one group remain available to the others.
+ *
+ * Tasks submitted through add() are distributed round-robin and may run
+ * concurrently with each other; this class provides no ordering guarantees
+ * across tasks.
+ */
+class StripedSerialExecutor : public folly::Executor {
+ public:
+  /**
+   * Creates numLanes serialized lanes over the given parent executor.
+   * numLanes must be non-zero; it is typically a small fraction of the
+   * parent pool's thread count.
+   */
+  StripedSerialExecutor(folly::Executor::KeepAlive<> parent, size_t numLanes);
+  ~StripedSerialExecutor() override;
+
+  StripedSerialExecutor(const StripedSerialExecutor&) = delete;
+  StripedSerialExecutor& operator=(const StripedSerialExecutor&) = delete;
+  StripedSerialExecutor(StripedSerialExecutor&&) = delete;
+  StripedSerialExecutor& operator=(StripedSerialExecutor&&) = delete;
+
+  /**
+   * Enqueues func on the next lane, round-robin. Never blocks and never runs
+   * func inline, matching the guarantees of UnboundedQueueExecutor.
+   */
+  void add(folly::Func func) override;
+
+ private:
+  std::vector<folly::Executor::KeepAlive<folly::SerialExecutor>> lanes_;
+  std::atomic<uint64_t> next_{0};
+};
+
+} // namespace facebook::eden
@@ -0,0 +1,231 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/utils/ThreadSampler.h"
+
+#include <fmt/core.h>
+#include <folly/Demangle.h>
+#include <folly/logging/xlog.h>
+#include <folly/system/ThreadName.h>
+
+#include <algorithm>
+
+#include "eden/fs/utils/IDGen.h"
+
+#ifdef __linux__
+#include <folly/experimental/symbolizer/StackTrace.h>
+#include <folly/experimental/symbolizer/Symbolizer.h>
+#include <signal.h>
+#endif
+
+namespace facebook::eden {
+
+#ifdef __linux__
+
+namespace {
+
+/**
+ * Staging area shared between the sampler thread and the SIGPROF handler.
+ * The sampler thread clears gStagingDone, interrupts one registered thread,
+ * and waits for the handler on that thread to capture its stack into
+ * gStagingFrames and set gStagingDone.
+ *
+ * If a target thread is blocked with signals masked the wait below times
+ * out, and a late-arriving handler may overwrite the staging buffer while
+ * the next thread is being sampled.  That can at worst attribute one sample
+ * to the wrong thread, which is acceptable noise for a profiler and avoids
+ * any synchronization on the signal handler side.
+ */
+uintptr_t gStagingFrames[ThreadSampler::kMaxFrames];
+std::atomic<size_t> gStagingNumFrames{0};
+std::atomic<bool> gStagingDone{false};
+
+void sigprofHandler(int /*signum*/, siginfo_t* /*info*/, void* /*ucontext*/) {
+  auto n = folly::symbolizer::getStackTraceSafe(
+      gStagingFrames, ThreadSampler::kMaxFrames);
+  gStagingNumFrames.store(
+      n > 0 ? static_cast<size_t>(n) : 0, std::memory_order_release);
+  gStagingDone.store(true, std::memory_order_release);
+}
+
+} // namespace
+
+ThreadSampler::Registration::Registration(std::string threadName)
+    : id_{generateUniqueID()} {
+  ThreadSampler::get().threads_.wlock()->emplace(
+      id_, RegisteredThread{pthread_self(), std::move(threadName)});
+}
+
+ThreadSampler::Registration::~Registration() {
+  ThreadSampler::get().threads_.wlock()->erase(id_);
+}
+
+void ThreadSampler::start(std::chrono::milliseconds interval) {
+  if (running_.exchange(true, std::memory_order_acq_rel)) {
+    return;
+  }
+
+  struct sigaction action = {};
+  action.sa_sigaction = sigprofHandler;
+  action.sa_flags = SA_SIGINFO | SA_RESTART;
+  sigemptyset(&action.sa_mask);
+  if (sigaction(SIGPROF, &action, nullptr) != 0) {
+    XLOG(WARN) << "Unable to install SIGPROF handler; "
+                  "the sampling profiler is disabled";
+    running_.store(false, std::memory_order_release);
+    return;
+  }
+
+  interval_ = interval;
+  XLOG(INFO) << "Starting the sampling profiler with a "
+             << interval_.count() << "ms interval";
+  thread_ = std::thread([this] { samplerThread(); });
+}
+
+void ThreadSampler::stop() {
+  if (!running_.exchange(false, std::memory_order_acq_rel)) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> guard{stopMutex_};
+  }
+  stopCv_.notify_all();
+  thread_.join();
+}
+
+void ThreadSampler::samplerThread() noexcept {
+  folly::setThreadName("EdenSampler");
+
+  // Warm up the unwinder on this thread before interrupting anyone else;
+  // the first capture may lazily initialize state that is not safe to set
+  // up from a signal handler.
+  (void)folly::symbolizer::getStackTraceSafe(gStagingFrames, kMaxFrames);
+
+  while (running_.load(std::memory_order_acquire)) {
+    auto threads = [&] {
+      std::vector<RegisteredThread> copy;
+      auto state = threads_.rlock();
+      copy.reserve(state->size());
+      for (const auto& entry : *state) {
+        copy.push_back(entry.second);
+      }
+      return copy;
+    }();
+
+    for (const auto& thread : threads) {
+      gStagingDone.store(false, std::memory_order_release);
+      if (pthread_kill(thread.handle, SIGPROF) != 0) {
+        continue;
+      }
+
+      // Bounded wait so a thread parked with SIGPROF masked cannot wedge
+      // the sampler.
+      bool done = false;
+      for (int i = 0; i < 10000; ++i) {
+        if (gStagingDone.load(std::memory_order_acquire)) {
+          done = true;
+          break;
+        }
+        std::this_thread::yield();
+      }
+      if (!done) {
+        continue;
+      }
+
+      RawSample sample;
+      sample.timestamp = std::chrono::system_clock::now();
+      sample.threadName = thread.name;
+      sample.numFrames = std::min(
+          gStagingNumFrames.load(std::memory_order_acquire), kMaxFrames);
+      std::copy_n(gStagingFrames, sample.numFrames, sample.frames.begin());
+
+      auto ring = ring_.wlock();
+      auto slot = ring->next % kMaxBufferedSamples;
+      if (slot < ring->samples.size()) {
+        ring->samples[slot] = std::move(sample);
+      } else {
+        ring->samples.push_back(std::move(sample));
+      }
+      ++ring->next;
+    }
+
+    std::unique_lock<std::mutex> lock{stopMutex_};
+    stopCv_.wait_for(lock, interval_, [this] {
+      return !running_.load(std::memory_order_acquire);
+    });
+  }
+}
+
+std::vector<ThreadSampler::Sample> ThreadSampler::getSamples(
+    std::chrono::system_clock::time_point since) {
+  std::vector<RawSample> raw;
+  {
+    auto ring = ring_.rlock();
+    raw.reserve(ring->samples.size());
+    for (const auto& sample : ring->samples) {
+      if (sample.timestamp >= since) {
+        raw.push_back(sample);
+      }
+    }
+  }
+  // The ring buffer is unordered once it has wrapped around.
+  std::sort(raw.begin(), raw.end(), [](const auto& a, const auto& b) {
+    return a.timestamp < b.timestamp;
+  });
+
+  folly::symbolizer::Symbolizer symbolizer;
+  std::vector<Sample> result;
+  result.reserve(raw.size());
+  for (auto& rawSample : raw) {
+    Sample sample;
+    sample.timestamp = rawSample.timestamp;
+    sample.threadName = std::move(rawSample.threadName);
+    sample.frames.reserve(rawSample.numFrames);
+    for (size_t i = 0; i < rawSample.numFrames; ++i) {
+      folly::symbolizer::SymbolizedFrame frame;
+      symbolizer.symbolize(rawSample.frames[i], frame);
+      if (frame.found && frame.name) {
+        sample.frames.push_back(folly::demangle(frame.name).toStdString());
+      } else {
+        sample.frames.push_back(fmt::format("{:#x}", rawSample.frames[i]));
+      }
+    }
+    result.push_back(std::move(sample));
+  }
+  return result;
+}
+
+ThreadSampler::~ThreadSampler() {
+  stop();
+}
+
+#else // !__linux__
+
+ThreadSampler::Registration::Registration(std::string /*threadName*/)
+    : id_{0} {}
+
+ThreadSampler::Registration::~Registration() = default;
+
+void ThreadSampler::start(std::chrono::milliseconds /*interval*/) {}
+
+void ThreadSampler::stop() {}
+
+std::vector<ThreadSampler::Sample> ThreadSampler::getSamples(
+    std::chrono::system_clock::time_point /*since*/) {
+  return {};
+}
+
+ThreadSampler::~ThreadSampler() = default;
+
+#endif // __linux__
+
+ThreadSampler& ThreadSampler::get() {
+  static ThreadSampler* instance = new ThreadSampler();
+  return *instance;
+}
+
+} // namespace facebook::eden
@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#pragma once
+
+#include <folly/Synchronized.h>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#endif
+
+namespace facebook::eden {
+
+/**
+ * ThreadSampler is a lightweight in-process sampling profiler.
+ *
+ * Threads opt in to being sampled by constructing a
+ * ThreadSampler::Registration on their own stack for as long as they should
+ * be visible to the profiler.  While the sampler is running, a background
+ * thread periodically interrupts each registered thread with SIGPROF and
+ * records its call stack into a fixed-size ring buffer.  The most recent
+ * samples can be retrieved and symbolized after an incident has already
+ * happened, without perf(1) having been attached at the time.
+ *
+ * When the sampler is not running a Registration is nothing more than a map
+ * insertion, and unregistered threads are never interrupted, so the cost of
+ * keeping this compiled in is negligible.
+ *
+ * Stack capture is only supported on Linux; on other platforms start() is a
+ * no-op and getSamples() always returns an empty vector.
+ */
+class ThreadSampler {
+ public:
+  /**
+   * Maximum number of stack frames captured per sample.  Deeper stacks are
+   * truncated at the innermost kMaxFrames frames.
+   */
+  static constexpr size_t kMaxFrames = 32;
+
+  /**
+   * One symbolized stack sample.
+   */
+  struct Sample {
+    std::chrono::system_clock::time_point timestamp;
+    std::string threadName;
+    /** Symbolized frames, innermost first. */
+    std::vector<std::string> frames;
+  };
+
+  /**
+   * Registers the calling thread for sampling for the lifetime of this
+   * object.  The object must be destroyed on the same thread that created
+   * it, before the thread exits.
+   */
+  class Registration {
+   public:
+    explicit Registration(std::string threadName);
+    ~Registration();
+
+    Registration(const Registration&) = delete;
+    Registration& operator=(const Registration&) = delete;
+    Registration(Registration&&) = delete;
+    Registration& operator=(Registration&&) = delete;
+
+   private:
+    uint64_t id_;
+  };
+
+  /**
+   * Returns the process-wide sampler instance.
+   */
+  static ThreadSampler& get();
+
+  /**
+   * Starts the sampler thread, interrupting each registered thread once per
+   * interval.  Does nothing if the sampler is already running or if stack
+   * capture is unsupported on this platform.
+   */
+  void start(std::chrono::milliseconds interval);
+
+  /**
+   * Stops the sampler thread.  Buffered samples are retained so they can
+   * still be retrieved afterwards.
+   */
+  void stop();
+
+  bool isRunning() const {
+    return running_.load(std::memory_order_acquire);
+  }
+
+  /**
+   * Returns the buffered samples taken at or after the given time, oldest
+   * first.  Symbolization is performed here rather than at capture time so
+   * that the sampling fast path stays cheap.
+   */
+  std::vector<Sample> getSamples(std::chrono::system_clock::time_point since);
+
+ private:
+  /**
+   * Number of samples retained in the ring buffer.  At the default 100ms
+   * sampling interval this holds several minutes of history even with a few
+   * dozen registered threads.
+   */
+  static constexpr size_t kMaxBufferedSamples = 64 * 1024;
+
+  struct RawSample {
+    std::chrono::system_clock::time_point timestamp;
+    std::string threadName;
+    size_t numFrames{0};
+    std::array<uintptr_t, kMaxFrames> frames;
+  };
+
+  struct Ring {
+    std::vector<RawSample> samples;
+    /** Monotonic insertion counter; insertion slot is next % capacity. */
+    size_t next{0};
+  };
+
+  ThreadSampler() = default;
+  ~ThreadSampler();
+
+  folly::Synchronized<Ring> ring_;
+  std::atomic<bool> running_{false};
+
+#ifdef __linux__
+  struct RegisteredThread {
+    pthread_t handle;
+    std::string name;
+  };
+
+  void samplerThread() noexcept;
+
+  folly::Synchronized<std::unordered_map<uint64_t, RegisteredThread>> threads_;
+  std::chrono::milliseconds interval_{0};
+  std::thread thread_;
+  std::mutex stopMutex_;
+  std::condition_variable stopCv_;
+#endif
+};
+
+} // namespace facebook::eden
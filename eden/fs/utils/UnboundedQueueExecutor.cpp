@@ -9,22 +9,82 @@
 
 #include <folly/executors/CPUThreadPoolExecutor.h>
 #include <folly/executors/ManualExecutor.h>
+#include <folly/executors/task_queue/PriorityUnboundedBlockingQueue.h>
 #include <folly/executors/task_queue/UnboundedBlockingQueue.h>
+#include <folly/executors/thread_factory/InitThreadFactory.h>
 #include <folly/executors/thread_factory/NamedThreadFactory.h>
 
+#include "eden/fs/utils/ThreadSampler.h"
+
 namespace facebook::eden {
 
+namespace {
+
+// Keeps each pool thread registered with the sampling profiler for its
+// entire lifetime; the thread_local destructor unregisters it just before
+// the thread exits.
+thread_local std::unique_ptr<ThreadSampler::Registration>
+    threadSamplerRegistration;
+
+std::unique_ptr<folly::BlockingQueue<folly::CPUThreadPoolExecutor::CPUTask>>
+makeTaskQueue(uint8_t numPriorities) {
+  if (numPriorities > 1) {
+    return std::make_unique<folly::PriorityUnboundedBlockingQueue<
+        folly::CPUThreadPoolExecutor::CPUTask>>(numPriorities);
+  }
+  return std::make_unique<
+      folly::UnboundedBlockingQueue<folly::CPUThreadPoolExecutor::CPUTask>>();
+}
+
+} // namespace
+
 UnboundedQueueExecutor::UnboundedQueueExecutor(
     size_t threadCount,
-    folly::StringPiece threadNamePrefix)
-    : executor_{std::make_unique<folly::CPUThreadPoolExecutor>(
+    folly::StringPiece threadNamePrefix,
+    uint8_t numPriorities)
+    : numPriorities_{numPriorities},
+      executor_{std::make_unique<folly::CPUThreadPoolExecutor>(
           threadCount,
-          std::make_unique<folly::UnboundedBlockingQueue<
-              folly::CPUThreadPoolExecutor::CPUTask>>(),
-          std::make_unique<folly::NamedThreadFactory>(threadNamePrefix))} {}
+          makeTaskQueue(numPriorities),
+          std::make_unique<folly::InitThreadFactory>(
+              std::make_shared<folly::NamedThreadFactory>(threadNamePrefix),
+              [name = threadNamePrefix.str()] {
+                threadSamplerRegistration =
+                    std::make_unique<ThreadSampler::Registration>(name);
+              },
+              [] { threadSamplerRegistration.reset(); }))} {}
 
 UnboundedQueueExecutor::UnboundedQueueExecutor(
     std::shared_ptr<folly::ManualExecutor> executor)
     : executor_{std::move(executor)} {}
 
+folly::Func UnboundedQueueExecutor::instrument(folly::Func func) {
+  stats_->queueDepth.fetch_add(1, std::memory_order_relaxed);
+  return [stats = stats_,
+          func = std::move(func),
+          enqueued = std::chrono::steady_clock::now()]() mutable {
+    auto delay = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - enqueued);
+    stats->lastQueueDelayUs.store(delay.count(), std::memory_order_relaxed);
+    stats->queueDepth.fetch_sub(1, std::memory_order_relaxed);
+    func();
+  };
+}
+
+void UnboundedQueueExecutor::add(folly::Func func) {
+  executor_->add(instrument(std::move(func)));
+}
+
+void UnboundedQueueExecutor::addWithPriority(
+    folly::Func func,
+    int8_t priority) {
+  if (numPriorities_ == 1) {
+    // The underlying executor has a single lane (or, for ManualExecutor,
+    // does not implement priorities at all).
+    add(std::move(func));
+    return;
+  }
+  executor_->addWithPriority(instrument(std::move(func)), priority);
+}
+
 } // namespace facebook::eden
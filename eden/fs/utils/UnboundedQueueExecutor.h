@@ -7,6 +7,10 @@
 
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <memory>
+
 #include <folly/Executor.h>
 #include <folly/Range.h>
 
@@ -22,16 +26,26 @@ namespace facebook::eden {
  *
  * Parts of Eden rely on queuing a function to be non-blocking for deadlock
  * safety.
+ *
+ * Because the queue is unbounded, overload is invisible unless something
+ * watches for it. Each executor therefore tracks its queue depth and the
+ * time tasks spend waiting in the queue; see getQueueDepth() and
+ * getLastQueueDelay().
  */
 class UnboundedQueueExecutor : public folly::Executor {
  public:
   /**
    * Instantiates with a folly::CPUThreadPoolExecutor with the given threadCount
    * and threadNamePrefix but with an unlimited queue.
+   *
+   * If numPriorities is greater than one, the queue has that many priority
+   * lanes and addWithPriority() schedules ahead of lower-priority work.
+   * add() enqueues at the middle priority.
    */
   explicit UnboundedQueueExecutor(
       size_t threadCount,
-      folly::StringPiece threadNamePrefix);
+      folly::StringPiece threadNamePrefix,
+      uint8_t numPriorities = 1);
 
   /**
    * ManualExecutors are unbounded too.
@@ -46,11 +60,54 @@ class UnboundedQueueExecutor : public folly::Executor {
   UnboundedQueueExecutor(UnboundedQueueExecutor&&) = delete;
   UnboundedQueueExecutor& operator=(UnboundedQueueExecutor&&) = delete;
 
-  void add(folly::Func func) override {
-    executor_->add(std::move(func));
+  void add(folly::Func func) override;
+
+  void addWithPriority(folly::Func func, int8_t priority) override;
+
+  uint8_t getNumPriorities() const override {
+    return numPriorities_;
+  }
+
+  /**
+   * The number of tasks that have been queued but not yet started.
+   */
+  size_t getQueueDepth() const noexcept {
+    return stats_->queueDepth.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * How long the most recently started task waited in the queue. This is a
+   * cheap backpressure signal: it stays near zero unless every pool thread
+   * is busy.
+   */
+  std::chrono::microseconds getLastQueueDelay() const noexcept {
+    return std::chrono::microseconds{
+        stats_->lastQueueDelayUs.load(std::memory_order_relaxed)};
   }
 
  private:
+  /**
+   * Queue accounting lives behind a shared_ptr because wrapped tasks handed
+   * to a ManualExecutor can outlive this object in tests.
+   */
+  struct QueueStats {
+    std::atomic<size_t> queueDepth{0};
+    std::atomic<uint64_t> lastQueueDelayUs{0};
+  };
+
+  /**
+   * Wraps func so that it updates the queue accounting when it starts
+   * running.
+   */
+  folly::Func instrument(folly::Func func);
+
+  std::shared_ptr<QueueStats> stats_{std::make_shared<QueueStats>()};
+  uint8_t numPriorities_{1};
+
+  /**
+   * Declared last so pool threads are joined before the other members are
+   * destroyed.
+   */
   std::shared_ptr<folly::Executor> executor_;
 };
 
@@ -20,7 +20,9 @@
 #include <folly/portability/Sockets.h>
 #include <folly/portability/SysUio.h>
 #include <algorithm>
+#include <cstring>
 #include <new>
+#include <tuple>
 #ifdef __APPLE__
 #include <sys/ucred.h> // @manual
 #endif
@@ -58,6 +60,15 @@ namespace {
  * linux/include/net/scm.h
  */
 constexpr size_t kMaxFDs = 253;
+
+/**
+ * The size of the receive arena that header reads over-read into.
+ *
+ * This bounds how much of a backlog of small messages can be drained from
+ * the socket with a single recvmsg() call.  Messages larger than this are
+ * still received directly into their own buffers.
+ */
+constexpr size_t kReceiveArenaSize = 64 * 1024;
 } // namespace
 
 class UnixSocket::Connector : private folly::EventHandler, folly::AsyncTimeout {
@@ -486,24 +497,37 @@ void UnixSocket::trySend() {
   // break out after sending MAX_MSGS_AT_ONCE, just to yield the event loop
   // so that we don't starve other events that need to be handled.
   constexpr unsigned int MAX_MSGS_AT_ONCE = 10;
-  for (unsigned int n = 0; n < MAX_MSGS_AT_ONCE; ++n) {
-    if (!sendQueue_) {
-      break;
+  unsigned int numSent = 0;
+  while (numSent < MAX_MSGS_AT_ONCE && sendQueue_) {
+    size_t fullySent;
+    bool blocked;
+    if (sendQueue_->message.files.empty() && sendQueue_->next &&
+        sendQueue_->next->message.files.empty()) {
+      // Several FD-free messages are queued up; coalesce them into a single
+      // vectored write rather than paying one sendmsg() wakeup per message.
+      std::tie(fullySent, blocked) = trySendBatch(MAX_MSGS_AT_ONCE - numSent);
+    } else {
+      blocked = !trySendMessage(sendQueue_.get());
+      fullySent = blocked ? 0 : 1;
+    }
+
+    for (size_t n = 0; n < fullySent; ++n) {
+      auto* callback = sendQueue_->callback;
+      sendQueue_ = std::move(sendQueue_->next);
+      if (!sendQueue_) {
+        sendQueueTail_ = nullptr;
+      }
+      if (callback) {
+        callback->sendSuccess();
+      }
     }
+    numSent += fullySent;
 
-    if (!trySendMessage(sendQueue_.get())) {
-      // The write blocked, and we need to retry this message again
+    if (blocked) {
+      // The write blocked, and we need to retry the current message again
       // after waiting for the socket to become writable.
       break;
     }
-    auto* callback = sendQueue_->callback;
-    sendQueue_ = std::move(sendQueue_->next);
-    if (!sendQueue_) {
-      sendQueueTail_ = nullptr;
-    }
-    if (callback) {
-      callback->sendSuccess();
-    }
   }
 
   // Update our I/O event and timeout registration
@@ -606,6 +630,78 @@ bool UnixSocket::trySendMessage(SendQueueEntry* entry) {
       entry->filesSent == entry->message.files.size());
 }
 
+std::pair<size_t, bool> UnixSocket::trySendBatch(size_t maxMessages) {
+  // Cap the number of iovec entries gathered per batch.  This is well under
+  // IOV_MAX everywhere we run, and bounds the stack usage here.
+  constexpr size_t kBatchIovecs = 64;
+  struct iovec iov[kBatchIovecs];
+
+  size_t iovCount = 0;
+  size_t numMessages = 0;
+  for (SendQueueEntry* entry = sendQueue_.get();
+       entry && numMessages < maxMessages;
+       entry = entry->next.get()) {
+    if (!entry->message.files.empty()) {
+      // Messages carrying FDs need their own sendmsg() call for the
+      // SCM_RIGHTS control data.
+      break;
+    }
+    size_t entryIovs = entry->iovCount - entry->iovIndex;
+    if (iovCount + entryIovs > kBatchIovecs) {
+      break;
+    }
+    memcpy(
+        iov + iovCount,
+        entry->iov + entry->iovIndex,
+        entryIovs * sizeof(struct iovec));
+    iovCount += entryIovs;
+    ++numMessages;
+  }
+  XDCHECK_GE(numMessages, 1ul);
+
+  struct msghdr msg = {};
+  msg.msg_iov = iov;
+  msg.msg_iovlen = iovCount;
+  XLOG(DBG9) << "trySendBatch(): numMessages=" << numMessages
+             << " iovCount=" << iovCount;
+
+  auto bytesSent = sendmsg(socket_.fd(), &msg, MSG_DONTWAIT);
+  XLOG(DBG9) << "sendmsg() returned " << bytesSent;
+  if (bytesSent < 0) {
+    if (errno == EAGAIN) {
+      return {0, true};
+    }
+    throwSystemError("sendmsg() failed on UnixSocket");
+  }
+
+  // Walk the queue again and account for the data that was sent, popping off
+  // each entry that was fully transmitted.
+  size_t fullySent = 0;
+  size_t remaining = static_cast<size_t>(bytesSent);
+  SendQueueEntry* entry = sendQueue_.get();
+  while (entry && remaining > 0) {
+    while (remaining > 0 && entry->iovIndex < entry->iovCount) {
+      auto* cur = entry->iov + entry->iovIndex;
+      if (remaining >= cur->iov_len) {
+        remaining -= cur->iov_len;
+        ++entry->iovIndex;
+      } else {
+        cur->iov_len -= remaining;
+        cur->iov_base = static_cast<char*>(cur->iov_base) + remaining;
+        remaining = 0;
+      }
+    }
+    if (entry->iovIndex == entry->iovCount) {
+      ++fullySent;
+      entry = entry->next.get();
+    }
+  }
+
+  // A short write means the kernel buffer filled up; wait for the socket to
+  // become writable before sending the rest.
+  return {fullySent, fullySent < numMessages};
+}
+
 size_t UnixSocket::initializeFirstControlMsg(
     vector<uint8_t>& controlBuf,
     struct msghdr* msg,
@@ -679,6 +775,9 @@ void UnixSocket::setReceiveCallback(ReceiveCallback* callback) {
   eventBase_->dcheckIsInEventBaseThread();
   receiveCallback_ = callback;
   registerForReads();
+  // Messages over-read into the receive arena while no callback was
+  // installed will not trigger a READ event; process them now.
+  scheduleReceiveFromArena();
 }
 
 void UnixSocket::clearReceiveCallback() {
@@ -714,6 +813,30 @@ void UnixSocket::tryReceive() {
     headerBytesReceived_ = 0;
     receiveCallback_->messageReceived(Message{std::move(recvMessage_)});
   }
+
+  // If we stopped with over-read data still sitting in the receive arena,
+  // the socket itself may be drained and will not signal another READ
+  // event.  Schedule another pass so the buffered messages are not
+  // stranded.
+  scheduleReceiveFromArena();
+}
+
+void UnixSocket::scheduleReceiveFromArena() {
+  if (!receiveCallback_ || !recvArena_ || recvArena_->length() == 0) {
+    return;
+  }
+  eventBase_->runInLoop([this, guard = DestructorGuard(this)] {
+    if (!receiveCallback_ || closeStarted_) {
+      return;
+    }
+    try {
+      tryReceive();
+    } catch (...) {
+      auto ew = exception_wrapper{std::current_exception()};
+      XLOG(ERR) << "unix socket receive error: " << ew;
+      socketError(std::move(ew));
+    }
+  });
 }
 
 bool UnixSocket::tryReceiveOne() {
@@ -749,7 +872,24 @@ bool UnixSocket::tryReceiveOne() {
     }
 
     if (recvHeader_.dataSize > 0) {
-      recvMessage_.data = IOBuf(IOBuf::CREATE, recvHeader_.dataSize);
+      auto arenaBytes = recvArena_ ? recvArena_->length() : 0;
+      if (arenaBytes >= recvHeader_.dataSize) {
+        // The entire payload was already over-read into the receive arena.
+        // Hand out a zero-copy view of it rather than allocating and
+        // copying.
+        auto view = recvArena_->cloneOne();
+        view->trimEnd(arenaBytes - recvHeader_.dataSize);
+        recvArena_->trimStart(recvHeader_.dataSize);
+        recvMessage_.data = std::move(*view);
+      } else {
+        recvMessage_.data = IOBuf(IOBuf::CREATE, recvHeader_.dataSize);
+        if (arenaBytes > 0) {
+          memcpy(
+              recvMessage_.data.writableTail(), recvArena_->data(), arenaBytes);
+          recvMessage_.data.append(arenaBytes);
+          recvArena_->trimStart(arenaBytes);
+        }
+      }
     }
   }
 
@@ -815,16 +955,40 @@ void UnixSocket::processReceivedFiles(struct cmsghdr* cmsg) {
   }
 }
 
+folly::MutableByteRange UnixSocket::prepareReceiveArena() {
+  XDCHECK(!recvArena_ || recvArena_->length() == 0);
+  if (recvArena_ && !recvArena_->isShared()) {
+    // No outstanding message still references the arena, so rewind it and
+    // reuse the same allocation for the next batch of messages.
+    recvArena_->clear();
+  } else {
+    recvArena_ = IOBuf::create(kReceiveArenaSize);
+  }
+  return MutableByteRange{recvArena_->writableTail(), recvArena_->tailroom()};
+}
+
 ssize_t UnixSocket::callRecvMsg(MutableByteRange buf) {
-  struct iovec iov;
-  iov.iov_base = buf.data();
-  iov.iov_len = buf.size();
+  return callRecvMsg(buf, MutableByteRange{});
+}
+
+ssize_t UnixSocket::callRecvMsg(
+    MutableByteRange buf,
+    MutableByteRange overflow) {
+  struct iovec iov[2];
+  iov[0].iov_base = buf.data();
+  iov[0].iov_len = buf.size();
+  size_t iovCount = 1;
+  if (!overflow.empty()) {
+    iov[1].iov_base = overflow.data();
+    iov[1].iov_len = overflow.size();
+    iovCount = 2;
+  }
 
   struct msghdr msg;
   msg.msg_name = nullptr;
   msg.msg_namelen = 0;
-  msg.msg_iov = &iov;
-  msg.msg_iovlen = 1;
+  msg.msg_iov = iov;
+  msg.msg_iovlen = iovCount;
   msg.msg_control = recvControlBuffer_.data();
   msg.msg_controllen = recvControlBuffer_.size();
   msg.msg_flags = 0;
@@ -850,10 +1014,28 @@ ssize_t UnixSocket::callRecvMsg(MutableByteRange buf) {
 }
 
 bool UnixSocket::tryReceiveHeader() {
+  // First consume any bytes already over-read into the receive arena.
+  if (recvArena_ && recvArena_->length() > 0) {
+    auto arenaBytes = std::min<size_t>(
+        recvArena_->length(), recvHeaderBuffer_.size() - headerBytesReceived_);
+    memcpy(
+        recvHeaderBuffer_.data() + headerBytesReceived_,
+        recvArena_->data(),
+        arenaBytes);
+    recvArena_->trimStart(arenaBytes);
+    headerBytesReceived_ += arenaBytes;
+    if (headerBytesReceived_ == recvHeaderBuffer_.size()) {
+      return true;
+    }
+  }
+
   MutableByteRange buf{recvHeaderBuffer_.data(), recvHeaderBuffer_.size()};
   buf.advance(headerBytesReceived_);
 
-  auto bytesReceived = callRecvMsg(buf);
+  // Pass the arena's free space as a second iovec so a single recvmsg()
+  // call also drains the payload of this message and any further messages
+  // already queued in the socket buffer.
+  auto bytesReceived = callRecvMsg(buf, prepareReceiveArena());
   if (bytesReceived < 0) {
     if (errno == EAGAIN) {
       return false;
@@ -871,7 +1053,11 @@ bool UnixSocket::tryReceiveHeader() {
         "through a unix socket message header");
   }
 
-  headerBytesReceived_ += bytesReceived;
+  auto headerBytes = std::min<size_t>(bytesReceived, buf.size());
+  headerBytesReceived_ += headerBytes;
+  if (static_cast<size_t>(bytesReceived) > buf.size()) {
+    recvArena_->append(bytesReceived - buf.size());
+  }
   return headerBytesReceived_ == recvHeaderBuffer_.size();
 }
 
@@ -9,6 +9,7 @@
 
 #include <sys/types.h>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include <folly/File.h>
@@ -354,6 +355,17 @@ class UnixSocket : public folly::DelayedDestruction,
 
   void trySend();
   bool trySendMessage(SendQueueEntry* entry);
+
+  /**
+   * Attempt to send several consecutive queued messages with a single
+   * sendmsg() call.  Only messages without file descriptors can be combined,
+   * since SCM_RIGHTS control data must be attached to exactly one message.
+   *
+   * Returns the number of fully-sent entries at the head of the queue, and
+   * whether the write blocked (or was short) so the caller should wait for
+   * the socket to become writable again.
+   */
+  std::pair<size_t, bool> trySendBatch(size_t maxMessages);
   size_t initializeFirstControlMsg(
       std::vector<uint8_t>& controlBuf,
       struct msghdr* msg,
@@ -364,11 +376,30 @@ class UnixSocket : public folly::DelayedDestruction,
       SendQueueEntry* entry);
 
   void tryReceive();
+
+  /**
+   * Schedule an EventBase loop callback to continue processing messages
+   * buffered in the receive arena.  This is needed whenever receiving
+   * stops with unconsumed arena data, since the socket itself may be
+   * drained and will not signal another READ event.
+   */
+  void scheduleReceiveFromArena();
+
   bool tryReceiveOne();
   bool tryReceiveHeader();
   bool tryReceiveData();
   bool tryReceiveFiles();
 
+  /**
+   * Prepare the receive arena for an over-read, returning its free space.
+   *
+   * The existing arena allocation is rewound and reused if no
+   * previously-received message still references it; otherwise a fresh
+   * arena is allocated.  Must only be called when the arena contains no
+   * unconsumed data.
+   */
+  folly::MutableByteRange prepareReceiveArena();
+
   /**
    * Call recvmsg(), reading data into the supplied ByteRange.
    *
@@ -382,6 +413,16 @@ class UnixSocket : public folly::DelayedDestruction,
    */
   ssize_t callRecvMsg(folly::MutableByteRange buf);
 
+  /**
+   * Like callRecvMsg(buf), but passes overflow as a second iovec entry so
+   * any bytes already queued in the socket beyond buf land in overflow
+   * rather than requiring another syscall.  The return value counts bytes
+   * stored in both ranges.
+   */
+  ssize_t callRecvMsg(
+      folly::MutableByteRange buf,
+      folly::MutableByteRange overflow);
+
   void processReceivedControlData(struct msghdr* msg);
   void processReceivedFiles(struct cmsghdr* cmsg);
 
@@ -417,6 +458,24 @@ class UnixSocket : public folly::DelayedDestruction,
   Header recvHeader_{0, 0, 0};
   Message recvMessage_;
 
+  /**
+   * A reusable arena that header reads over-read into, so one recvmsg()
+   * call can pull in the payloads and headers of any further messages
+   * already queued in the socket buffer.  Subsequent messages are then
+   * carved out of the arena without additional syscalls, and small
+   * payloads are handed to the receive callback as zero-copy views of it.
+   *
+   * The region [data(), data() + length()) holds unconsumed received
+   * bytes; the tailroom is free space for the next over-read.
+   *
+   * SCM_RIGHTS attribution remains correct because the kernel never
+   * returns data spanning a control-data boundary from a single
+   * recvmsg() call, so file descriptors are always delivered by the read
+   * that starts the message they belong to, never buried in an over-read
+   * for an earlier message.
+   */
+  std::unique_ptr<folly::IOBuf> recvArena_;
+
   SendQueuePtr sendQueue_;
   SendQueueEntry* sendQueueTail_{nullptr};
 };
@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/common/utils/benchharness/Bench.h"
+
+#include "eden/fs/utils/CoverageSet.h"
+
+namespace {
+
+using namespace facebook::eden;
+
+constexpr size_t kReadSize = 128 * 1024;
+constexpr size_t kReadCount = 256;
+constexpr size_t kFileSize = kReadSize * kReadCount;
+
+void CoverageSet_sequential_read(benchmark::State& state) {
+  // The pattern FileInode follows while a blob is read front to back: each
+  // read records its range and then asks whether the whole file is covered.
+  uint64_t processed = 0;
+  for (auto _ : state) {
+    CoverageSet set;
+    for (size_t off = 0; off < kFileSize; off += kReadSize) {
+      set.add(off, off + kReadSize);
+      benchmark::DoNotOptimize(set.covers(0, kFileSize));
+    }
+    processed += kReadCount;
+  }
+  state.SetItemsProcessed(processed);
+}
+BENCHMARK(CoverageSet_sequential_read);
+
+void CoverageSet_strided_read(benchmark::State& state) {
+  // Every other block first, then the gaps, so no add extends the previous
+  // interval and the merge machinery does all the work.
+  uint64_t processed = 0;
+  for (auto _ : state) {
+    CoverageSet set;
+    for (size_t off = 0; off < kFileSize; off += 2 * kReadSize) {
+      set.add(off, off + kReadSize);
+    }
+    for (size_t off = kReadSize; off < kFileSize; off += 2 * kReadSize) {
+      set.add(off, off + kReadSize);
+      benchmark::DoNotOptimize(set.covers(0, kFileSize));
+    }
+    processed += kReadCount;
+  }
+  state.SetItemsProcessed(processed);
+}
+BENCHMARK(CoverageSet_strided_read);
+
+} // namespace
@@ -95,3 +95,42 @@ TEST(CoverageSetTest, merge_can_replace_many_nodes) {
   EXPECT_FALSE(s.covers(7, 9));
   EXPECT_TRUE(s.covers(1, 8));
 }
+
+TEST(CoverageSetTest, many_scattered_adds_merge) {
+  // Add enough disjoint intervals to force the pending buffer to be merged
+  // into the sorted storage several times, in an order that interleaves with
+  // previously-merged intervals.
+  CoverageSet s;
+  for (size_t i = 0; i < 100; i += 2) {
+    s.add(i * 10, i * 10 + 10);
+  }
+  EXPECT_EQ(50, s.getIntervalCount());
+  for (size_t i = 1; i < 100; i += 2) {
+    s.add(i * 10, i * 10 + 10);
+  }
+  EXPECT_EQ(1, s.getIntervalCount());
+  EXPECT_TRUE(s.covers(0, 1000));
+  EXPECT_FALSE(s.covers(0, 1001));
+}
+
+TEST(CoverageSetTest, covers_spanning_unmerged_intervals) {
+  // A query can be satisfied only by the union of intervals that have not
+  // been merged yet.
+  CoverageSet s;
+  s.add(10, 15);
+  s.add(0, 5);
+  s.add(5, 10);
+  EXPECT_TRUE(s.covers(0, 15));
+  EXPECT_FALSE(s.covers(0, 16));
+}
+
+TEST(CoverageSetTest, overlapping_adds_in_random_order) {
+  CoverageSet s;
+  s.add(20, 30);
+  s.add(0, 12);
+  s.add(25, 40);
+  s.add(10, 22);
+  EXPECT_EQ(1, s.getIntervalCount());
+  EXPECT_TRUE(s.covers(0, 40));
+  EXPECT_FALSE(s.covers(0, 41));
+}
@@ -488,4 +488,29 @@ TEST(Glob, testCaseInsensitive) {
   EXPECT_CASE_INSENSITIVE_NOMATCH("!", "[Zz]");
 }
 
+TEST(Glob, testCreateCached) {
+  // Repeated lookups of the same pattern return an equivalent matcher.
+  for (int i = 0; i < 2; i++) {
+    auto matcher = GlobMatcher::createCached("*.txt", GlobOptions::DEFAULT);
+    ASSERT_TRUE(matcher.hasValue());
+    EXPECT_TRUE(matcher.value().match("foo.txt"));
+    EXPECT_FALSE(matcher.value().match("foo.cpp"));
+  }
+
+  // The same pattern with different options must compile differently.
+  auto sensitive = GlobMatcher::createCached("*.TXT", GlobOptions::DEFAULT);
+  auto insensitive =
+      GlobMatcher::createCached("*.TXT", GlobOptions::CASE_INSENSITIVE);
+  ASSERT_TRUE(sensitive.hasValue());
+  ASSERT_TRUE(insensitive.hasValue());
+  EXPECT_FALSE(sensitive.value().match("foo.txt"));
+  EXPECT_TRUE(insensitive.value().match("foo.txt"));
+
+  // Invalid patterns fail on every call rather than being cached.
+  EXPECT_TRUE(
+      GlobMatcher::createCached("foo**bar", GlobOptions::DEFAULT).hasError());
+  EXPECT_TRUE(
+      GlobMatcher::createCached("foo**bar", GlobOptions::DEFAULT).hasError());
+}
+
 } // namespace
@@ -74,6 +74,25 @@ void ImmediateFuture_thenValue_with_exc(benchmark::State& state) {
 }
 BENCHMARK(ImmediateFuture_thenValue_with_exc);
 
+// Measures the per-link cost of continuations attached to a future that is
+// not yet ready, which is the path taken for every request that has to wait
+// on a backing fetch.
+void ImmediateFuture_pending_thenValue_chain(benchmark::State& state) {
+  constexpr int kChainLength = 8;
+  uint64_t processed = 0;
+  for (auto _ : state) {
+    auto [promise, semiFut] = folly::makePromiseContract<uint64_t>();
+    ImmediateFuture<uint64_t> fut{std::move(semiFut)};
+    for (int i = 0; i < kChainLength; ++i) {
+      fut = std::move(fut).thenValue([](uint64_t v) { return v + 1; });
+    }
+    promise.setValue(0);
+    processed += std::move(fut).get();
+  }
+  state.SetItemsProcessed(processed);
+}
+BENCHMARK(ImmediateFuture_pending_thenValue_chain);
+
 void folly_Future_thenValue_with_int(benchmark::State& state) {
   folly::Future<int> fut{0};
   for (auto _ : state) {
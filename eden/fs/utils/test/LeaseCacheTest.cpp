@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/utils/LeaseCache.h"
+#include <folly/portability/GTest.h>
+
+using namespace facebook::eden;
+
+namespace {
+using Cache = LeaseCache<int, std::string>;
+} // namespace
+
+TEST(LeaseCache, fetchesOncePerKey) {
+  size_t fetchCount = 0;
+  Cache cache{10, [&](const int& key) {
+                fetchCount++;
+                return folly::makeFuture(
+                    std::make_shared<std::string>(std::to_string(key)));
+              }};
+
+  EXPECT_EQ("5", *cache.get(5).get());
+  EXPECT_EQ("5", *cache.get(5).get());
+  EXPECT_EQ(1, fetchCount) << "second get was served from the cache";
+
+  EXPECT_EQ("7", *cache.get(7).get());
+  EXPECT_EQ(2, fetchCount);
+}
+
+TEST(LeaseCache, concurrentGetsShareOneFetch) {
+  size_t fetchCount = 0;
+  folly::Promise<Cache::ValuePtr> promise;
+  Cache cache{10, [&](const int&) {
+                fetchCount++;
+                return promise.getFuture();
+              }};
+
+  auto first = cache.get(1);
+  auto second = cache.get(1);
+  EXPECT_EQ(1, fetchCount) << "second get attached to the in-flight lease";
+  EXPECT_FALSE(first.isReady());
+  EXPECT_FALSE(second.isReady());
+
+  promise.setValue(std::make_shared<std::string>("one"));
+  EXPECT_EQ("one", *std::move(first).get());
+  EXPECT_EQ("one", *std::move(second).get());
+}
+
+TEST(LeaseCache, perCallFetcher) {
+  Cache cache{10};
+  auto value = cache.get(3, [](const int&) {
+    return folly::makeFuture(std::make_shared<std::string>("three"));
+  });
+  EXPECT_EQ("three", *std::move(value).get());
+  EXPECT_TRUE(cache.exists(3));
+}
+
+TEST(LeaseCache, setAndErase) {
+  size_t fetchCount = 0;
+  Cache cache{10, [&](const int& key) {
+                fetchCount++;
+                return folly::makeFuture(
+                    std::make_shared<std::string>(std::to_string(key)));
+              }};
+
+  cache.set(4, std::make_shared<std::string>("four"));
+  EXPECT_EQ("four", *cache.get(4).get());
+  EXPECT_EQ(0, fetchCount);
+
+  cache.erase(4);
+  EXPECT_FALSE(cache.exists(4));
+  EXPECT_EQ("4", *cache.get(4).get());
+  EXPECT_EQ(1, fetchCount);
+}
+
+TEST(LeaseCache, errorsPropagateToAllWaiters) {
+  folly::Promise<Cache::ValuePtr> promise;
+  Cache cache{10, [&](const int&) { return promise.getFuture(); }};
+
+  auto first = cache.get(9);
+  auto second = cache.get(9);
+  promise.setException(std::runtime_error("fetch failed"));
+  EXPECT_THROW(std::move(first).get(), std::runtime_error);
+  EXPECT_THROW(std::move(second).get(), std::runtime_error);
+}
+
+TEST(LeaseCache, manyKeysAcrossShards) {
+  size_t fetchCount = 0;
+  Cache cache{1000, [&](const int& key) {
+                fetchCount++;
+                return folly::makeFuture(
+                    std::make_shared<std::string>(std::to_string(key)));
+              }};
+
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(std::to_string(i), *cache.get(i).get());
+  }
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(std::to_string(i), *cache.get(i).get());
+  }
+  EXPECT_EQ(100, fetchCount);
+}
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/common/utils/benchharness/Bench.h"
+
+#include "eden/fs/utils/CaseSensitivity.h"
+#include "eden/fs/utils/PathFuncs.h"
+
+namespace {
+
+using namespace facebook::eden;
+
+// A path depth typical of deep monorepo sources.
+constexpr std::string_view kDeepPath{
+    "fbcode/eden/fs/store/hg/proxyhash/serialization/tests/data/"
+    "generated/fixtures/v2/ProxyHashSerializationRoundTripTest.cpp"};
+
+void PathFuncs_component_iteration(benchmark::State& state) {
+  RelativePathPiece path{kDeepPath};
+  uint64_t components = 0;
+  for (auto _ : state) {
+    for (auto component : path.components()) {
+      benchmark::DoNotOptimize(component);
+      components++;
+    }
+  }
+  state.SetItemsProcessed(components);
+}
+BENCHMARK(PathFuncs_component_iteration);
+
+void PathFuncs_reverse_component_iteration(benchmark::State& state) {
+  RelativePathPiece path{kDeepPath};
+  uint64_t components = 0;
+  for (auto _ : state) {
+    for (auto component : path.rcomponents()) {
+      benchmark::DoNotOptimize(component);
+      components++;
+    }
+  }
+  state.SetItemsProcessed(components);
+}
+BENCHMARK(PathFuncs_reverse_component_iteration);
+
+void PathFuncs_canonicalPath(benchmark::State& state) {
+  uint64_t processed = 0;
+  for (auto _ : state) {
+    auto path = canonicalPath(kDeepPath);
+    benchmark::DoNotOptimize(path);
+    processed++;
+  }
+  state.SetItemsProcessed(processed);
+}
+BENCHMARK(PathFuncs_canonicalPath);
+
+void PathFuncs_equal_case_insensitive(benchmark::State& state) {
+  // The common case on case-insensitive mounts: both sides have identical
+  // case, so the memcmp fast path applies.
+  RelativePathPiece left{kDeepPath};
+  RelativePathPiece right{kDeepPath};
+  uint64_t processed = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        isPathPieceEqual(left, right, CaseSensitivity::Insensitive));
+    processed++;
+  }
+  state.SetItemsProcessed(processed);
+}
+BENCHMARK(PathFuncs_equal_case_insensitive);
+
+void PathFuncs_equal_case_insensitive_folded(benchmark::State& state) {
+  // Differing case forces the byte-wise folding comparison.
+  RelativePathPiece left{kDeepPath};
+  std::string upper{kDeepPath};
+  upper.front() = 'F';
+  RelativePathPiece right{upper};
+  uint64_t processed = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        isPathPieceEqual(left, right, CaseSensitivity::Insensitive));
+    processed++;
+  }
+  state.SetItemsProcessed(processed);
+}
+BENCHMARK(PathFuncs_equal_case_insensitive_folded);
+
+} // namespace
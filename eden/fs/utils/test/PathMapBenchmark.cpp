@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/common/utils/benchharness/Bench.h"
+
+#include <fmt/core.h>
+
+#include "eden/fs/utils/PathMap.h"
+
+namespace {
+
+using namespace facebook::eden;
+
+constexpr size_t kEntryCount = 256;
+
+std::vector<PathComponent> makeComponents() {
+  std::vector<PathComponent> components;
+  components.reserve(kEntryCount);
+  for (size_t i = 0; i < kEntryCount; ++i) {
+    components.emplace_back(fmt::format("Entry{:03}.cpp", i));
+  }
+  return components;
+}
+
+PathMap<size_t> makeMap(CaseSensitivity caseSensitive) {
+  PathMap<size_t> map{caseSensitive};
+  size_t i = 0;
+  for (const auto& component : makeComponents()) {
+    map.emplace(component.piece(), i++);
+  }
+  return map;
+}
+
+void PathMap_find_case_sensitive(benchmark::State& state) {
+  auto map = makeMap(CaseSensitivity::Sensitive);
+  auto components = makeComponents();
+  uint64_t processed = 0;
+  for (auto _ : state) {
+    auto iter = map.find(components[processed % kEntryCount].piece());
+    benchmark::DoNotOptimize(iter);
+    processed++;
+  }
+  state.SetItemsProcessed(processed);
+}
+BENCHMARK(PathMap_find_case_sensitive);
+
+void PathMap_find_case_insensitive(benchmark::State& state) {
+  auto map = makeMap(CaseSensitivity::Insensitive);
+  auto components = makeComponents();
+  uint64_t processed = 0;
+  for (auto _ : state) {
+    auto iter = map.find(components[processed % kEntryCount].piece());
+    benchmark::DoNotOptimize(iter);
+    processed++;
+  }
+  state.SetItemsProcessed(processed);
+}
+BENCHMARK(PathMap_find_case_insensitive);
+
+void PathMap_insert_in_order(benchmark::State& state) {
+  auto components = makeComponents();
+  uint64_t processed = 0;
+  for (auto _ : state) {
+    // Component names are zero-padded so this inserts in sorted order and
+    // mostly appends to the underlying vector.
+    PathMap<size_t> map{CaseSensitivity::Sensitive};
+    for (const auto& component : components) {
+      map.emplace(component.piece(), processed);
+    }
+    benchmark::DoNotOptimize(map);
+    processed += kEntryCount;
+  }
+  state.SetItemsProcessed(processed);
+}
+BENCHMARK(PathMap_insert_in_order);
+
+void PathMap_emplace_sorted(benchmark::State& state) {
+  auto components = makeComponents();
+  uint64_t processed = 0;
+  for (auto _ : state) {
+    // The append path taken when populating a directory from sorted Tree
+    // entries.
+    PathMap<size_t> map{CaseSensitivity::Sensitive};
+    map.reserve(kEntryCount);
+    for (const auto& component : components) {
+      map.emplaceSorted(component.piece(), processed);
+    }
+    benchmark::DoNotOptimize(map);
+    processed += kEntryCount;
+  }
+  state.SetItemsProcessed(processed);
+}
+BENCHMARK(PathMap_emplace_sorted);
+
+void PathMap_insert_reverse_order(benchmark::State& state) {
+  auto components = makeComponents();
+  uint64_t processed = 0;
+  for (auto _ : state) {
+    // Every insert lands at the front of the vector and has to shift the
+    // existing entries, which is the worst case for the sorted-vector
+    // representation.
+    PathMap<size_t> map{CaseSensitivity::Sensitive};
+    for (auto iter = components.rbegin(); iter != components.rend(); ++iter) {
+      map.emplace(iter->piece(), processed);
+    }
+    benchmark::DoNotOptimize(map);
+    processed += kEntryCount;
+  }
+  state.SetItemsProcessed(processed);
+}
+BENCHMARK(PathMap_insert_reverse_order);
+
+} // namespace
+
+EDEN_BENCHMARK_MAIN();
@@ -126,6 +126,57 @@ TEST(PathMap, caseInSensitiveCopyMove) {
   EXPECT_TRUE(move_assign.at("Foo"_pc));
 }
 
+TEST(PathMap, caseInSensitiveFindAcrossMutations) {
+  // Case insensitive maps keep a folded-name index for find(); exercise the
+  // lookups after every kind of mutation to verify the index tracks the
+  // sorted vector.
+  PathMap<int> map(CaseSensitivity::Insensitive);
+
+  map.insert(std::make_pair(PathComponent("Delta"), 4));
+  map.emplace("alpha"_pc, 1);
+  map["Charlie"_pc] = 3;
+  EXPECT_EQ(1, map.at("ALPHA"_pc));
+  EXPECT_EQ(3, map.at("charlie"_pc));
+  EXPECT_EQ(4, map.at("delta"_pc));
+  EXPECT_EQ(map.end(), map.find("echo"_pc));
+
+  // Shifting insert in the middle: later entries move, lookups must follow.
+  map.emplace(PathComponent("Bravo"), 2);
+  EXPECT_EQ(2, map.at("bravo"_pc));
+  EXPECT_EQ(3, map.at("CHARLIE"_pc));
+  EXPECT_EQ(4, map.at("Delta"_pc));
+
+  // Erase from the middle by differing-case key.
+  EXPECT_EQ(1, map.erase("BRAVO"_pc));
+  EXPECT_EQ(map.end(), map.find("Bravo"_pc));
+  EXPECT_EQ(3, map.at("charlie"_pc));
+  EXPECT_EQ(4, map.at("delta"_pc));
+
+  // Erase by iterator.
+  auto iter = map.erase(map.find("ALPHA"_pc));
+  EXPECT_EQ(3, iter->second) << "iter advanced to next item";
+  EXPECT_EQ(map.end(), map.find("alpha"_pc));
+  EXPECT_EQ(4, map.at("DELTA"_pc));
+
+  // Range construction builds the index too.
+  std::vector<std::pair<PathComponent, int>> input = {
+      {PathComponent("Foo"), 1},
+      {PathComponent("bar"), 2},
+  };
+  PathMap<int> ranged(input.begin(), input.end(), CaseSensitivity::Insensitive);
+  EXPECT_EQ(1, ranged.at("foo"_pc));
+  EXPECT_EQ(2, ranged.at("BAR"_pc));
+
+  // emplaceSorted's append fast path maintains the index.
+  EXPECT_TRUE(ranged.emplaceSorted("quux"_pc, 3).second);
+  EXPECT_EQ(3, ranged.at("QUUX"_pc));
+
+  ranged.clear();
+  EXPECT_EQ(ranged.end(), ranged.find("Foo"_pc));
+  ranged["Foo"_pc] = 9;
+  EXPECT_EQ(9, ranged.at("foo"_pc));
+}
+
 TEST(PathMap, insert) {
   PathMap<bool> map(kPathMapDefaultCaseSensitive);
 
@@ -244,6 +295,46 @@ TEST(PathMap, emplace) {
   EXPECT_TRUE(map.at("one"_pc).dummy) << "didn't change value to false";
 }
 
+TEST(PathMap, rangeConstructSortsAndDedupes) {
+  // Out-of-order input with a duplicated key: the map must end up sorted and
+  // the first occurrence of the duplicate must win, matching insert().
+  std::vector<std::pair<PathComponent, int>> input = {
+      {PathComponent("banana"), 1},
+      {PathComponent("apple"), 2},
+      {PathComponent("banana"), 3},
+      {PathComponent("cherry"), 4},
+  };
+  PathMap<int> map(input.begin(), input.end(), CaseSensitivity::Sensitive);
+
+  EXPECT_EQ(3, map.size());
+  EXPECT_EQ(2, map.at("apple"_pc));
+  EXPECT_EQ(1, map.at("banana"_pc)) << "first occurrence wins";
+  EXPECT_EQ(4, map.at("cherry"_pc));
+  EXPECT_TRUE(std::is_sorted(
+      map.begin(), map.end(), [](const auto& a, const auto& b) {
+        return a.first < b.first;
+      }));
+}
+
+TEST(PathMap, emplaceSorted) {
+  PathMap<int> map(CaseSensitivity::Sensitive);
+
+  // In-order keys append.
+  EXPECT_TRUE(map.emplaceSorted("apple"_pc, 1).second);
+  EXPECT_TRUE(map.emplaceSorted("banana"_pc, 2).second);
+
+  // An out-of-order key falls back to a regular emplace.
+  EXPECT_TRUE(map.emplaceSorted("aardvark"_pc, 3).second);
+  EXPECT_EQ(3, map.size());
+  EXPECT_EQ(3, map.begin()->second) << "aardvark sorted to the front";
+
+  // Duplicates are left unaltered on both paths.
+  EXPECT_FALSE(map.emplaceSorted("banana"_pc, 4).second);
+  EXPECT_FALSE(map.emplaceSorted("aardvark"_pc, 5).second);
+  EXPECT_EQ(2, map.at("banana"_pc));
+  EXPECT_EQ(3, map.at("aardvark"_pc));
+}
+
 TEST(PathMap, swap) {
   PathMap<std::string> b(kPathMapDefaultCaseSensitive),
       a({std::make_pair(PathComponent("foo"), "foo")},
@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/utils/PoolAlloc.h"
+
+#include <memory>
+#include <vector>
+
+#include <folly/portability/GTest.h>
+
+using namespace facebook::eden;
+
+namespace {
+
+struct PooledThing : PoolAlloc<PooledThing, 4> {
+  char payload[64];
+};
+
+struct PooledBase : PoolAlloc<PooledBase, 4> {
+  virtual ~PooledBase() = default;
+  char payload[16];
+};
+
+struct DerivedThing : PooledBase {
+  char extra[32];
+};
+
+} // namespace
+
+TEST(PoolAlloc, recyclesAllocations) {
+  // Drain the pool by holding more live objects than its capacity, so the
+  // delete/new pair below is deterministic regardless of test order.
+  std::vector<PooledThing*> held;
+  for (int i = 0; i < 5; ++i) {
+    held.push_back(new PooledThing);
+  }
+
+  auto* first = held.back();
+  held.pop_back();
+  void* firstAddress = first;
+  delete first;
+
+  // With no other threads touching the pool, the next allocation must pop
+  // the block we just returned.
+  auto* second = new PooledThing;
+  EXPECT_EQ(firstAddress, static_cast<void*>(second));
+  delete second;
+
+  for (auto* thing : held) {
+    delete thing;
+  }
+}
+
+TEST(PoolAlloc, overflowFallsBackToHeap) {
+  // Allocate well past the pool capacity, then free everything. The pool
+  // keeps only its capacity; the rest goes back to the heap. Nothing to
+  // assert beyond not crashing and not double-freeing under ASAN.
+  std::vector<PooledThing*> things;
+  for (int i = 0; i < 32; ++i) {
+    things.push_back(new PooledThing);
+  }
+  for (auto* thing : things) {
+    delete thing;
+  }
+}
+
+TEST(PoolAlloc, derivedClassBypassesPool) {
+  // DerivedThing is larger than PooledBase, so its allocations must not mix
+  // with PooledBase's pool even when deleted through the base pointer.
+  std::unique_ptr<PooledBase> base{new PooledBase};
+  std::unique_ptr<PooledBase> derived{new DerivedThing};
+  base.reset();
+  derived.reset();
+
+  auto* again = new PooledBase;
+  delete again;
+}
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/utils/StringInterner.h"
+
+#include <thread>
+#include <vector>
+
+#include <folly/portability/GTest.h>
+
+using namespace facebook::eden;
+using namespace facebook::eden::path_literals;
+
+TEST(StringInterner, identicalStringsShareStorage) {
+  auto& interner = StringInterner::get();
+
+  auto first = interner.intern(std::string_view{"src/BUCK.interner-test"});
+  std::string copy = "src/BUCK.interner-test";
+  auto second = interner.intern(std::string_view{copy});
+
+  EXPECT_EQ(first, second);
+  EXPECT_EQ(first.data(), second.data()) << "both views share one copy";
+}
+
+TEST(StringInterner, internedViewOutlivesInput) {
+  auto& interner = StringInterner::get();
+
+  std::string_view interned;
+  {
+    std::string input = "some/deep/path/component.interner-test";
+    interned = interner.intern(std::string_view{input});
+  }
+  EXPECT_EQ("some/deep/path/component.interner-test", interned);
+}
+
+TEST(StringInterner, emptyString) {
+  auto& interner = StringInterner::get();
+  EXPECT_EQ(std::string_view{}, interner.intern(std::string_view{}));
+}
+
+TEST(StringInterner, pathPieces) {
+  auto& interner = StringInterner::get();
+
+  auto component = interner.intern("__init__.py.interner-test"_pc);
+  EXPECT_EQ("__init__.py.interner-test"_pc, component);
+
+  auto path = interner.intern("a/b/c.interner-test"_relpath);
+  EXPECT_EQ("a/b/c.interner-test"_relpath, path);
+  auto again = interner.intern("a/b/c.interner-test"_relpath);
+  EXPECT_EQ(path.view().data(), again.view().data());
+}
+
+TEST(StringInterner, concurrentInterning) {
+  auto& interner = StringInterner::get();
+
+  constexpr size_t kThreads = 8;
+  std::vector<std::thread> threads;
+  std::vector<std::string_view> results(kThreads);
+  for (size_t i = 0; i < kThreads; ++i) {
+    threads.emplace_back([&interner, &results, i] {
+      results[i] =
+          interner.intern(std::string_view{"racy/component.interner-test"});
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (size_t i = 1; i < kThreads; ++i) {
+    EXPECT_EQ(results[0].data(), results[i].data());
+  }
+}
@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/utils/StripedSerialExecutor.h"
+
+#include <folly/executors/ManualExecutor.h>
+#include <folly/portability/gtest.h>
+
+namespace facebook::eden {
+
+TEST(StripedSerialExecutorTest, runsAllTasks) {
+  folly::ManualExecutor parent;
+  StripedSerialExecutor executor{folly::getKeepAliveToken(parent), 3};
+
+  size_t ran = 0;
+  for (size_t i = 0; i < 10; ++i) {
+    executor.add([&] { ++ran; });
+  }
+  parent.drain();
+  EXPECT_EQ(10, ran);
+}
+
+TEST(StripedSerialExecutorTest, singleLanePreservesSubmissionOrder) {
+  folly::ManualExecutor parent;
+  StripedSerialExecutor executor{folly::getKeepAliveToken(parent), 1};
+
+  std::vector<size_t> order;
+  for (size_t i = 0; i < 5; ++i) {
+    executor.add([&order, i] { order.push_back(i); });
+  }
+  parent.drain();
+  EXPECT_EQ((std::vector<size_t>{0, 1, 2, 3, 4}), order);
+}
+
+TEST(StripedSerialExecutorTest, laneCountBoundsParentOccupancy) {
+  folly::ManualExecutor parent;
+  StripedSerialExecutor executor{folly::getKeepAliveToken(parent), 2};
+
+  // Each serialized lane submits at most one unit of work to the parent at a
+  // time, so no matter how many tasks are queued, only numLanes parent tasks
+  // are runnable at once.
+  size_t ran = 0;
+  for (size_t i = 0; i < 10; ++i) {
+    executor.add([&] { ++ran; });
+  }
+  EXPECT_EQ(2, parent.run());
+  parent.drain();
+  EXPECT_EQ(10, ran);
+}
+
+} // namespace facebook::eden
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/utils/UnboundedQueueExecutor.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <folly/executors/ManualExecutor.h>
+#include <folly/portability/GTest.h>
+
+using namespace facebook::eden;
+
+TEST(UnboundedQueueExecutor, tracksQueueDepth) {
+  auto manual = std::make_shared<folly::ManualExecutor>();
+  UnboundedQueueExecutor executor{manual};
+
+  EXPECT_EQ(0, executor.getQueueDepth());
+
+  size_t ran = 0;
+  executor.add([&] { ran++; });
+  executor.add([&] { ran++; });
+  EXPECT_EQ(2, executor.getQueueDepth());
+
+  manual->drain();
+  EXPECT_EQ(2, ran);
+  EXPECT_EQ(0, executor.getQueueDepth());
+}
+
+TEST(UnboundedQueueExecutor, recordsQueueDelay) {
+  auto manual = std::make_shared<folly::ManualExecutor>();
+  UnboundedQueueExecutor executor{manual};
+
+  executor.add([] {});
+  /* sleep override */
+  std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  manual->drain();
+
+  EXPECT_GE(executor.getLastQueueDelay(), std::chrono::milliseconds(2));
+}
+
+TEST(UnboundedQueueExecutor, addWithPriorityFallsBackToSingleLane) {
+  auto manual = std::make_shared<folly::ManualExecutor>();
+  UnboundedQueueExecutor executor{manual};
+  EXPECT_EQ(1, executor.getNumPriorities());
+
+  // ManualExecutor has no priority support; the task must still run.
+  bool ran = false;
+  executor.addWithPriority([&] { ran = true; }, folly::Executor::HI_PRI);
+  manual->drain();
+  EXPECT_TRUE(ran);
+}
+
+TEST(UnboundedQueueExecutor, priorityLanes) {
+  std::atomic<size_t> ran{0};
+  {
+    UnboundedQueueExecutor executor{1, "TestPool", 3};
+    EXPECT_EQ(3, executor.getNumPriorities());
+
+    executor.addWithPriority([&] { ran++; }, folly::Executor::LO_PRI);
+    executor.addWithPriority([&] { ran++; }, folly::Executor::HI_PRI);
+    executor.add([&] { ran++; });
+    // The destructor joins the pool threads after draining the queue.
+  }
+  EXPECT_EQ(3, ran);
+}
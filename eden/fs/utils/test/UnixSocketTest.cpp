@@ -10,6 +10,7 @@
 #include "eden/fs/utils/UnixSocket.h"
 #include "eden/fs/utils/FutureUnixSocket.h"
 
+#include <folly/Conv.h>
 #include <folly/Exception.h>
 #include <folly/File.h>
 #include <folly/Random.h>
@@ -253,6 +254,115 @@ TEST(FutureUnixSocket, receiveQueue) {
   EXPECT_EQ(sendMessages.size(), receivedMessages.size());
 }
 
+TEST(FutureUnixSocket, sendQueueBatching) {
+  auto sockets = createSocketPair();
+  EventBase evb;
+
+  auto socket1 = make_unique<FutureUnixSocket>(&evb, std::move(sockets.first));
+  auto socket2 = make_unique<FutureUnixSocket>(&evb, std::move(sockets.second));
+
+  // Queue up many messages at once, including some large enough to fill the
+  // kernel socket buffer, so batches of smaller messages get flushed together
+  // each time the socket becomes writable again.
+  std::vector<std::string> sendMessages;
+  for (size_t n = 0; n < 100; ++n) {
+    if (n % 10 == 0) {
+      sendMessages.emplace_back(
+          256 * 1024, static_cast<char>('A' + (n / 10)));
+    } else {
+      sendMessages.push_back(folly::to<std::string>("message ", n));
+    }
+  }
+
+  std::vector<UnixSocket::Message> receivedMessages;
+  for (size_t n = 0; n < sendMessages.size(); ++n) {
+    auto future = socket2->receive(500ms)
+                      .thenValue([&receivedMessages](UnixSocket::Message&& msg) {
+                        receivedMessages.emplace_back(std::move(msg));
+                      })
+                      .thenError([n, &evb](const folly::exception_wrapper& ew) {
+                        ADD_FAILURE() << "receive " << n
+                                      << " error: " << ew.what();
+                        evb.terminateLoopSoon();
+                      });
+    if (n == sendMessages.size() - 1) {
+      std::move(future).ensure([&evb]() { evb.terminateLoopSoon(); });
+    }
+  }
+
+  for (const auto& msg : sendMessages) {
+    auto sendBuf = IOBuf(IOBuf::WRAP_BUFFER, ByteRange{StringPiece{msg}});
+    socket1->send(std::move(sendBuf))
+        .thenError([](const folly::exception_wrapper& ew) {
+          ADD_FAILURE() << "send error: " << ew.what();
+        });
+  }
+
+  evb.loopForever();
+
+  ASSERT_EQ(sendMessages.size(), receivedMessages.size());
+  for (size_t n = 0; n < sendMessages.size(); ++n) {
+    EXPECT_EQ(
+        StringPiece{sendMessages[n]},
+        StringPiece{receivedMessages[n].data.coalesce()})
+        << "message " << n;
+  }
+}
+
+TEST(FutureUnixSocket, receiveArenaBatching) {
+  auto sockets = createSocketPair();
+  EventBase evb;
+
+  auto socket1 = make_unique<FutureUnixSocket>(&evb, std::move(sockets.first));
+  auto socket2 = make_unique<FutureUnixSocket>(&evb, std::move(sockets.second));
+
+  // Many small messages get pulled into the receive arena together, well
+  // past the per-loop-iteration message limit, while a message larger than
+  // the arena takes the direct read path in the middle of the batch.
+  std::vector<std::string> sendMessages;
+  for (size_t n = 0; n < 50; ++n) {
+    if (n == 25) {
+      sendMessages.emplace_back(100 * 1024, 'x');
+    } else {
+      sendMessages.push_back(folly::to<std::string>("small message ", n));
+    }
+  }
+
+  std::vector<UnixSocket::Message> receivedMessages;
+  for (size_t n = 0; n < sendMessages.size(); ++n) {
+    auto future = socket2->receive(500ms)
+                      .thenValue([&receivedMessages](UnixSocket::Message&& msg) {
+                        receivedMessages.emplace_back(std::move(msg));
+                      })
+                      .thenError([n, &evb](const folly::exception_wrapper& ew) {
+                        ADD_FAILURE() << "receive " << n
+                                      << " error: " << ew.what();
+                        evb.terminateLoopSoon();
+                      });
+    if (n == sendMessages.size() - 1) {
+      std::move(future).ensure([&evb]() { evb.terminateLoopSoon(); });
+    }
+  }
+
+  for (const auto& msg : sendMessages) {
+    auto sendBuf = IOBuf(IOBuf::WRAP_BUFFER, ByteRange{StringPiece{msg}});
+    socket1->send(std::move(sendBuf))
+        .thenError([](const folly::exception_wrapper& ew) {
+          ADD_FAILURE() << "send error: " << ew.what();
+        });
+  }
+
+  evb.loopForever();
+
+  ASSERT_EQ(sendMessages.size(), receivedMessages.size());
+  for (size_t n = 0; n < sendMessages.size(); ++n) {
+    EXPECT_EQ(
+        StringPiece{sendMessages[n]},
+        StringPiece{receivedMessages[n].data.coalesce()})
+        << "message " << n;
+  }
+}
+
 TEST(FutureUnixSocket, attachEventBase) {
   // A helper function to attach sockets to an EventBase, send a message, then
   // detach from the EventBase
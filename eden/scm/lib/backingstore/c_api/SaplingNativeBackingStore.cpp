@@ -17,11 +17,6 @@
 
 namespace sapling {
 
-namespace {
-/**
- * Convert a `CBytes` into `folly::IOBuf` without copying the underlying
- * data.
- */
 std::unique_ptr<folly::IOBuf> bytesToIOBuf(CBytes* bytes) {
   return folly::IOBuf::takeOwnership(
       reinterpret_cast<void*>(bytes->ptr),
@@ -32,8 +27,6 @@ std::unique_ptr<folly::IOBuf> bytesToIOBuf(CBytes* bytes) {
       reinterpret_cast<void*>(bytes));
 }
 
-} // namespace
-
 SaplingNativeBackingStore::SaplingNativeBackingStore(
     std::string_view repository,
     const BackingStoreOptions& options) {
@@ -39,6 +39,17 @@ using NodeId = folly::ByteRange;
  */
 using NodeIdRange = folly::Range<const NodeId*>;
 
+/**
+ * Transfer ownership of a `CBytes` into a `folly::IOBuf` without copying the
+ * underlying data.
+ *
+ * The backing store is linked into the process, so blob contents cross the
+ * FFI boundary by handing the Rust allocation to the IOBuf; even multi-GB
+ * blobs are never duplicated here. The Rust allocation is freed when the
+ * last clone of the returned IOBuf is destroyed.
+ */
+std::unique_ptr<folly::IOBuf> bytesToIOBuf(CBytes* bytes);
+
 /**
  * Provides a type-safe layer and a more convenient API around the raw
  * BackingStoreBindings.h C functions.